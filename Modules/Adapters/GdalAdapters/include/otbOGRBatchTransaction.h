@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbOGRBatchTransaction_h
+#define otbOGRBatchTransaction_h
+
+#include <cstddef>
+
+#include "otbOGRLayerWrapper.h"
+
+#include "OTBGdalAdaptersExport.h"
+
+namespace otb
+{
+namespace ogr
+{
+/**\ingroup gGeometry
+ * \class BatchTransaction
+ * \brief Groups the modifications of a layer into transactions of bounded size.
+ *
+ * Drivers like SQLite or GeoPackage commit each modification done outside a
+ * transaction, which makes feature-by-feature writes very slow. On the other
+ * hand, a single transaction over millions of features grows a huge journal.
+ * This class forwards \c CreateFeature(), \c SetFeature() and \c
+ * DeleteFeature() to the layer, within transactions that are committed every
+ * \c GetBatchSize() modifications.
+ *
+ * On layers without transactions, modifications are simply forwarded.
+ *
+ * \code
+ * ogr::BatchTransaction batch(layer);
+ * for (...)
+ * {
+ *   batch.CreateFeature(feature);
+ * }
+ * batch.Commit();
+ * \endcode
+ *
+ * \note The pending modifications are also committed on destruction, but
+ * errors can only be reported by an explicit call to \c Commit().
+ * \since OTB v 7.5.0
+ * \ingroup OTBGdalAdapters
+ */
+class OTBGdalAdapters_EXPORT BatchTransaction
+{
+public:
+  /** Init constructor.
+   * \param[in] layer      layer to modify
+   * \param[in] batchSize  maximum number of modifications per transaction
+   * (at least 1)
+   */
+  explicit BatchTransaction(Layer layer, std::size_t batchSize = 10000);
+
+  /** Destructor: commits the pending modifications. */
+  ~BatchTransaction();
+
+  BatchTransaction(BatchTransaction const&) = delete;
+  BatchTransaction& operator=(BatchTransaction const&) = delete;
+
+  /** \copydoc Layer::CreateFeature() */
+  void CreateFeature(Feature feature);
+
+  /** \copydoc Layer::SetFeature() */
+  void SetFeature(Feature feature);
+
+  /** \copydoc Layer::DeleteFeature() */
+  void DeleteFeature(long nFID);
+
+  /** Commits the pending modifications. The next modification starts a new
+   * transaction.
+   * \throw itk::ExceptionObject if the transaction can't be committed.
+   */
+  void Commit();
+
+  std::size_t GetBatchSize() const
+  {
+    return m_BatchSize;
+  }
+
+  /** Number of modifications done so far. */
+  std::size_t GetNumberOfModifications() const
+  {
+    return m_NumberOfModifications;
+  }
+
+private:
+  /** Opens a transaction before a modification, if needed. */
+  void Prepare();
+  /** Commits the transaction once it is full. */
+  void Done();
+
+  Layer       m_Layer;
+  std::size_t m_BatchSize;
+  std::size_t m_Pending;
+  std::size_t m_NumberOfModifications;
+  bool        m_HasTransactions;
+  bool        m_InTransaction;
+};
+
+} // ogr namespace
+} // end namespace otb
+
+#endif // otbOGRBatchTransaction_h
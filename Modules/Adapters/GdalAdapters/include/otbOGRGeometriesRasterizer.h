@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbOGRGeometriesRasterizer_h
+#define otbOGRGeometriesRasterizer_h
+
+#include <string>
+#include <vector>
+
+#include "gdal.h"
+#include "otbOGRSpatialIndex.h"
+
+#include "OTBGdalAdaptersExport.h"
+
+class OGRLayer;
+class OGRGeometry;
+
+namespace otb
+{
+namespace ogr
+{
+/**\ingroup gGeometry
+ * \class GeometriesRasterizer
+ * \brief Burns a cached set of geometries into arbitrary windows of a raster.
+ *
+ * \c GDALRasterizeLayers() iterates over all the features of the layers each
+ * time it is called, which is prohibitive when an image is produced by many
+ * small regions (streaming divisions, threads). This class reads the layers
+ * once, reprojects their geometries into the raster spatial reference, and
+ * indexes their envelopes in a \c SpatialIndex. \c Burn() then only
+ * rasterizes (with \c GDALRasterizeGeometries()) the geometries that
+ * intersect the window covered by the target dataset, in the order they have
+ * been read, so that the result is the same as rasterizing all the layers at
+ * once.
+ *
+ * Once \c BuildIndex() has been called, \c Burn() may be called concurrently
+ * on distinct datasets.
+ *
+ * \since OTB v 7.5.0
+ * \ingroup OTBGdalAdapters
+ */
+class OTBGdalAdapters_EXPORT GeometriesRasterizer
+{
+public:
+  GeometriesRasterizer();
+  ~GeometriesRasterizer();
+  GeometriesRasterizer(GeometriesRasterizer const&) = delete;
+  GeometriesRasterizer& operator=(GeometriesRasterizer const&) = delete;
+
+  /** Releases all the cached geometries. */
+  void Clear();
+
+  /** Caches the geometries of a layer.
+   * \param[in] layer          layer to read, from its first feature
+   * \param[in] projectionRef  WKT of the spatial reference of the rasters the
+   * geometries will be burnt into. If it is empty, or if the layer has no
+   * spatial reference, geometries are not reprojected.
+   * \param[in] burnValues     values to burn, one per band
+   * \param[in] burnAttribute  when not empty, name of the field holding the
+   * value to burn in every band instead of \c burnValues
+   *
+   * \throw itk::ExceptionObject if \c burnAttribute is not a field of \c
+   * layer, or if the geometries cannot be reprojected.
+   * \pre all the calls shall use the same number of burn values.
+   */
+  void AddLayer(OGRLayer& layer, std::string const& projectionRef, std::vector<double> const& burnValues, std::string const& burnAttribute = "");
+
+  /** Indexes the cached geometries; to be called before \c Burn(). */
+  void BuildIndex();
+
+  /** Number of cached geometries. */
+  std::size_t GetNumberOfGeometries() const
+  {
+    return m_Geometries.size();
+  }
+
+  /** Burns the cached geometries that intersect a dataset.
+   * \param[in] dataset    target dataset, with a geo-transform set
+   * \param[in] bands      bands of \c dataset to burn (1-based), as many as
+   * burn values
+   * \param[in] allTouched whether all pixels touched by the geometries are
+   * burnt, or only those whose center is inside the geometries
+   * \throw itk::ExceptionObject if the rasterization fails.
+   */
+  void Burn(GDALDatasetH dataset, std::vector<int> const& bands, bool allTouched = false) const;
+
+private:
+  std::vector<OGRGeometry*> m_Geometries; // owned
+  std::vector<double>       m_BurnValues; // m_NumberOfBands values per geometry
+  std::size_t               m_NumberOfBands;
+  SpatialIndex              m_Index;
+};
+
+} // ogr namespace
+} // end namespace otb
+
+#endif // otbOGRGeometriesRasterizer_h
@@ -34,8 +34,10 @@
 #endif
 // #include "itkIndent.h", included from field
 #include "otbOGRFeatureWrapper.h"
+#include "otbOGRSpatialIndex.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 // #include "ogr_core.h" // OGRwkbGeometryType, included from feature -> field
 // Forward declarations
@@ -65,7 +67,7 @@ OTBGdalAdapters_EXPORT bool operator==(Layer const& lhs, Layer const& rhs);
  *
  * \note This class is a proxy class on top of an \c OGRLayer.
  * \note It can be copied, and assigned. New instances will share the underlying
- * \c OGRLayer.
+ * \c OGRLayer, but not its spatial index.
  * \note When created from a \c otb::ogr::DataSource::ExecuteSQL(), it will
  * automatically manage the release of the underlying \c OGRLayer.
  * \note The default constructor is disabled on purpose.
@@ -123,6 +125,18 @@ public:
    * DataSource::ExecuteSQL().
    */
   Layer(OGRLayer* layer, GDALDataset& sourceInChargeOfLifeTime, bool modifiable);
+
+  /** Copy constructor.
+   * The copy shares the \c OGRLayer, and the count of the modifications done
+   * through the proxies, but starts without spatial index.
+   */
+  Layer(Layer const& other);
+
+  /** Assignment operator.
+   * As with the copy constructor, the spatial index is not shared: the one of
+   * this proxy is dropped.
+   */
+  Layer& operator=(Layer const& other);
   //@}
 
   /**\name Features collection */
@@ -298,6 +312,76 @@ public:
   void SetSpatialFilterRect(double dfMinX, double dfMinY, double dfMaxX, double dfMaxY);
   //@}
 
+  /**\name Spatial index
+   * In-memory index of the envelopes of the features, for layers that are
+   * queried many times (one spatial filter per image tile for instance) and
+   * whose driver has no spatial index, or a costly one.
+   *
+   * While the index is up-to-date, the iterations over a layer with a
+   * spatial filter read the features whose envelope intersects the one of
+   * the filter from the index, and keep those whose geometry intersects the
+   * filter, instead of scanning the whole layer.
+   */
+  //@{
+  /**
+   * Indexes the envelopes of the features of the layer.
+   * The spatial filter is ignored, but only the features matching the
+   * attribute filter of the \c OGRLayer are indexed.
+   * \post <tt>HasSpatialIndex() == true</tt>
+   * \note The index belongs to this proxy: copies do not get it. It is
+   * outdated by \c CreateFeature(), \c SetFeature(), \c DeleteFeature(), \c
+   * CommitTransaction() and \c RollbackTransaction(), called on this proxy or
+   * on any copy of it (a \c BatchTransaction for instance), but not by
+   * modifications done directly on the \c OGRLayer.
+   * \sa \c SpatialIndex
+   */
+  void BuildSpatialIndex();
+
+  /** Tells whether the spatial index is built and up-to-date. */
+  bool HasSpatialIndex() const;
+
+  /** Releases the spatial index. */
+  void DropSpatialIndex();
+
+  /**
+   * Searches the features whose envelope intersects a rectangle.
+   * \param[in]  window  searched area, in the layer spatial reference
+   * \param[out] fids    ids of the features found, sorted. The vector is
+   * cleared first.
+   * \throw itk::ExceptionObject if the spatial index isn't built or is
+   * outdated.
+   * \note As with OGR spatial filters, features are selected on their
+   * envelope: the result may contain false-positives, but no missed shapes.
+   */
+  void QuerySpatialIndex(OGREnvelope const& window, std::vector<long>& fids) const;
+  //@}
+
+  /**\name Transactions */
+  //@{
+  /** Tells whether the layer supports transactions.
+   * \sa \c OGRLayer::TestCapability(OLCTransactions)
+   */
+  bool HasTransactions() const;
+
+  /** Starts a new transaction.
+   * \throw itk::ExceptionObject if the transaction can't be started.
+   * \sa \c OGRLayer::StartTransaction(), \c BatchTransaction
+   */
+  void StartTransaction();
+
+  /** Commits the current transaction.
+   * \throw itk::ExceptionObject if the transaction can't be committed.
+   * \sa \c OGRLayer::CommitTransaction()
+   */
+  void CommitTransaction();
+
+  /** Cancels the current transaction.
+   * \throw itk::ExceptionObject if the transaction can't be rolled back.
+   * \sa \c OGRLayer::RollbackTransaction()
+   */
+  void RollbackTransaction();
+  //@}
+
   /** Spatial Reference property.
    * \note Read-only property. In order to set this property, you'll have to
    * create a new layer with a spatial reference.
@@ -561,6 +645,15 @@ private:
    */
   Feature GetNextFeature();
 
+  /** Restarts the iteration over the features: from the spatial index when
+   * it is up-to-date and a spatial filter is set, from the \c OGRLayer
+   * otherwise.
+   */
+  void ResetReading();
+
+  /** Restarts the iteration over the features at the i-th one. */
+  void SetNextByIndex(GIntBig index);
+
   /** Data implementation.
    * \internal
    * The actual %layer implementation belongs to the \c otb::Layer object,
@@ -571,6 +664,20 @@ private:
 
   bool m_Modifiable;
 
+  /** Number of modifications done through this proxy and its copies,
+   * shared by all of them. */
+  std::shared_ptr<unsigned long> m_Modifications;
+
+  /** Spatial index of the features, keyed by their ids, and number of
+   * modifications when it was built. Null when not built. */
+  std::unique_ptr<SpatialIndex const> m_SpatialIndex;
+  unsigned long                       m_IndexedModifications;
+
+  /** Features found in the spatial index for the current iteration */
+  std::vector<SpatialIndex::IdType> m_Candidates;
+  std::size_t                       m_NextCandidate;
+  bool                              m_ReadingIndex;
+
 #if 0
   /** Related DataSource.
    * Needed to access OTB meta information.
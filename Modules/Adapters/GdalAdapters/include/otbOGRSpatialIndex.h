@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbOGRSpatialIndex_h
+#define otbOGRSpatialIndex_h
+
+#include <cstddef>
+#include <vector>
+
+#include "ogr_core.h"
+
+#include "OTBGdalAdaptersExport.h"
+
+#if defined(_MSC_VER)
+#pragma warning(disable : 4251)
+// Disable following warning :
+// warning C4251: 'otb::ogr::SpatialIndex::m_Envelopes':
+// class 'std::vector<...>' needs to have dll-interface to be used by clients
+// of class 'otb::ogr::SpatialIndex'
+// As long as the members are private no need to export this type.
+#endif
+
+namespace otb
+{
+namespace ogr
+{
+/**\ingroup gGeometry
+ * \class SpatialIndex
+ * \brief Static in-memory R-tree of 2D envelopes.
+ *
+ * The tree is bulk-loaded with the Sort-Tile-Recursive (STR) algorithm:
+ * envelopes are first registered with \c Insert(), then \c Build() packs them
+ * into full nodes of \c GetNodeCapacity() entries, level by level. Once built,
+ * \c Query() returns the identifiers of all envelopes intersecting a window.
+ *
+ * The index is read-only once built: \c Query() may be called concurrently
+ * from several threads.
+ *
+ * \since OTB v 7.5.0
+ * \ingroup OTBGdalAdapters
+ */
+class OTBGdalAdapters_EXPORT SpatialIndex
+{
+public:
+  typedef std::size_t IdType;
+
+  /** Default constructor.
+   * \param[in] nodeCapacity  maximum number of children per node (at least 2)
+   */
+  explicit SpatialIndex(std::size_t nodeCapacity = 16);
+
+  /** Removes all the envelopes and invalidates the tree. */
+  void Clear();
+
+  /** Registers a new envelope.
+   * \param[in] envelope  envelope to index
+   * \param[in] id        identifier returned by \c Query() for this envelope
+   * \post the tree needs to be (re)built with \c Build()
+   */
+  void Insert(OGREnvelope const& envelope, IdType id);
+
+  /** Packs the registered envelopes into the tree. */
+  void Build();
+
+  /** Tells whether the tree is up-to-date with the registered envelopes. */
+  bool IsBuilt() const
+  {
+    return m_Built;
+  }
+
+  /** Number of registered envelopes. */
+  std::size_t GetSize() const
+  {
+    return m_Ids.size();
+  }
+
+  std::size_t GetNodeCapacity() const
+  {
+    return m_NodeCapacity;
+  }
+
+  /** Envelope of all the registered envelopes. */
+  OGREnvelope const& GetExtent() const
+  {
+    return m_Extent;
+  }
+
+  /** Searches the envelopes intersecting a window.
+   * \param[in]  window  searched area
+   * \param[out] result  identifiers of the intersecting envelopes, sorted in
+   * increasing order. The vector is cleared first.
+   * \pre the tree shall be built.
+   */
+  void Query(OGREnvelope const& window, std::vector<IdType>& result) const;
+
+  /** Tells whether at least one envelope intersects a window; cheaper than
+   * \c Query() as the search stops at the first match.
+   * \pre the tree shall be built.
+   */
+  bool Intersects(OGREnvelope const& window) const;
+
+private:
+  /** Tree node: envelope of the children, and range of the children in the
+   * level below (or in the entries, for leaves).
+   */
+  struct Node
+  {
+    OGREnvelope envelope;
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  std::vector<OGREnvelope>       m_Envelopes;
+  std::vector<IdType>            m_Ids;
+  std::vector<std::vector<Node>> m_Levels; // m_Levels[0] are the leaves
+  OGREnvelope                    m_Extent;
+  std::size_t                    m_NodeCapacity;
+  bool                           m_Built;
+};
+
+} // ogr namespace
+} // end namespace otb
+
+#endif // otbOGRSpatialIndex_h
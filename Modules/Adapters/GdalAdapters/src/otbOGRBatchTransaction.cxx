@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbOGRBatchTransaction.h"
+
+#include <algorithm>
+
+#include "itkMacro.h"
+
+namespace otb
+{
+namespace ogr
+{
+
+BatchTransaction::BatchTransaction(Layer layer, std::size_t batchSize)
+  : m_Layer(layer),
+    m_BatchSize(std::max<std::size_t>(batchSize, 1)),
+    m_Pending(0),
+    m_NumberOfModifications(0),
+    m_HasTransactions(layer.HasTransactions()),
+    m_InTransaction(false)
+{
+}
+
+BatchTransaction::~BatchTransaction()
+{
+  try
+  {
+    Commit();
+  }
+  catch (itk::ExceptionObject const& e)
+  {
+    itkGenericOutputMacro(<< "Failed to commit the last modifications of layer <" << m_Layer.GetName() << ">: " << e.GetDescription());
+  }
+}
+
+void BatchTransaction::CreateFeature(Feature feature)
+{
+  Prepare();
+  m_Layer.CreateFeature(feature);
+  Done();
+}
+
+void BatchTransaction::SetFeature(Feature feature)
+{
+  Prepare();
+  m_Layer.SetFeature(feature);
+  Done();
+}
+
+void BatchTransaction::DeleteFeature(long nFID)
+{
+  Prepare();
+  m_Layer.DeleteFeature(nFID);
+  Done();
+}
+
+void BatchTransaction::Commit()
+{
+  if (m_InTransaction)
+  {
+    m_InTransaction = false;
+    m_Pending       = 0;
+    m_Layer.CommitTransaction();
+  }
+}
+
+void BatchTransaction::Prepare()
+{
+  if (m_HasTransactions && !m_InTransaction)
+  {
+    m_Layer.StartTransaction();
+    m_InTransaction = true;
+  }
+}
+
+void BatchTransaction::Done()
+{
+  ++m_NumberOfModifications;
+  if (m_InTransaction && ++m_Pending >= m_BatchSize)
+  {
+    Commit();
+  }
+}
+
+} // ogr namespace
+} // end namespace otb
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbOGRGeometriesRasterizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+#include "gdal_alg.h"
+#include "ogrsf_frmts.h"
+#include "ogr_spatialref.h"
+#pragma GCC diagnostic pop
+#else
+#include "gdal_alg.h"
+#include "ogrsf_frmts.h"
+#include "ogr_spatialref.h"
+#endif // __GNUC__ || __clang__
+
+#include "itkMacro.h"
+#include "otbOGRHelpers.h"
+
+namespace otb
+{
+namespace ogr
+{
+
+namespace
+{
+struct CoordinateTransformationDeleter
+{
+  void operator()(OGRCoordinateTransformation* ct) const
+  {
+    OGRCoordinateTransformation::DestroyCT(ct);
+  }
+};
+
+struct FeatureDeleter
+{
+  void operator()(OGRFeature* feature) const
+  {
+    OGRFeature::DestroyFeature(feature);
+  }
+};
+}
+
+GeometriesRasterizer::GeometriesRasterizer() : m_NumberOfBands(0)
+{
+}
+
+GeometriesRasterizer::~GeometriesRasterizer()
+{
+  Clear();
+}
+
+void GeometriesRasterizer::Clear()
+{
+  for (OGRGeometry* geometry : m_Geometries)
+  {
+    OGRGeometryFactory::destroyGeometry(geometry);
+  }
+  m_Geometries.clear();
+  m_BurnValues.clear();
+  m_NumberOfBands = 0;
+  m_Index.Clear();
+}
+
+void GeometriesRasterizer::AddLayer(OGRLayer& layer, std::string const& projectionRef, std::vector<double> const& burnValues, std::string const& burnAttribute)
+{
+  assert((m_Geometries.empty() || m_NumberOfBands == burnValues.size()) && "The same number of burn values shall be used for all the layers");
+  m_NumberOfBands = burnValues.size();
+
+  int burnField = -1;
+  if (!burnAttribute.empty())
+  {
+    burnField = layer.GetLayerDefn()->GetFieldIndex(burnAttribute.c_str());
+    if (burnField < 0)
+    {
+      itkGenericExceptionMacro(<< "Failed to find field " << burnAttribute << " on layer " << layer.GetName());
+    }
+  }
+
+  // Same behaviour as GDALRasterizeLayers(): geometries are reprojected into
+  // the raster spatial reference when both are known
+  std::unique_ptr<OGRCoordinateTransformation, CoordinateTransformationDeleter> transformation;
+  OGRSpatialReference const* layerSRS = layer.GetSpatialRef();
+  if (layerSRS && !projectionRef.empty())
+  {
+    OGRSpatialReference target;
+    if (target.SetFromUserInput(projectionRef.c_str()) == OGRERR_NONE && !target.IsSame(layerSRS))
+    {
+      OGRSpatialReference source(*layerSRS);
+#if GDAL_VERSION_NUM >= 3000000
+      source.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+      target.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+#endif
+      transformation.reset(OGRCreateCoordinateTransformation(&source, &target));
+      if (!transformation)
+      {
+        itkGenericExceptionMacro(<< "Cannot reproject the geometries of layer " << layer.GetName() << " into the raster spatial reference: "
+                                 << CPLGetLastErrorMsg());
+      }
+    }
+  }
+
+  layer.ResetReading();
+  for (std::unique_ptr<OGRFeature, FeatureDeleter> feature(layer.GetNextFeature()); feature; feature.reset(layer.GetNextFeature()))
+  {
+    OGRGeometry* geometry = feature->StealGeometry();
+    if (!geometry)
+    {
+      continue;
+    }
+    if (geometry->IsEmpty() || (transformation && geometry->transform(transformation.get()) != OGRERR_NONE))
+    {
+      OGRGeometryFactory::destroyGeometry(geometry);
+      continue;
+    }
+
+    OGREnvelope envelope;
+    geometry->getEnvelope(&envelope);
+    m_Index.Insert(envelope, m_Geometries.size());
+    m_Geometries.push_back(geometry);
+
+    if (burnField >= 0)
+    {
+      m_BurnValues.insert(m_BurnValues.end(), m_NumberOfBands, feature->GetFieldAsDouble(burnField));
+    }
+    else
+    {
+      m_BurnValues.insert(m_BurnValues.end(), burnValues.begin(), burnValues.end());
+    }
+  }
+  layer.ResetReading();
+}
+
+void GeometriesRasterizer::BuildIndex()
+{
+  m_Index.Build();
+}
+
+void GeometriesRasterizer::Burn(GDALDatasetH dataset, std::vector<int> const& bands, bool allTouched) const
+{
+  assert(dataset);
+  assert(m_Index.IsBuilt() && "BuildIndex() shall be called before Burn()");
+  if (bands.size() != m_NumberOfBands && !m_Geometries.empty())
+  {
+    itkGenericExceptionMacro(<< "Expecting " << m_NumberOfBands << " bands to burn, got " << bands.size());
+  }
+
+  // Window covered by the dataset
+  double geoTransform[6];
+  if (GDALGetGeoTransform(dataset, geoTransform) != CE_None)
+  {
+    itkGenericExceptionMacro(<< "Cannot burn geometries into a dataset without geo-transform");
+  }
+  const double x0 = geoTransform[0];
+  const double y0 = geoTransform[3];
+  const double x1 = x0 + GDALGetRasterXSize(dataset) * geoTransform[1] + GDALGetRasterYSize(dataset) * geoTransform[2];
+  const double y1 = y0 + GDALGetRasterXSize(dataset) * geoTransform[4] + GDALGetRasterYSize(dataset) * geoTransform[5];
+
+  OGREnvelope window;
+  window.MinX = std::min(x0, x1);
+  window.MaxX = std::max(x0, x1);
+  window.MinY = std::min(y0, y1);
+  window.MaxY = std::max(y0, y1);
+
+  std::vector<SpatialIndex::IdType> ids;
+  m_Index.Query(window, ids);
+  if (ids.empty())
+  {
+    return;
+  }
+
+  // Ids are sorted: geometries are burnt in their reading order
+  std::vector<OGRGeometryH> geometries;
+  std::vector<double>       burnValues;
+  geometries.reserve(ids.size());
+  burnValues.reserve(ids.size() * m_NumberOfBands);
+  for (SpatialIndex::IdType id : ids)
+  {
+    geometries.push_back(reinterpret_cast<OGRGeometryH>(m_Geometries[id]));
+    burnValues.insert(burnValues.end(), m_BurnValues.begin() + id * m_NumberOfBands, m_BurnValues.begin() + (id + 1) * m_NumberOfBands);
+  }
+
+  std::vector<std::string> options;
+  if (allTouched)
+  {
+    options.push_back("ALL_TOUCHED=TRUE");
+  }
+
+  const CPLErr err = GDALRasterizeGeometries(dataset, bands.size(), const_cast<int*>(bands.data()), geometries.size(), geometries.data(), nullptr, nullptr,
+                                             burnValues.data(), StringListConverter(options).to_ogr(), nullptr, nullptr);
+  if (err != CE_None)
+  {
+    itkGenericExceptionMacro(<< "Failed to rasterize geometries: " << CPLGetLastErrorMsg());
+  }
+}
+
+} // ogr namespace
+} // end namespace otb
@@ -41,6 +41,7 @@
 
 
 #include "otbOGRDataSourceWrapper.h"
+#include "otbOGRGeometryWrapper.h"
 
 /*===========================================================================*/
 /*======================[ Construction & Destruction ]=======================*/
@@ -61,7 +62,13 @@ struct LeaveAloneDeleter
 } // Anonymous namespace
 
 
-otb::ogr::Layer::Layer(OGRLayer* layer, bool modifiable) : m_Layer(layer, LeaveAloneDeleter()), m_Modifiable(modifiable)
+otb::ogr::Layer::Layer(OGRLayer* layer, bool modifiable)
+  : m_Layer(layer, LeaveAloneDeleter()),
+    m_Modifiable(modifiable),
+    m_Modifications(std::make_shared<unsigned long>(0)),
+    m_IndexedModifications(0),
+    m_NextCandidate(0),
+    m_ReadingIndex(false)
 #if 0
   , m_DataSource(datasource)
 #endif
@@ -69,12 +76,39 @@ otb::ogr::Layer::Layer(OGRLayer* layer, bool modifiable) : m_Layer(layer, LeaveA
 }
 
 otb::ogr::Layer::Layer(OGRLayer* layer, GDALDataset& sourceInChargeOfLifeTime, bool modifiable)
-  : m_Layer(layer, [&](auto const& x) { return sourceInChargeOfLifeTime.ReleaseResultSet(x); }), m_Modifiable(modifiable)
+  : m_Layer(layer, [&](auto const& x) { return sourceInChargeOfLifeTime.ReleaseResultSet(x); }),
+    m_Modifiable(modifiable),
+    m_Modifications(std::make_shared<unsigned long>(0)),
+    m_IndexedModifications(0),
+    m_NextCandidate(0),
+    m_ReadingIndex(false)
 {
   assert(layer && "A null OGRlayer cannot belong to an OGRDataSource");
   // OGR always refuses "delete 0". *sigh*
 }
 
+otb::ogr::Layer::Layer(Layer const& other)
+  : m_Layer(other.m_Layer),
+    m_Modifiable(other.m_Modifiable),
+    m_Modifications(other.m_Modifications),
+    m_IndexedModifications(0),
+    m_NextCandidate(0),
+    m_ReadingIndex(false)
+{
+}
+
+otb::ogr::Layer& otb::ogr::Layer::operator=(Layer const& other)
+{
+  if (this != &other)
+  {
+    m_Layer         = other.m_Layer;
+    m_Modifiable    = other.m_Modifiable;
+    m_Modifications = other.m_Modifications;
+    DropSpatialIndex();
+  }
+  return *this;
+}
+
 /*===========================================================================*/
 /*===============================[ Features ]================================*/
 /*===========================================================================*/
@@ -87,35 +121,89 @@ int otb::ogr::Layer::GetFeatureCount(bool doForceComputation) const
 otb::ogr::Feature otb::ogr::Layer::GetNextFeature()
 {
   assert(m_Layer && "OGRLayer not initialized");
-  OGRFeature* f = m_Layer->GetNextFeature();
+  if (!m_ReadingIndex)
+  {
+    OGRFeature* f = m_Layer->GetNextFeature();
+    return f;
+  }
+
+  // The index selects the features on their envelope, the spatial filter
+  // decides on their geometry
+  OGRGeometry const* filter = m_Layer->GetSpatialFilter();
+  while (m_NextCandidate < m_Candidates.size())
+  {
+    OGRFeature*        f        = m_Layer->GetFeature(static_cast<GIntBig>(m_Candidates[m_NextCandidate++]));
+    OGRGeometry const* geometry = f ? f->GetGeometryRef() : nullptr;
+    if (geometry && filter && filter->Intersects(geometry))
+    {
+      return f;
+    }
+    OGRFeature::DestroyFeature(f);
+  }
+  OGRFeature* f = nullptr;
   return f;
 }
 
+void otb::ogr::Layer::ResetReading()
+{
+  OGRGeometry const* filter = m_Layer->GetSpatialFilter();
+  m_ReadingIndex            = filter && HasSpatialIndex();
+  m_NextCandidate           = 0;
+  m_Candidates.clear();
+  if (m_ReadingIndex)
+  {
+    OGREnvelope window;
+    filter->getEnvelope(&window);
+    m_SpatialIndex->Query(window, m_Candidates);
+  }
+  else
+  {
+    m_Layer->ResetReading();
+  }
+}
+
+void otb::ogr::Layer::SetNextByIndex(GIntBig index)
+{
+  ResetReading();
+  if (m_ReadingIndex)
+  {
+    // Skips the features of the index that do not pass the filter, as OGR
+    // does for filtered layers
+    for (GIntBig i = 0; i < index && GetNextFeature().addr(); ++i)
+    {
+    }
+  }
+  else
+  {
+    m_Layer->SetNextByIndex(index);
+  }
+}
+
 otb::ogr::Layer::iterator otb::ogr::Layer::begin()
 {
   assert(m_Layer && "OGRLayer not initialized");
-  m_Layer->ResetReading();
+  ResetReading();
   return iterator(*this);
 }
 
 otb::ogr::Layer::const_iterator otb::ogr::Layer::cbegin() const
 {
   assert(m_Layer && "OGRLayer not initialized");
-  m_Layer->ResetReading();
+  const_cast<Layer*>(this)->ResetReading();
   return const_iterator(*const_cast<Layer*>(this));
 }
 
 otb::ogr::Layer::iterator otb::ogr::Layer::start_at(GIntBig index)
 {
   assert(m_Layer && "OGRLayer not initialized");
-  m_Layer->SetNextByIndex(index);
+  SetNextByIndex(index);
   return iterator(*this);
 }
 
 otb::ogr::Layer::const_iterator otb::ogr::Layer::cstart_at(GIntBig index) const
 {
   assert(m_Layer && "OGRLayer not initialized");
-  m_Layer->SetNextByIndex(index);
+  const_cast<Layer*>(this)->SetNextByIndex(index);
   return const_iterator(*const_cast<Layer*>(this));
 }
 
@@ -128,6 +216,7 @@ void otb::ogr::Layer::CreateFeature(Feature feature)
     itkGenericExceptionMacro(<< "Cannot create a new feature in the layer <" << GetName() << ">: layer is not modifiable");
   }
 
+  ++*m_Modifications;
   const OGRErr res = m_Layer->CreateFeature(&feature.ogr());
   if (res != OGRERR_NONE)
   {
@@ -144,6 +233,7 @@ void otb::ogr::Layer::DeleteFeature(long nFID)
     itkGenericExceptionMacro(<< "Cannot create a new feature in the layer <" << GetName() << ">: layer is not modifiable");
   }
 
+  ++*m_Modifications;
   const OGRErr res = m_Layer->DeleteFeature(nFID);
   if (res != OGRERR_NONE)
   {
@@ -171,6 +261,7 @@ void otb::ogr::Layer::SetFeature(Feature feature)
     itkGenericExceptionMacro(<< "Cannot create a new feature in the layer <" << GetName() << ">: layer is not modifiable");
   }
 
+  ++*m_Modifications;
   const OGRErr res = m_Layer->SetFeature(&feature.ogr());
   if (res != OGRERR_NONE)
   {
@@ -256,6 +347,106 @@ void otb::ogr::Layer::SetSpatialFilterRect(double dfMinX, double dfMinY, double
   m_Layer->SetSpatialFilterRect(dfMinX, dfMinY, dfMaxX, dfMaxY);
 }
 
+/*===========================================================================*/
+/*=============================[ Spatial index ]=============================*/
+/*===========================================================================*/
+void otb::ogr::Layer::BuildSpatialIndex()
+{
+  assert(m_Layer && "OGRLayer not initialized");
+  std::unique_ptr<SpatialIndex> index(new SpatialIndex());
+
+  // Every feature is indexed, whatever the spatial filter
+  OGRGeometry const* filter = m_Layer->GetSpatialFilter();
+  UniqueGeometryPtr  savedFilter(filter ? filter->clone() : nullptr);
+  m_Layer->SetSpatialFilter(nullptr);
+  m_ReadingIndex = false;
+
+  m_Layer->ResetReading();
+  for (Feature feature = GetNextFeature(); feature.addr(); feature = GetNextFeature())
+  {
+    OGRGeometry const* geometry = feature.ogr().GetGeometryRef();
+    if (!geometry || geometry->IsEmpty() || feature.GetFID() < 0)
+    {
+      continue;
+    }
+    OGREnvelope envelope;
+    geometry->getEnvelope(&envelope);
+    index->Insert(envelope, static_cast<SpatialIndex::IdType>(feature.GetFID()));
+  }
+
+  m_Layer->SetSpatialFilter(savedFilter.get());
+  m_Layer->ResetReading();
+
+  index->Build();
+  m_SpatialIndex         = std::move(index);
+  m_IndexedModifications = *m_Modifications;
+}
+
+bool otb::ogr::Layer::HasSpatialIndex() const
+{
+  return m_SpatialIndex && m_IndexedModifications == *m_Modifications;
+}
+
+void otb::ogr::Layer::DropSpatialIndex()
+{
+  m_SpatialIndex.reset();
+  m_Candidates.clear();
+  m_NextCandidate = 0;
+  m_ReadingIndex  = false;
+}
+
+void otb::ogr::Layer::QuerySpatialIndex(OGREnvelope const& window, std::vector<long>& fids) const
+{
+  if (!HasSpatialIndex())
+  {
+    itkGenericExceptionMacro(<< "The spatial index of the layer <" << GetName() << "> is not built or outdated");
+  }
+  std::vector<SpatialIndex::IdType> ids;
+  m_SpatialIndex->Query(window, ids);
+  fids.assign(ids.begin(), ids.end());
+}
+
+/*===========================================================================*/
+/*==============================[ Transactions ]=============================*/
+/*===========================================================================*/
+bool otb::ogr::Layer::HasTransactions() const
+{
+  assert(m_Layer && "OGRLayer not initialized");
+  return m_Layer->TestCapability(OLCTransactions);
+}
+
+void otb::ogr::Layer::StartTransaction()
+{
+  assert(m_Layer && "OGRLayer not initialized");
+  const OGRErr res = m_Layer->StartTransaction();
+  if (res != OGRERR_NONE)
+  {
+    itkGenericExceptionMacro(<< "Unable to start transaction for OGR layer <" << GetName() << ">: " << CPLGetLastErrorMsg());
+  }
+}
+
+void otb::ogr::Layer::CommitTransaction()
+{
+  assert(m_Layer && "OGRLayer not initialized");
+  ++*m_Modifications;
+  const OGRErr res = m_Layer->CommitTransaction();
+  if (res != OGRERR_NONE)
+  {
+    itkGenericExceptionMacro(<< "Unable to commit transaction for OGR layer <" << GetName() << ">: " << CPLGetLastErrorMsg());
+  }
+}
+
+void otb::ogr::Layer::RollbackTransaction()
+{
+  assert(m_Layer && "OGRLayer not initialized");
+  ++*m_Modifications;
+  const OGRErr res = m_Layer->RollbackTransaction();
+  if (res != OGRERR_NONE)
+  {
+    itkGenericExceptionMacro(<< "Unable to rollback transaction for OGR layer <" << GetName() << ">: " << CPLGetLastErrorMsg());
+  }
+}
+
 OGRSpatialReference const* otb::ogr::Layer::GetSpatialRef() const
 {
   assert(m_Layer && "OGRLayer not initialized");
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbOGRSpatialIndex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace otb
+{
+namespace ogr
+{
+
+namespace
+{
+inline double CenterX(OGREnvelope const& e)
+{
+  return 0.5 * (e.MinX + e.MaxX);
+}
+
+inline double CenterY(OGREnvelope const& e)
+{
+  return 0.5 * (e.MinY + e.MaxY);
+}
+
+/** Sort-Tile-Recursive ordering of a set of envelopes: envelopes are sorted
+ * along X, cut in vertical slices of \c sliceSize elements, and each slice is
+ * sorted along Y. Consecutive groups of \c capacity elements of the returned
+ * permutation make the nodes of the next level.
+ */
+std::vector<std::size_t> STROrder(std::vector<OGREnvelope> const& envelopes, std::size_t capacity)
+{
+  const std::size_t        n = envelopes.size();
+  std::vector<std::size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+
+  const std::size_t nbNodes   = (n + capacity - 1) / capacity;
+  const std::size_t nbSlices  = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nbNodes))));
+  const std::size_t sliceSize = nbSlices * capacity;
+
+  std::sort(order.begin(), order.end(), [&envelopes](std::size_t a, std::size_t b) { return CenterX(envelopes[a]) < CenterX(envelopes[b]); });
+
+  for (std::size_t start = 0; start < n; start += sliceSize)
+  {
+    auto first = order.begin() + start;
+    auto last  = order.begin() + std::min(n, start + sliceSize);
+    std::sort(first, last, [&envelopes](std::size_t a, std::size_t b) { return CenterY(envelopes[a]) < CenterY(envelopes[b]); });
+  }
+  return order;
+}
+}
+
+SpatialIndex::SpatialIndex(std::size_t nodeCapacity) : m_NodeCapacity(std::max<std::size_t>(nodeCapacity, 2)), m_Built(false)
+{
+}
+
+void SpatialIndex::Clear()
+{
+  m_Envelopes.clear();
+  m_Ids.clear();
+  m_Levels.clear();
+  m_Extent = OGREnvelope();
+  m_Built  = false;
+}
+
+void SpatialIndex::Insert(OGREnvelope const& envelope, IdType id)
+{
+  m_Envelopes.push_back(envelope);
+  m_Ids.push_back(id);
+  m_Extent.Merge(envelope);
+  m_Built = false;
+}
+
+void SpatialIndex::Build()
+{
+  m_Levels.clear();
+  m_Built = true;
+  if (m_Envelopes.empty())
+  {
+    return;
+  }
+
+  // Reorder the entries themselves so that each leaf covers a contiguous
+  // range of them
+  {
+    const std::vector<std::size_t> order = STROrder(m_Envelopes, m_NodeCapacity);
+    std::vector<OGREnvelope>        envelopes;
+    std::vector<IdType>             ids;
+    envelopes.reserve(order.size());
+    ids.reserve(order.size());
+    for (std::size_t i : order)
+    {
+      envelopes.push_back(m_Envelopes[i]);
+      ids.push_back(m_Ids[i]);
+    }
+    m_Envelopes.swap(envelopes);
+    m_Ids.swap(ids);
+  }
+
+  // Group the elements of the level below (entries first, nodes then) until
+  // a single root is left
+  std::vector<OGREnvelope> children = m_Envelopes;
+  do
+  {
+    std::vector<Node> level;
+    level.reserve((children.size() + m_NodeCapacity - 1) / m_NodeCapacity);
+    for (std::size_t begin = 0; begin < children.size(); begin += m_NodeCapacity)
+    {
+      Node node;
+      node.begin = begin;
+      node.end   = std::min(children.size(), begin + m_NodeCapacity);
+      for (std::size_t c = node.begin; c < node.end; ++c)
+      {
+        node.envelope.Merge(children[c]);
+      }
+      level.push_back(node);
+    }
+
+    children.clear();
+    if (level.size() > 1)
+    {
+      // Pack the nodes of this level before building their parents
+      std::vector<OGREnvelope> envelopes;
+      envelopes.reserve(level.size());
+      for (auto const& node : level)
+      {
+        envelopes.push_back(node.envelope);
+      }
+      const std::vector<std::size_t> order = STROrder(envelopes, m_NodeCapacity);
+
+      std::vector<Node> sorted;
+      sorted.reserve(level.size());
+      for (std::size_t i : order)
+      {
+        sorted.push_back(level[i]);
+        children.push_back(level[i].envelope);
+      }
+      level.swap(sorted);
+    }
+    m_Levels.push_back(std::move(level));
+  } while (!children.empty());
+}
+
+void SpatialIndex::Query(OGREnvelope const& window, std::vector<IdType>& result) const
+{
+  assert(m_Built && "The spatial index shall be built before being queried");
+  result.clear();
+  if (m_Levels.empty())
+  {
+    return;
+  }
+
+  // Depth-first traversal: (level, node position in the level)
+  std::vector<std::pair<std::size_t, std::size_t>> stack;
+  const std::size_t                                root = m_Levels.size() - 1;
+  for (std::size_t n = 0; n < m_Levels[root].size(); ++n)
+  {
+    stack.emplace_back(root, n);
+  }
+
+  while (!stack.empty())
+  {
+    const std::size_t level = stack.back().first;
+    Node const&       node  = m_Levels[level][stack.back().second];
+    stack.pop_back();
+
+    if (!node.envelope.Intersects(window))
+    {
+      continue;
+    }
+
+    if (level == 0)
+    {
+      for (std::size_t e = node.begin; e < node.end; ++e)
+      {
+        if (m_Envelopes[e].Intersects(window))
+        {
+          result.push_back(m_Ids[e]);
+        }
+      }
+    }
+    else
+    {
+      for (std::size_t c = node.begin; c < node.end; ++c)
+      {
+        stack.emplace_back(level - 1, c);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+}
+
+bool SpatialIndex::Intersects(OGREnvelope const& window) const
+{
+  assert(m_Built && "The spatial index shall be built before being queried");
+  if (m_Levels.empty() || !m_Extent.Intersects(window))
+  {
+    return false;
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> stack;
+  const std::size_t                                root = m_Levels.size() - 1;
+  for (std::size_t n = 0; n < m_Levels[root].size(); ++n)
+  {
+    stack.emplace_back(root, n);
+  }
+
+  while (!stack.empty())
+  {
+    const std::size_t level = stack.back().first;
+    Node const&       node  = m_Levels[level][stack.back().second];
+    stack.pop_back();
+
+    if (!node.envelope.Intersects(window))
+    {
+      continue;
+    }
+
+    for (std::size_t c = node.begin; c < node.end; ++c)
+    {
+      if (level == 0)
+      {
+        if (m_Envelopes[c].Intersects(window))
+        {
+          return true;
+        }
+      }
+      else
+      {
+        stack.emplace_back(level - 1, c);
+      }
+    }
+  }
+  return false;
+}
+
+} // ogr namespace
+} // end namespace otb
@@ -24,4 +24,6 @@ void RegisterTests()
 {
   REGISTER_TEST(otbSpatialReferenceTest);
   REGISTER_TEST(otbCoordinateTransformationTest);
+  REGISTER_TEST(otbOGRSpatialIndexTest);
+  REGISTER_TEST(otbOGRBatchTransactionTest);
 }
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbOGRBatchTransaction.h"
+#include "otbOGRDataSourceWrapper.h"
+#include "otbStopwatch.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace otb;
+
+int otbOGRBatchTransactionTest(int argc, char* argv[])
+{
+  if (argc != 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " <output.gpkg> <nbFeatures>" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const long nbFeatures = std::atol(argv[2]);
+
+  ogr::DataSource::Pointer ds    = ogr::DataSource::New(argv[1], ogr::DataSource::Modes::Overwrite);
+  ogr::Layer               layer = ds->CreateLayer("points", nullptr, wkbPoint);
+
+  // Write the features by batches
+  std::mt19937                           generator(42);
+  std::uniform_real_distribution<double> position(0., 1000.);
+
+  otb::Stopwatch chrono;
+  chrono.Start();
+  {
+    ogr::BatchTransaction batch(layer, 1000);
+    for (long i = 0; i < nbFeatures; ++i)
+    {
+      ogr::Feature feature(layer.GetLayerDefn());
+      OGRPoint     point(position(generator), position(generator));
+      feature.SetGeometry(&point);
+      batch.CreateFeature(feature);
+    }
+    batch.Commit();
+    if (batch.GetNumberOfModifications() != static_cast<std::size_t>(nbFeatures))
+    {
+      std::cerr << "Fail: expecting " << nbFeatures << " modifications, got " << batch.GetNumberOfModifications() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  chrono.Stop();
+  std::cout << "Writing " << nbFeatures << " features (transactions: " << layer.HasTransactions() << "): " << chrono.GetElapsedMilliseconds() << " ms"
+            << std::endl;
+
+  if (layer.GetFeatureCount(true) != nbFeatures)
+  {
+    std::cerr << "Fail: expecting " << nbFeatures << " features in the layer, got " << layer.GetFeatureCount(true) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The spatial index belongs to this proxy: the copy reads the features
+  // through the OGR spatial filters
+  chrono.Restart();
+  layer.BuildSpatialIndex();
+  chrono.Stop();
+  std::cout << "Indexing: " << chrono.GetElapsedMilliseconds() << " ms" << std::endl;
+
+  ogr::Layer unindexed = layer;
+  if (!layer.HasSpatialIndex() || unindexed.HasSpatialIndex())
+  {
+    std::cerr << "Fail: the spatial index shall belong to the layer it was built for" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const unsigned int nbQueries = 100;
+  otb::Stopwatch     indexChrono, filterChrono;
+  bool               success = true;
+  for (unsigned int q = 0; q < nbQueries && success; ++q)
+  {
+    OGREnvelope window;
+    window.MinX = position(generator);
+    window.MinY = position(generator);
+    window.MaxX = window.MinX + 50.;
+    window.MaxY = window.MinY + 50.;
+
+    std::vector<long> result;
+    indexChrono.Start();
+    layer.SetSpatialFilterRect(window.MinX, window.MinY, window.MaxX, window.MaxY);
+    for (auto const& feature : layer)
+    {
+      result.push_back(feature.GetFID());
+    }
+    indexChrono.Stop();
+
+    std::vector<long> expected;
+    filterChrono.Start();
+    for (auto const& feature : unindexed)
+    {
+      expected.push_back(feature.GetFID());
+    }
+    filterChrono.Stop();
+    layer.SetSpatialFilter(nullptr);
+
+    std::vector<long> envelopes;
+    layer.QuerySpatialIndex(window, envelopes);
+
+    std::sort(result.begin(), result.end());
+    std::sort(expected.begin(), expected.end());
+    if (result != expected || envelopes != expected)
+    {
+      std::cerr << "Fail: the spatial index found " << result.size() << " features (" << envelopes.size() << " envelopes), the spatial filter "
+                << expected.size() << std::endl;
+      success = false;
+    }
+  }
+  std::cout << nbQueries << " queries: spatial index " << indexChrono.GetElapsedMilliseconds() << " ms, spatial filter "
+            << filterChrono.GetElapsedMilliseconds() << " ms" << std::endl;
+
+  // Modifications through any copy of the layer, here a batch, outdate the
+  // index
+  {
+    ogr::BatchTransaction batch(layer, 1000);
+    ogr::Feature          feature(layer.GetLayerDefn());
+    OGRPoint              point(position(generator), position(generator));
+    feature.SetGeometry(&point);
+    batch.CreateFeature(feature);
+    batch.Commit();
+  }
+  if (layer.HasSpatialIndex())
+  {
+    std::cerr << "Fail: the spatial index is still up-to-date after a modification" << std::endl;
+    success = false;
+  }
+
+  // Outdated, the index is not used anymore: the new feature is found
+  layer.SetSpatialFilterRect(0., 0., 1000., 1000.);
+  const long nbFiltered = std::distance(layer.begin(), layer.end());
+  layer.SetSpatialFilter(nullptr);
+  if (nbFiltered != nbFeatures + 1)
+  {
+    std::cerr << "Fail: expecting " << nbFeatures + 1 << " features in the spatial filter, got " << nbFiltered << std::endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbOGRSpatialIndex.h"
+
+#include <iostream>
+#include <random>
+
+using namespace otb;
+
+int otbOGRSpatialIndexTest(int, char* [])
+{
+  bool success = true;
+
+  std::mt19937                           generator(42);
+  std::uniform_real_distribution<double> position(0., 1000.);
+  std::uniform_real_distribution<double> extent(0., 20.);
+
+  for (std::size_t capacity : {2, 4, 16})
+  {
+    for (std::size_t nbEnvelopes : {0, 1, 7, 300, 5000})
+    {
+      ogr::SpatialIndex        index(capacity);
+      std::vector<OGREnvelope> envelopes;
+      for (std::size_t i = 0; i < nbEnvelopes; ++i)
+      {
+        OGREnvelope e;
+        e.MinX = position(generator);
+        e.MinY = position(generator);
+        e.MaxX = e.MinX + extent(generator);
+        e.MaxY = e.MinY + extent(generator);
+        envelopes.push_back(e);
+        index.Insert(e, i);
+      }
+      index.Build();
+
+      if (index.GetSize() != nbEnvelopes)
+      {
+        std::cerr << "Fail: expecting " << nbEnvelopes << " indexed envelopes, got " << index.GetSize() << std::endl;
+        success = false;
+      }
+
+      // Compare with a brute force search
+      for (unsigned int q = 0; q < 200; ++q)
+      {
+        OGREnvelope window;
+        window.MinX = position(generator);
+        window.MinY = position(generator);
+        window.MaxX = window.MinX + 10 * extent(generator);
+        window.MaxY = window.MinY + 10 * extent(generator);
+
+        std::vector<ogr::SpatialIndex::IdType> result, expected;
+        index.Query(window, result);
+        for (std::size_t i = 0; i < nbEnvelopes; ++i)
+        {
+          if (envelopes[i].Intersects(window))
+          {
+            expected.push_back(i);
+          }
+        }
+
+        if (index.Intersects(window) != !expected.empty())
+        {
+          std::cerr << "Fail: capacity " << capacity << ", " << nbEnvelopes << " envelopes: Intersects() and Query() disagree" << std::endl;
+          success = false;
+          break;
+        }
+
+        if (result != expected)
+        {
+          std::cerr << "Fail: capacity " << capacity << ", " << nbEnvelopes << " envelopes: got " << result.size() << " envelopes intersecting the window, expected "
+                    << expected.size() << std::endl;
+          success = false;
+          break;
+        }
+      }
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
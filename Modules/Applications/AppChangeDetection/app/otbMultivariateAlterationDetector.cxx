@@ -75,6 +75,12 @@ private:
         " input image 1 and input image 2 to build the change map,\n"
         "- Rho, the vector of correlation associated to each change map.\n"
         " \n"
+        "By default the statistics are estimated on every pixel. When a number"
+        " of samples is given, they are estimated on a random subsample of the"
+        " pixels, drawn in a single pass and kept in memory. This also enables"
+        " the iteratively re-weighted MAD (IR-MAD) [3], which weights the pixels"
+        " by their probability of no change at each iteration.\n"
+        " \n"
         "The OTB filter used in this application has been implemented from the"
         " Matlab code kindly made available by the authors here [2]. Both cases"
         " (same and different number of bands) have been validated"
@@ -89,7 +95,9 @@ private:
         "[1] Nielsen, A. A., & Conradsen, K. (1997). Multivariate alteration"
         "detection (MAD) in multispectral, bi-temporal image data: A new"
         "approach to change detection studies.\n"
-        "[2] http://www2.imm.dtu.dk/~aa/software.html");
+        "[2] http://www2.imm.dtu.dk/~aa/software.html\n"
+        "[3] Nielsen, A. A. (2007). The regularized iteratively reweighted MAD"
+        " method for change detection in multi- and hyperspectral data.");
 
     AddDocTag(Tags::ChangeDetection);
 
@@ -100,6 +108,20 @@ private:
     AddParameter(ParameterType_OutputImage, "out", "Change Map");
     SetParameterDescription("out", "Multiband image containing change maps.");
 
+    AddParameter(ParameterType_Int, "samples", "Number of samples");
+    SetParameterDescription("samples",
+                            "Number of pixels randomly drawn to estimate the statistics. "
+                            "0 uses every pixel, which only allows a single iteration.");
+    SetDefaultParameterInt("samples", 0);
+    SetMinimumParameterIntValue("samples", 0);
+    MandatoryOff("samples");
+
+    AddParameter(ParameterType_Int, "iterations", "Maximum number of iterations");
+    SetParameterDescription("iterations", "Maximum number of iterations of IR-MAD. 1 gives the plain MAD.");
+    SetDefaultParameterInt("iterations", 1);
+    SetMinimumParameterIntValue("iterations", 1);
+    MandatoryOff("iterations");
+
     AddRAMParameter();
 
     // Doc example parameter settings
@@ -122,6 +144,8 @@ private:
 
     changeFilter->SetInput1(GetParameterImage("in1"));
     changeFilter->SetInput2(GetParameterImage("in2"));
+    changeFilter->SetNumberOfSamples(GetParameterInt("samples"));
+    changeFilter->SetMaximumNumberOfIterations(GetParameterInt("iterations"));
     changeFilter->GetOutput()->UpdateOutputInformation();
 
     otbAppLogINFO("Input 1 mean: " << changeFilter->GetMean1());
@@ -129,6 +153,7 @@ private:
     otbAppLogINFO("Input 1 transform: " << changeFilter->GetV1());
     otbAppLogINFO("Input 2 transform: " << changeFilter->GetV2());
     otbAppLogINFO("Rho: " << changeFilter->GetRho());
+    otbAppLogINFO("Number of iterations: " << changeFilter->GetNumberOfIterations());
 
     m_Ref = changeFilter;
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "otbVectorImage.h"
+#include "otbWrapperApplicationRegistry.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+typedef otb::VectorImage<double, 2> ImageType;
+typedef otb::VectorImage<float, 2>  OutputImageType;
+
+/** The application runs IR-MAD on two synthetic images of 4 bands: the
+ * second one is the first one plus a small noise, except on the 20 first
+ * columns where it is independent. The change variable of a pixel, the sum
+ * of its squared MAD variates scaled by their robust standard deviations,
+ * shall find these columns: it follows a chi-square distribution with 4
+ * degrees of freedom on the unchanged pixels. */
+int otbMultivariateAlterationDetectorIRMADAppTest(int itkNotUsed(argc), char* argv[])
+{
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  const unsigned int nbBands     = 4;
+  const unsigned int changedSize = 20;
+
+  ImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 100);
+  region.SetSize(1, 100);
+
+  ImageType::Pointer image1 = ImageType::New();
+  image1->SetRegions(region);
+  image1->SetNumberOfComponentsPerPixel(nbBands);
+  image1->Allocate();
+
+  ImageType::Pointer image2 = ImageType::New();
+  image2->SetRegions(region);
+  image2->SetNumberOfComponentsPerPixel(nbBands);
+  image2->Allocate();
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it1(image1, region);
+  itk::ImageRegionIterator<ImageType>          it2(image2, region);
+  for (it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    const bool           changed = static_cast<unsigned int>(it1.GetIndex()[0]) < changedSize;
+    ImageType::PixelType pixel1(nbBands), pixel2(nbBands);
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      pixel1[b] = 1000. + 100. * generator->GetNormalVariate();
+      pixel2[b] = changed ? 1000. + 100. * generator->GetNormalVariate() : pixel1[b] + 5. * generator->GetNormalVariate();
+    }
+    it1.Set(pixel1);
+    it2.Set(pixel2);
+  }
+
+  otb::Wrapper::ApplicationRegistry::SetApplicationPath(argv[1]);
+  auto app = otb::Wrapper::ApplicationRegistry::CreateApplication("MultivariateAlterationDetector");
+  if (app.IsNull())
+  {
+    std::cout << "Unable to load the MultivariateAlterationDetector application" << std::endl;
+    return EXIT_FAILURE;
+  }
+  app->SetParameterInputImage("in1", image1);
+  app->SetParameterInputImage("in2", image2);
+  app->SetParameterInt("samples", 5000);
+  app->SetParameterInt("iterations", 20);
+  app->Execute();
+
+  OutputImageType* output = dynamic_cast<OutputImageType*>(app->GetParameterOutputImage("out"));
+  output->Update();
+  if (output->GetNumberOfComponentsPerPixel() != nbBands)
+  {
+    std::cout << "Wrong number of MAD variates: " << output->GetNumberOfComponentsPerPixel() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Robust standard deviation of each MAD variate, from its median absolute
+  // value: the changed pixels are a minority
+  std::vector<double> deviations(nbBands);
+  for (unsigned int b = 0; b < nbBands; ++b)
+  {
+    std::vector<double>                            values;
+    itk::ImageRegionConstIterator<OutputImageType> outputIt(output, region);
+    for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+    {
+      values.push_back(std::abs(outputIt.Get()[b]));
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    deviations[b] = values[values.size() / 2] / 0.6745;
+  }
+
+  // 99.9% quantile of the chi-square distribution with 4 degrees of freedom
+  const double                                            threshold   = 18.47;
+  unsigned long                                           detected    = 0;
+  unsigned long                                           falseAlarms = 0;
+  unsigned long                                           nbChanged   = 0;
+  itk::ImageRegionConstIteratorWithIndex<OutputImageType> outputIt(output, region);
+  for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+  {
+    double chiSquare = 0.;
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      const double scaled = outputIt.Get()[b] / deviations[b];
+      chiSquare += scaled * scaled;
+    }
+    if (static_cast<unsigned int>(outputIt.GetIndex()[0]) < changedSize)
+    {
+      ++nbChanged;
+      detected += chiSquare > threshold ? 1 : 0;
+    }
+    else
+    {
+      falseAlarms += chiSquare > threshold ? 1 : 0;
+    }
+  }
+
+  const double detectionRate  = static_cast<double>(detected) / nbChanged;
+  const double falseAlarmRate = static_cast<double>(falseAlarms) / (region.GetNumberOfPixels() - nbChanged);
+  std::cout << "Detection rate: " << detectionRate << ", false alarm rate: " << falseAlarmRate << std::endl;
+
+  return detectionRate > 0.99 && falseAlarmRate < 0.01 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
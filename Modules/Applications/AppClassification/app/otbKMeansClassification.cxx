@@ -22,6 +22,10 @@
 #include "otbWrapperApplicationFactory.h"
 
 #include "otbOGRDataToSamplePositionFilter.h"
+#include "otbSharkKMeansMachineLearningModel.h"
+#include "otbShiftScaleVectorImageFilter.h"
+#include "otbStatisticsXMLFileReader.h"
+#include "otbStreamingMiniBatchKMeansImageFilter.h"
 
 namespace otb
 {
@@ -38,9 +42,14 @@ public:
   typedef itk::SmartPointer<const Self> ConstPointer;
 
   /** Standard macro */
-  itkTypeMacro(KMeansApplicationBase, Superclass)
+  itkTypeMacro(KMeansApplicationBase, Superclass);
 
-      protected : void InitKMParams()
+  typedef otb::ShiftScaleVectorImageFilter<FloatVectorImageType, FloatVectorImageType>   RescalerType;
+  typedef otb::StreamingMiniBatchKMeansImageFilter<FloatVectorImageType, UInt8ImageType> MiniBatchKMeansType;
+  typedef otb::SharkKMeansMachineLearningModel<float, int>                               KMeansModelType;
+
+protected:
+  void InitKMParams()
   {
     AddApplication("ImageEnvelope", "imgenvelop", "mean shift smoothing");
     AddApplication("PolygonClassStatistics", "polystats", "Polygon Class Statistics");
@@ -92,6 +101,30 @@ public:
                             "(one centroid per line with values separated by spaces).");
     MandatoryOff("centroids.in");
 
+    AddParameter(ParameterType_Choice, "algo", "Training algorithm");
+    SetParameterDescription("algo", "Algorithm used to learn the centroids.");
+
+    AddChoice("algo.shark", "Shark KMeans on a selection of samples");
+    SetParameterDescription("algo.shark",
+                            "A selection of pixels (see 'ts') is extracted to a vector file, "
+                            "and the Shark KMeans is trained in memory on these samples.");
+
+    AddChoice("algo.minibatch", "Streaming mini-batch KMeans");
+    SetParameterDescription("algo.minibatch",
+                            "The centroids are learnt from all the valid pixels of the image, streamed one division at a time. "
+                            "They are seeded with k-means++ from a random subset of 'ts' pixels, then refined by mini-batches "
+                            "during several passes over the image. The 'maxit' parameter is not used.");
+
+    AddParameter(ParameterType_Int, "algo.minibatch.bs", "Batch size");
+    SetParameterDescription("algo.minibatch.bs", "Number of pixels per mini-batch. The pixels of a batch are assigned to their centroid in parallel.");
+    SetDefaultParameterInt("algo.minibatch.bs", 1024);
+    SetMinimumParameterIntValue("algo.minibatch.bs", 1);
+
+    AddParameter(ParameterType_Int, "algo.minibatch.epochs", "Number of passes");
+    SetParameterDescription("algo.minibatch.epochs", "Number of passes over the whole image to refine the centroids.");
+    SetDefaultParameterInt("algo.minibatch.epochs", 3);
+    SetMinimumParameterIntValue("algo.minibatch.epochs", 1);
+
     ShareKMSamplingParameters();
     ConnectKMSamplingParams();
   }
@@ -265,6 +298,84 @@ public:
     otbAppLogINFO("output model: " << GetInternalApplication("training")->GetParameterString("io.out"));
   }
 
+  void TrainMiniBatchKMModel(FloatVectorImageType* image, const std::string& imagesStatsFileName, const std::string& modelFileName, unsigned int nbSamples)
+  {
+    // Center and reduce the pixels with the statistics used by ImageClassifier
+    auto statisticsReader = otb::StatisticsXMLFileReader<itk::VariableLengthVector<float>>::New();
+    statisticsReader->SetFileName(imagesStatsFileName);
+    auto meanMeasurementVector   = statisticsReader->GetStatisticVectorByName("mean");
+    auto stddevMeasurementVector = statisticsReader->GetStatisticVectorByName("stddev");
+
+    RescalerType::Pointer rescaler = RescalerType::New();
+    rescaler->SetInput(image);
+    rescaler->SetShift(meanMeasurementVector);
+    rescaler->SetScale(stddevMeasurementVector);
+
+    const unsigned int          nbClasses = GetParameterInt("nc");
+    MiniBatchKMeansType::Pointer kmeans    = MiniBatchKMeansType::New();
+    kmeans->SetInput(rescaler->GetOutput());
+    if (IsParameterEnabled("vm") && HasValue("vm"))
+      kmeans->SetMaskImage(GetParameterUInt8Image("vm"));
+    kmeans->SetNumberOfEpochs(GetParameterInt("algo.minibatch.epochs"));
+    kmeans->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
+    kmeans->GetFilter()->SetNumberOfClusters(nbClasses);
+    kmeans->GetFilter()->SetBatchSize(GetParameterInt("algo.minibatch.bs"));
+    kmeans->GetFilter()->SetReservoirSize(nbSamples);
+    if (IsParameterEnabled("rand"))
+      kmeans->GetFilter()->SetSeed(GetParameterInt("rand"));
+
+    if (IsParameterEnabled("centroids.in") && HasValue("centroids.in"))
+    {
+      shark::Data<shark::RealVector> centroidData;
+      shark::importCSV(centroidData, GetParameterString("centroids.in"), ' ');
+      if (centroidData.numberOfElements() != nbClasses)
+      {
+        otbAppLogWARNING("The input centroid file will not be used because it contains "
+                         << centroidData.numberOfElements() << " points, which is different than from the requested number of class: " << nbClasses << ".");
+      }
+      else
+      {
+        MiniBatchKMeansType::CentroidsType centroids;
+        for (const auto& point : centroidData.elements())
+        {
+          MiniBatchKMeansType::KMeansFilterType::CentroidType centroid(point.size());
+          for (unsigned int i = 0; i < point.size(); ++i)
+          {
+            centroid[i] = (point[i] - meanMeasurementVector[i]) / stddevMeasurementVector[i];
+          }
+          centroids.push_back(centroid);
+        }
+        kmeans->GetFilter()->SetInitialCentroids(centroids);
+      }
+    }
+
+    AddProcess(kmeans->GetStreamer(), "Mini-batch KMeans");
+    kmeans->Update();
+
+    // Save the centroids as a Shark KMeans model, so that ImageClassifier can
+    // load it
+    std::vector<shark::RealVector> centroidVectors;
+    for (const auto& centroid : kmeans->GetCentroids())
+    {
+      shark::RealVector point(centroid.Size());
+      for (unsigned int i = 0; i < centroid.Size(); ++i)
+      {
+        point[i] = centroid[i];
+      }
+      centroidVectors.push_back(point);
+    }
+    KMeansModelType::Pointer model = KMeansModelType::New();
+    model->SetK(nbClasses);
+    model->SetCentroidsFromData(shark::createDataFromRange(centroidVectors));
+    model->Save(modelFileName);
+    if (HasValue("centroids.out"))
+      model->ExportCentroids(GetParameterString("centroids.out"));
+
+    // classif.model points to training.io.out
+    GetInternalApplication("training")->SetParameterString("io.out", modelFileName);
+    otbAppLogINFO("output model: " << modelFileName);
+  }
+
   void ComputeImageStatistics(ImageBaseType* img, const std::string& imagesStatsFileName)
   {
     // std::vector<std::string> imageFileNameList = {imageFileName};
@@ -373,6 +484,9 @@ private:
         "6) TrainVectorClassifier: train the SharkKMeans model,\n"
         "7) ImageClassifier: perform the classification of the input image "
         "according to a model file.\n\n"
+        "With the mini-batch algorithm (algo=minibatch), steps 1 to 4 and 6 are replaced by a streaming "
+        "mini-batch KMeans, which learns the centroids from all the pixels of the image without loading "
+        "them in memory. The resulting model is a SharkKMeans model as well.\n\n"
         "It is possible to choose random/periodic modes of the SampleSelection application.\n"
         "If you do not want to keep the temporary files (sample selected, model file, ...), "
         "initialize cleanup parameter.\n"
@@ -417,6 +531,31 @@ private:
 
     KMeansFileNamesHandler fileNames(GetParameterString("out"));
 
+    // Compute number of sample max for KMeans
+    const int theoricNBSamplesForKMeans        = GetParameterInt("ts");
+    const int upperThresholdNBSamplesForKMeans = 1000 * 1000;
+    const int actualNBSamplesForKMeans         = std::min(theoricNBSamplesForKMeans, upperThresholdNBSamplesForKMeans);
+    otbAppLogINFO(<< actualNBSamplesForKMeans << " is the maximum sample size that will be used." << std::endl);
+
+    if (GetParameterString("algo") == "minibatch")
+    {
+      // Compute Images second order statistics
+      Superclass::ComputeImageStatistics(GetParameterImageBase("in"), fileNames.imgStatOutput);
+
+      // Learn the centroids from the whole image
+      Superclass::TrainMiniBatchKMModel(GetParameterImage("in"), fileNames.imgStatOutput, fileNames.modelFile, actualNBSamplesForKMeans);
+
+      // Compute a classification of the input image according to a model file
+      Superclass::KMeansClassif();
+
+      if (GetParameterInt("cleanup"))
+      {
+        otbAppLogINFO(<< "Final clean-up ...");
+        fileNames.clear();
+      }
+      return;
+    }
+
     const std::string fieldName = "field";
 
     // Create an image envelope
@@ -428,12 +567,6 @@ private:
     UpdateKMPolygonClassStatisticsParameters(fileNames.tmpVectorFile);
     Superclass::ComputePolygonStatistics(fileNames.polyStatOutput, fieldName);
 
-    // Compute number of sample max for KMeans
-    const int theoricNBSamplesForKMeans        = GetParameterInt("ts");
-    const int upperThresholdNBSamplesForKMeans = 1000 * 1000;
-    const int actualNBSamplesForKMeans         = std::min(theoricNBSamplesForKMeans, upperThresholdNBSamplesForKMeans);
-    otbAppLogINFO(<< actualNBSamplesForKMeans << " is the maximum sample size that will be used." << std::endl);
-
     // Compute SampleSelection and SampleExtraction app
     Superclass::SelectAndExtractSamples(fileNames.polyStatOutput, fieldName, fileNames.sampleOutput, actualNBSamplesForKMeans);
 
@@ -23,6 +23,7 @@
 
 #include "otbOGRDataSourceWrapper.h"
 #include "otbOGRFeatureWrapper.h"
+#include "otbOGRBatchTransaction.h"
 #include "otbStatisticsXMLFileWriter.h"
 
 #include "itkVariableLengthVector.h"
@@ -217,22 +218,17 @@ private:
     otb::ogr::Feature feature2 = layer2.ogr().GetNextFeature();
     unsigned int      count    = 0;
 
+    otb::ogr::BatchTransaction batch(layer2);
     if (feature2.addr())
       while (goesOn2)
       {
         feature2.ogr().SetField(GetParameterString("cfield").c_str(), (int)labelListSample->GetMeasurementVector(count)[0]);
-        layer2.SetFeature(feature2);
+        batch.SetFeature(feature2);
         feature2 = layer2.ogr().GetNextFeature();
         goesOn2  = feature2.addr() != nullptr;
         count++;
       }
-
-    const OGRErr err = layer2.ogr().CommitTransaction();
-
-    if (err != OGRERR_NONE)
-    {
-      itkExceptionMacro(<< "Unable to commit transaction for OGR layer " << layer2.ogr().GetName() << ".");
-    }
+    batch.Commit();
 
     source2->SyncToDisk();
 
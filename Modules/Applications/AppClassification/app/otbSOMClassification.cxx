@@ -145,6 +145,13 @@ private:
     SetParameterDescription("iv", "Maximum initial neuron weight");
     MandatoryOff("iv");
 
+    AddParameter(ParameterType_Int, "bs", "BatchSize");
+    SetParameterDescription("bs",
+                            "Number of samples per mini-batch. The winners of the samples of a batch are searched in parallel, "
+                            "and the map is updated once per batch. 0 updates the map after each sample.");
+    MandatoryOff("bs");
+    SetMinimumParameterIntValue("bs", 0);
+
     AddRANDParameter();
 
     AddRAMParameter();
@@ -160,6 +167,7 @@ private:
     SetDefaultParameterFloat("bi", 1.0);
     SetDefaultParameterFloat("bf", 0.1);
     SetDefaultParameterFloat("iv", 0.0);
+    SetDefaultParameterInt("bs", 0);
 
     // Doc example parameter settings
     SetDocExampleParameterValue("in", "QB_1_ortho.tif");
@@ -366,6 +374,7 @@ private:
     estimator->SetBetaInit(GetParameterFloat("bi"));
     estimator->SetBetaEnd(GetParameterFloat("bf"));
     estimator->SetMaxWeight(GetParameterFloat("iv"));
+    estimator->SetBatchSize(GetParameterInt("bs"));
 
     AddProcess(estimator, "Learning");
     estimator->Update();
@@ -22,6 +22,8 @@
 #include "otbWrapperApplicationFactory.h"
 
 #include "otbImageSampleExtractorFilter.h"
+#include "otbSampleTable.h"
+#include "itksys/SystemTools.hxx"
 
 namespace otb
 {
@@ -75,7 +77,10 @@ private:
     AddParameter(ParameterType_OutputFilename, "out", "Output samples");
     SetParameterDescription("out",
                             "Output vector data file storing sample"
-                            "values (OGR format). If not given, the input vector data file is updated");
+                            "values (OGR format). If not given, the input vector data file is updated. "
+                            "With the .ost extension, the class field and the sample values are written "
+                            "in a columnar sample table, which TrainVectorClassifier reads much faster "
+                            "than OGR formats.");
     MandatoryOff("out");
 
     AddParameter(ParameterType_Choice, "outfield", "Output field names");
@@ -159,7 +164,16 @@ private:
   {
     ogr::DataSource::Pointer vectors;
     ogr::DataSource::Pointer output;
-    if (IsParameterEnabled("out") && HasValue("out"))
+    bool                     sampleTableOutput = false;
+    if (IsParameterEnabled("out") && HasValue("out") &&
+        itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(this->GetParameterString("out"))) == ".ost")
+    {
+      // Samples are extracted in memory, then dumped in a sample table
+      vectors           = ogr::DataSource::New(this->GetParameterString("vec"));
+      output            = ogr::DataSource::New();
+      sampleTableOutput = true;
+    }
+    else if (IsParameterEnabled("out") && HasValue("out"))
     {
       vectors = ogr::DataSource::New(this->GetParameterString("vec"));
       output  = ogr::DataSource::New(this->GetParameterString("out"), ogr::DataSource::Modes::Overwrite);
@@ -211,7 +225,21 @@ private:
 
     AddProcess(filter->GetStreamer(), "Extracting sample values...");
     filter->Update();
-    output->SyncToDisk();
+
+    if (sampleTableOutput)
+    {
+      std::vector<std::string> columns(1, fieldName);
+      columns.insert(columns.end(), filter->GetOutputFieldNames().begin(), filter->GetOutputFieldNames().end());
+
+      otbAppLogINFO("Writing sample table " << this->GetParameterString("out"));
+      SampleTableWriter::Pointer writer = SampleTableWriter::New();
+      writer->AppendLayer(output->GetLayer(0), columns, SampleColumnType::Float32);
+      writer->Write(this->GetParameterString("out"));
+    }
+    else
+    {
+      output->SyncToDisk();
+    }
   }
 };
 
@@ -39,6 +39,25 @@ void LearningApplicationBase<TInputValue, TOutputValue>::InitKNNParams()
   SetParameterInt("classifier.knn.k", 32);
   SetParameterDescription("classifier.knn.k", "The number of neighbors to use.");
 
+  // Search algorithm
+  AddParameter(ParameterType_Choice, "classifier.knn.search", "Search algorithm");
+  SetParameterDescription("classifier.knn.search", "Algorithm used to search the neighbors of the samples to predict");
+
+  AddChoice("classifier.knn.search.bf", "Brute force");
+  SetParameterDescription("classifier.knn.search.bf", "Exhaustive search among the training samples");
+
+  AddChoice("classifier.knn.search.kdtree", "KD-tree");
+  SetParameterDescription("classifier.knn.search.kdtree",
+                          "Search in a KD-tree of the training samples, built at training time and saved in the model file. "
+                          "Much faster than the brute force search on large training sets.");
+
+  AddParameter(ParameterType_Int, "classifier.knn.search.kdtree.maxchecks", "Maximum number of leaf checks");
+  SetParameterInt("classifier.knn.search.kdtree.maxchecks", 0);
+  SetMinimumParameterIntValue("classifier.knn.search.kdtree.maxchecks", 0);
+  SetParameterDescription("classifier.knn.search.kdtree.maxchecks",
+                          "Maximum number of leaves of the KD-tree visited per sample. "
+                          "The search is exact if 0, approximate (faster, but the neighbors found may not be the nearest ones) otherwise.");
+
   if (this->m_RegressionFlag)
   {
     // Decision rule : mean / median
@@ -63,6 +82,11 @@ void LearningApplicationBase<TInputValue, TOutputValue>::TrainKNN(typename ListS
   knnClassifier->SetInputListSample(trainingListSample);
   knnClassifier->SetTargetListSample(trainingLabeledListSample);
   knnClassifier->SetK(GetParameterInt("classifier.knn.k"));
+  if (GetParameterString("classifier.knn.search") == "kdtree")
+  {
+    knnClassifier->SetAlgorithm(KNNType::KNN_KD_TREE);
+    knnClassifier->SetMaxLeafChecks(GetParameterInt("classifier.knn.search.kdtree.maxchecks"));
+  }
   if (this->m_RegressionFlag)
   {
     std::string decision = this->GetParameterString("classifier.knn.rule");
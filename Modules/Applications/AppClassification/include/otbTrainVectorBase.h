@@ -26,6 +26,7 @@
 
 #include "otbOGRDataSourceWrapper.h"
 #include "otbOGRFeatureWrapper.h"
+#include "otbSampleTable.h"
 #include "otbStatisticsXMLFileWriter.h"
 
 #include "itkVariableLengthVector.h"
@@ -163,6 +164,14 @@ protected:
    */
   SamplesWithLabel ExtractSamplesWithLabel(std::string parameterName, std::string parameterLayer, const ShiftScaleParameters& measurement);
 
+  /** Append the selected features and class of a sample table (see \c SampleTableWriter) to sample lists.
+   * Columns are read as a whole from the mapped file instead of one OGR field at a time.
+   * \param fileName the sample table file
+   * \param input the list of samples to fill
+   * \param target the list of labels to fill
+   */
+  void ReadSampleTable(const std::string& fileName, ListSampleType* input, TargetListSampleType* target);
+
 
   /**
    * Retrieve statistics mean and standard deviation if input statistics are provided.
@@ -22,6 +22,8 @@
 
 #include "otbTrainVectorBase.h"
 
+#include <algorithm>
+
 namespace otb
 {
 namespace Wrapper
@@ -104,23 +106,52 @@ void TrainVectorBase<TInputValue, TOutputValue>::DoUpdateParameters()
   if (this->HasValue("io.vd"))
   {
     std::vector<std::string> vectorFileList = this->GetParameterStringList("io.vd");
-    ogr::DataSource::Pointer ogrDS          = ogr::DataSource::New(vectorFileList[0], ogr::DataSource::Modes::Read);
-    ogr::Layer               layer          = ogrDS->GetLayer(static_cast<size_t>(this->GetParameterInt("layer")));
-    ogr::Feature             feature        = layer.ogr().GetNextFeature();
+
+    // Names and types of the available fields
+    std::vector<std::pair<std::string, OGRFieldType>> fields;
+    if (SampleTableReader::CanReadFile(vectorFileList[0]))
+    {
+      SampleTableReader::Pointer table = SampleTableReader::New();
+      table->Open(vectorFileList[0]);
+      for (std::size_t iColumn = 0; iColumn < table->GetNumberOfColumns(); iColumn++)
+      {
+        switch (table->GetColumnType(iColumn))
+        {
+        case SampleColumnType::Int32:
+          fields.emplace_back(table->GetColumnName(iColumn), OFTInteger);
+          break;
+        case SampleColumnType::Int64:
+          fields.emplace_back(table->GetColumnName(iColumn), OFTInteger64);
+          break;
+        default:
+          fields.emplace_back(table->GetColumnName(iColumn), OFTReal);
+        }
+      }
+    }
+    else
+    {
+      ogr::DataSource::Pointer ogrDS   = ogr::DataSource::New(vectorFileList[0], ogr::DataSource::Modes::Read);
+      ogr::Layer               layer   = ogrDS->GetLayer(static_cast<size_t>(this->GetParameterInt("layer")));
+      ogr::Feature             feature = layer.ogr().GetNextFeature();
+      for (int iField = 0; iField < feature.ogr().GetFieldCount(); iField++)
+      {
+        fields.emplace_back(feature.ogr().GetFieldDefnRef(iField)->GetNameRef(), feature.ogr().GetFieldDefnRef(iField)->GetType());
+      }
+    }
 
     this->ClearChoices("feat");
     this->ClearChoices("cfield");
 
     FieldParameter::TypeFilterType featTypeFilter = this->GetTypeFilter("feat");
     FieldParameter::TypeFilterType cfieldTypeFilter = this->GetTypeFilter("cfield");
-    for (int iField = 0; iField < feature.ogr().GetFieldCount(); iField++)
+    for (const auto& field : fields)
     {
-      std::string key, item = feature.ogr().GetFieldDefnRef(iField)->GetNameRef();
+      std::string key, item = field.first;
       key                       = item;
       std::string::iterator end = std::remove_if(key.begin(), key.end(), [](char c) { return !std::isalnum(c); });
       std::transform(key.begin(), end, key.begin(), tolower);
 
-      OGRFieldType fieldType = feature.ogr().GetFieldDefnRef(iField)->GetType();
+      OGRFieldType fieldType = field.second;
 
       if (featTypeFilter.empty() || std::find(featTypeFilter.begin(), featTypeFilter.end(), fieldType) != std::end(featTypeFilter))
       {
@@ -235,6 +266,13 @@ TrainVectorBase<TInputValue, TOutputValue>::ExtractSamplesWithLabel(std::string
     std::vector<std::string> fileList = this->GetParameterStringList(parameterName);
     for (unsigned int k = 0; k < fileList.size(); k++)
     {
+      if (SampleTableReader::CanReadFile(fileList[k]))
+      {
+        otbAppLogINFO("Reading sample table " << k + 1 << "/" << fileList.size());
+        ReadSampleTable(fileList[k], input, target);
+        continue;
+      }
+
       otbAppLogINFO("Reading vector file " << k + 1 << "/" << fileList.size());
       ogr::DataSource::Pointer source  = ogr::DataSource::New(fileList[k], ogr::DataSource::Modes::Read);
       ogr::Layer               layer   = source->GetLayer(static_cast<size_t>(this->GetParameterInt(parameterLayer)));
@@ -331,6 +369,59 @@ TrainVectorBase<TInputValue, TOutputValue>::ExtractSamplesWithLabel(std::string
 
   return samplesWithLabel;
 }
+
+template <class TInputValue, class TOutputValue>
+void TrainVectorBase<TInputValue, TOutputValue>::ReadSampleTable(const std::string& fileName, ListSampleType* input, TargetListSampleType* target)
+{
+  SampleTableReader::Pointer table = SampleTableReader::New();
+  table->Open(fileName);
+
+  int cColumnIndex = table->GetColumnIndex(m_FeaturesInfo.m_SelectedCFieldName);
+  if (cColumnIndex < 0 && !m_FeaturesInfo.m_SelectedCFieldName.empty())
+  {
+    otbAppLogFATAL("The field name for class label (" << m_FeaturesInfo.m_SelectedCFieldName << ") has not been found in the sample table " << fileName);
+  }
+
+  const unsigned int       nbFeatures = m_FeaturesInfo.m_NbFeatures;
+  std::vector<std::size_t> columnIndices(nbFeatures);
+  for (unsigned int i = 0; i < nbFeatures; i++)
+  {
+    int columnIndex = table->GetColumnIndex(m_FeaturesInfo.m_SelectedNames[i]);
+    if (columnIndex < 0)
+      otbAppLogFATAL("The field name for feature " << m_FeaturesInfo.m_SelectedNames[i] << " has not been found in the sample table " << fileName);
+    columnIndices[i] = columnIndex;
+  }
+
+  // The samples are copied from the mapped columns to the list samples, by
+  // blocks of rows interleaved in a buffer of one block
+  const std::uint64_t                               nbRows    = table->GetNumberOfRows();
+  const std::uint64_t                               blockSize = 4096;
+  const typename ListSampleType::InstanceIdentifier first     = input->Size();
+  input->Resize(first + nbRows);
+  target->Resize(first + nbRows);
+
+  std::vector<TInputValue>    block(blockSize * nbFeatures);
+  std::vector<ValueType>      labels(blockSize, 0.);
+  for (std::uint64_t begin = 0; begin < nbRows; begin += blockSize)
+  {
+    const std::uint64_t count = std::min(blockSize, nbRows - begin);
+    for (unsigned int idx = 0; idx < nbFeatures; ++idx)
+    {
+      table->ReadColumn(columnIndices[idx], begin, count, &block[idx], nbFeatures);
+    }
+    if (cColumnIndex >= 0)
+    {
+      table->ReadColumn(cColumnIndex, begin, count, labels.data());
+    }
+
+    for (std::uint64_t row = 0; row < count; ++row)
+    {
+      const SampleType sample(&block[row * nbFeatures], nbFeatures, false);
+      input->SetMeasurementVector(first + begin + row, sample);
+      target->SetMeasurementVector(first + begin + row, labels[row]);
+    }
+  }
+}
 }
 }
 
@@ -26,6 +26,7 @@
 
 #include "otbOGRDataSourceWrapper.h"
 #include "otbOGRFeatureWrapper.h"
+#include "otbOGRBatchTransaction.h"
 
 #include "itkVariableLengthVector.h"
 #include "otbStatisticsXMLFileReader.h"
@@ -241,6 +241,8 @@ void VectorPrediction<RegressionMode>::FillOutputLayer(otb::ogr::Layer& outLayer
 {
   unsigned int count          = 0;
   std::string  classfieldname = GetParameterString("cfield");
+  // Features are written by batches of transactions
+  ogr::BatchTransaction batch(outLayer);
   for (auto const& feature : layer)
   {
     ogr::Feature dstFeature(outLayer.GetLayerDefn());
@@ -266,14 +268,15 @@ void VectorPrediction<RegressionMode>::FillOutputLayer(otb::ogr::Layer& outLayer
       dstFeature[confFieldName].template SetValue<double>(quality->GetMeasurementVector(count)[0]);
     if (updateMode)
     {
-      outLayer.SetFeature(dstFeature);
+      batch.SetFeature(dstFeature);
     }
     else
     {
-      outLayer.CreateFeature(dstFeature);
+      batch.CreateFeature(dstFeature);
     }
     count++;
   }
+  batch.Commit();
 }
 
 template <bool RegressionMode>
@@ -334,24 +337,9 @@ void           VectorPrediction<RegressionMode>::DoExecute()
 
   otb::ogr::Layer outLayer = output->GetLayer(0);
 
-  OGRErr errStart = outLayer.ogr().StartTransaction();
-  if (errStart != OGRERR_NONE)
-  {
-    itkExceptionMacro(<< "Unable to start transaction for OGR layer " << outLayer.ogr().GetName() << ".");
-  }
-
   AddPredictionField(outLayer, layer, computeConfidenceMap);
   FillOutputLayer(outLayer, layer, target, quality, updateMode, computeConfidenceMap);
 
-  if (outLayer.ogr().TestCapability("Transactions"))
-  {
-    const OGRErr errCommitX = outLayer.ogr().CommitTransaction();
-    if (errCommitX != OGRERR_NONE)
-    {
-      itkExceptionMacro(<< "Unable to commit transaction for OGR layer " << outLayer.ogr().GetName() << ".");
-    }
-  }
-
   output->SyncToDisk();
 }
 
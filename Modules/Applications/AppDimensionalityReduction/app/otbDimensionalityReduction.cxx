@@ -133,6 +133,10 @@ private:
     SetParameterDescription("method.pca.whiten", "Perform whitening and ensure uncorrelated outputs with unit component wise variances");
     SetParameterInt("method.pca.whiten", 1);
     MandatoryOff("method.pca.whiten");
+    AddParameter(ParameterType_Bool, "method.pca.randomized", "Use a randomized decomposition");
+    SetParameterDescription("method.pca.randomized",
+                            "Estimate only the requested components with a streaming randomized decomposition, "
+                            "which avoids computing the full covariance matrix of inputs with many bands.");
 
     AddChoice("method.napca", "NA-PCA");
     SetParameterDescription("method.napca", "Noise Adjusted Principal Component Analysis.");
@@ -142,6 +146,9 @@ private:
     AddParameter(ParameterType_Int, "method.napca.radiusy", "Set the y radius of the sliding window");
     SetMinimumParameterIntValue("method.napca.radiusy", 1);
     SetDefaultParameterInt("method.napca.radiusy", 1);
+    AddParameter(ParameterType_Bool, "method.napca.randomized", "Use a randomized decomposition");
+    SetParameterDescription("method.napca.randomized",
+                            "Estimate only the requested components of the noise-whitened data with a streaming randomized decomposition.");
 
     AddChoice("method.maf", "MAF");
     SetParameterDescription("method.maf", "Maximum Autocorrelation Factor.");
@@ -159,6 +166,14 @@ private:
     SetDefaultParameterFloat("method.ica.mu", 1.);
     MandatoryOff("method.ica.mu");
 
+    AddParameter(ParameterType_Int, "method.ica.samples", "Number of samples");
+    SetParameterDescription("method.ica.samples",
+                            "Number of pixels randomly drawn to run the iterations in memory, in a single pass over the image. "
+                            "0 streams the whole image at each iteration.");
+    SetMinimumParameterIntValue("method.ica.samples", 0);
+    SetDefaultParameterInt("method.ica.samples", 0);
+    MandatoryOff("method.ica.samples");
+
     AddParameter(ParameterType_Choice, "method.ica.g", "Nonlinearity");
     SetParameterDescription("method.ica.g", "Nonlinearity used in the FastICA algorithm");
     AddChoice("method.ica.g.tanh", "tanh");
@@ -268,6 +283,7 @@ private:
       filter->SetInput(GetParameterFloatVectorImage("in"));
       filter->SetNumberOfPrincipalComponentsRequired(nbComp);
       filter->SetWhitening(GetParameterInt("method.pca.whiten"));
+      filter->SetUseRandomizedSVD(GetParameterInt("method.pca.randomized"));
 
       // Center AND reduce the input data.
       if (normalize)
@@ -349,6 +365,7 @@ private:
       filter->SetNumberOfPrincipalComponentsRequired(nbComp);
       filter->SetUseNormalization(normalize);
       filter->GetNoiseImageFilter()->SetRadius(radius);
+      filter->SetUseRandomizedSVD(GetParameterInt("method.napca.randomized"));
 
       if (HasValue("bv"))
       {
@@ -403,6 +420,7 @@ private:
       filter->SetNumberOfPrincipalComponentsRequired(nbComp);
       filter->SetNumberOfIterations(nbIterations);
       filter->SetMu(mu);
+      filter->SetNumberOfSamples(static_cast<unsigned long>(GetParameterInt("method.ica.samples")));
 
       switch (GetParameterInt("method.ica.g"))
       {
@@ -24,6 +24,7 @@
 #include "otbWaveletImageFilter.h"
 #include "otbWaveletInverseImageFilter.h"
 #include "otbWaveletGenerator.h"
+#include "otbLiftingWaveletImageFilter.h"
 
 #include <itkConfigure.h>
 #include <itkForwardFFTImageFilter.h>
@@ -87,9 +88,11 @@ private:
 
     // Documentation
     SetDocLongDescription("Domain Transform application for wavelet and fourier.");
-    SetDocLimitations("This application is not streamed, check your system resources when processing large images");
+    SetDocLimitations(
+        "This application is not streamed, check your system resources when processing large images. Only the lifting wavelets "
+        "(lifthaar, lift53 and lift97) are streamed.");
     SetDocAuthors("OTB-Team");
-    SetDocSeeAlso("otbWaveletImageFilter, otbWaveletInverseImageFilter, otbWaveletTransform");
+    SetDocSeeAlso("otbWaveletImageFilter, otbWaveletInverseImageFilter, otbWaveletTransform, otbLiftingWaveletImageFilter");
     AddDocTag(Tags::Filter);
 
     // Parameters
@@ -133,6 +136,12 @@ private:
     AddChoice("mode.wavelet.form.sb24", "SPLINE_BIORTHOGONAL_2_4");
     AddChoice("mode.wavelet.form.sb44", "SPLINE_BIORTHOGONAL_4_4");
     AddChoice("mode.wavelet.form.sym8", "SYMLET8");
+    AddChoice("mode.wavelet.form.lifthaar", "LIFTING_HAAR");
+    SetParameterDescription("mode.wavelet.form.lifthaar", "Haar wavelet computed with the lifting scheme (streamed)");
+    AddChoice("mode.wavelet.form.lift53", "LEGALL_5_3");
+    SetParameterDescription("mode.wavelet.form.lift53", "LeGall 5/3 wavelet computed with the lifting scheme (streamed)");
+    AddChoice("mode.wavelet.form.lift97", "CDF_9_7");
+    SetParameterDescription("mode.wavelet.form.lift97", "CDF 9/7 wavelet computed with the lifting scheme (streamed)");
 
     // Default values for mode
     SetParameterString("mode", "wavelet");
@@ -179,65 +188,75 @@ private:
 
     if (mode == 1)
     {
-      int          wavelet_type = GetParameterInt("mode.wavelet.form");
-      unsigned int nlevels      = GetParameterInt("mode.wavelet.nlevels");
-      switch (wavelet_type)
+      int               wavelet_type = GetParameterInt("mode.wavelet.form");
+      unsigned int      nlevels      = GetParameterInt("mode.wavelet.nlevels");
+      const std::string form         = GetParameterString("mode.wavelet.form");
+      if (form == "lifthaar" || form == "lift53" || form == "lift97")
       {
-      case 0:
-      {
-        DoWaveletTransform<otb::Wavelet::HAAR>(dir, nlevels);
-        break;
-      }
-      case 1:
-      {
-        DoWaveletTransform<otb::Wavelet::DB4>(dir, nlevels);
-        break;
-      }
-      case 2:
-      {
-        DoWaveletTransform<otb::Wavelet::DB4>(dir, nlevels);
-        break;
-      }
-      case 3:
-      {
-        DoWaveletTransform<otb::Wavelet::DB6>(dir, nlevels);
-        break;
-      }
-      case 4:
-      {
-        DoWaveletTransform<otb::Wavelet::DB8>(dir, nlevels);
-        break;
-      }
-      case 5:
-      {
-        DoWaveletTransform<otb::Wavelet::DB12>(dir, nlevels);
-        break;
-      }
-      case 6:
-      {
-        DoWaveletTransform<otb::Wavelet::DB20>(dir, nlevels);
-        break;
-      }
-      case 7:
-      {
-        DoWaveletTransform<otb::Wavelet::SPLINE_BIORTHOGONAL_2_4>(dir, nlevels);
-        break;
+        const otb::Wavelet::LiftingWavelet wavelet =
+            form == "lifthaar" ? otb::Wavelet::LIFTING_HAAR : (form == "lift53" ? otb::Wavelet::LEGALL_5_3 : otb::Wavelet::CDF_9_7);
+        DoLiftingWaveletTransform(dir, nlevels, wavelet);
       }
-      case 8:
-      {
-        DoWaveletTransform<otb::Wavelet::SPLINE_BIORTHOGONAL_4_4>(dir, nlevels);
-        break;
-      }
-      case 9:
-      {
-        DoWaveletTransform<otb::Wavelet::SYMLET8>(dir, nlevels);
-        break;
-      }
-      default:
+      else
       {
-        itkExceptionMacro(<< "Invalid wavelet type: '" << wavelet_type << "'");
-        break;
-      }
+        switch (wavelet_type)
+        {
+        case 0:
+        {
+          DoWaveletTransform<otb::Wavelet::HAAR>(dir, nlevels);
+          break;
+        }
+        case 1:
+        {
+          DoWaveletTransform<otb::Wavelet::DB4>(dir, nlevels);
+          break;
+        }
+        case 2:
+        {
+          DoWaveletTransform<otb::Wavelet::DB4>(dir, nlevels);
+          break;
+        }
+        case 3:
+        {
+          DoWaveletTransform<otb::Wavelet::DB6>(dir, nlevels);
+          break;
+        }
+        case 4:
+        {
+          DoWaveletTransform<otb::Wavelet::DB8>(dir, nlevels);
+          break;
+        }
+        case 5:
+        {
+          DoWaveletTransform<otb::Wavelet::DB12>(dir, nlevels);
+          break;
+        }
+        case 6:
+        {
+          DoWaveletTransform<otb::Wavelet::DB20>(dir, nlevels);
+          break;
+        }
+        case 7:
+        {
+          DoWaveletTransform<otb::Wavelet::SPLINE_BIORTHOGONAL_2_4>(dir, nlevels);
+          break;
+        }
+        case 8:
+        {
+          DoWaveletTransform<otb::Wavelet::SPLINE_BIORTHOGONAL_4_4>(dir, nlevels);
+          break;
+        }
+        case 9:
+        {
+          DoWaveletTransform<otb::Wavelet::SYMLET8>(dir, nlevels);
+          break;
+        }
+        default:
+        {
+          itkExceptionMacro(<< "Invalid wavelet type: '" << wavelet_type << "'");
+          break;
+        }
+        }
       }
     }
     else
@@ -343,6 +362,35 @@ private:
     CleanupFFTWThreads();
   }
 
+  /** The lifting filters are streamed: the pipeline is left to the writer */
+  void DoLiftingWaveletTransform(const int dir, const unsigned int nlevels, const otb::Wavelet::LiftingWavelet wavelet)
+  {
+    typedef otb::Image<InputPixelType>  TInputImage;
+    typedef otb::Image<OutputPixelType> TOutputImage;
+
+    if (dir == 0)
+    {
+      typedef otb::LiftingWaveletImageFilter<TInputImage, TOutputImage, otb::Wavelet::FORWARD> TLiftingImageFilter;
+
+      TLiftingImageFilter::Pointer liftingImageFilter = TLiftingImageFilter::New();
+      liftingImageFilter->SetInput(GetParameterImage<TInputImage>("in"));
+      liftingImageFilter->SetWavelet(wavelet);
+      liftingImageFilter->SetNumberOfDecompositions(nlevels);
+      SetParameterOutputImage<TOutputImage>("out", liftingImageFilter->GetOutput());
+    }
+    else
+    {
+      typedef otb::LiftingWaveletImageFilter<TInputImage, TOutputImage, otb::Wavelet::INVERSE> TLiftingImageFilter;
+
+      TLiftingImageFilter::Pointer liftingImageFilter = TLiftingImageFilter::New();
+      liftingImageFilter->SetInput(GetParameterImage<TInputImage>("in"));
+      liftingImageFilter->SetWavelet(wavelet);
+      liftingImageFilter->SetNumberOfDecompositions(nlevels);
+      SetParameterOutputImage<TOutputImage>("out", liftingImageFilter->GetOutput());
+    }
+    RegisterPipeline();
+  }
+
   template <otb::Wavelet::Wavelet TWaveletOperator>
   void DoWaveletTransform(const int dir, const unsigned int nlevels, const std::string inkey = "in", const std::string outkey = "out")
   {
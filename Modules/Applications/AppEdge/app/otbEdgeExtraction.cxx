@@ -27,6 +27,16 @@
 //#include "itkCannyEdgeDetectionImageFilter.h"
 #include "otbTouziEdgeDetectorImageFilter.h"
 
+#include "otbGaborFilterGenerator.h"
+#include "otbConvolutionImageFilter.h"
+#include "otbOverlapSaveConvolutionImageFilter.h"
+#include "otbImageList.h"
+#include "otbImageListToVectorImageFilter.h"
+#include "otbMath.h"
+
+#include <cmath>
+#include <vector>
+
 #include "otbMultiToMonoChannelExtractROI.h"
 
 namespace otb
@@ -50,6 +60,12 @@ public:
   //                                                    CannyFilterType;
   typedef TouziEdgeDetectorImageFilter<FloatImageType, FloatImageType> TouziFilterType;
 
+  typedef GaborFilterGenerator<double>                                      GaborGeneratorType;
+  typedef ConvolutionImageFilter<FloatImageType, FloatImageType>            ConvolutionFilterType;
+  typedef OverlapSaveConvolutionImageFilter<FloatImageType, FloatImageType> OverlapSaveFilterType;
+  typedef ImageList<FloatImageType>                                         ImageListType;
+  typedef ImageListToVectorImageFilter<ImageListType, FloatVectorImageType> ListConcatenerFilterType;
+
   /** Standard macro */
   itkNewMacro(Self);
 
@@ -66,7 +82,7 @@ private:
     // Documentation
     SetDocLongDescription(
         "This application computes edge features on a selected channel of the input."
-        "It uses different filters such as gradient, Sobel and Touzi");
+        "It uses different filters such as gradient, Sobel, Touzi and a bank of Gabor kernels");
 
     SetDocLimitations("None");
     SetDocAuthors("OTB-Team");
@@ -110,6 +126,36 @@ private:
     AddParameter(ParameterType_Int, "filter.touzi.yradius", "Y radius of the neighborhood");
     SetDefaultParameterInt("filter.touzi.yradius", 1);
 
+    // Gabor Section
+    AddChoice("filter.gabor", "Gabor");
+    SetParameterDescription("filter.gabor",
+                            "This filter convolves the image with a bank of Gabor kernels (real part), "
+                            "one per orientation, and outputs one band per orientation. Kernels of low rank, "
+                            "such as the axis aligned ones, are applied as successive 1-D passes, and large "
+                            "kernels are applied in the Fourier domain when FFTW is available.");
+    AddParameter(ParameterType_Int, "filter.gabor.radius", "Radius of the kernels");
+    SetDefaultParameterInt("filter.gabor.radius", 8);
+    SetMinimumParameterIntValue("filter.gabor.radius", 1);
+    AddParameter(ParameterType_Float, "filter.gabor.a", "Envelope scale along the orientation");
+    SetParameterDescription("filter.gabor.a", "Scale of the gaussian envelope along the orientation of the kernel.");
+    SetDefaultParameterFloat("filter.gabor.a", 0.1);
+    AddParameter(ParameterType_Float, "filter.gabor.b", "Envelope scale across the orientation");
+    SetParameterDescription("filter.gabor.b", "Scale of the gaussian envelope across the orientation of the kernel.");
+    SetDefaultParameterFloat("filter.gabor.b", 0.1);
+    AddParameter(ParameterType_Float, "filter.gabor.frequency", "Carrier frequency");
+    SetParameterDescription("filter.gabor.frequency", "Spatial frequency of the sinusoidal carrier, in cycles per pixel.");
+    SetDefaultParameterFloat("filter.gabor.frequency", 0.1);
+    AddParameter(ParameterType_Int, "filter.gabor.nbangles", "Number of orientations");
+    SetParameterDescription("filter.gabor.nbangles", "Number of orientations of the bank, evenly spaced in [0, 180[ degrees.");
+    SetDefaultParameterInt("filter.gabor.nbangles", 4);
+    SetMinimumParameterIntValue("filter.gabor.nbangles", 1);
+    AddParameter(ParameterType_Int, "filter.gabor.fftradius", "Radius of the Fourier domain convolution");
+    SetParameterDescription("filter.gabor.fftradius",
+                            "Kernels of at least this radius are applied in the Fourier domain (overlap-save "
+                            "algorithm), which is faster for large kernels. 0 never uses it.");
+    SetDefaultParameterInt("filter.gabor.fftradius", 16);
+    SetMinimumParameterIntValue("filter.gabor.fftradius", 0);
+
     // Canny Section
     /*
     AddChoice("filter.canny", "Canny");
@@ -187,6 +233,61 @@ private:
       m_TouziFilter->SetRadius(rad);
       SetParameterOutputImage("out", m_TouziFilter->GetOutput());
     }
+
+    if (edgeType == "gabor")
+    {
+      const unsigned int radius    = GetParameterInt("filter.gabor.radius");
+      const unsigned int nbAngles  = GetParameterInt("filter.gabor.nbangles");
+      const double       frequency = GetParameterFloat("filter.gabor.frequency");
+      const unsigned int fftRadius = GetParameterInt("filter.gabor.fftradius");
+
+      // The Gabor kernels are symmetric with respect to their center, so the
+      // spatial and Fourier convolutions give the same result
+      const bool useFFT = fftRadius > 0 && radius >= fftRadius && OverlapSaveFilterType::FFTWTraitsType::IsAvailable();
+      otbAppLogINFO(<< "Gabor bank of " << nbAngles << " kernels of radius " << radius << " applied in the "
+                    << (useFFT ? "Fourier" : "spatial") << " domain");
+
+      GaborGeneratorType::RadiusType gaborRadius;
+      gaborRadius.Fill(radius);
+
+      m_ImageList = ImageListType::New();
+      m_ConvolutionFilters.clear();
+      for (unsigned int k = 0; k < nbAngles; ++k)
+      {
+        const double theta = 180. * k / nbAngles;
+
+        GaborGeneratorType::Pointer gabor = GaborGeneratorType::New();
+        gabor->SetRadius(gaborRadius);
+        gabor->SetA(GetParameterFloat("filter.gabor.a"));
+        gabor->SetB(GetParameterFloat("filter.gabor.b"));
+        gabor->SetTheta(theta);
+        gabor->SetU0(frequency * std::cos(theta * CONST_PI_180));
+        gabor->SetV0(frequency * std::sin(theta * CONST_PI_180));
+
+        if (useFFT)
+        {
+          OverlapSaveFilterType::Pointer convolution = OverlapSaveFilterType::New();
+          convolution->SetInput(m_ExtractorFilter->GetOutput());
+          convolution->SetRadius(gaborRadius);
+          convolution->SetFilter(gabor->GetFilter());
+          m_ImageList->PushBack(convolution->GetOutput());
+          m_ConvolutionFilters.push_back(convolution.GetPointer());
+        }
+        else
+        {
+          ConvolutionFilterType::Pointer convolution = ConvolutionFilterType::New();
+          convolution->SetInput(m_ExtractorFilter->GetOutput());
+          convolution->SetRadius(gaborRadius);
+          convolution->SetFilter(gabor->GetFilter());
+          m_ImageList->PushBack(convolution->GetOutput());
+          m_ConvolutionFilters.push_back(convolution.GetPointer());
+        }
+      }
+
+      m_Concatener = ListConcatenerFilterType::New();
+      m_Concatener->SetInput(m_ImageList);
+      SetParameterOutputImage("out", m_Concatener->GetOutput());
+    }
     /*
       if( edgeType == "canny" )
         {
@@ -206,6 +307,10 @@ private:
   GradientFilterType::Pointer  m_GradientFilter;
   SobelFilterType::Pointer     m_SobelFilter;
   TouziFilterType::Pointer     m_TouziFilter;
+
+  ImageListType::Pointer                   m_ImageList;
+  ListConcatenerFilterType::Pointer        m_Concatener;
+  std::vector<itk::ProcessObject::Pointer> m_ConvolutionFilters;
   // CannyFilterType::Pointer     m_CannyFilter;
 };
 } // namespace Wrapper
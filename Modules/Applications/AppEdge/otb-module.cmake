@@ -28,6 +28,8 @@ otb_module(OTBAppEdge
     OTBImageBase
     OTBApplicationEngine
     OTBEdge
+    OTBConvolution
+    OTBImageList
     OTBImageManipulation
     OTBProjection
 
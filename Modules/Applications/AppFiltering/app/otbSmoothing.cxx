@@ -25,6 +25,7 @@
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkGradientAnisotropicDiffusionImageFilter.h"
 #include "otbPerBandVectorImageFilter.h"
+#include "otbConvolutionImageFilter.h"
 
 namespace otb
 {
@@ -94,6 +95,12 @@ private:
     SetParameterDescription("type.mean.radius", "Kernel's radius (in pixels)");
     SetDefaultParameterInt("type.mean.radius", 2);
 
+    AddParameter(ParameterType_Bool, "type.mean.separable", "Separable passes");
+    SetParameterDescription("type.mean.separable",
+                            "Apply the mean as a horizontal and a vertical 1-D pass, whose cost grows "
+                            "linearly with the radius instead of quadratically. The result may differ "
+                            "from the default mean filter by rounding errors.");
+
     AddChoice("type.gaussian", "Gaussian");
 
     AddParameter(ParameterType_Float, "type.gaussian.stdev", "Standard deviation");
@@ -165,6 +172,29 @@ private:
     {
       otbAppLogINFO("Using mean smoothing");
 
+      if (GetParameterInt("type.mean.separable"))
+      {
+        // The box kernel is detected as separable by the convolution filter
+        typedef otb::ConvolutionImageFilter<ImageType, ImageType> ConvolutionFilterType;
+        typedef otb::PerBandVectorImageFilter<FloatVectorImageType, FloatVectorImageType, ConvolutionFilterType> PerBandConvolutionFilterType;
+
+        auto perBand = PerBandConvolutionFilterType::New();
+        perBand->SetInput(inImage);
+
+        ConvolutionFilterType::InputSizeType radius;
+        radius.Fill(GetParameterInt("type.mean.radius"));
+        ConvolutionFilterType::ArrayType kernel((2 * radius[0] + 1) * (2 * radius[1] + 1));
+        kernel.Fill(1.);
+        perBand->GetFilter()->SetRadius(radius);
+        perBand->GetFilter()->SetFilter(kernel);
+        perBand->GetFilter()->NormalizeFilterOn();
+
+        SetParameterOutputImage("out", perBand->GetOutput());
+
+        RegisterPipeline();
+        break;
+      }
+
       typedef itk::MeanImageFilter<ImageType, ImageType> MeanFilterType;
       typedef otb::PerBandVectorImageFilter<FloatVectorImageType, FloatVectorImageType, MeanFilterType> PerBandMeanFilterType;
 
@@ -31,6 +31,7 @@ otb_module(OTBAppFiltering
     OTBStreaming
     OTBFunctor
     OTBSmoothing
+    OTBConvolution
 
   TEST_DEPENDS
     OTBTestKernel
@@ -24,6 +24,7 @@
 #include "otbStreamingStatisticsVectorImageFilter.h"
 #include "otbEigenvalueLikelihoodMaximisation.h"
 #include "otbVirtualDimensionality.h"
+#include "otbStreamingStratifiedSampleImageFilter.h"
 
 namespace otb
 {
@@ -47,6 +48,7 @@ public:
   typedef otb::StreamingStatisticsVectorImageFilter<FloatVectorImageType, double> StreamingStatisticsVectorImageFilterType;
   typedef otb::VirtualDimensionality<double>            VirtualDimensionalityType;
   typedef otb::EigenvalueLikelihoodMaximisation<double> EigenvalueLikelihoodMaximisationType;
+  typedef otb::StreamingStratifiedSampleImageFilter<FloatVectorImageType> SamplerFilterType;
 
 private:
   void DoInit() override
@@ -66,6 +68,10 @@ private:
 
         "The application then returns the estimated number of endmembers.\n\n"
 
+        "The statistics can be computed on a spatially stratified subset of "
+        "the pixels, drawn in a single pass and held in memory, instead of the "
+        "whole image.\n\n"
+
         "[1] C.-I. Chang and Q. Du, Estimation of number of spectrally distinct signal "
         "sources in hyperspectral imagery, IEEE Transactions on Geoscience and Remote "
         "Sensing, vol. 43, no. 3, mar 2004.\n\n"
@@ -108,6 +114,14 @@ private:
     SetDefaultParameterFloat("algo.vd.far", 1.0E-3);
     SetParameterDescription("algo.vd.far", "False alarm rate for the virtual dimensionality algorithm");
 
+    AddParameter(ParameterType_Int, "samples", "Number of samples");
+    SetParameterDescription("samples",
+                            "Approximate number of pixels, drawn on a regular grid, on which the "
+                            "statistics are computed. 0 computes them on the whole image.");
+    SetDefaultParameterInt("samples", 0);
+    SetMinimumParameterIntValue("samples", 0);
+    MandatoryOff("samples");
+
     AddRAMParameter();
 
     // Doc example parameter settings
@@ -128,16 +142,73 @@ private:
     // Load input image
     auto inputImage = GetParameterImage("in");
 
-    otbAppLogINFO("Computing statistics on input image...");
-    auto statisticsFilter = StreamingStatisticsVectorImageFilterType::New();
-    statisticsFilter->SetInput(inputImage);
-    AddProcess(statisticsFilter->GetStreamer(), "Statistic estimation step");
+    vnl_matrix<double> correlationMatrix;
+    vnl_matrix<double> covarianceMatrix;
+    unsigned long      numberOfPixels = 0;
 
-    statisticsFilter->Update();
+    if (GetParameterInt("samples") > 0)
+    {
+      otbAppLogINFO("Drawing samples from input image...");
+      auto sampler = SamplerFilterType::New();
+      sampler->SetInput(inputImage);
+      sampler->GetFilter()->SetNumberOfSamples(GetParameterInt("samples"));
+      AddProcess(sampler->GetStreamer(), "Sampling step");
+      sampler->Update();
+
+      numberOfPixels = sampler->GetNumberOfValidSamples();
+      if (numberOfPixels < 2)
+      {
+        otbAppLogFATAL(<< "Not enough valid samples to compute the statistics: " << numberOfPixels);
+      }
+      otbAppLogINFO(<< "Computing statistics on " << numberOfPixels << " samples...");
+
+      // Same estimators as StreamingStatisticsVectorImageFilter: biased
+      // correlation and unbiased covariance
+      const unsigned int nbBands = inputImage->GetNumberOfComponentsPerPixel();
+      const double*      sample  = sampler->GetSamples().data();
+      vnl_vector<double> mean(nbBands, 0.);
+      correlationMatrix.set_size(nbBands, nbBands);
+      correlationMatrix.fill(0.);
+      for (unsigned long s = 0; s < numberOfPixels; ++s, sample += nbBands)
+      {
+        for (unsigned int r = 0; r < nbBands; ++r)
+        {
+          mean[r] += sample[r];
+          for (unsigned int c = 0; c <= r; ++c)
+          {
+            correlationMatrix(r, c) += sample[r] * sample[c];
+          }
+        }
+      }
+      mean /= static_cast<double>(numberOfPixels);
+
+      const double regul = static_cast<double>(numberOfPixels) / (static_cast<double>(numberOfPixels) - 1.);
+      covarianceMatrix.set_size(nbBands, nbBands);
+      for (unsigned int r = 0; r < nbBands; ++r)
+      {
+        for (unsigned int c = 0; c <= r; ++c)
+        {
+          correlationMatrix(r, c) /= static_cast<double>(numberOfPixels);
+          correlationMatrix(c, r) = correlationMatrix(r, c);
+          covarianceMatrix(r, c)  = regul * (correlationMatrix(r, c) - mean[r] * mean[c]);
+          covarianceMatrix(c, r)  = covarianceMatrix(r, c);
+        }
+      }
+    }
+    else
+    {
+      otbAppLogINFO("Computing statistics on input image...");
+      auto statisticsFilter = StreamingStatisticsVectorImageFilterType::New();
+      statisticsFilter->SetInput(inputImage);
+      statisticsFilter->SetEnableMinMax(false);
+      AddProcess(statisticsFilter->GetStreamer(), "Statistic estimation step");
+
+      statisticsFilter->Update();
 
-    auto correlationMatrix = statisticsFilter->GetCorrelation().GetVnlMatrix();
-    auto covarianceMatrix  = statisticsFilter->GetCovariance().GetVnlMatrix();
-    auto numberOfPixels    = inputImage->GetLargestPossibleRegion().GetNumberOfPixels();
+      correlationMatrix = statisticsFilter->GetCorrelation().GetVnlMatrix();
+      covarianceMatrix  = statisticsFilter->GetCovariance().GetVnlMatrix();
+      numberOfPixels    = inputImage->GetLargestPossibleRegion().GetNumberOfPixels();
+    }
 
     int               numberOfEndmembers = 0;
     const std::string algorithm          = GetParameterString("algo");
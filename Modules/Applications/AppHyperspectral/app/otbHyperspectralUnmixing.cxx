@@ -21,17 +21,16 @@
 #include "otbWrapperApplication.h"
 #include "otbWrapperApplicationFactory.h"
 
-#include "otbUnConstrainedLeastSquareImageFilter.h"
-#include "otbISRAUnmixingImageFilter.h"
+#include "otbLinearUnmixingImageFilter.h"
 #include "otbMDMDNMFImageFilter.h"
+#include "otbVectorImageToMatrixImageFilter.h"
 
 
 namespace otb
 {
 namespace Wrapper
 {
-typedef otb::UnConstrainedLeastSquareImageFilter<DoubleVectorImageType, DoubleVectorImageType, double> UCLSUnmixingFilterType;
-typedef otb::ISRAUnmixingImageFilter<DoubleVectorImageType, DoubleVectorImageType, double>             ISRAUnmixingFilterType;
+typedef otb::LinearUnmixingImageFilter<DoubleVectorImageType, DoubleVectorImageType, double> LinearUnmixingFilterType;
 typedef otb::MDMDNMFImageFilter<DoubleVectorImageType, DoubleVectorImageType> MDMDNMFUnmixingFilterType;
 
 typedef otb::VectorImageToMatrixImageFilter<DoubleVectorImageType> VectorImageToMatrixImageFilterType;
@@ -60,14 +59,14 @@ enum EndmembersEstimationMethod
 enum UnMixingMethod
 {
   UnMixingMethod_UCLS,
-  // UnMixingMethod_FCLS,
   // UnMixingMethod_NCLS,
   UnMixingMethod_ISRA,
   UnMixingMethod_MDMDNMF,
+  UnMixingMethod_FCLS,
 };
 
 const char* UnMixingMethodNames[] = {
-    "UCLS", "ISRA", "MDMDNMF",
+    "UCLS", "ISRA", "MDMDNMF", "FCLS",
 };
 
 
@@ -105,7 +104,8 @@ private:
         "* Unconstrained Least Square (ucls)\n"
         "* Image Space Reconstruction Algorithm (isra)\n"
         "* Least Square (ncls)\n"
-        "* Minimum Dispersion Constrained Non Negative Matrix Factorization (MDMDNMF).");
+        "* Minimum Dispersion Constrained Non Negative Matrix Factorization (MDMDNMF)\n"
+        "* Fully Constrained Least Square (fcls).");
     SetDocLimitations("None");
     SetDocAuthors("OTB-Team");
     SetDocSeeAlso("VertexComponentAnalysis");
@@ -138,6 +138,9 @@ private:
 
     AddChoice("ua.mdmdnmf", "MDMDNMF");
     SetParameterDescription("ua.mdmdnmf", "Minimum Dispersion Constrained Non Negative Matrix Factorization");
+
+    AddChoice("ua.fcls", "FCLS");
+    SetParameterDescription("ua.fcls", "Fully Constrained Least Square: non negative abundances, summing to one");
     SetParameterString("ua", "ucls");
     // Doc example parameter settings
     SetDocExampleParameterValue("in", "cupriteSubHsi.tif");
@@ -180,27 +183,24 @@ private:
     switch (static_cast<UnMixingMethod>(GetParameterInt("ua")))
     {
     case UnMixingMethod_UCLS:
-    {
-      otbAppLogINFO("UCLS Unmixing");
-
-      UCLSUnmixingFilterType::Pointer unmixer = UCLSUnmixingFilterType::New();
-
-      unmixer->SetInput(inputImage);
-      unmixer->GetModifiableFunctor().SetMatrix(endMembersMatrix);
-      unmixer->SetNumberOfThreads(1); // FIXME : currently buggy
-
-      abundanceMap = unmixer->GetOutput();
-      m_ProcessObjects.push_back(unmixer.GetPointer());
-    }
-    break;
     case UnMixingMethod_ISRA:
+    case UnMixingMethod_FCLS:
     {
-      otbAppLogINFO("ISRA Unmixing");
+      const UnMixingMethod method = static_cast<UnMixingMethod>(GetParameterInt("ua"));
+      otbAppLogINFO(<< UnMixingMethodNames[method] << " Unmixing");
 
-      ISRAUnmixingFilterType::Pointer unmixer = ISRAUnmixingFilterType::New();
+      LinearUnmixingFilterType::Pointer unmixer = LinearUnmixingFilterType::New();
 
       unmixer->SetInput(inputImage);
-      unmixer->GetModifiableFunctor().SetEndmembersMatrix(endMembersMatrix);
+      unmixer->SetEndmembersMatrix(endMembersMatrix);
+      if (method == UnMixingMethod_ISRA)
+      {
+        unmixer->SetMethod(LinearUnmixingFilterType::ISRA);
+      }
+      else if (method == UnMixingMethod_FCLS)
+      {
+        unmixer->SetMethod(LinearUnmixingFilterType::FCLS);
+      }
       abundanceMap = unmixer->GetOutput();
       m_ProcessObjects.push_back(unmixer.GetPointer());
     }
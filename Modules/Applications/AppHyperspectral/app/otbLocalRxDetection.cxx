@@ -22,7 +22,6 @@
 #include "otbWrapperApplicationFactory.h"
 
 #include "otbLocalRxDetectorFilter.h"
-#include "otbFunctorImageFilter.h"
 
 namespace otb
 {
@@ -47,6 +46,8 @@ public:
   typedef DoubleVectorImageType VectorImageType;
   typedef DoubleImageType       ImageType;
 
+  typedef LocalRxDetectorFilter<VectorImageType, ImageType> LocalRxDetectorFilterType;
+
 private:
   void DoInit() override
   {
@@ -105,18 +106,12 @@ private:
     auto inputImage = GetParameterDoubleVectorImage("in");
     inputImage->UpdateOutputInformation();
 
-    Functor::LocalRxDetectionFunctor<double> detectorFunctor;
-
-    unsigned int externalRadius = GetParameterInt("er");
-    unsigned int internalRadius = GetParameterInt("ir");
-
-    detectorFunctor.SetInternalRadius(internalRadius, internalRadius);
-
-    // Create a functorImageFilter with the localRx functor and the appropriate
-    // external radius.
-    auto localRxDetectionFilter = otb::NewFunctorFilter(detectorFunctor, {{externalRadius, externalRadius}});
-
-    localRxDetectionFilter->SetInputs(inputImage);
+    // The filter slides the annulus statistics instead of computing them
+    // from the whole neighborhood of each pixel
+    auto localRxDetectionFilter = LocalRxDetectorFilterType::New();
+    localRxDetectionFilter->SetExternalRadius(GetParameterInt("er"));
+    localRxDetectionFilter->SetInternalRadius(GetParameterInt("ir"));
+    localRxDetectionFilter->SetInput(inputImage);
 
     SetParameterOutputImage("out", localRxDetectionFilter->GetOutput());
     RegisterPipeline();
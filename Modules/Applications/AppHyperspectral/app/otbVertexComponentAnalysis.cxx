@@ -22,6 +22,7 @@
 #include "otbWrapperApplicationFactory.h"
 
 #include "otbVcaImageFilter.h"
+#include "otbEigenvalueLikelihoodMaximisation.h"
 
 namespace otb
 {
@@ -31,6 +32,8 @@ namespace Wrapper
 
 typedef otb::VCAImageFilter<DoubleVectorImageType>                 VCAFilterType;
 typedef otb::VectorImageToMatrixImageFilter<DoubleVectorImageType> VectorImageToMatrixImageFilterType;
+typedef VCAFilterType::StreamingStatisticsVectorImageFilterType    StatisticsFilterType;
+typedef otb::EigenvalueLikelihoodMaximisation<double>              EigenvalueLikelihoodMaximisationType;
 
 class VertexComponentAnalysis : public Application
 {
@@ -88,10 +91,23 @@ private:
     MandatoryOn("outendm");
 
     AddParameter(ParameterType_Int, "ne", "Number of endmembers");
-    SetParameterDescription("ne", "The number of endmembers to extract from the hyperspectral image.");
+    SetParameterDescription("ne",
+                            "The number of endmembers to extract from the hyperspectral image. "
+                            "0 estimates it with the Eigenvalue Likelihood Maximization, "
+                            "from the image statistics also used by the VCA.");
     SetParameterInt("ne", 1);
+    SetMinimumParameterIntValue("ne", 0);
     MandatoryOn("ne");
 
+    AddParameter(ParameterType_Int, "samples", "Number of samples");
+    SetParameterDescription("samples",
+                            "Approximate number of pixels, drawn on a regular grid, among which the "
+                            "endmembers are searched in memory. 0 searches them in the whole image, "
+                            "with a pass over the image per endmember.");
+    SetDefaultParameterInt("samples", 0);
+    SetMinimumParameterIntValue("samples", 0);
+    MandatoryOff("samples");
+
     AddRANDParameter();
     // Doc example parameter settings
     SetDocExampleParameterValue("in", "cupriteSubHsi.tif");
@@ -111,9 +127,37 @@ private:
     DoubleVectorImageType::Pointer inputImage = GetParameterDoubleVectorImage("in");
     DoubleVectorImageType::Pointer endmembersImage;
 
-    const unsigned int     nbEndmembers = GetParameterInt("ne");
+    unsigned int           nbEndmembers = GetParameterInt("ne");
     VCAFilterType::Pointer vca          = VCAFilterType::New();
+
+    if (nbEndmembers == 0)
+    {
+      // The statistics are computed once, for the estimation and the VCA
+      otbAppLogINFO("Computing statistics on input image...");
+      StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+      statistics->SetInput(inputImage);
+      statistics->SetEnableMinMax(false);
+      AddProcess(statistics->GetStreamer(), "Statistic estimation step");
+      statistics->Update();
+
+      EigenvalueLikelihoodMaximisationType::Pointer elm = EigenvalueLikelihoodMaximisationType::New();
+      elm->SetCovariance(statistics->GetCovariance().GetVnlMatrix());
+      elm->SetCorrelation(statistics->GetCorrelation().GetVnlMatrix());
+      elm->SetNumberOfPixels(inputImage->GetLargestPossibleRegion().GetNumberOfPixels());
+      elm->Compute();
+      nbEndmembers = elm->GetNumberOfEndmembers();
+      if (nbEndmembers == 0)
+      {
+        otbAppLogFATAL(<< "No endmember found by the Eigenvalue Likelihood Maximization");
+      }
+      otbAppLogINFO(<< "Estimated number of endmembers: " << nbEndmembers);
+      SetParameterInt("ne", nbEndmembers);
+
+      vca->SetStatisticsEstimator(statistics);
+    }
+
     vca->SetNumberOfEndmembers(nbEndmembers);
+    vca->SetNumberOfSamples(GetParameterInt("samples"));
     vca->SetInput(inputImage);
 
     endmembersImage = vca->GetOutput();
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "otbVectorImage.h"
+#include "otbWrapperApplicationRegistry.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+typedef otb::VectorImage<double, 2> ImageType;
+
+const unsigned int nbBands      = 4;
+const unsigned int nbEndmembers = 3;
+
+/** Orthogonal endmembers: the columns of a Hadamard matrix. The fit error
+ * of abundances b to a pixel M a is then 4 |b - a|^2. */
+const double endmembers[nbEndmembers][nbBands] = {{1., 1., 1., 1.}, {1., -1., 1., -1.}, {1., 1., -1., -1.}};
+
+/** Euclidean projection onto the simplex {b >= 0, sum(b) = 1}, by sorting */
+std::vector<double> ProjectOntoSimplex(const std::vector<double>& a)
+{
+  std::vector<double> sorted(a);
+  std::sort(sorted.begin(), sorted.end(), std::greater<double>());
+
+  double sum   = 0.;
+  double theta = 0.;
+  for (unsigned int j = 0; j < sorted.size(); ++j)
+  {
+    sum += sorted[j];
+    if (sorted[j] - (sum - 1.) / (j + 1) > 0.)
+    {
+      theta = (sum - 1.) / (j + 1);
+    }
+  }
+
+  std::vector<double> projection(a.size());
+  for (unsigned int i = 0; i < a.size(); ++i)
+  {
+    projection[i] = std::max(a[i] - theta, 0.);
+  }
+  return projection;
+}
+
+/** Abundances of the synthetic pixel at (x, y): inside and outside of the
+ * simplex */
+std::vector<double> SyntheticAbundances(int x, int y)
+{
+  return {-0.5 + 0.1 * x, -0.5 + 0.1 * y, 0.2 + 0.05 * (x - y)};
+}
+}
+
+/** The FCLS abundances of pixels mixed from orthogonal endmembers are the
+ * projections onto the simplex of their mixing abundances: this reference
+ * does not depend on the solver. */
+int otbHyperspectralUnmixingFCLSAppTest(int itkNotUsed(argc), char* argv[])
+{
+  ImageType::RegionType endmembersRegion;
+  endmembersRegion.SetSize(0, nbEndmembers);
+  endmembersRegion.SetSize(1, 1);
+  ImageType::Pointer endmembersImage = ImageType::New();
+  endmembersImage->SetRegions(endmembersRegion);
+  endmembersImage->SetNumberOfComponentsPerPixel(nbBands);
+  endmembersImage->Allocate();
+  for (unsigned int e = 0; e < nbEndmembers; ++e)
+  {
+    ImageType::IndexType index;
+    index[0] = e;
+    index[1] = 0;
+    ImageType::PixelType endmember(nbBands);
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      endmember[b] = endmembers[e][b];
+    }
+    endmembersImage->SetPixel(index, endmember);
+  }
+
+  ImageType::RegionType region;
+  region.SetSize(0, 21);
+  region.SetSize(1, 21);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const std::vector<double> abundances = SyntheticAbundances(it.GetIndex()[0], it.GetIndex()[1]);
+    ImageType::PixelType      pixel(nbBands);
+    pixel.Fill(0.);
+    for (unsigned int e = 0; e < nbEndmembers; ++e)
+    {
+      for (unsigned int b = 0; b < nbBands; ++b)
+      {
+        pixel[b] += abundances[e] * endmembers[e][b];
+      }
+    }
+    it.Set(pixel);
+  }
+
+  otb::Wrapper::ApplicationRegistry::SetApplicationPath(argv[1]);
+  auto app = otb::Wrapper::ApplicationRegistry::CreateApplication("HyperspectralUnmixing");
+  if (app.IsNull())
+  {
+    std::cout << "Unable to load the HyperspectralUnmixing application" << std::endl;
+    return EXIT_FAILURE;
+  }
+  app->SetParameterInputImage("in", image);
+  app->SetParameterInputImage("ie", endmembersImage);
+  app->SetParameterString("ua", "fcls");
+  app->Execute();
+
+  ImageType* output = dynamic_cast<ImageType*>(app->GetParameterOutputImage("out"));
+  output->Update();
+  if (output->GetNumberOfComponentsPerPixel() != nbEndmembers)
+  {
+    std::cout << "Wrong number of abundances: " << output->GetNumberOfComponentsPerPixel() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  unsigned int                                 constrained = 0;
+  itk::ImageRegionIteratorWithIndex<ImageType> outputIt(output, region);
+  for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+  {
+    const std::vector<double> abundances = SyntheticAbundances(outputIt.GetIndex()[0], outputIt.GetIndex()[1]);
+    const std::vector<double> expected   = ProjectOntoSimplex(abundances);
+    for (unsigned int e = 0; e < nbEndmembers; ++e)
+    {
+      if (std::abs(outputIt.Get()[e] - expected[e]) > 1e-9)
+      {
+        std::cout << "FCLS abundances " << outputIt.Get() << " at " << outputIt.GetIndex() << " differ from the projection of the mixing abundances ("
+                  << expected[0] << ", " << expected[1] << ", " << expected[2] << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    constrained += *std::min_element(abundances.begin(), abundances.end()) < 0. ? 1 : 0;
+  }
+  std::cout << constrained << " pixels out of " << region.GetNumberOfPixels() << " have negative mixing abundances" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -112,6 +112,19 @@ public:
    */
   static int InitOpenMPThreads();
 
+  /**
+   * MaxConcurrentBranches is the maximum number of independent
+   * pipeline branches updated concurrently by multi-input filters
+   * (see PipelineBranchScheduler). The threads of the filter are
+   * shared between these branches.
+   *
+   * If environment variable OTB_MAX_CONCURRENT_BRANCHES is defined and
+   * could be converted to int, return its content (1 disables the
+   * concurrent updates).
+   * Else, returns the global default number of threads of ITK.
+   */
+  static unsigned int GetMaxConcurrentBranches();
+
 private:
   ConfigurationManager()                            = delete;
   ~ConfigurationManager()                           = delete;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2005-2021 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbParallelForRange_h
+#define otbParallelForRange_h
+
+#include "itkMultiThreader.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace otb
+{
+/**
+ * Number of threads used by ParallelForRange() to process `size` items with
+ * at most `numberOfThreads` threads: every thread gets at least one item.
+ * Per-thread results can be sized with it.
+ */
+inline itk::ThreadIdType GetParallelForRangeNumberOfThreads(itk::ThreadIdType numberOfThreads, std::size_t size)
+{
+  return static_cast<itk::ThreadIdType>(std::max<std::size_t>(1, std::min<std::size_t>(numberOfThreads, size)));
+}
+
+namespace internal
+{
+template <class TBody>
+struct ParallelForRangeStruct
+{
+  TBody*      Body;
+  std::size_t Size;
+};
+
+template <class TBody>
+ITK_THREAD_RETURN_TYPE ParallelForRangeCallback(void* arg)
+{
+  itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+  ParallelForRangeStruct<TBody>*        str  = static_cast<ParallelForRangeStruct<TBody>*>(info->UserData);
+
+  const std::size_t threadId = info->ThreadID;
+  const std::size_t nbThread = info->NumberOfThreads;
+  (*str->Body)(info->ThreadID, str->Size * threadId / nbThread, str->Size * (threadId + 1) / nbThread);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+} // end namespace internal
+
+/**
+ * Split [0, size) in contiguous ranges, one per thread, and call
+ * `body(threadId, begin, end)` for each of them with the threads of
+ * `threader`. At most `numberOfThreads` threads are used, see
+ * GetParallelForRangeNumberOfThreads(). The ranges only depend on the
+ * number of threads, so that per-thread results reduced in the thread order
+ * are reproducible.
+ */
+template <class TBody>
+void ParallelForRange(itk::MultiThreader* threader, itk::ThreadIdType numberOfThreads, std::size_t size, TBody body)
+{
+  internal::ParallelForRangeStruct<TBody> str;
+  str.Body = &body;
+  str.Size = size;
+  threader->SetNumberOfThreads(GetParallelForRangeNumberOfThreads(numberOfThreads, size));
+  threader->SetSingleMethod(internal::ParallelForRangeCallback<TBody>, &str);
+  threader->SingleMethodExecute();
+}
+} // otb namespace
+
+#endif // otbParallelForRange_h
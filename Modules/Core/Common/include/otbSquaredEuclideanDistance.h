@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2005-2021 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbSquaredEuclideanDistance_h
+#define otbSquaredEuclideanDistance_h
+
+namespace otb
+{
+/**
+ * Squared euclidean distance between two packed vectors of `size` values,
+ * accumulated in `TRealType`.
+ * Four partial sums are kept so that the compiler can vectorize the loop
+ * without reordering floating point additions: the result only depends on
+ * `size`, not on the instruction set.
+ * @throw None
+ */
+template <class TRealType = double, class TValue>
+inline TRealType SquaredEuclideanDistance(const TValue* a, const TValue* b, unsigned int size) noexcept
+{
+  TRealType    d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+  unsigned int i  = 0;
+  for (; i + 4 <= size; i += 4)
+  {
+    const TRealType e0 = static_cast<TRealType>(a[i]) - static_cast<TRealType>(b[i]);
+    const TRealType e1 = static_cast<TRealType>(a[i + 1]) - static_cast<TRealType>(b[i + 1]);
+    const TRealType e2 = static_cast<TRealType>(a[i + 2]) - static_cast<TRealType>(b[i + 2]);
+    const TRealType e3 = static_cast<TRealType>(a[i + 3]) - static_cast<TRealType>(b[i + 3]);
+    d0 += e0 * e0;
+    d1 += e1 * e1;
+    d2 += e2 * e2;
+    d3 += e3 * e3;
+  }
+  for (; i < size; ++i)
+  {
+    const TRealType e = static_cast<TRealType>(a[i]) - static_cast<TRealType>(b[i]);
+    d0 += e * e;
+  }
+  return (d0 + d1) + (d2 + d3);
+}
+} // otb namespace
+
+#endif // otbSquaredEuclideanDistance_h
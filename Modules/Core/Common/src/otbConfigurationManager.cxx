@@ -114,4 +114,21 @@ int ConfigurationManager::InitOpenMPThreads()
 #endif
   return ret;
 }
+
+unsigned int ConfigurationManager::GetMaxConcurrentBranches()
+{
+  std::string svalue;
+  if (itksys::SystemTools::GetEnv("OTB_MAX_CONCURRENT_BRANCHES", svalue))
+  {
+    try
+    {
+      return std::max(std::stoi(svalue), 1);
+    }
+    catch (std::exception const&)
+    {
+      otbLogMacro(Warning, << "Unknown value for OTB_MAX_CONCURRENT_BRANCHES (set to: " << svalue << "). Using the default number of threads.");
+    }
+  }
+  return std::max<itk::ThreadIdType>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads(), 1);
+}
 }
@@ -28,6 +28,7 @@ void RegisterTests()
   REGISTER_TEST(otbRectangle);
   REGISTER_TEST(otbSystemTest);
   REGISTER_TEST(otbStopwatchTest);
+  REGISTER_TEST(otbParallelForRangeTest);
   REGISTER_TEST(otbParseHdfSubsetName);
   REGISTER_TEST(otbParseHdfFileName);
   REGISTER_TEST(otbImageRegionSquareTileSplitter);
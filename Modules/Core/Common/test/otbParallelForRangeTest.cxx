@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2005-2021 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "itkMacro.h"
+
+#include "otbParallelForRange.h"
+#include "otbSquaredEuclideanDistance.h"
+
+int otbParallelForRangeTest(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+
+  // Every item is visited once, by the thread of its contiguous range
+  const std::size_t sizes[] = {0, 1, 3, 1000};
+  for (std::size_t size : sizes)
+  {
+    const itk::ThreadIdType  numberOfThreads = otb::GetParallelForRangeNumberOfThreads(4, size);
+    std::vector<int>         visits(size, 0);
+    std::vector<std::size_t> firsts(numberOfThreads, size);
+    otb::ParallelForRange(threader, 4, size, [&](itk::ThreadIdType threadId, std::size_t begin, std::size_t end) {
+      firsts[threadId] = begin;
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        ++visits[i];
+      }
+    });
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      if (visits[i] != 1)
+      {
+        std::cout << "Item " << i << " of " << size << " visited " << visits[i] << " times" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    for (itk::ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId)
+    {
+      if (firsts[threadId] != size * threadId / numberOfThreads)
+      {
+        std::cout << "Wrong range for thread " << threadId << " of " << size << " items" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The partial sums of the distance cover the remainder of the vectors
+  const float a[] = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f};
+  const float b[] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+  for (unsigned int size = 0; size <= 7; ++size)
+  {
+    const double expected = size * (size + 1) * (2 * size + 1) / 6.;
+    if (otb::SquaredEuclideanDistance(a, b, size) != expected || otb::SquaredEuclideanDistance<float>(b, a, size) != static_cast<float>(expected))
+    {
+      std::cout << "Wrong squared distance over " << size << " components" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -357,6 +357,16 @@ public:
     return false;
   }
 
+  /** Size of the blocks (tiles or strips) the file is written with. Writing
+   * regions aligned on these blocks spares the driver partial block updates.
+   * A null size along a dimension means that the blocks span the whole image
+   * along it, or that the layout is unknown. Default is no constraint. */
+  virtual void GetWriteBlockSize(unsigned int& blockSizeX, unsigned int& blockSizeY) const
+  {
+    blockSizeX = 0;
+    blockSizeY = 0;
+  }
+
   /** Writes the spacing and dimensions of the image.
    * Assumes SetFileName has been called with a valid file name. */
   virtual void WriteImageInformation() = 0;
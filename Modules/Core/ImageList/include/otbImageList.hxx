@@ -23,6 +23,7 @@
 
 #include "otbImageList.h"
 #include "otbMacro.h"
+#include "otbPipelineBranchScheduler.h"
 
 namespace otb
 {
@@ -31,16 +32,14 @@ template <class TImage>
 void ImageList<TImage>::UpdateOutputData()
 {
   Superclass::UpdateOutputData();
+
+  // Images produced by independent pipelines are updated concurrently
+  PipelineBranchScheduler::DataObjectVectorType images;
   for (ConstIterator it = this->Begin(); it != this->End(); ++it)
   {
-    if (it.Get()->GetUpdateMTime() < it.Get()->GetPipelineMTime() || it.Get()->GetDataReleased() || it.Get()->RequestedRegionIsOutsideOfTheBufferedRegion())
-    {
-      if (it.Get()->GetSource())
-      {
-        it.Get()->GetSource()->UpdateOutputData(it.Get());
-      }
-    }
+    images.push_back(it.Get());
   }
+  PipelineBranchScheduler::Update(images);
 }
 
 template <class TImage>
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPipelineBranchScheduler_h
+#define otbPipelineBranchScheduler_h
+
+#include "itkMultiThreader.h"
+#include "itkProcessObject.h"
+#include "otbConfigurationManager.h"
+#include "otbDataObjectListInterface.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PipelineBranchScheduler
+ *  \brief Updates the independent upstream branches of a pipeline concurrently.
+ *
+ * The pipeline of ITK updates the inputs of a filter one after the other.
+ * When a filter has several inputs produced by unrelated sub-pipelines (the
+ * images of BandMathX, or of the list given to ConcatenateImages, for
+ * instance), these sub-pipelines may as well be updated at the same time.
+ *
+ * Update() groups the data objects to update into independent branches: two
+ * data objects belong to the same branch when their upstream pipelines share
+ * an object (data or process object). Branches are then updated
+ * concurrently, while the data objects of a branch are updated
+ * sequentially, as usual. The number of concurrent branches is bounded by
+ * ConfigurationManager::GetMaxConcurrentBranches().
+ *
+ * The number of threads of the filter whose inputs are updated (the global
+ * default number of threads of itk::MultiThreader for Update()) is shared
+ * between the branches: while they are updated, the number of threads of
+ * every process object of a branch is bounded by this budget divided by
+ * the number of concurrent branches, and restored afterwards. The global
+ * settings of itk::MultiThreader, shared with the other pipelines of the
+ * process, are left alone. A scheduler nested in a branch shares the
+ * bounded number of threads of its filter in the same way.
+ *
+ * As the requested regions have already been propagated, updating a data
+ * object beforehand makes the usual sequential update of the filter find it
+ * up-to-date: filters only need to call UpdateInputs() before
+ * ProcessObject::UpdateOutputData().
+ *
+ * \ingroup OTBObjectList
+ */
+class PipelineBranchScheduler
+{
+public:
+  typedef std::vector<itk::DataObject*> DataObjectVectorType;
+
+  /** Groups data objects by independent branches, keeping their order
+   * inside each branch. Null data objects are ignored. */
+  static std::vector<DataObjectVectorType> GroupIndependentBranches(DataObjectVectorType const& data)
+  {
+    // Union-find of the data objects, merged when an upstream object is shared
+    std::vector<std::size_t> parent(data.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](std::size_t i) {
+      while (parent[i] != i)
+      {
+        parent[i] = parent[parent[i]];
+        i         = parent[i];
+      }
+      return i;
+    };
+
+    std::map<itk::Object const*, std::size_t> owners;
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+      if (!data[i])
+      {
+        continue;
+      }
+      for (itk::Object const* object : GetUpstreamObjects(data[i]))
+      {
+        auto inserted = owners.emplace(object, i);
+        if (!inserted.second)
+        {
+          parent[find(i)] = find(inserted.first->second);
+        }
+      }
+    }
+
+    std::vector<DataObjectVectorType> branches;
+    std::map<std::size_t, std::size_t> branchOfRoot;
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+      if (!data[i])
+      {
+        continue;
+      }
+      auto inserted = branchOfRoot.emplace(find(i), branches.size());
+      if (inserted.second)
+      {
+        branches.emplace_back();
+      }
+      branches[inserted.first->second].push_back(data[i]);
+    }
+    return branches;
+  }
+
+  /** Updates data objects, independent branches concurrently.
+   * \param numberOfThreads  threads shared by the branches, 0 for the
+   * global default number of threads.
+   * \throw the first exception raised by the update of a branch, once all
+   * the branches are over.
+   * \note Bounding and restoring the number of threads of a filter modifies
+   * it: the next propagation of the pipeline information finds it modified.
+   */
+  static void Update(DataObjectVectorType const& data, itk::ThreadIdType numberOfThreads = 0)
+  {
+    const unsigned int maxBranches = ConfigurationManager::GetMaxConcurrentBranches();
+    if (maxBranches < 2 || std::count_if(data.begin(), data.end(), [](itk::DataObject* d) { return d != nullptr; }) < 2)
+    {
+      UpdateSequentially(data);
+      return;
+    }
+
+    const std::vector<DataObjectVectorType> branches = GroupIndependentBranches(data);
+    if (branches.size() < 2)
+    {
+      UpdateSequentially(data);
+      return;
+    }
+
+    // Split the thread budget between the branches
+    const std::size_t       nbWorkers        = std::min<std::size_t>(branches.size(), maxBranches);
+    const itk::ThreadIdType budget           = numberOfThreads > 0 ? numberOfThreads : itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+    const itk::ThreadIdType threadsPerBranch = std::max<itk::ThreadIdType>(1, static_cast<itk::ThreadIdType>(budget / nbWorkers));
+
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr       error;
+    std::mutex               errorMutex;
+    auto                     worker = [&]() {
+      for (std::size_t b = next++; b < branches.size(); b = next++)
+      {
+        try
+        {
+          BranchThreadBudget branchBudget(branches[b], threadsPerBranch);
+          UpdateSequentially(branches[b]);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(errorMutex);
+          if (!error)
+          {
+            error = std::current_exception();
+          }
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t w = 1; w < nbWorkers; ++w)
+    {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers)
+    {
+      thread.join();
+    }
+
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /** Updates the inputs of a filter, independent branches concurrently,
+   * within the number of threads of the filter. */
+  static void UpdateInputs(itk::ProcessObject* filter)
+  {
+    DataObjectVectorType inputs;
+    for (auto const& input : filter->GetInputs())
+    {
+      inputs.push_back(input.GetPointer());
+    }
+    Update(inputs, filter->GetNumberOfThreads());
+  }
+
+private:
+  /** Bounds the number of threads of the process objects of a branch, for
+   * its lifetime. The branches being independent, each filter is bounded by
+   * a single budget. */
+  class BranchThreadBudget
+  {
+  public:
+    BranchThreadBudget(DataObjectVectorType const& branch, itk::ThreadIdType numberOfThreads)
+    {
+      for (itk::DataObject* data : branch)
+      {
+        for (itk::Object const* object : GetUpstreamObjects(data))
+        {
+          // The pipeline only hands out const pointers to the sources
+          itk::ProcessObject* process = const_cast<itk::ProcessObject*>(dynamic_cast<itk::ProcessObject const*>(object));
+          if (process && m_NumberOfThreads.emplace(process, process->GetNumberOfThreads()).second)
+          {
+            process->SetNumberOfThreads(std::min(process->GetNumberOfThreads(), numberOfThreads));
+          }
+        }
+      }
+    }
+
+    ~BranchThreadBudget()
+    {
+      for (auto const& process : m_NumberOfThreads)
+      {
+        process.first->SetNumberOfThreads(process.second);
+      }
+    }
+
+  private:
+    BranchThreadBudget(const BranchThreadBudget&) = delete;
+    void operator=(const BranchThreadBudget&) = delete;
+
+    std::map<itk::ProcessObject*, itk::ThreadIdType> m_NumberOfThreads;
+  };
+
+  static void UpdateSequentially(DataObjectVectorType const& data)
+  {
+    for (itk::DataObject* d : data)
+    {
+      if (d)
+      {
+        d->UpdateOutputData();
+      }
+    }
+  }
+
+  /** Data and process objects upstream of a data object, itself included */
+  static std::set<itk::Object const*> GetUpstreamObjects(itk::DataObject* data)
+  {
+    std::set<itk::Object const*>  visited;
+    std::vector<itk::DataObject*> stack(1, data);
+    while (!stack.empty())
+    {
+      itk::DataObject* current = stack.back();
+      stack.pop_back();
+      if (!current || !visited.insert(current).second)
+      {
+        continue;
+      }
+
+      // The elements of a list are updated with it
+      if (DataObjectListInterface* list = dynamic_cast<DataObjectListInterface*>(current))
+      {
+        for (std::size_t i = 0; i < list->Size(); ++i)
+        {
+          stack.push_back(list->GetNthDataObject(i));
+        }
+      }
+
+      itk::ProcessObject* source = current->GetSource();
+      if (source && visited.insert(source).second)
+      {
+        for (auto const& input : source->GetInputs())
+        {
+          stack.push_back(input.GetPointer());
+        }
+      }
+    }
+    return visited;
+  }
+};
+
+} // end namespace otb
+
+#endif
@@ -24,4 +24,6 @@ void RegisterTests()
 {
   REGISTER_TEST(otbObjectList);
   REGISTER_TEST(otbObjectList2);
+  REGISTER_TEST(otbPipelineBranchScheduler);
+  REGISTER_TEST(otbPipelineBranchSchedulerThreadBudget);
 }
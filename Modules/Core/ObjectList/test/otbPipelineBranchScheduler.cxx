@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+#include "itkCastImageFilter.h"
+#include "itkImageToImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+
+#include "otbImageFileReader.h"
+#include "otbImage.h"
+#include "otbPipelineBranchScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+int otbPipelineBranchScheduler(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::Image<unsigned char, 2> ImageType;
+  typedef otb::Image<float, 2>         FloatImageType;
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+  typedef itk::CastImageFilter<ImageType, FloatImageType> CastFilterType;
+  typedef otb::PipelineBranchScheduler SchedulerType;
+
+  ReaderType::Pointer reader1 = ReaderType::New();
+  reader1->SetFileName(argv[1]);
+  ReaderType::Pointer reader2 = ReaderType::New();
+  reader2->SetFileName(argv[2]);
+
+  CastFilterType::Pointer cast1 = CastFilterType::New();
+  cast1->SetInput(reader1->GetOutput());
+  CastFilterType::Pointer cast2 = CastFilterType::New();
+  cast2->SetInput(reader1->GetOutput());
+  CastFilterType::Pointer cast3 = CastFilterType::New();
+  cast3->SetInput(reader2->GetOutput());
+
+  // cast1 and cast2 share their reader, cast3 is independent
+  SchedulerType::DataObjectVectorType data = {cast1->GetOutput(), cast3->GetOutput(), nullptr, cast2->GetOutput()};
+  std::vector<SchedulerType::DataObjectVectorType> branches = SchedulerType::GroupIndependentBranches(data);
+  if (branches.size() != 2 || branches[0] != SchedulerType::DataObjectVectorType{cast1->GetOutput(), cast2->GetOutput()} ||
+      branches[1] != SchedulerType::DataObjectVectorType{cast3->GetOutput()})
+  {
+    std::cerr << "Fail: expecting 2 branches, got " << branches.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Update the branches concurrently, as a filter would do
+  for (itk::DataObject* d : data)
+  {
+    if (d)
+    {
+      d->UpdateOutputInformation();
+      d->SetRequestedRegionToLargestPossibleRegion();
+      d->PropagateRequestedRegion();
+    }
+  }
+  SchedulerType::Update(data);
+
+  for (CastFilterType* filter : {cast1.GetPointer(), cast2.GetPointer(), cast3.GetPointer()})
+  {
+    FloatImageType* output = filter->GetOutput();
+    if (output->GetBufferedRegion() != output->GetLargestPossibleRegion())
+    {
+      std::cerr << "Fail: an output has not been updated" << std::endl;
+      return EXIT_FAILURE;
+    }
+    ImageType::IndexType index;
+    index.Fill(0);
+    const ImageType* input = filter->GetInput();
+    if (output->GetPixel(index) != input->GetPixel(index))
+    {
+      std::cerr << "Fail: unexpected output value" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+/** Copies its input, counting the threads running concurrently in all the
+ * instances */
+template <class TImage>
+class ConcurrencyProbeFilter : public itk::ImageToImageFilter<TImage, TImage>
+{
+public:
+  typedef ConcurrencyProbeFilter                  Self;
+  typedef itk::ImageToImageFilter<TImage, TImage> Superclass;
+  typedef itk::SmartPointer<Self>                 Pointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ConcurrencyProbeFilter, ImageToImageFilter);
+
+  static std::atomic<unsigned int> Active;
+  static std::atomic<unsigned int> Peak;
+  static std::atomic<unsigned int> GlobalMaximum;
+
+protected:
+  ConcurrencyProbeFilter() = default;
+
+  void ThreadedGenerateData(const typename TImage::RegionType& region, itk::ThreadIdType) override
+  {
+    const unsigned int active = ++Active;
+    unsigned int       peak   = Peak;
+    while (active > peak && !Peak.compare_exchange_weak(peak, active))
+    {
+    }
+    GlobalMaximum = itk::MultiThreader::GetGlobalMaximumNumberOfThreads();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    itk::ImageRegionConstIterator<TImage> inIt(this->GetInput(), region);
+    itk::ImageRegionIterator<TImage>      outIt(this->GetOutput(), region);
+    for (; !inIt.IsAtEnd(); ++inIt, ++outIt)
+    {
+      outIt.Set(inIt.Get());
+    }
+    --Active;
+  }
+};
+
+template <class TImage>
+std::atomic<unsigned int> ConcurrencyProbeFilter<TImage>::Active(0);
+template <class TImage>
+std::atomic<unsigned int> ConcurrencyProbeFilter<TImage>::Peak(0);
+template <class TImage>
+std::atomic<unsigned int> ConcurrencyProbeFilter<TImage>::GlobalMaximum(0);
+}
+
+int otbPipelineBranchSchedulerThreadBudget(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::Image<unsigned char, 2>      ImageType;
+  typedef ConcurrencyProbeFilter<ImageType> ProbeFilterType;
+  typedef otb::PipelineBranchScheduler      SchedulerType;
+
+  const itk::ThreadIdType nbThreads = 4;
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(nbThreads);
+  const itk::ThreadIdType maximumNumberOfThreads = itk::MultiThreader::GetGlobalMaximumNumberOfThreads();
+
+  // 4 independent branches, whose filters would use 4 threads each
+  ImageType::RegionType region;
+  region.SetSize(0, 64);
+  region.SetSize(1, 64);
+  std::vector<ImageType::Pointer>       images;
+  std::vector<ProbeFilterType::Pointer> filters;
+  SchedulerType::DataObjectVectorType   data;
+  for (unsigned int b = 0; b < 4; ++b)
+  {
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer(b);
+    images.push_back(image);
+
+    ProbeFilterType::Pointer filter = ProbeFilterType::New();
+    filter->SetInput(image);
+    filters.push_back(filter);
+    data.push_back(filter->GetOutput());
+  }
+  if (filters.front()->GetNumberOfThreads() != nbThreads)
+  {
+    std::cerr << "Fail: the filters shall use " << nbThreads << " threads" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (itk::DataObject* d : data)
+  {
+    d->UpdateOutputInformation();
+    d->SetRequestedRegionToLargestPossibleRegion();
+    d->PropagateRequestedRegion();
+  }
+  SchedulerType::Update(data);
+
+  std::cout << "Peak number of threads: " << ProbeFilterType::Peak << std::endl;
+  if (ProbeFilterType::Peak > nbThreads)
+  {
+    std::cerr << "Fail: " << ProbeFilterType::Peak << " threads ran concurrently, the budget is " << nbThreads << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (unsigned int b = 0; b < filters.size(); ++b)
+  {
+    ImageType::IndexType index;
+    index.Fill(63);
+    if (filters[b]->GetOutput()->GetPixel(index) != b)
+    {
+      std::cerr << "Fail: branch " << b << " has not been updated" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The budget is given to the filters, the global settings shared with the
+  // other pipelines of the process are left alone
+  if (ProbeFilterType::GlobalMaximum != maximumNumberOfThreads || itk::MultiThreader::GetGlobalDefaultNumberOfThreads() != nbThreads ||
+      itk::MultiThreader::GetGlobalMaximumNumberOfThreads() != maximumNumberOfThreads)
+  {
+    std::cerr << "Fail: the global number of threads has been modified" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (auto const& filter : filters)
+  {
+    if (filter->GetNumberOfThreads() != nbThreads)
+    {
+      std::cerr << "Fail: the number of threads of a filter has not been restored" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -94,6 +94,13 @@ public:
   itkSetMacro(DefaultRAM, MemoryPrintType);
   itkGetMacro(DefaultRAM, MemoryPrintType);
 
+  /** Memory print, in bytes, of the buffers held beside the pipeline for the
+   * whole region (e.g. copies of divisions waiting to be written). It is
+   * added to the pipeline print when the number of divisions is estimated
+   * from the available RAM. Default is 0. */
+  itkSetMacro(AdditionalMemoryPrint, MemoryPrintType);
+  itkGetMacro(AdditionalMemoryPrint, MemoryPrintType);
+
 protected:
   StreamingManager();
   ~StreamingManager() override;
@@ -121,6 +128,9 @@ private:
 
   /** Default available RAM in MB */
   MemoryPrintType m_DefaultRAM;
+
+  /** Memory print of the buffers held beside the pipeline */
+  MemoryPrintType m_AdditionalMemoryPrint;
 };
 
 } // End namespace otb
@@ -29,7 +29,7 @@ namespace otb
 {
 
 template <class TImage>
-StreamingManager<TImage>::StreamingManager() : m_ComputedNumberOfSplits(0), m_DefaultRAM(0)
+StreamingManager<TImage>::StreamingManager() : m_ComputedNumberOfSplits(0), m_DefaultRAM(0), m_AdditionalMemoryPrint(0)
 {
 }
 
@@ -145,6 +145,8 @@ unsigned int StreamingManager<TImage>::EstimateOptimalNumberOfDivisions(itk::Dat
     pipelineMemoryPrint = memoryPrintCalculator->GetMemoryPrint();
   }
 
+  pipelineMemoryPrint += m_AdditionalMemoryPrint;
+
   unsigned int optimalNumberOfDivisions = otb::PipelineMemoryPrintCalculator::EstimateOptimalNumberOfStreamDivisions(pipelineMemoryPrint, availableRAMInBytes);
 
   otbLogMacro(Info, << "Estimated memory for full processing: " << pipelineMemoryPrint * otb::PipelineMemoryPrintCalculator::ByteToMegabyte
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBinaryFunctorPowerSumsImageFilter_h
+#define otbBinaryFunctorPowerSumsImageFilter_h
+
+#include "otbBinaryFunctorNeighborhoodImageFilter.h"
+#include "otbLocalPowerSums.h"
+
+namespace otb
+{
+
+/** \class BinaryFunctorPowerSumsImageFilter
+ * \brief Neighborhood filter whose functor only needs the power sums of
+ * the windows.
+ *
+ * Instead of walking the neighborhoods of the two inputs, this filter
+ * builds the integral images of the powers of the values of the thread
+ * region (LocalPowerSums), band of rows by band of rows, and gives the
+ * WindowPowerSums of both windows of each pixel to the functor. The cost
+ * per pixel does not depend on the radius anymore.
+ *
+ * The functor shall provide, besides the neighborhood operator() of
+ * BinaryFunctorNeighborhoodImageFilter:
+ *
+ * - static unsigned int GetPowerSumsOrder(), the highest power it needs,
+ * - TOutput operator()(const WindowPowerSums&, const WindowPowerSums&).
+ *
+ * The borders are handled as by itk::ZeroFluxNeumannBoundaryCondition.
+ * This filter only supports images of dimension 2 with scalar pixels.
+ *
+ * \ingroup OTBChangeDetection
+ * \sa LocalPowerSums
+ */
+template <class TInputImage1, class TInputImage2, class TOutputImage, class TFunction>
+class ITK_EXPORT BinaryFunctorPowerSumsImageFilter : public BinaryFunctorNeighborhoodImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunction>
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryFunctorPowerSumsImageFilter Self;
+  typedef BinaryFunctorNeighborhoodImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunction> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BinaryFunctorPowerSumsImageFilter, BinaryFunctorNeighborhoodImageFilter);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename Superclass::RadiusSizeType        RadiusSizeType;
+  typedef LocalPowerSums<TInputImage1>               PowerSums1Type;
+  typedef LocalPowerSums<TInputImage2>               PowerSums2Type;
+
+protected:
+  BinaryFunctorPowerSumsImageFilter()
+  {
+  }
+  ~BinaryFunctorPowerSumsImageFilter() override
+  {
+  }
+
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+private:
+  BinaryFunctorPowerSumsImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbBinaryFunctorPowerSumsImageFilter.hxx"
+#endif
+
+#endif
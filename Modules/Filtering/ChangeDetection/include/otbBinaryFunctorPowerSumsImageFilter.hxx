@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBinaryFunctorPowerSumsImageFilter_hxx
+#define otbBinaryFunctorPowerSumsImageFilter_hxx
+
+#include <algorithm>
+
+#include "otbBinaryFunctorPowerSumsImageFilter.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+
+namespace otb
+{
+
+template <class TInputImage1, class TInputImage2, class TOutputImage, class TFunction>
+void BinaryFunctorPowerSumsImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunction>::ThreadedGenerateData(
+    const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  const TInputImage1* inputPtr1 = this->GetInput1();
+  const TInputImage2* inputPtr2 = this->GetInput2();
+  TOutputImage*       outputPtr = this->GetOutput();
+
+  const RadiusSizeType radius = this->m_Radius;
+  const unsigned int   order  = TFunction::GetPowerSumsOrder();
+
+  PowerSums1Type  powerSums1(order);
+  PowerSums2Type  powerSums2(order);
+  WindowPowerSums windowSums1;
+  WindowPowerSums windowSums2;
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // The integral images are built for bands of rows to bound their size
+  const long rowsPerBand = PowerSums1Type::GetNumberOfRowsPerBand(radius);
+  const long firstRow    = outputRegionForThread.GetIndex()[1];
+  const long endRow      = firstRow + static_cast<long>(outputRegionForThread.GetSize()[1]);
+
+  for (long bandRow = firstRow; bandRow < endRow; bandRow += rowsPerBand)
+  {
+    OutputImageRegionType band = outputRegionForThread;
+    band.SetIndex(1, bandRow);
+    band.SetSize(1, std::min(rowsPerBand, endRow - bandRow));
+
+    powerSums1.Compute(inputPtr1, band, radius);
+    powerSums2.Compute(inputPtr2, band, radius);
+
+    itk::ImageScanlineIterator<TOutputImage> outputIt(outputPtr, band);
+    for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); outputIt.NextLine())
+    {
+      typename TOutputImage::IndexType index = outputIt.GetIndex();
+      for (; !outputIt.IsAtEndOfLine(); ++outputIt, ++index[0])
+      {
+        powerSums1.GetWindowSums(index, radius, windowSums1);
+        powerSums2.GetWindowSums(index, radius, windowSums2);
+        outputIt.Set(this->GetFunctor()(windowSums1, windowSums2));
+        progress.CompletedPixel();
+      }
+    }
+  }
+}
+
+} // end namespace otb
+
+#endif
@@ -23,7 +23,7 @@
 #define otbKullbackLeiblerDistanceImageFilter_h
 
 #include "itkVariableLengthVector.h"
-#include "otbBinaryFunctorNeighborhoodImageFilter.h"
+#include "otbBinaryFunctorPowerSumsImageFilter.h"
 
 namespace otb
 {
@@ -40,6 +40,7 @@ class CumulantsForEdgeworth
 public:
   CumulantsForEdgeworth(const TInput& input);
   CumulantsForEdgeworth(const itk::Image<typename TInput::ImageType::PixelType, 1>* input);
+  CumulantsForEdgeworth(const WindowPowerSums& sums);
   virtual ~CumulantsForEdgeworth()
   {
   }
@@ -74,6 +75,8 @@ protected:
   void MakeSumAndMoments(const TInput& input);
   /** Moment estimation from raw data */
   void MakeSumAndMoments(const itk::Image<typename TInput::ImageType::PixelType, 1>* input);
+  /** Moment estimation from the power sums of a window */
+  void MakeSumAndMoments(const WindowPowerSums& sums);
   /** transformation moment -> cumulants (for Edgeworth) */
   void MakeCumulants();
 
@@ -114,6 +117,26 @@ public:
 
     return static_cast<TOutput>(cum1.Divergence(cum2) + cum2.Divergence(cum1));
   }
+
+  /** Same distance from the power sums of the windows */
+  TOutput operator()(const WindowPowerSums& sums1, const WindowPowerSums& sums2)
+  {
+    CumulantsForEdgeworth<TInput1> cum1(sums1);
+    if (!cum1.IsDataAvailable())
+      return static_cast<TOutput>(0.);
+
+    CumulantsForEdgeworth<TInput2> cum2(sums2);
+    if (!cum2.IsDataAvailable())
+      return static_cast<TOutput>(0.);
+
+    return static_cast<TOutput>(cum1.Divergence(cum2) + cum2.Divergence(cum1));
+  }
+
+  /** The first four moments are needed */
+  static unsigned int GetPowerSumsOrder()
+  {
+    return 4;
+  }
 };
 
 } // Functor
@@ -139,6 +162,11 @@ public:
  * The filter expect all images to have the same dimension
  * (e.g. all 2D, or all 3D, or all ND)
  *
+ * The moments of the windows are computed from the integral images of the
+ * first four powers of the pixel values (see
+ * BinaryFunctorPowerSumsImageFilter), at a cost which does not depend on
+ * the radius.
+ *
  * See article of  Lin Saito et Levine
  * "Edgeworth Approximation of the Kullback-Leibler Distance Towards Problems in Image Analysis"
  * and
@@ -151,7 +179,7 @@ public:
  */
 template <class TInputImage1, class TInputImage2, class TOutputImage>
 class ITK_EXPORT KullbackLeiblerDistanceImageFilter
-    : public otb::BinaryFunctorNeighborhoodImageFilter<
+    : public otb::BinaryFunctorPowerSumsImageFilter<
           TInputImage1, TInputImage2, TOutputImage,
           Functor::KullbackLeiblerDistance<typename itk::ConstNeighborhoodIterator<TInputImage1>, typename itk::ConstNeighborhoodIterator<TInputImage2>,
                                            typename TOutputImage::PixelType>>
@@ -159,7 +187,7 @@ class ITK_EXPORT KullbackLeiblerDistanceImageFilter
 public:
   /** Standard class typedefs. */
   typedef KullbackLeiblerDistanceImageFilter Self;
-  typedef otb::BinaryFunctorNeighborhoodImageFilter<
+  typedef otb::BinaryFunctorPowerSumsImageFilter<
       TInputImage1, TInputImage2, TOutputImage,
       Functor::KullbackLeiblerDistance<typename itk::ConstNeighborhoodIterator<TInputImage1>, typename itk::ConstNeighborhoodIterator<TInputImage2>,
                                        typename TOutputImage::PixelType>>
@@ -50,6 +50,13 @@ CumulantsForEdgeworth<TInput>::CumulantsForEdgeworth(const itk::Image<typename T
   MakeCumulants();
 }
 
+template <class TInput>
+CumulantsForEdgeworth<TInput>::CumulantsForEdgeworth(const WindowPowerSums& sums)
+{
+  MakeSumAndMoments(sums);
+  MakeCumulants();
+}
+
 /* ========================== Divergence de KL ======================= */
 
 template <class TInput>
@@ -239,6 +246,37 @@ void CumulantsForEdgeworth<TInput>::MakeSumAndMoments(const itk::Image<typename
   // return 0;
 }
 
+/* ============ Moment estimation from the window power sums ========== */
+
+template <class TInput>
+void CumulantsForEdgeworth<TInput>::MakeSumAndMoments(const WindowPowerSums& sums)
+{
+  fSum0 = static_cast<double>(sums.GetCount());
+  fSum1 = sums.GetRawSum(1);
+  fSum2 = sums.GetRawSum(2);
+  fSum3 = sums.GetRawSum(3);
+  fSum4 = sums.GetRawSum(4);
+
+  // The central moments are derived from the sums around the offset of the
+  // window, which LocalPowerSums keeps close enough to its mean for the
+  // rounding error of the normalized moments to stay below its tolerance
+  fMu1 = sums.GetMean();
+  fMu2 = sums.GetCentralSum(2) / fSum0;
+
+  if (fMu2 <= 0.0)
+  {
+    fMu3           = 0.0;
+    fMu4           = 4.0;
+    fDataAvailable = false;
+    return;
+  }
+
+  fMu3 = sums.GetCentralSum(3) / (fSum0 * fMu2 * sqrt(fMu2));
+  fMu4 = sums.GetCentralSum(4) / (fSum0 * fMu2 * fMu2);
+
+  fDataAvailable = true;
+}
+
 /* ================= moments -> cumulants transformation ============= */
 
 template <class TInput>
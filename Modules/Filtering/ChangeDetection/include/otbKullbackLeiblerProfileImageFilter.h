@@ -29,6 +29,7 @@
 #include "itkVariableLengthVector.h"
 
 #include "otbBinaryFunctorNeighborhoodVectorImageFilter.h"
+#include "otbLocalPowerSums.h"
 
 namespace otb
 {
@@ -48,6 +49,8 @@ public:
   typedef CumulantSet::iterator     Iterator;
 
   CumulantsForEdgeworthProfile(const TInput& input, std::vector<itk::Array2D<int>>& mask);
+  /** From the power sums of the windows of increasing radius */
+  CumulantsForEdgeworthProfile(const std::vector<WindowPowerSums>& sums);
   virtual ~CumulantsForEdgeworthProfile()
   {
   }
@@ -74,6 +77,8 @@ public:
 protected:
   // Momentum Estimation from encapsulated neighborhood
   int MakeSumAndMoments(const TInput& input, std::vector<itk::Array2D<int>>& mask);
+  // Momentum Estimation from the power sums of the windows
+  int MakeSumAndMoments(const std::vector<WindowPowerSums>& sums);
   // momentum estimation from the smaller window
   int InitSumAndMoments(const TInput& input, itk::Array2D<int>& mask);
   //
@@ -120,6 +125,8 @@ public:
   }
   // functor
   TOutput operator()(const TInput1& it1, const TInput2& it2);
+  // functor on the power sums of the windows of increasing radius
+  TOutput operator()(const std::vector<WindowPowerSums>& sums1, const std::vector<WindowPowerSums>& sums2);
 
 protected:
   // Make the set of masks to play the increase in window size
@@ -151,6 +158,11 @@ protected:
  *
  * The filter expect all images to have the same dimension (all 2D)
  *
+ * The moments of the windows of all the radii are computed from the same
+ * integral images of the first four powers of the pixel values (see
+ * LocalPowerSums), so that the cost per pixel grows linearly with the
+ * number of radii, instead of with the area of the largest window.
+ *
  * See article of  Lin Saito et Levine
  * "Edgeworth Approximation of the Kullback-Leibler Distance Towards Problems in Image Analysis"
  * and
@@ -184,6 +196,12 @@ public:
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
+  typedef typename Superclass::FunctorType           FunctorType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef LocalPowerSums<TInputImage1>               PowerSums1Type;
+  typedef LocalPowerSums<TInputImage2>               PowerSums2Type;
+  typedef typename PowerSums1Type::SizeType          SizeType;
+
 protected:
   KullbackLeiblerProfileImageFilter()
   {
@@ -192,6 +210,8 @@ protected:
   {
   }
 
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
 private:
   KullbackLeiblerProfileImageFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
@@ -22,10 +22,13 @@
 #ifndef otbKullbackLeiblerProfileImageFilter_hxx
 #define otbKullbackLeiblerProfileImageFilter_hxx
 
+#include <algorithm>
 #include <vector>
 
 #include "otbKullbackLeiblerProfileImageFilter.h"
 #include "otbMath.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
 
 namespace otb
 {
@@ -41,6 +44,13 @@ CumulantsForEdgeworthProfile<TInput>::CumulantsForEdgeworthProfile(const TInput&
   MakeCumulants();
 }
 
+template <class TInput>
+CumulantsForEdgeworthProfile<TInput>::CumulantsForEdgeworthProfile(const std::vector<WindowPowerSums>& sums)
+{
+  m_debug = MakeSumAndMoments(sums);
+  MakeCumulants();
+}
+
 /* ===================== Kullback-Leibler Profile ==================== */
 
 template <class TInput>
@@ -290,6 +300,73 @@ int CumulantsForEdgeworthProfile<TInput>::ReInitSumAndMoments(const TInput& inpu
   return 0;
 }
 
+/* ========= Moments estimation from the window power sums ========= */
+
+template <class TInput>
+int CumulantsForEdgeworthProfile<TInput>::MakeSumAndMoments(const std::vector<WindowPowerSums>& sums)
+{
+  fMu.resize(sums.size());
+
+  // Smallest window, as InitSumAndMoments()
+  const WindowPowerSums& first = sums.front();
+
+  fSum0 = static_cast<double>(first.GetCount());
+  if (fSum0 == 0.0)
+  {
+    fDataAvailable = false;
+    return 1;
+  }
+
+  double mu1 = first.GetMean();
+  double mu2 = first.GetCentralSum(2) / fSum0;
+
+  if (mu2 == 0.0)
+  {
+    fDataAvailable = false;
+    return 1;
+  }
+
+  double mu3 = first.GetCentralSum(3) / (fSum0 * mu2 * sqrt(mu2));
+  double mu4 = first.GetCentralSum(4) / (fSum0 * mu2 * mu2);
+
+  if (vnl_math_isnan(mu3) || vnl_math_isnan(mu4))
+  {
+    fDataAvailable = false;
+    return 1;
+  }
+
+  fMu[0][0] = mu1;
+  fMu[0][1] = mu2;
+  fMu[0][2] = mu3;
+  fMu[0][3] = mu4;
+
+  fDataAvailable = true;
+
+  // Larger windows, normalized as ReInitSumAndMoments()
+  for (unsigned int level = 1; level < sums.size(); level++)
+  {
+    const WindowPowerSums& window = sums[level];
+
+    fSum0 = static_cast<double>(window.GetCount());
+    fSum1 = window.GetRawSum(1);
+    fSum2 = window.GetRawSum(2);
+    fSum3 = window.GetRawSum(3);
+    fSum4 = window.GetRawSum(4);
+
+    double sigma   = sqrt(fSum2);
+    double sigma_2 = fSum2;
+    double sigma_3 = sigma * sigma_2;
+    double sigma_4 = sigma_2 * sigma_2;
+
+    fMu[level][0] = window.GetMean();
+    fMu[level][1] = window.GetCentralSum(2) / fSum0;
+    fMu[level][2] = window.GetCentralSum(3) / (sigma_3 * fSum0);
+    fMu[level][3] = window.GetCentralSum(4) / (sigma_4 * fSum0);
+  }
+
+  return 0;
+}
+
 /* =========== transformation moment -> cumulants ==================== */
 
 template <class TInput>
@@ -411,8 +488,102 @@ TOutput KullbackLeiblerProfile<TInput1, TInput2, TOutput>::operator()(const TInp
   return static_cast<TOutput>(cum1.KL_profile(cum2) + cum2.KL_profile(cum1));
 }
 
+template <class TInput1, class TInput2, class TOutput>
+TOutput KullbackLeiblerProfile<TInput1, TInput2, TOutput>::operator()(const std::vector<WindowPowerSums>& sums1, const std::vector<WindowPowerSums>& sums2)
+{
+  CumulantsForEdgeworthProfile<TInput1> cum1(sums1);
+
+  if (cum1.m_debug)
+  {
+    itk::VariableLengthVector<double> resu(m_RadiusMax - m_RadiusMin + 1);
+    resu.Fill(1e3);
+    return static_cast<TOutput>(resu);
+  }
+
+  CumulantsForEdgeworthProfile<TInput2> cum2(sums2);
+
+  if (cum2.m_debug)
+  {
+    itk::VariableLengthVector<double> resu(m_RadiusMax - m_RadiusMin + 1);
+    resu.Fill(1e3);
+    return static_cast<TOutput>(resu);
+  }
+
+  return static_cast<TOutput>(cum1.KL_profile(cum2) + cum2.KL_profile(cum1));
+}
+
 } // Functor
 
+/* *******************************************************************
+*
+*  KullbackLeiblerProfileImageFilter
+*
+* ********************************************************************
+*/
+
+template <class TInputImage1, class TInputImage2, class TOutputImage>
+void KullbackLeiblerProfileImageFilter<TInputImage1, TInputImage2, TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                                       itk::ThreadIdType threadId)
+{
+  const TInputImage1* inputPtr1 = dynamic_cast<const TInputImage1*>(this->itk::ProcessObject::GetInput(0));
+  const TInputImage2* inputPtr2 = dynamic_cast<const TInputImage2*>(this->itk::ProcessObject::GetInput(1));
+  TOutputImage*       outputPtr = this->GetOutput();
+
+  FunctorType&       functor   = this->GetFunctor();
+  const unsigned int radiusMin = functor.GetRadiusMin();
+  const unsigned int radiusMax = functor.GetRadiusMax();
+
+  // Every window of the profile is read from the integral images built for
+  // the largest one
+  std::vector<SizeType> radii;
+  for (unsigned int radius = radiusMin; radius <= radiusMax; ++radius)
+  {
+    SizeType size;
+    size.Fill(radius);
+    radii.push_back(size);
+  }
+  const SizeType& largestRadius = radii.back();
+
+  PowerSums1Type               powerSums1(4);
+  PowerSums2Type               powerSums2(4);
+  std::vector<WindowPowerSums> windowSums1(radii.size());
+  std::vector<WindowPowerSums> windowSums2(radii.size());
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // The integral images are built for bands of rows to bound their size
+  const long rowsPerBand = PowerSums1Type::GetNumberOfRowsPerBand(largestRadius);
+  const long firstRow    = outputRegionForThread.GetIndex()[1];
+  const long endRow      = firstRow + static_cast<long>(outputRegionForThread.GetSize()[1]);
+
+  for (long bandRow = firstRow; bandRow < endRow; bandRow += rowsPerBand)
+  {
+    OutputImageRegionType band = outputRegionForThread;
+    band.SetIndex(1, bandRow);
+    band.SetSize(1, std::min(rowsPerBand, endRow - bandRow));
+
+    powerSums1.Compute(inputPtr1, band, largestRadius);
+    powerSums2.Compute(inputPtr2, band, largestRadius);
+
+    itk::ImageScanlineIterator<TOutputImage> outputIt(outputPtr, band);
+    for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); outputIt.NextLine())
+    {
+      typename TOutputImage::IndexType index = outputIt.GetIndex();
+      for (; !outputIt.IsAtEndOfLine(); ++outputIt, ++index[0])
+      {
+        for (unsigned int level = 0; level < radii.size(); ++level)
+        {
+          powerSums1.GetWindowSums(index, radii[level], windowSums1[level]);
+          powerSums2.GetWindowSums(index, radii[level], windowSums2[level]);
+        }
+        outputIt.Set(functor(windowSums1, windowSums2));
+        progress.CompletedPixel();
+      }
+    }
+  }
+}
+
 } // namespace otb
 
 #endif
@@ -0,0 +1,461 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLocalPowerSums_h
+#define otbLocalPowerSums_h
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "itkImageRegionConstIterator.h"
+
+namespace otb
+{
+
+/** \class WindowPowerSums
+ * \brief Sums of the first powers of the values of a window.
+ *
+ * The sums are stored relative to an offset close to the values, which
+ * keeps them exact for integer values and limits the cancellation when the
+ * central sums are derived from them. GetCentralSumError() bounds what is
+ * left of that cancellation.
+ *
+ * \ingroup OTBChangeDetection
+ * \sa LocalPowerSums
+ */
+class WindowPowerSums
+{
+public:
+  /** Highest power available */
+  static const unsigned int MaximumOrder = 4;
+
+  WindowPowerSums() : m_Count(0), m_Order(0), m_Offset(0.)
+  {
+    std::fill(m_Sums, m_Sums + MaximumOrder + 1, 0.);
+  }
+
+  /** Set the number of values, the offset and the sums of the powers 1 to
+   * order of the values minus the offset */
+  void Set(unsigned long count, double offset, const double* sums, unsigned int order)
+  {
+    m_Count   = count;
+    m_Order   = order;
+    m_Offset  = offset;
+    m_Sums[0] = static_cast<double>(count);
+    for (unsigned int k = 1; k <= MaximumOrder; ++k)
+    {
+      m_Sums[k] = k <= order ? sums[k - 1] : 0.;
+    }
+  }
+
+  unsigned long GetCount() const
+  {
+    return m_Count;
+  }
+
+  double GetMean() const
+  {
+    return m_Offset + m_Sums[1] / m_Sums[0];
+  }
+
+  /** Sum of the k-th powers of the values */
+  double GetRawSum(unsigned int k) const
+  {
+    return ShiftedSum(k, m_Offset);
+  }
+
+  /** Sum of the k-th powers of the deviations of the values to their mean */
+  double GetCentralSum(unsigned int k) const
+  {
+    return ShiftedSum(k, -m_Sums[1] / m_Sums[0]);
+  }
+
+  /** Bound of the rounding error of GetCentralSum(k), given the bounds
+   * sumErrors[j] of the errors of the stored sums of the powers j, from 0
+   * to k, and a bound of the deviations of the values to the offset */
+  double GetCentralSumError(unsigned int k, const double* sumErrors, double maxDeviation) const
+  {
+    const double epsilon    = std::numeric_limits<double>::epsilon();
+    const double shift      = std::abs(m_Sums[1] / m_Sums[0]);
+    const double shiftError = sumErrors[1] / m_Sums[0];
+
+    // Errors of the stored sums and of the expansion, scaled by the powers
+    // of the shift: this is where a mean far from the offset costs digits
+    double error       = 0.;
+    double coefficient = 1.;
+    double power       = 1.;
+    for (unsigned int j = 0; j <= k; ++j)
+    {
+      error += coefficient * power * (sumErrors[k - j] + (k + 2) * epsilon * AbsoluteSum(k - j, maxDeviation));
+      coefficient = coefficient * (k - j) / (j + 1);
+      power *= shift;
+    }
+
+    // Error of the shift, the derivative of the central sum of order k
+    // being k times the one of order k-1
+    double deviationPower = 1.;
+    for (unsigned int j = 1; j < k; ++j)
+    {
+      deviationPower *= maxDeviation + shift;
+    }
+    return error + k * m_Sums[0] * deviationPower * shiftError;
+  }
+
+private:
+  /** Sum of (x + shift)^k, x being the stored values, from the binomial
+   * expansion */
+  double ShiftedSum(unsigned int k, double shift) const
+  {
+    double sum         = 0.;
+    double coefficient = 1.;
+    double power       = 1.;
+    for (unsigned int j = 0; j <= k; ++j)
+    {
+      // C(k, k-j) * shift^j * S(k-j)
+      sum += coefficient * power * m_Sums[k - j];
+      coefficient = coefficient * (k - j) / (j + 1);
+      power *= shift;
+    }
+    return sum;
+  }
+
+  /** Bound of the sum of the m-th powers of the absolute values stored,
+   * from Cauchy-Schwarz for the odd powers */
+  double AbsoluteSum(unsigned int m, double maxDeviation) const
+  {
+    if (m % 2 == 0)
+    {
+      return std::abs(m_Sums[m]);
+    }
+    double bound = m_Sums[0];
+    for (unsigned int j = 0; j < m; ++j)
+    {
+      bound *= maxDeviation;
+    }
+    if (m < m_Order)
+    {
+      bound = std::min(bound, std::sqrt(std::abs(m_Sums[m - 1] * m_Sums[m + 1])));
+    }
+    return bound;
+  }
+
+  unsigned long m_Count;
+  unsigned int  m_Order;
+  double        m_Offset;
+  double        m_Sums[MaximumOrder + 1];
+};
+
+/** \class LocalPowerSums
+ * \brief Sums of the powers of the values of the rectangular windows of a
+ * region, computed from integral images.
+ *
+ * Compute() reads the region of an image dilated by the largest radius of
+ * the windows, extended on the borders of the buffered region like
+ * itk::ZeroFluxNeumannBoundaryCondition. It splits the region in blocks of
+ * columns and builds, for each block, the integral images of the powers 1
+ * to order of its values minus the mean of the block. The sums of any
+ * window centered in the region, with a radius up to the one given to
+ * Compute(), are then given by GetWindowSums() in constant time, whatever
+ * its size.
+ *
+ * The offset of a block stays close to the values of its windows and its
+ * integral images stay small, but a window far from the mean of its block,
+ * next to a strong edge, may still lose the digits of its central sums.
+ * GetWindowSums() bounds that error and, when it exceeds
+ * GetRelativeTolerance() of the normalized central moments, sums the
+ * values of the window around its own mean instead.
+ *
+ * This class only supports images of dimension 2 with scalar pixels.
+ *
+ * \ingroup OTBChangeDetection
+ * \sa WindowPowerSums
+ */
+template <class TImage>
+class LocalPowerSums
+{
+public:
+  typedef TImage                         ImageType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef typename ImageType::IndexType  IndexType;
+  typedef typename ImageType::SizeType   SizeType;
+
+  explicit LocalPowerSums(unsigned int order = WindowPowerSums::MaximumOrder)
+    : m_Order(order), m_Width(0), m_Height(0), m_BlockWidth(1)
+  {
+    if (m_Order < 1)
+    {
+      m_Order = 1;
+    }
+    if (m_Order > WindowPowerSums::MaximumOrder)
+    {
+      m_Order = WindowPowerSums::MaximumOrder;
+    }
+    m_Origin.Fill(0);
+    m_Radius.Fill(0);
+  }
+
+  /** Number of rows of the regions to give to Compute(), which is also the
+   * number of columns of the blocks: small, so that the windows of a block
+   * stay close to its mean, while the rows and columns read for the margins
+   * do not more than double the work for large radii */
+  static unsigned long GetNumberOfRowsPerBand(const SizeType& radius)
+  {
+    return std::max<unsigned long>(16, 2 * radius[1]);
+  }
+
+  /** Largest error of the normalized central moments (relative for the
+   * variance) accepted before summing the values of a window */
+  static double GetRelativeTolerance()
+  {
+    return 1e-6;
+  }
+
+  /** Build the integral images for the windows of the given radius centered
+   * in the region */
+  void Compute(const ImageType* image, const RegionType& region, const SizeType& radius)
+  {
+    const RegionType& buffered = image->GetBufferedRegion();
+    const long        firstX   = buffered.GetIndex()[0];
+    const long        lastX    = firstX + static_cast<long>(buffered.GetSize()[0]) - 1;
+    const long        firstY   = buffered.GetIndex()[1];
+    const long        lastY    = firstY + static_cast<long>(buffered.GetSize()[1]) - 1;
+
+    m_Radius    = radius;
+    m_Origin[0] = region.GetIndex()[0] - static_cast<long>(radius[0]);
+    m_Origin[1] = region.GetIndex()[1] - static_cast<long>(radius[1]);
+    m_Width     = region.GetSize()[0] + 2 * radius[0];
+    m_Height    = region.GetSize()[1] + 2 * radius[1];
+
+    // Values of the dilated region, the borders being replicated
+    const long          rowBegin = std::min(std::max(m_Origin[0], firstX), lastX);
+    const long          rowEnd   = std::min(std::max(m_Origin[0] + m_Width - 1, firstX), lastX);
+    std::vector<double> row(rowEnd - rowBegin + 1);
+    m_Values.resize(m_Width * m_Height);
+    for (long y = 0; y < m_Height; ++y)
+    {
+      RegionType rowRegion;
+      rowRegion.SetIndex(0, rowBegin);
+      rowRegion.SetIndex(1, std::min(std::max(m_Origin[1] + y, firstY), lastY));
+      rowRegion.SetSize(0, row.size());
+      rowRegion.SetSize(1, 1);
+
+      itk::ImageRegionConstIterator<ImageType> it(image, rowRegion);
+      for (std::vector<double>::iterator rowIt = row.begin(); rowIt != row.end(); ++rowIt, ++it)
+      {
+        *rowIt = static_cast<double>(it.Get());
+      }
+
+      double* value = &m_Values[y * m_Width];
+      for (long x = 0; x < m_Width; ++x)
+      {
+        value[x] = row[std::min(std::max(m_Origin[0] + x, rowBegin), rowEnd) - rowBegin];
+      }
+    }
+
+    // Blocks of columns of the region, each with the margins of its windows
+    const long nbColumns = region.GetSize()[0];
+    m_BlockWidth         = std::max<long>(16, 2 * radius[0]);
+    m_Blocks.resize((nbColumns + m_BlockWidth - 1) / m_BlockWidth);
+    for (unsigned long b = 0; b < m_Blocks.size(); ++b)
+    {
+      Block& block = m_Blocks[b];
+      block.x0     = b * m_BlockWidth;
+      block.width  = std::min(m_BlockWidth, nbColumns - block.x0) + 2 * radius[0];
+      ComputeBlock(block);
+    }
+  }
+
+  /** Sums of the window of the given radius centered on a pixel of the
+   * region given to Compute() */
+  void GetWindowSums(const IndexType& center, const SizeType& radius, WindowPowerSums& sums) const
+  {
+    const long x0 = center[0] - static_cast<long>(radius[0]) - m_Origin[0];
+    const long x1 = center[0] + static_cast<long>(radius[0]) + 1 - m_Origin[0];
+    const long y0 = center[1] - static_cast<long>(radius[1]) - m_Origin[1];
+    const long y1 = center[1] + static_cast<long>(radius[1]) + 1 - m_Origin[1];
+
+    const Block& block = m_Blocks[(center[0] - m_Origin[0] - static_cast<long>(m_Radius[0])) / m_BlockWidth];
+
+    const long    stride      = (block.width + 1) * m_Order;
+    const double* topLeft     = &block.integrals[y0 * stride + (x0 - block.x0) * m_Order];
+    const double* topRight    = &block.integrals[y0 * stride + (x1 - block.x0) * m_Order];
+    const double* bottomLeft  = &block.integrals[y1 * stride + (x0 - block.x0) * m_Order];
+    const double* bottomRight = &block.integrals[y1 * stride + (x1 - block.x0) * m_Order];
+
+    double boxSums[WindowPowerSums::MaximumOrder];
+    for (unsigned int k = 0; k < m_Order; ++k)
+    {
+      boxSums[k] = (bottomRight[k] - bottomLeft[k]) - (topRight[k] - topLeft[k]);
+    }
+    sums.Set((x1 - x0) * (y1 - y0), block.offset, boxSums, m_Order);
+
+    if (m_Order > 1 && !IsAccurate(block, sums))
+    {
+      SumWindow(x0, x1, y0, y1, sums);
+    }
+  }
+
+private:
+  /** Integral images of the powers of a block of columns of the dilated
+   * region, relative to the mean of the block */
+  struct Block
+  {
+    long                x0;
+    long                width;
+    double              offset;
+    double              maxDeviation;
+    double              sumErrors[WindowPowerSums::MaximumOrder + 1];
+    std::vector<double> integrals;
+  };
+
+  void ComputeBlock(Block& block) const
+  {
+    // Rounded for integer values, so that their sums are exact
+    double mean    = 0.;
+    bool   integer = true;
+    for (long y = 0; y < m_Height; ++y)
+    {
+      const double* value = &m_Values[y * m_Width + block.x0];
+      for (long x = 0; x < block.width; ++x)
+      {
+        mean += value[x];
+        integer = integer && value[x] == std::floor(value[x]);
+      }
+    }
+    mean /= block.width * m_Height;
+    block.offset = integer ? std::floor(mean + 0.5) : mean;
+
+    // Integral images of the powers, interleaved, with a first row and column
+    // of zeros, and the sums of the absolute values of the powers
+    const long stride = (block.width + 1) * m_Order;
+    block.integrals.assign((m_Height + 1) * stride, 0.);
+    block.maxDeviation = 0.;
+    std::vector<double> rowSums(m_Order);
+    std::vector<double> absoluteSums(m_Order, 0.);
+    for (long y = 0; y < m_Height; ++y)
+    {
+      std::fill(rowSums.begin(), rowSums.end(), 0.);
+      const double* value    = &m_Values[y * m_Width + block.x0];
+      const double* previous = &block.integrals[y * stride + m_Order];
+      double*       integral = &block.integrals[(y + 1) * stride + m_Order];
+      for (long x = 0; x < block.width; ++x)
+      {
+        const double v     = value[x] - block.offset;
+        double       power = 1.;
+        for (unsigned int k = 0; k < m_Order; ++k)
+        {
+          power *= v;
+          rowSums[k] += power;
+          absoluteSums[k] += std::abs(power);
+          integral[k] = previous[k] + rowSums[k];
+        }
+        block.maxDeviation = std::max(block.maxDeviation, std::abs(v));
+        previous += m_Order;
+        integral += m_Order;
+      }
+    }
+
+    // Integers below 2^53 are summed exactly; otherwise, the error of the
+    // recursive sums and of the differences of GetWindowSums() is bounded by
+    // the number of additions times the sum of the absolute values
+    const double exactLimit = 9007199254740992.;
+    bool         exact      = integer;
+    for (unsigned int k = 0; k < m_Order; ++k)
+    {
+      exact = exact && absoluteSums[k] < exactLimit;
+    }
+    const double errorFactor = exact ? 0. : (block.width + m_Height + 4) * std::numeric_limits<double>::epsilon();
+
+    std::fill(block.sumErrors, block.sumErrors + WindowPowerSums::MaximumOrder + 1, 0.);
+    for (unsigned int k = 0; k < m_Order; ++k)
+    {
+      block.sumErrors[k + 1] = errorFactor * absoluteSums[k];
+    }
+  }
+
+  /** Whether the central sums of the window are accurate enough for the
+   * normalized moments: the variance, and the third and fourth central
+   * moments divided by the powers of the standard deviation */
+  bool IsAccurate(const Block& block, const WindowPowerSums& sums) const
+  {
+    const double count       = static_cast<double>(sums.GetCount());
+    const double centralSum2 = std::max(0., sums.GetCentralSum(2));
+    const double sigma       = std::sqrt(centralSum2 / count);
+
+    double scale = centralSum2;
+    for (unsigned int k = 2; k <= m_Order; ++k, scale *= sigma)
+    {
+      if (sums.GetCentralSumError(k, block.sumErrors, block.maxDeviation) > GetRelativeTolerance() * scale)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Sums of the window around its own mean, read from the values */
+  void SumWindow(long x0, long x1, long y0, long y1, WindowPowerSums& sums) const
+  {
+    const long count = (x1 - x0) * (y1 - y0);
+
+    double mean = 0.;
+    for (long y = y0; y < y1; ++y)
+    {
+      const double* value = &m_Values[y * m_Width];
+      for (long x = x0; x < x1; ++x)
+      {
+        mean += value[x];
+      }
+    }
+    mean /= count;
+
+    double windowSums[WindowPowerSums::MaximumOrder] = {0., 0., 0., 0.};
+    for (long y = y0; y < y1; ++y)
+    {
+      const double* value = &m_Values[y * m_Width];
+      for (long x = x0; x < x1; ++x)
+      {
+        const double v     = value[x] - mean;
+        double       power = 1.;
+        for (unsigned int k = 0; k < m_Order; ++k)
+        {
+          power *= v;
+          windowSums[k] += power;
+        }
+      }
+    }
+    sums.Set(count, mean, windowSums, m_Order);
+  }
+
+  unsigned int        m_Order;
+  IndexType           m_Origin;
+  SizeType            m_Radius;
+  long                m_Width;
+  long                m_Height;
+  long                m_BlockWidth;
+  std::vector<double> m_Values;
+  std::vector<Block>  m_Blocks;
+};
+
+} // end namespace otb
+
+#endif
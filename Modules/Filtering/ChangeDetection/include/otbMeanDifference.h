@@ -21,6 +21,8 @@
 #ifndef otbMeanDifference_h
 #define otbMeanDifference_h
 
+#include "otbLocalPowerSums.h"
+
 namespace otb
 {
 
@@ -51,6 +53,21 @@ public:
     }
     return static_cast<TOutput>((meanA - meanB) / itA.Size());
   }
+
+  /** Same measure from the power sums of the windows */
+  inline TOutput operator()(const WindowPowerSums& sumsA, const WindowPowerSums& sumsB)
+  {
+    TOutput meanA = static_cast<TOutput>(sumsA.GetRawSum(1));
+    TOutput meanB = static_cast<TOutput>(sumsB.GetRawSum(1));
+
+    return static_cast<TOutput>((meanA - meanB) / sumsA.GetCount());
+  }
+
+  /** Only the means are needed */
+  static unsigned int GetPowerSumsOrder()
+  {
+    return 1;
+  }
 };
 }
 }
@@ -21,7 +21,7 @@
 #ifndef otbMeanDifferenceImageFilter_h
 #define otbMeanDifferenceImageFilter_h
 
-#include "otbBinaryFunctorNeighborhoodImageFilter.h"
+#include "otbBinaryFunctorPowerSumsImageFilter.h"
 #include "otbMeanDifference.h"
 
 namespace otb
@@ -47,6 +47,10 @@ namespace otb
  * The filter expect all images to have the same dimension
  * (e.g. all 2D, or all 3D, or all ND)
  *
+ * The means of the windows are computed from integral images (see
+ * BinaryFunctorPowerSumsImageFilter), at a cost which does not depend on
+ * the radius.
+ *
  * \ingroup IntensityImageFilters Multithreaded
  *
  * \ingroup OTBChangeDetection
@@ -54,7 +58,7 @@ namespace otb
 
 template <class TInputImage1, class TInputImage2, class TOutputImage>
 class ITK_EXPORT MeanDifferenceImageFilter
-    : public BinaryFunctorNeighborhoodImageFilter<
+    : public BinaryFunctorPowerSumsImageFilter<
           TInputImage1, TInputImage2, TOutputImage,
           Functor::MeanDifference<typename itk::ConstNeighborhoodIterator<TInputImage1>, typename itk::ConstNeighborhoodIterator<TInputImage2>,
                                   typename TOutputImage::PixelType>>
@@ -62,9 +66,9 @@ class ITK_EXPORT MeanDifferenceImageFilter
 public:
   /** Standard class typedefs. */
   typedef MeanDifferenceImageFilter Self;
-  typedef BinaryFunctorNeighborhoodImageFilter<TInputImage1, TInputImage2, TOutputImage,
-                                               Functor::MeanDifference<typename itk::ConstNeighborhoodIterator<TInputImage1>,
-                                                                       typename itk::ConstNeighborhoodIterator<TInputImage2>, typename TOutputImage::PixelType>>
+  typedef BinaryFunctorPowerSumsImageFilter<TInputImage1, TInputImage2, TOutputImage,
+                                            Functor::MeanDifference<typename itk::ConstNeighborhoodIterator<TInputImage1>,
+                                                                    typename itk::ConstNeighborhoodIterator<TInputImage2>, typename TOutputImage::PixelType>>
                                         Superclass;
   typedef itk::SmartPointer<Self>       Pointer;
   typedef itk::SmartPointer<const Self> ConstPointer;
@@ -22,6 +22,7 @@
 #define otbMeanRatio_h
 
 #include "otbBinaryFunctorNeighborhoodImageFilter.h"
+#include "otbLocalPowerSums.h"
 
 namespace otb
 {
@@ -67,8 +68,30 @@ public:
     meanA /= itA.Size();
     meanB /= itB.Size();
 
-    // std::cout<<"meanA= "<<meanA<<", meanB= "<<meanB<<std::endl;
+    return RatioOfMeans(meanA, meanB);
+  }
+
+  /** Same measure from the power sums of the windows */
+  inline TOutput operator()(const WindowPowerSums& sumsA, const WindowPowerSums& sumsB)
+  {
+    TOutput meanA = static_cast<TOutput>(sumsA.GetRawSum(1));
+    TOutput meanB = static_cast<TOutput>(sumsB.GetRawSum(1));
+
+    meanA /= sumsA.GetCount();
+    meanB /= sumsB.GetCount();
+
+    return RatioOfMeans(meanA, meanB);
+  }
 
+  /** Only the means are needed */
+  static unsigned int GetPowerSumsOrder()
+  {
+    return 1;
+  }
+
+private:
+  static TOutput RatioOfMeans(const TOutput& meanA, const TOutput& meanB)
+  {
     TOutput ratio;
 
     if (meanA == meanB)
@@ -21,6 +21,7 @@
 #ifndef otbMeanRatioImageFilter_h
 #define otbMeanRatioImageFilter_h
 
+#include "otbBinaryFunctorPowerSumsImageFilter.h"
 #include "otbMeanRatio.h"
 
 namespace otb
@@ -45,6 +46,10 @@ namespace otb
  * The filter expect all images to have the same dimension
  * (e.g. all 2D, or all 3D, or all ND)
  *
+ * The means of the windows are computed from integral images (see
+ * BinaryFunctorPowerSumsImageFilter), at a cost which does not depend on
+ * the radius.
+ *
  * \ingroup IntensityImageFilters Multithreaded
  *
  * \ingroup OTBChangeDetection
@@ -52,16 +57,16 @@ namespace otb
 
 template <class TInputImage1, class TInputImage2, class TOutputImage>
 class ITK_EXPORT MeanRatioImageFilter
-    : public BinaryFunctorNeighborhoodImageFilter<TInputImage1, TInputImage2, TOutputImage,
-                                                  Functor::MeanRatio<typename itk::ConstNeighborhoodIterator<TInputImage1>,
-                                                                     typename itk::ConstNeighborhoodIterator<TInputImage2>, typename TOutputImage::PixelType>>
+    : public BinaryFunctorPowerSumsImageFilter<TInputImage1, TInputImage2, TOutputImage,
+                                               Functor::MeanRatio<typename itk::ConstNeighborhoodIterator<TInputImage1>,
+                                                                  typename itk::ConstNeighborhoodIterator<TInputImage2>, typename TOutputImage::PixelType>>
 {
 public:
   /** Standard class typedefs. */
   typedef MeanRatioImageFilter Self;
-  typedef BinaryFunctorNeighborhoodImageFilter<TInputImage1, TInputImage2, TOutputImage,
-                                               Functor::MeanRatio<typename itk::ConstNeighborhoodIterator<TInputImage1>,
-                                                                  typename itk::ConstNeighborhoodIterator<TInputImage2>, typename TOutputImage::PixelType>>
+  typedef BinaryFunctorPowerSumsImageFilter<TInputImage1, TInputImage2, TOutputImage,
+                                            Functor::MeanRatio<typename itk::ConstNeighborhoodIterator<TInputImage1>,
+                                                               typename itk::ConstNeighborhoodIterator<TInputImage2>, typename TOutputImage::PixelType>>
                                         Superclass;
   typedef itk::SmartPointer<Self>       Pointer;
   typedef itk::SmartPointer<const Self> ConstPointer;
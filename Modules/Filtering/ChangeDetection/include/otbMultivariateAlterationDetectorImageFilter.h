@@ -22,7 +22,10 @@
 #define otbMultivariateAlterationDetectorImageFilter_h
 
 
+#include <vector>
+
 #include "otbStreamingStatisticsVectorImageFilter.h"
+#include "otbStreamingSampleReservoirImageFilter.h"
 #include "otbConcatenateVectorImageFilter.h"
 
 #include "vnl/vnl_vector.h"
@@ -64,6 +67,26 @@ namespace otb
  * double, and the GetRho() method allows retrieving the correlation
  * associated to each Mad change maps as a vnl_vector.
  *
+ * The iteratively re-weighted MAD (IR-MAD) of the following work is
+ * available through SetMaximumNumberOfIterations():
+ *
+ * A. A. Nielsen, "The regularized iteratively reweighted MAD method for
+ * change detection in multi- and hyperspectral data," IEEE Trans. Image
+ * Process., vol. 16, no. 2, pp. 463-478, (2007)
+ *
+ * At each iteration, the pixels are weighted by the probability of no
+ * change given by the chi-square distribution of their normalized MAD
+ * variates, and the canonical correlations are computed again from the
+ * weighted covariance, until no correlation moves by more than
+ * ConvergenceThreshold.
+ *
+ * By default, the joint covariance is estimated on every pixel with a
+ * streaming pass. When NumberOfSamples is set, a uniform subsample of the
+ * pixels is drawn in a single streaming pass and cached, and the
+ * statistics (weighted for IR-MAD) are estimated on it in memory: IR-MAD
+ * requires this subsample, since each iteration would otherwise read the
+ * images again. The change maps are then computed in one streamed pass.
+ *
  * This filter has been implemented from the Matlab code kindly made
  * available by the authors here:
  * http://www2.imm.dtu.dk/~aa/software.html
@@ -109,6 +132,8 @@ public:
   typedef typename CovarianceEstimatorType::Pointer            CovarianceEstimatorPointer;
   typedef otb::ConcatenateVectorImageFilter<InputImageType, InputImageType, InputImageType> ConcatenateImageFilterType;
   typedef typename ConcatenateImageFilterType::Pointer ConcatenateImageFilterPointer;
+  typedef StreamingSampleReservoirImageFilter<InputImageType> SamplerType;
+  typedef typename SamplerType::Pointer                       SamplerPointer;
 
   typedef typename CovarianceEstimatorType::MatrixObjectType MatrixObjectType;
   typedef typename MatrixObjectType::ComponentType           MatrixType;
@@ -142,6 +167,37 @@ public:
   /** Get the covariance estimator (for progress reporting purposes) */
   itkGetObjectMacro(CovarianceEstimator, CovarianceEstimatorType);
 
+  /** Get the sampler (for progress reporting purposes) */
+  itkGetObjectMacro(Sampler, SamplerType);
+
+  /** Size of the cached subsample on which the statistics are estimated.
+   *  0 (default) estimates them on every pixel with a streaming pass, which
+   *  only allows the plain MAD. */
+  itkSetMacro(NumberOfSamples, unsigned long);
+  itkGetConstMacro(NumberOfSamples, unsigned long);
+
+  /** Seed of the random draw of the subsample */
+  itkSetMacro(Seed, unsigned int);
+  itkGetConstMacro(Seed, unsigned int);
+
+  /** Maximum number of iterations of IR-MAD. 1 (default) gives the plain
+   *  MAD. */
+  itkSetMacro(MaximumNumberOfIterations, unsigned int);
+  itkGetConstMacro(MaximumNumberOfIterations, unsigned int);
+
+  /** IR-MAD stops when no canonical correlation changes by more than this
+   *  threshold between two iterations */
+  itkSetMacro(ConvergenceThreshold, double);
+  itkGetConstMacro(ConvergenceThreshold, double);
+
+  /** Number of iterations actually performed */
+  itkGetConstMacro(NumberOfIterations, unsigned int);
+
+  /** Weights of the cached samples in the statistics of the last iteration:
+   *  1 for the plain MAD, and the probabilities of no change for IR-MAD.
+   *  Empty when the statistics are estimated on every pixel. */
+  itkGetConstReferenceMacro(SampleWeights, std::vector<double>);
+
   /** Connect one of the operands for pixel-wise addition */
   void SetInput1(const TInputImage* image1);
 
@@ -158,18 +214,43 @@ protected:
   {
   }
 
+  void BeforeThreadedGenerateData() override;
+
   void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
 
   void GenerateOutputInformation() override;
 
+  /** Compute V1, V2 and Rho from the joint covariance of both images */
+  void ComputeCanonicalTransform(const VnlMatrixType& covariance, unsigned int nbComp1, unsigned int nbComp2);
+
+  /** MAD or IR-MAD on the cached subsample */
+  void EstimateFromSamples(unsigned int nbComp1, unsigned int nbComp2);
+
 private:
   MultivariateAlterationDetectorImageFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
 
   CovarianceEstimatorPointer m_CovarianceEstimator;
+  SamplerPointer             m_Sampler;
   MatrixType                 m_CovarianceMatrix;
   VectorType                 m_MeanValues;
 
+  unsigned long m_NumberOfSamples;
+  unsigned int  m_Seed;
+  unsigned int  m_MaximumNumberOfIterations;
+  double        m_ConvergenceThreshold;
+  unsigned int  m_NumberOfIterations;
+
+  /** Weights of the cached samples in the last statistics */
+  std::vector<double> m_SampleWeights;
+
+  /** Transform applied to the pixels: out = Offset + x1 * Transform1 - x2 *
+   *  Transform2, with the matrices stored row by row and the ordering and
+   *  scaling of the change maps folded in */
+  std::vector<double> m_Transform1;
+  std::vector<double> m_Transform2;
+  std::vector<double> m_Offset;
+
   VnlMatrixType m_V1;
   VnlMatrixType m_V2;
   VnlVectorType m_Mean1;
@@ -21,22 +21,28 @@
 #ifndef otbMultivariateAlterationDetectorImageFilter_hxx
 #define otbMultivariateAlterationDetectorImageFilter_hxx
 
+#include <algorithm>
+
 #include "otbMultivariateAlterationDetectorImageFilter.h"
 #include "otbMath.h"
 
 #include "vnl/algo/vnl_matrix_inverse.h"
 #include "vnl/algo/vnl_generalized_eigensystem.h"
+#include "vnl/algo/vnl_chi_squared.h"
 
-#include "itkImageRegionIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 
 namespace otb
 {
 template <class TInputImage, class TOutputImage>
 MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::MultivariateAlterationDetectorImageFilter()
+  : m_NumberOfSamples(0), m_Seed(0), m_MaximumNumberOfIterations(1), m_ConvergenceThreshold(1e-3), m_NumberOfIterations(0)
 {
   this->SetNumberOfRequiredInputs(2);
   m_CovarianceEstimator = CovarianceEstimatorType::New();
+  m_Sampler             = SamplerType::New();
 }
 
 template <class TInputImage, class TOutputImage>
@@ -104,32 +110,59 @@ void MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::Gener
   concatenateFilter->SetInput1(input1Ptr);
   concatenateFilter->SetInput2(input2Ptr);
 
-  // The compute covariance matrix
-  // TODO: implement switch off of this computation
-  m_CovarianceEstimator->SetInput(concatenateFilter->GetOutput());
-  m_CovarianceEstimator->Update();
-  m_CovarianceMatrix = m_CovarianceEstimator->GetCovariance();
-  m_MeanValues       = m_CovarianceEstimator->GetMean();
+  if (m_NumberOfSamples == 0)
+  {
+    if (m_MaximumNumberOfIterations > 1)
+    {
+      itkExceptionMacro(<< "IR-MAD needs a cached subsample: the number of samples shall be set");
+    }
 
-  // Extract sub-matrices of the covariance matrix
-  VnlMatrixType s11 = m_CovarianceMatrix.GetVnlMatrix().extract(nbComp1, nbComp1);
-  VnlMatrixType s22 = m_CovarianceMatrix.GetVnlMatrix().extract(nbComp2, nbComp2, nbComp1, nbComp1);
-  VnlMatrixType s12 = m_CovarianceMatrix.GetVnlMatrix().extract(nbComp1, nbComp2, 0, nbComp1);
-  VnlMatrixType s21 = s12.transpose();
+    // The compute covariance matrix
+    m_CovarianceEstimator->SetInput(concatenateFilter->GetOutput());
+    m_CovarianceEstimator->Update();
+    m_CovarianceMatrix = m_CovarianceEstimator->GetCovariance();
+    m_MeanValues       = m_CovarianceEstimator->GetMean();
 
-  // Extract means
-  m_Mean1 = VnlVectorType(nbComp1, 0);
-  m_Mean2 = VnlVectorType(nbComp2, 0);
+    // Extract means
+    m_Mean1 = VnlVectorType(nbComp1, 0);
+    m_Mean2 = VnlVectorType(nbComp2, 0);
 
-  for (unsigned int i = 0; i < nbComp1; ++i)
-  {
-    m_Mean1[i] = m_MeanValues[i];
-  }
+    for (unsigned int i = 0; i < nbComp1; ++i)
+    {
+      m_Mean1[i] = m_MeanValues[i];
+    }
+
+    for (unsigned int i = 0; i < nbComp2; ++i)
+    {
+      m_Mean2[i] = m_MeanValues[nbComp1 + i];
+    }
 
-  for (unsigned int i = 0; i < nbComp2; ++i)
+    ComputeCanonicalTransform(m_CovarianceMatrix.GetVnlMatrix(), nbComp1, nbComp2);
+    m_NumberOfIterations = 1;
+    m_SampleWeights.clear();
+  }
+  else
   {
-    m_Mean2[i] = m_MeanValues[nbComp1 + i];
+    // Single pass over both images, then the statistics are estimated in
+    // memory
+    m_Sampler->SetInput(concatenateFilter->GetOutput());
+    m_Sampler->GetFilter()->SetReservoirSize(m_NumberOfSamples);
+    m_Sampler->GetFilter()->SetSeed(m_Seed);
+    m_Sampler->Update();
+    EstimateFromSamples(nbComp1, nbComp2);
+    m_Sampler->GetFilter()->ClearSamples();
   }
+}
+
+template <class TInputImage, class TOutputImage>
+void MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::ComputeCanonicalTransform(const VnlMatrixType& covariance, unsigned int nbComp1,
+                                                                                                     unsigned int nbComp2)
+{
+  // Extract sub-matrices of the covariance matrix
+  VnlMatrixType s11 = covariance.extract(nbComp1, nbComp1);
+  VnlMatrixType s22 = covariance.extract(nbComp2, nbComp2, nbComp1, nbComp1);
+  VnlMatrixType s12 = covariance.extract(nbComp1, nbComp2, 0, nbComp1);
+  VnlMatrixType s21 = s12.transpose();
 
   if (nbComp1 == nbComp2)
   {
@@ -261,94 +294,228 @@ void MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::Gener
 }
 
 template <class TInputImage, class TOutputImage>
-void MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
-                                                                                                itk::ThreadIdType threadId)
+void MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::EstimateFromSamples(unsigned int nbComp1, unsigned int nbComp2)
 {
-  // Retrieve input images pointers
-  const TInputImage* input1Ptr = this->GetInput1();
-  const TInputImage* input2Ptr = this->GetInput2();
-  TOutputImage*      outputPtr = this->GetOutput();
-
-
-  typedef itk::ImageRegionConstIterator<InputImageType> ConstIteratorType;
-  typedef itk::ImageRegionIterator<OutputImageType>     IteratorType;
-
-  IteratorType      outIt(outputPtr, outputRegionForThread);
-  ConstIteratorType inIt1(input1Ptr, outputRegionForThread);
-  ConstIteratorType inIt2(input2Ptr, outputRegionForThread);
-
-  inIt1.GoToBegin();
-  inIt2.GoToBegin();
-  outIt.GoToBegin();
-
-  // Get the number of components for each image
-  unsigned int nbComp1   = input1Ptr->GetNumberOfComponentsPerPixel();
-  unsigned int nbComp2   = input2Ptr->GetNumberOfComponentsPerPixel();
-  unsigned int outNbComp = outputPtr->GetNumberOfComponentsPerPixel();
+  const std::vector<double>& samples   = m_Sampler->GetSamples();
+  const unsigned long        nbSamples = m_Sampler->GetNumberOfSamples();
+  const unsigned int         nbComp    = nbComp1 + nbComp2;
+  const unsigned int         nbPairs   = std::min(nbComp1, nbComp2);
 
+  if (nbSamples < 2)
+  {
+    itkExceptionMacro(<< "At least two valid samples are needed, got " << nbSamples);
+  }
 
-  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+  std::vector<double>& weights = m_SampleWeights;
+  std::vector<double>  centered(nbComp);
+  std::vector<double>  mads(nbSamples * nbPairs);
+  VnlVectorType        previousRho;
+  weights.assign(nbSamples, 1.);
 
-  while (!inIt1.IsAtEnd() && !inIt2.IsAtEnd() && !outIt.IsAtEnd())
+  m_NumberOfIterations = 0;
+  while (m_NumberOfIterations < std::max(m_MaximumNumberOfIterations, 1U))
   {
-    VnlVectorType x1(nbComp1, 0);
-    VnlVectorType x1bis(outNbComp, 0);
-    VnlVectorType x2(nbComp2, 0);
-    VnlVectorType x2bis(outNbComp, 0);
-    VnlVectorType mad(outNbComp, 0);
-
-    for (unsigned int i = 0; i < nbComp1; ++i)
+    // Weighted mean and covariance, unbiased for unit weights
+    VnlVectorType mean(nbComp, 0.);
+    double        sumWeights = 0., sumSquaredWeights = 0.;
+    for (unsigned long s = 0; s < nbSamples; ++s)
     {
-      x1[i] = inIt1.Get()[i];
+      const double  w = weights[s];
+      const double* x = &samples[s * nbComp];
+      sumWeights += w;
+      sumSquaredWeights += w * w;
+      for (unsigned int c = 0; c < nbComp; ++c)
+      {
+        mean[c] += w * x[c];
+      }
+    }
+    const double normalization = sumWeights - sumSquaredWeights / sumWeights;
+    if (!(normalization > 0.))
+    {
+      itkExceptionMacro(<< "The weights of the samples are degenerated");
     }
+    mean /= sumWeights;
 
-    for (unsigned int i = 0; i < nbComp2; ++i)
+    VnlMatrixType covariance(nbComp, nbComp, 0.);
+    for (unsigned long s = 0; s < nbSamples; ++s)
+    {
+      const double  w = weights[s];
+      const double* x = &samples[s * nbComp];
+      for (unsigned int c = 0; c < nbComp; ++c)
+      {
+        centered[c] = x[c] - mean[c];
+      }
+      for (unsigned int i = 0; i < nbComp; ++i)
+      {
+        const double wi  = w * centered[i];
+        RealType*    row = covariance[i];
+        for (unsigned int j = i; j < nbComp; ++j)
+        {
+          row[j] += wi * centered[j];
+        }
+      }
+    }
+    for (unsigned int i = 0; i < nbComp; ++i)
     {
-      x2[i] = inIt2.Get()[i];
+      for (unsigned int j = i; j < nbComp; ++j)
+      {
+        covariance[i][j] /= normalization;
+        covariance[j][i] = covariance[i][j];
+      }
     }
 
-    VnlVectorType first  = (x1 - m_Mean1) * m_V1;
-    VnlVectorType second = (x2 - m_Mean2) * m_V2;
+    m_Mean1 = mean.extract(nbComp1, 0);
+    m_Mean2 = mean.extract(nbComp2, nbComp1);
+    ComputeCanonicalTransform(covariance, nbComp1, nbComp2);
+    ++m_NumberOfIterations;
 
-    for (unsigned int i = 0; i < nbComp1; ++i)
+    if (m_NumberOfIterations > 1 && (m_Rho - previousRho).inf_norm() < m_ConvergenceThreshold)
     {
-      x1bis[i] = first[i];
+      break;
     }
-
-    for (unsigned int i = 0; i < nbComp2; ++i)
+    previousRho = m_Rho;
+    if (m_NumberOfIterations >= m_MaximumNumberOfIterations)
     {
-      x2bis[i] = second[i];
+      break;
     }
 
-    mad = x1bis - x2bis;
+    // Paired MAD variates of the samples, and their weighted variances
+    std::vector<double> variances(nbPairs, 0.);
+    for (unsigned long s = 0; s < nbSamples; ++s)
+    {
+      const double* x   = &samples[s * nbComp];
+      double*       mad = &mads[s * nbPairs];
+      for (unsigned int p = 0; p < nbPairs; ++p)
+      {
+        double u = 0., v = 0.;
+        for (unsigned int i = 0; i < nbComp1; ++i)
+        {
+          u += (x[i] - m_Mean1[i]) * m_V1[i][p];
+        }
+        for (unsigned int i = 0; i < nbComp2; ++i)
+        {
+          v += (x[nbComp1 + i] - m_Mean2[i]) * m_V2[i][p];
+        }
+        mad[p] = u - v;
+        variances[p] += weights[s] * mad[p] * mad[p];
+      }
+    }
 
-    typename OutputImageType::PixelType outPixel(outNbComp);
+    // New weights: probability of no change
+    for (unsigned long s = 0; s < nbSamples; ++s)
+    {
+      const double* mad = &mads[s * nbPairs];
+      double        chi2 = 0.;
+      for (unsigned int p = 0; p < nbPairs; ++p)
+      {
+        chi2 += mad[p] * mad[p] * normalization / variances[p];
+      }
+      weights[s] = 1. - vnl_chi_squared_cumulative(chi2, static_cast<long>(nbPairs));
+    }
+  }
+}
 
-    if (nbComp1 == nbComp2)
+template <class TInputImage, class TOutputImage>
+void MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  const unsigned int nbComp1   = this->GetInput1()->GetNumberOfComponentsPerPixel();
+  const unsigned int nbComp2   = this->GetInput2()->GetNumberOfComponentsPerPixel();
+  const unsigned int outNbComp = this->GetOutput()->GetNumberOfComponentsPerPixel();
+  const unsigned int nbPairs   = std::min(nbComp1, nbComp2);
+
+  // Change map o is the mad variate source, scaled when the numbers of bands
+  // differ
+  m_Transform1.assign(nbComp1 * outNbComp, 0.);
+  m_Transform2.assign(nbComp2 * outNbComp, 0.);
+  m_Offset.assign(outNbComp, 0.);
+  for (unsigned int o = 0; o < outNbComp; ++o)
+  {
+    unsigned int source = o;
+    double       scale  = 1.;
+    if (nbComp1 != nbComp2)
+    {
+      source = outNbComp - o - 1;
+      scale  = o < outNbComp - nbPairs ? std::sqrt(2.) : 1.;
+    }
+    if (source < nbComp1)
     {
-      for (unsigned int i = 0; i < outNbComp; ++i)
+      for (unsigned int i = 0; i < nbComp1; ++i)
       {
-        outPixel[i] = mad[i];
+        m_Transform1[i * outNbComp + o] = scale * m_V1[i][source];
+        m_Offset[o] -= m_Mean1[i] * m_Transform1[i * outNbComp + o];
       }
     }
-    else
+    if (source < nbComp2)
     {
-      for (unsigned int i = 0; i < outNbComp; ++i)
+      for (unsigned int i = 0; i < nbComp2; ++i)
       {
-        outPixel[i] = mad[outNbComp - i - 1];
+        m_Transform2[i * outNbComp + o] = scale * m_V2[i][source];
+        m_Offset[o] += m_Mean2[i] * m_Transform2[i * outNbComp + o];
+      }
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+void MultivariateAlterationDetectorImageFilter<TInputImage, TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                                itk::ThreadIdType threadId)
+{
+  // Retrieve input images pointers
+  const TInputImage* input1Ptr = this->GetInput1();
+  const TInputImage* input2Ptr = this->GetInput2();
+  TOutputImage*      outputPtr = this->GetOutput();
+
+  typedef itk::ImageScanlineConstIterator<InputImageType> ConstIteratorType;
+  typedef itk::ImageScanlineIterator<OutputImageType>     IteratorType;
+
+  IteratorType      outIt(outputPtr, outputRegionForThread);
+  ConstIteratorType inIt1(input1Ptr, outputRegionForThread);
+  ConstIteratorType inIt2(input2Ptr, outputRegionForThread);
+
+  // Get the number of components for each image
+  const unsigned int nbComp1   = input1Ptr->GetNumberOfComponentsPerPixel();
+  const unsigned int nbComp2   = input2Ptr->GetNumberOfComponentsPerPixel();
+  const unsigned int outNbComp = outputPtr->GetNumberOfComponentsPerPixel();
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize()[0]);
 
-        if (i < outNbComp - std::min(nbComp1, nbComp2))
+  OutputImagePixelType outPixel(outNbComp);
+  std::vector<double>  mad(outNbComp);
+
+  for (inIt1.GoToBegin(), inIt2.GoToBegin(), outIt.GoToBegin(); !outIt.IsAtEnd(); inIt1.NextLine(), inIt2.NextLine(), outIt.NextLine())
+  {
+    for (; !outIt.IsAtEndOfLine(); ++inIt1, ++inIt2, ++outIt)
+    {
+      const InputImagePixelType& x1 = inIt1.Get();
+      const InputImagePixelType& x2 = inIt2.Get();
+
+      // Accumulate the rows of the transforms, which are contiguous
+      std::copy(m_Offset.begin(), m_Offset.end(), mad.begin());
+      for (unsigned int i = 0; i < nbComp1; ++i)
+      {
+        const double  value = static_cast<double>(x1[i]);
+        const double* row   = &m_Transform1[i * outNbComp];
+        for (unsigned int o = 0; o < outNbComp; ++o)
         {
-          outPixel[i] *= std::sqrt(2.);
+          mad[o] += value * row[o];
+        }
+      }
+      for (unsigned int i = 0; i < nbComp2; ++i)
+      {
+        const double  value = static_cast<double>(x2[i]);
+        const double* row   = &m_Transform2[i * outNbComp];
+        for (unsigned int o = 0; o < outNbComp; ++o)
+        {
+          mad[o] -= value * row[o];
         }
       }
-    }
-
-    outIt.Set(outPixel);
 
-    ++inIt1;
-    ++inIt2;
-    ++outIt;
+      for (unsigned int o = 0; o < outNbComp; ++o)
+      {
+        outPixel[o] = static_cast<typename OutputImagePixelType::ValueType>(mad[o]);
+      }
+      outIt.Set(outPixel);
+    }
     progress.CompletedPixel();
   }
 }
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+This test checks that the change detectors computing the moments of the
+windows from integral images give the same results as the walk over the
+neighborhoods, with streaming.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkStreamingImageFilter.h"
+
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "otbMeanDifferenceImageFilter.h"
+#include "otbKullbackLeiblerDistanceImageFilter.h"
+#include "otbKullbackLeiblerProfileImageFilter.h"
+
+namespace
+{
+typedef otb::Image<double, 2>       PowerSumsImageType;
+typedef otb::VectorImage<double, 2> PowerSumsVectorImageType;
+
+template <class TImage>
+double MaximumDifference(const TImage* a, const TImage* b)
+{
+  itk::ImageRegionConstIterator<TImage> itA(a, a->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<TImage> itB(b, b->GetLargestPossibleRegion());
+  double                                maxError = 0.;
+  for (itA.GoToBegin(), itB.GoToBegin(); !itA.IsAtEnd(); ++itA, ++itB)
+  {
+    for (unsigned int c = 0; c < a->GetNumberOfComponentsPerPixel(); ++c)
+    {
+      const double va = itk::DefaultConvertPixelTraits<typename TImage::PixelType>::GetNthComponent(c, itA.Get());
+      const double vb = itk::DefaultConvertPixelTraits<typename TImage::PixelType>::GetNthComponent(c, itB.Get());
+      maxError        = std::max(maxError, std::abs(va - vb) / (1. + std::abs(va)));
+    }
+  }
+  return maxError;
+}
+
+/** Whole image on the neighborhoods against streamed on the power sums */
+template <class TFilter, class TReference>
+double CompareScalarFilters(PowerSumsImageType* input1, PowerSumsImageType* input2, unsigned int radius)
+{
+  typename TReference::Pointer reference = TReference::New();
+  reference->SetRadius(radius);
+  reference->SetInput1(input1);
+  reference->SetInput2(input2);
+  reference->Update();
+
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetRadius(radius);
+  filter->SetInput1(input1);
+  filter->SetInput2(input2);
+
+  typedef itk::StreamingImageFilter<PowerSumsImageType, PowerSumsImageType> StreamerType;
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(5);
+  streamer->Update();
+
+  return MaximumDifference(reference->GetOutput(), streamer->GetOutput());
+}
+
+/** Squares of 24 pixels alternating between low and high means, with a
+ * gaussian noise, rounded to integers as 16 bits data or not */
+PowerSumsImageType::Pointer ContrastImage(itk::Statistics::MersenneTwisterRandomVariateGenerator* generator, double lowMean, double highMean, bool integer)
+{
+  PowerSumsImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 200);
+  region.SetSize(1, 150);
+
+  PowerSumsImageType::Pointer image = PowerSumsImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<PowerSumsImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const bool   high  = (it.GetIndex()[0] / 24 + it.GetIndex()[1] / 24) % 2 == 1;
+    const double value = (high ? highMean : lowMean) + 20. * generator->GetNormalVariate();
+    it.Set(integer ? std::floor(value + 0.5) : value);
+  }
+  return image;
+}
+}
+
+int otbBinaryFunctorPowerSumsImageFilter(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::ImageFileReader<PowerSumsImageType>           ReaderType;
+  typedef itk::ConstNeighborhoodIterator<PowerSumsImageType> NeighborhoodType;
+  typedef PowerSumsImageType                                 ImageType;
+  typedef PowerSumsVectorImageType                           VectorImageType;
+
+  typedef otb::Functor::MeanDifference<NeighborhoodType, NeighborhoodType, double>                                  MeanDifferenceFunctorType;
+  typedef otb::Functor::KullbackLeiblerDistance<NeighborhoodType, NeighborhoodType, double>                         DistanceFunctorType;
+  typedef otb::Functor::KullbackLeiblerProfile<NeighborhoodType, NeighborhoodType, itk::VariableLengthVector<double>> ProfileFunctorType;
+
+  typedef otb::MeanDifferenceImageFilter<ImageType, ImageType, ImageType>                                           MeanDifferenceFilterType;
+  typedef otb::BinaryFunctorNeighborhoodImageFilter<ImageType, ImageType, ImageType, MeanDifferenceFunctorType>     MeanDifferenceReferenceType;
+  typedef otb::KullbackLeiblerDistanceImageFilter<ImageType, ImageType, ImageType>                                  DistanceFilterType;
+  typedef otb::BinaryFunctorNeighborhoodImageFilter<ImageType, ImageType, ImageType, DistanceFunctorType>           DistanceReferenceType;
+  typedef otb::KullbackLeiblerProfileImageFilter<ImageType, ImageType, VectorImageType>                             ProfileFilterType;
+  typedef otb::BinaryFunctorNeighborhoodVectorImageFilter<ImageType, ImageType, VectorImageType, ProfileFunctorType> ProfileReferenceType;
+
+  const unsigned int radius    = atoi(argv[3]);
+  const unsigned int radiusMin = atoi(argv[4]);
+  const unsigned int radiusMax = atoi(argv[5]);
+
+  ReaderType::Pointer reader1 = ReaderType::New();
+  reader1->SetFileName(argv[1]);
+  reader1->Update();
+
+  ReaderType::Pointer reader2 = ReaderType::New();
+  reader2->SetFileName(argv[2]);
+  reader2->Update();
+
+  const double meanDifferenceError =
+      CompareScalarFilters<MeanDifferenceFilterType, MeanDifferenceReferenceType>(reader1->GetOutput(), reader2->GetOutput(), radius);
+  std::cout << "Maximum relative difference of the mean differences: " << meanDifferenceError << std::endl;
+
+  const double distanceError = CompareScalarFilters<DistanceFilterType, DistanceReferenceType>(reader1->GetOutput(), reader2->GetOutput(), radius);
+  std::cout << "Maximum relative difference of the Kullback-Leibler distances: " << distanceError << std::endl;
+
+  // Both profile filters process the whole image, since the neighborhoods
+  // of the reference are not padded
+  ProfileReferenceType::Pointer profileReference = ProfileReferenceType::New();
+  profileReference->SetRadius(radiusMin, radiusMax);
+  profileReference->SetInput1(reader1->GetOutput());
+  profileReference->SetInput2(reader2->GetOutput());
+  profileReference->Update();
+
+  ProfileFilterType::Pointer profile = ProfileFilterType::New();
+  profile->SetRadius(radiusMin, radiusMax);
+  profile->SetInput1(reader1->GetOutput());
+  profile->SetInput2(reader2->GetOutput());
+  profile->Update();
+
+  const double profileError = MaximumDifference(profileReference->GetOutput(), profile->GetOutput());
+  std::cout << "Maximum relative difference of the Kullback-Leibler profiles: " << profileError << std::endl;
+
+  return (meanDifferenceError < 1e-9 && distanceError < 1e-9 && profileError < 1e-9) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int otbBinaryFunctorPowerSumsImageFilterContrast(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef itk::ConstNeighborhoodIterator<PowerSumsImageType> NeighborhoodType;
+  typedef PowerSumsImageType                                 ImageType;
+
+  typedef otb::Functor::MeanDifference<NeighborhoodType, NeighborhoodType, double>          MeanDifferenceFunctorType;
+  typedef otb::Functor::KullbackLeiblerDistance<NeighborhoodType, NeighborhoodType, double> DistanceFunctorType;
+
+  typedef otb::MeanDifferenceImageFilter<ImageType, ImageType, ImageType>                                       MeanDifferenceFilterType;
+  typedef otb::BinaryFunctorNeighborhoodImageFilter<ImageType, ImageType, ImageType, MeanDifferenceFunctorType> MeanDifferenceReferenceType;
+  typedef otb::KullbackLeiblerDistanceImageFilter<ImageType, ImageType, ImageType>                              DistanceFilterType;
+  typedef otb::BinaryFunctorNeighborhoodImageFilter<ImageType, ImageType, ImageType, DistanceFunctorType>       DistanceReferenceType;
+
+  itk::Statistics::MersenneTwisterRandomVariateGenerator::Pointer generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(1);
+
+  // The windows inside the squares are far from the means of the blocks
+  // which straddle the edges, and their kurtosis is lost if the central
+  // sums are derived from sums around these means
+  bool success = true;
+  for (unsigned int integer = 0; integer < 2; ++integer)
+  {
+    ImageType::Pointer image1 = ContrastImage(generator, 200., 60000., integer == 1);
+    ImageType::Pointer image2 = ContrastImage(generator, 300., 50000., integer == 1);
+
+    const double meanDifferenceError = CompareScalarFilters<MeanDifferenceFilterType, MeanDifferenceReferenceType>(image1, image2, 5);
+    const double distanceError       = CompareScalarFilters<DistanceFilterType, DistanceReferenceType>(image1, image2, 5);
+    std::cout << (integer == 1 ? "Integer" : "Real") << " values: maximum relative difference of the mean differences " << meanDifferenceError
+              << ", of the Kullback-Leibler distances " << distanceError << std::endl;
+
+    success = success && meanDifferenceError < 1e-9 && distanceError < 1e-5;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
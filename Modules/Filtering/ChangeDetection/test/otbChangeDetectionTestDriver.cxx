@@ -25,6 +25,8 @@ void RegisterTests()
   REGISTER_TEST(otbJHMIChangeDetectionTest);
   REGISTER_TEST(otbMeanDiffChangeDetectionTest);
   REGISTER_TEST(otbMultivariateAlterationDetectorImageFilter);
+  REGISTER_TEST(otbMultivariateAlterationDetectorImageFilterSamples);
+  REGISTER_TEST(otbMultivariateAlterationDetectorImageFilterIRMADWeights);
   REGISTER_TEST(otbCBAMIChangeDetectionTest);
   REGISTER_TEST(otbKullbackLeiblerSupervizedDistanceImageFilter);
   REGISTER_TEST(otbCorrelChangeDetectionTest);
@@ -32,4 +34,6 @@ void RegisterTests()
   REGISTER_TEST(otbKullbackLeiblerDistanceImageFilter);
   REGISTER_TEST(otbMeanRatioChangeDetectionTest);
   REGISTER_TEST(otbLHMIChangeDetectionTest);
+  REGISTER_TEST(otbBinaryFunctorPowerSumsImageFilter);
+  REGISTER_TEST(otbBinaryFunctorPowerSumsImageFilterContrast);
 }
@@ -18,11 +18,17 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "otbVectorImage.h"
 #include "otbImageFileReader.h"
 #include "otbImageFileWriter.h"
 #include "otbMultivariateAlterationDetectorImageFilter.h"
 
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
 typedef otb::VectorImage<unsigned short, 2> ImageType;
 typedef otb::VectorImage<double, 2>         OutputImageType;
 typedef otb::ImageFileReader<ImageType>       ReaderType;
@@ -62,3 +68,153 @@ int otbMultivariateAlterationDetectorImageFilter(int itkNotUsed(argc), char* arg
 
   return EXIT_SUCCESS;
 }
+
+int otbMultivariateAlterationDetectorImageFilterSamples(int itkNotUsed(argc), char* argv[])
+{
+  char* infname1 = argv[1];
+  char* infname2 = argv[2];
+  char* outfname = argv[3];
+
+  ReaderType::Pointer reader1 = ReaderType::New();
+  reader1->SetFileName(infname1);
+  reader1->UpdateOutputInformation();
+
+  ReaderType::Pointer reader2 = ReaderType::New();
+  reader2->SetFileName(infname2);
+
+  // Statistics on every pixel, with a streaming pass
+  MADFilterType::Pointer reference = MADFilterType::New();
+  reference->SetInput1(reader1->GetOutput());
+  reference->SetInput2(reader2->GetOutput());
+  reference->UpdateOutputInformation();
+
+  // Statistics on a cached subsample holding every pixel
+  MADFilterType::Pointer sampled = MADFilterType::New();
+  sampled->SetInput1(reader1->GetOutput());
+  sampled->SetInput2(reader2->GetOutput());
+  sampled->SetNumberOfSamples(reader1->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels());
+  sampled->UpdateOutputInformation();
+
+  const double errV1  = (reference->GetV1() - sampled->GetV1()).absolute_value_max();
+  const double errV2  = (reference->GetV2() - sampled->GetV2()).absolute_value_max();
+  const double errRho = (reference->GetRho() - sampled->GetRho()).inf_norm();
+  std::cout << "Maximum differences with the streaming statistics: V1 " << errV1 << ", V2 " << errV2 << ", Rho " << errRho << std::endl;
+
+  bool ok = errV1 < 1e-6 && errV2 < 1e-6 && errRho < 1e-6;
+
+  // IR-MAD on a subsample, with the default seed of the application
+  MADFilterType::Pointer irmad = MADFilterType::New();
+  irmad->SetInput1(reader1->GetOutput());
+  irmad->SetInput2(reader2->GetOutput());
+  irmad->SetNumberOfSamples(10000);
+  irmad->SetSeed(0);
+  irmad->SetMaximumNumberOfIterations(10);
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(irmad->GetOutput());
+  writer->SetFileName(outfname);
+  writer->Update();
+
+  std::cout << "IR-MAD iterations: " << irmad->GetNumberOfIterations() << std::endl;
+  std::cout << "IR-MAD Rho: " << std::endl;
+  std::cout << irmad->GetRho() << std::endl;
+
+  ok = ok && irmad->GetNumberOfIterations() >= 1 && irmad->GetNumberOfIterations() <= 10;
+  for (unsigned int i = 0; i < irmad->GetRho().size(); ++i)
+  {
+    ok = ok && std::isfinite(irmad->GetRho()[i]);
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int otbMultivariateAlterationDetectorImageFilterIRMADWeights(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+  // Synthetic images of 4 bands: the second image is the first one plus a
+  // small noise, except on the 20 first columns where it is independent
+  const unsigned int nbBands     = 4;
+  const unsigned int changedSize = 20;
+
+  ImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 100);
+  region.SetSize(1, 100);
+
+  ImageType::Pointer image1 = ImageType::New();
+  image1->SetRegions(region);
+  image1->SetNumberOfComponentsPerPixel(nbBands);
+  image1->Allocate();
+
+  ImageType::Pointer image2 = ImageType::New();
+  image2->SetRegions(region);
+  image2->SetNumberOfComponentsPerPixel(nbBands);
+  image2->Allocate();
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it1(image1, region);
+  itk::ImageRegionIterator<ImageType>          it2(image2, region);
+  for (it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    const bool           changed = static_cast<unsigned int>(it1.GetIndex()[0]) < changedSize;
+    ImageType::PixelType pixel1(nbBands), pixel2(nbBands);
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      const double value1 = std::floor(1000. + 100. * generator->GetNormalVariate() + 0.5);
+      const double value2 = changed ? 1000. + 100. * generator->GetNormalVariate() : value1 + 5. * generator->GetNormalVariate();
+      pixel1[b]           = static_cast<unsigned short>(value1);
+      pixel2[b]           = static_cast<unsigned short>(std::floor(value2 + 0.5));
+    }
+    it1.Set(pixel1);
+    it2.Set(pixel2);
+  }
+
+  // Plain MAD, on every pixel
+  MADFilterType::Pointer mad = MADFilterType::New();
+  mad->SetInput1(image1);
+  mad->SetInput2(image2);
+  mad->SetNumberOfSamples(region.GetNumberOfPixels());
+  mad->UpdateOutputInformation();
+
+  MADFilterType::Pointer irmad = MADFilterType::New();
+  irmad->SetInput1(image1);
+  irmad->SetInput2(image2);
+  irmad->SetNumberOfSamples(region.GetNumberOfPixels());
+  irmad->SetMaximumNumberOfIterations(50);
+  irmad->UpdateOutputInformation();
+
+  std::cout << "MAD Rho: " << mad->GetRho() << std::endl;
+  std::cout << "IR-MAD Rho: " << irmad->GetRho() << " after " << irmad->GetNumberOfIterations() << " iterations" << std::endl;
+
+  // The changed pixels lower the correlations of the MAD, while IR-MAD
+  // discards them and finds the correlation of the noisy copy (above 0.998)
+  bool ok = irmad->GetNumberOfIterations() < 50 && mad->GetRho().max_value() < 0.9 && irmad->GetRho().min_value() > 0.998;
+
+  // The weights of the unchanged pixels are the p-values of a chi-square
+  // variable, about uniform, and those of the changed pixels vanish: about
+  // a fifth of the weights are null and the mean weight is about 0.8 * 0.5
+  // (0.375 with the bias of the weighted variances). A wrong scaling of the
+  // chi-square variable moves the mean weight away: it falls to 0.1 when the
+  // variable is doubled, and rises to 0.6 when it is halved.
+  const std::vector<double>& weights = irmad->GetSampleWeights();
+  ok = ok && weights.size() == region.GetNumberOfPixels();
+
+  double        meanWeight  = 0.;
+  unsigned long nullWeights = 0;
+  for (std::vector<double>::const_iterator it = weights.begin(); it != weights.end(); ++it)
+  {
+    meanWeight += *it;
+    nullWeights += *it < 1e-3 ? 1 : 0;
+  }
+  meanWeight /= weights.size();
+  const double nullFraction = static_cast<double>(nullWeights) / weights.size();
+  std::cout << "Mean weight: " << meanWeight << ", fraction of null weights: " << nullFraction << std::endl;
+
+  ok = ok && meanWeight > 0.33 && meanWeight < 0.42 && nullFraction > 0.19 && nullFraction < 0.22;
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
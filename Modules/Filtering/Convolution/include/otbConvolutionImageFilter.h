@@ -27,6 +27,9 @@
 #include "itkArray.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
 
+#include <type_traits>
+#include <vector>
+
 namespace otb
 {
 /** \class ConvolutionImageFilter
@@ -45,6 +48,15 @@ namespace otb
  * This filter allows the user to choose the boundary conditions in the template parameters.
  Default boundary conditions are zero flux Neumann boundary conditions.
  *
+ * Kernels of low rank, such as the separable box or gaussian kernels, are
+ * detected with a singular value decomposition of the kernel: when the
+ * decomposition has few enough terms, each of them is applied as a horizontal
+ * and a vertical 1-D pass, which costs rank * (width + height) operations per
+ * pixel instead of width * height. The terms whose singular value is below
+ * SeparableTolerance times the largest one are neglected. This fast path is
+ * used for scalar pixels only, and can be disabled with
+ * UseSeparableConvolutionOff().
+ *
  * An optimized version of this filter using FFTW is available in the Orfeo ToolBox and
  * will significantly improves performances especially for large kernels
  * (see OverlapSaveConvolutionImageFilter).
@@ -142,6 +154,21 @@ public:
   itkGetMacro(NormalizeFilter, bool);
   itkBooleanMacro(NormalizeFilter);
 
+  /** Set/Get whether low-rank kernels are applied as successive 1-D passes
+   * (default is true) */
+  itkSetMacro(UseSeparableConvolution, bool);
+  itkGetConstMacro(UseSeparableConvolution, bool);
+  itkBooleanMacro(UseSeparableConvolution);
+
+  /** Set/Get the singular value, relative to the largest one, below which a
+   * term of the kernel decomposition is neglected (default is 1e-10) */
+  itkSetMacro(SeparableTolerance, double);
+  itkGetConstMacro(SeparableTolerance, double);
+
+  /** Number of pairs of 1-D passes used by the last update, 0 if the kernel
+   * was applied in a single 2-D pass */
+  itkGetConstMacro(KernelRank, unsigned int);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(InputHasNumericTraitsCheck, (itk::Concept::HasNumericTraits<InputPixelType>));
@@ -167,6 +194,18 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
 
+  /** Decompose the kernel and choose between the 1-D and 2-D passes */
+  void BeforeThreadedGenerateData() override;
+
+  /** Whether the pixels can be processed by the 1-D passes */
+  typedef std::integral_constant<bool, std::is_arithmetic<InputPixelType>::value && std::is_arithmetic<OutputPixelType>::value> IsScalarPixelType;
+
+  /** Successive 1-D passes on a padded block of the input */
+  void ThreadedSeparableGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId, std::true_type);
+  void ThreadedSeparableGenerateData(const OutputImageRegionType&, itk::ThreadIdType, std::false_type)
+  {
+  }
+
   /** ConvolutionImageFilter needs a larger input requested region than
    * the output requested region.  As such, ConvolutionImageFilter needs
    * to provide an implementation for GenerateInputRequestedRegion()
@@ -185,6 +224,15 @@ private:
   ArrayType m_Filter;
   /** Flag for filter coefficients normalization */
   bool m_NormalizeFilter;
+
+  bool         m_UseSeparableConvolution;
+  double       m_SeparableTolerance;
+  unsigned int m_KernelRank;
+
+  /** Terms of the kernel decomposition: the kernel is the sum over the terms
+   * of the outer product of their vertical and horizontal 1-D kernels */
+  std::vector<double> m_VerticalKernels;
+  std::vector<double> m_HorizontalKernels;
 };
 
 } // end namespace itk
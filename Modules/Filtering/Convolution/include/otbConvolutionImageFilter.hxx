@@ -22,14 +22,20 @@
 #define otbConvolutionImageFilter_hxx
 #include "otbConvolutionImageFilter.h"
 
+#include <algorithm>
+
 #include "itkConstNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
 #include "itkConstantBoundaryCondition.h"
 
 #include "otbMacro.h"
 
+#include "vnl/algo/vnl_svd.h"
+
 
 namespace otb
 {
@@ -40,7 +46,10 @@ ConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFilterPre
   m_Radius.Fill(1);
   m_Filter.SetSize(3 * 3);
   m_Filter.Fill(1);
-  m_NormalizeFilter = false;
+  m_NormalizeFilter         = false;
+  m_UseSeparableConvolution = true;
+  m_SeparableTolerance      = 1e-10;
+  m_KernelRank              = 0;
 }
 
 template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFilterPrecision>
@@ -91,10 +100,208 @@ void ConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFilt
   }
 }
 
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFilterPrecision>
+void ConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFilterPrecision>::BeforeThreadedGenerateData()
+{
+  m_KernelRank = 0;
+  m_VerticalKernels.clear();
+  m_HorizontalKernels.clear();
+
+  if (!m_UseSeparableConvolution || !IsScalarPixelType::value)
+  {
+    return;
+  }
+
+  const unsigned int width  = 2 * m_Radius[0] + 1;
+  const unsigned int height = 2 * m_Radius[1] + 1;
+
+  // Decompose the kernel, or its transpose, so that the decomposed matrix has
+  // at least as many rows as columns
+  const bool         transpose = height < width;
+  vnl_matrix<double> kernel(transpose ? width : height, transpose ? height : width);
+  for (unsigned int j = 0; j < height; ++j)
+  {
+    for (unsigned int i = 0; i < width; ++i)
+    {
+      const double value = static_cast<double>(m_Filter(j * width + i));
+      if (transpose)
+      {
+        kernel(i, j) = value;
+      }
+      else
+      {
+        kernel(j, i) = value;
+      }
+    }
+  }
+  vnl_svd<double> svd(kernel);
+
+  const unsigned int nbTerms = std::min(width, height);
+  unsigned int       rank    = 0;
+  while (rank < nbTerms && svd.W(rank) > m_SeparableTolerance * svd.W(0))
+  {
+    ++rank;
+  }
+
+  // Each term costs a horizontal and a vertical pass
+  if (rank == 0 || rank * (width + height) >= width * height)
+  {
+    otbMsgDevMacro(<< "Kernel of rank " << rank << " applied in a single 2-D pass");
+    return;
+  }
+
+  const vnl_matrix<double>& columns = transpose ? svd.V() : svd.U();
+  const vnl_matrix<double>& rows    = transpose ? svd.U() : svd.V();
+  m_VerticalKernels.resize(rank * height);
+  m_HorizontalKernels.resize(rank * width);
+  for (unsigned int t = 0; t < rank; ++t)
+  {
+    for (unsigned int j = 0; j < height; ++j)
+    {
+      m_VerticalKernels[t * height + j] = svd.W(t) * columns(j, t);
+    }
+    for (unsigned int i = 0; i < width; ++i)
+    {
+      m_HorizontalKernels[t * width + i] = rows(i, t);
+    }
+  }
+  m_KernelRank = rank;
+  otbMsgDevMacro(<< "Kernel of rank " << rank << " applied in separable 1-D passes");
+}
+
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFilterPrecision>
+void ConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFilterPrecision>::ThreadedSeparableGenerateData(
+    const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId, std::true_type)
+{
+  typename OutputImageType::Pointer     output = this->GetOutput();
+  typename InputImageType::ConstPointer input  = this->GetInput();
+
+  // support progress methods/callbacks, one output line at a time
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetSize()[1]);
+
+  const unsigned long kernelWidth  = 2 * m_Radius[0] + 1;
+  const unsigned long kernelHeight = 2 * m_Radius[1] + 1;
+  const unsigned long outputWidth  = outputRegionForThread.GetSize()[0];
+  const unsigned long outputHeight = outputRegionForThread.GetSize()[1];
+  const unsigned long blockWidth   = outputWidth + kernelWidth - 1;
+  const unsigned long blockHeight  = outputHeight + kernelHeight - 1;
+
+  // Padded block of the input, where the pixels out of the buffered region
+  // come from the boundary condition, as for the neighborhood iterator
+  InputImageRegionType blockRegion;
+  this->CallCopyOutputRegionToInputRegion(blockRegion, outputRegionForThread);
+  blockRegion.PadByRadius(m_Radius);
+  const typename InputImageType::IndexType blockIndex = blockRegion.GetIndex();
+
+  std::vector<double>  block(blockWidth * blockHeight);
+  InputImageRegionType insideRegion = blockRegion;
+  const bool           hasInside    = insideRegion.Crop(input->GetBufferedRegion());
+  if (!hasInside || insideRegion != blockRegion)
+  {
+    BoundaryConditionType              boundaryCondition;
+    typename InputImageType::IndexType index;
+    for (unsigned long y = 0; y < blockHeight; ++y)
+    {
+      index[1] = blockIndex[1] + y;
+      for (unsigned long x = 0; x < blockWidth; ++x)
+      {
+        index[0] = blockIndex[0] + x;
+        if (!hasInside || !insideRegion.IsInside(index))
+        {
+          block[y * blockWidth + x] = static_cast<double>(boundaryCondition.GetPixel(index, input.GetPointer()));
+        }
+      }
+    }
+  }
+  if (hasInside)
+  {
+    itk::ImageScanlineConstIterator<InputImageType> inputIt(input, insideRegion);
+    double* line = &block[(insideRegion.GetIndex()[1] - blockIndex[1]) * blockWidth + insideRegion.GetIndex()[0] - blockIndex[0]];
+    for (inputIt.GoToBegin(); !inputIt.IsAtEnd(); inputIt.NextLine(), line += blockWidth)
+    {
+      double* pixel = line;
+      for (; !inputIt.IsAtEndOfLine(); ++inputIt, ++pixel)
+      {
+        *pixel = static_cast<double>(inputIt.Get());
+      }
+    }
+  }
+
+  // The loops on x are contiguous so that the compiler can vectorize them
+  std::vector<double> rows(blockHeight * outputWidth);
+  std::vector<double> result(outputHeight * outputWidth, 0.);
+  for (unsigned int t = 0; t < m_KernelRank; ++t)
+  {
+    const double* horizontal = &m_HorizontalKernels[t * kernelWidth];
+    const double* vertical   = &m_VerticalKernels[t * kernelHeight];
+
+    // Horizontal pass on all the lines of the block
+    std::fill(rows.begin(), rows.end(), 0.);
+    for (unsigned long y = 0; y < blockHeight; ++y)
+    {
+      const double* in  = &block[y * blockWidth];
+      double*       out = &rows[y * outputWidth];
+      for (unsigned long i = 0; i < kernelWidth; ++i)
+      {
+        const double  coef = horizontal[i];
+        const double* src  = in + i;
+        for (unsigned long x = 0; x < outputWidth; ++x)
+        {
+          out[x] += coef * src[x];
+        }
+      }
+    }
+
+    // Vertical pass, accumulated over the terms
+    for (unsigned long y = 0; y < outputHeight; ++y)
+    {
+      double* out = &result[y * outputWidth];
+      for (unsigned long j = 0; j < kernelHeight; ++j)
+      {
+        const double  coef = vertical[j];
+        const double* src  = &rows[(y + j) * outputWidth];
+        for (unsigned long x = 0; x < outputWidth; ++x)
+        {
+          out[x] += coef * src[x];
+        }
+      }
+    }
+  }
+
+  double scale = 1.;
+  if (m_NormalizeFilter)
+  {
+    double norm = 0.;
+    for (unsigned int i = 0; i < m_Filter.Size(); ++i)
+    {
+      norm += std::abs(static_cast<double>(m_Filter(i)));
+    }
+    scale = 1. / norm;
+  }
+
+  itk::ImageScanlineIterator<OutputImageType> outputIt(output, outputRegionForThread);
+  const double*                               line = &result[0];
+  for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); outputIt.NextLine(), line += outputWidth)
+  {
+    const double* value = line;
+    for (; !outputIt.IsAtEndOfLine(); ++outputIt, ++value)
+    {
+      outputIt.Set(static_cast<OutputPixelType>(*value * scale));
+    }
+    progress.CompletedPixel();
+  }
+}
+
 template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFilterPrecision>
 void ConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFilterPrecision>::ThreadedGenerateData(
     const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId)
 {
+  if (m_KernelRank > 0)
+  {
+    this->ThreadedSeparableGenerateData(outputRegionForThread, threadId, IsScalarPixelType());
+    return;
+  }
+
   // Allocate output
   typename OutputImageType::Pointer     output = this->GetOutput();
   typename InputImageType::ConstPointer input  = this->GetInput();
@@ -169,6 +376,9 @@ void ConvolutionImageFilter<TInputImage, TOutput, TBoundaryCondition, TFilterPre
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "Radius: " << m_Radius << '\n';
+  os << indent << "UseSeparableConvolution: " << m_UseSeparableConvolution << '\n';
+  os << indent << "SeparableTolerance: " << m_SeparableTolerance << '\n';
+  os << indent << "KernelRank: " << m_KernelRank << '\n';
 }
 
 } // end namespace otb
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbFFTWConvolutionTraits_h
+#define otbFFTWConvolutionTraits_h
+
+#include <cstddef>
+
+#include "itkConfigure.h"
+#include "itkMacro.h"
+
+#if defined ITK_USE_FFTWD || defined ITK_USE_FFTWF
+#include "itkFFTWCommon.h"
+#endif
+
+namespace otb
+{
+/** \class FFTWConvolutionTraits
+ * \brief Selects the FFTW implementation (double or single precision) used by
+ * OverlapSaveConvolutionImageFilter.
+ *
+ * The specializations wrap itk::fftw::Proxy and the matching FFTW allocator.
+ * They only exist when ITK has been built with the corresponding FFTW library
+ * (ITK_USE_FFTWD for double, ITK_USE_FFTWF for float): the generic version
+ * reports that the precision is not available and throws if used.
+ *
+ * \ingroup OTBConvolution
+ */
+template <class TPrecision>
+class FFTWConvolutionTraits
+{
+public:
+  typedef TPrecision PixelType;
+  typedef TPrecision ComplexType[2];
+  typedef void*      PlanType;
+
+  static bool IsAvailable()
+  {
+    return false;
+  }
+
+  static void* Malloc(std::size_t)
+  {
+    itkGenericExceptionMacro(<< "No FFTW library is available for this precision");
+  }
+  static void Free(void*)
+  {
+  }
+  static PlanType PlanForward(int, int, PixelType*, ComplexType*, int)
+  {
+    itkGenericExceptionMacro(<< "No FFTW library is available for this precision");
+  }
+  static PlanType PlanBackward(int, int, ComplexType*, PixelType*, int)
+  {
+    itkGenericExceptionMacro(<< "No FFTW library is available for this precision");
+  }
+  static void Execute(PlanType)
+  {
+  }
+  static void ExecuteForward(PlanType, PixelType*, ComplexType*)
+  {
+  }
+  static void ExecuteBackward(PlanType, ComplexType*, PixelType*)
+  {
+  }
+  static void DestroyPlan(PlanType)
+  {
+  }
+};
+
+#if defined ITK_USE_FFTWD
+template <>
+class FFTWConvolutionTraits<double>
+{
+public:
+  typedef itk::fftw::Proxy<double> ProxyType;
+  typedef ProxyType::PixelType     PixelType;
+  typedef ProxyType::ComplexType   ComplexType;
+  typedef ProxyType::PlanType      PlanType;
+
+  static bool IsAvailable()
+  {
+    return true;
+  }
+
+  static void* Malloc(std::size_t size)
+  {
+    return fftw_malloc(size);
+  }
+  static void Free(void* buffer)
+  {
+    fftw_free(buffer);
+  }
+  /** Real to complex transform of a nx * ny (row major, ny rows) array */
+  static PlanType PlanForward(int nx, int ny, PixelType* in, ComplexType* out, int threads)
+  {
+    return ProxyType::Plan_dft_r2c_2d(ny, nx, in, out, FFTW_MEASURE, threads);
+  }
+  /** Complex to real transform, which may overwrite its input */
+  static PlanType PlanBackward(int nx, int ny, ComplexType* in, PixelType* out, int threads)
+  {
+    return ProxyType::Plan_dft_c2r_2d(ny, nx, in, out, FFTW_MEASURE, threads, true);
+  }
+  static void Execute(PlanType plan)
+  {
+    ProxyType::Execute(plan);
+  }
+  /** Execute a forward plan on other buffers allocated with Malloc() */
+  static void ExecuteForward(PlanType plan, PixelType* in, ComplexType* out)
+  {
+    fftw_execute_dft_r2c(plan, in, out);
+  }
+  /** Execute a backward plan on other buffers allocated with Malloc() */
+  static void ExecuteBackward(PlanType plan, ComplexType* in, PixelType* out)
+  {
+    fftw_execute_dft_c2r(plan, in, out);
+  }
+  static void DestroyPlan(PlanType plan)
+  {
+    ProxyType::DestroyPlan(plan);
+  }
+};
+#endif
+
+#if defined ITK_USE_FFTWF
+template <>
+class FFTWConvolutionTraits<float>
+{
+public:
+  typedef itk::fftw::Proxy<float> ProxyType;
+  typedef ProxyType::PixelType    PixelType;
+  typedef ProxyType::ComplexType  ComplexType;
+  typedef ProxyType::PlanType     PlanType;
+
+  static bool IsAvailable()
+  {
+    return true;
+  }
+
+  static void* Malloc(std::size_t size)
+  {
+    return fftwf_malloc(size);
+  }
+  static void Free(void* buffer)
+  {
+    fftwf_free(buffer);
+  }
+  /** Real to complex transform of a nx * ny (row major, ny rows) array */
+  static PlanType PlanForward(int nx, int ny, PixelType* in, ComplexType* out, int threads)
+  {
+    return ProxyType::Plan_dft_r2c_2d(ny, nx, in, out, FFTW_MEASURE, threads);
+  }
+  /** Complex to real transform, which may overwrite its input */
+  static PlanType PlanBackward(int nx, int ny, ComplexType* in, PixelType* out, int threads)
+  {
+    return ProxyType::Plan_dft_c2r_2d(ny, nx, in, out, FFTW_MEASURE, threads, true);
+  }
+  static void Execute(PlanType plan)
+  {
+    ProxyType::Execute(plan);
+  }
+  /** Execute a forward plan on other buffers allocated with Malloc() */
+  static void ExecuteForward(PlanType plan, PixelType* in, ComplexType* out)
+  {
+    fftwf_execute_dft_r2c(plan, in, out);
+  }
+  /** Execute a backward plan on other buffers allocated with Malloc() */
+  static void ExecuteBackward(PlanType plan, ComplexType* in, PixelType* out)
+  {
+    fftwf_execute_dft_c2r(plan, in, out);
+  }
+  static void DestroyPlan(PlanType plan)
+  {
+    ProxyType::DestroyPlan(plan);
+  }
+};
+#endif
+
+} // end namespace otb
+
+#endif
@@ -26,6 +26,11 @@
 #include "itkNumericTraits.h"
 #include "itkArray.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "otbFFTWConvolutionTraits.h"
+#include "otbParallelForRange.h"
+
+#include <memory>
+#include <vector>
 
 namespace otb
 {
@@ -39,16 +44,30 @@ namespace otb
  * product in the Fourrier domain. This result in tremendous speed gain when using large kernel
  * with exactly the same result as the classical convolution filter.
  *
- * \note This filter could be threaded but requires additional design due to limited thread-safety
- * of the FFTW library.
+ * Each requested region is processed as a single piece, padded up to a size
+ * that FFTW transforms efficiently. The FFTW plans are kept in a cache keyed
+ * by the padded size, so that the streaming divisions of the same size do not
+ * plan again: the plans, created with FFTW_MEASURE, are built once. The
+ * buffers of a piece are only allocated while it is processed. Pieces of at
+ * least MinimumNumberOfPixelsForThreadedFFT pixels are transformed with the
+ * FFTW threads (NumberOfThreads of the filter).
+ *
+ * Small kernels are faster to apply in the spatial domain: kernels of at most
+ * MaximumKernelSizeForSpatialConvolution coefficients are convolved directly,
+ * with the same zero boundary condition and no FFT. The default threshold
+ * (7x7 kernels) comes from timings of the FFTW double precision transforms
+ * against ConvolutionImageFilter.
+ *
+ * The transforms are computed with the TFFTPrecision type, which can be
+ * double (ITK_USE_FFTWD) or float (ITK_USE_FFTWF).
  *
  * \note For the moment only constant zero boundary conditions are used in this filter. This could produce
  *  very different results from the classical convolution filter with zero flux neumann boundary condition,
  * especially with large kernels.
  *
- * \note ITK must be set to use FFTW (double implementation) for this filter to work properly. If not, exception
+ * \note ITK must be set to use FFTW for the TFFTPrecision type for this filter to work properly. If not, exception
  *  will be raised at filter creation.
- *  Install fftw and set the cmake variable ITK_USE_FFTWD to ON.
+ *  Install fftw and set the cmake variable ITK_USE_FFTWD (or ITK_USE_FFTWF for float) to ON.
  *
  * \sa ConvolutionImageFilter
  *
@@ -58,7 +77,7 @@ namespace otb
  *
  * \ingroup OTBConvolution
  */
-template <class TInputImage, class TOutputImage, class TBoundaryCondition = itk::ZeroFluxNeumannBoundaryCondition<TInputImage>>
+template <class TInputImage, class TOutputImage, class TBoundaryCondition = itk::ZeroFluxNeumannBoundaryCondition<TInputImage>, class TFFTPrecision = double>
 class ITK_EXPORT OverlapSaveConvolutionImageFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
 {
 public:
@@ -91,6 +110,8 @@ public:
   typedef typename InputImageType::SizeType                     InputSizeType;
   typedef typename itk::Array<InputRealType>                    ArrayType;
   typedef TBoundaryCondition                                    BoundaryConditionType;
+  typedef TFFTPrecision                                         FFTPrecisionType;
+  typedef FFTWConvolutionTraits<FFTPrecisionType>               FFTWTraitsType;
 
   /** Set the radius of the neighborhood used to compute the mean. */
   virtual void SetRadius(const InputSizeType rad)
@@ -134,6 +155,38 @@ public:
   itkGetMacro(NormalizeFilter, bool);
   itkBooleanMacro(NormalizeFilter);
 
+  /** Set/Get the number of padded piece sizes whose plans are kept between
+   * two streaming divisions (default is 4) */
+  itkSetMacro(MaximumNumberOfCachedPlans, unsigned int);
+  itkGetConstMacro(MaximumNumberOfCachedPlans, unsigned int);
+
+  /** Set/Get the number of pixels of a padded piece from which the FFT is
+   * computed with several threads (default is 65536) */
+  itkSetMacro(MinimumNumberOfPixelsForThreadedFFT, unsigned long);
+  itkGetConstMacro(MinimumNumberOfPixelsForThreadedFFT, unsigned long);
+
+  /** Set/Get the largest number of kernel coefficients for which the
+   * convolution is computed in the spatial domain (default is 49). 0 always
+   * uses the FFT. */
+  itkSetMacro(MaximumKernelSizeForSpatialConvolution, unsigned long);
+  itkGetConstMacro(MaximumKernelSizeForSpatialConvolution, unsigned long);
+
+  /** Number of plans currently in the cache */
+  unsigned int GetNumberOfCachedPlans() const
+  {
+    return static_cast<unsigned int>(m_PlanCache.size());
+  }
+
+  /** Release the plans kept in the cache */
+  void ClearPlanCache()
+  {
+    m_PlanCache.clear();
+  }
+
+  /** Smallest size greater or equal to n with no prime factor greater than 7,
+   * for which FFTW is efficient */
+  static unsigned long GetEfficientFFTSize(unsigned long n);
+
   /** Since this filter implements a neighborhood operation, it requests a largest input
    * region than the output region.
    */
@@ -152,13 +205,69 @@ protected:
   ~OverlapSaveConvolutionImageFilter() override
   {
   }
+
+  typedef typename FFTWTraitsType::PixelType   FFTPixelType;
+  typedef typename FFTWTraitsType::ComplexType FFTComplexType;
+  typedef typename FFTWTraitsType::PlanType    FFTPlanType;
+
+  /** Transforms for a given padded piece size */
+  class PlanCacheEntry
+  {
+  public:
+    PlanCacheEntry(const InputSizeType& size, int nbThreads);
+    ~PlanCacheEntry();
+
+    PlanCacheEntry(const PlanCacheEntry&) = delete;
+    void operator=(const PlanCacheEntry&) = delete;
+
+    InputSizeType Size;
+    int           NumberOfThreads;
+    unsigned long SpectrumSize;
+    FFTPlanType   ForwardPlan;
+    FFTPlanType   BackwardPlan;
+  };
+
+  /** Buffer allocated with the FFTW allocator, which gives the alignment the
+   * plans were created with */
+  template <class T>
+  class FFTWBuffer
+  {
+  public:
+    explicit FFTWBuffer(unsigned long size) : m_Data(static_cast<T*>(FFTWTraitsType::Malloc(size * sizeof(T))))
+    {
+    }
+    ~FFTWBuffer()
+    {
+      FFTWTraitsType::Free(m_Data);
+    }
+
+    FFTWBuffer(const FFTWBuffer&) = delete;
+    void operator=(const FFTWBuffer&) = delete;
+
+    T* Get() const
+    {
+      return m_Data;
+    }
+
+  private:
+    T* m_Data;
+  };
+
+  /** Get the cache entry for a padded size */
+  PlanCacheEntry* GetPlanCacheEntry(const InputSizeType& size, int nbThreads);
+
+  /** Factor applied to the kernel coefficients by the normalization */
+  double GetFilterScale() const;
+
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
-  /* TODO For the moment this class provide only a GenerateData(),
-   * due to limited thread-safety of FFTW plan creation.
-   */
+  /** The region is processed as a single piece: the threads are used inside
+   * the FFTW transforms, or split the rows of the spatial convolution */
   void GenerateData() override;
-  // void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId);
+
+  /** Convolution in the spatial domain of the zero padded piece, for the
+   * output rows [firstRow, endRow) of the requested region */
+  void ThreadedSpatialConvolution(const FFTPixelType* piece, unsigned long pieceWidth, double scale, std::size_t firstRow, std::size_t endRow);
 
 private:
   OverlapSaveConvolutionImageFilter(const Self&) = delete;
@@ -172,6 +281,13 @@ private:
 
   /** Flag for filter normalization */
   bool m_NormalizeFilter;
+
+  unsigned int  m_MaximumNumberOfCachedPlans;
+  unsigned long m_MinimumNumberOfPixelsForThreadedFFT;
+  unsigned long m_MaximumKernelSizeForSpatialConvolution;
+
+  /** Cached plans, the most recently used last */
+  std::vector<std::unique_ptr<PlanCacheEntry>> m_PlanCache;
 };
 } // end namespace otb
 
@@ -21,40 +21,38 @@
 #ifndef otbOverlapSaveConvolutionImageFilter_hxx
 #define otbOverlapSaveConvolutionImageFilter_hxx
 
-#include "itkConfigure.h"
-
 #include "otbOverlapSaveConvolutionImageFilter.h"
 
-#include "itkConstNeighborhoodIterator.h"
-#include "itkImageRegionIteratorWithIndex.h"
-#include "itkNeighborhoodAlgorithm.h"
-#include "itkOffset.h"
-#include "itkProgressReporter.h"
-
-// debug
-#include "itkImageRegionIterator.h"
-#include "otbMath.h"
+#include <algorithm>
+#include <vector>
 
-#ifdef ITK_USE_FFTWD
-#include "itkFFTWCommon.h"
-#endif
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
 
 namespace otb
 {
 
-template <class TInputImage, class TOutputImage, class TBoundaryCondition>
-OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition>::OverlapSaveConvolutionImageFilter()
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::OverlapSaveConvolutionImageFilter()
 {
   m_Radius.Fill(1);
   m_Filter.SetSize(3 * 3);
   m_Filter.Fill(1);
-  m_NormalizeFilter = false;
+  m_NormalizeFilter                        = false;
+  m_MaximumNumberOfCachedPlans             = 4;
+  m_MinimumNumberOfPixelsForThreadedFFT    = 65536;
+  m_MaximumKernelSizeForSpatialConvolution = 49;
 }
 
-template <class TInputImage, class TOutputImage, class TBoundaryCondition>
-void OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition>::GenerateInputRequestedRegion()
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+void OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::GenerateInputRequestedRegion()
 {
-#if defined ITK_USE_FFTWD
+  if (m_Filter.Size() > m_MaximumKernelSizeForSpatialConvolution && !FFTWTraitsType::IsAvailable())
+  {
+    itkGenericExceptionMacro(<< "The OverlapSaveConvolutionImageFilter can not operate without the FFTW library for the requested precision. Please build "
+                                "ITK with USE_FFTWD (double) or USE_FFTWF (float) set to ON, and rebuild OTB.");
+  }
+
   // call the superclass' implementation of this method
   Superclass::GenerateInputRequestedRegion();
 
@@ -96,202 +94,276 @@ void OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondi
     e.SetDataObject(inputPtr);
     throw e;
   }
-#else
-  itkGenericExceptionMacro(<< "The OverlapSaveConvolutionImageFilter can not operate without the FFTW library (double implementation). Please build ITK with "
-                              "USE_FFTD set to ON, and rebuild OTB.");
-#endif
 }
 
-template <class TInputImage, class TOutputImage, class TBoundaryCondition>
-void OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition>
-    /* TODO commented out since multi-threading is not supported for the moment
-     * ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) */
-    ::GenerateData()
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+unsigned long OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::GetEfficientFFTSize(unsigned long n)
 {
-#if defined ITK_USE_FFTWD
-  // Input/Output pointers
-  typename OutputImageType::Pointer     output = this->GetOutput();
-  typename InputImageType::ConstPointer input  = this->GetInput();
-
-  /* TODO: This is a patch to switch from GenerateData() to ThreadedGenerateData(). Remove these two lines
-  once multi-threading problem is solved */
-  this->AllocateOutputs();
-  OutputImageRegionType outputRegionForThread = output->GetRequestedRegion();
-
-  // Size of the filter
-  typename InputImageType::SizeType sizeOfFilter;
-  sizeOfFilter[0] = 2 * m_Radius[0] + 1;
-  sizeOfFilter[1] = 2 * m_Radius[1] + 1;
-
-  // Filter normalization
-  InputRealType norm;
-
-  // Compute the input region for the given thread
-  OutputImageRegionType inputRegionForThread = outputRegionForThread;
-  inputRegionForThread.PadByRadius(m_Radius);
-
-  // Compute the piece region for the input thread. Piece region is different
-  // from input region on boundaries
-  typename InputImageType::RegionType pieceRegion = inputRegionForThread;
-  typename InputImageType::SizeType   pieceSize   = pieceRegion.GetSize();
-  typename InputImageType::IndexType  pieceIndex  = pieceRegion.GetIndex();
-
-  // Compute the size of the FFT and the size of the piece
-  unsigned int pieceNbOfPixel = pieceRegion.GetNumberOfPixels();
-  unsigned int sizeFFT        = (pieceSize[0] / 2 + 1) * pieceSize[1];
+  static const unsigned long factors[] = {2, 3, 5, 7};
+  for (n = std::max(n, 1UL);; ++n)
+  {
+    unsigned long remainder = n;
+    for (unsigned long factor : factors)
+    {
+      while (remainder % factor == 0)
+      {
+        remainder /= factor;
+      }
+    }
+    if (remainder == 1)
+    {
+      return n;
+    }
+  }
+}
 
-  // Achieve the computation of the inputRegionForThread
-  inputRegionForThread.Crop(input->GetLargestPossibleRegion());
-  typename InputImageType::IndexType inputIndex = inputRegionForThread.GetIndex();
-  typename InputImageType::SizeType  inputSize  = inputRegionForThread.GetSize();
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::PlanCacheEntry::PlanCacheEntry(const InputSizeType& size,
+                                                                                                                              int nbThreads)
+  : Size(size), NumberOfThreads(nbThreads), SpectrumSize((size[0] / 2 + 1) * size[1])
+{
+  // FFTW_MEASURE overwrites the buffers: the plans are created on buffers of
+  // their own, and then executed on the ones of each piece
+  FFTWBuffer<FFTPixelType>   piece(size[0] * size[1]);
+  FFTWBuffer<FFTComplexType> spectrum(SpectrumSize);
+  ForwardPlan  = FFTWTraitsType::PlanForward(size[0], size[1], piece.Get(), spectrum.Get(), nbThreads);
+  BackwardPlan = FFTWTraitsType::PlanBackward(size[0], size[1], spectrum.Get(), piece.Get(), nbThreads);
+}
 
-  // Iterator of input image
-  itk::ConstNeighborhoodIterator<InputImageType, BoundaryConditionType> inputIt(m_Radius, input, inputRegionForThread);
-  inputIt.GoToBegin();
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::PlanCacheEntry::~PlanCacheEntry()
+{
+  FFTWTraitsType::DestroyPlan(ForwardPlan);
+  FFTWTraitsType::DestroyPlan(BackwardPlan);
+}
 
-  // Iterator of output image
-  itk::ImageRegionIteratorWithIndex<OutputImageType> outputIt;
-  outputIt = itk::ImageRegionIteratorWithIndex<OutputImageType>(output, outputRegionForThread);
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+typename OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::PlanCacheEntry*
+OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::GetPlanCacheEntry(const InputSizeType& size, int nbThreads)
+{
+  for (auto it = m_PlanCache.begin(); it != m_PlanCache.end(); ++it)
+  {
+    if ((*it)->Size == size && (*it)->NumberOfThreads == nbThreads)
+    {
+      // Keep the most recently used entry last
+      std::rotate(it, it + 1, m_PlanCache.end());
+      return m_PlanCache.back().get();
+    }
+  }
 
-  // variables for loops
-  unsigned int i, j, k, l;
+  // Drop the least recently used entries
+  while (!m_PlanCache.empty() && m_PlanCache.size() >= m_MaximumNumberOfCachedPlans)
+  {
+    m_PlanCache.erase(m_PlanCache.begin());
+  }
+  m_PlanCache.emplace_back(new PlanCacheEntry(size, nbThreads));
+  return m_PlanCache.back().get();
+}
 
-  // ITK proxy to the fftw library
-  typedef typename itk::fftw::Proxy<double> FFTWProxyType;
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+double OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::GetFilterScale() const
+{
+  if (!m_NormalizeFilter)
+  {
+    return 1.;
+  }
+  InputRealType norm = itk::NumericTraits<InputRealType>::Zero;
+  for (unsigned int i = 0; i < m_Filter.Size(); ++i)
+  {
+    norm += static_cast<InputRealType>(m_Filter(i));
+  }
+  return (norm == 0.0) ? 1.0 : 1 / static_cast<double>(norm);
+}
 
-  // memory allocation
-  InputPixelType* resampledFilterPiece;
-  resampledFilterPiece = static_cast<FFTWProxyType::PixelType*>(fftw_malloc(pieceNbOfPixel * sizeof(InputPixelType)));
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+void OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::GenerateData()
+{
+  // Input/Output pointers
+  typename OutputImageType::Pointer     output = this->GetOutput();
+  typename InputImageType::ConstPointer input  = this->GetInput();
 
-  FFTWProxyType::ComplexType* filterPieceFFT;
-  filterPieceFFT = static_cast<FFTWProxyType::ComplexType*>(fftw_malloc(sizeFFT * sizeof(FFTWProxyType::ComplexType)));
+  this->AllocateOutputs();
+  const OutputImageRegionType outputRegion = output->GetRequestedRegion();
 
-  InputPixelType* inputPiece;
-  inputPiece = static_cast<FFTWProxyType::PixelType*>(fftw_malloc(pieceNbOfPixel * sizeof(InputPixelType)));
+  // The piece is the output region padded by the radius
+  InputImageRegionType inputRegion = outputRegion;
+  inputRegion.PadByRadius(m_Radius);
+  const typename InputImageType::IndexType pieceIndex = inputRegion.GetIndex();
+  const InputSizeType                      validSize  = inputRegion.GetSize();
 
-  FFTWProxyType::ComplexType* inputPieceFFT;
-  inputPieceFFT = static_cast<FFTWProxyType::ComplexType*>(fftw_malloc(sizeFFT * sizeof(FFTWProxyType::ComplexType)));
+  if (m_Filter.Size() <= m_MaximumKernelSizeForSpatialConvolution)
+  {
+    // Zero padded piece of the input image
+    std::vector<FFTPixelType> piece(validSize[0] * validSize[1], FFTPixelType(0));
+    inputRegion.Crop(input->GetLargestPossibleRegion());
+    FFTPixelType* line = &piece[(inputRegion.GetIndex()[1] - pieceIndex[1]) * validSize[0] + inputRegion.GetIndex()[0] - pieceIndex[0]];
 
-  // Image piece FFT
-  FFTWProxyType::PlanType inputPlan = FFTWProxyType::Plan_dft_r2c_2d(pieceSize[1], pieceSize[0], inputPiece, inputPieceFFT, FFTW_MEASURE);
+    itk::ImageScanlineConstIterator<InputImageType> inputIt(input, inputRegion);
+    for (inputIt.GoToBegin(); !inputIt.IsAtEnd(); inputIt.NextLine(), line += validSize[0])
+    {
+      FFTPixelType* pixel = line;
+      for (; !inputIt.IsAtEndOfLine(); ++inputIt, ++pixel)
+      {
+        *pixel = static_cast<FFTPixelType>(inputIt.Get());
+      }
+    }
 
-  // left zero padding
-  unsigned int leftskip = static_cast<unsigned int>(std::max((typename InputImageType::IndexValueType)0, inputIndex[0] - pieceIndex[0]));
-  unsigned int topskip  = pieceSize[0] * static_cast<unsigned int>(std::max((typename InputImageType::IndexValueType)0, inputIndex[1] - pieceIndex[1]));
+    const FFTPixelType* pieceData  = piece.data();
+    const unsigned long pieceWidth = validSize[0];
+    const double        scale      = this->GetFilterScale();
+    ParallelForRange(this->GetMultiThreader(), this->GetNumberOfThreads(), outputRegion.GetSize()[1],
+                     [this, pieceData, pieceWidth, scale](itk::ThreadIdType, std::size_t firstRow, std::size_t endRow) {
+                       ThreadedSpatialConvolution(pieceData, pieceWidth, scale, firstRow, endRow);
+                     });
+    return;
+  }
 
-  // zero filling
-  memset(inputPiece, 0, pieceNbOfPixel * sizeof(InputPixelType));
+  if (!FFTWTraitsType::IsAvailable())
+  {
+    itkGenericExceptionMacro(<< "The OverlapSaveConvolutionImageFilter can not operate without the FFTW library for the requested precision. Please build "
+                                "ITK with USE_FFTWD (double) or USE_FFTWF (float) set to ON, and rebuild OTB.");
+  }
 
-  // Filling the buffer with image values
-  for (l = 0; l < inputSize[1]; ++l)
+  // The piece is padded up to an efficient FFT size: the additional zeros do
+  // not reach the valid part of the circular convolution
+  InputSizeType pieceSize;
+  pieceSize[0]                       = GetEfficientFFTSize(validSize[0]);
+  pieceSize[1]                       = GetEfficientFFTSize(validSize[1]);
+  const unsigned long pieceNbOfPixel = pieceSize[0] * pieceSize[1];
+
+  const int nbThreads =
+      pieceNbOfPixel >= m_MinimumNumberOfPixelsForThreadedFFT ? std::max(1, static_cast<int>(this->GetNumberOfThreads())) : 1;
+  const PlanCacheEntry* entry = this->GetPlanCacheEntry(pieceSize, nbThreads);
+
+  // The buffers only live while the piece is processed. The real buffer holds
+  // the kernel, then the input piece, and then the result.
+  FFTWBuffer<FFTPixelType>   piece(pieceNbOfPixel);
+  FFTWBuffer<FFTComplexType> pieceSpectrum(entry->SpectrumSize);
+  FFTWBuffer<FFTComplexType> filterSpectrum(entry->SpectrumSize);
+
+  // The kernel spectrum holds the normalization of the filter and the 1/N
+  // factor of the unnormalized backward transform
+  const double scale = this->GetFilterScale() / static_cast<double>(pieceNbOfPixel);
+
+  std::fill(piece.Get(), piece.Get() + pieceNbOfPixel, FFTPixelType(0));
+  const unsigned long filterWidth  = 2 * m_Radius[0] + 1;
+  const unsigned long filterHeight = 2 * m_Radius[1] + 1;
+  for (unsigned long j = 0, k = 0; j < filterHeight; ++j)
   {
-    for (k = 0; k < inputSize[0]; ++k)
+    for (unsigned long i = 0; i < filterWidth; ++i, ++k)
     {
-      inputPiece[topskip + pieceSize[0] * l + k + leftskip] = inputIt.GetCenterPixel();
-      ++inputIt;
+      piece.Get()[i + j * pieceSize[0]] = static_cast<FFTPixelType>(m_Filter.GetElement(k) * scale);
     }
   }
+  FFTWTraitsType::ExecuteForward(entry->ForwardPlan, piece.Get(), filterSpectrum.Get());
 
-  FFTWProxyType::Execute(inputPlan);
+  // Zero padded piece of the input image
+  inputRegion.Crop(input->GetLargestPossibleRegion());
+  const unsigned long leftskip = inputRegion.GetIndex()[0] - pieceIndex[0];
+  const unsigned long topskip  = inputRegion.GetIndex()[1] - pieceIndex[1];
 
-  // Resampled filter FFT
-  FFTWProxyType::PlanType filterPlan = FFTWProxyType::Plan_dft_r2c_2d(pieceSize[1], pieceSize[0], resampledFilterPiece, filterPieceFFT, FFTW_MEASURE);
+  std::fill(piece.Get(), piece.Get() + pieceNbOfPixel, FFTPixelType(0));
+  FFTPixelType* line = piece.Get() + topskip * pieceSize[0] + leftskip;
 
-  // zero filling
-  memset(resampledFilterPiece, 0, pieceNbOfPixel * sizeof(InputPixelType));
-
-  k = 0;
-  // Filling the buffer with filter values
-  for (j = 0; j < sizeOfFilter[1]; ++j)
+  itk::ImageScanlineConstIterator<InputImageType> inputIt(input, inputRegion);
+  for (inputIt.GoToBegin(); !inputIt.IsAtEnd(); inputIt.NextLine(), line += pieceSize[0])
   {
-    for (i = 0; i < sizeOfFilter[0]; ++i)
+    FFTPixelType* pixel = line;
+    for (; !inputIt.IsAtEndOfLine(); ++inputIt, ++pixel)
     {
-      resampledFilterPiece[i + j * pieceSize[0]] = m_Filter.GetElement(k); // Copy values
-      ++k;
+      *pixel = static_cast<FFTPixelType>(inputIt.Get());
     }
   }
 
-  FFTWProxyType::Execute(filterPlan);
-
-  // memory allocation for inverse FFT
-  FFTWProxyType::ComplexType* multipliedFFTarray;
-  multipliedFFTarray = static_cast<FFTWProxyType::ComplexType*>(fftw_malloc(sizeFFT * sizeof(FFTWProxyType::ComplexType)));
+  FFTWTraitsType::ExecuteForward(entry->ForwardPlan, piece.Get(), pieceSpectrum.Get());
 
-  FFTWProxyType::PixelType* inverseFFTpiece;
-  inverseFFTpiece = static_cast<FFTWProxyType::PixelType*>(fftw_malloc(pieceNbOfPixel * sizeof(FFTWProxyType::PixelType)));
-
-  // Inverse FFT of the product of FFT (actually do filtering here)
-  FFTWProxyType::PlanType outputPlan = FFTWProxyType::Plan_dft_c2r_2d(pieceSize[1], pieceSize[0], multipliedFFTarray, inverseFFTpiece, FFTW_MEASURE);
-
-  // Filling the buffer with complex product values
-  for (k = 0; k < sizeFFT; ++k)
+  // Term by term product with the kernel spectrum (actually do filtering here)
+  FFTComplexType*       product = pieceSpectrum.Get();
+  const FFTComplexType* filter  = filterSpectrum.Get();
+  for (unsigned long k = 0; k < entry->SpectrumSize; ++k)
   {
-    // complex mutiplication
-    multipliedFFTarray[k][0] = inputPieceFFT[k][0] * filterPieceFFT[k][0] - inputPieceFFT[k][1] * filterPieceFFT[k][1];
-    multipliedFFTarray[k][1] = inputPieceFFT[k][0] * filterPieceFFT[k][1] + inputPieceFFT[k][1] * filterPieceFFT[k][0];
+    const FFTPixelType re = product[k][0] * filter[k][0] - product[k][1] * filter[k][1];
+    const FFTPixelType im = product[k][0] * filter[k][1] + product[k][1] * filter[k][0];
+    product[k][0]         = re;
+    product[k][1]         = im;
   }
 
-  FFTWProxyType::Execute(outputPlan);
+  FFTWTraitsType::ExecuteBackward(entry->BackwardPlan, pieceSpectrum.Get(), piece.Get());
 
-  // Computing the filter normalization
+  // The valid part of the circular convolution starts after twice the radius
+  const FFTPixelType* resultLine = piece.Get() + 2 * m_Radius[1] * pieceSize[0] + 2 * m_Radius[0];
 
-  if (m_NormalizeFilter)
+  itk::ImageScanlineIterator<OutputImageType> outputIt(output, outputRegion);
+  for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); outputIt.NextLine(), resultLine += pieceSize[0])
   {
-    norm = itk::NumericTraits<InputRealType>::Zero;
-    for (i = 0; i < sizeOfFilter[0] * sizeOfFilter[1]; ++i)
+    const FFTPixelType* result = resultLine;
+    for (; !outputIt.IsAtEndOfLine(); ++outputIt, ++result)
     {
-      norm += static_cast<InputRealType>(m_Filter(i));
-    }
-    if (norm == 0.0)
-    {
-      norm = 1.0;
-    }
-    else
-    {
-      norm = 1 / norm;
+      outputIt.Set(static_cast<OutputPixelType>(*result));
     }
   }
-  else
+}
+
+template <class TInputImage, class TOutputImage, class TBoundaryCondition, class TFFTPrecision>
+void OverlapSaveConvolutionImageFilter<TInputImage, TOutputImage, TBoundaryCondition, TFFTPrecision>::ThreadedSpatialConvolution(const FFTPixelType* piece,
+                                                                                                                                 unsigned long       pieceWidth,
+                                                                                                                                 double              scale,
+                                                                                                                                 std::size_t         firstRow,
+                                                                                                                                 std::size_t         endRow)
+{
+  if (firstRow == endRow)
   {
-    norm = 1.0;
+    return;
   }
 
-  // Fill the output image
-  outputIt.GoToBegin();
-  while (!outputIt.IsAtEnd())
+  typename OutputImageType::Pointer output       = this->GetOutput();
+  const OutputImageRegionType       outputRegion = output->GetRequestedRegion();
+
+  OutputImageRegionType threadRegion = outputRegion;
+  threadRegion.SetIndex(1, outputRegion.GetIndex()[1] + firstRow);
+  threadRegion.SetSize(1, endRow - firstRow);
+
+  // Same sum as the circular convolution of the FFT: the kernel is flipped
+  const unsigned long filterWidth  = 2 * m_Radius[0] + 1;
+  const unsigned long filterHeight = 2 * m_Radius[1] + 1;
+  std::vector<double> kernel(m_Filter.Size());
+  for (unsigned long k = 0; k < kernel.size(); ++k)
   {
-    typename InputImageType::IndexType index = outputIt.GetIndex();
-    unsigned int linearIndex = (index[1] + sizeOfFilter[1] - 1 - outputRegionForThread.GetIndex()[1]) * pieceSize[0] - 1 + index[0] + sizeOfFilter[0] -
-                               outputRegionForThread.GetIndex()[0];
-    outputIt.Set(static_cast<OutputPixelType>((inverseFFTpiece[linearIndex] / pieceNbOfPixel) * static_cast<double>(norm)));
-    ++outputIt;
+    kernel[k] = m_Filter.GetElement(k) * scale;
   }
 
-  // destroy the FFT plans
-  FFTWProxyType::DestroyPlan(inputPlan);
-  FFTWProxyType::DestroyPlan(filterPlan);
-  FFTWProxyType::DestroyPlan(outputPlan);
-
-  // frees memory
-  fftw_free(resampledFilterPiece);
-  fftw_free(inputPiece);
-  fftw_free(filterPieceFFT);
-  fftw_free(inputPieceFFT);
-  fftw_free(multipliedFFTarray);
-  fftw_free(inverseFFTpiece);
-#else
-  itkGenericExceptionMacro(<< "The OverlapSaveConvolutionImageFilter can not operate without the FFTW library (double implementation). Please build ITK with "
-                              "USE_FFTD set to ON, and rebuild OTB.");
-#endif
+  itk::ImageScanlineIterator<OutputImageType> outputIt(output, threadRegion);
+  const FFTPixelType*                          pieceLine = piece + (firstRow + 2 * m_Radius[1]) * pieceWidth + 2 * m_Radius[0];
+  for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); outputIt.NextLine(), pieceLine += pieceWidth)
+  {
+    for (const FFTPixelType* center = pieceLine; !outputIt.IsAtEndOfLine(); ++outputIt, ++center)
+    {
+      double        sum         = 0.;
+      const double* coefficient = kernel.data();
+      for (unsigned long j = 0; j < filterHeight; ++j)
+      {
+        const FFTPixelType* pixel = center - j * pieceWidth;
+        for (unsigned long i = 0; i < filterWidth; ++i, ++coefficient)
+        {
+          sum += *coefficient * pixel[-static_cast<long>(i)];
+        }
+      }
+      outputIt.Set(static_cast<OutputPixelType>(sum));
+    }
+  }
 }
 
 /** Standard "PrintSelf" method */
-template <class TInputImage, class TOutput, class TBoundaryCondition>
-void OverlapSaveConvolutionImageFilter<TInputImage, TOutput, TBoundaryCondition>::PrintSelf(std::ostream& os, itk::Indent indent) const
+template <class TInputImage, class TOutput, class TBoundaryCondition, class TFFTPrecision>
+void OverlapSaveConvolutionImageFilter<TInputImage, TOutput, TBoundaryCondition, TFFTPrecision>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "Radius: " << m_Radius << std::endl;
   os << indent << "Normalize filter: " << m_NormalizeFilter << std::endl;
+  os << indent << "Maximum number of cached plans: " << m_MaximumNumberOfCachedPlans << std::endl;
+  os << indent << "Number of cached plans: " << m_PlanCache.size() << std::endl;
+  os << indent << "Minimum number of pixels for threaded FFT: " << m_MinimumNumberOfPixelsForThreadedFFT << std::endl;
+  os << indent << "Maximum kernel size for spatial convolution: " << m_MaximumKernelSizeForSpatialConvolution << std::endl;
 }
 } // end namespace otb
 
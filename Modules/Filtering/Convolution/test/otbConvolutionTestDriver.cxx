@@ -23,9 +23,12 @@
 void RegisterTests()
 {
   REGISTER_TEST(otbConvolutionImageFilter);
+  REGISTER_TEST(otbConvolutionImageFilterSeparable);
 #if defined(ITK_USE_FFTWD)
   REGISTER_TEST(otbOverlapSaveConvolutionImageFilter);
   REGISTER_TEST(otbCompareOverlapSaveAndClassicalConvolutionWithGaborFilter);
+  REGISTER_TEST(otbOverlapSaveConvolutionImageFilterStreaming);
+  REGISTER_TEST(otbOverlapSaveConvolutionBenchmark);
 #endif
   REGISTER_TEST(otbGaborFilterGenerator);
 }
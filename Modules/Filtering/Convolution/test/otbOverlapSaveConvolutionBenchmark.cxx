@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "itkImageRegionConstIterator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTimeProbe.h"
+
+#include "otbImage.h"
+#include "otbImageFileReader.h"
+#include "otbConvolutionImageFilter.h"
+#include "otbOverlapSaveConvolutionImageFilter.h"
+
+typedef otb::Image<double, 2>                       ConvolutionImageType;
+typedef otb::ImageFileReader<ConvolutionImageType> ConvolutionReaderType;
+
+int otbOverlapSaveConvolutionImageFilterStreaming(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::OverlapSaveConvolutionImageFilter<ConvolutionImageType, ConvolutionImageType> ConvFilterType;
+  typedef itk::StreamingImageFilter<ConvolutionImageType, ConvolutionImageType>              StreamerType;
+
+  ConvolutionReaderType::Pointer reader = ConvolutionReaderType::New();
+  reader->SetFileName(argv[1]);
+
+  ConvFilterType::InputSizeType radius;
+  radius.Fill(4);
+  ConvFilterType::ArrayType filterCoeffs((2 * radius[0] + 1) * (2 * radius[1] + 1));
+  for (unsigned int i = 0; i < filterCoeffs.Size(); ++i)
+  {
+    filterCoeffs[i] = 1. + (i % 7);
+  }
+
+  // Whole image at once
+  ConvFilterType::Pointer reference = ConvFilterType::New();
+  reference->SetRadius(radius);
+  reference->SetFilter(filterCoeffs);
+  reference->NormalizeFilterOn();
+  reference->SetInput(reader->GetOutput());
+  reference->Update();
+
+  // Streamed: the divisions of the same size share their plans
+  ConvFilterType::Pointer streamed = ConvFilterType::New();
+  streamed->SetRadius(radius);
+  streamed->SetFilter(filterCoeffs);
+  streamed->NormalizeFilterOn();
+  streamed->SetInput(reader->GetOutput());
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput(streamed->GetOutput());
+  streamer->SetNumberOfStreamDivisions(10);
+  streamer->Update();
+
+  std::cout << "Number of cached plans after streaming: " << streamed->GetNumberOfCachedPlans() << std::endl;
+  bool ok = streamed->GetNumberOfCachedPlans() > 0 && streamed->GetNumberOfCachedPlans() <= streamed->GetMaximumNumberOfCachedPlans();
+
+  const ConvolutionImageType::RegionType region = reader->GetOutput()->GetLargestPossibleRegion();
+  itk::ImageRegionConstIterator<ConvolutionImageType> refIt(reference->GetOutput(), region);
+  itk::ImageRegionConstIterator<ConvolutionImageType> streamedIt(streamer->GetOutput(), region);
+  double                                              maxError = 0.;
+  for (refIt.GoToBegin(), streamedIt.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++streamedIt)
+  {
+    maxError = std::max(maxError, std::abs(refIt.Get() - streamedIt.Get()) / (1. + std::abs(refIt.Get())));
+  }
+  std::cout << "Maximum relative difference between the streamed and whole convolutions: " << maxError << std::endl;
+  ok = ok && maxError < 1e-9;
+
+#if defined ITK_USE_FFTWF
+  // Single precision transforms
+  typedef otb::OverlapSaveConvolutionImageFilter<ConvolutionImageType, ConvolutionImageType, itk::ZeroFluxNeumannBoundaryCondition<ConvolutionImageType>, float>
+      FloatConvFilterType;
+  FloatConvFilterType::Pointer single = FloatConvFilterType::New();
+  single->SetRadius(radius);
+  single->SetFilter(filterCoeffs);
+  single->NormalizeFilterOn();
+  single->SetInput(reader->GetOutput());
+  single->Update();
+
+  itk::ImageRegionConstIterator<ConvolutionImageType> singleIt(single->GetOutput(), region);
+  double                                              singleError = 0.;
+  for (refIt.GoToBegin(), singleIt.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++singleIt)
+  {
+    singleError = std::max(singleError, std::abs(refIt.Get() - singleIt.Get()) / (1. + std::abs(refIt.Get())));
+  }
+  std::cout << "Maximum relative difference between the float and double transforms: " << singleError << std::endl;
+  ok = ok && singleError < 1e-4;
+#endif
+
+  // Small kernels are convolved in the spatial domain, with the same result
+  ConvFilterType::InputSizeType smallRadius;
+  smallRadius[0] = 2;
+  smallRadius[1] = 1;
+  ConvFilterType::ArrayType smallCoeffs((2 * smallRadius[0] + 1) * (2 * smallRadius[1] + 1));
+  for (unsigned int i = 0; i < smallCoeffs.Size(); ++i)
+  {
+    smallCoeffs[i] = 1. + (i % 7);
+  }
+
+  ConvFilterType::Pointer spatial = ConvFilterType::New();
+  spatial->SetRadius(smallRadius);
+  spatial->SetFilter(smallCoeffs);
+  spatial->NormalizeFilterOn();
+  spatial->SetInput(reader->GetOutput());
+  spatial->Update();
+
+  ConvFilterType::Pointer fft = ConvFilterType::New();
+  fft->SetRadius(smallRadius);
+  fft->SetFilter(smallCoeffs);
+  fft->NormalizeFilterOn();
+  fft->SetMaximumKernelSizeForSpatialConvolution(0);
+  fft->SetInput(reader->GetOutput());
+  fft->Update();
+
+  ok = ok && spatial->GetNumberOfCachedPlans() == 0 && fft->GetNumberOfCachedPlans() == 1;
+
+  itk::ImageRegionConstIterator<ConvolutionImageType> spatialIt(spatial->GetOutput(), region);
+  itk::ImageRegionConstIterator<ConvolutionImageType> fftIt(fft->GetOutput(), region);
+  double                                              spatialError = 0.;
+  for (spatialIt.GoToBegin(), fftIt.GoToBegin(); !fftIt.IsAtEnd(); ++spatialIt, ++fftIt)
+  {
+    spatialError = std::max(spatialError, std::abs(fftIt.Get() - spatialIt.Get()) / (1. + std::abs(fftIt.Get())));
+  }
+  std::cout << "Maximum relative difference between the spatial and FFT convolutions: " << spatialError << std::endl;
+  ok = ok && spatialError < 1e-9;
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/** Times the spatial and the overlap-save convolutions for increasing kernel
+ * radii, and reports the smallest kernel size (number of coefficients) from
+ * which the FFT is faster: MaximumKernelSizeForSpatialConvolution should stay
+ * below it. It is not run as a test, since the timings depend on the machine:
+ *   otbConvolutionTestDriver otbOverlapSaveConvolutionBenchmark input.tif output.txt 32 */
+int otbOverlapSaveConvolutionBenchmark(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::ConvolutionImageFilter<ConvolutionImageType, ConvolutionImageType>            SpatialFilterType;
+  typedef otb::OverlapSaveConvolutionImageFilter<ConvolutionImageType, ConvolutionImageType> FFTFilterType;
+
+  const char*        outputFileName = argv[2];
+  const unsigned int maxRadius      = atoi(argv[3]);
+
+  ConvolutionReaderType::Pointer reader = ConvolutionReaderType::New();
+  reader->SetFileName(argv[1]);
+  reader->Update();
+
+  std::ofstream file(outputFileName);
+  file << "radius spatial(s) overlap-save(s)" << std::endl;
+
+  unsigned int crossover = 0;
+  for (unsigned int r = 1; r <= maxRadius; r *= 2)
+  {
+    SpatialFilterType::InputSizeType radius;
+    radius.Fill(r);
+    SpatialFilterType::ArrayType filterCoeffs((2 * r + 1) * (2 * r + 1));
+    filterCoeffs.Fill(1.);
+
+    SpatialFilterType::Pointer spatial = SpatialFilterType::New();
+    spatial->SetRadius(radius);
+    spatial->SetFilter(filterCoeffs);
+    spatial->NormalizeFilterOn();
+    spatial->SetInput(reader->GetOutput());
+
+    FFTFilterType::Pointer fft = FFTFilterType::New();
+    fft->SetRadius(radius);
+    fft->SetFilter(filterCoeffs);
+    fft->NormalizeFilterOn();
+    fft->SetMaximumKernelSizeForSpatialConvolution(0);
+    fft->SetInput(reader->GetOutput());
+
+    itk::TimeProbe spatialProbe, fftProbe;
+    spatialProbe.Start();
+    spatial->Update();
+    spatialProbe.Stop();
+
+    fftProbe.Start();
+    fft->Update();
+    fftProbe.Stop();
+
+    file << r << " " << spatialProbe.GetTotal() << " " << fftProbe.GetTotal() << std::endl;
+    if (crossover == 0 && fftProbe.GetTotal() < spatialProbe.GetTotal())
+    {
+      crossover = filterCoeffs.Size();
+    }
+  }
+
+  // 0 means that the spatial convolution was always faster
+  file << "crossover kernel size: " << crossover << std::endl;
+  std::cout << "Overlap-save convolution is faster from " << crossover << " kernel coefficients" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -24,7 +24,10 @@
 #include "itkImageToImageFilter.h"
 #include "otbPCAImageFilter.h"
 #include "otbFastICAInternalOptimizerVectorImageFilter.h"
+#include "otbStreamingSampleReservoirImageFilter.h"
+#include "otbParallelForRange.h"
 #include <functional>
+#include <vector>
 
 namespace otb
 {
@@ -37,6 +40,13 @@ namespace otb
  * The contrast function and its derivative can be supplied to the filter as
  * lambda functions.
  *
+ * By default, each fixed-point iteration streams the whole image. When
+ * NumberOfSamples is not 0, a uniform random subset of NumberOfSamples
+ * whitened pixels is drawn in a single streaming pass, and the iterations
+ * run in memory on these samples, one block of samples per thread. The
+ * unmixing matrix is then applied to the whole image in a final streaming
+ * pass.
+ *
  * [1] Fast and robust fixed-point algorithms for independent component analysis
  *
  * \sa PCAImageFilter
@@ -88,6 +98,9 @@ public:
   typedef StreamingStatisticsVectorImageFilter<InputImageType> MeanEstimatorFilterType;
   typedef typename MeanEstimatorFilterType::Pointer            MeanEstimatorFilterPointerType;
 
+  typedef StreamingSampleReservoirImageFilter<OutputImageType> SamplerFilterType;
+  typedef typename SamplerFilterType::Pointer                  SamplerFilterPointerType;
+
   typedef std::function<double(double)> NonLinearityType;
 
   /**
@@ -158,6 +171,14 @@ public:
   itkGetMacro(Mu, double);
   itkSetMacro(Mu, double);
 
+  /** Number of whitened pixels drawn to estimate the unmixing matrix in
+   * memory. 0 (default) streams the whole image at each iteration. */
+  itkGetMacro(NumberOfSamples, unsigned long);
+  itkSetMacro(NumberOfSamples, unsigned long);
+
+  /** Sampler of the whitened pixels, e.g. to set its seed */
+  itkGetMacro(Sampler, SamplerFilterType*);
+
 protected:
   FastICAImageFilter();
   ~FastICAImageFilter() override
@@ -188,6 +209,17 @@ protected:
   /** this is the specific part of FastICA */
   virtual void GenerateTransformationMatrix();
 
+  /** FastICA iterations on a random subset of the whitened pixels */
+  void GenerateTransformationMatrixFromSamples();
+
+  /** Accumulate, over the samples [begin, end), E[x.g(w^T.x)] in the first
+   * size x size values of the thread accumulator, then E[w^T.x.g(w^T.x)]
+   * and E[g'(w^T.x)] for each column w of W */
+  void ThreadedAccumulateSamples(const InternalMatrixType& W, itk::ThreadIdType threadId, std::size_t begin, std::size_t end);
+
+  /** Symmetric decorrelation W = (W.W^T)^-1/2.W */
+  void SymmetricDecorrelation(InternalMatrixType& W) const;
+
   unsigned int m_NumberOfPrincipalComponentsRequired;
 
   /** Transformation matrix refers to the ICA step (not PCA) */
@@ -201,13 +233,18 @@ protected:
   NonLinearityType m_NonLinearity;           // see g() function in the biblio. Def is tanh
   NonLinearityType m_NonLinearityDerivative; // derivative of g().
   double           m_Mu;                     // def is 1. in [0, 1]
+  unsigned long    m_NumberOfSamples;        // def is 0 (whole image)
 
   PCAFilterPointerType       m_PCAFilter;
   TransformFilterPointerType m_TransformFilter;
+  SamplerFilterPointerType   m_Sampler;
 
 private:
   FastICAImageFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
+
+  /** Per-thread accumulators of the in-memory iterations */
+  std::vector<double> m_ThreadAccumulators;
 }; // end of class
 
 } // end of namespace otb
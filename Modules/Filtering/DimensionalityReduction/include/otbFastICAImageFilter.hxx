@@ -27,6 +27,8 @@
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
 
+#include <algorithm>
+
 #include <vnl/vnl_matrix.h>
 #include <vnl/algo/vnl_matrix_inverse.h>
 #include <vnl/algo/vnl_generalized_eigensystem.h>
@@ -52,11 +54,15 @@ FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::FastI
 
   m_Mu = 1.;
 
+  m_NumberOfSamples = 0;
+
   m_PCAFilter = PCAFilterType::New();
   m_PCAFilter->SetUseNormalization(true);
   m_PCAFilter->SetUseVarianceForNormalization(false);
 
   m_TransformFilter = TransformFilterType::New();
+
+  m_Sampler = SamplerFilterType::New();
 }
 
 template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
@@ -209,6 +215,12 @@ void FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::
 template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
 void FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::GenerateTransformationMatrix()
 {
+  if (m_NumberOfSamples > 0)
+  {
+    GenerateTransformationMatrixFromSamples();
+    return;
+  }
+
   itk::ProgressReporter reporter(this, 0, GetNumberOfIterations(), GetNumberOfIterations());
 
   double       convergence = itk::NumericTraits<double>::max();
@@ -264,14 +276,7 @@ void FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::
     }
 
     // Decorrelation of the W vectors
-    InternalMatrixType         W_tmp = W * W.transpose();
-    vnl_svd<MatrixElementType> solver(W_tmp);
-    InternalMatrixType         valP = solver.W();
-    for (unsigned int i = 0; i < valP.rows(); ++i)
-      valP(i, i) = 1. / std::sqrt(static_cast<double>(valP(i, i))); // Watch for 0 or neg
-    InternalMatrixType transf = solver.U();
-    W_tmp                     = transf * valP * transf.transpose();
-    W                         = W_tmp * W;
+    SymmetricDecorrelation(W);
 
     // Convergence evaluation
     convergence = 0.;
@@ -287,6 +292,143 @@ void FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::
   otbMsgDebugMacro(<< "Final convergence " << convergence << " after " << iteration << " iterations");
 }
 
+template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
+void FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::GenerateTransformationMatrixFromSamples()
+{
+  const unsigned int size = this->GetNumberOfPrincipalComponentsRequired();
+
+  // Single streaming pass drawing the whitened samples
+  m_Sampler->SetInput(m_PCAFilter->GetOutput());
+  m_Sampler->GetFilter()->SetReservoirSize(m_NumberOfSamples);
+  m_Sampler->Update();
+
+  const unsigned long nbSamples = m_Sampler->GetNumberOfSamples();
+  if (nbSamples == 0)
+  {
+    throw itk::ExceptionObject(__FILE__, __LINE__, "No valid pixel to estimate the unmixing matrix", ITK_LOCATION);
+  }
+
+  itk::ProgressReporter reporter(this, 0, GetNumberOfIterations(), GetNumberOfIterations());
+
+  double       convergence = itk::NumericTraits<double>::max();
+  unsigned int iteration   = 0;
+
+  // transformation matrix
+  InternalMatrixType W(size, size, vnl_matrix_identity);
+
+  const itk::ThreadIdType numberOfThreads = GetParallelForRangeNumberOfThreads(this->GetNumberOfThreads(), nbSamples);
+  const unsigned int      accumulatorSize = size * size + 2 * size;
+
+  while (iteration++ < GetNumberOfIterations() && convergence > GetConvergenceThreshold())
+  {
+    InternalMatrixType W_old(W);
+
+    m_ThreadAccumulators.assign(numberOfThreads * accumulatorSize, 0.);
+    ParallelForRange(this->GetMultiThreader(), numberOfThreads, nbSamples, [this, &W](itk::ThreadIdType threadId, std::size_t begin, std::size_t end) {
+      ThreadedAccumulateSamples(W, threadId, begin, end);
+    });
+
+    // Reduce in the thread order so that the result does not depend on the
+    // scheduling of the threads
+    std::vector<double> sums(accumulatorSize, 0.);
+    for (itk::ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId)
+    {
+      for (unsigned int i = 0; i < accumulatorSize; ++i)
+        sums[i] += m_ThreadAccumulators[threadId * accumulatorSize + i];
+    }
+
+    // Fixed-point update of each column of W, from the W of the iteration
+    // start as in the streamed version
+    for (unsigned int band = 0; band < size; band++)
+    {
+      const double beta = sums[size * size + band] / nbSamples;
+      const double den  = sums[size * size + size + band] / nbSamples - beta;
+
+      double norm = 0.;
+      for (unsigned int bd = 0; bd < size; bd++)
+      {
+        W(bd, band) -= m_Mu * (sums[band * size + bd] / nbSamples - beta * W(bd, band)) / den;
+        norm += std::pow(W(bd, band), 2.);
+      }
+      for (unsigned int bd = 0; bd < size; bd++)
+        W(bd, band) /= std::sqrt(norm);
+    }
+
+    // Decorrelation of the W vectors
+    SymmetricDecorrelation(W);
+
+    // Convergence evaluation
+    convergence = 0.;
+    for (unsigned int i = 0; i < W.rows(); ++i)
+      for (unsigned int j = 0; j < W.cols(); ++j)
+        convergence += std::abs(W(i, j) - W_old(i, j));
+
+    reporter.CompletedPixel();
+  } // end of while loop
+
+  this->m_TransformationMatrix = W;
+
+  // The samples are not needed anymore
+  m_Sampler->GetFilter()->ClearSamples();
+  std::vector<double>().swap(m_ThreadAccumulators);
+
+  otbMsgDebugMacro(<< "Final convergence " << convergence << " after " << iteration << " iterations on " << nbSamples << " samples");
+}
+
+template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
+void FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::ThreadedAccumulateSamples(const InternalMatrixType& W,
+                                                                                                         itk::ThreadIdType         threadId,
+                                                                                                         std::size_t               begin,
+                                                                                                         std::size_t               end)
+{
+  const unsigned int                                  size    = W.rows();
+  const typename SamplerFilterType::SampleBufferType& samples = m_Sampler->GetSamples();
+
+  double* expectations = &m_ThreadAccumulators[threadId * (size * size + 2 * size)];
+  double* betas        = expectations + size * size;
+  double* dens         = betas + size;
+
+  std::vector<double> y(size);
+  for (std::size_t s = begin; s < end; ++s)
+  {
+    const double* x = &samples[s * size];
+
+    // Projections on all the columns of W at once
+    std::fill(y.begin(), y.end(), 0.);
+    for (unsigned int bd = 0; bd < size; bd++)
+    {
+      const double  xi  = x[bd];
+      const double* row = W[bd];
+      for (unsigned int band = 0; band < size; band++)
+        y[band] += xi * row[band];
+    }
+
+    for (unsigned int band = 0; band < size; band++)
+    {
+      const double g_x = m_NonLinearity(y[band]);
+      betas[band] += y[band] * g_x;
+      dens[band] += m_NonLinearityDerivative(y[band]);
+
+      double* expectation = expectations + band * size;
+      for (unsigned int bd = 0; bd < size; bd++)
+        expectation[bd] += g_x * x[bd];
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
+void FastICAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::SymmetricDecorrelation(InternalMatrixType& W) const
+{
+  InternalMatrixType         W_tmp = W * W.transpose();
+  vnl_svd<MatrixElementType> solver(W_tmp);
+  InternalMatrixType         valP = solver.W();
+  for (unsigned int i = 0; i < valP.rows(); ++i)
+    valP(i, i) = 1. / std::sqrt(static_cast<double>(valP(i, i))); // Watch for 0 or neg
+  InternalMatrixType transf = solver.U();
+  W_tmp                     = transf * valP * transf.transpose();
+  W                         = W_tmp * W;
+}
+
 } // end of namespace otb
 
 #endif
@@ -38,8 +38,15 @@ namespace otb
  *
  * TODO? Use a 2nd input to give a noise image directly?
  *
+ * When UseRandomizedSVD is on (forward transform, no given covariance nor
+ * transformation matrix), the covariance matrix of the data is not computed:
+ * the leading components of the noise-whitened data are estimated by
+ * StreamingRandomizedCovarianceEigenImageFilter. The noise covariance matrix
+ * is still fully estimated since it defines the whitening.
+ *
  * \sa otbStreamingStatisticsVectorImageFilter
  * \sa PCAImageFiler
+ * \sa StreamingRandomizedCovarianceEigenImageFilter
  *
  * \ingroup OTBDimensionalityReduction
  */
@@ -90,6 +97,9 @@ public:
   typedef NormalizeVectorImageFilter<InputImageType, OutputImageType> NormalizeFilterType;
   typedef typename NormalizeFilterType::Pointer NormalizeFilterPointerType;
 
+  typedef StreamingRandomizedCovarianceEigenImageFilter<OutputImageType> EigenEstimatorFilterType;
+  typedef typename EigenEstimatorFilterType::Pointer                     EigenEstimatorFilterPointerType;
+
   /**
    * Set/Get the number of required largest principal components.
    */
@@ -102,6 +112,14 @@ public:
   itkGetMacro(Transformer, TransformFilterType*);
   itkGetMacro(NoiseImageFilter, NoiseImageFilterType*);
 
+  /** Estimate the required components with a randomized decomposition
+   * instead of the full covariance matrix. The number of power iterations
+   * and the oversampling are set through GetEigenEstimator()->GetFilter(). */
+  itkSetMacro(UseRandomizedSVD, bool);
+  itkGetMacro(UseRandomizedSVD, bool);
+  itkBooleanMacro(UseRandomizedSVD);
+  itkGetMacro(EigenEstimator, EigenEstimatorFilterType*);
+
   /** Normalization only impact the use of variance. The data is always centered */
   itkGetMacro(UseNormalization, bool);
   itkSetMacro(UseNormalization, bool);
@@ -154,6 +172,8 @@ public:
     /** User ignored value for the noise covariance estimator */
     m_NoiseCovarianceEstimator->SetUserIgnoredValue(value);
     m_NoiseCovarianceEstimator->SetIgnoreUserDefinedValue(true);
+    /** User ignored value for the randomized estimator */
+    m_EigenEstimator->SetUserIgnoredValue(value);
   }
 
   itkGetConstMacro(EigenValues, VectorType);
@@ -189,6 +209,11 @@ protected:
 
   /** Specific functionality of MNF */
   virtual void GenerateTransformationMatrix();
+  virtual void GenerateRandomizedTransformationMatrix();
+
+  /** Leading eigenpairs of whitening.C.whitening^T, where C is the
+   * covariance matrix of the normalized data, by decreasing eigenvalues */
+  void EstimateLeadingEigenPairs(const InternalMatrixType& whitening, InternalMatrixType& eigenVectors, vnl_vector<double>& eigenValues);
 
   /** Internal attributes */
   unsigned int m_NumberOfPrincipalComponentsRequired;
@@ -201,6 +226,7 @@ protected:
   bool m_GivenNoiseCovarianceMatrix;
   bool m_GivenTransformationMatrix;
   bool m_IsTransformationMatrixForward;
+  bool m_UseRandomizedSVD;
 
   VectorType m_MeanValues;
   VectorType m_StdDevValues;
@@ -214,6 +240,7 @@ protected:
   CovarianceEstimatorFilterPointerType m_CovarianceEstimator;
   CovarianceEstimatorFilterPointerType m_NoiseCovarianceEstimator;
   TransformFilterPointerType           m_Transformer;
+  EigenEstimatorFilterPointerType      m_EigenEstimator;
 
 private:
   MNFImageFilter(const Self&); // not implemented
@@ -47,6 +47,7 @@ MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTransfo
   m_GivenNoiseCovarianceMatrix    = false;
   m_GivenTransformationMatrix     = false;
   m_IsTransformationMatrixForward = true;
+  m_UseRandomizedSVD              = false;
 
   m_Normalizer               = NormalizeFilterType::New();
   m_NoiseImageFilter         = NoiseImageFilterType::New();
@@ -54,6 +55,7 @@ MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTransfo
   m_NoiseCovarianceEstimator = CovarianceEstimatorFilterType::New();
   m_Transformer              = TransformFilterType::New();
   m_Transformer->MatrixByVectorOn();
+  m_EigenEstimator = EigenEstimatorFilterType::New();
 }
 
 template <class TInputImage, class TOutputImage, class TNoiseImageFilter, Transform::TransformDirection TDirectionOfTransformation>
@@ -131,6 +133,11 @@ void MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTr
   else
     m_Normalizer->SetUseStdDev(false);
 
+  // Only the mean is needed from the normalizer statistics: the randomized
+  // mode avoids their second order part
+  if (m_UseRandomizedSVD && !m_UseNormalization)
+    m_Normalizer->GetCovarianceEstimator()->SetEnableSecondOrderStats(false);
+
   m_Normalizer->SetInput(inputImgPtr);
   m_Normalizer->GetOutput()->UpdateOutputInformation();
 
@@ -154,15 +161,22 @@ void MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTr
       m_NoiseCovarianceMatrix = m_NoiseCovarianceEstimator->GetCovariance();
     }
 
-    if (!m_GivenCovarianceMatrix)
+    if (m_UseRandomizedSVD && !m_GivenCovarianceMatrix)
     {
-      m_CovarianceEstimator->SetInput(m_Normalizer->GetOutput());
-      m_CovarianceEstimator->Update();
-
-      m_CovarianceMatrix = m_CovarianceEstimator->GetCovariance();
+      GenerateRandomizedTransformationMatrix();
     }
+    else
+    {
+      if (!m_GivenCovarianceMatrix)
+      {
+        m_CovarianceEstimator->SetInput(m_Normalizer->GetOutput());
+        m_CovarianceEstimator->Update();
 
-    GenerateTransformationMatrix();
+        m_CovarianceMatrix = m_CovarianceEstimator->GetCovariance();
+      }
+
+      GenerateTransformationMatrix();
+    }
   }
   else if (!m_IsTransformationMatrixForward)
   {
@@ -327,6 +341,41 @@ void MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTr
     m_EigenValues[i]  = static_cast<RealType>(valP(i, i));
 }
 
+template <class TInputImage, class TOutputImage, class TNoiseImageFilter, Transform::TransformDirection TDirectionOfTransformation>
+void MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTransformation>::GenerateRandomizedTransformationMatrix()
+{
+  vnl_cholesky       choleskySolver(m_NoiseCovarianceMatrix.GetVnlMatrix(), vnl_cholesky::estimate_condition);
+  InternalMatrixType Rn     = choleskySolver.lower_triangle();
+  InternalMatrixType Rn_inv = vnl_matrix_inverse<MatrixElementType>(Rn.transpose());
+
+  // Leading eigenvectors of Rn_inv^T.C.Rn_inv, estimated without C
+  InternalMatrixType U;
+  vnl_vector<double> valP;
+  EstimateLeadingEigenPairs(Rn_inv.transpose(), U, valP);
+
+  InternalMatrixType transf = Rn_inv * U;
+  transf.inplace_transpose();
+  m_TransformationMatrix = transf;
+
+  m_EigenValues.SetSize(m_NumberOfPrincipalComponentsRequired);
+  for (unsigned int i = 0; i < m_NumberOfPrincipalComponentsRequired; ++i)
+    m_EigenValues[i]  = static_cast<RealType>(valP[i]);
+}
+
+template <class TInputImage, class TOutputImage, class TNoiseImageFilter, Transform::TransformDirection TDirectionOfTransformation>
+void MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTransformation>::EstimateLeadingEigenPairs(const InternalMatrixType& whitening,
+                                                                                                                        InternalMatrixType& eigenVectors,
+                                                                                                                        vnl_vector<double>& eigenValues)
+{
+  m_EigenEstimator->SetInput(m_Normalizer->GetOutput());
+  m_EigenEstimator->GetFilter()->SetWhiteningMatrix(whitening);
+  m_EigenEstimator->GetFilter()->SetNumberOfComponentsRequired(m_NumberOfPrincipalComponentsRequired);
+  m_EigenEstimator->Update();
+
+  eigenVectors = m_EigenEstimator->GetEigenVectors();
+  eigenValues  = m_EigenEstimator->GetEigenValues();
+}
+
 template <class TInputImage, class TOutputImage, class TNoiseImageFilter, Transform::TransformDirection TDirectionOfTransformation>
 void MNFImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTransformation>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
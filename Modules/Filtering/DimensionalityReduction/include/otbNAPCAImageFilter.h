@@ -94,6 +94,7 @@ protected:
 
   /** Specific functionality of NAPCA */
   void GenerateTransformationMatrix() override;
+  void GenerateRandomizedTransformationMatrix() override;
 }; // end of class
 
 } // end of namespace otb
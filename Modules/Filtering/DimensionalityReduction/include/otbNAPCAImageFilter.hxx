@@ -80,6 +80,47 @@ void NAPCAImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOf
     this->m_EigenValues[this->GetNumberOfPrincipalComponentsRequired() - 1 - i] = static_cast<RealType>(vectValPadj[i]);
 }
 
+template <class TInputImage, class TOutputImage, class TNoiseImageFilter, Transform::TransformDirection TDirectionOfTransformation>
+void NAPCAImageFilter<TInputImage, TOutputImage, TNoiseImageFilter, TDirectionOfTransformation>::GenerateRandomizedTransformationMatrix()
+{
+  InternalMatrixType An = this->GetNoiseCovarianceMatrix().GetVnlMatrix();
+  InternalMatrixType Fn;
+  vnl_vector<double> vectValPn;
+  vnl_symmetric_eigensystem_compute(An, Fn, vectValPn);
+
+  /* We used normalized PCA: Fn = En.Ln^-1/2, and its inverse Ln^1/2.En^T */
+  InternalMatrixType Fn_inv = Fn.transpose();
+  for (unsigned int i = 0; i < vectValPn.size(); ++i)
+  {
+    if (vectValPn[i] == 0.)
+    {
+      throw itk::ExceptionObject(__FILE__, __LINE__, "Null Eigen value !!", ITK_LOCATION);
+    }
+    const double scale = std::sqrt(std::abs(vectValPn[i]));
+    Fn.scale_column(i, 1. / scale);
+    Fn_inv.scale_row(i, scale);
+  }
+
+  /* The smallest eigenvalues of Aadj = Fn^T.Ax^-1.Fn are the inverses of
+   * the largest ones of Fn^-1.Ax.Fn^-T, which are estimated without Ax */
+  InternalMatrixType Fadj;
+  vnl_vector<double> vectValPadj;
+  this->EstimateLeadingEigenPairs(Fn_inv, Fadj, vectValPadj);
+
+  InternalMatrixType transf = Fn * Fadj;
+  transf.inplace_transpose();
+  this->m_TransformationMatrix = transf;
+
+  this->m_EigenValues.SetSize(this->GetNumberOfPrincipalComponentsRequired());
+  for (unsigned int i = 0; i < this->GetNumberOfPrincipalComponentsRequired(); ++i)
+  {
+    if (vectValPadj[i] == 0.)
+    {
+      throw itk::ExceptionObject(__FILE__, __LINE__, "Null Eigen value !!", ITK_LOCATION);
+    }
+    this->m_EigenValues[this->GetNumberOfPrincipalComponentsRequired() - 1 - i] = static_cast<RealType>(1. / vectValPadj[i]);
+  }
+}
 
 } // end of namespace otb
 
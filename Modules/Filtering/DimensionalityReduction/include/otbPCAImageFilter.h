@@ -24,6 +24,7 @@
 #include "otbMacro.h"
 #include "otbMatrixImageFilter.h"
 #include "otbNormalizeVectorImageFilter.h"
+#include "otbStreamingRandomizedCovarianceEigenImageFilter.h"
 
 
 namespace otb
@@ -44,7 +45,16 @@ enum TransformDirection
  * The internal structure of this filter is a filter-to-filter like structure.
  * The estimation of the covariance matrix has persistent capabilities...
  *
+ * When UseRandomizedSVD is on (forward transform, no given covariance nor
+ * transformation matrix), the covariance matrix is not computed: the leading
+ * principal components are estimated by
+ * StreamingRandomizedCovarianceEigenImageFilter, in
+ * NumberOfPowerIterations + 1 passes over the image costing O(N.K) per pixel
+ * instead of O(N^2), which pays off when only a few components of an image
+ * with many bands are required. The covariance matrix is then left empty.
+ *
  * \sa otbStreamingStatisticsVectorImageFilter
+ * \sa StreamingRandomizedCovarianceEigenImageFilter
  * \sa MatrixMultiplyImageFilter
  *
  * \ingroup OTBDimensionalityReduction
@@ -93,6 +103,9 @@ public:
   typedef NormalizeVectorImageFilter<TInputImage, TOutputImage> NormalizeFilterType;
   typedef typename NormalizeFilterType::Pointer NormalizeFilterPointerType;
 
+  typedef StreamingRandomizedCovarianceEigenImageFilter<InputImageType> EigenEstimatorFilterType;
+  typedef typename EigenEstimatorFilterType::Pointer                    EigenEstimatorFilterPointerType;
+
   /**
    * Set/Get the number of required largest principal components.
    * The filter produces the required number of principal components plus one outputs.
@@ -107,6 +120,14 @@ public:
   itkGetMacro(CovarianceEstimator, CovarianceEstimatorFilterType*);
   itkGetMacro(Transformer, TransformFilterType*);
 
+  /** Estimate the required components with a randomized decomposition
+   * instead of the full covariance matrix. The number of power iterations
+   * and the oversampling are set through GetEigenEstimator()->GetFilter(). */
+  itkSetMacro(UseRandomizedSVD, bool);
+  itkGetMacro(UseRandomizedSVD, bool);
+  itkBooleanMacro(UseRandomizedSVD);
+  itkGetMacro(EigenEstimator, EigenEstimatorFilterType*);
+
   itkGetMacro(GivenCovarianceMatrix, bool);
   MatrixType GetCovarianceMatrix() const
   {
@@ -173,6 +194,8 @@ public:
     /** User ignored value for the covariance estimator */
     m_CovarianceEstimator->SetUserIgnoredValue(value);
     m_CovarianceEstimator->SetIgnoreUserDefinedValue(true);
+    /** User ignored value for the randomized estimator */
+    m_EigenEstimator->SetUserIgnoredValue(value);
   }
 
 protected:
@@ -205,6 +228,7 @@ protected:
   virtual void ReverseGenerateData();
 
   void GenerateTransformationMatrix();
+  void GenerateRandomizedTransformationMatrix();
 
   /** Internal attributes */
   unsigned int m_NumberOfPrincipalComponentsRequired;
@@ -216,6 +240,7 @@ protected:
   bool         m_GivenTransformationMatrix;
   bool         m_IsTransformationMatrixForward;
   bool         m_Whitening;
+  bool         m_UseRandomizedSVD;
 
   VectorType m_MeanValues;
   VectorType m_StdDevValues;
@@ -226,6 +251,7 @@ protected:
   CovarianceEstimatorFilterPointerType m_CovarianceEstimator;
   TransformFilterPointerType           m_Transformer;
   NormalizeFilterPointerType           m_Normalizer;
+  EigenEstimatorFilterPointerType      m_EigenEstimator;
 
 private:
   PCAImageFilter(const Self&); // not implemented
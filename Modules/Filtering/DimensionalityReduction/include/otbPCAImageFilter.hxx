@@ -38,6 +38,7 @@ PCAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::PCAImageF
 
   m_NumberOfPrincipalComponentsRequired = 0;
   m_Whitening                           = true;
+  m_UseRandomizedSVD                    = false;
   m_UseNormalization                    = false;
   m_UseVarianceForNormalization         = false;
   m_GivenMeanValues                     = false;
@@ -50,7 +51,8 @@ PCAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::PCAImageF
   m_CovarianceEstimator = CovarianceEstimatorFilterType::New();
   m_Transformer         = TransformFilterType::New();
   m_Transformer->MatrixByVectorOn();
-  m_Normalizer = NormalizeFilterType::New();
+  m_Normalizer     = NormalizeFilterType::New();
+  m_EigenEstimator = EigenEstimatorFilterType::New();
 }
 
 template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
@@ -115,7 +117,11 @@ void PCAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::Forw
 {
   typename InputImageType::Pointer inputImgPtr = const_cast<InputImageType*>(this->GetInput());
 
-  if (!m_GivenTransformationMatrix)
+  if (!m_GivenTransformationMatrix && !m_GivenCovarianceMatrix && m_UseRandomizedSVD)
+  {
+    GenerateRandomizedTransformationMatrix();
+  }
+  else if (!m_GivenTransformationMatrix)
   {
     if (!m_GivenCovarianceMatrix)
     {
@@ -357,12 +363,91 @@ void PCAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::Gene
     m_TransformationMatrix = transf;
 }
 
+template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
+void PCAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::GenerateRandomizedTransformationMatrix()
+{
+  typename InputImageType::Pointer                   inputImgPtr = const_cast<InputImageType*>(this->GetInput());
+  typename EigenEstimatorFilterType::EigenFilterType* estimator   = m_EigenEstimator->GetFilter();
+
+  if (m_UseNormalization && (m_GivenMeanValues || m_GivenStdDevValues))
+  {
+    // Decompose the covariance of the data normalized with the given values
+    m_Normalizer->SetInput(inputImgPtr);
+    m_Normalizer->SetUseStdDev(m_UseVarianceForNormalization);
+
+    if (m_GivenMeanValues)
+      m_Normalizer->SetMean(m_MeanValues);
+
+    if (m_GivenStdDevValues)
+      m_Normalizer->SetStdDev(m_StdDevValues);
+
+    m_EigenEstimator->SetInput(m_Normalizer->GetOutput());
+    estimator->SetUseCorrelation(false);
+  }
+  else
+  {
+    // The first pass of the estimator gives the mean and standard deviations,
+    // so that the normalizer does not need to compute any statistics
+    m_EigenEstimator->SetInput(inputImgPtr);
+    estimator->SetUseCorrelation(m_UseNormalization && m_UseVarianceForNormalization);
+  }
+  estimator->SetNumberOfComponentsRequired(m_NumberOfPrincipalComponentsRequired);
+  m_EigenEstimator->Update();
+
+  if (m_UseNormalization)
+  {
+    if (!m_GivenMeanValues && !m_GivenStdDevValues)
+    {
+      m_MeanValues = m_EigenEstimator->GetMean();
+      m_Normalizer->SetInput(inputImgPtr);
+      m_Normalizer->SetMean(m_MeanValues);
+
+      if (m_UseVarianceForNormalization)
+      {
+        m_StdDevValues = m_EigenEstimator->GetStdDev();
+        m_Normalizer->SetStdDev(m_StdDevValues);
+      }
+      else
+      {
+        m_Normalizer->SetUseStdDev(false);
+      }
+    }
+    m_Transformer->SetInput(m_Normalizer->GetOutput());
+  }
+  else
+  {
+    m_Transformer->SetInput(inputImgPtr);
+  }
+
+  // Eigenvectors are given in columns, by decreasing eigenvalues
+  const InternalMatrixType& eigenVectors = m_EigenEstimator->GetEigenVectors();
+  InternalMatrixType        transf(m_NumberOfPrincipalComponentsRequired, eigenVectors.rows());
+  m_EigenValues.SetSize(m_NumberOfPrincipalComponentsRequired);
+  for (unsigned int c = 0; c < m_NumberOfPrincipalComponentsRequired; ++c)
+  {
+    const double eigenValue = m_EigenEstimator->GetEigenValues()[c];
+    m_EigenValues[c]        = static_cast<RealType>(eigenValue);
+
+    double scale = 1.0;
+    if (m_Whitening)
+    {
+      if (eigenValue == 0.0)
+        throw itk::ExceptionObject(__FILE__, __LINE__, "Null Eigen value !!", ITK_LOCATION);
+      scale = 1.0 / std::sqrt(eigenValue);
+    }
+    for (unsigned int i = 0; i < eigenVectors.rows(); ++i)
+      transf(c, i) = eigenVectors(i, c) * scale;
+  }
+  m_TransformationMatrix = transf;
+}
 
 template <class TInputImage, class TOutputImage, Transform::TransformDirection TDirectionOfTransformation>
 void PCAImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
 
+  os << indent << "m_UseRandomizedSVD = " << (m_UseRandomizedSVD ? "true\n" : "false\n");
+
   os << indent << "m_UseNormalization = ";
   if (m_UseNormalization)
     os << "true\n";
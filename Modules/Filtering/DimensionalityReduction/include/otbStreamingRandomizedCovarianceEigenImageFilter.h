@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingRandomizedCovarianceEigenImageFilter_h
+#define otbStreamingRandomizedCovarianceEigenImageFilter_h
+
+#include <vector>
+
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkVariableLengthVector.h"
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+
+#include <vnl/vnl_matrix.h>
+#include <vnl/vnl_vector.h>
+
+namespace otb
+{
+
+/** \class PersistentRandomizedCovarianceEigenImageFilter
+ * \brief Persistent filter estimating the leading eigenpairs of the
+ * covariance matrix of an image without computing the covariance matrix.
+ *
+ * Let C be the covariance matrix of the N bands of the image and A an
+ * optional N x N whitening matrix (identity by default). The filter
+ * estimates the K leading eigenpairs of M = A.C.A^T with the randomized
+ * range finder of Halko, Martinsson and Tropp (Finding structure with
+ * randomness, 2011). Each pass over the image computes the sketch Y = M.Q of
+ * a block Q of L = K + Oversampling vectors, so that the cost per pixel is
+ * O(N.L) instead of the O(N^2) of a full covariance estimation:
+ *
+ * - Pass 0 uses a Gaussian random block, and also estimates the mean and the
+ *   standard deviation of each band.
+ * - Each of the NumberOfPowerIterations following passes uses the
+ *   orthonormalized sketch of the previous pass, which sharpens the estimated
+ *   range when the spectrum decays slowly. These passes work on centered
+ *   pixels.
+ *
+ * Synthetize() of the last pass computes the Nystrom approximation
+ * M ~ Y.(Q^T.Y)^-1.Y^T and its eigen-decomposition, at the cost of a few
+ * dense operations on N x L matrices.
+ *
+ * Pixels are accumulated one scanline at a time, with block matrix products
+ * between the line and the random block.
+ *
+ * When UseCorrelation is on, the bands are also reduced by their standard
+ * deviation, i.e. M = A.D^-1.C.D^-1.A^T where D is the diagonal matrix of
+ * the standard deviations.
+ *
+ * The filter does not produce an image: it shall be streamed through
+ * StreamingRandomizedCovarianceEigenImageFilter, which runs all the passes.
+ *
+ * \sa StreamingRandomizedCovarianceEigenImageFilter
+ * \sa PCAImageFilter
+ *
+ * \ingroup OTBDimensionalityReduction
+ */
+template <class TInputImage>
+class ITK_EXPORT PersistentRandomizedCovarianceEigenImageFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentRandomizedCovarianceEigenImageFilter Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentRandomizedCovarianceEigenImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                           ImageType;
+  typedef typename ImageType::RegionType        RegionType;
+  typedef typename ImageType::PixelType         PixelType;
+  typedef typename ImageType::InternalPixelType InternalPixelType;
+  typedef itk::VariableLengthVector<double>     RealPixelType;
+  typedef vnl_matrix<double>                    InternalMatrixType;
+  typedef vnl_vector<double>                    InternalVectorType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+
+  /** Number of leading eigenpairs to estimate */
+  itkSetMacro(NumberOfComponentsRequired, unsigned int);
+  itkGetConstMacro(NumberOfComponentsRequired, unsigned int);
+
+  /** Number of extra random vectors used to capture the range */
+  itkSetMacro(Oversampling, unsigned int);
+  itkGetConstMacro(Oversampling, unsigned int);
+
+  /** Number of passes refining the range after the first one */
+  itkSetMacro(NumberOfPowerIterations, unsigned int);
+  itkGetConstMacro(NumberOfPowerIterations, unsigned int);
+
+  /** Seed of the random block of the first pass */
+  itkSetMacro(Seed, unsigned int);
+  itkGetConstMacro(Seed, unsigned int);
+
+  /** Decompose the correlation matrix instead of the covariance matrix */
+  itkSetMacro(UseCorrelation, bool);
+  itkGetConstMacro(UseCorrelation, bool);
+  itkBooleanMacro(UseCorrelation);
+
+  itkSetMacro(UseUnbiasedEstimator, bool);
+  itkGetConstMacro(UseUnbiasedEstimator, bool);
+
+  itkSetMacro(IgnoreInfiniteValues, bool);
+  itkGetConstMacro(IgnoreInfiniteValues, bool);
+
+  itkSetMacro(IgnoreUserDefinedValue, bool);
+  itkGetConstMacro(IgnoreUserDefinedValue, bool);
+
+  itkSetMacro(UserIgnoredValue, InternalPixelType);
+  itkGetConstMacro(UserIgnoredValue, InternalPixelType);
+
+  /** Whitening matrix A applied to the (reduced) bands. An empty matrix
+   * stands for the identity. */
+  void SetWhiteningMatrix(const InternalMatrixType& whitening)
+  {
+    m_WhiteningMatrix = whitening;
+    this->Modified();
+  }
+  itkGetConstReferenceMacro(WhiteningMatrix, InternalMatrixType);
+
+  /** Pass of the next streaming: 0 for the first pass */
+  itkSetMacro(CurrentPass, unsigned int);
+  itkGetConstMacro(CurrentPass, unsigned int);
+
+  /** Mean and standard deviation of the bands, estimated by pass 0 */
+  itkGetConstReferenceMacro(Mean, RealPixelType);
+  itkGetConstReferenceMacro(StdDev, RealPixelType);
+
+  /** Leading eigenvectors (in columns) and eigenvalues of M, by decreasing
+   * eigenvalues. Available once the last pass has been synthetized. */
+  itkGetConstReferenceMacro(EigenVectors, InternalMatrixType);
+  itkGetConstReferenceMacro(EigenValues, InternalVectorType);
+
+  /** Number of pixels used in the estimation */
+  itkGetConstMacro(NumberOfValidPixels, unsigned long);
+
+  void GenerateOutputInformation() override;
+  void AllocateOutputs() override;
+  void Reset(void) override;
+  void Synthetize(void) override;
+
+protected:
+  PersistentRandomizedCovarianceEigenImageFilter();
+  ~PersistentRandomizedCovarianceEigenImageFilter() override
+  {
+  }
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+  /** Sets the block of the next pass from its expression in the coordinates
+   * of M, i.e. m_InputBlock = D^-1.A^T.block */
+  void SetBlock(const InternalMatrixType& block);
+
+  /** Nystrom approximation from the sketch of the last pass */
+  void ComputeEigenPairs();
+
+private:
+  PersistentRandomizedCovarianceEigenImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** out (m x cols) = in (m x inner) . matrix (inner x cols), all row-major */
+  static void MultiplyBlock(const double* in, const double* matrix, double* out, unsigned int m, unsigned int inner, unsigned int cols);
+
+  /** out (inner x cols) += in^T . product, with in (m x inner) and product
+   * (m x cols), all row-major */
+  static void AccumulateTransposedProduct(const double* in, const double* product, double* out, unsigned int m, unsigned int inner, unsigned int cols);
+
+  /** Orthonormalizes the columns of a matrix (Gram-Schmidt, twice) */
+  static InternalMatrixType Orthonormalize(const InternalMatrixType& matrix);
+
+  unsigned int      m_NumberOfComponentsRequired;
+  unsigned int      m_Oversampling;
+  unsigned int      m_NumberOfPowerIterations;
+  unsigned int      m_Seed;
+  bool              m_UseCorrelation;
+  bool              m_UseUnbiasedEstimator;
+  bool              m_IgnoreInfiniteValues;
+  bool              m_IgnoreUserDefinedValue;
+  InternalPixelType m_UserIgnoredValue;
+  unsigned int      m_CurrentPass;
+
+  InternalMatrixType m_WhiteningMatrix;
+
+  /** Number of bands and of vectors of the block */
+  unsigned int m_NumberOfBands;
+  unsigned int m_BlockSize;
+
+  /** Block of the current pass, in the coordinates of M (N x L) and of the
+   * input pixels (N x L, row-major) */
+  InternalMatrixType  m_Block;
+  std::vector<double> m_InputBlock;
+
+  /** Per-thread accumulators: sketch (N x L, row-major), band sums and sums
+   * of squares, and number of valid pixels */
+  std::vector<std::vector<double>> m_ThreadSketch;
+  std::vector<std::vector<double>> m_ThreadSum;
+  std::vector<std::vector<double>> m_ThreadSumOfSquares;
+  std::vector<unsigned long>       m_ThreadCount;
+
+  RealPixelType      m_Mean;
+  RealPixelType      m_StdDev;
+  InternalMatrixType m_Sketch;
+  InternalMatrixType m_EigenVectors;
+  InternalVectorType m_EigenValues;
+  unsigned long      m_NumberOfValidPixels;
+
+  RandomGeneratorType::Pointer m_Generator;
+}; // end of class PersistentRandomizedCovarianceEigenImageFilter
+
+
+/** \class StreamingRandomizedCovarianceEigenImageFilter
+ * \brief Streams an image through PersistentRandomizedCovarianceEigenImageFilter
+ * for the NumberOfPowerIterations + 1 passes of the randomized estimation.
+ *
+ * \code
+ * typedef otb::StreamingRandomizedCovarianceEigenImageFilter<ImageType> EigenType;
+ * EigenType::Pointer eigen = EigenType::New();
+ * eigen->SetInput(reader->GetOutput());
+ * eigen->GetFilter()->SetNumberOfComponentsRequired(20);
+ * eigen->Update();
+ * EigenType::InternalMatrixType vectors = eigen->GetEigenVectors();
+ * \endcode
+ *
+ * \sa PersistentRandomizedCovarianceEigenImageFilter
+ *
+ * \ingroup OTBDimensionalityReduction
+ */
+template <class TInputImage>
+class ITK_EXPORT StreamingRandomizedCovarianceEigenImageFilter
+    : public PersistentFilterStreamingDecorator<PersistentRandomizedCovarianceEigenImageFilter<TInputImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingRandomizedCovarianceEigenImageFilter Self;
+  typedef PersistentFilterStreamingDecorator<PersistentRandomizedCovarianceEigenImageFilter<TInputImage>> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingRandomizedCovarianceEigenImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef typename Superclass::FilterType              EigenFilterType;
+  typedef typename EigenFilterType::RealPixelType      RealPixelType;
+  typedef typename EigenFilterType::InternalMatrixType InternalMatrixType;
+  typedef typename EigenFilterType::InternalVectorType InternalVectorType;
+  typedef typename EigenFilterType::InternalPixelType  InternalPixelType;
+  typedef TInputImage                                  InputImageType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType* input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType* GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  void SetUserIgnoredValue(InternalPixelType value)
+  {
+    this->GetFilter()->SetUserIgnoredValue(value);
+    this->GetFilter()->SetIgnoreUserDefinedValue(true);
+  }
+
+  const RealPixelType& GetMean() const
+  {
+    return this->GetFilter()->GetMean();
+  }
+  const RealPixelType& GetStdDev() const
+  {
+    return this->GetFilter()->GetStdDev();
+  }
+  const InternalMatrixType& GetEigenVectors() const
+  {
+    return this->GetFilter()->GetEigenVectors();
+  }
+  const InternalVectorType& GetEigenValues() const
+  {
+    return this->GetFilter()->GetEigenValues();
+  }
+
+protected:
+  /** Constructor */
+  StreamingRandomizedCovarianceEigenImageFilter()
+  {
+  }
+  /** Destructor */
+  ~StreamingRandomizedCovarianceEigenImageFilter() override
+  {
+  }
+
+  void GenerateData(void) override;
+
+private:
+  StreamingRandomizedCovarianceEigenImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingRandomizedCovarianceEigenImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,557 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingRandomizedCovarianceEigenImageFilter_hxx
+#define otbStreamingRandomizedCovarianceEigenImageFilter_hxx
+
+#include "otbStreamingRandomizedCovarianceEigenImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "itkImageScanlineConstIterator.h"
+#include "itkProgressReporter.h"
+
+#include <vnl/algo/vnl_cholesky.h>
+#include <vnl/algo/vnl_matrix_inverse.h>
+#include <vnl/algo/vnl_svd.h>
+#include <vnl/algo/vnl_symmetric_eigensystem.h>
+
+namespace otb
+{
+
+template <class TInputImage>
+PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::PersistentRandomizedCovarianceEigenImageFilter()
+  : m_NumberOfComponentsRequired(1),
+    m_Oversampling(10),
+    m_NumberOfPowerIterations(1),
+    m_Seed(0),
+    m_UseCorrelation(false),
+    m_UseUnbiasedEstimator(true),
+    m_IgnoreInfiniteValues(true),
+    m_IgnoreUserDefinedValue(false),
+    m_UserIgnoredValue(itk::NumericTraits<InternalPixelType>::Zero),
+    m_CurrentPass(0),
+    m_NumberOfBands(0),
+    m_BlockSize(0),
+    m_NumberOfValidPixels(0),
+    m_Generator(RandomGeneratorType::New())
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+  {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+    {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::AllocateOutputs()
+{
+  // Nothing to allocate: the output image is not intended to be used
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::Reset()
+{
+  const unsigned int numberOfThreads = this->GetNumberOfThreads();
+
+  if (m_CurrentPass == 0)
+  {
+    const_cast<ImageType*>(this->GetInput())->UpdateOutputInformation();
+    m_NumberOfBands = this->GetInput()->GetNumberOfComponentsPerPixel();
+
+    if (m_NumberOfComponentsRequired < 1 || m_NumberOfComponentsRequired > m_NumberOfBands)
+    {
+      itkExceptionMacro(<< "The number of components shall be between 1 and the number of bands (" << m_NumberOfBands << "), got "
+                        << m_NumberOfComponentsRequired);
+    }
+    if (!m_WhiteningMatrix.empty() && (m_WhiteningMatrix.rows() != m_NumberOfBands || m_WhiteningMatrix.cols() != m_NumberOfBands))
+    {
+      itkExceptionMacro(<< "The whitening matrix shall be " << m_NumberOfBands << " x " << m_NumberOfBands << ", got " << m_WhiteningMatrix.rows() << " x "
+                        << m_WhiteningMatrix.cols());
+    }
+    m_BlockSize = std::min(m_NumberOfComponentsRequired + m_Oversampling, m_NumberOfBands);
+
+    // Gaussian block of the first pass, drawn directly in the coordinates of
+    // the input pixels since the standard deviations are not known yet
+    m_Generator->Initialize(m_Seed);
+    m_InputBlock.resize(m_NumberOfBands * m_BlockSize);
+    for (auto& value : m_InputBlock)
+    {
+      value = m_Generator->GetNormalVariate();
+    }
+    m_Block.clear();
+    m_EigenVectors.clear();
+    m_EigenValues.clear();
+
+    m_ThreadSum.assign(numberOfThreads, std::vector<double>(m_NumberOfBands, 0.0));
+    m_ThreadSumOfSquares.assign(numberOfThreads, std::vector<double>(m_NumberOfBands, 0.0));
+  }
+  else if (m_InputBlock.empty())
+  {
+    itkExceptionMacro(<< "The first pass shall be run before pass " << m_CurrentPass);
+  }
+
+  m_ThreadSketch.assign(numberOfThreads, std::vector<double>(m_NumberOfBands * m_BlockSize, 0.0));
+  m_ThreadCount.assign(numberOfThreads, 0);
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::Synthetize()
+{
+  const unsigned int nbBands   = m_NumberOfBands;
+  const unsigned int blockSize = m_BlockSize;
+
+  InternalMatrixType sketch(nbBands, blockSize, 0.0);
+  unsigned long      count = 0;
+  for (unsigned int t = 0; t < m_ThreadSketch.size(); ++t)
+  {
+    const std::vector<double>& threadSketch = m_ThreadSketch[t];
+    for (unsigned int i = 0; i < nbBands; ++i)
+    {
+      for (unsigned int c = 0; c < blockSize; ++c)
+      {
+        sketch(i, c) += threadSketch[i * blockSize + c];
+      }
+    }
+    count += m_ThreadCount[t];
+  }
+
+  if (m_CurrentPass == 0)
+  {
+    if (count < 2)
+    {
+      itkExceptionMacro(<< "At least 2 valid pixels are needed, got " << count);
+    }
+    m_NumberOfValidPixels = count;
+
+    InternalVectorType sum(nbBands, 0.0);
+    InternalVectorType sumOfSquares(nbBands, 0.0);
+    for (unsigned int t = 0; t < m_ThreadSum.size(); ++t)
+    {
+      for (unsigned int i = 0; i < nbBands; ++i)
+      {
+        sum[i] += m_ThreadSum[t][i];
+        sumOfSquares[i] += m_ThreadSumOfSquares[t][i];
+      }
+    }
+
+    const double n           = static_cast<double>(count);
+    const double denominator = m_UseUnbiasedEstimator ? n - 1.0 : n;
+    m_Mean.SetSize(nbBands);
+    m_StdDev.SetSize(nbBands);
+    for (unsigned int i = 0; i < nbBands; ++i)
+    {
+      m_Mean[i]             = sum[i] / n;
+      const double variance = (sumOfSquares[i] - n * m_Mean[i] * m_Mean[i]) / denominator;
+      // A constant band does not contribute to the decomposition: it is not
+      // rescaled
+      m_StdDev[i] = variance > 0.0 ? std::sqrt(variance) : 1.0;
+    }
+
+    // The first pass works on raw pixels: remove N.mean.(mean^T.block)
+    for (unsigned int c = 0; c < blockSize; ++c)
+    {
+      double meanProjection = 0.0;
+      for (unsigned int i = 0; i < nbBands; ++i)
+      {
+        meanProjection += m_Mean[i] * m_InputBlock[i * blockSize + c];
+      }
+      for (unsigned int i = 0; i < nbBands; ++i)
+      {
+        sketch(i, c) -= n * m_Mean[i] * meanProjection;
+      }
+    }
+  }
+
+  // C.block, then Y = A.D^-1.C.block in the coordinates of M
+  const double denominator = m_UseUnbiasedEstimator ? m_NumberOfValidPixels - 1.0 : static_cast<double>(m_NumberOfValidPixels);
+  sketch /= denominator;
+  if (m_UseCorrelation)
+  {
+    for (unsigned int i = 0; i < nbBands; ++i)
+    {
+      sketch.scale_row(i, 1.0 / m_StdDev[i]);
+    }
+  }
+  if (!m_WhiteningMatrix.empty())
+  {
+    sketch = m_WhiteningMatrix * sketch;
+  }
+  m_Sketch = sketch;
+
+  if (m_CurrentPass == 0 && m_NumberOfPowerIterations == 0)
+  {
+    // Express the random block in the coordinates of M: block = A^-T.D.omega
+    InternalMatrixType omega(nbBands, blockSize);
+    for (unsigned int i = 0; i < nbBands; ++i)
+    {
+      for (unsigned int c = 0; c < blockSize; ++c)
+      {
+        omega(i, c) = m_InputBlock[i * blockSize + c] * (m_UseCorrelation ? m_StdDev[i] : 1.0);
+      }
+    }
+    m_Block = m_WhiteningMatrix.empty() ? omega : vnl_svd<double>(m_WhiteningMatrix.transpose()).solve(omega);
+  }
+
+  if (m_CurrentPass < m_NumberOfPowerIterations)
+  {
+    SetBlock(Orthonormalize(m_Sketch));
+  }
+  else
+  {
+    ComputeEigenPairs();
+  }
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::SetBlock(const InternalMatrixType& block)
+{
+  m_Block = block;
+
+  InternalMatrixType inputBlock = m_WhiteningMatrix.empty() ? block : m_WhiteningMatrix.transpose() * block;
+  if (m_UseCorrelation)
+  {
+    for (unsigned int i = 0; i < m_NumberOfBands; ++i)
+    {
+      inputBlock.scale_row(i, 1.0 / m_StdDev[i]);
+    }
+  }
+  m_InputBlock.assign(inputBlock.data_block(), inputBlock.data_block() + inputBlock.size());
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::ComputeEigenPairs()
+{
+  const unsigned int nbBands   = m_NumberOfBands;
+  const unsigned int blockSize = m_BlockSize;
+
+  // Orthonormal basis Q of the block and Y = M.Q
+  InternalMatrixType q = m_Block;
+  InternalMatrixType y = m_Sketch;
+  if (m_CurrentPass == 0)
+  {
+    // The random block is not orthonormal: with block = Q.R, M.Q = Y.R^-1
+    q                       = Orthonormalize(m_Block);
+    InternalMatrixType rInv = vnl_matrix_inverse<double>(q.transpose() * m_Block);
+    y                       = y * rInv;
+  }
+
+  // Nystrom approximation M ~ Y.(Q^T.Y)^-1.Y^T, computed as F.F^T with
+  // F = Y.L^-T where Q^T.Y = L.L^T. A small shift keeps the Cholesky
+  // factorization stable and is removed from the eigenvalues.
+  const double       shift = std::sqrt(static_cast<double>(nbBands)) * std::numeric_limits<double>::epsilon() * y.frobenius_norm();
+  InternalMatrixType yShifted = y + shift * q;
+  InternalMatrixType core     = q.transpose() * yShifted;
+  core                        = 0.5 * (core + core.transpose());
+
+  m_EigenVectors.set_size(nbBands, m_NumberOfComponentsRequired);
+  m_EigenValues.set_size(m_NumberOfComponentsRequired);
+
+  vnl_cholesky cholesky(core, vnl_cholesky::quiet);
+  if (cholesky.rank_deficiency() == 0)
+  {
+    InternalMatrixType lInv = vnl_matrix_inverse<double>(cholesky.lower_triangle());
+    vnl_svd<double>    svd(yShifted * lInv.transpose());
+    for (unsigned int c = 0; c < m_NumberOfComponentsRequired; ++c)
+    {
+      m_EigenValues[c] = std::max(svd.W(c) * svd.W(c) - shift, 0.0);
+      m_EigenVectors.set_column(c, svd.U().get_column(c));
+    }
+  }
+  else
+  {
+    // Q^T.M.Q is not numerically positive: fall back to the Rayleigh-Ritz
+    // approximation Q.(Q^T.M.Q).Q^T
+    InternalMatrixType identity(blockSize, blockSize);
+    identity.set_identity();
+    vnl_symmetric_eigensystem<double> eigen(core - shift * identity);
+    for (unsigned int c = 0; c < m_NumberOfComponentsRequired; ++c)
+    {
+      const unsigned int index = blockSize - 1 - c;
+      m_EigenValues[c]         = std::max(eigen.get_eigenvalue(index), 0.0);
+      m_EigenVectors.set_column(c, q * eigen.get_eigenvector(index));
+    }
+  }
+
+  // Deterministic signs: the largest component of each eigenvector is positive
+  for (unsigned int c = 0; c < m_NumberOfComponentsRequired; ++c)
+  {
+    unsigned int largest = 0;
+    for (unsigned int i = 1; i < nbBands; ++i)
+    {
+      if (std::abs(m_EigenVectors(i, c)) > std::abs(m_EigenVectors(largest, c)))
+      {
+        largest = i;
+      }
+    }
+    if (m_EigenVectors(largest, c) < 0.0)
+    {
+      m_EigenVectors.scale_column(c, -1.0);
+    }
+  }
+}
+
+template <class TInputImage>
+typename PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::InternalMatrixType
+PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::Orthonormalize(const InternalMatrixType& matrix)
+{
+  InternalMatrixType q(matrix);
+  unsigned int       basis = 0;
+  for (unsigned int c = 0; c < q.cols(); ++c)
+  {
+    InternalVectorType column        = q.get_column(c);
+    const double       initialNorm   = column.two_norm();
+    double             norm          = 0.0;
+    bool               replaceColumn = initialNorm == 0.0;
+    do
+    {
+      if (replaceColumn)
+      {
+        // The column lies in the span of the previous ones: complete the
+        // basis with a canonical vector instead
+        column.fill(0.0);
+        column[basis++] = 1.0;
+      }
+      // Gram-Schmidt twice, for the orthogonality to hold in floating point
+      for (unsigned int pass = 0; pass < 2; ++pass)
+      {
+        for (unsigned int p = 0; p < c; ++p)
+        {
+          const InternalVectorType previous = q.get_column(p);
+          column -= dot_product(previous, column) * previous;
+        }
+      }
+      norm          = column.two_norm();
+      replaceColumn = !(norm > 1e-10 * (replaceColumn ? 1.0 : initialNorm));
+    } while (replaceColumn && basis < q.rows());
+    q.set_column(c, column / norm);
+  }
+  return q;
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::MultiplyBlock(const double* in, const double* matrix, double* out, unsigned int m,
+                                                                                unsigned int inner, unsigned int cols)
+{
+  std::fill(out, out + m * cols, 0.0);
+  unsigned int p = 0;
+  for (; p + 4 <= m; p += 4)
+  {
+    const double* in0  = in + p * inner;
+    const double* in1  = in0 + inner;
+    const double* in2  = in1 + inner;
+    const double* in3  = in2 + inner;
+    double*       out0 = out + p * cols;
+    double*       out1 = out0 + cols;
+    double*       out2 = out1 + cols;
+    double*       out3 = out2 + cols;
+    for (unsigned int i = 0; i < inner; ++i)
+    {
+      const double* row = matrix + i * cols;
+      const double  a0  = in0[i], a1 = in1[i], a2 = in2[i], a3 = in3[i];
+      for (unsigned int j = 0; j < cols; ++j)
+      {
+        out0[j] += a0 * row[j];
+        out1[j] += a1 * row[j];
+        out2[j] += a2 * row[j];
+        out3[j] += a3 * row[j];
+      }
+    }
+  }
+  for (; p < m; ++p)
+  {
+    const double* in0  = in + p * inner;
+    double*       out0 = out + p * cols;
+    for (unsigned int i = 0; i < inner; ++i)
+    {
+      const double* row = matrix + i * cols;
+      const double  a0  = in0[i];
+      for (unsigned int j = 0; j < cols; ++j)
+      {
+        out0[j] += a0 * row[j];
+      }
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::AccumulateTransposedProduct(const double* in, const double* product, double* out,
+                                                                                              unsigned int m, unsigned int inner, unsigned int cols)
+{
+  // Four pixels at a time, so that each row of the output is loaded once
+  // for four pixels
+  unsigned int p = 0;
+  for (; p + 4 <= m; p += 4)
+  {
+    const double* in0 = in + p * inner;
+    const double* in1 = in0 + inner;
+    const double* in2 = in1 + inner;
+    const double* in3 = in2 + inner;
+    const double* pr0 = product + p * cols;
+    const double* pr1 = pr0 + cols;
+    const double* pr2 = pr1 + cols;
+    const double* pr3 = pr2 + cols;
+    for (unsigned int i = 0; i < inner; ++i)
+    {
+      double*      row = out + i * cols;
+      const double a0  = in0[i], a1 = in1[i], a2 = in2[i], a3 = in3[i];
+      for (unsigned int j = 0; j < cols; ++j)
+      {
+        row[j] += a0 * pr0[j] + a1 * pr1[j] + a2 * pr2[j] + a3 * pr3[j];
+      }
+    }
+  }
+  for (; p < m; ++p)
+  {
+    const double* in0 = in + p * inner;
+    const double* pr0 = product + p * cols;
+    for (unsigned int i = 0; i < inner; ++i)
+    {
+      double*      row = out + i * cols;
+      const double a0  = in0[i];
+      for (unsigned int j = 0; j < cols; ++j)
+      {
+        row[j] += a0 * pr0[j];
+      }
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const unsigned int nbBands   = m_NumberOfBands;
+  const unsigned int blockSize = m_BlockSize;
+  const unsigned int lineSize  = outputRegionForThread.GetSize(0);
+  const bool         firstPass = m_CurrentPass == 0;
+
+  std::vector<double> line(lineSize * nbBands);
+  std::vector<double> product(lineSize * blockSize);
+  double*             sketch       = m_ThreadSketch[threadId].data();
+  double*             sum          = firstPass ? m_ThreadSum[threadId].data() : nullptr;
+  double*             sumOfSquares = firstPass ? m_ThreadSumOfSquares[threadId].data() : nullptr;
+  const double*       mean         = firstPass ? nullptr : m_Mean.GetDataPointer();
+
+  itk::ImageScanlineConstIterator<ImageType> it(this->GetInput(), outputRegionForThread);
+  while (!it.IsAtEnd())
+  {
+    // Gather the valid pixels of the line, centered after the first pass
+    unsigned int nbValid = 0;
+    while (!it.IsAtEndOfLine())
+    {
+      const PixelType& pixel = it.Get();
+
+      double finiteProbe = 0.0;
+      bool   userProbe   = m_IgnoreUserDefinedValue;
+      for (unsigned int i = 0; i < nbBands; ++i)
+      {
+        finiteProbe += static_cast<double>(pixel[i]);
+        userProbe = userProbe && (pixel[i] == m_UserIgnoredValue);
+      }
+
+      if (!(m_IgnoreInfiniteValues && !std::isfinite(finiteProbe)) && !userProbe)
+      {
+        double* row = line.data() + nbValid * nbBands;
+        if (firstPass)
+        {
+          for (unsigned int i = 0; i < nbBands; ++i)
+          {
+            const double value = static_cast<double>(pixel[i]);
+            row[i]             = value;
+            sum[i] += value;
+            sumOfSquares[i] += value * value;
+          }
+        }
+        else
+        {
+          for (unsigned int i = 0; i < nbBands; ++i)
+          {
+            row[i] = static_cast<double>(pixel[i]) - mean[i];
+          }
+        }
+        ++nbValid;
+      }
+      ++it;
+      progress.CompletedPixel();
+    }
+
+    // sketch += line^T.(line.block)
+    if (nbValid > 0)
+    {
+      MultiplyBlock(line.data(), m_InputBlock.data(), product.data(), nbValid, nbBands, blockSize);
+      AccumulateTransposedProduct(line.data(), product.data(), sketch, nbValid, nbBands, blockSize);
+      m_ThreadCount[threadId] += nbValid;
+    }
+    it.NextLine();
+  }
+}
+
+template <class TInputImage>
+void PersistentRandomizedCovarianceEigenImageFilter<TInputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfComponentsRequired: " << m_NumberOfComponentsRequired << std::endl;
+  os << indent << "Oversampling: " << m_Oversampling << std::endl;
+  os << indent << "NumberOfPowerIterations: " << m_NumberOfPowerIterations << std::endl;
+  os << indent << "Seed: " << m_Seed << std::endl;
+  os << indent << "UseCorrelation: " << m_UseCorrelation << std::endl;
+  os << indent << "CurrentPass: " << m_CurrentPass << std::endl;
+  os << indent << "NumberOfValidPixels: " << m_NumberOfValidPixels << std::endl;
+  if (!m_EigenValues.empty())
+  {
+    os << indent << "EigenValues: " << m_EigenValues << std::endl;
+  }
+}
+
+template <class TInputImage>
+void StreamingRandomizedCovarianceEigenImageFilter<TInputImage>::GenerateData()
+{
+  EigenFilterType* filter = this->GetFilter();
+  this->GetStreamer()->SetInput(filter->GetOutput());
+
+  for (unsigned int pass = 0; pass <= filter->GetNumberOfPowerIterations(); ++pass)
+  {
+    // Each pass streams the whole image again
+    filter->SetCurrentPass(pass);
+    filter->Modified();
+    filter->Reset();
+    this->GetStreamer()->Update();
+    filter->Synthetize();
+  }
+}
+
+} // end namespace otb
+
+#endif
@@ -23,6 +23,7 @@
 void RegisterTests()
 {
   REGISTER_TEST(otbFastICAImageFilterTest);
+  REGISTER_TEST(otbFastICAImageFilterSamplesTest);
   REGISTER_TEST(otbNormalizeInnerProductPCAImageFilter);
   REGISTER_TEST(otbMaximumAutocorrelationFactorImageFilter);
   REGISTER_TEST(otbMNFImageFilterTest);
@@ -34,5 +35,6 @@ void RegisterTests()
   REGISTER_TEST(otbAngularProjectionImageFilterTest);
   REGISTER_TEST(otbLocalActivityVectorImageFilterTest);
   REGISTER_TEST(otbAngularProjectionBinaryImageFilterTest);
+  REGISTER_TEST(otbStreamingRandomizedCovarianceEigenImageFilterTest);
   // REGISTER_TEST(otbSparseWvltToAngleMapperListFilterTest);
 }
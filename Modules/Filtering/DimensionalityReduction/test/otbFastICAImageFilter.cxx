@@ -94,3 +94,72 @@ int otbFastICAImageFilterTest(int, char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbFastICAImageFilterSamplesTest(int, char* argv[])
+{
+  const unsigned int nbComponents = 3;
+  const unsigned int nbIterations = 20;
+
+  typedef otb::VectorImage<double, 2>     ImageType;
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer                     reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+  reader->UpdateOutputInformation();
+  const unsigned long nbPixels = reader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+
+  typedef otb::FastICAImageFilter<ImageType, ImageType, otb::Transform::FORWARD> FilterType;
+  FilterType::Pointer streamed = FilterType::New();
+  streamed->SetInput(reader->GetOutput());
+  streamed->SetNumberOfPrincipalComponentsRequired(nbComponents);
+  streamed->SetNumberOfIterations(nbIterations);
+  streamed->GetOutput()->UpdateOutputInformation();
+
+  // A reservoir holding all the pixels gives the streamed iterations back
+  FilterType::Pointer inMemory = FilterType::New();
+  inMemory->SetInput(reader->GetOutput());
+  inMemory->SetNumberOfPrincipalComponentsRequired(nbComponents);
+  inMemory->SetNumberOfIterations(nbIterations);
+  inMemory->SetNumberOfSamples(nbPixels);
+  inMemory->GetOutput()->UpdateOutputInformation();
+
+  const FilterType::MatrixType streamedW = streamed->GetTransformationMatrix();
+  const FilterType::MatrixType inMemoryW = inMemory->GetTransformationMatrix();
+  for (unsigned int i = 0; i < nbComponents; ++i)
+  {
+    for (unsigned int j = 0; j < nbComponents; ++j)
+    {
+      if (std::abs(streamedW(i, j) - inMemoryW(i, j)) > 1e-6)
+      {
+        std::cerr << "In-memory unmixing matrix" << std::endl
+                  << inMemoryW << "differs from the streamed one" << std::endl
+                  << streamedW;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // A random subset still gives an orthonormal unmixing matrix
+  FilterType::Pointer sampled = FilterType::New();
+  sampled->SetInput(reader->GetOutput());
+  sampled->SetNumberOfPrincipalComponentsRequired(nbComponents);
+  sampled->SetNumberOfIterations(nbIterations);
+  sampled->SetNumberOfSamples(nbPixels / 4);
+  sampled->GetSampler()->GetFilter()->SetSeed(42);
+  sampled->GetOutput()->UpdateOutputInformation();
+
+  const FilterType::MatrixType::InternalMatrixType W   = sampled->GetTransformationMatrix().GetVnlMatrix();
+  const FilterType::MatrixType::InternalMatrixType WWt = W * W.transpose();
+  for (unsigned int i = 0; i < nbComponents; ++i)
+  {
+    for (unsigned int j = 0; j < nbComponents; ++j)
+    {
+      if (std::abs(WWt(i, j) - (i == j ? 1. : 0.)) > 1e-6)
+      {
+        std::cerr << "Unmixing matrix estimated on samples is not orthonormal" << std::endl << W;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
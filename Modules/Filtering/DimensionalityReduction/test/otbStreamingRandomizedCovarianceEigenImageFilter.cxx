@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+
+#include "otbPCAImageFilter.h"
+#include "otbMNFImageFilter.h"
+#include "otbNAPCAImageFilter.h"
+#include "otbLocalActivityVectorImageFilter.h"
+
+namespace
+{
+/** Compares the leading eigenvalues and the rows of the transformation
+ * matrices (up to their sign) of a randomized and a dense decomposition */
+template <class TVector, class TMatrix>
+bool CompareDecompositions(const char* name, const TVector& randomizedValues, const TMatrix& randomizedMatrix, const TVector& denseValues,
+                           const TMatrix& denseMatrix, unsigned int nbComponents)
+{
+  bool ok = true;
+  for (unsigned int c = 0; c < nbComponents; ++c)
+  {
+    const double valueError = std::abs(randomizedValues[c] - denseValues[c]) / std::abs(denseValues[c]);
+
+    double dot = 0., randomizedNorm = 0., denseNorm = 0.;
+    for (unsigned int i = 0; i < denseMatrix.Cols(); ++i)
+    {
+      dot += randomizedMatrix(c, i) * denseMatrix(c, i);
+      randomizedNorm += randomizedMatrix(c, i) * randomizedMatrix(c, i);
+      denseNorm += denseMatrix(c, i) * denseMatrix(c, i);
+    }
+    const double cosine = std::abs(dot) / std::sqrt(randomizedNorm * denseNorm);
+
+    std::cout << name << " component " << c << ": eigenvalue " << randomizedValues[c] << " (dense " << denseValues[c] << "), |cos| " << cosine << std::endl;
+    if (valueError > 1e-4 || cosine < 1. - 1e-3)
+    {
+      std::cerr << name << " component " << c << " differs from the dense decomposition" << std::endl;
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+/** Compares the components of a pixel of the outputs of a randomized and a
+ * dense transform, up to their sign */
+template <class TImage>
+bool CompareOutputs(const char* name, const TImage* randomizedOutput, const TImage* denseOutput, unsigned int nbComponents)
+{
+  typename TImage::IndexType index;
+  index.Fill(5);
+  const typename TImage::PixelType randomizedPixel = randomizedOutput->GetPixel(index);
+  const typename TImage::PixelType densePixel      = denseOutput->GetPixel(index);
+
+  bool ok = true;
+  for (unsigned int c = 0; c < nbComponents; ++c)
+  {
+    if (std::abs(std::abs(randomizedPixel[c]) - std::abs(densePixel[c])) > 1e-2 * (1. + std::abs(densePixel[c])))
+    {
+      std::cerr << name << " output component " << c << " differs: " << randomizedPixel[c] << " (dense " << densePixel[c] << ")" << std::endl;
+      ok = false;
+    }
+  }
+  return ok;
+}
+}
+
+int otbStreamingRandomizedCovarianceEigenImageFilterTest(int itkNotUsed(argc), char* argv[])
+{
+  const unsigned int nbComponents = atoi(argv[2]);
+
+  typedef otb::VectorImage<double, 2>     ImageType;
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer                     reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+
+  // PCA of the correlation matrix
+  typedef otb::PCAImageFilter<ImageType, ImageType, otb::Transform::FORWARD> PCAFilterType;
+  PCAFilterType::Pointer densePCA = PCAFilterType::New();
+  densePCA->SetInput(reader->GetOutput());
+  densePCA->SetWhitening(false);
+  densePCA->SetUseNormalization(true);
+  densePCA->GetOutput()->UpdateOutputInformation();
+
+  PCAFilterType::Pointer randomizedPCA = PCAFilterType::New();
+  randomizedPCA->SetInput(reader->GetOutput());
+  randomizedPCA->SetNumberOfPrincipalComponentsRequired(nbComponents);
+  randomizedPCA->SetWhitening(false);
+  randomizedPCA->SetUseNormalization(true);
+  randomizedPCA->UseRandomizedSVDOn();
+  randomizedPCA->GetEigenEstimator()->GetFilter()->SetNumberOfPowerIterations(2);
+  randomizedPCA->GetOutput()->UpdateOutputInformation();
+
+  bool ok = CompareDecompositions("PCA", randomizedPCA->GetEigenValues(), randomizedPCA->GetTransformationMatrix(), densePCA->GetEigenValues(),
+                                  densePCA->GetTransformationMatrix(), nbComponents);
+
+  for (unsigned int i = 0; i < reader->GetOutput()->GetNumberOfComponentsPerPixel(); ++i)
+  {
+    if (std::abs(randomizedPCA->GetMeanValues()[i] - densePCA->GetMeanValues()[i]) > 1e-6 * std::abs(densePCA->GetMeanValues()[i]) ||
+        std::abs(randomizedPCA->GetStdDevValues()[i] - densePCA->GetStdDevValues()[i]) > 1e-6 * densePCA->GetStdDevValues()[i])
+    {
+      std::cerr << "PCA normalization of band " << i << " differs: mean " << randomizedPCA->GetMeanValues()[i] << " (dense "
+                << densePCA->GetMeanValues()[i] << "), stddev " << randomizedPCA->GetStdDevValues()[i] << " (dense " << densePCA->GetStdDevValues()[i]
+                << ")" << std::endl;
+      ok = false;
+    }
+  }
+
+  // The forward transforms agree on the output pixels
+  randomizedPCA->GetOutput()->SetRequestedRegionToLargestPossibleRegion();
+  randomizedPCA->Update();
+  densePCA->Update();
+  ok = CompareOutputs("PCA", randomizedPCA->GetOutput(), densePCA->GetOutput(), nbComponents) && ok;
+
+  // MNF, where the randomized decomposition works on noise-whitened data
+  typedef otb::LocalActivityVectorImageFilter<ImageType, ImageType> NoiseFilterType;
+  typedef otb::MNFImageFilter<ImageType, ImageType, NoiseFilterType, otb::Transform::FORWARD> MNFFilterType;
+  NoiseFilterType::RadiusType radius = {{1, 1}};
+
+  MNFFilterType::Pointer denseMNF = MNFFilterType::New();
+  denseMNF->SetInput(reader->GetOutput());
+  denseMNF->GetNoiseImageFilter()->SetRadius(radius);
+  denseMNF->GetOutput()->UpdateOutputInformation();
+
+  MNFFilterType::Pointer randomizedMNF = MNFFilterType::New();
+  randomizedMNF->SetInput(reader->GetOutput());
+  randomizedMNF->SetNumberOfPrincipalComponentsRequired(nbComponents);
+  randomizedMNF->GetNoiseImageFilter()->SetRadius(radius);
+  randomizedMNF->UseRandomizedSVDOn();
+  randomizedMNF->GetEigenEstimator()->GetFilter()->SetNumberOfPowerIterations(2);
+  randomizedMNF->GetOutput()->UpdateOutputInformation();
+
+  ok = CompareDecompositions("MNF", randomizedMNF->GetEigenValues(), randomizedMNF->GetTransformationMatrix(), denseMNF->GetEigenValues(),
+                             denseMNF->GetTransformationMatrix(), nbComponents) &&
+       ok;
+
+  // NAPCA, whose leading components are the smallest eigenvalues of the
+  // adjusted inverse covariance: the randomized decomposition estimates the
+  // largest ones of its inverse and reports their inverses, in the order
+  // of the dense filter
+  typedef otb::NAPCAImageFilter<ImageType, ImageType, NoiseFilterType, otb::Transform::FORWARD> NAPCAFilterType;
+
+  NAPCAFilterType::Pointer denseNAPCA = NAPCAFilterType::New();
+  denseNAPCA->SetInput(reader->GetOutput());
+  denseNAPCA->SetNumberOfPrincipalComponentsRequired(nbComponents);
+  denseNAPCA->GetNoiseImageFilter()->SetRadius(radius);
+  denseNAPCA->GetOutput()->UpdateOutputInformation();
+
+  NAPCAFilterType::Pointer randomizedNAPCA = NAPCAFilterType::New();
+  randomizedNAPCA->SetInput(reader->GetOutput());
+  randomizedNAPCA->SetNumberOfPrincipalComponentsRequired(nbComponents);
+  randomizedNAPCA->GetNoiseImageFilter()->SetRadius(radius);
+  randomizedNAPCA->UseRandomizedSVDOn();
+  randomizedNAPCA->GetEigenEstimator()->GetFilter()->SetNumberOfPowerIterations(2);
+  randomizedNAPCA->GetOutput()->UpdateOutputInformation();
+
+  ok = CompareDecompositions("NAPCA", randomizedNAPCA->GetEigenValues(), randomizedNAPCA->GetTransformationMatrix(), denseNAPCA->GetEigenValues(),
+                             denseNAPCA->GetTransformationMatrix(), nbComponents) &&
+       ok;
+
+  randomizedNAPCA->GetOutput()->SetRequestedRegionToLargestPossibleRegion();
+  randomizedNAPCA->Update();
+  denseNAPCA->Update();
+  ok = CompareOutputs("NAPCA", randomizedNAPCA->GetOutput(), denseNAPCA->GetOutput(), nbComponents) && ok;
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
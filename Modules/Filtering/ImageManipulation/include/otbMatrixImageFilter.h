@@ -23,6 +23,7 @@
 
 #include "itkImageToImageFilter.h"
 #include "otbMath.h"
+#include <vector>
 
 namespace otb
 {
@@ -42,6 +43,11 @@ namespace otb
  * For example, if the image has 2 bands, the matrix is \f$ \begin{pmatrix} \alpha & \beta \\ \gama & \delta \end{pmatrix} \f$
  * The pixel \f$ [a, b] \f$ will give the output pixel \f$ [\alpha.a + \beta.b, \gamma.a + \delta.b  ]. \f$
  *
+ * The image is processed one scanline at a time: the pixels of a line are
+ * gathered in a contiguous buffer and multiplied at once by the matrix, so
+ * that the matrix coefficients are reused across several pixels instead of
+ * being reloaded for each of them.
+ *
  *
  * \ingroup OTBImageManipulation
  */
@@ -117,6 +123,9 @@ protected:
    */
   void GenerateOutputInformation() override;
 
+  /** Lay out the matrix for the scanline products */
+  void BeforeThreadedGenerateData() override;
+
   /** MatrixImageFilter can be implemented for a multithreaded filter treatment.
    * Thus, this implementation give the ThreadedGenerateData() method.
    * that is called for each process thread. Image datas are automatically allocated
@@ -138,6 +147,10 @@ private:
       Otherwise the applied operation is  \f$ p . M \f$ where p is the pixel represented as a row vector.
   */
   bool m_MatrixByVector;
+
+  /** Matrix laid out as (input size x output size), row-major, so that a
+   * line of pixels is multiplied by it as a matrix-matrix product */
+  std::vector<InputRealType> m_LineMatrix;
 };
 } // end namespace otb
 
@@ -22,9 +22,12 @@
 #define otbMatrixImageFilter_hxx
 
 #include "otbMatrixImageFilter.h"
-#include "itkImageRegionIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 
+#include <algorithm>
+
 namespace otb
 {
 
@@ -71,6 +74,22 @@ void MatrixImageFilter<TInputImage, TOutputImage, TMatrix>::GenerateOutputInform
   }
 }
 
+template <class TInputImage, class TOutputImage, class TMatrix>
+void MatrixImageFilter<TInputImage, TOutputImage, TMatrix>::BeforeThreadedGenerateData()
+{
+  const unsigned int inSize  = m_MatrixByVector ? m_Matrix.cols() : m_Matrix.rows();
+  const unsigned int outSize = m_MatrixByVector ? m_Matrix.rows() : m_Matrix.cols();
+
+  m_LineMatrix.resize(inSize * outSize);
+  for (unsigned int i = 0; i < inSize; ++i)
+  {
+    for (unsigned int j = 0; j < outSize; ++j)
+    {
+      m_LineMatrix[i * outSize + j] = static_cast<InputRealType>(m_MatrixByVector ? m_Matrix(j, i) : m_Matrix(i, j));
+    }
+  }
+}
+
 template <class TInputImage, class TOutputImage, class TMatrix>
 void MatrixImageFilter<TInputImage, TOutputImage, TMatrix>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId)
 {
@@ -78,44 +97,97 @@ void MatrixImageFilter<TInputImage, TOutputImage, TMatrix>::ThreadedGenerateData
   typename OutputImageType::Pointer     outputPtr = this->GetOutput();
   typename InputImageType::ConstPointer inputPtr  = this->GetInput();
 
-  typename itk::ImageRegionConstIterator<InputImageType> inIt(inputPtr, outputRegionForThread);
-  itk::ImageRegionIterator<OutputImageType>              outIt(outputPtr, outputRegionForThread);
-
+  itk::ImageScanlineConstIterator<InputImageType> inIt(inputPtr, outputRegionForThread);
+  itk::ImageScanlineIterator<OutputImageType>     outIt(outputPtr, outputRegionForThread);
 
   // support progress methods/callbacks
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
-  inIt.GoToBegin();
-  outIt.GoToBegin();
+  const unsigned int   inSize   = m_MatrixByVector ? m_Matrix.cols() : m_Matrix.rows();
+  const unsigned int   outSize  = m_MatrixByVector ? m_Matrix.rows() : m_Matrix.cols();
+  const unsigned int   lineSize = outputRegionForThread.GetSize(0);
+  const InputRealType* matrix   = m_LineMatrix.data();
 
-  const unsigned int inSize  = m_MatrixByVector ? m_Matrix.cols() : m_Matrix.rows();
-  const unsigned int outSize = m_MatrixByVector ? m_Matrix.rows() : m_Matrix.cols();
+  std::vector<InputRealType> inLine(lineSize * inSize);
+  std::vector<InputRealType> outLine(lineSize * outSize);
 
-  VectorType inVect(inSize, InputRealType(0.));
-  VectorType outVect(outSize, InputRealType(0.));
+  OutputPixelType outPix;
+  outPix.SetSize(outSize);
 
   while (!outIt.IsAtEnd())
   {
-    const InputPixelType& inPix = inIt.Get();
-    OutputPixelType       outPix;
-    outPix.SetSize(outSize);
-
-    for (unsigned int i = 0; i < inSize; ++i)
+    // Gather the line
+    InputRealType* in = inLine.data();
+    while (!inIt.IsAtEndOfLine())
     {
-      inVect[i] = static_cast<InputRealType>(inPix[i]);
+      const InputPixelType& inPix = inIt.Get();
+      for (unsigned int i = 0; i < inSize; ++i)
+      {
+        in[i] = static_cast<InputRealType>(inPix[i]);
+      }
+      in += inSize;
+      ++inIt;
     }
 
-    outVect = m_MatrixByVector ? m_Matrix * inVect : inVect * m_Matrix;
+    // outLine = inLine . matrix, four pixels at a time so that each row of
+    // the matrix is loaded once for four pixels. The accumulation order over
+    // the input components is the same as a matrix-vector product.
+    std::fill(outLine.begin(), outLine.end(), InputRealType(0.));
+    unsigned int p = 0;
+    for (; p + 4 <= lineSize; p += 4)
+    {
+      const InputRealType* in0  = inLine.data() + p * inSize;
+      const InputRealType* in1  = in0 + inSize;
+      const InputRealType* in2  = in1 + inSize;
+      const InputRealType* in3  = in2 + inSize;
+      InputRealType*       out0 = outLine.data() + p * outSize;
+      InputRealType*       out1 = out0 + outSize;
+      InputRealType*       out2 = out1 + outSize;
+      InputRealType*       out3 = out2 + outSize;
+      for (unsigned int i = 0; i < inSize; ++i)
+      {
+        const InputRealType* row = matrix + i * outSize;
+        const InputRealType  a0  = in0[i], a1 = in1[i], a2 = in2[i], a3 = in3[i];
+        for (unsigned int j = 0; j < outSize; ++j)
+        {
+          out0[j] += a0 * row[j];
+          out1[j] += a1 * row[j];
+          out2[j] += a2 * row[j];
+          out3[j] += a3 * row[j];
+        }
+      }
+    }
+    for (; p < lineSize; ++p)
+    {
+      const InputRealType* in0  = inLine.data() + p * inSize;
+      InputRealType*       out0 = outLine.data() + p * outSize;
+      for (unsigned int i = 0; i < inSize; ++i)
+      {
+        const InputRealType* row = matrix + i * outSize;
+        const InputRealType  a0  = in0[i];
+        for (unsigned int j = 0; j < outSize; ++j)
+        {
+          out0[j] += a0 * row[j];
+        }
+      }
+    }
 
-    for (unsigned int i = 0; i < outSize; ++i)
+    // Scatter the line
+    const InputRealType* out = outLine.data();
+    while (!outIt.IsAtEndOfLine())
     {
-      outPix[i] = static_cast<OutputInternalPixelType>(outVect[i]);
+      for (unsigned int j = 0; j < outSize; ++j)
+      {
+        outPix[j] = static_cast<OutputInternalPixelType>(out[j]);
+      }
+      outIt.Set(outPix);
+      out += outSize;
+      ++outIt;
+      progress.CompletedPixel();
     }
-    outIt.Set(outPix);
 
-    ++inIt;
-    ++outIt;
-    progress.CompletedPixel();
+    inIt.NextLine();
+    outIt.NextLine();
   }
 }
 
@@ -28,6 +28,7 @@
 #include "itkArray.h"
 
 #include "otbParser.h"
+#include "otbPipelineBranchScheduler.h"
 #include <string>
 
 namespace otb
@@ -131,6 +132,9 @@ protected:
   ~BandMathImageFilter() override;
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
+  /** Updates the inputs produced by independent pipelines concurrently */
+  void UpdateOutputData(itk::DataObject* output) override;
+
   void BeforeThreadedGenerateData() override;
   void ThreadedGenerateData(const ImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
   void AfterThreadedGenerateData() override;
@@ -69,6 +69,14 @@ void BandMathImageFilter<TImage>::PrintSelf(std::ostream& os, itk::Indent indent
   os << indent << "itk::NumericTraits<PixelType>::max()  :             " << itk::NumericTraits<PixelType>::max() << std::endl;
 }
 
+template <class TImage>
+void BandMathImageFilter<TImage>::UpdateOutputData(itk::DataObject* output)
+{
+  // The usual sequential update then finds these inputs up-to-date
+  PipelineBranchScheduler::UpdateInputs(this);
+  Superclass::UpdateOutputData(output);
+}
+
 template <class TImage>
 void BandMathImageFilter<TImage>::SetNthInput(DataObjectPointerArraySizeType idx, const ImageType* image)
 {
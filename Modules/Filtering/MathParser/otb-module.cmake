@@ -28,13 +28,13 @@ otb_module(OTBMathParser
     OTBITK
     OTBImageManipulation
     OTBMuParser
+    OTBObjectList
     OTBPath
     OTBVectorDataBase
 
   TEST_DEPENDS
     OTBImageBase
     OTBImageIO
-    OTBObjectList
     OTBProjection
     OTBTestKernel
     OTBVectorDataIO
@@ -29,6 +29,7 @@
 
 #include "otbStreamingStatisticsVectorImageFilter.h"
 #include "otbParserX.h"
+#include "otbPipelineBranchScheduler.h"
 
 #include <vector>
 #include <string>
@@ -141,6 +142,9 @@ protected:
   ~BandMathXImageFilter() override;
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
+  /** Updates the inputs produced by independent pipelines concurrently */
+  void UpdateOutputData(itk::DataObject* output) override;
+
   void GenerateOutputInformation() override;
   void GenerateInputRequestedRegion() override;
 
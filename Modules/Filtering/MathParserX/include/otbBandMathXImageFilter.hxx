@@ -105,6 +105,14 @@ void BandMathXImageFilter<TImage>::PrintSelf(std::ostream& os, itk::Indent inden
   os << indent << "itk::NumericTraits<typename PixelValueType>::max()  :             " << itk::NumericTraits<PixelValueType>::max() << std::endl;
 }
 
+template <class TImage>
+void BandMathXImageFilter<TImage>::UpdateOutputData(itk::DataObject* output)
+{
+  // The usual sequential update then finds these inputs up-to-date
+  PipelineBranchScheduler::UpdateInputs(this);
+  Superclass::UpdateOutputData(output);
+}
+
 template <class TImage>
 void BandMathXImageFilter<TImage>::SetNthInput(DataObjectPointerArraySizeType idx, const ImageType* image)
 {
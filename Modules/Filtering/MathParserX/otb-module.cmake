@@ -25,6 +25,7 @@ otb_module(OTBMathParserX
     OTBCommon
     OTBITK
     OTBMuParserX
+    OTBObjectList
     OTBStatistics
 
   TEST_DEPENDS
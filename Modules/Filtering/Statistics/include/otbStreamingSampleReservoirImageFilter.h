@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingSampleReservoirImageFilter_h
+#define otbStreamingSampleReservoirImageFilter_h
+
+#include <vector>
+
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+
+namespace otb
+{
+
+/** \class PersistentSampleReservoirImageFilter
+ * \brief Persistent filter drawing a uniform random subset of the pixels of
+ * an image, one streaming division at a time.
+ *
+ * The pixels are drawn with reservoir sampling (Vitter, Random sampling with
+ * a reservoir, 1985): after a single pass, each pixel of the image has the
+ * same probability to be part of the ReservoirSize samples, whatever the
+ * streaming divisions. When the image has less pixels than ReservoirSize,
+ * all its pixels are kept, in their scanning order.
+ *
+ * Pixels with a non-finite component are skipped.
+ *
+ * The samples are packed in a single buffer, one pixel after the other, so
+ * that they can be processed in memory without further copies.
+ *
+ * The filter does not produce an image: it shall be streamed through
+ * StreamingSampleReservoirImageFilter.
+ *
+ * \sa StreamingSampleReservoirImageFilter
+ *
+ * \ingroup OTBStatistics
+ */
+template <class TInputImage>
+class ITK_EXPORT PersistentSampleReservoirImageFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentSampleReservoirImageFilter Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentSampleReservoirImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                    ImageType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef typename ImageType::PixelType  PixelType;
+  typedef std::vector<double>            SampleBufferType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+
+  /** Maximum number of samples kept */
+  itkSetMacro(ReservoirSize, unsigned long);
+  itkGetConstMacro(ReservoirSize, unsigned long);
+
+  /** Seed of the random generator */
+  itkSetMacro(Seed, unsigned int);
+  itkGetConstMacro(Seed, unsigned int);
+
+  /** Packed samples: component c of sample s is at s * NumberOfComponents + c */
+  itkGetConstReferenceMacro(Samples, SampleBufferType);
+
+  /** Number of components of each sample */
+  itkGetConstMacro(NumberOfComponents, unsigned int);
+
+  /** Number of samples in the reservoir */
+  unsigned long GetNumberOfSamples() const
+  {
+    return m_NumberOfComponents > 0 ? m_Samples.size() / m_NumberOfComponents : 0;
+  }
+
+  /** Number of valid pixels seen during the last pass */
+  itkGetConstMacro(NumberOfSeenSamples, unsigned long);
+
+  /** Release the memory held by the samples */
+  void ClearSamples()
+  {
+    SampleBufferType().swap(m_Samples);
+  }
+
+  void GenerateOutputInformation() override;
+  void AllocateOutputs() override;
+  void Reset(void) override;
+  void Synthetize(void) override;
+
+protected:
+  PersistentSampleReservoirImageFilter();
+  ~PersistentSampleReservoirImageFilter() override
+  {
+  }
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  /** Single-threaded GenerateData: the reservoir is updated in the scanning
+   * order so that the draw does not depend on the number of threads. */
+  void GenerateData() override;
+
+private:
+  PersistentSampleReservoirImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  unsigned long    m_ReservoirSize;
+  unsigned int     m_Seed;
+  unsigned int     m_NumberOfComponents;
+  SampleBufferType m_Samples;
+  unsigned long    m_NumberOfSeenSamples;
+
+  RandomGeneratorType::Pointer m_Generator;
+}; // end of class PersistentSampleReservoirImageFilter
+
+
+/** \class StreamingSampleReservoirImageFilter
+ * \brief Streams an image through PersistentSampleReservoirImageFilter to
+ * draw a uniform random subset of its pixels in a single pass.
+ *
+ * \code
+ * typedef otb::StreamingSampleReservoirImageFilter<ImageType> SamplerType;
+ * SamplerType::Pointer sampler = SamplerType::New();
+ * sampler->SetInput(reader->GetOutput());
+ * sampler->GetFilter()->SetReservoirSize(10000);
+ * sampler->Update();
+ * const SamplerType::SampleBufferType& samples = sampler->GetSamples();
+ * \endcode
+ *
+ * \sa PersistentSampleReservoirImageFilter
+ *
+ * \ingroup OTBStatistics
+ */
+template <class TInputImage>
+class ITK_EXPORT StreamingSampleReservoirImageFilter : public PersistentFilterStreamingDecorator<PersistentSampleReservoirImageFilter<TInputImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingSampleReservoirImageFilter Self;
+  typedef PersistentFilterStreamingDecorator<PersistentSampleReservoirImageFilter<TInputImage>> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingSampleReservoirImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef typename Superclass::FilterType              SamplerFilterType;
+  typedef typename SamplerFilterType::SampleBufferType SampleBufferType;
+  typedef TInputImage                                  InputImageType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType* input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType* GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  /** Packed samples */
+  const SampleBufferType& GetSamples() const
+  {
+    return this->GetFilter()->GetSamples();
+  }
+
+  /** Number of samples in the reservoir */
+  unsigned long GetNumberOfSamples() const
+  {
+    return this->GetFilter()->GetNumberOfSamples();
+  }
+
+protected:
+  /** Constructor */
+  StreamingSampleReservoirImageFilter()
+  {
+  }
+  /** Destructor */
+  ~StreamingSampleReservoirImageFilter() override
+  {
+  }
+
+private:
+  StreamingSampleReservoirImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingSampleReservoirImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingSampleReservoirImageFilter_hxx
+#define otbStreamingSampleReservoirImageFilter_hxx
+
+#include "otbStreamingSampleReservoirImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "itkImageScanlineConstIterator.h"
+
+namespace otb
+{
+
+template <class TInputImage>
+PersistentSampleReservoirImageFilter<TInputImage>::PersistentSampleReservoirImageFilter()
+  : m_ReservoirSize(10000), m_Seed(0), m_NumberOfComponents(0), m_NumberOfSeenSamples(0), m_Generator(RandomGeneratorType::New())
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template <class TInputImage>
+void PersistentSampleReservoirImageFilter<TInputImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+  {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+    {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentSampleReservoirImageFilter<TInputImage>::AllocateOutputs()
+{
+  // Nothing to allocate: the output image is not intended to be used
+}
+
+template <class TInputImage>
+void PersistentSampleReservoirImageFilter<TInputImage>::Reset()
+{
+  if (m_ReservoirSize < 1)
+  {
+    itkExceptionMacro(<< "The reservoir size shall be at least 1");
+  }
+  const_cast<ImageType*>(this->GetInput())->UpdateOutputInformation();
+  m_NumberOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
+
+  m_Generator->Initialize(m_Seed);
+
+  // Only reserve what the image can fill
+  const unsigned long nbPixels = this->GetInput()->GetLargestPossibleRegion().GetNumberOfPixels();
+  m_Samples.clear();
+  m_Samples.reserve(static_cast<std::size_t>(std::min(m_ReservoirSize, nbPixels)) * m_NumberOfComponents);
+  m_NumberOfSeenSamples = 0;
+}
+
+template <class TInputImage>
+void PersistentSampleReservoirImageFilter<TInputImage>::Synthetize()
+{
+}
+
+template <class TInputImage>
+void PersistentSampleReservoirImageFilter<TInputImage>::GenerateData()
+{
+  const ImageType*   input  = this->GetInput();
+  const RegionType   region = this->GetOutput()->GetRequestedRegion();
+  const unsigned int nbComp = m_NumberOfComponents;
+
+  std::vector<double> pixel(nbComp);
+
+  itk::ImageScanlineConstIterator<ImageType> it(input, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine())
+  {
+    for (; !it.IsAtEndOfLine(); ++it)
+    {
+      const PixelType& value = it.Get();
+      bool             valid = true;
+      for (unsigned int i = 0; i < nbComp && valid; ++i)
+      {
+        pixel[i] = static_cast<double>(value[i]);
+        valid    = std::isfinite(pixel[i]);
+      }
+      if (!valid)
+      {
+        continue;
+      }
+
+      if (m_NumberOfSeenSamples < m_ReservoirSize)
+      {
+        m_Samples.insert(m_Samples.end(), pixel.begin(), pixel.end());
+      }
+      else
+      {
+        // Uniform index in [0, m_NumberOfSeenSamples], without the 32 bits
+        // limit of GetIntegerVariate()
+        const auto j = static_cast<unsigned long>(m_Generator->GetUniformVariate(0.0, static_cast<double>(m_NumberOfSeenSamples) + 1.0));
+        if (j < m_ReservoirSize)
+        {
+          std::copy(pixel.begin(), pixel.end(), m_Samples.begin() + j * nbComp);
+        }
+      }
+      ++m_NumberOfSeenSamples;
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentSampleReservoirImageFilter<TInputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "ReservoirSize: " << m_ReservoirSize << std::endl;
+  os << indent << "Seed: " << m_Seed << std::endl;
+  os << indent << "NumberOfSamples: " << this->GetNumberOfSamples() << std::endl;
+  os << indent << "NumberOfSeenSamples: " << m_NumberOfSeenSamples << std::endl;
+}
+
+} // end namespace otb
+
+#endif
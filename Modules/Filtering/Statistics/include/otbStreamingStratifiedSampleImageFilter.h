@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingStratifiedSampleImageFilter_h
+#define otbStreamingStratifiedSampleImageFilter_h
+
+#include <vector>
+
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+
+namespace otb
+{
+
+/** \class PersistentStratifiedSampleImageFilter
+ * \brief Persistent filter drawing a spatially stratified subset of the
+ * pixels of an image.
+ *
+ * The largest possible region is divided into square cells of side
+ * ceil(sqrt(NumberOfPixels / NumberOfSamples)), and one pixel is drawn
+ * uniformly in each cell, so that the samples cover the whole scene. The
+ * drawn positions only depend on the image size and on the seed: the
+ * samples do not depend on the streaming divisions nor on the number of
+ * threads, and they are stored in the order of their cells (row major).
+ *
+ * Samples with a non-finite component are discarded.
+ *
+ * The samples are packed in a single buffer, one pixel after the other.
+ *
+ * The filter does not produce an image: it shall be streamed through
+ * StreamingStratifiedSampleImageFilter.
+ *
+ * \sa StreamingStratifiedSampleImageFilter
+ *
+ * \ingroup OTBStatistics
+ */
+template <class TInputImage>
+class ITK_EXPORT PersistentStratifiedSampleImageFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentStratifiedSampleImageFilter Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentStratifiedSampleImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                    ImageType;
+  typedef typename ImageType::IndexType  IndexType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef typename ImageType::PixelType  PixelType;
+  typedef std::vector<double>            SampleBufferType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+
+  /** Approximate number of samples (one per cell) */
+  itkSetMacro(NumberOfSamples, unsigned long);
+  itkGetConstMacro(NumberOfSamples, unsigned long);
+
+  /** Seed of the random generator drawing the pixel of each cell */
+  itkSetMacro(Seed, unsigned int);
+  itkGetConstMacro(Seed, unsigned int);
+
+  /** Packed samples: component c of sample s is at s * NumberOfComponents + c */
+  itkGetConstReferenceMacro(Samples, SampleBufferType);
+
+  /** Number of components of each sample */
+  itkGetConstMacro(NumberOfComponents, unsigned int);
+
+  /** Side of the cells, in pixels */
+  itkGetConstMacro(CellSize, unsigned long);
+
+  /** Number of valid samples */
+  unsigned long GetNumberOfValidSamples() const
+  {
+    return m_NumberOfComponents > 0 ? m_Samples.size() / m_NumberOfComponents : 0;
+  }
+
+  /** Release the memory held by the samples */
+  void ClearSamples()
+  {
+    SampleBufferType().swap(m_Samples);
+  }
+
+  void GenerateOutputInformation() override;
+  void AllocateOutputs() override;
+  void Reset(void) override;
+  void Synthetize(void) override;
+
+protected:
+  PersistentStratifiedSampleImageFilter();
+  ~PersistentStratifiedSampleImageFilter() override
+  {
+  }
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+private:
+  PersistentStratifiedSampleImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  unsigned long m_NumberOfSamples;
+  unsigned int  m_Seed;
+  unsigned int  m_NumberOfComponents;
+  unsigned long m_CellSize;
+
+  /** Drawn positions sorted by line: the positions of line y are in
+   * [m_LineBegin[y], m_LineBegin[y + 1]), with their column and cell */
+  std::vector<unsigned long> m_LineBegin;
+  std::vector<unsigned long> m_Columns;
+  std::vector<unsigned long> m_Cells;
+
+  /** One slot per cell, and whether the slot holds a finite pixel */
+  SampleBufferType  m_Samples;
+  std::vector<char> m_ValidCells;
+
+  RandomGeneratorType::Pointer m_Generator;
+}; // end of class PersistentStratifiedSampleImageFilter
+
+
+/** \class StreamingStratifiedSampleImageFilter
+ * \brief Streams an image through PersistentStratifiedSampleImageFilter to
+ * draw a spatially stratified subset of its pixels in a single pass.
+ *
+ * \code
+ * typedef otb::StreamingStratifiedSampleImageFilter<ImageType> SamplerType;
+ * SamplerType::Pointer sampler = SamplerType::New();
+ * sampler->SetInput(reader->GetOutput());
+ * sampler->GetFilter()->SetNumberOfSamples(10000);
+ * sampler->Update();
+ * const SamplerType::SampleBufferType& samples = sampler->GetSamples();
+ * \endcode
+ *
+ * \sa PersistentStratifiedSampleImageFilter
+ *
+ * \ingroup OTBStatistics
+ */
+template <class TInputImage>
+class ITK_EXPORT StreamingStratifiedSampleImageFilter : public PersistentFilterStreamingDecorator<PersistentStratifiedSampleImageFilter<TInputImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingStratifiedSampleImageFilter Self;
+  typedef PersistentFilterStreamingDecorator<PersistentStratifiedSampleImageFilter<TInputImage>> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingStratifiedSampleImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef typename Superclass::FilterType              SamplerFilterType;
+  typedef typename SamplerFilterType::SampleBufferType SampleBufferType;
+  typedef TInputImage                                  InputImageType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType* input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType* GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  /** Packed samples */
+  const SampleBufferType& GetSamples() const
+  {
+    return this->GetFilter()->GetSamples();
+  }
+
+  /** Number of valid samples */
+  unsigned long GetNumberOfValidSamples() const
+  {
+    return this->GetFilter()->GetNumberOfValidSamples();
+  }
+
+protected:
+  /** Constructor */
+  StreamingStratifiedSampleImageFilter()
+  {
+  }
+  /** Destructor */
+  ~StreamingStratifiedSampleImageFilter() override
+  {
+  }
+
+private:
+  StreamingStratifiedSampleImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingStratifiedSampleImageFilter.hxx"
+#endif
+
+#endif
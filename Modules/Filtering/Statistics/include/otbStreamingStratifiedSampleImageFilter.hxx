@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingStratifiedSampleImageFilter_hxx
+#define otbStreamingStratifiedSampleImageFilter_hxx
+
+#include "otbStreamingStratifiedSampleImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace otb
+{
+
+template <class TInputImage>
+PersistentStratifiedSampleImageFilter<TInputImage>::PersistentStratifiedSampleImageFilter()
+  : m_NumberOfSamples(10000), m_Seed(0), m_NumberOfComponents(0), m_CellSize(1), m_Generator(RandomGeneratorType::New())
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template <class TInputImage>
+void PersistentStratifiedSampleImageFilter<TInputImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+  {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+    {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentStratifiedSampleImageFilter<TInputImage>::AllocateOutputs()
+{
+  // Nothing to allocate: the output image is not intended to be used
+}
+
+template <class TInputImage>
+void PersistentStratifiedSampleImageFilter<TInputImage>::Reset()
+{
+  if (m_NumberOfSamples < 1)
+  {
+    itkExceptionMacro(<< "The number of samples shall be at least 1");
+  }
+  const_cast<ImageType*>(this->GetInput())->UpdateOutputInformation();
+  m_NumberOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
+
+  const RegionType    region   = this->GetInput()->GetLargestPossibleRegion();
+  const unsigned long width    = region.GetSize()[0];
+  const unsigned long height   = region.GetSize()[1];
+  const double        nbPixels = static_cast<double>(width) * height;
+
+  m_CellSize                  = std::max(1UL, static_cast<unsigned long>(std::ceil(std::sqrt(nbPixels / m_NumberOfSamples))));
+  const unsigned long cellsX  = (width + m_CellSize - 1) / m_CellSize;
+  const unsigned long cellsY  = (height + m_CellSize - 1) / m_CellSize;
+  const unsigned long nbCells = cellsX * cellsY;
+
+  // Draw one position per cell, then sort them by line (counting sort,
+  // which keeps the columns of a line increasing)
+  m_Generator->Initialize(m_Seed);
+  std::vector<unsigned long> lines(nbCells), columns(nbCells);
+  m_LineBegin.assign(height + 1, 0);
+  for (unsigned long cy = 0, cell = 0; cy < cellsY; ++cy)
+  {
+    const unsigned long cellHeight = std::min(m_CellSize, height - cy * m_CellSize);
+    for (unsigned long cx = 0; cx < cellsX; ++cx, ++cell)
+    {
+      const unsigned long cellWidth = std::min(m_CellSize, width - cx * m_CellSize);
+      lines[cell]   = cy * m_CellSize + m_Generator->GetIntegerVariate(static_cast<RandomGeneratorType::IntegerType>(cellHeight - 1));
+      columns[cell] = cx * m_CellSize + m_Generator->GetIntegerVariate(static_cast<RandomGeneratorType::IntegerType>(cellWidth - 1));
+      ++m_LineBegin[lines[cell] + 1];
+    }
+  }
+  for (unsigned long y = 0; y < height; ++y)
+  {
+    m_LineBegin[y + 1] += m_LineBegin[y];
+  }
+  std::vector<unsigned long> next(m_LineBegin.begin(), m_LineBegin.end() - 1);
+  m_Columns.resize(nbCells);
+  m_Cells.resize(nbCells);
+  for (unsigned long cell = 0; cell < nbCells; ++cell)
+  {
+    const unsigned long position = next[lines[cell]]++;
+    m_Columns[position]          = columns[cell];
+    m_Cells[position]            = cell;
+  }
+
+  m_Samples.assign(static_cast<std::size_t>(nbCells) * m_NumberOfComponents, 0.);
+  m_ValidCells.assign(nbCells, 0);
+}
+
+template <class TInputImage>
+void PersistentStratifiedSampleImageFilter<TInputImage>::Synthetize()
+{
+  // Pack the valid samples, in the order of their cells
+  const unsigned int nbComp  = m_NumberOfComponents;
+  std::size_t        written = 0;
+  for (std::size_t cell = 0; cell < m_ValidCells.size(); ++cell)
+  {
+    if (m_ValidCells[cell])
+    {
+      if (written != cell)
+      {
+        std::copy(m_Samples.begin() + cell * nbComp, m_Samples.begin() + (cell + 1) * nbComp, m_Samples.begin() + written * nbComp);
+      }
+      ++written;
+    }
+  }
+  m_Samples.resize(written * nbComp);
+  std::vector<char>().swap(m_ValidCells);
+}
+
+template <class TInputImage>
+void PersistentStratifiedSampleImageFilter<TInputImage>::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType itkNotUsed(threadId))
+{
+  // Each cell has a single position, read by a single thread: the threads
+  // write to disjoint slots
+  const ImageType*   input  = this->GetInput();
+  const IndexType    origin = input->GetLargestPossibleRegion().GetIndex();
+  const unsigned int nbComp = m_NumberOfComponents;
+
+  const unsigned long firstColumn = outputRegionForThread.GetIndex()[0] - origin[0];
+  const unsigned long endColumn   = firstColumn + outputRegionForThread.GetSize()[0];
+  const unsigned long firstLine   = outputRegionForThread.GetIndex()[1] - origin[1];
+  const unsigned long endLine     = firstLine + outputRegionForThread.GetSize()[1];
+
+  IndexType index;
+  for (unsigned long y = firstLine; y < endLine; ++y)
+  {
+    index[1] = origin[1] + y;
+
+    auto       it  = std::lower_bound(m_Columns.begin() + m_LineBegin[y], m_Columns.begin() + m_LineBegin[y + 1], firstColumn);
+    const auto end = m_Columns.begin() + m_LineBegin[y + 1];
+    for (; it != end && *it < endColumn; ++it)
+    {
+      index[0] = origin[0] + *it;
+
+      const PixelType&    pixel = input->GetPixel(index);
+      const unsigned long cell  = m_Cells[it - m_Columns.begin()];
+      double*             slot  = &m_Samples[cell * nbComp];
+      bool                valid = true;
+      for (unsigned int c = 0; c < nbComp; ++c)
+      {
+        slot[c] = static_cast<double>(pixel[c]);
+        valid   = valid && std::isfinite(slot[c]);
+      }
+      m_ValidCells[cell] = valid;
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentStratifiedSampleImageFilter<TInputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfSamples: " << m_NumberOfSamples << std::endl;
+  os << indent << "Seed: " << m_Seed << std::endl;
+  os << indent << "CellSize: " << m_CellSize << std::endl;
+  os << indent << "NumberOfValidSamples: " << this->GetNumberOfValidSamples() << std::endl;
+}
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLiftingWaveletImageFilter_h
+#define otbLiftingWaveletImageFilter_h
+
+#include <array>
+#include <vector>
+
+#include "itkImageToImageFilter.h"
+#include "otbWaveletOperatorBase.h"
+#include "otbLiftingWaveletScheme.h"
+
+namespace otb
+{
+
+/** \class LiftingWaveletImageFilter
+ * \brief Streamed multi-level wavelet transform computed with the lifting
+ * scheme.
+ *
+ * The forward filter (TDirectionOfTransformation = Wavelet::FORWARD) writes
+ * the coefficients in the synopsis layout of WaveletImageFilter: the
+ * approximation of the last level is in the upper left corner, and the
+ * horizontal, vertical and diagonal details of each level are on its right,
+ * below it and in the lower right corner. A level of size n keeps ceil(n/2)
+ * low-pass and floor(n/2) high-pass coefficients along each axis, so that
+ * images of any size are supported and the synopsis has the size of the
+ * image. The inverse filter (Wavelet::INVERSE) rebuilds the image from such
+ * a synopsis.
+ *
+ * Contrary to WaveletImageFilter, which convolves with the filter bank and
+ * subsamples afterwards, the lifting steps of LiftingWaveletScheme only
+ * compute the kept coefficients, in place. Each requested region is
+ * computed from the smallest windows of each level, extended on the image
+ * borders only, so that the result does not depend on the streaming
+ * divisions nor on the number of threads. The inverse transform of a region
+ * reads the coefficients of every level, which spread over the synopsis.
+ *
+ * This filter only supports images of dimension 2 with scalar pixels.
+ *
+ * \ingroup OTBWavelet
+ * \sa LiftingWaveletScheme
+ * \sa WaveletImageFilter
+ * \sa WaveletInverseImageFilter
+ */
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation = Wavelet::FORWARD>
+class ITK_EXPORT LiftingWaveletImageFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef LiftingWaveletImageFilter Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LiftingWaveletImageFilter, ImageToImageFilter);
+
+  typedef TInputImage                             InputImageType;
+  typedef TOutputImage                            OutputImageType;
+  typedef typename InputImageType::PixelType      InputPixelType;
+  typedef typename OutputImageType::PixelType     OutputPixelType;
+  typedef typename OutputImageType::RegionType    OutputImageRegionType;
+  typedef typename OutputImageType::IndexType     IndexType;
+  typedef typename OutputImageType::SizeType      SizeType;
+  typedef LiftingWaveletScheme                    SchemeType;
+  typedef SchemeType::WaveletType                 WaveletType;
+  typedef SchemeType::Interval                    IntervalType;
+  typedef std::array<IntervalType, 2>             WindowType;
+  typedef std::vector<WindowType>                 WindowListType;
+  typedef std::vector<std::array<long, 2>>        LevelSizesType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, InputImageType::ImageDimension);
+  itkStaticConstMacro(DirectionOfTransformation, short, TDirectionOfTransformation);
+
+  /** Wavelet, CDF 9/7 by default */
+  itkSetMacro(Wavelet, WaveletType);
+  itkGetConstMacro(Wavelet, WaveletType);
+
+  /** Number of decomposition levels, 2 by default */
+  itkSetMacro(NumberOfDecompositions, unsigned int);
+  itkGetConstMacro(NumberOfDecompositions, unsigned int);
+
+protected:
+  LiftingWaveletImageFilter();
+  ~LiftingWaveletImageFilter() override
+  {
+  }
+
+  void GenerateInputRequestedRegion() override;
+
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  /** Size of the signal of each level: level 0 is the image */
+  LevelSizesType ComputeLevelSizes() const;
+
+  /** Synopsis windows of the detail coefficients of a level (and of the
+   * approximation at the last level) falling in a region */
+  WindowListType GetLevelQuadrants(const WindowType& region, const LevelSizesType& sizes, unsigned int level) const;
+
+  /** Synopsis interval of the low-pass (part 0) or high-pass (part 1)
+   * coefficients whose positions are in an interval */
+  static IntervalType PositionsToSynopsis(const IntervalType& positions, long lowPassSize, unsigned int part);
+
+  /** Forward transform: for each level, the positions to keep and the window
+   * of the approximation read by the next level (level 0 is the input) */
+  void ComputeForwardWindows(const WindowType& region, const LevelSizesType& sizes, const SchemeType& scheme, WindowListType& positions,
+                             WindowListType& windows) const;
+
+  /** Inverse transform: for each level, the coefficient positions read and
+   * the window of the approximation to rebuild (level 0 is the output) */
+  void ComputeInverseWindows(const WindowType& region, const LevelSizesType& sizes, const SchemeType& scheme, WindowListType& supports,
+                             WindowListType& windows) const;
+
+  void ForwardGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId);
+  void InverseGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId);
+
+  /** Conversions between regions and windows relative to the largest
+   * possible region */
+  WindowType RegionToWindow(const OutputImageRegionType& region) const;
+  OutputImageRegionType WindowToRegion(const WindowType& window) const;
+
+private:
+  LiftingWaveletImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  WaveletType  m_Wavelet;
+  unsigned int m_NumberOfDecompositions;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbLiftingWaveletImageFilter.hxx"
+#endif
+
+#endif
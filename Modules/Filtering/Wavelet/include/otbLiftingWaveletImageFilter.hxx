@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLiftingWaveletImageFilter_hxx
+#define otbLiftingWaveletImageFilter_hxx
+
+#include "otbLiftingWaveletImageFilter.h"
+
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+
+namespace otb
+{
+
+/** Position, in the signal of the previous level, of the coefficient stored
+ * at synopsis index s of a level having lowPassSize low-pass coefficients */
+inline long LiftingWaveletSynopsisToPosition(long s, long lowPassSize)
+{
+  return s < lowPassSize ? 2 * s : 2 * (s - lowPassSize) + 1;
+}
+
+/** Synopsis index of the coefficient at position p */
+inline long LiftingWaveletPositionToSynopsis(long p, long lowPassSize)
+{
+  return (p & 1) ? lowPassSize + (p - 1) / 2 : p / 2;
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::LiftingWaveletImageFilter()
+  : m_Wavelet(Wavelet::CDF_9_7), m_NumberOfDecompositions(2)
+{
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+typename LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::LevelSizesType
+LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::ComputeLevelSizes() const
+{
+  if (m_NumberOfDecompositions < 1)
+  {
+    itkExceptionMacro(<< "The number of decompositions shall be at least 1");
+  }
+  const SizeType size = this->GetOutput()->GetLargestPossibleRegion().GetSize();
+  LevelSizesType sizes(m_NumberOfDecompositions + 1);
+  for (unsigned int a = 0; a < 2; ++a)
+  {
+    sizes[0][a] = size[a];
+    for (unsigned int level = 1; level <= m_NumberOfDecompositions; ++level)
+    {
+      sizes[level][a] = (sizes[level - 1][a] + 1) / 2;
+    }
+  }
+  return sizes;
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+typename LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::WindowType
+LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::RegionToWindow(const OutputImageRegionType& region) const
+{
+  const IndexType origin = this->GetOutput()->GetLargestPossibleRegion().GetIndex();
+  WindowType      window;
+  for (unsigned int a = 0; a < 2; ++a)
+  {
+    window[a].first = region.GetIndex()[a] - origin[a];
+    window[a].last  = window[a].first + static_cast<long>(region.GetSize()[a]) - 1;
+  }
+  return window;
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+typename LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::OutputImageRegionType
+LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::WindowToRegion(const WindowType& window) const
+{
+  const IndexType origin = this->GetOutput()->GetLargestPossibleRegion().GetIndex();
+  IndexType       index;
+  SizeType        size;
+  for (unsigned int a = 0; a < 2; ++a)
+  {
+    index[a] = origin[a] + window[a].first;
+    size[a]  = window[a].GetLength();
+  }
+  return OutputImageRegionType(index, size);
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+typename LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::WindowListType
+LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::GetLevelQuadrants(const WindowType& region, const LevelSizesType& sizes,
+                                                                                                    unsigned int level) const
+{
+  const unsigned int nbLevels = sizes.size() - 1;
+  WindowListType     quadrants;
+  for (unsigned int qy = 0; qy < 2; ++qy)
+  {
+    for (unsigned int qx = 0; qx < 2; ++qx)
+    {
+      // The approximation of the intermediate levels is decomposed further
+      if (qx == 0 && qy == 0 && level < nbLevels)
+      {
+        continue;
+      }
+      const unsigned int parts[2] = {qx, qy};
+      WindowType         quadrant;
+      for (unsigned int a = 0; a < 2; ++a)
+      {
+        const IntervalType part = parts[a] == 0 ? IntervalType(0, sizes[level][a] - 1) : IntervalType(sizes[level][a], sizes[level - 1][a] - 1);
+        quadrant[a]             = region[a].Intersect(part);
+      }
+      if (!quadrant[0].IsEmpty() && !quadrant[1].IsEmpty())
+      {
+        quadrants.push_back(quadrant);
+      }
+    }
+  }
+  return quadrants;
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+typename LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::IntervalType
+LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::PositionsToSynopsis(const IntervalType& positions, long lowPassSize,
+                                                                                                      unsigned int part)
+{
+  if (part == 0)
+  {
+    // Even positions
+    return positions.IsEmpty() ? IntervalType() : IntervalType((positions.first + 1) / 2, positions.last / 2);
+  }
+  // Odd positions
+  if (positions.IsEmpty() || positions.last < 1)
+  {
+    return IntervalType();
+  }
+  return IntervalType(lowPassSize + positions.first / 2, lowPassSize + (positions.last - 1) / 2);
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+void LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::ComputeForwardWindows(const WindowType&     region,
+                                                                                                            const LevelSizesType& sizes,
+                                                                                                            const SchemeType&     scheme,
+                                                                                                            WindowListType&       positions,
+                                                                                                            WindowListType&       windows) const
+{
+  const unsigned int nbLevels = sizes.size() - 1;
+  positions.assign(nbLevels + 1, WindowType());
+  windows.assign(nbLevels + 1, WindowType());
+
+  // From the last level to the first one: each level reads the approximation
+  // computed by the previous one
+  for (unsigned int level = nbLevels; level >= 1; --level)
+  {
+    WindowType&          kept      = positions[level];
+    const WindowListType quadrants = GetLevelQuadrants(region, sizes, level);
+    for (typename WindowListType::const_iterator it = quadrants.begin(); it != quadrants.end(); ++it)
+    {
+      for (unsigned int a = 0; a < 2; ++a)
+      {
+        // The mapping is increasing within a quadrant
+        kept[a].Merge(IntervalType(LiftingWaveletSynopsisToPosition((*it)[a].first, sizes[level][a]),
+                                   LiftingWaveletSynopsisToPosition((*it)[a].last, sizes[level][a])));
+      }
+    }
+    const WindowType& next = windows[level];
+    if (!next[0].IsEmpty() && !next[1].IsEmpty())
+    {
+      for (unsigned int a = 0; a < 2; ++a)
+      {
+        kept[a].Merge(IntervalType(2 * next[a].first, 2 * next[a].last));
+      }
+    }
+    if (kept[0].IsEmpty() || kept[1].IsEmpty())
+    {
+      continue;
+    }
+    for (unsigned int a = 0; a < 2; ++a)
+    {
+      windows[level - 1][a] = scheme.GetSampleSupport(kept[a].Dilate(scheme.GetMargin()), sizes[level - 1][a]);
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+void LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::ComputeInverseWindows(const WindowType&     region,
+                                                                                                            const LevelSizesType& sizes,
+                                                                                                            const SchemeType&     scheme,
+                                                                                                            WindowListType&       supports,
+                                                                                                            WindowListType&       windows) const
+{
+  const unsigned int nbLevels = sizes.size() - 1;
+  supports.assign(nbLevels + 1, WindowType());
+  windows.assign(nbLevels + 1, WindowType());
+  windows[0] = region;
+
+  for (unsigned int level = 1; level <= nbLevels; ++level)
+  {
+    const WindowType& previous = windows[level - 1];
+    if (previous[0].IsEmpty() || previous[1].IsEmpty())
+    {
+      break;
+    }
+    for (unsigned int a = 0; a < 2; ++a)
+    {
+      supports[level][a] = scheme.GetCoefficientSupport(previous[a].Dilate(scheme.GetMargin()), sizes[level - 1][a]);
+      windows[level][a]  = PositionsToSynopsis(supports[level][a], sizes[level][a], 0);
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+void LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType* input = const_cast<InputImageType*>(this->GetInput());
+  if (!input)
+  {
+    return;
+  }
+
+  const LevelSizesType sizes = ComputeLevelSizes();
+  const SchemeType     scheme(m_Wavelet);
+  const WindowType     region = RegionToWindow(this->GetOutput()->GetRequestedRegion());
+  const unsigned int   nbLevels = m_NumberOfDecompositions;
+
+  WindowListType positions, windows;
+  WindowType     requested;
+  if (TDirectionOfTransformation == Wavelet::FORWARD)
+  {
+    ComputeForwardWindows(region, sizes, scheme, positions, windows);
+    requested = windows[0];
+  }
+  else
+  {
+    // Bounding window of the coefficients of every level
+    ComputeInverseWindows(region, sizes, scheme, positions, windows);
+    for (unsigned int level = 1; level <= nbLevels; ++level)
+    {
+      for (unsigned int qy = 0; qy < 2; ++qy)
+      {
+        for (unsigned int qx = 0; qx < 2; ++qx)
+        {
+          if (qx == 0 && qy == 0 && level < nbLevels)
+          {
+            continue;
+          }
+          const IntervalType sx = PositionsToSynopsis(positions[level][0], sizes[level][0], qx);
+          const IntervalType sy = PositionsToSynopsis(positions[level][1], sizes[level][1], qy);
+          if (!sx.IsEmpty() && !sy.IsEmpty())
+          {
+            requested[0].Merge(sx);
+            requested[1].Merge(sy);
+          }
+        }
+      }
+    }
+  }
+
+  input->SetRequestedRegion(WindowToRegion(requested));
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+void LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                                           itk::ThreadIdType            threadId)
+{
+  if (TDirectionOfTransformation == Wavelet::FORWARD)
+  {
+    ForwardGenerateData(outputRegionForThread, threadId);
+  }
+  else
+  {
+    InverseGenerateData(outputRegionForThread, threadId);
+  }
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+void LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::ForwardGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                                          itk::ThreadIdType            threadId)
+{
+  const InputImageType* input  = this->GetInput();
+  OutputImageType*      output = this->GetOutput();
+  const IndexType       origin = output->GetLargestPossibleRegion().GetIndex();
+
+  const LevelSizesType sizes = ComputeLevelSizes();
+  const SchemeType     scheme(m_Wavelet);
+  const long           margin = scheme.GetMargin();
+  const WindowType     region = RegionToWindow(outputRegionForThread);
+
+  WindowListType positions, windows;
+  ComputeForwardWindows(region, sizes, scheme, positions, windows);
+  if (windows[0][0].IsEmpty() || windows[0][1].IsEmpty())
+  {
+    return;
+  }
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // Input samples read by the first level
+  std::vector<double> approximation(windows[0][0].GetLength() * windows[0][1].GetLength());
+  {
+    itk::ImageScanlineConstIterator<InputImageType> it(input, WindowToRegion(windows[0]));
+    std::vector<double>::iterator                   out = approximation.begin();
+    for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine())
+    {
+      for (; !it.IsAtEndOfLine(); ++it, ++out)
+      {
+        *out = static_cast<double>(it.Get());
+      }
+    }
+  }
+
+  std::vector<double> buffer, next;
+  std::vector<long>   mapX, mapY;
+  IndexType           index;
+  for (unsigned int level = 1; level <= m_NumberOfDecompositions; ++level)
+  {
+    const WindowType& kept = positions[level];
+    if (kept[0].IsEmpty() || kept[1].IsEmpty())
+    {
+      break;
+    }
+
+    // Symmetric extension of the approximation of the previous level over
+    // the kept positions and the margin of the lifting steps
+    const WindowType&  previous = windows[level - 1];
+    const IntervalType ex       = kept[0].Dilate(margin);
+    const IntervalType ey       = kept[1].Dilate(margin);
+    const long         width    = ex.GetLength();
+    const long         height   = ey.GetLength();
+    mapX.resize(width);
+    mapY.resize(height);
+    for (long i = 0; i < width; ++i)
+    {
+      mapX[i] = scheme.ExtendSample(ex.first + i, sizes[level - 1][0]) - previous[0].first;
+    }
+    for (long j = 0; j < height; ++j)
+    {
+      mapY[j] = scheme.ExtendSample(ey.first + j, sizes[level - 1][1]) - previous[1].first;
+    }
+    const long previousWidth = previous[0].GetLength();
+    buffer.resize(width * height);
+    for (long j = 0; j < height; ++j)
+    {
+      const double* in  = &approximation[mapY[j] * previousWidth];
+      double*       out = &buffer[j * width];
+      for (long i = 0; i < width; ++i)
+      {
+        out[i] = in[mapX[i]];
+      }
+    }
+
+    // Lines, then columns
+    for (long j = 0; j < height; ++j)
+    {
+      scheme.Forward(&buffer[j * width], ex.first, width, 1);
+    }
+    for (long i = 0; i < width; ++i)
+    {
+      scheme.Forward(&buffer[i], ey.first, height, width);
+    }
+
+    // Coefficients of this level falling in the region
+    const WindowListType quadrants = GetLevelQuadrants(region, sizes, level);
+    for (typename WindowListType::const_iterator it = quadrants.begin(); it != quadrants.end(); ++it)
+    {
+      const WindowType& quadrant = *it;
+      for (long sy = quadrant[1].first; sy <= quadrant[1].last; ++sy)
+      {
+        const double* line = &buffer[(LiftingWaveletSynopsisToPosition(sy, sizes[level][1]) - ey.first) * width];
+        index[1]           = origin[1] + sy;
+        for (long sx = quadrant[0].first; sx <= quadrant[0].last; ++sx)
+        {
+          index[0] = origin[0] + sx;
+          output->SetPixel(index, static_cast<OutputPixelType>(line[LiftingWaveletSynopsisToPosition(sx, sizes[level][0]) - ex.first]));
+          progress.CompletedPixel();
+        }
+      }
+    }
+
+    // Approximation read by the next level
+    const WindowType& window = windows[level];
+    if (window[0].IsEmpty() || window[1].IsEmpty())
+    {
+      break;
+    }
+    next.resize(window[0].GetLength() * window[1].GetLength());
+    std::vector<double>::iterator out = next.begin();
+    for (long ky = window[1].first; ky <= window[1].last; ++ky)
+    {
+      const double* line = &buffer[(2 * ky - ey.first) * width];
+      for (long kx = window[0].first; kx <= window[0].last; ++kx, ++out)
+      {
+        *out = line[2 * kx - ex.first];
+      }
+    }
+    approximation.swap(next);
+  }
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+void LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::InverseGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                                          itk::ThreadIdType            threadId)
+{
+  const InputImageType* input  = this->GetInput();
+  OutputImageType*      output = this->GetOutput();
+  const IndexType       origin = output->GetLargestPossibleRegion().GetIndex();
+
+  const unsigned int   nbLevels = m_NumberOfDecompositions;
+  const LevelSizesType sizes    = ComputeLevelSizes();
+  const SchemeType     scheme(m_Wavelet);
+  const long           margin = scheme.GetMargin();
+  const WindowType     region = RegionToWindow(outputRegionForThread);
+
+  WindowListType supports, windows;
+  ComputeInverseWindows(region, sizes, scheme, supports, windows);
+  if (windows[nbLevels][0].IsEmpty() || windows[nbLevels][1].IsEmpty())
+  {
+    return;
+  }
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // Approximation of the last level, in the upper left corner
+  std::vector<double> approximation(windows[nbLevels][0].GetLength() * windows[nbLevels][1].GetLength());
+  {
+    itk::ImageScanlineConstIterator<InputImageType> it(input, WindowToRegion(windows[nbLevels]));
+    std::vector<double>::iterator                   out = approximation.begin();
+    for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine())
+    {
+      for (; !it.IsAtEndOfLine(); ++it, ++out)
+      {
+        *out = static_cast<double>(it.Get());
+      }
+    }
+  }
+
+  std::vector<double> buffer, next;
+  std::vector<long>   mapX, mapY;
+  IndexType           index;
+  for (unsigned int level = nbLevels; level >= 1; --level)
+  {
+    // Coefficients of the extended window, the approximation coming from the
+    // next level and the details from the synopsis
+    const WindowType&  current = windows[level];
+    const WindowType&  rebuilt = windows[level - 1];
+    const IntervalType ex      = rebuilt[0].Dilate(margin);
+    const IntervalType ey      = rebuilt[1].Dilate(margin);
+    const long         width   = ex.GetLength();
+    const long         height  = ey.GetLength();
+    mapX.resize(width);
+    mapY.resize(height);
+    for (long i = 0; i < width; ++i)
+    {
+      mapX[i] = scheme.ExtendCoefficient(ex.first + i, sizes[level - 1][0]);
+    }
+    for (long j = 0; j < height; ++j)
+    {
+      mapY[j] = scheme.ExtendCoefficient(ey.first + j, sizes[level - 1][1]);
+    }
+    const long currentWidth = current[0].GetLength();
+    buffer.resize(width * height);
+    for (long j = 0; j < height; ++j)
+    {
+      const long py  = mapY[j];
+      double*    out = &buffer[j * width];
+      if (py >= 0)
+      {
+        index[1] = origin[1] + LiftingWaveletPositionToSynopsis(py, sizes[level][1]);
+      }
+      for (long i = 0; i < width; ++i)
+      {
+        const long px = mapX[i];
+        if (px < 0 || py < 0)
+        {
+          out[i] = 0.;
+        }
+        else if (!(px & 1) && !(py & 1))
+        {
+          out[i] = approximation[(py / 2 - current[1].first) * currentWidth + px / 2 - current[0].first];
+        }
+        else
+        {
+          index[0] = origin[0] + LiftingWaveletPositionToSynopsis(px, sizes[level][0]);
+          out[i]   = static_cast<double>(input->GetPixel(index));
+        }
+      }
+    }
+
+    // Columns, then lines
+    for (long i = 0; i < width; ++i)
+    {
+      scheme.Inverse(&buffer[i], ey.first, height, width);
+    }
+    for (long j = 0; j < height; ++j)
+    {
+      scheme.Inverse(&buffer[j * width], ex.first, width, 1);
+    }
+
+    // Approximation of the previous level (the output at level 1)
+    next.resize(rebuilt[0].GetLength() * rebuilt[1].GetLength());
+    std::vector<double>::iterator out = next.begin();
+    for (long y = rebuilt[1].first; y <= rebuilt[1].last; ++y)
+    {
+      const double* line = &buffer[(y - ey.first) * width];
+      for (long x = rebuilt[0].first; x <= rebuilt[0].last; ++x, ++out)
+      {
+        *out = line[x - ex.first];
+      }
+    }
+    approximation.swap(next);
+  }
+
+  itk::ImageScanlineIterator<OutputImageType> it(output, outputRegionForThread);
+  std::vector<double>::const_iterator         in = approximation.begin();
+  for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine())
+  {
+    for (; !it.IsAtEndOfLine(); ++it, ++in)
+    {
+      it.Set(static_cast<OutputPixelType>(*in));
+      progress.CompletedPixel();
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage, Wavelet::WaveletDirection TDirectionOfTransformation>
+void LiftingWaveletImageFilter<TInputImage, TOutputImage, TDirectionOfTransformation>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Wavelet: " << m_Wavelet << std::endl;
+  os << indent << "NumberOfDecompositions: " << m_NumberOfDecompositions << std::endl;
+}
+
+} // end namespace otb
+
+#endif
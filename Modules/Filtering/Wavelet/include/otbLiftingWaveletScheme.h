@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLiftingWaveletScheme_h
+#define otbLiftingWaveletScheme_h
+
+#include <algorithm>
+#include <vector>
+
+namespace otb
+{
+
+namespace Wavelet
+{
+/** Wavelets implemented by LiftingWaveletScheme */
+enum LiftingWavelet
+{
+  LIFTING_HAAR = 0,
+  LEGALL_5_3   = 1,
+  CDF_9_7      = 2
+};
+}
+
+/** \class LiftingWaveletScheme
+ * \brief One dimensional lifting steps of the Haar, LeGall 5/3 and
+ * Cohen-Daubechies-Feauveau 9/7 wavelets.
+ *
+ * The transform works in place on a window of a signal: the sample at
+ * position p of the window becomes the low-pass coefficient p/2 when p is
+ * even, and the high-pass coefficient (p-1)/2 when p is odd. Positions are
+ * given in the coordinates of the whole signal, so that a window may start
+ * anywhere (even before the first sample).
+ *
+ * Each lifting step updates the samples of one parity from their two
+ * neighbours, hence the GetMargin() first and last values of a window are
+ * not valid after a transform. A window holding the symmetric extension of
+ * the signal (ExtendSample()) gives the exact coefficients of the signal on
+ * its valid part, and conversely for the inverse transform with
+ * ExtendCoefficient(): tiles can be processed independently.
+ *
+ * The 5/3 and 9/7 wavelets use the whole-sample symmetric extension, which
+ * also holds for their coefficients. The Haar wavelet uses the half-sample
+ * symmetric extension, which nulls the missing high-pass coefficient of
+ * signals of odd length.
+ *
+ * The low-pass filters have a unit gain: the approximation of a constant
+ * signal is the constant itself.
+ *
+ * \ingroup OTBWavelet
+ * \sa LiftingWaveletImageFilter
+ */
+class LiftingWaveletScheme
+{
+public:
+  typedef Wavelet::LiftingWavelet WaveletType;
+
+  /** Closed interval of positions along one axis, empty when first > last */
+  struct Interval
+  {
+    long first;
+    long last;
+
+    Interval() : first(0), last(-1)
+    {
+    }
+    Interval(long f, long l) : first(f), last(l)
+    {
+    }
+    bool IsEmpty() const
+    {
+      return first > last;
+    }
+    long GetLength() const
+    {
+      return IsEmpty() ? 0 : last - first + 1;
+    }
+    /** Grow to the bounding interval of both */
+    void Merge(const Interval& other)
+    {
+      if (other.IsEmpty())
+      {
+        return;
+      }
+      if (IsEmpty())
+      {
+        *this = other;
+        return;
+      }
+      first = std::min(first, other.first);
+      last  = std::max(last, other.last);
+    }
+    Interval Intersect(const Interval& other) const
+    {
+      return Interval(std::max(first, other.first), std::min(last, other.last));
+    }
+    Interval Dilate(long radius) const
+    {
+      return IsEmpty() ? *this : Interval(first - radius, last + radius);
+    }
+  };
+
+  explicit LiftingWaveletScheme(WaveletType wavelet = Wavelet::CDF_9_7) : m_Wavelet(wavelet), m_LowPassScale(1.), m_HighPassScale(1.)
+  {
+    switch (wavelet)
+    {
+    case Wavelet::LIFTING_HAAR:
+      // d = x(2n+1) - x(2n), s = x(2n) + d / 2
+      m_Steps.push_back(Step(1, -1., 0.));
+      m_Steps.push_back(Step(0, 0., 0.5));
+      break;
+    case Wavelet::LEGALL_5_3:
+      m_Steps.push_back(Step(1, -0.5, -0.5));
+      m_Steps.push_back(Step(0, 0.25, 0.25));
+      break;
+    case Wavelet::CDF_9_7:
+    default:
+    {
+      // Lifting factorization of JPEG 2000
+      const double k = 1.230174104914001;
+      m_Steps.push_back(Step(1, -1.586134342059924, -1.586134342059924));
+      m_Steps.push_back(Step(0, -0.052980118572961, -0.052980118572961));
+      m_Steps.push_back(Step(1, 0.882911075530934, 0.882911075530934));
+      m_Steps.push_back(Step(0, 0.443506852043971, 0.443506852043971));
+      m_LowPassScale  = 1. / k;
+      m_HighPassScale = k / 2.;
+      m_Wavelet       = Wavelet::CDF_9_7;
+      break;
+    }
+    }
+  }
+
+  WaveletType GetWavelet() const
+  {
+    return m_Wavelet;
+  }
+
+  /** Number of positions, on each side of a window, which are not valid
+   * after a forward or an inverse transform */
+  long GetMargin() const
+  {
+    return static_cast<long>(m_Steps.size());
+  }
+
+  /** Position of the sample of a signal of the given length holding the
+   * value at position p of its symmetric extension */
+  long ExtendSample(long p, long length) const
+  {
+    if (m_Wavelet == Wavelet::LIFTING_HAAR)
+    {
+      while (p < 0 || p >= length)
+      {
+        p = p < 0 ? -1 - p : 2 * length - 1 - p;
+      }
+      return p;
+    }
+    if (length == 1)
+    {
+      return 0;
+    }
+    while (p < 0 || p >= length)
+    {
+      p = p < 0 ? -p : 2 * (length - 1) - p;
+    }
+    return p;
+  }
+
+  /** Position of the coefficient (interleaved low and high-pass) holding the
+   * coefficient at position p of the transform of the extended signal, or -1
+   * if that coefficient is null */
+  long ExtendCoefficient(long p, long length) const
+  {
+    if (m_Wavelet == Wavelet::LIFTING_HAAR)
+    {
+      return (p < 0 || p >= length) ? -1 : p;
+    }
+    if (length == 1)
+    {
+      // The extension of a single sample is constant: no details
+      return (p & 1) ? -1 : 0;
+    }
+    return ExtendSample(p, length);
+  }
+
+  /** Bounding interval of the samples read by the extension of a window */
+  Interval GetSampleSupport(const Interval& window, long length) const
+  {
+    Interval support;
+    for (long p = window.first; p <= window.last; ++p)
+    {
+      const long q = ExtendSample(p, length);
+      support.Merge(Interval(q, q));
+    }
+    return support;
+  }
+
+  /** Bounding interval of the non null coefficients read by the extension of
+   * a window */
+  Interval GetCoefficientSupport(const Interval& window, long length) const
+  {
+    Interval support;
+    for (long p = window.first; p <= window.last; ++p)
+    {
+      const long q = ExtendCoefficient(p, length);
+      if (q >= 0)
+      {
+        support.Merge(Interval(q, q));
+      }
+    }
+    return support;
+  }
+
+  /** In place forward transform of length values spaced by stride, the first
+   * one being at position first of the signal */
+  void Forward(double* buffer, long first, long length, long stride) const
+  {
+    for (std::vector<Step>::const_iterator it = m_Steps.begin(); it != m_Steps.end(); ++it)
+    {
+      ApplyStep(buffer, first, length, stride, it->parity, it->left, it->right);
+    }
+    Scale(buffer, first, length, stride, m_LowPassScale, m_HighPassScale);
+  }
+
+  /** In place inverse transform, undoing Forward() */
+  void Inverse(double* buffer, long first, long length, long stride) const
+  {
+    Scale(buffer, first, length, stride, 1. / m_LowPassScale, 1. / m_HighPassScale);
+    for (std::vector<Step>::const_reverse_iterator it = m_Steps.rbegin(); it != m_Steps.rend(); ++it)
+    {
+      ApplyStep(buffer, first, length, stride, it->parity, -it->left, -it->right);
+    }
+  }
+
+private:
+  /** x(p) += left * x(p-1) + right * x(p+1) for the positions p of the given
+   * parity */
+  struct Step
+  {
+    long   parity;
+    double left;
+    double right;
+
+    Step(long p, double l, double r) : parity(p), left(l), right(r)
+    {
+    }
+  };
+
+  static void ApplyStep(double* buffer, long first, long length, long stride, long parity, double left, double right)
+  {
+    // Only the positions having both neighbours in the window are updated
+    for (long j = ((first + 1) & 1) == parity ? 1 : 2; j < length - 1; j += 2)
+    {
+      double* x = buffer + j * stride;
+      *x += left * x[-stride] + right * x[stride];
+    }
+  }
+
+  static void Scale(double* buffer, long first, long length, long stride, double lowPassScale, double highPassScale)
+  {
+    if (lowPassScale == 1. && highPassScale == 1.)
+    {
+      return;
+    }
+    for (long j = 0; j < length; ++j)
+    {
+      buffer[j * stride] *= ((first + j) & 1) ? highPassScale : lowPassScale;
+    }
+  }
+
+  WaveletType       m_Wavelet;
+  std::vector<Step> m_Steps;
+  double            m_LowPassScale;
+  double            m_HighPassScale;
+};
+
+} // end namespace otb
+
+#endif
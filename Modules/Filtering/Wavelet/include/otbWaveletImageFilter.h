@@ -40,6 +40,7 @@ namespace otb
  * \sa WaveletInverseImageFilter
  * \sa WaveletsBandsListToWaveletsSynopsisImageFilter
  * \sa WaveletGenerator
+ * \sa LiftingWaveletImageFilter
  */
 template <class TInputImage, class TOutputImage, Wavelet::Wavelet TMotherWaveletOperator>
 class WaveletImageFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
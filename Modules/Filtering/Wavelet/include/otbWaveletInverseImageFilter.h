@@ -39,6 +39,7 @@ namespace otb
  * \sa WaveletImageFilter
  * \sa WaveletsSynopsisImageToWaveletsBandsListFilter
  * \sa WaveletGenerator
+ * \sa LiftingWaveletImageFilter
  */
 template <class TInputImage, class TOutputImage, Wavelet::Wavelet TMotherWaveletOperator>
 class WaveletInverseImageFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+This test runs the lifting wavelet transform on the whole image and through
+streaming divisions, which shall give the same synopsis, and checks that the
+streamed inverse transform rebuilds the input image.
+
+The known coefficients test checks the synopsis of synthetic images: a
+constant image has no details and its approximation is the constant, and the
+details of a linear ramp are null away from the borders for the wavelets
+having two vanishing moments (5/3 and 9/7), whose approximation is then the
+subsampled ramp.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkStreamingImageFilter.h"
+
+#include "otbImage.h"
+#include "otbImageFileReader.h"
+#include "otbLiftingWaveletImageFilter.h"
+
+namespace
+{
+typedef otb::Image<double, 2> LiftingImageType;
+
+double MaximumDifference(const LiftingImageType* a, const LiftingImageType* b)
+{
+  itk::ImageRegionConstIterator<LiftingImageType> itA(a, a->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<LiftingImageType> itB(b, b->GetLargestPossibleRegion());
+  double                                          maxError = 0.;
+  for (itA.GoToBegin(), itB.GoToBegin(); !itA.IsAtEnd(); ++itA, ++itB)
+  {
+    maxError = std::max(maxError, std::abs(itA.Get() - itB.Get()) / (1. + std::abs(itA.Get())));
+  }
+  return maxError;
+}
+
+/** Checks the coefficients of a synopsis quadrant, whose indices along each
+ * axis are those of the low-pass (part 0) or high-pass (part 1) coefficients
+ * of a level. Coefficients closer than margin to the quadrant borders are
+ * skipped. */
+bool CheckQuadrant(const LiftingImageType* synopsis, const long offset[2], const long size[2], long margin, double (*expected)(long, long, long),
+                   long step, const char* name)
+{
+  bool ok = true;
+  for (long j = margin; j < size[1] - margin; ++j)
+  {
+    for (long i = margin; i < size[0] - margin; ++i)
+    {
+      LiftingImageType::IndexType index;
+      index[0]               = offset[0] + i;
+      index[1]               = offset[1] + j;
+      const double reference = expected(i, j, step);
+      const double value     = synopsis->GetPixel(index);
+      if (std::abs(value - reference) > 1e-9 * (1. + std::abs(reference)))
+      {
+        std::cerr << name << " coefficient (" << i << ", " << j << ") at " << index << " is " << value << " instead of " << reference << std::endl;
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+double Constant(long, long, long)
+{
+  return 7.;
+}
+
+double Zero(long, long, long)
+{
+  return 0.;
+}
+
+double Ramp(long x, long y, long step)
+{
+  return 3. + 0.5 * x * step + 2. * y * step;
+}
+
+/** Checks the approximation of the last level and the details of every level
+ * of the synopsis of an image f */
+bool CheckSynopsis(const LiftingImageType* synopsis, unsigned int nbLevels, long margin, double (*approximation)(long, long, long), const char* name)
+{
+  const LiftingImageType::SizeType imageSize = synopsis->GetLargestPossibleRegion().GetSize();
+
+  bool ok      = true;
+  long size[2] = {static_cast<long>(imageSize[0]), static_cast<long>(imageSize[1])};
+  long step    = 1;
+  for (unsigned int level = 1; level <= nbLevels; ++level)
+  {
+    const long low[2]  = {(size[0] + 1) / 2, (size[1] + 1) / 2};
+    const long high[2] = {size[0] / 2, size[1] / 2};
+
+    const long horizontalOffset[2] = {low[0], 0};
+    const long horizontalSize[2]   = {high[0], low[1]};
+    const long verticalOffset[2]   = {0, low[1]};
+    const long verticalSize[2]     = {low[0], high[1]};
+
+    ok = CheckQuadrant(synopsis, horizontalOffset, horizontalSize, margin, Zero, step, name) && ok;
+    ok = CheckQuadrant(synopsis, verticalOffset, verticalSize, margin, Zero, step, name) && ok;
+    ok = CheckQuadrant(synopsis, low, high, margin, Zero, step, name) && ok;
+
+    size[0] = low[0];
+    size[1] = low[1];
+    step *= 2;
+  }
+
+  const long origin[2] = {0, 0};
+  return CheckQuadrant(synopsis, origin, size, margin, approximation, step, name) && ok;
+}
+}
+
+int otbLiftingWaveletImageFilter(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::ImageFileReader<LiftingImageType>                                                    ReaderType;
+  typedef otb::LiftingWaveletImageFilter<LiftingImageType, LiftingImageType, otb::Wavelet::FORWARD> FwdFilterType;
+  typedef otb::LiftingWaveletImageFilter<LiftingImageType, LiftingImageType, otb::Wavelet::INVERSE> InvFilterType;
+  typedef itk::StreamingImageFilter<LiftingImageType, LiftingImageType>                             StreamerType;
+
+  const char*                        inputFileName = argv[1];
+  const otb::Wavelet::LiftingWavelet wavelet       = static_cast<otb::Wavelet::LiftingWavelet>(atoi(argv[2]));
+  const unsigned int                 nbLevels      = atoi(argv[3]);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFileName);
+  reader->Update();
+
+  // Whole image at once
+  FwdFilterType::Pointer reference = FwdFilterType::New();
+  reference->SetWavelet(wavelet);
+  reference->SetNumberOfDecompositions(nbLevels);
+  reference->SetInput(reader->GetOutput());
+  reference->Update();
+
+  // Streamed forward transform
+  FwdFilterType::Pointer fwdFilter = FwdFilterType::New();
+  fwdFilter->SetWavelet(wavelet);
+  fwdFilter->SetNumberOfDecompositions(nbLevels);
+  fwdFilter->SetInput(reader->GetOutput());
+
+  StreamerType::Pointer fwdStreamer = StreamerType::New();
+  fwdStreamer->SetInput(fwdFilter->GetOutput());
+  fwdStreamer->SetNumberOfStreamDivisions(7);
+  fwdStreamer->Update();
+
+  const double streamingError = MaximumDifference(reference->GetOutput(), fwdStreamer->GetOutput());
+  std::cout << "Maximum relative difference between the streamed and whole transforms: " << streamingError << std::endl;
+
+  // Streamed inverse transform
+  InvFilterType::Pointer invFilter = InvFilterType::New();
+  invFilter->SetWavelet(wavelet);
+  invFilter->SetNumberOfDecompositions(nbLevels);
+  invFilter->SetInput(reference->GetOutput());
+
+  StreamerType::Pointer invStreamer = StreamerType::New();
+  invStreamer->SetInput(invFilter->GetOutput());
+  invStreamer->SetNumberOfStreamDivisions(5);
+  invStreamer->Update();
+
+  const double reconstructionError = MaximumDifference(reader->GetOutput(), invStreamer->GetOutput());
+  std::cout << "Maximum relative reconstruction error: " << reconstructionError << std::endl;
+
+  return (streamingError < 1e-9 && reconstructionError < 1e-9) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int otbLiftingWaveletImageFilterKnownCoefficients(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::LiftingWaveletImageFilter<LiftingImageType, LiftingImageType, otb::Wavelet::FORWARD> FwdFilterType;
+
+  const otb::Wavelet::LiftingWavelet wavelet  = static_cast<otb::Wavelet::LiftingWavelet>(atoi(argv[1]));
+  const unsigned int                 nbLevels = 3;
+
+  LiftingImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 128);
+  region.SetSize(1, 93);
+
+  LiftingImageType::Pointer constant = LiftingImageType::New();
+  constant->SetRegions(region);
+  constant->Allocate();
+  constant->FillBuffer(Constant(0, 0, 1));
+
+  LiftingImageType::Pointer ramp = LiftingImageType::New();
+  ramp->SetRegions(region);
+  ramp->Allocate();
+  itk::ImageRegionIteratorWithIndex<LiftingImageType> it(ramp, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    it.Set(Ramp(it.GetIndex()[0], it.GetIndex()[1], 1));
+  }
+
+  // Unit gain of the low-pass filter and no details, up to the borders
+  FwdFilterType::Pointer constantFilter = FwdFilterType::New();
+  constantFilter->SetWavelet(wavelet);
+  constantFilter->SetNumberOfDecompositions(nbLevels);
+  constantFilter->SetInput(constant);
+  constantFilter->Update();
+  bool ok = CheckSynopsis(constantFilter->GetOutput(), nbLevels, 0, Constant, "Constant");
+
+  if (wavelet != otb::Wavelet::LIFTING_HAAR)
+  {
+    // The symmetric extension breaks the ramp on the borders. The 9/7
+    // analysis filters read 4 positions around a coefficient, so the
+    // coefficients spoilt by the borders stay within 4 of them at each level.
+    FwdFilterType::Pointer rampFilter = FwdFilterType::New();
+    rampFilter->SetWavelet(wavelet);
+    rampFilter->SetNumberOfDecompositions(nbLevels);
+    rampFilter->SetInput(ramp);
+    rampFilter->Update();
+    ok = CheckSynopsis(rampFilter->GetOutput(), nbLevels, 5, Ramp, "Ramp") && ok;
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -28,4 +28,6 @@ void RegisterTests()
   REGISTER_TEST(otbSubsampleImageFilter);
   REGISTER_TEST(otbWaveletFilterBank);
   REGISTER_TEST(otbWaveletImageToImageFilter);
+  REGISTER_TEST(otbLiftingWaveletImageFilter);
+  REGISTER_TEST(otbLiftingWaveletImageFilterKnownCoefficients);
 }
@@ -29,6 +29,8 @@
 #include "itkMorphologyImageFilter.h"
 #include "itkBinaryBallStructuringElement.h"
 
+#include <vector>
+
 namespace otb
 {
 
@@ -57,6 +59,14 @@ namespace otb
  *     the image neighbors where the kernel has elements > 0.
  *   - Replace the original label value with the more representative label value
  *
+ * When the labels are integers spanning a small range (at most 65536
+ * values), the label histogram is not rebuilt for each pixel: it is a dense
+ * count array updated incrementally along each line of the output, the
+ * kernel elements leaving the window being removed and those entering it
+ * added. The cost per pixel is then proportional to the height of the
+ * structuring element rather than to its area. The results are the same as
+ * with Evaluate(), which is used for the other label types.
+ *
  * \sa MorphologyImageFilter, GrayscaleFunctionDilateImageFilter, BinaryDilateImageFilter
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
  *
@@ -105,6 +115,9 @@ public:
   /** Type of the pixels in the Kernel. */
   typedef typename TKernel::PixelType KernelPixelType;
 
+  /** Region typedef */
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(InputConvertibleToOutputCheck, (itk::Concept::Convertible<PixelType, typename TOutputImage::PixelType>));
@@ -156,6 +169,14 @@ protected:
 
   void GenerateOutputInformation() override;
 
+  /** Choose between the incremental histogram and Evaluate() */
+  void BeforeThreadedGenerateData() override;
+
+  /** Slide the window along the lines of the region with an incremental
+   * label histogram, or call the superclass implementation when the labels
+   * do not allow it */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
 
   // Type to store the useful information from the label histogram
   struct HistoSummary
@@ -197,6 +218,107 @@ private:
   // this threshold with the same label
   unsigned int m_IsolatedThreshold;
 
+  // Dense label histogram of a sliding window, which keeps track of the
+  // number of labels reaching each count to know the maximum count and
+  // whether it is reached by a single label
+  class LabelHistogram
+  {
+  public:
+    LabelHistogram(unsigned int numberOfBins, unsigned int windowSize)
+      : m_Counts(numberOfBins, 0), m_Positions(numberOfBins, 0), m_BinsPerCount(windowSize + 1, 0), m_MaximumCount(0)
+    {
+    }
+
+    void Add(unsigned int bin)
+    {
+      unsigned int& count = m_Counts[bin];
+      if (count == 0)
+      {
+        m_Positions[bin] = static_cast<unsigned int>(m_PresentBins.size());
+        m_PresentBins.push_back(bin);
+      }
+      else
+      {
+        --m_BinsPerCount[count];
+      }
+      ++count;
+      ++m_BinsPerCount[count];
+      if (count > m_MaximumCount)
+      {
+        m_MaximumCount = count;
+      }
+    }
+
+    void Remove(unsigned int bin)
+    {
+      unsigned int& count = m_Counts[bin];
+      --m_BinsPerCount[count];
+      if (count == m_MaximumCount && m_BinsPerCount[count] == 0)
+      {
+        --m_MaximumCount;
+      }
+      --count;
+      if (count == 0)
+      {
+        // Move the last present bin to the position of the removed one
+        const unsigned int last = m_PresentBins.back();
+        m_PresentBins[m_Positions[bin]] = last;
+        m_Positions[last]               = m_Positions[bin];
+        m_PresentBins.pop_back();
+      }
+      else
+      {
+        ++m_BinsPerCount[count];
+      }
+    }
+
+    void Clear()
+    {
+      for (unsigned int bin : m_PresentBins)
+      {
+        m_BinsPerCount[m_Counts[bin]] = 0;
+        m_Counts[bin]                 = 0;
+      }
+      m_PresentBins.clear();
+      m_MaximumCount = 0;
+    }
+
+    unsigned int GetCount(unsigned int bin) const
+    {
+      return m_Counts[bin];
+    }
+
+    bool IsMajorityUnique() const
+    {
+      return m_BinsPerCount[m_MaximumCount] == 1;
+    }
+
+    unsigned int GetMajorityBin() const
+    {
+      for (unsigned int bin : m_PresentBins)
+      {
+        if (m_Counts[bin] == m_MaximumCount)
+        {
+          return bin;
+        }
+      }
+      return 0;
+    }
+
+  private:
+    std::vector<unsigned int> m_Counts;
+    std::vector<unsigned int> m_Positions;
+    std::vector<unsigned int> m_PresentBins;
+    std::vector<unsigned int> m_BinsPerCount;
+    unsigned int              m_MaximumCount;
+  };
+
+  // Whether ThreadedGenerateData() uses the incremental histogram, and the
+  // labels its bins stand for
+  bool         m_UseLabelHistogram;
+  PixelType    m_MinimumLabel;
+  unsigned int m_NumberOfLabels;
+
 }; // end of class
 
 } // end namespace otb
@@ -30,6 +30,12 @@
 #include "itkMetaDataObject.h"
 #include "otbMetaDataKey.h"
 #include "otbNoDataHelper.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+
+#include <cstdlib>
+#include <limits>
 
 namespace otb
 {
@@ -38,6 +44,7 @@ namespace otb
  */
 template <class TInputImage, class TOutputImage, class TKernel>
 NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>::NeighborhoodMajorityVotingImageFilter()
+  : m_UseLabelHistogram(false), m_MinimumLabel(itk::NumericTraits<PixelType>::Zero), m_NumberOfLabels(0)
 {
   this->SetLabelForNoDataPixels(itk::NumericTraits<PixelType>::NonpositiveMin());    // m_LabelForNoDataPixels = 0
   this->SetLabelForUndecidedPixels(itk::NumericTraits<PixelType>::NonpositiveMin()); // m_LabelForUndecidedPixels = 0
@@ -151,6 +158,180 @@ void NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>::
   WriteNoDataFlags(noDataValueAvailable, noDataValue, outputPtr->GetImageMetadata());
 }
 
+template <class TInputImage, class TOutputImage, class TKernel>
+void NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  // The incremental histogram needs integer labels, and a center pixel which
+  // always votes (as assumed by ComputeNeighborhoodHistogramSummary())
+  m_UseLabelHistogram = false;
+  const KernelType& kernel = this->GetKernel();
+  if (!std::numeric_limits<PixelType>::is_integer || !(kernel[kernel.GetCenterNeighborhoodIndex()] > itk::NumericTraits<KernelPixelType>::Zero))
+  {
+    return;
+  }
+
+  // Range of the labels, no-data excluded
+  const TInputImage* input = this->GetInput();
+  bool               found = false;
+  PixelType          minimum(itk::NumericTraits<PixelType>::Zero);
+  PixelType          maximum(itk::NumericTraits<PixelType>::Zero);
+  for (itk::ImageRegionConstIterator<TInputImage> it(input, input->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const PixelType label = it.Get();
+    if (label != m_LabelForNoDataPixels)
+    {
+      minimum = (!found || label < minimum) ? label : minimum;
+      maximum = (!found || label > maximum) ? label : maximum;
+      found   = true;
+    }
+  }
+
+  // Bounded so that the count array of each thread stays small
+  const double numberOfLabels = static_cast<double>(maximum) - static_cast<double>(minimum) + 1.0;
+  if (numberOfLabels <= 65536.0)
+  {
+    m_UseLabelHistogram = true;
+    m_MinimumLabel      = minimum;
+    m_NumberOfLabels    = static_cast<unsigned int>(numberOfLabels);
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TKernel>
+void NeighborhoodMajorityVotingImageFilter<TInputImage, TOutputImage, TKernel>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                                  itk::ThreadIdType            threadId)
+{
+  if (!m_UseLabelHistogram)
+  {
+    Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+  }
+
+  typedef typename TInputImage::OffsetType OffsetType;
+  typedef typename TInputImage::IndexType  IndexType;
+  typedef typename TOutputImage::PixelType OutputPixelType;
+
+  const TInputImage*                     input          = this->GetInput();
+  TOutputImage*                          output         = this->GetOutput();
+  const typename TInputImage::RegionType bufferedRegion = input->GetBufferedRegion();
+  const KernelType&                      kernel         = this->GetKernel();
+
+  auto isVoting = [&kernel](const OffsetType& offset) {
+    for (unsigned int d = 0; d < KernelDimension; ++d)
+    {
+      if (std::abs(offset[d]) > static_cast<itk::OffsetValueType>(kernel.GetRadius(d)))
+      {
+        return false;
+      }
+    }
+    return kernel[kernel.GetNeighborhoodIndex(offset)] > itk::NumericTraits<KernelPixelType>::Zero;
+  };
+
+  // Offsets of the voting elements of the kernel: all of them, those which
+  // enter the window (relatively to the new center) and those which leave it
+  // (relatively to the old center) when it moves by one pixel along a line
+  std::vector<OffsetType> windowOffsets;
+  std::vector<OffsetType> enteringOffsets;
+  std::vector<OffsetType> leavingOffsets;
+  for (unsigned int i = 0; i < kernel.Size(); ++i)
+  {
+    if (kernel[i] > itk::NumericTraits<KernelPixelType>::Zero)
+    {
+      const OffsetType offset   = kernel.GetOffset(i);
+      OffsetType       next     = offset;
+      OffsetType       previous = offset;
+      next[0] += 1;
+      previous[0] -= 1;
+      windowOffsets.push_back(offset);
+      if (!isVoting(next))
+      {
+        enteringOffsets.push_back(offset);
+      }
+      if (!isVoting(previous))
+      {
+        leavingOffsets.push_back(offset);
+      }
+    }
+  }
+
+  // Pixels outside of the buffer get the no-data label through the boundary
+  // condition: they do not vote
+  LabelHistogram histogram(m_NumberOfLabels, windowOffsets.size());
+  auto           labelBin = [this](const PixelType& label) { return static_cast<unsigned int>(label - m_MinimumLabel); };
+  auto           update   = [&](const IndexType& index, bool add) {
+    if (bufferedRegion.IsInside(index))
+    {
+      const PixelType label = input->GetPixel(index);
+      if (label != m_LabelForNoDataPixels)
+      {
+        if (add)
+        {
+          histogram.Add(labelBin(label));
+        }
+        else
+        {
+          histogram.Remove(labelBin(label));
+        }
+      }
+    }
+  };
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  itk::ImageScanlineIterator<TOutputImage> outIt(output, outputRegionForThread);
+  while (!outIt.IsAtEnd())
+  {
+    // Fill the window of the first pixel of the line
+    IndexType center = outIt.GetIndex();
+    histogram.Clear();
+    for (const OffsetType& offset : windowOffsets)
+    {
+      update(center + offset, true);
+    }
+
+    while (!outIt.IsAtEndOfLine())
+    {
+      if (outIt.GetIndex()[0] != center[0])
+      {
+        for (const OffsetType& offset : leavingOffsets)
+        {
+          update(center + offset, false);
+        }
+        ++center[0];
+        for (const OffsetType& offset : enteringOffsets)
+        {
+          update(center + offset, true);
+        }
+      }
+
+      // Same decision as Evaluate()
+      const PixelType centerPixel = input->GetPixel(center);
+      PixelType       result      = centerPixel;
+      if (centerPixel == m_LabelForNoDataPixels)
+      {
+        result = m_LabelForNoDataPixels;
+      }
+      else if (!(m_OnlyIsolatedPixels && histogram.GetCount(labelBin(centerPixel)) > m_IsolatedThreshold))
+      {
+        if (!histogram.IsMajorityUnique())
+        {
+          result = m_KeepOriginalLabelBool ? centerPixel : m_LabelForUndecidedPixels;
+        }
+        else
+        {
+          result = static_cast<PixelType>(m_MinimumLabel + histogram.GetMajorityBin());
+        }
+      }
+      outIt.Set(static_cast<OutputPixelType>(result));
+
+      ++outIt;
+      progress.CompletedPixel();
+    }
+    outIt.NextLine();
+  }
+}
+
 } // end namespace otb
 
 #endif
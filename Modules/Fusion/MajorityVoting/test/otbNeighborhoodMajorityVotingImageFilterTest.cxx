@@ -27,6 +27,7 @@
 #include "otbImageFileWriter.h"
 
 #include "otbNeighborhoodMajorityVotingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
 
 
 int otbNeighborhoodMajorityVotingImageFilterTest(int argc, char* argv[])
@@ -206,3 +207,95 @@ int otbNeighborhoodMajorityVotingImageFilterIsolatedTest(int itkNotUsed(argc), c
   }
   return EXIT_SUCCESS;
 }
+
+namespace
+{
+template <class TImage>
+typename TImage::Pointer MajorityVoting(const TImage* image, unsigned int xRadius, unsigned int yRadius, bool keepOriginalLabel, bool onlyIsolatedPixels)
+{
+  typedef otb::NeighborhoodMajorityVotingImageFilter<TImage> NeighborhoodMajorityVotingFilterType;
+  typedef typename NeighborhoodMajorityVotingFilterType::KernelType StructuringType;
+
+  typename NeighborhoodMajorityVotingFilterType::Pointer filter = NeighborhoodMajorityVotingFilterType::New();
+  filter->SetInput(image);
+  filter->SetKeepOriginalLabelBool(keepOriginalLabel);
+  filter->SetLabelForNoDataPixels(10);
+  filter->SetLabelForUndecidedPixels(7);
+  filter->SetOnlyIsolatedPixels(onlyIsolatedPixels);
+  filter->SetIsolatedThreshold(3);
+
+  StructuringType                      seBall;
+  typename StructuringType::RadiusType rad;
+  rad[0] = xRadius;
+  rad[1] = yRadius;
+  seBall.SetRadius(rad);
+  seBall.CreateStructuringElement();
+  filter->SetKernel(seBall);
+  filter->Update();
+  return filter->GetOutput();
+}
+}
+
+int otbNeighborhoodMajorityVotingImageFilterIncrementalTest(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  // Integer labels use the incremental histogram, floating point labels use
+  // the per-pixel histogram of Evaluate(): both shall agree
+  typedef otb::Image<unsigned char, 2> LabelImageType;
+  typedef otb::Image<float, 2>         FloatImageType;
+
+  LabelImageType::RegionType region;
+  region.SetSize(0, 80);
+  region.SetSize(1, 60);
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(region);
+  labels->Allocate();
+  FloatImageType::Pointer floatLabels = FloatImageType::New();
+  floatLabels->SetRegions(region);
+  floatLabels->Allocate();
+
+  // Blocks of labels 0 to 4 with salt noise, ties, and some no-data (10) pixels
+  itk::ImageRegionIteratorWithIndex<LabelImageType> it(labels, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const int     x     = it.GetIndex()[0];
+    const int     y     = it.GetIndex()[1];
+    unsigned char label = ((x / 7) + (y / 5)) % 5;
+    if ((x * 31 + y * 17) % 11 == 0)
+    {
+      label = (x + y) % 5;
+    }
+    if ((x * 13 + y * 29) % 23 == 0)
+    {
+      label = 10;
+    }
+    it.Set(label);
+    floatLabels->SetPixel(it.GetIndex(), label);
+  }
+
+  const unsigned int radii[3][2] = {{1, 1}, {2, 5}, {4, 3}};
+  for (unsigned int r = 0; r < 3; ++r)
+  {
+    for (unsigned int config = 0; config < 4; ++config)
+    {
+      const bool keepOriginalLabel  = (config & 1) != 0;
+      const bool onlyIsolatedPixels = (config & 2) != 0;
+
+      LabelImageType::Pointer incremental = MajorityVoting<LabelImageType>(labels, radii[r][0], radii[r][1], keepOriginalLabel, onlyIsolatedPixels);
+      FloatImageType::Pointer reference   = MajorityVoting<FloatImageType>(floatLabels, radii[r][0], radii[r][1], keepOriginalLabel, onlyIsolatedPixels);
+
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+        const float expected = reference->GetPixel(it.GetIndex());
+        const float result   = incremental->GetPixel(it.GetIndex());
+        if (expected != result)
+        {
+          std::cout << "Radius (" << radii[r][0] << ", " << radii[r][1] << "), keep original label " << keepOriginalLabel << ", only isolated pixels "
+                    << onlyIsolatedPixels << ": pixel " << it.GetIndex() << " is " << result << " instead of " << expected << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
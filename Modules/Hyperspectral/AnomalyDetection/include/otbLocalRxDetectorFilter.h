@@ -146,6 +146,88 @@ public:
 };
 
 } // end namespace functor
+
+/** \class LocalRxDetectorFilter
+ * \brief Computes the local Rx score of each pixel of a vector image.
+ *
+ * The score of a pixel x is (x - m)^T C^-1 (x - m), where m and C are the mean
+ * and the covariance matrix of the pixels of the annulus between the internal
+ * and the external radius around x. It is the score of
+ * Functor::LocalRxDetectionFunctor (with pixels outside the image replicated
+ * from the border), computed without visiting the neighborhood of each pixel:
+ *
+ * - the sums of the first and second moments of the pixels are slid down the
+ *   columns, then along the rows, for the external and the internal windows,
+ *   so that the annulus statistics cost O(bands^2) per pixel whatever the
+ *   radius,
+ * - C z = x - m is solved with a Cholesky factorization instead of an explicit
+ *   inversion (the pseudo-inverse of C is used if C is not positive
+ *   definite).
+ *
+ * Each thread processes its region by vertical strips, so that the column
+ * sums of a strip fit in a bounded amount of memory whatever the number of
+ * bands. The moments are accumulated relative to a pixel of the region, to
+ * limit the cancellation in the covariance.
+ *
+ * \sa Functor::LocalRxDetectionFunctor
+ *
+ * \ingroup OTBAnomalyDetection
+ */
+template <class TInputImage, class TOutputImage>
+class ITK_EXPORT LocalRxDetectorFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef LocalRxDetectorFilter Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LocalRxDetectorFilter, ImageToImageFilter);
+
+  /** typedef related to input and output images */
+  typedef TInputImage                                InputImageType;
+  typedef typename InputImageType::RegionType        InputRegionType;
+  typedef typename InputImageType::InternalPixelType InputInternalPixelType;
+  typedef TOutputImage                               OutputImageType;
+  typedef typename OutputImageType::PixelType        OutputPixelType;
+  typedef typename OutputImageType::RegionType       OutputImageRegionType;
+
+  /** Radius of the window of the background statistics */
+  itkSetMacro(ExternalRadius, unsigned int);
+  itkGetConstMacro(ExternalRadius, unsigned int);
+
+  /** Radius of the window around the pixel excluded from the statistics */
+  itkSetMacro(InternalRadius, unsigned int);
+  itkGetConstMacro(InternalRadius, unsigned int);
+
+protected:
+  LocalRxDetectorFilter();
+  ~LocalRxDetectorFilter() override
+  {
+  }
+
+  void GenerateInputRequestedRegion() override;
+  void BeforeThreadedGenerateData() override;
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  LocalRxDetectorFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  unsigned int m_ExternalRadius;
+  unsigned int m_InternalRadius;
+};
+
 } // end namespace otb
 
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbLocalRxDetectorFilter.hxx"
+#endif
+
 #endif
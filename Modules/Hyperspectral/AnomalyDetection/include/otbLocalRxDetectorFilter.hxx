@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLocalRxDetectorFilter_hxx
+#define otbLocalRxDetectorFilter_hxx
+
+#include "otbLocalRxDetectorFilter.h"
+#include "itkProgressReporter.h"
+#include "vnl/algo/vnl_matrix_inverse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace otb
+{
+
+namespace internal
+{
+/** In-place Cholesky factorization of the n x n symmetric matrix a (row major,
+ * only the lower triangle is used). Returns false if a is not positive
+ * definite. */
+inline bool CholeskyDecompose(double* a, unsigned int n)
+{
+  for (unsigned int j = 0; j < n; ++j)
+  {
+    const double* rowJ     = a + j * n;
+    double        diagonal = rowJ[j];
+    for (unsigned int k = 0; k < j; ++k)
+    {
+      diagonal -= rowJ[k] * rowJ[k];
+    }
+    if (!(diagonal > 0.))
+    {
+      return false;
+    }
+    diagonal      = std::sqrt(diagonal);
+    a[j * n + j] = diagonal;
+    for (unsigned int i = j + 1; i < n; ++i)
+    {
+      double* rowI = a + i * n;
+      double  sum  = rowI[j];
+      for (unsigned int k = 0; k < j; ++k)
+      {
+        sum -= rowI[k] * rowJ[k];
+      }
+      rowI[j] = sum / diagonal;
+    }
+  }
+  return true;
+}
+
+/** d^T (L L^T)^-1 d, for the Cholesky factor L computed by
+ * CholeskyDecompose(). d is overwritten by L^-1 d. */
+inline double CholeskySquaredNorm(const double* l, unsigned int n, double* d)
+{
+  double result = 0.;
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    const double* rowI = l + i * n;
+    double        sum  = d[i];
+    for (unsigned int k = 0; k < i; ++k)
+    {
+      sum -= rowI[k] * d[k];
+    }
+    d[i] = sum / rowI[i];
+    result += d[i] * d[i];
+  }
+  return result;
+}
+
+/** Add sign times the first moments (n values) and the second moments (upper
+ * triangle, row by row) of (pixel - reference) to sums */
+template <class TValue>
+inline void AccumulateMoments(const TValue* pixel, const double* reference, unsigned int n, double sign, double* centered, double* sums)
+{
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    centered[i] = static_cast<double>(pixel[i]) - reference[i];
+    sums[i] += sign * centered[i];
+  }
+  double* second = sums + n;
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    const double value = sign * centered[i];
+    for (unsigned int j = i; j < n; ++j)
+    {
+      second[j] += value * centered[j];
+    }
+    second += n - i - 1;
+  }
+}
+
+/** sums += sign * values, for size values */
+inline void AccumulateSums(const double* values, unsigned int size, double sign, double* sums)
+{
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    sums[i] += sign * values[i];
+  }
+}
+} // end namespace internal
+
+template <class TInputImage, class TOutputImage>
+LocalRxDetectorFilter<TInputImage, TOutputImage>::LocalRxDetectorFilter() : m_ExternalRadius(5), m_InternalRadius(1)
+{
+}
+
+template <class TInputImage, class TOutputImage>
+void LocalRxDetectorFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType* inputPtr = const_cast<InputImageType*>(this->GetInput());
+  if (!inputPtr)
+  {
+    return;
+  }
+
+  // pad the input requested region by the external radius
+  InputRegionType inputRequestedRegion = inputPtr->GetRequestedRegion();
+  inputRequestedRegion.PadByRadius(m_ExternalRadius);
+
+  // crop the input requested region at the input's largest possible region
+  if (inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()))
+  {
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+    return;
+  }
+  else
+  {
+    // Couldn't crop the region (requested region is outside the largest
+    // possible region).  Throw an exception.
+
+    // store what we tried to request (prior to trying to crop)
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+
+    // build an exception
+    itk::InvalidRequestedRegionError e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+    e.SetDataObject(inputPtr);
+    throw e;
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+void LocalRxDetectorFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  if (m_InternalRadius >= m_ExternalRadius)
+  {
+    itkExceptionMacro(<< "The internal radius (" << m_InternalRadius << ") shall be lower than the external radius (" << m_ExternalRadius << ")");
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+void LocalRxDetectorFilter<TInputImage, TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  // Column sums of a strip are kept within this amount of memory
+  const std::size_t maximumStripMemory = 32 * 1024 * 1024;
+
+  const InputImageType* input  = this->GetInput();
+  OutputImageType*      output = this->GetOutput();
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const unsigned int nbBands    = input->GetNumberOfComponentsPerPixel();
+  const unsigned int nbMoments  = nbBands + nbBands * (nbBands + 1) / 2;
+  const int          extRadius  = static_cast<int>(m_ExternalRadius);
+  const int          intRadius  = static_cast<int>(m_InternalRadius);
+  const double       nbExternal = (2. * extRadius + 1.) * (2. * extRadius + 1.);
+  const double       nbInternal = (2. * intRadius + 1.) * (2. * intRadius + 1.);
+  const double       nbAnnulus  = nbExternal - nbInternal;
+
+  // Pixels outside the image are replicated from the border, as the default
+  // boundary condition of the neighborhood iterators does
+  const InputRegionType         buffered = input->GetBufferedRegion();
+  const InputInternalPixelType* buffer   = input->GetBufferPointer();
+  const long                    minX     = buffered.GetIndex(0);
+  const long                    minY     = buffered.GetIndex(1);
+  const long                    maxX     = minX + static_cast<long>(buffered.GetSize(0)) - 1;
+  const long                    maxY     = minY + static_cast<long>(buffered.GetSize(1)) - 1;
+  auto pixelAt = [=](long x, long y) {
+    x = std::min(std::max(x, minX), maxX);
+    y = std::min(std::max(y, minY), maxY);
+    return buffer + ((y - minY) * static_cast<long>(buffered.GetSize(0)) + (x - minX)) * nbBands;
+  };
+
+  const long regionX     = outputRegionForThread.GetIndex(0);
+  const long regionY     = outputRegionForThread.GetIndex(1);
+  const long regionSizeX = static_cast<long>(outputRegionForThread.GetSize(0));
+  const long regionSizeY = static_cast<long>(outputRegionForThread.GetSize(1));
+
+  const std::size_t columnMemory = 2 * nbMoments * sizeof(double);
+  const long        stripWidth   = std::max(1L, static_cast<long>(maximumStripMemory / columnMemory) - 2 * extRadius);
+
+  std::vector<double> reference(nbBands);
+  std::copy(pixelAt(regionX, regionY), pixelAt(regionX, regionY) + nbBands, reference.begin());
+
+  std::vector<double> centered(nbBands);
+  std::vector<double> externalSums(nbMoments);
+  std::vector<double> internalSums(nbMoments);
+  std::vector<double> mean(nbBands);
+  std::vector<double> difference(nbBands);
+  std::vector<double> covariance(nbBands * nbBands);
+
+  for (long stripX = regionX; stripX < regionX + regionSizeX; stripX += stripWidth)
+  {
+    const long width    = std::min(stripWidth, regionX + regionSizeX - stripX);
+    const long nbColumn = width + 2 * extRadius;
+    const long firstX   = stripX - extRadius;
+
+    // Column sums of the external and internal windows, for the columns
+    // [firstX, firstX + nbColumn)
+    std::vector<double> externalColumns(nbColumn * nbMoments, 0.);
+    std::vector<double> internalColumns(nbColumn * nbMoments, 0.);
+
+    for (long y = regionY; y < regionY + regionSizeY; ++y)
+    {
+      // Slide the column sums down to row y
+      for (long c = 0; c < nbColumn; ++c)
+      {
+        double*    external = &externalColumns[c * nbMoments];
+        double*    internal = &internalColumns[c * nbMoments];
+        const long x        = firstX + c;
+        if (y == regionY)
+        {
+          for (long dy = -extRadius; dy <= extRadius; ++dy)
+          {
+            internal::AccumulateMoments(pixelAt(x, y + dy), reference.data(), nbBands, 1., centered.data(), external);
+          }
+          for (long dy = -intRadius; dy <= intRadius; ++dy)
+          {
+            internal::AccumulateMoments(pixelAt(x, y + dy), reference.data(), nbBands, 1., centered.data(), internal);
+          }
+        }
+        else
+        {
+          internal::AccumulateMoments(pixelAt(x, y + extRadius), reference.data(), nbBands, 1., centered.data(), external);
+          internal::AccumulateMoments(pixelAt(x, y - extRadius - 1), reference.data(), nbBands, -1., centered.data(), external);
+          internal::AccumulateMoments(pixelAt(x, y + intRadius), reference.data(), nbBands, 1., centered.data(), internal);
+          internal::AccumulateMoments(pixelAt(x, y - intRadius - 1), reference.data(), nbBands, -1., centered.data(), internal);
+        }
+      }
+
+      // Slide the window sums along the row. Column c is x = firstX + c, so
+      // that the external window of x = stripX is the columns [0, 2 R].
+      std::fill(externalSums.begin(), externalSums.end(), 0.);
+      std::fill(internalSums.begin(), internalSums.end(), 0.);
+      for (long c = 0; c <= 2 * extRadius; ++c)
+      {
+        internal::AccumulateSums(&externalColumns[c * nbMoments], nbMoments, 1., externalSums.data());
+      }
+      for (long c = extRadius - intRadius; c <= extRadius + intRadius; ++c)
+      {
+        internal::AccumulateSums(&internalColumns[c * nbMoments], nbMoments, 1., internalSums.data());
+      }
+
+      typename OutputImageType::IndexType index;
+      index[1] = y;
+      for (long x = stripX; x < stripX + width; ++x)
+      {
+        const long center = x - firstX;
+        if (x > stripX)
+        {
+          internal::AccumulateSums(&externalColumns[(center + extRadius) * nbMoments], nbMoments, 1., externalSums.data());
+          internal::AccumulateSums(&externalColumns[(center - extRadius - 1) * nbMoments], nbMoments, -1., externalSums.data());
+          internal::AccumulateSums(&internalColumns[(center + intRadius) * nbMoments], nbMoments, 1., internalSums.data());
+          internal::AccumulateSums(&internalColumns[(center - intRadius - 1) * nbMoments], nbMoments, -1., internalSums.data());
+        }
+
+        // Annulus statistics: unbiased covariance, as CovarianceSampleFilter
+        const InputInternalPixelType* pixel = pixelAt(x, y);
+        for (unsigned int i = 0; i < nbBands; ++i)
+        {
+          mean[i]       = (externalSums[i] - internalSums[i]) / nbAnnulus;
+          difference[i] = static_cast<double>(pixel[i]) - reference[i] - mean[i];
+        }
+        unsigned int k = nbBands;
+        for (unsigned int i = 0; i < nbBands; ++i)
+        {
+          for (unsigned int j = i; j < nbBands; ++j, ++k)
+          {
+            const double value = (externalSums[k] - internalSums[k] - nbAnnulus * mean[i] * mean[j]) / (nbAnnulus - 1.);
+            covariance[i * nbBands + j] = value;
+            covariance[j * nbBands + i] = value;
+          }
+        }
+
+        double score;
+        if (internal::CholeskyDecompose(covariance.data(), nbBands))
+        {
+          score = internal::CholeskySquaredNorm(covariance.data(), nbBands, difference.data());
+        }
+        else
+        {
+          // Singular covariance: fall back to its pseudo-inverse. The strict
+          // upper triangle has been left untouched by the factorization.
+          vnl_matrix<double> matrix(nbBands, nbBands);
+          for (unsigned int i = 0, diagonal = nbBands; i < nbBands; diagonal += nbBands - i, ++i)
+          {
+            matrix(i, i) = (externalSums[diagonal] - internalSums[diagonal] - nbAnnulus * mean[i] * mean[i]) / (nbAnnulus - 1.);
+            for (unsigned int j = i + 1; j < nbBands; ++j)
+            {
+              matrix(i, j) = covariance[i * nbBands + j];
+              matrix(j, i) = covariance[i * nbBands + j];
+            }
+          }
+          const vnl_vector<double> centeredPixel(difference.data(), nbBands);
+          score = dot_product(centeredPixel, vnl_matrix_inverse<double>(matrix).inverse() * centeredPixel);
+        }
+
+        index[0] = x;
+        output->SetPixel(index, static_cast<OutputPixelType>(score));
+        progress.CompletedPixel();
+      }
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+void LocalRxDetectorFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "ExternalRadius: " << m_ExternalRadius << std::endl;
+  os << indent << "InternalRadius: " << m_InternalRadius << std::endl;
+}
+
+} // end namespace otb
+
+#endif
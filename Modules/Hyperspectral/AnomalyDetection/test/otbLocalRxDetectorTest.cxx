@@ -23,6 +23,7 @@
 #include "otbLocalRxDetectorFilter.h"
 #include "itkRescaleIntensityImageFilter.h"
 #include "otbFunctorImageFilter.h"
+#include "itkImageRegionConstIterator.h"
 
 int LocalRXDetectorTest(int itkNotUsed(argc), char* argv[])
 {
@@ -72,3 +73,46 @@ int LocalRXDetectorTest(int itkNotUsed(argc), char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+int LocalRXDetectorFilterTest(int itkNotUsed(argc), char* argv[])
+{
+  typedef double PixelType;
+  typedef otb::VectorImage<PixelType, 2> VectorImageType;
+  typedef otb::Image<PixelType, 2>       ImageType;
+  typedef otb::Functor::LocalRxDetectionFunctor<PixelType> LocalRxDetectorFunctorType;
+  typedef otb::LocalRxDetectorFilter<VectorImageType, ImageType> LocalRxDetectorFilterType;
+  typedef otb::ImageFileReader<VectorImageType> ReaderType;
+
+  const char*        filename       = argv[1];
+  const unsigned int externalRadius = atoi(argv[2]);
+  const unsigned int internalRadius = atoi(argv[3]);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(filename);
+
+  // Reference: statistics computed from the whole neighborhood of each pixel
+  LocalRxDetectorFunctorType detectorFunctor;
+  detectorFunctor.SetInternalRadius(internalRadius, internalRadius);
+  auto reference = otb::NewFunctorFilter(detectorFunctor, {{externalRadius, externalRadius}});
+  reference->SetInputs(reader->GetOutput());
+  reference->Update();
+
+  LocalRxDetectorFilterType::Pointer rxDetector = LocalRxDetectorFilterType::New();
+  rxDetector->SetInput(reader->GetOutput());
+  rxDetector->SetExternalRadius(externalRadius);
+  rxDetector->SetInternalRadius(internalRadius);
+  rxDetector->Update();
+
+  itk::ImageRegionConstIterator<ImageType> refIt(reference->GetOutput(), reference->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> it(rxDetector->GetOutput(), rxDetector->GetOutput()->GetLargestPossibleRegion());
+  for (refIt.GoToBegin(), it.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++it)
+  {
+    if (std::abs(it.Get() - refIt.Get()) > 1e-6 * std::max(1., std::abs(refIt.Get())))
+    {
+      std::cerr << "Rx score " << it.Get() << " at " << it.GetIndex() << " differs from the reference " << refIt.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
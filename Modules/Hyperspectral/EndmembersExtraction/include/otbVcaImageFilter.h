@@ -32,10 +32,14 @@
 #include "otbPCAImageFilter.h"
 #include "otbVectorImageToAmplitudeImageFilter.h"
 #include "otbConcatenateScalarValueImageFilter.h"
+#include "otbStreamingStratifiedSampleImageFilter.h"
+#include "otbParallelForRange.h"
 
 #include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "vnl/algo/vnl_svd.h"
 
+#include <vector>
+
 namespace otb
 {
 
@@ -52,6 +56,19 @@ namespace otb
  * Most notably it supports streaming and is fully multi-threaded,
  * so it can be run seamlessly on full hyperspectral scenes.
  *
+ * The statistics of the input image (mean, correlation and covariance) are
+ * computed in a single streaming pass. They can also be given with
+ * SetStatisticsEstimator(), for instance when they have already been
+ * computed to estimate the number of endmembers, and are then not computed
+ * again.
+ *
+ * By default, each endmember is searched with a streaming pass over the
+ * whole image. When NumberOfSamples is not 0, a spatially stratified subset
+ * of about NumberOfSamples pixels is drawn in a single streaming pass and
+ * held in memory: the reduced samples are computed once, and each endmember
+ * is the argmax of the projections of the samples, searched concurrently
+ * by blocks of samples.
+ *
  * References :
  * "Vertex Component Analysis: A Fast Algorithm to Unmix Hyperspectral Data",
  * Jos\'e M. P. Nascimento, and Jos\'e M. Bioucas Dias,
@@ -95,6 +112,7 @@ public:
   typedef otb::PCAImageFilter<VectorImageType, VectorImageType, otb::Transform::INVERSE> InversePCAImageFilterType;
   typedef otb::VectorImageToAmplitudeImageFilter<VectorImageType, ImageType>       VectorImageToAmplitudeImageFilterType;
   typedef otb::ConcatenateScalarValueImageFilter<VectorImageType, VectorImageType> ConcatenateScalarValueImageFilterType;
+  typedef otb::StreamingStratifiedSampleImageFilter<VectorImageType>               SamplerFilterType;
 
   // creation of SmartPointer
   itkNewMacro(Self);
@@ -104,6 +122,20 @@ public:
   itkGetMacro(NumberOfEndmembers, unsigned int);
   itkSetMacro(NumberOfEndmembers, unsigned int);
 
+  /** Statistics of the input image, already updated. When not set, they are
+   * computed by the filter. */
+  itkSetObjectMacro(StatisticsEstimator, StreamingStatisticsVectorImageFilterType);
+  itkGetObjectMacro(StatisticsEstimator, StreamingStatisticsVectorImageFilterType);
+
+  /** Approximate number of pixels drawn to search the endmembers in memory.
+   * 0 (default) searches them in the whole image, with a streaming pass per
+   * endmember. */
+  itkSetMacro(NumberOfSamples, unsigned long);
+  itkGetConstMacro(NumberOfSamples, unsigned long);
+
+  /** Sampler of the pixels, e.g. to set its seed */
+  itkGetObjectMacro(Sampler, SamplerFilterType);
+
   void Update() override
   {
     this->GenerateData();
@@ -125,11 +157,45 @@ protected:
 
   void GenerateData() override;
 
+  /** Draw the samples and reduce them with Ud: with a projective projection
+   * in the high SNR case, after centering and with the maximum norm appended
+   * otherwise. */
+  void ReduceSamples(const vnl_matrix<PrecisionType>& Ud, const vnl_vector<PrecisionType>& mean, bool projective);
+
+  /** Index of the reduced sample with the largest absolute projection on f */
+  unsigned long ArgMaxSamples(const vnl_vector<PrecisionType>& f);
+
+  /** Reduce the samples [begin, end), four samples at a time */
+  void ThreadedReduceSamples(itk::ThreadIdType threadId, std::size_t begin, std::size_t end);
+
+  /** Search the sample of [begin, end) with the largest absolute projection
+   * on the given direction */
+  void ThreadedArgMaxSamples(const double* direction, itk::ThreadIdType threadId, std::size_t begin, std::size_t end);
+
 private:
   VCAImageFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
 
-  unsigned int m_NumberOfEndmembers;
+  unsigned int  m_NumberOfEndmembers;
+  unsigned long m_NumberOfSamples;
+
+  typename StreamingStatisticsVectorImageFilterType::Pointer m_StatisticsEstimator;
+  typename SamplerFilterType::Pointer                        m_Sampler;
+
+  /** In-memory search: transposed reduction matrix (one reduced component
+   * per row), offset removed before the reduction, direction of the
+   * projective projection, and reduced samples (NumberOfEndmembers values
+   * per sample) */
+  std::vector<double> m_ReductionMatrix;
+  std::vector<double> m_ReductionOffset;
+  std::vector<double> m_ProjectionDirection;
+  unsigned int        m_ReducedSize;
+  bool                m_Projective;
+  std::vector<double> m_ReducedSamples;
+
+  /** Per-thread results of the reduction and of the argmax */
+  std::vector<double>        m_ThreadMaxima;
+  std::vector<unsigned long> m_ThreadArgMax;
 };
 
 } // end namesapce otb
@@ -25,11 +25,14 @@
 #include "otbVcaImageFilter.h"
 #include "otbStandardWriterWatcher.h"
 
+#include <algorithm>
+
 namespace otb
 {
 
 template <class TImage>
-VCAImageFilter<TImage>::VCAImageFilter() : m_NumberOfEndmembers(0)
+VCAImageFilter<TImage>::VCAImageFilter()
+  : m_NumberOfEndmembers(0), m_NumberOfSamples(0), m_Sampler(SamplerFilterType::New()), m_ReducedSize(0), m_Projective(false)
 {
 }
 
@@ -77,12 +80,15 @@ void VCAImageFilter<TImage>::GenerateData()
   const unsigned int nbBands = this->GetInput()->GetNumberOfComponentsPerPixel();
 
 
-  otbMsgDevMacro("Computing image stats") typename StreamingStatisticsVectorImageFilterType::Pointer statsInput =
-      StreamingStatisticsVectorImageFilterType::New();
-
-  statsInput->SetInput(input);
-  statsInput->SetEnableMinMax(false);
-  statsInput->Update();
+  typename StreamingStatisticsVectorImageFilterType::Pointer statsInput = m_StatisticsEstimator;
+  if (statsInput.IsNull())
+  {
+    otbMsgDevMacro("Computing image stats");
+    statsInput = StreamingStatisticsVectorImageFilterType::New();
+    statsInput->SetInput(input);
+    statsInput->SetEnableMinMax(false);
+    statsInput->Update();
+  }
 
   double                    SNR, SNRth;
   vnl_matrix<PrecisionType> Ud;
@@ -91,31 +97,22 @@ void VCAImageFilter<TImage>::GenerateData()
   {
     vnl_matrix<PrecisionType> R = statsInput->GetCorrelation().GetVnlMatrix();
     vnl_svd<PrecisionType>    svd(R);
-    vnl_matrix<PrecisionType> U   = svd.U();
-    Ud                            = U.get_n_columns(0, m_NumberOfEndmembers);
-    vnl_matrix<PrecisionType> Udt = Ud.transpose();
-
-    // To remove the mean
-    typename NormalizeFilterType::Pointer normalize = NormalizeFilterType::New();
-    normalize->SetInput(input);
-    normalize->SetMean(statsInput->GetMean());
-    normalize->SetUseMean(true);
-    normalize->SetUseStdDev(false);
-
-    typename MatrixImageFilterType::Pointer mulUd = MatrixImageFilterType::New();
-    mulUd->MatrixByVectorOn();
-    mulUd->SetInput(normalize->GetOutput());
-    mulUd->SetMatrix(Udt);
-    mulUd->UpdateOutputInformation();
-
-    typename StreamingStatisticsVectorImageFilterType::Pointer transformedStats = StreamingStatisticsVectorImageFilterType::New();
-
-    transformedStats->SetInput(mulUd->GetOutput());
-    transformedStats->SetEnableMinMax(false);
-    transformedStats->Update();
+    vnl_matrix<PrecisionType> U = svd.U();
+    Ud                          = U.get_n_columns(0, m_NumberOfEndmembers);
+
+    // The power of the centered and reduced data Ud^T.(x - mean) follows
+    // from the statistics of the input: trace(Ud^T.(R - mean.mean^T).Ud)
+    const vnl_vector<PrecisionType> mean(statsInput->GetMean().GetDataPointer(), statsInput->GetMean().GetSize());
+    const vnl_matrix<PrecisionType> RUd          = R * Ud;
+    const vnl_vector<PrecisionType> meanUd       = Ud.transpose() * mean;
+    double                          reducedPower = 0.;
+    for (unsigned int j = 0; j < m_NumberOfEndmembers; ++j)
+    {
+      reducedPower += dot_product(Ud.get_column(j), RUd.get_column(j)) - meanUd[j] * meanUd[j];
+    }
 
     double P_R  = nbBands * statsInput->GetComponentCorrelation();
-    double P_Rp = m_NumberOfEndmembers * transformedStats->GetComponentCorrelation() + statsInput->GetMean().GetSquaredNorm();
+    double P_Rp = reducedPower + statsInput->GetMean().GetSquaredNorm();
     // const double qL = static_cast<double>(m_NumberOfEndmembers) / nbBands;
     SNR = std::abs(10 * std::log10((P_Rp - (m_NumberOfEndmembers / nbBands) * P_R) / (P_R - P_Rp)));
   }
@@ -155,13 +152,11 @@ void VCAImageFilter<TImage>::GenerateData()
 
     Xd = mulUd->GetOutput();
 
-    // Compute mean(Xd)
-    otbMsgDevMacro("Compute mean(Xd)") typename StreamingStatisticsVectorImageFilterType::Pointer statsXd = StreamingStatisticsVectorImageFilterType::New();
-    statsXd->SetEnableSecondOrderStats(false);
-    statsXd->SetInput(Xd);
-    // statsXd->GetStreamer()->SetNumberOfDivisionsStrippedStreaming(10);
-    statsXd->Update();
-    typename VectorImageType::PixelType Xdmean = statsXd->GetMean();
+    // mean(Xd) = Ud.' * mean(M)
+    otbMsgDevMacro("Compute mean(Xd)");
+    const vnl_vector<PrecisionType>     mean(statsInput->GetMean().GetDataPointer(), statsInput->GetMean().GetSize());
+    const vnl_vector<PrecisionType>     XdmeanV = UdT * mean;
+    typename VectorImageType::PixelType Xdmean(XdmeanV.data_block(), XdmeanV.size());
     otbMsgDevMacro("mean(Xd) = " << Xdmean)
 
         // Projective projection
@@ -201,22 +196,33 @@ void VCAImageFilter<TImage>::GenerateData()
 
     Xd = mulUd->GetOutput();
 
-    typename VectorImageToAmplitudeImageFilterType::Pointer normComputer = VectorImageToAmplitudeImageFilterType::New();
-    normComputer->SetInput(Xd);
-
-    typename StreamingMinMaxImageFilterType::Pointer maxNormComputer = StreamingMinMaxImageFilterType::New();
-    maxNormComputer->SetInput(normComputer->GetOutput());
-    maxNormComputer->Update();
-    typename ImageType::PixelType maxNorm = maxNormComputer->GetMaximum();
-    otbMsgDevMacro("maxNorm : " << maxNorm)
-
-        typename ConcatenateScalarValueImageFilterType::Pointer concat = ConcatenateScalarValueImageFilterType::New();
-    concat->SetInput(Xd);
-    concat->SetScalarValue(maxNorm);
-    refHolder.push_back(concat.GetPointer());
+    // With samples, the maximum norm is searched among the samples
+    if (m_NumberOfSamples == 0)
+    {
+      typename VectorImageToAmplitudeImageFilterType::Pointer normComputer = VectorImageToAmplitudeImageFilterType::New();
+      normComputer->SetInput(Xd);
+
+      typename StreamingMinMaxImageFilterType::Pointer maxNormComputer = StreamingMinMaxImageFilterType::New();
+      maxNormComputer->SetInput(normComputer->GetOutput());
+      maxNormComputer->Update();
+      typename ImageType::PixelType maxNorm = maxNormComputer->GetMaximum();
+      otbMsgDevMacro("maxNorm : " << maxNorm);
+
+      typename ConcatenateScalarValueImageFilterType::Pointer concat = ConcatenateScalarValueImageFilterType::New();
+      concat->SetInput(Xd);
+      concat->SetScalarValue(maxNorm);
+      refHolder.push_back(concat.GetPointer());
+
+      Y = concat->GetOutput();
+      Y->UpdateOutputInformation();
+    }
+  }
 
-    Y = concat->GetOutput();
-    Y->UpdateOutputInformation();
+  const vnl_vector<PrecisionType> inputMean(statsInput->GetMean().GetDataPointer(), statsInput->GetMean().GetSize());
+  if (m_NumberOfSamples > 0)
+  {
+    otbMsgDevMacro("Reduce the samples");
+    ReduceSamples(Ud, inputMean, SNR > SNRth);
   }
 
   // E : result, will contain the endmembers
@@ -250,77 +256,98 @@ void VCAImageFilter<TImage>::GenerateData()
     vnl_vector<PrecisionType> tmpNumerator = tmpMat * w;
     vnl_vector<PrecisionType> f            = tmpNumerator / tmpNumerator.two_norm();
 
-    // v = f.'*Y
-    otbMsgDevMacro("f = " << f);
-    otbMsgDevMacro("v = f.'*Y");
-    typename DotProductImageFilterType::Pointer dotfY = DotProductImageFilterType::New();
-    dotfY->SetInput(Y);
-
-    typename VectorImageType::PixelType fV(f.data_block(), f.size());
-    dotfY->GetModifiableFunctor().SetVector(typename VectorImageType::PixelType(fV));
-    typename ImageType::Pointer v = dotfY->GetOutput();
-
-    // abs(v)
-    otbMsgDevMacro("abs(v)");
-    typename AbsImageFilterType::Pointer absVFilter = AbsImageFilterType::New();
-    absVFilter->SetInput(v);
-
-    // max(abs(v))
-    otbMsgDevMacro("max(abs(v))");
-    typename StreamingMinMaxImageFilterType::Pointer maxAbs = StreamingMinMaxImageFilterType::New();
-    maxAbs->SetInput(absVFilter->GetOutput());
-    maxAbs->Update();
-
-    // k = arg_max( max(abs(v)) )
-    otbMsgDevMacro("k = arg_max( max(abs(v)) )") IndexType maxIdx = maxAbs->GetMaximumIndex();
-    otbMsgDevMacro("max : " << maxAbs->GetMaximum()) otbMsgDevMacro("maxIdx : " << maxIdx)
-
-        // extract Y(:, k)
-        otbMsgDevMacro("Y(:, k)") RegionType region;
-    region.SetIndex(maxIdx);
-    SizeType size;
-    size.Fill(1);
-    region.SetSize(size);
-    Y->SetRequestedRegion(region);
-    Y->Update();
+    vnl_vector<PrecisionType> e(m_NumberOfEndmembers);
+    vnl_vector<PrecisionType> xdV;
+    if (m_NumberOfSamples > 0)
+    {
+      // k = arg_max( abs(f.'*Y) ) among the samples
+      otbMsgDevMacro("k = arg_max( abs(f.'*Y) ) among the samples");
+      const unsigned long k       = ArgMaxSamples(f);
+      const double*       reduced = &m_ReducedSamples[k * m_NumberOfEndmembers];
+      for (unsigned int j = 0; j < m_NumberOfEndmembers; ++j)
+      {
+        e[j] = static_cast<PrecisionType>(reduced[j]);
+      }
+      xdV = e.extract(Ud.cols());
+    }
+    else
+    {
+      // v = f.'*Y
+      otbMsgDevMacro("f = " << f);
+      otbMsgDevMacro("v = f.'*Y");
+      typename DotProductImageFilterType::Pointer dotfY = DotProductImageFilterType::New();
+      dotfY->SetInput(Y);
+
+      typename VectorImageType::PixelType fV(f.data_block(), f.size());
+      dotfY->GetModifiableFunctor().SetVector(typename VectorImageType::PixelType(fV));
+      typename ImageType::Pointer v = dotfY->GetOutput();
+
+      // abs(v)
+      otbMsgDevMacro("abs(v)");
+      typename AbsImageFilterType::Pointer absVFilter = AbsImageFilterType::New();
+      absVFilter->SetInput(v);
+
+      // max(abs(v))
+      otbMsgDevMacro("max(abs(v))");
+      typename StreamingMinMaxImageFilterType::Pointer maxAbs = StreamingMinMaxImageFilterType::New();
+      maxAbs->SetInput(absVFilter->GetOutput());
+      maxAbs->Update();
+
+      // k = arg_max( max(abs(v)) )
+      otbMsgDevMacro("k = arg_max( max(abs(v)) )");
+      IndexType maxIdx = maxAbs->GetMaximumIndex();
+      otbMsgDevMacro("max : " << maxAbs->GetMaximum());
+      otbMsgDevMacro("maxIdx : " << maxIdx);
+
+      // extract Y(:, k)
+      otbMsgDevMacro("Y(:, k)");
+      RegionType region;
+      region.SetIndex(maxIdx);
+      SizeType size;
+      size.Fill(1);
+      region.SetSize(size);
+      Y->SetRequestedRegion(region);
+      Y->Update();
+      typename VectorImageType::PixelType yk = Y->GetPixel(maxIdx);
+      e.copy_in(yk.GetDataPointer());
+
+      // extract Xd(:, k)
+      Xd->SetRequestedRegion(region);
+      Xd->Update();
+      typename VectorImageType::PixelType xd = Xd->GetPixel(maxIdx);
+      xdV                                    = vnl_vector<PrecisionType>(xd.GetDataPointer(), xd.GetSize());
+    }
 
     // store new endmember in A
     // A(:, i) = Y(:, k)
-    otbMsgDevMacro("A(:, i) = Y(:, k)") typename VectorImageType::PixelType e = Y->GetPixel(maxIdx);
-    otbMsgDevMacro("e = " << e) A.set_column(i, e.GetDataPointer());
-
-    otbMsgDevMacro("A" << std::endl
-                       << A)
+    otbMsgDevMacro("A(:, i) = Y(:, k)");
+    otbMsgDevMacro("e = " << e);
+    A.set_column(i, e);
+    otbMsgDevMacro("A" << std::endl << A);
 
-        // reproject new endmember in original space
-        vnl_vector<PrecisionType>
-            u;
+    // reproject new endmember in original space
+    vnl_vector<PrecisionType> u;
     if (SNR > SNRth)
     {
       // u = Ud * Xd(:, k)
-      otbMsgDevMacro("u = Ud * Xd(:, k)") Xd->SetRequestedRegion(region);
-      Xd->Update();
-      typename VectorImageType::PixelType xd = Xd->GetPixel(maxIdx);
-      vnl_vector<PrecisionType>           xdV(xd.GetDataPointer(), xd.GetSize());
+      otbMsgDevMacro("u = Ud * Xd(:, k)");
       u = Ud * xdV;
     }
     else
     {
       // u = invPCA( Xd(:, k) )
-      otbMsgDevMacro("u = Ud * Xd(:, k)") Xd->SetRequestedRegion(region);
-      Xd->Update();
-      typename VectorImageType::PixelType xd = Xd->GetPixel(maxIdx);
-      vnl_vector<PrecisionType>           xdV(xd.GetDataPointer(), xd.GetSize());
-      // Ud = pca->GetTransformationMatrix().GetVnlMatrix().transpose();
-
-      vnl_vector<PrecisionType> mean(statsInput->GetMean().GetDataPointer(), statsInput->GetMean().GetSize());
-      u = Ud * xdV + mean;
+      otbMsgDevMacro("u = Ud * Xd(:, k) + mean");
+      u = Ud * xdV + inputMean;
     }
 
     // E(:, i) = u
     otbMsgDevMacro("E(:, i) = u") otbMsgDevMacro("u = " << u) E.set_column(i, u);
   }
 
+  // The reduced samples are not needed anymore
+  std::vector<double>().swap(m_ReducedSamples);
+  std::vector<double>().swap(m_ReductionMatrix);
+
   typename VectorImageType::Pointer output = this->GetOutput();
   output->SetRegions(output->GetLargestPossibleRegion());
   // output->SetNumberOfComponentsPerPixel(input->GetNumberOfComponentsPerPixel());
@@ -340,6 +367,209 @@ void VCAImageFilter<TImage>::GenerateData()
   }
 }
 
+template <class TImage>
+void VCAImageFilter<TImage>::ReduceSamples(const vnl_matrix<PrecisionType>& Ud, const vnl_vector<PrecisionType>& mean, bool projective)
+{
+  VectorImageType*   input   = const_cast<VectorImageType*>(this->GetInput());
+  const unsigned int nbBands = input->GetNumberOfComponentsPerPixel();
+
+  // Single streaming pass drawing the samples
+  m_Sampler->SetInput(input);
+  m_Sampler->GetFilter()->SetNumberOfSamples(m_NumberOfSamples);
+  m_Sampler->Update();
+
+  const unsigned long nbSamples = m_Sampler->GetNumberOfValidSamples();
+  if (nbSamples == 0)
+  {
+    itkExceptionMacro(<< "No valid pixel to search the endmembers");
+  }
+
+  m_Projective  = projective;
+  m_ReducedSize = Ud.cols();
+  m_ReductionMatrix.resize(m_ReducedSize * nbBands);
+  for (unsigned int j = 0; j < m_ReducedSize; ++j)
+  {
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      m_ReductionMatrix[j * nbBands + b] = Ud(b, j);
+    }
+  }
+  m_ReductionOffset.assign(nbBands, 0.);
+  if (!projective)
+  {
+    std::copy(mean.begin(), mean.end(), m_ReductionOffset.begin());
+  }
+  // The direction of the projective projection is mean(Xd) = Ud.' * mean(M)
+  const vnl_vector<PrecisionType> direction = Ud.transpose() * mean;
+  m_ProjectionDirection.assign(direction.begin(), direction.end());
+
+  m_ReducedSamples.resize(nbSamples * m_NumberOfEndmembers);
+
+  const itk::ThreadIdType numberOfThreads = GetParallelForRangeNumberOfThreads(this->GetNumberOfThreads(), nbSamples);
+  m_ThreadMaxima.assign(numberOfThreads, 0.);
+  m_ThreadArgMax.assign(numberOfThreads, 0);
+
+  ParallelForRange(this->GetMultiThreader(), numberOfThreads, nbSamples,
+                   [this](itk::ThreadIdType threadId, std::size_t begin, std::size_t end) { ThreadedReduceSamples(threadId, begin, end); });
+
+  // The raw samples are not needed anymore
+  m_Sampler->GetFilter()->ClearSamples();
+
+  if (!projective)
+  {
+    // Y = [Xd; max(norm(Xd))]
+    const double maxNorm = *std::max_element(m_ThreadMaxima.begin(), m_ThreadMaxima.end());
+    otbMsgDevMacro("maxNorm : " << maxNorm);
+    for (unsigned long s = 0; s < nbSamples; ++s)
+    {
+      m_ReducedSamples[s * m_NumberOfEndmembers + m_NumberOfEndmembers - 1] = maxNorm;
+    }
+  }
+}
+
+template <class TImage>
+void VCAImageFilter<TImage>::ThreadedReduceSamples(itk::ThreadIdType threadId, std::size_t begin, std::size_t end)
+{
+  const typename SamplerFilterType::SampleBufferType& samples = m_Sampler->GetSamples();
+  const unsigned int                                  nbBands = m_ReductionOffset.size();
+  const unsigned int                                  size    = m_ReducedSize;
+
+  std::vector<double> centered(4 * nbBands);
+  double              maxNorm = 0.;
+  for (std::size_t first = begin; first < end; first += 4)
+  {
+    const unsigned int blockSize = static_cast<unsigned int>(std::min<std::size_t>(4, end - first));
+    for (unsigned int s = 0; s < blockSize; ++s)
+    {
+      const double* sample = &samples[(first + s) * nbBands];
+      for (unsigned int b = 0; b < nbBands; ++b)
+      {
+        centered[s * nbBands + b] = sample[b] - m_ReductionOffset[b];
+      }
+    }
+
+    // Each row of the reduction matrix is applied to four samples at a time
+    double* reduced = &m_ReducedSamples[first * m_NumberOfEndmembers];
+    for (unsigned int j = 0; j < size; ++j)
+    {
+      const double* row = &m_ReductionMatrix[j * nbBands];
+      double        r0 = 0., r1 = 0., r2 = 0., r3 = 0.;
+      if (blockSize == 4)
+      {
+        const double* x0 = &centered[0];
+        const double* x1 = x0 + nbBands;
+        const double* x2 = x1 + nbBands;
+        const double* x3 = x2 + nbBands;
+        for (unsigned int b = 0; b < nbBands; ++b)
+        {
+          r0 += row[b] * x0[b];
+          r1 += row[b] * x1[b];
+          r2 += row[b] * x2[b];
+          r3 += row[b] * x3[b];
+        }
+        reduced[j]                            = r0;
+        reduced[m_NumberOfEndmembers + j]     = r1;
+        reduced[2 * m_NumberOfEndmembers + j] = r2;
+        reduced[3 * m_NumberOfEndmembers + j] = r3;
+      }
+      else
+      {
+        for (unsigned int s = 0; s < blockSize; ++s)
+        {
+          const double* x = &centered[s * nbBands];
+          r0              = 0.;
+          for (unsigned int b = 0; b < nbBands; ++b)
+          {
+            r0 += row[b] * x[b];
+          }
+          reduced[s * m_NumberOfEndmembers + j] = r0;
+        }
+      }
+    }
+
+    for (unsigned int s = 0; s < blockSize; ++s)
+    {
+      double* y = reduced + s * m_NumberOfEndmembers;
+      if (m_Projective)
+      {
+        // Xd ./ repmat( sum( Xd .* repmat(u, [1 N]) ) , [d 1])
+        double dotProduct = 0.;
+        for (unsigned int j = 0; j < size; ++j)
+        {
+          dotProduct += y[j] * m_ProjectionDirection[j];
+        }
+        for (unsigned int j = 0; j < size; ++j)
+        {
+          y[j] /= dotProduct;
+        }
+      }
+      else
+      {
+        double norm = 0.;
+        for (unsigned int j = 0; j < size; ++j)
+        {
+          norm += y[j] * y[j];
+        }
+        maxNorm = std::max(maxNorm, std::sqrt(norm));
+      }
+    }
+  }
+  m_ThreadMaxima[threadId] = maxNorm;
+}
+
+template <class TImage>
+unsigned long VCAImageFilter<TImage>::ArgMaxSamples(const vnl_vector<PrecisionType>& f)
+{
+  const std::vector<double> direction(f.begin(), f.end());
+  std::fill(m_ThreadMaxima.begin(), m_ThreadMaxima.end(), -1.);
+
+  ParallelForRange(this->GetMultiThreader(), static_cast<itk::ThreadIdType>(m_ThreadMaxima.size()), m_ReducedSamples.size() / m_NumberOfEndmembers,
+                   [this, &direction](itk::ThreadIdType threadId, std::size_t begin, std::size_t end) {
+                     ThreadedArgMaxSamples(direction.data(), threadId, begin, end);
+                   });
+
+  // The first sample wins in case of equality, whatever the number of threads
+  unsigned long argMax = m_ThreadArgMax[0];
+  double        maxAbs = m_ThreadMaxima[0];
+  for (std::size_t threadId = 1; threadId < m_ThreadMaxima.size(); ++threadId)
+  {
+    if (m_ThreadMaxima[threadId] > maxAbs)
+    {
+      maxAbs = m_ThreadMaxima[threadId];
+      argMax = m_ThreadArgMax[threadId];
+    }
+  }
+  otbMsgDevMacro("max : " << maxAbs);
+  otbMsgDevMacro("argmax : " << argMax);
+  return argMax;
+}
+
+template <class TImage>
+void VCAImageFilter<TImage>::ThreadedArgMaxSamples(const double* direction, itk::ThreadIdType threadId, std::size_t begin, std::size_t end)
+{
+  const unsigned int size = m_NumberOfEndmembers;
+
+  double        maxAbs = -1.;
+  unsigned long argMax = begin;
+  for (std::size_t s = begin; s < end; ++s)
+  {
+    const double* y     = &m_ReducedSamples[s * size];
+    double        value = 0.;
+    for (unsigned int j = 0; j < size; ++j)
+    {
+      value += direction[j] * y[j];
+    }
+    value = std::abs(value);
+    if (value > maxAbs)
+    {
+      maxAbs = value;
+      argMax = s;
+    }
+  }
+  m_ThreadMaxima[threadId] = maxAbs;
+  m_ThreadArgMax[threadId] = argMax;
+}
+
 /**
  * Standard "PrintSelf" method
  */
@@ -347,6 +577,8 @@ template <class TImage>
 void VCAImageFilter<TImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfEndmembers: " << m_NumberOfEndmembers << std::endl;
+  os << indent << "NumberOfSamples: " << m_NumberOfSamples << std::endl;
 }
 
 } // end namespace otb
@@ -25,4 +25,6 @@ void RegisterTests()
   REGISTER_TEST(otbEigenvalueLikelihoodMaximizationTest);
   REGISTER_TEST(otbVirtualDimensionalityTest);
   REGISTER_TEST(otbVCAImageFilterTestHighSNR);
+  REGISTER_TEST(otbVCAImageFilterTestSamples);
+  REGISTER_TEST(otbVCAImageFilterTestLowSNRSamples);
 }
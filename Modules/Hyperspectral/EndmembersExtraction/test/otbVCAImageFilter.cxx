@@ -24,6 +24,11 @@
 #include "otbImageFileReader.h"
 #include "otbImageFileWriter.h"
 
+#include "itkImageRegionIterator.h"
+
+#include <cmath>
+#include <vector>
+
 const unsigned int Dimension = 2;
 typedef double     PixelType;
 typedef double     PrecisionType;
@@ -35,6 +40,32 @@ typedef otb::VCAImageFilter<VectorImageType> VCAFilterType;
 typedef otb::ImageFileReader<VectorImageType> ReaderType;
 typedef otb::ImageFileWriter<VectorImageType> WriterType;
 
+namespace
+{
+/** Compares the endmembers found in memory with those of the streamed search */
+bool CompareEndmembers(const VectorImageType* actualEndmembers, const VectorImageType* refEndmembers, unsigned int nbEndmembers)
+{
+  bool                       ok = true;
+  VectorImageType::IndexType index;
+  index.Fill(0);
+  for (unsigned int i = 0; i < nbEndmembers; ++i)
+  {
+    index[0]                                 = i;
+    const VectorImageType::PixelType& ref    = refEndmembers->GetPixel(index);
+    const VectorImageType::PixelType& actual = actualEndmembers->GetPixel(index);
+    for (unsigned int b = 0; b < ref.GetSize(); ++b)
+    {
+      if (std::abs(actual[b] - ref[b]) > 1e-9 * (1. + std::abs(ref[b])))
+      {
+        std::cerr << "Endmember " << i << ", band " << b << ": " << actual[b] << " (streamed " << ref[b] << ")" << std::endl;
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+}
+
 
 int otbVCAImageFilterTestHighSNR(int itkNotUsed(argc), char* argv[])
 {
@@ -56,3 +87,141 @@ int otbVCAImageFilterTestHighSNR(int itkNotUsed(argc), char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbVCAImageFilterTestSamples(int itkNotUsed(argc), char* argv[])
+{
+  const char*        inputImage   = argv[1];
+  const unsigned int nbEndmembers = atoi(argv[2]);
+
+  typedef VCAFilterType::RandomVariateGeneratorType               RandomVariateGeneratorType;
+  typedef VCAFilterType::StreamingStatisticsVectorImageFilterType StatisticsFilterType;
+
+  ReaderType::Pointer readerImage = ReaderType::New();
+  readerImage->SetFileName(inputImage);
+  readerImage->UpdateOutputInformation();
+  const unsigned long nbPixels = readerImage->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+
+  // Reference: endmembers searched in the streamed image
+  RandomVariateGeneratorType::GetInstance()->Initialize(0);
+  VCAFilterType::Pointer streamedVCA = VCAFilterType::New();
+  streamedVCA->SetNumberOfEndmembers(nbEndmembers);
+  streamedVCA->SetInput(readerImage->GetOutput());
+  streamedVCA->Update();
+
+  // With a sample per pixel and shared statistics, the same endmembers are found
+  StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+  statistics->SetInput(readerImage->GetOutput());
+  statistics->Update();
+
+  RandomVariateGeneratorType::GetInstance()->Initialize(0);
+  VCAFilterType::Pointer sampledVCA = VCAFilterType::New();
+  sampledVCA->SetNumberOfEndmembers(nbEndmembers);
+  sampledVCA->SetNumberOfSamples(nbPixels);
+  sampledVCA->SetStatisticsEstimator(statistics);
+  sampledVCA->SetInput(readerImage->GetOutput());
+  sampledVCA->Update();
+
+  bool ok = CompareEndmembers(sampledVCA->GetOutput(), streamedVCA->GetOutput(), nbEndmembers);
+
+  // A genuine subset still gives finite endmembers
+  VCAFilterType::Pointer subsetVCA = VCAFilterType::New();
+  subsetVCA->SetNumberOfEndmembers(nbEndmembers);
+  subsetVCA->SetNumberOfSamples(nbPixels / 16);
+  subsetVCA->SetInput(readerImage->GetOutput());
+  subsetVCA->Update();
+  VectorImageType::IndexType index;
+  index.Fill(0);
+  std::cout << "Number of samples drawn: " << subsetVCA->GetSampler()->GetNumberOfValidSamples() << std::endl;
+  for (unsigned int i = 0; i < nbEndmembers; ++i)
+  {
+    index[0]                                = i;
+    const VectorImageType::PixelType& pixel = subsetVCA->GetOutput()->GetPixel(index);
+    for (unsigned int b = 0; b < pixel.GetSize(); ++b)
+    {
+      if (!std::isfinite(pixel[b]))
+      {
+        std::cerr << "Endmember " << i << " of the subset is not finite" << std::endl;
+        ok = false;
+        break;
+      }
+    }
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int otbVCAImageFilterTestLowSNRSamples(int itkNotUsed(argc), char* argv[])
+{
+  const unsigned int nbEndmembers = atoi(argv[1]);
+  const unsigned int nbBands      = 30;
+  const double       noiseStdDev  = 0.1;
+
+  typedef VCAFilterType::RandomVariateGeneratorType RandomVariateGeneratorType;
+
+  // Mixtures of random endmembers with a noise strong enough for the
+  // estimated SNR to stay well below the threshold of the projective
+  // projection: the data is reduced by a PCA, and the maximum norm is
+  // appended to the reduced samples
+  RandomVariateGeneratorType::Pointer generator = RandomVariateGeneratorType::New();
+  generator->Initialize(1);
+
+  std::vector<std::vector<double>> endmembers(nbEndmembers, std::vector<double>(nbBands));
+  for (unsigned int i = 0; i < nbEndmembers; ++i)
+  {
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      endmembers[i][b] = generator->GetVariateWithClosedRange();
+    }
+  }
+
+  VectorImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 64);
+  region.SetSize(1, 64);
+
+  VectorImageType::Pointer image = VectorImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  std::vector<double>                       abundances(nbEndmembers);
+  itk::ImageRegionIterator<VectorImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    double sum = 0.;
+    for (unsigned int i = 0; i < nbEndmembers; ++i)
+    {
+      abundances[i] = generator->GetVariateWithOpenRange();
+      sum += abundances[i];
+    }
+
+    VectorImageType::PixelType pixel(nbBands);
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      pixel[b] = noiseStdDev * generator->GetNormalVariate();
+      for (unsigned int i = 0; i < nbEndmembers; ++i)
+      {
+        pixel[b] += abundances[i] / sum * endmembers[i][b];
+      }
+    }
+    it.Set(pixel);
+  }
+
+  // Reference: endmembers searched in the streamed image
+  RandomVariateGeneratorType::GetInstance()->Initialize(0);
+  VCAFilterType::Pointer streamedVCA = VCAFilterType::New();
+  streamedVCA->SetNumberOfEndmembers(nbEndmembers);
+  streamedVCA->SetInput(image);
+  streamedVCA->Update();
+
+  // With a sample per pixel, the same endmembers are found in memory
+  RandomVariateGeneratorType::GetInstance()->Initialize(0);
+  VCAFilterType::Pointer sampledVCA = VCAFilterType::New();
+  sampledVCA->SetNumberOfEndmembers(nbEndmembers);
+  sampledVCA->SetNumberOfSamples(region.GetNumberOfPixels());
+  sampledVCA->SetInput(image);
+  sampledVCA->Update();
+
+  return CompareEndmembers(sampledVCA->GetOutput(), streamedVCA->GetOutput(), nbEndmembers) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
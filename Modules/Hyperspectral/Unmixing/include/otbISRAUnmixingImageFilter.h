@@ -83,7 +83,8 @@ private:
   typedef std::shared_ptr<SVDType> SVDPointerType;
 
   MatrixType     m_U;
-  SVDPointerType m_Svd; // SVD of U
+  MatrixType     m_Gram; // U^T U
+  SVDPointerType m_Svd;  // SVD of U
   unsigned int   m_OutputSize;
   unsigned int   m_MaxIteration;
 };
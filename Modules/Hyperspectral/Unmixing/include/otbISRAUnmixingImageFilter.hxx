@@ -46,6 +46,7 @@ void ISRAUnmixingFunctor<TInput, TOutput, TPrecision>::SetEndmembersMatrix(const
 {
   m_U          = U;
   m_OutputSize = m_U.cols();
+  m_Gram       = m_U.transpose() * m_U;
   m_Svd.reset(new SVDType(m_U));
 }
 
@@ -72,36 +73,34 @@ typename ISRAUnmixingFunctor<TInput, TOutput, TPrecision>::OutputType ISRAUnmixi
   unsigned int nbEndmembers = m_OutputSize;
   unsigned int nbBands      = in.Size();
 
-  // Apply ISRA iterations
-  for (unsigned int i = 0; i < m_MaxIteration; ++i)
+  // The numerators U^T in do not depend on the iteration
+  VectorType numerators(nbEndmembers, 0);
+  for (unsigned int e = 0; e < nbEndmembers; ++e)
   {
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      numerators[e] += in[b] * m_U(b, e);
+    }
+  }
 
-    // Use a temporary storage since it is used
-    // inside the iterations
-    VectorType outVectorNew = outVector;
+  // Apply ISRA iterations, the denominators U^T U out use the precomputed
+  // Gram matrix
+  VectorType outVectorNew(nbEndmembers);
+  for (unsigned int i = 0; i < m_MaxIteration; ++i)
+  {
     for (unsigned int e = 0; e < nbEndmembers; ++e)
     {
-      PrecisionType numerator   = 0;
       PrecisionType denominator = 0;
-
-      for (unsigned int b = 0; b < nbBands; ++b)
+      for (unsigned int s = 0; s < nbEndmembers; ++s)
       {
-        numerator += in[b] * m_U(b, e);
-
-        PrecisionType dot = 0;
-        for (unsigned int s = 0; s < nbEndmembers; ++s)
-        {
-          // Use outVector from previous iteration here
-          dot += m_U(b, s) * outVector[s];
-        }
-        denominator += dot * m_U(b, e);
+        // Use outVector from previous iteration here
+        denominator += m_Gram(e, s) * outVector[s];
       }
-
-      outVectorNew[e] *= (numerator / denominator);
+      outVectorNew[e] = outVector[e] * (numerators[e] / denominator);
     }
 
     // Prepare for next iteration
-    outVector = outVectorNew;
+    outVector.swap(outVectorNew);
   }
 
   OutputType out(outVector.size());
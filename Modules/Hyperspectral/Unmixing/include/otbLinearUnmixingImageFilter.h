@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLinearUnmixingImageFilter_h
+#define otbLinearUnmixingImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "vnl/vnl_matrix.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class LinearUnmixingImageFilter
+ *
+ * \brief Estimates the abundances of a set of endmembers in each pixel of a
+ * VectorImage, under the linear mixing model.
+ *
+ * If the endmembers matrix is called \f$A\f$ (one row per band, one column per
+ * endmember), the filter solves, for each pixel \f$p\f$, the system \f$A \cdot x
+ * = p\f$ in the least square sense with one of the following methods:
+ *
+ * - UCLS: unconstrained least square, \f$\hat{x} = A^+ p\f$,
+ * - ISRA: the Image Space Reconstruction Algorithm, MaxIteration
+ *   multiplicative updates \f$x \leftarrow x \cdot A^T p / A^T A x\f$ starting
+ *   from the UCLS solution, which keep the abundances positive,
+ * - FCLS: fully constrained least square (non-negative abundances summing to
+ *   one), solved exactly by an active set method. When some endmembers are
+ *   colinear, the abundances are one of the least square solutions. Pixels
+ *   for which the method does not reach the optimality conditions, because of
+ *   rounding errors, keep their last feasible abundances: they are counted by
+ *   GetNumberOfNonOptimalPixels() and reported by a warning.
+ *
+ * The pseudo-inverse and the Gram matrix \f$A^T A\f$ are computed once before
+ * the threads are started, and shared by all of them. Each scanline of the
+ * input is processed as a pixels x bands matrix, so that \f$A^+ p\f$ and \f$A^T
+ * p\f$ are computed by matrix products over the whole line (as well as \f$A^T A
+ * x\f$ for each ISRA iteration), instead of one pixel at a time.
+ *
+ * It gives the same abundances as UnConstrainedLeastSquareImageFilter and
+ * ISRAUnmixingImageFilter.
+ *
+ * References
+ *   "Fully Constrained Least-Squares Based Linear Unmixing." Daniel Heinz,
+ *   Chein-I Chang, and Mark L.G. Althouse. IEEE. 1999.
+ *
+ * \sa UnConstrainedLeastSquareImageFilter, ISRAUnmixingImageFilter
+ *
+ * \ingroup Streamed
+ * \ingroup Threaded
+ *
+ * \ingroup OTBUnmixing
+ */
+template <class TInputImage, class TOutputImage, class TPrecision = double>
+class ITK_EXPORT LinearUnmixingImageFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef LinearUnmixingImageFilter Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LinearUnmixingImageFilter, ImageToImageFilter);
+
+  /** Template parameters typedefs */
+  typedef TInputImage                                 InputImageType;
+  typedef typename InputImageType::InternalPixelType  InputInternalPixelType;
+  typedef TOutputImage                                OutputImageType;
+  typedef typename OutputImageType::InternalPixelType OutputInternalPixelType;
+  typedef typename OutputImageType::RegionType        OutputImageRegionType;
+  typedef TPrecision                                  PrecisionType;
+  typedef vnl_matrix<PrecisionType>                   MatrixType;
+
+  /** Unmixing methods */
+  enum MethodType
+  {
+    UCLS,
+    ISRA,
+    FCLS
+  };
+
+  /** Endmembers matrix: one row per band, one column per endmember */
+  void SetEndmembersMatrix(const MatrixType& endmembers);
+  itkGetConstReferenceMacro(EndmembersMatrix, MatrixType);
+
+  /** Unmixing method (default is UCLS) */
+  itkSetEnumMacro(Method, MethodType);
+  itkGetEnumMacro(Method, MethodType);
+
+  /** Number of ISRA iterations (default is 100) */
+  itkSetMacro(MaxIteration, unsigned int);
+  itkGetConstMacro(MaxIteration, unsigned int);
+
+  /** Number of pixels of the last update whose FCLS abundances do not reach
+   * the optimality conditions */
+  itkGetConstMacro(NumberOfNonOptimalPixels, unsigned long);
+
+protected:
+  LinearUnmixingImageFilter();
+  ~LinearUnmixingImageFilter() override
+  {
+  }
+
+  void GenerateOutputInformation() override;
+  void BeforeThreadedGenerateData() override;
+  void AfterThreadedGenerateData() override;
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  LinearUnmixingImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** c (m x n) = a (m x k) . b (k x n), all row major */
+  static void MultiplyMatrices(const PrecisionType* a, const PrecisionType* b, PrecisionType* c, unsigned int m, unsigned int k, unsigned int n);
+
+  /** In-place Cholesky factorization of the n x n symmetric matrix a (lower
+   * triangle). Returns false if a pivot is not above minimumPivot, i.e. if a
+   * is not positive definite or is nearly singular. */
+  static bool CholeskyDecompose(PrecisionType* a, unsigned int n, PrecisionType minimumPivot);
+
+  /** Solve (L L^T) x = x in place, for the factor L of CholeskyDecompose() */
+  static void CholeskySolve(const PrecisionType* l, unsigned int n, PrecisionType* x);
+
+  /** Fully constrained abundances of a pixel p, from its correlations A^T p
+   * with the endmembers. system holds endmembers^2 values, work 3 x
+   * endmembers and passive endmembers. Returns false if the optimality
+   * conditions are not reached. */
+  bool SolveFullyConstrained(const PrecisionType* correlations, PrecisionType* abundances, std::vector<PrecisionType>& system,
+                             std::vector<PrecisionType>& work, std::vector<unsigned char>& passive) const;
+
+  MatrixType   m_EndmembersMatrix;
+  MethodType   m_Method;
+  unsigned int m_MaxIteration;
+
+  /** Shared by the threads, computed before they start. Matrices are stored
+   * row major, transposed so that they multiply the pixels x bands lines on
+   * the right. */
+  std::vector<PrecisionType> m_PseudoInverseTransposed; // bands x endmembers
+  std::vector<PrecisionType> m_Endmembers;              // bands x endmembers
+  std::vector<PrecisionType> m_Gram;                    // endmembers x endmembers
+
+  /** Pixels whose FCLS abundances are not optimal, counted by each thread */
+  std::vector<unsigned long> m_NonOptimalPixelsPerThread;
+  unsigned long              m_NumberOfNonOptimalPixels;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbLinearUnmixingImageFilter.hxx"
+#endif
+
+#endif
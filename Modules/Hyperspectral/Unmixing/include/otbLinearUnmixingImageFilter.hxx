@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLinearUnmixingImageFilter_hxx
+#define otbLinearUnmixingImageFilter_hxx
+
+#include "otbLinearUnmixingImageFilter.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkProgressReporter.h"
+#include "vnl/algo/vnl_svd.h"
+#include "otbMacro.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace otb
+{
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::LinearUnmixingImageFilter() : m_Method(UCLS), m_MaxIteration(100), m_NumberOfNonOptimalPixels(0)
+{
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::SetEndmembersMatrix(const MatrixType& endmembers)
+{
+  m_EndmembersMatrix = endmembers;
+  this->Modified();
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  this->GetOutput()->SetNumberOfComponentsPerPixel(m_EndmembersMatrix.cols());
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::BeforeThreadedGenerateData()
+{
+  const unsigned int nbBands      = m_EndmembersMatrix.rows();
+  const unsigned int nbEndmembers = m_EndmembersMatrix.cols();
+  if (nbEndmembers == 0 || nbBands != this->GetInput()->GetNumberOfComponentsPerPixel())
+  {
+    itkExceptionMacro(<< "The endmembers matrix (" << nbBands << " x " << nbEndmembers << ") does not match the number of bands of the input image ("
+                      << this->GetInput()->GetNumberOfComponentsPerPixel() << ")");
+  }
+
+  vnl_svd<PrecisionType> svd(m_EndmembersMatrix);
+  const MatrixType       pseudoInverse = svd.pinverse();
+
+  m_PseudoInverseTransposed.resize(nbBands * nbEndmembers);
+  m_Endmembers.resize(nbBands * nbEndmembers);
+  for (unsigned int b = 0; b < nbBands; ++b)
+  {
+    for (unsigned int e = 0; e < nbEndmembers; ++e)
+    {
+      m_PseudoInverseTransposed[b * nbEndmembers + e] = pseudoInverse(e, b);
+      m_Endmembers[b * nbEndmembers + e]              = m_EndmembersMatrix(b, e);
+    }
+  }
+
+  m_Gram.assign(nbEndmembers * nbEndmembers, 0);
+  for (unsigned int b = 0; b < nbBands; ++b)
+  {
+    const PrecisionType* row = &m_Endmembers[b * nbEndmembers];
+    for (unsigned int i = 0; i < nbEndmembers; ++i)
+    {
+      for (unsigned int j = 0; j < nbEndmembers; ++j)
+      {
+        m_Gram[i * nbEndmembers + j] += row[i] * row[j];
+      }
+    }
+  }
+
+  m_NumberOfNonOptimalPixels = 0;
+  m_NonOptimalPixelsPerThread.assign(this->GetNumberOfThreads(), 0);
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::AfterThreadedGenerateData()
+{
+  for (auto count : m_NonOptimalPixelsPerThread)
+  {
+    m_NumberOfNonOptimalPixels += count;
+  }
+  if (m_NumberOfNonOptimalPixels > 0)
+  {
+    otbWarningMacro(<< "The fully constrained abundances of " << m_NumberOfNonOptimalPixels
+                    << " pixels did not reach the optimality conditions, the last feasible abundances were kept");
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                            itk::ThreadIdType threadId)
+{
+  const InputImageType* input  = this->GetInput();
+  OutputImageType*      output = this->GetOutput();
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const unsigned int nbBands      = m_EndmembersMatrix.rows();
+  const unsigned int nbEndmembers = m_EndmembersMatrix.cols();
+  const unsigned int width        = outputRegionForThread.GetSize(0);
+
+  // Line buffers: pixels x bands input, pixels x endmembers outputs
+  std::vector<PrecisionType> line(width * nbBands);
+  std::vector<PrecisionType> abundances(width * nbEndmembers);
+  std::vector<PrecisionType> correlations(m_Method == UCLS ? 0 : width * nbEndmembers);
+  std::vector<PrecisionType> products(m_Method == ISRA ? width * nbEndmembers : 0);
+
+  // Working memory of the fully constrained solver
+  std::vector<PrecisionType> system(nbEndmembers * nbEndmembers);
+  std::vector<PrecisionType> work(3 * nbEndmembers);
+  std::vector<unsigned char> passive(nbEndmembers);
+
+  itk::ImageScanlineConstIterator<OutputImageType> lineIt(output, outputRegionForThread);
+  for (lineIt.GoToBegin(); !lineIt.IsAtEnd(); lineIt.NextLine())
+  {
+    const InputInternalPixelType* inputLine  = input->GetBufferPointer() + input->ComputeOffset(lineIt.GetIndex()) * nbBands;
+    OutputInternalPixelType*      outputLine = output->GetBufferPointer() + output->ComputeOffset(lineIt.GetIndex()) * nbEndmembers;
+    for (unsigned int i = 0; i < width * nbBands; ++i)
+    {
+      line[i] = static_cast<PrecisionType>(inputLine[i]);
+    }
+
+    switch (m_Method)
+    {
+    case UCLS:
+      MultiplyMatrices(line.data(), m_PseudoInverseTransposed.data(), abundances.data(), width, nbBands, nbEndmembers);
+      break;
+    case ISRA:
+      // Start from the unconstrained solution, A^T p is the constant numerator
+      MultiplyMatrices(line.data(), m_PseudoInverseTransposed.data(), abundances.data(), width, nbBands, nbEndmembers);
+      MultiplyMatrices(line.data(), m_Endmembers.data(), correlations.data(), width, nbBands, nbEndmembers);
+      for (unsigned int it = 0; it < m_MaxIteration; ++it)
+      {
+        // The Gram matrix is symmetric: x^T A^T A is (A^T A x)^T
+        MultiplyMatrices(abundances.data(), m_Gram.data(), products.data(), width, nbEndmembers, nbEndmembers);
+        for (unsigned int i = 0; i < width * nbEndmembers; ++i)
+        {
+          abundances[i] *= correlations[i] / products[i];
+        }
+      }
+      break;
+    case FCLS:
+      MultiplyMatrices(line.data(), m_Endmembers.data(), correlations.data(), width, nbBands, nbEndmembers);
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        if (!SolveFullyConstrained(&correlations[x * nbEndmembers], &abundances[x * nbEndmembers], system, work, passive))
+        {
+          ++m_NonOptimalPixelsPerThread[threadId];
+        }
+      }
+      break;
+    }
+
+    for (unsigned int i = 0; i < width * nbEndmembers; ++i)
+    {
+      outputLine[i] = static_cast<OutputInternalPixelType>(abundances[i]);
+    }
+    for (unsigned int x = 0; x < width; ++x)
+    {
+      progress.CompletedPixel();
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+bool LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::SolveFullyConstrained(const PrecisionType* correlations, PrecisionType* abundances,
+                                                                                             std::vector<PrecisionType>& system,
+                                                                                             std::vector<PrecisionType>& work,
+                                                                                             std::vector<unsigned char>& passive) const
+{
+  // Active set method (Lawson-Hanson, with the sum-to-one equality) on
+  // f(a) = 1/2 a^T G a - c^T a. Abundances of the active set are null, the
+  // ones of the passive set are the equality constrained minimum of f.
+  const unsigned int n        = static_cast<unsigned int>(passive.size());
+  PrecisionType*     solution = &work[0];
+  PrecisionType*     ones     = &work[n];
+  PrecisionType*     gradient = &work[2 * n];
+
+  PrecisionType maxDiagonal = 0;
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    maxDiagonal = std::max(maxDiagonal, m_Gram[i * n + i]);
+  }
+  const PrecisionType scale     = std::max(maxDiagonal, PrecisionType(1));
+  const PrecisionType tolerance = 1e-12 * scale;
+
+  // Colinear passive endmembers make G_P singular: f then has several
+  // minima on the passive set, a small ridge on G_P selects the one of
+  // smallest norm
+  const PrecisionType ridge = 1e-10 * scale;
+
+  // Start from the feasible barycenter, all endmembers passive
+  std::fill(abundances, abundances + n, PrecisionType(1) / n);
+  std::fill(passive.begin(), passive.end(), 1);
+
+  // The active set method terminates after a finite number of iterations,
+  // this bound only guards against cycling caused by rounding errors
+  const unsigned int maxIterations = 10 * n + 10;
+  for (unsigned int iteration = 0; iteration < maxIterations; ++iteration)
+  {
+    // Equality constrained minimum on the passive set:
+    // z = G_P^-1 (c_P - mu 1), with mu such that sum(z) = 1
+    const unsigned int k          = static_cast<unsigned int>(std::count(passive.begin(), passive.end(), 1));
+    bool               decomposed = false;
+    for (unsigned int attempt = 0; attempt < 2 && !decomposed; ++attempt)
+    {
+      for (unsigned int i = 0, r = 0; i < n; ++i)
+      {
+        if (passive[i])
+        {
+          for (unsigned int j = 0, c = 0; j < n; ++j)
+          {
+            if (passive[j])
+            {
+              system[r * k + c++] = m_Gram[i * n + j];
+            }
+          }
+          system[r * k + r] += attempt * ridge;
+
+          solution[r] = correlations[i];
+          ones[r]     = 1;
+          ++r;
+        }
+      }
+      decomposed = CholeskyDecompose(system.data(), k, tolerance);
+    }
+    if (!decomposed)
+    {
+      // Keep the current feasible abundances
+      return false;
+    }
+    CholeskySolve(system.data(), k, solution);
+    CholeskySolve(system.data(), k, ones);
+    PrecisionType sumSolution = 0;
+    PrecisionType sumOnes     = 0;
+    for (unsigned int r = 0; r < k; ++r)
+    {
+      sumSolution += solution[r];
+      sumOnes += ones[r];
+    }
+    const PrecisionType mu = (sumSolution - 1) / sumOnes;
+    for (unsigned int r = 0; r < k; ++r)
+    {
+      solution[r] -= mu * ones[r];
+    }
+
+    // If z is not feasible, move towards it until the first abundance
+    // vanishes, and make it active
+    PrecisionType step    = 1;
+    unsigned int  blocked = n;
+    for (unsigned int i = 0, r = 0; i < n; ++i)
+    {
+      if (passive[i])
+      {
+        if (solution[r] < 0)
+        {
+          const PrecisionType ratio = abundances[i] / (abundances[i] - solution[r]);
+          if (ratio < step)
+          {
+            step    = ratio;
+            blocked = i;
+          }
+        }
+        ++r;
+      }
+    }
+    for (unsigned int i = 0, r = 0; i < n; ++i)
+    {
+      if (passive[i])
+      {
+        abundances[i] += step * (solution[r] - abundances[i]);
+        if (i == blocked || abundances[i] <= 0)
+        {
+          abundances[i] = 0;
+          passive[i]    = 0;
+        }
+        ++r;
+      }
+    }
+    if (blocked != n)
+    {
+      continue;
+    }
+
+    // Optimality: the Lagrange multipliers G a - c + mu of the active
+    // constraints shall be non-negative
+    unsigned int  entering = n;
+    PrecisionType lowest   = -tolerance;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      gradient[i] = -correlations[i];
+      for (unsigned int j = 0; j < n; ++j)
+      {
+        gradient[i] += m_Gram[i * n + j] * abundances[j];
+      }
+      if (!passive[i] && gradient[i] + mu < lowest)
+      {
+        lowest   = gradient[i] + mu;
+        entering = i;
+      }
+    }
+    if (entering == n)
+    {
+      return true;
+    }
+    passive[entering] = 1;
+  }
+  return false;
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::MultiplyMatrices(const PrecisionType* a, const PrecisionType* b, PrecisionType* c,
+                                                                                        unsigned int m, unsigned int k, unsigned int n)
+{
+  // Rows of a are processed by blocks, so that the block of rows of b they
+  // use stays in cache. The inner loop runs along the rows of b and c, and
+  // can be vectorized.
+  const unsigned int blockSize = 64;
+  std::fill(c, c + m * n, PrecisionType(0));
+  for (unsigned int i0 = 0; i0 < m; i0 += blockSize)
+  {
+    const unsigned int iEnd = std::min(m, i0 + blockSize);
+    for (unsigned int k0 = 0; k0 < k; k0 += blockSize)
+    {
+      const unsigned int kEnd = std::min(k, k0 + blockSize);
+      for (unsigned int i = i0; i < iEnd; ++i)
+      {
+        const PrecisionType* rowA = a + i * k;
+        PrecisionType*       rowC = c + i * n;
+        for (unsigned int l = k0; l < kEnd; ++l)
+        {
+          const PrecisionType  value = rowA[l];
+          const PrecisionType* rowB  = b + l * n;
+          for (unsigned int j = 0; j < n; ++j)
+          {
+            rowC[j] += value * rowB[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+bool LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::CholeskyDecompose(PrecisionType* a, unsigned int n, PrecisionType minimumPivot)
+{
+  for (unsigned int j = 0; j < n; ++j)
+  {
+    const PrecisionType* rowJ     = a + j * n;
+    PrecisionType        diagonal = rowJ[j];
+    for (unsigned int k = 0; k < j; ++k)
+    {
+      diagonal -= rowJ[k] * rowJ[k];
+    }
+    if (!(diagonal > minimumPivot))
+    {
+      return false;
+    }
+    diagonal     = std::sqrt(diagonal);
+    a[j * n + j] = diagonal;
+    for (unsigned int i = j + 1; i < n; ++i)
+    {
+      PrecisionType* rowI = a + i * n;
+      PrecisionType  sum  = rowI[j];
+      for (unsigned int k = 0; k < j; ++k)
+      {
+        sum -= rowI[k] * rowJ[k];
+      }
+      rowI[j] = sum / diagonal;
+    }
+  }
+  return true;
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::CholeskySolve(const PrecisionType* l, unsigned int n, PrecisionType* x)
+{
+  // L y = x, then L^T x = y
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    PrecisionType sum = x[i];
+    for (unsigned int k = 0; k < i; ++k)
+    {
+      sum -= l[i * n + k] * x[k];
+    }
+    x[i] = sum / l[i * n + i];
+  }
+  for (unsigned int i = n; i-- > 0;)
+  {
+    PrecisionType sum = x[i];
+    for (unsigned int k = i + 1; k < n; ++k)
+    {
+      sum -= l[k * n + i] * x[k];
+    }
+    x[i] = sum / l[i * n + i];
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TPrecision>
+void LinearUnmixingImageFilter<TInputImage, TOutputImage, TPrecision>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Method: " << m_Method << std::endl;
+  os << indent << "MaxIteration: " << m_MaxIteration << std::endl;
+  os << indent << "NumberOfNonOptimalPixels: " << m_NumberOfNonOptimalPixels << std::endl;
+  os << indent << "EndmembersMatrix: " << m_EndmembersMatrix.rows() << " x " << m_EndmembersMatrix.cols() << std::endl;
+}
+
+} // end namespace otb
+
+#endif
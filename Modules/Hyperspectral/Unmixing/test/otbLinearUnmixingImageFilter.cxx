@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbLinearUnmixingImageFilter.h"
+#include "otbISRAUnmixingImageFilter.h"
+#include "otbUnConstrainedLeastSquareImageFilter.h"
+
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "otbVectorImageToMatrixImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+typedef otb::VectorImage<double, 2> ImageType;
+
+/** Largest difference between the components of two images */
+double MaximumDifference(const ImageType* image1, const ImageType* image2)
+{
+  itk::ImageRegionConstIterator<ImageType> it1(image1, image1->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> it2(image2, image2->GetLargestPossibleRegion());
+  double                                   difference = 0.;
+  for (it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    for (unsigned int i = 0; i < it1.Get().Size(); ++i)
+    {
+      difference = std::max(difference, std::abs(it1.Get()[i] - it2.Get()[i]));
+    }
+  }
+  return difference;
+}
+
+/** Check the Karush-Kuhn-Tucker conditions of the fully constrained least
+ * square problem min 1/2 |A a - p|^2, a >= 0, sum(a) = 1, which are
+ * sufficient for its convex objective: with g = A^T (A a - p), there is a
+ * multiplier mu such that g_i + mu = 0 where a_i > 0 and g_i + mu >= 0 where
+ * a_i = 0. */
+bool CheckFullyConstrainedOptimality(const ImageType* image, const ImageType* abundances, const vnl_matrix<double>& endmembers)
+{
+  const vnl_matrix<double> gram = endmembers.transpose() * endmembers;
+  const unsigned int       n    = endmembers.cols();
+
+  itk::ImageRegionConstIterator<ImageType> pixelIt(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> abundanceIt(abundances, abundances->GetLargestPossibleRegion());
+  for (pixelIt.GoToBegin(), abundanceIt.GoToBegin(); !pixelIt.IsAtEnd(); ++pixelIt, ++abundanceIt)
+  {
+    const vnl_vector<double> p(pixelIt.Get().GetDataPointer(), pixelIt.Get().Size());
+    const vnl_vector<double> a(abundanceIt.Get().GetDataPointer(), n);
+    const vnl_vector<double> correlations = endmembers.transpose() * p;
+    const vnl_vector<double> gradient     = gram * a - correlations;
+    const double             tolerance    = 1e-7 * (gram.absolute_value_max() + correlations.inf_norm() + 1.);
+
+    double       mu      = 0.;
+    unsigned int passive = 0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      if (a[i] > 1e-10)
+      {
+        mu -= gradient[i];
+        ++passive;
+      }
+    }
+    mu /= passive;
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      const double multiplier = gradient[i] + mu;
+      if ((a[i] > 1e-10 && std::abs(multiplier) > tolerance) || multiplier < -tolerance)
+      {
+        std::cerr << "FCLS abundances " << abundanceIt.Get() << " at " << abundanceIt.GetIndex() << " are not optimal: multiplier " << multiplier
+                  << " of endmember " << i << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int otbLinearUnmixingImageFilterTest(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+  typedef otb::VectorImageToMatrixImageFilter<ImageType> VectorImageToMatrixImageFilterType;
+  typedef otb::LinearUnmixingImageFilter<ImageType, ImageType, double> LinearUnmixingFilterType;
+  typedef otb::UnConstrainedLeastSquareImageFilter<ImageType, ImageType, double> UCLSFilterType;
+  typedef otb::ISRAUnmixingImageFilter<ImageType, ImageType, double>             ISRAFilterType;
+  typedef otb::ImageFileWriter<ImageType> WriterType;
+
+  const char* inputImage      = argv[1];
+  const char* inputEndmembers = argv[2];
+  const char* outputImage     = argv[3];
+  const int   maxIter         = atoi(argv[4]);
+
+  ReaderType::Pointer readerImage = ReaderType::New();
+  readerImage->SetFileName(inputImage);
+
+  ReaderType::Pointer readerEndMembers = ReaderType::New();
+  readerEndMembers->SetFileName(inputEndmembers);
+  VectorImageToMatrixImageFilterType::Pointer endMember2Matrix = VectorImageToMatrixImageFilterType::New();
+  endMember2Matrix->SetInput(readerEndMembers->GetOutput());
+  endMember2Matrix->Update();
+  const LinearUnmixingFilterType::MatrixType endMembers = endMember2Matrix->GetMatrix();
+
+  // UCLS and ISRA give the abundances of the per-pixel functors
+  UCLSFilterType::Pointer ucls = UCLSFilterType::New();
+  ucls->SetInput(readerImage->GetOutput());
+  ucls->GetModifiableFunctor().SetMatrix(endMembers);
+  ucls->Update();
+
+  LinearUnmixingFilterType::Pointer unmixer = LinearUnmixingFilterType::New();
+  unmixer->SetInput(readerImage->GetOutput());
+  unmixer->SetEndmembersMatrix(endMembers);
+  unmixer->SetMethod(LinearUnmixingFilterType::UCLS);
+  unmixer->Update();
+  const double uclsDifference = MaximumDifference(unmixer->GetOutput(), ucls->GetOutput());
+  if (uclsDifference > 1e-9)
+  {
+    std::cerr << "UCLS abundances differ from UnConstrainedLeastSquareImageFilter by " << uclsDifference << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ISRAFilterType::Pointer isra = ISRAFilterType::New();
+  isra->SetInput(readerImage->GetOutput());
+  isra->GetModifiableFunctor().SetMaxIteration(maxIter);
+  isra->GetModifiableFunctor().SetEndmembersMatrix(endMembers);
+  isra->Update();
+
+  unmixer->SetMethod(LinearUnmixingFilterType::ISRA);
+  unmixer->SetMaxIteration(maxIter);
+  unmixer->Update();
+  const double israDifference = MaximumDifference(unmixer->GetOutput(), isra->GetOutput());
+  if (israDifference > 1e-9)
+  {
+    std::cerr << "ISRA abundances differ from ISRAUnmixingImageFilter by " << israDifference << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // FCLS abundances are non-negative and sum to one
+  unmixer->SetMethod(LinearUnmixingFilterType::FCLS);
+  unmixer->Update();
+  itk::ImageRegionConstIterator<ImageType> it(unmixer->GetOutput(), unmixer->GetOutput()->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    double sum = 0.;
+    for (unsigned int i = 0; i < it.Get().Size(); ++i)
+    {
+      if (it.Get()[i] < 0.)
+      {
+        std::cerr << "Negative FCLS abundance " << it.Get() << " at " << it.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+      }
+      sum += it.Get()[i];
+    }
+    if (std::abs(sum - 1.) > 1e-9)
+    {
+      std::cerr << "FCLS abundances " << it.Get() << " at " << it.GetIndex() << " do not sum to one" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!CheckFullyConstrainedOptimality(readerImage->GetOutput(), unmixer->GetOutput(), endMembers) || unmixer->GetNumberOfNonOptimalPixels() != 0)
+  {
+    return EXIT_FAILURE;
+  }
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(outputImage);
+  writer->SetInput(unmixer->GetOutput());
+  writer->Update();
+
+  return EXIT_SUCCESS;
+}
+
+int otbLinearUnmixingImageFilterFCLSOptimality(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::LinearUnmixingImageFilter<ImageType, ImageType, double> LinearUnmixingFilterType;
+  typedef LinearUnmixingFilterType::MatrixType                         MatrixType;
+
+  const unsigned int nbBands  = 4;
+  const unsigned int nbPixels = 20;
+
+  // Pixels inside and outside of the cone of the endmembers
+  ImageType::RegionType region;
+  region.SetSize(0, nbPixels);
+  region.SetSize(1, 1);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+  for (unsigned int k = 0; k < nbPixels; ++k)
+  {
+    ImageType::PixelType pixel(nbBands);
+    pixel[0] = std::sin(static_cast<double>(k));
+    pixel[1] = std::cos(2. * k) + 0.5;
+    pixel[2] = std::fmod(0.3 * k, 1.7) - 0.2;
+    pixel[3] = 1.;
+    ImageType::IndexType index;
+    index[0] = k;
+    index[1] = 0;
+    image->SetPixel(index, pixel);
+  }
+
+  // Independent endmembers, then colinear ones (the third is twice the
+  // first), for which the Gram matrix is singular
+  for (unsigned int colinear = 0; colinear < 2; ++colinear)
+  {
+    MatrixType endmembers(nbBands, 3, 0.);
+    endmembers(0, 0) = 1.;
+    endmembers(1, 1) = 1.;
+    endmembers(2, 2) = 1.;
+    for (unsigned int e = 0; e < 3; ++e)
+    {
+      endmembers(nbBands - 1, e) = 0.5;
+    }
+    if (colinear)
+    {
+      endmembers.set_column(2, 2. * endmembers.get_column(0));
+    }
+
+    LinearUnmixingFilterType::Pointer unmixer = LinearUnmixingFilterType::New();
+    unmixer->SetInput(image);
+    unmixer->SetEndmembersMatrix(endmembers);
+    unmixer->SetMethod(LinearUnmixingFilterType::FCLS);
+    unmixer->Update();
+
+    if (unmixer->GetNumberOfNonOptimalPixels() != 0)
+    {
+      std::cerr << unmixer->GetNumberOfNonOptimalPixels() << " pixels are not optimal" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!CheckFullyConstrainedOptimality(image, unmixer->GetOutput(), endmembers))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // No point of a fine grid of the simplex shall fit a pixel better
+    const unsigned int steps = 300;
+    itk::ImageRegionConstIterator<ImageType> pixelIt(image, region);
+    itk::ImageRegionConstIterator<ImageType> abundanceIt(unmixer->GetOutput(), region);
+    for (pixelIt.GoToBegin(), abundanceIt.GoToBegin(); !pixelIt.IsAtEnd(); ++pixelIt, ++abundanceIt)
+    {
+      const vnl_vector<double> p(pixelIt.Get().GetDataPointer(), nbBands);
+      const vnl_vector<double> a(abundanceIt.Get().GetDataPointer(), 3);
+      const double             error = (endmembers * a - p).squared_magnitude();
+
+      double gridError = std::numeric_limits<double>::max();
+      for (unsigned int i = 0; i <= steps; ++i)
+      {
+        for (unsigned int j = 0; i + j <= steps; ++j)
+        {
+          vnl_vector<double> candidate(3);
+          candidate[0] = static_cast<double>(i) / steps;
+          candidate[1] = static_cast<double>(j) / steps;
+          candidate[2] = static_cast<double>(steps - i - j) / steps;
+          gridError    = std::min(gridError, (endmembers * candidate - p).squared_magnitude());
+        }
+      }
+      if (error > gridError + 1e-12 * (1. + gridError))
+      {
+        std::cerr << "FCLS abundances " << abundanceIt.Get() << " at " << abundanceIt.GetIndex() << " fit worse (" << error
+                  << ") than a point of the simplex (" << gridError << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
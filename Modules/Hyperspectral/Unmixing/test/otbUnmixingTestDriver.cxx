@@ -26,5 +26,7 @@ void RegisterTests()
   REGISTER_TEST(otbMDMDNMFImageFilterTest2);
   REGISTER_TEST(otbISRAUnmixingImageFilterTest);
   REGISTER_TEST(otbUnConstrainedLeastSquareImageFilterTest);
+  REGISTER_TEST(otbLinearUnmixingImageFilterTest);
+  REGISTER_TEST(otbLinearUnmixingImageFilterFCLSOptimality);
   REGISTER_TEST(otbSparseUnmixingImageFilterTest);
 }
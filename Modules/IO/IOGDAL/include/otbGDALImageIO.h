@@ -174,6 +174,10 @@ public:
   /** Determine the file type. Returns true if the ImageIO can stream write the specified file */
   bool CanStreamWrite() override;
 
+  /** Block size deduced from the driver and the creation options: tiles of
+   * tiled GeoTIFF and COG files, strips of GeoTIFF files with a BLOCKYSIZE. */
+  void GetWriteBlockSize(unsigned int& blockSizeX, unsigned int& blockSizeY) const override;
+
   /** Writes the spacing and dimensions of the image.
    * Assumes SetFileName has been called with a valid file name. */
   void WriteImageInformation() override;
@@ -19,8 +19,12 @@
  * limitations under the License.
  */
 
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <limits>
 #include <vector>
 
 #include "otbGDALImageIO.h"
@@ -1171,6 +1175,62 @@ bool GDALImageIO::CanStreamWrite()
   return m_CanStreamWrite;
 }
 
+void GDALImageIO::GetWriteBlockSize(unsigned int& blockSizeX, unsigned int& blockSizeY) const
+{
+  blockSizeX = 0;
+  blockSizeY = 0;
+
+  // Value of a creation option, or defaultValue when it is not set
+  auto getOption = [this](std::string const& key, std::string const& defaultValue) {
+    for (auto const& option : m_CreationOptions)
+    {
+      if (boost::algorithm::istarts_with(option, key + "="))
+      {
+        return option.substr(key.size() + 1);
+      }
+    }
+    return defaultValue;
+  };
+
+  // Block size given by a creation option. An invalid value gives no
+  // constraint: GDAL reports it when the file is created.
+  auto getBlockSize = [this, &getOption](std::string const& key, std::string const& defaultValue) -> unsigned int {
+    errno                     = 0;
+    const std::string   value = getOption(key, defaultValue);
+    char*               end   = nullptr;
+    const unsigned long size  = std::strtoul(value.c_str(), &end, 10);
+    if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' || errno == ERANGE ||
+        size > std::numeric_limits<unsigned int>::max())
+    {
+      otbLogMacro(Warning, << "Invalid creation option " << key << "=" << value << " for file " << m_FileName << ", its block size is ignored");
+      return 0;
+    }
+    return static_cast<unsigned int>(size);
+  };
+
+  const std::string gdalDriverShortName = FilenameToGdalDriverShortName(m_FileName);
+  if (gdalDriverShortName == "GTiff")
+  {
+    const std::string tiled = getOption("TILED", "NO");
+    if (boost::algorithm::iequals(tiled, "YES") || boost::algorithm::iequals(tiled, "TRUE") || boost::algorithm::iequals(tiled, "ON") || tiled == "1")
+    {
+      blockSizeX = getBlockSize("BLOCKXSIZE", "256");
+      blockSizeY = getBlockSize("BLOCKYSIZE", "256");
+    }
+    else
+    {
+      // Strips span the whole width, their height is chosen by GDAL unless
+      // it is given
+      blockSizeY = getBlockSize("BLOCKYSIZE", "0");
+    }
+  }
+  else if (gdalDriverShortName == "COG")
+  {
+    blockSizeX = getBlockSize("BLOCKSIZE", "512");
+    blockSizeY = blockSizeX;
+  }
+}
+
 void GDALImageIO::Write(const void* buffer)
 {
   // Check if we have to write the image information
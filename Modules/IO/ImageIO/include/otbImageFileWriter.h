@@ -203,6 +203,13 @@ public:
 
   itkGetConstObjectMacro(FilenameHelper, FNameHelperType);
 
+  /** Writes the buffer of an image into the current IO region of the ImageIO,
+   *  without updating the pipeline. The information shall have been written
+   *  beforehand with UpdateOutputInformation(). This is what GenerateData()
+   *  does with the input; MultiImageFileWriter uses it to write copies of the
+   *  divisions from I/O threads while the pipeline computes the next ones. */
+  void WriteImageBuffer(const InputImageType* input);
+
   /** This override doesn't return a const ref on the actual boolean */
   const bool& GetAbortGenerateData() const override;
 
@@ -683,8 +683,13 @@ void ImageFileWriter<TInputImage>::Update()
 template <class TInputImage>
 void ImageFileWriter<TInputImage>::GenerateData(void)
 {
-  const InputImageType* input = this->GetInput();
-  InputImagePointer     cacheImage;
+  this->WriteImageBuffer(this->GetInput());
+}
+
+template <class TInputImage>
+void ImageFileWriter<TInputImage>::WriteImageBuffer(const InputImageType* input)
+{
+  InputImagePointer cacheImage;
 
   // Make sure that the image is the right type and no more than
   // four components.
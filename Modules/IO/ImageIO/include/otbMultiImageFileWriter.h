@@ -28,7 +28,13 @@
 #include "itkImageIOBase.h"
 #include "OTBImageIOExport.h"
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 namespace otb
 {
@@ -42,6 +48,18 @@ namespace otb
  *  is interpreted on the first input to deduce the number of streams. This
  *  number of streams is then used to split the other inputs.
  *
+ *  When the output files are written by blocks (e.g. tiled GeoTIFF), the
+ *  block sizes of all the outputs are combined into the tile hint given to
+ *  the adaptative streaming manager, so that divisions are aligned on the
+ *  blocks of every file.
+ *
+ *  When parallel writing is on (the default) and the image is streamed, each
+ *  division is copied once computed and handed to an I/O thread dedicated to
+ *  its output file, which encodes and writes it while the pipeline computes
+ *  the next division. At most two copies per output are pending at a time,
+ *  they are accounted for when the number of divisions is estimated from the
+ *  available RAM.
+ *
  * \ingroup OTBImageIO
  */
 class OTBImageIO_EXPORT MultiImageFileWriter : public itk::ProcessObject
@@ -113,6 +131,12 @@ public:
    *   is set from the CMake configuration option */
   void SetAutomaticAdaptativeStreaming(unsigned int availableRAM = 0, double bias = 1.0);
 
+  /** Write each output file from its own I/O thread while the pipeline
+   *  computes the next divisions (On by default) */
+  itkSetMacro(ParallelWriting, bool);
+  itkGetConstMacro(ParallelWriting, bool);
+  itkBooleanMacro(ParallelWriting);
+
   virtual void UpdateOutputData(itk::DataObject* itkNotUsed(output)) override;
 
   /** Connect a new input to the multi-writer. Only the input pointer is
@@ -169,6 +193,10 @@ protected:
   /** Returns the current stream region of the given input */
   virtual RegionType GetStreamRegion(int inputIndex);
 
+  /** Sets the tile hint of the fake output from the block sizes of the
+   *  output files, when they have any. */
+  void SetTileHintFromOutputBlocks();
+
   void operator=(const MultiImageFileWriter&) = delete;
 
   void ObserveSourceFilterProgress(itk::Object* object, const itk::EventObject& event)
@@ -206,6 +234,8 @@ private:
   bool          m_IsObserving;
   unsigned long m_ObserverID;
 
+  bool m_ParallelWriting;
+
   /** \class SinkBase
    * Internal base wrapper class to handle each ImageFileWriter
    *
@@ -222,6 +252,7 @@ private:
     }
     virtual ~SinkBase()
     {
+      this->StopIOThread(false);
     }
     virtual ImageBaseType::ConstPointer GetInput() const
     {
@@ -233,15 +264,40 @@ private:
     }
     virtual void WriteImageInformation()                 = 0;
     virtual void Write(const RegionType& streamRegion)   = 0;
+    /** Updates the input on the stream region, then writes a copy of it from
+     *  the I/O thread */
+    virtual void WriteAsync(const RegionType& streamRegion) = 0;
     virtual bool                        CanStreamWrite() const = 0;
+    virtual void GetWriteBlockSize(unsigned int& blockSizeX, unsigned int& blockSizeY) const = 0;
+    /** Size in bytes of a buffer holding the whole region to write */
+    virtual StreamingManagerType::MemoryPrintType GetRegionToWriteMemoryPrint() const = 0;
     typedef std::shared_ptr<SinkBase> Pointer;
 
 
     virtual itk::ImageRegion<2> GetRegionToWrite() const = 0;
 
+    /** Waits for the pending writes and stops the I/O thread. The first
+     *  error raised by a write is rethrown if rethrow is true. */
+    void StopIOThread(bool rethrow);
+
   protected:
+    /** Queues a job for the I/O thread, which is started on first use. Blocks
+     *  while a job is already waiting, and rethrows the error of a previous
+     *  job if any. */
+    void PushIOJob(std::function<void()> job);
+
     /** The image on which streaming is performed */
     ImageBaseType::ConstPointer m_InputImage;
+
+  private:
+    void RunIOThread();
+
+    std::thread                       m_IOThread;
+    std::mutex                        m_IOMutex;
+    std::condition_variable           m_IOCondition;
+    std::deque<std::function<void()>> m_IOJobs;
+    std::exception_ptr                m_IOError;
+    bool                              m_StopIO = false;
   };
 
   /** \class Sink
@@ -265,7 +321,10 @@ private:
 
     void WriteImageInformation() override;
     void Write(const RegionType& streamRegion) override;
+    void WriteAsync(const RegionType& streamRegion) override;
     bool                    CanStreamWrite() const override;
+    void GetWriteBlockSize(unsigned int& blockSizeX, unsigned int& blockSizeY) const override;
+    StreamingManagerType::MemoryPrintType GetRegionToWriteMemoryPrint() const override;
     typedef std::shared_ptr<Sink> Pointer;
     
     /** Get the region that should be written. By default this is the largest possible region
@@ -24,6 +24,8 @@
 #include "otbMultiImageFileWriter.h"
 #include "otbImageIOFactory.h"
 #include "otbMacro.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
 
 namespace otb
 {
@@ -71,6 +73,64 @@ void MultiImageFileWriter::Sink<TImage>::Write(const RegionType& streamRegion)
   m_Writer->UpdateOutputData(nullptr);
 }
 
+template <class TImage>
+void MultiImageFileWriter::Sink<TImage>::WriteAsync(const RegionType& streamRegion)
+{
+  // Compute the division in the calling thread
+  TImage* input = const_cast<TImage*>(m_Writer->GetInput());
+  input->UpdateOutputData();
+
+  // Copy it so that the pipeline can compute the next one meanwhile
+  RegionType inputRegion = streamRegion;
+  inputRegion.SetIndex(0, streamRegion.GetIndex(0) + this->GetRegionToWrite().GetIndex(0));
+  inputRegion.SetIndex(1, streamRegion.GetIndex(1) + this->GetRegionToWrite().GetIndex(1));
+
+  typename TImage::Pointer copy = TImage::New();
+  copy->CopyInformation(input);
+  copy->SetBufferedRegion(inputRegion);
+  copy->Allocate();
+  itk::ImageRegionConstIterator<TImage> inIt(input, inputRegion);
+  itk::ImageRegionIterator<TImage>      outIt(copy, inputRegion);
+  for (inIt.GoToBegin(), outIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt, ++outIt)
+  {
+    outIt.Set(inIt.Get());
+  }
+
+  itk::ImageIORegion ioRegion(TImage::ImageDimension);
+  for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+  {
+    ioRegion.SetSize(i, streamRegion.GetSize(i));
+    ioRegion.SetIndex(i, streamRegion.GetIndex(i));
+  }
+
+  // The job holds its own references: it may outlive this sink
+  typename otb::ImageFileWriter<TImage>::Pointer writer  = m_Writer;
+  otb::ImageIOBase::Pointer                      imageIO = m_ImageIO;
+  this->PushIOJob([writer, imageIO, copy, ioRegion]() {
+    imageIO->SetIORegion(ioRegion);
+    writer->WriteImageBuffer(copy);
+  });
+}
+
+template <class TImage>
+void MultiImageFileWriter::Sink<TImage>::GetWriteBlockSize(unsigned int& blockSizeX, unsigned int& blockSizeY) const
+{
+  if (m_ImageIO.IsNull())
+  {
+    blockSizeX = 0;
+    blockSizeY = 0;
+    return;
+  }
+  m_ImageIO->GetWriteBlockSize(blockSizeX, blockSizeY);
+}
+
+template <class TImage>
+MultiImageFileWriter::StreamingManagerType::MemoryPrintType MultiImageFileWriter::Sink<TImage>::GetRegionToWriteMemoryPrint() const
+{
+  return static_cast<StreamingManagerType::MemoryPrintType>(this->GetRegionToWrite().GetNumberOfPixels()) *
+         m_Writer->GetInput()->GetNumberOfComponentsPerPixel() * sizeof(typename TImage::InternalPixelType);
+}
+
 template <class TImage>
 itk::ImageRegion<2>
 MultiImageFileWriter::Sink<TImage>::GetRegionToWrite() const
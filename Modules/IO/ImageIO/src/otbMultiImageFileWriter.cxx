@@ -24,7 +24,7 @@
 namespace otb
 {
 
-MultiImageFileWriter::MultiImageFileWriter() : m_NumberOfDivisions(0), m_CurrentDivision(0), m_DivisionProgress(0.0), m_IsObserving(true), m_ObserverID(0)
+MultiImageFileWriter::MultiImageFileWriter() : m_NumberOfDivisions(0), m_CurrentDivision(0), m_DivisionProgress(0.0), m_IsObserving(true), m_ObserverID(0), m_ParallelWriting(true)
 {
   // By default, we use tiled streaming, with automatic tile size
   // We don't set any parameter, so the memory size is retrieved from the OTB configuration options
@@ -150,6 +150,20 @@ void MultiImageFileWriter::InitializeStreaming()
      * first input. Then there is a check that each input can be split into
      * this number of pieces.
      */
+    this->SetTileHintFromOutputBlocks();
+
+    // With parallel writing, up to two copies of each division of each input
+    // are pending beside the pipeline
+    StreamingManagerType::MemoryPrintType pendingCopiesPrint = 0;
+    if (m_ParallelWriting)
+    {
+      for (auto const& sink : m_SinkList)
+      {
+        pendingCopiesPrint += 2 * sink->GetRegionToWriteMemoryPrint();
+      }
+    }
+    m_StreamingManager->SetAdditionalMemoryPrint(pendingCopiesPrint);
+
     FakeOutputType* fakeOut = static_cast<FakeOutputType*>(this->itk::ProcessObject::GetOutput(0));
     RegionType      region  = fakeOut->GetLargestPossibleRegion();
     m_StreamingManager->PrepareStreaming(fakeOut, region);
@@ -184,6 +198,58 @@ void MultiImageFileWriter::InitializeStreaming()
   }
 }
 
+void MultiImageFileWriter::SetTileHintFromOutputBlocks()
+{
+  FakeOutputType* fakeOut = static_cast<FakeOutputType*>(this->itk::ProcessObject::GetOutput(0));
+  const SizeType  size    = fakeOut->GetLargestPossibleRegion().GetSize();
+
+  // Least common multiple of the block sizes of the outputs, along each
+  // dimension. It is capped by the image size: the adaptative splitter then
+  // makes a single tile along this dimension.
+  unsigned long hint[2]   = {0, 0};
+  bool          hasBlocks = false;
+  for (auto const& sink : m_SinkList)
+  {
+    unsigned int blockSize[2] = {0, 0};
+    sink->GetWriteBlockSize(blockSize[0], blockSize[1]);
+    for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+      if (blockSize[dim] == 0)
+      {
+        continue;
+      }
+      hasBlocks = true;
+      if (hint[dim] == 0)
+      {
+        hint[dim] = blockSize[dim];
+      }
+      else
+      {
+        unsigned long a = hint[dim], b = blockSize[dim];
+        while (b != 0)
+        {
+          const unsigned long r = a % b;
+          a                     = b;
+          b                     = r;
+        }
+        hint[dim] = std::min<unsigned long>(hint[dim] / a * blockSize[dim], size[dim]);
+      }
+    }
+  }
+
+  if (!hasBlocks)
+  {
+    // Keep the tile hint of the first input
+    return;
+  }
+
+  // Blocks without constraint along a dimension span the whole image (strips)
+  ImageMetadata& imd = fakeOut->GetImageMetadata();
+  imd.Add(MDNum::TileHintX, hint[0] != 0 ? hint[0] : size[0]);
+  imd.Add(MDNum::TileHintY, hint[1] != 0 ? hint[1] : 1);
+  otbMsgDevMacro(<< "Tile hint from the output blocks: " << imd[MDNum::TileHintX] << "x" << imd[MDNum::TileHintY]);
+}
+
 void MultiImageFileWriter::ResetAllRequestedRegions(ImageBaseType* imagePtr)
 {
   RegionType nullRegion = imagePtr->GetLargestPossibleRegion();
@@ -268,48 +334,66 @@ void MultiImageFileWriter::UpdateOutputData(itk::DataObject* itkNotUsed(output))
     }
   }
 
-  for (m_CurrentDivision = 0; m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
-       m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
+  try
   {
-    // Update all stream regions
-    for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+    for (m_CurrentDivision = 0; m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
+         m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
     {
-      m_StreamRegionList[inputIndex] = GetStreamRegion(inputIndex);
-    }
+      // Update all stream regions
+      for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+      {
+        m_StreamRegionList[inputIndex] = GetStreamRegion(inputIndex);
+      }
 
-    // NOTE : this reset was probably designed to work with the next section
-    // Where the final requested region is the "union" between the computed
-    // requested region and the current requested region.
+      // NOTE : this reset was probably designed to work with the next section
+      // Where the final requested region is the "union" between the computed
+      // requested region and the current requested region.
 
-    // Reset requested regions for all images
-    for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
-    {
-      ResetAllRequestedRegions(m_SinkList[inputIndex]->GetInput());
-    }
+      // Reset requested regions for all images
+      for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+      {
+        ResetAllRequestedRegions(m_SinkList[inputIndex]->GetInput());
+      }
 
-    for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
-    {
-      ImageBaseType::Pointer inputPtr                    = m_SinkList[inputIndex]->GetInput();
-      RegionType             inputRequestedRegion        = m_StreamRegionList[inputIndex];
-      const RegionType&      currentInputRequestedRegion = inputPtr->GetRequestedRegion();
-      if (currentInputRequestedRegion != inputPtr->GetLargestPossibleRegion() && currentInputRequestedRegion.GetNumberOfPixels() != 0)
+      for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
       {
-        IndexType startIndex = currentInputRequestedRegion.GetIndex();
-        IndexType lastIndex  = currentInputRequestedRegion.GetUpperIndex();
-        startIndex[0]        = std::min(startIndex[0], inputRequestedRegion.GetIndex(0));
-        startIndex[1]        = std::min(startIndex[1], inputRequestedRegion.GetIndex(1));
-        lastIndex[0]         = std::max(lastIndex[0], inputRequestedRegion.GetUpperIndex()[0]);
-        lastIndex[1]         = std::max(lastIndex[1], inputRequestedRegion.GetUpperIndex()[1]);
-        inputRequestedRegion.SetIndex(startIndex);
-        inputRequestedRegion.SetUpperIndex(lastIndex);
+        ImageBaseType::Pointer inputPtr                    = m_SinkList[inputIndex]->GetInput();
+        RegionType             inputRequestedRegion        = m_StreamRegionList[inputIndex];
+        const RegionType&      currentInputRequestedRegion = inputPtr->GetRequestedRegion();
+        if (currentInputRequestedRegion != inputPtr->GetLargestPossibleRegion() && currentInputRequestedRegion.GetNumberOfPixels() != 0)
+        {
+          IndexType startIndex = currentInputRequestedRegion.GetIndex();
+          IndexType lastIndex  = currentInputRequestedRegion.GetUpperIndex();
+          startIndex[0]        = std::min(startIndex[0], inputRequestedRegion.GetIndex(0));
+          startIndex[1]        = std::min(startIndex[1], inputRequestedRegion.GetIndex(1));
+          lastIndex[0]         = std::max(lastIndex[0], inputRequestedRegion.GetUpperIndex()[0]);
+          lastIndex[1]         = std::max(lastIndex[1], inputRequestedRegion.GetUpperIndex()[1]);
+          inputRequestedRegion.SetIndex(startIndex);
+          inputRequestedRegion.SetUpperIndex(lastIndex);
+        }
+
+        inputPtr->SetRequestedRegion(inputRequestedRegion);
+        inputPtr->PropagateRequestedRegion();
       }
 
-      inputPtr->SetRequestedRegion(inputRequestedRegion);
-      inputPtr->PropagateRequestedRegion();
+      /** Call GenerateData to write streams to files if needed */
+      this->GenerateData();
     }
 
-    /** Call GenerateData to write streams to files if needed */
-    this->GenerateData();
+    // Wait for the I/O threads to write the last divisions
+    for (auto const& sink : m_SinkList)
+    {
+      sink->StopIOThread(true);
+    }
+  }
+  catch (...)
+  {
+    for (auto const& sink : m_SinkList)
+    {
+      sink->StopIOThread(false);
+    }
+    this->m_Updating = false;
+    throw;
   }
 
   /**
@@ -394,7 +478,14 @@ void MultiImageFileWriter::GenerateData()
     index[1] -= shiftIndex[1];
     
     region.SetIndex(index);
-    m_SinkList[inputIndex]->Write(region);
+    if (m_ParallelWriting && m_NumberOfDivisions > 1)
+    {
+      m_SinkList[inputIndex]->WriteAsync(region);
+    }
+    else
+    {
+      m_SinkList[inputIndex]->Write(region);
+    }
   }
 }
 
@@ -407,4 +498,85 @@ MultiImageFileWriter::RegionType MultiImageFileWriter::GetStreamRegion(int input
   return region;
 }
 
+void MultiImageFileWriter::SinkBase::PushIOJob(std::function<void()> job)
+{
+  std::unique_lock<std::mutex> lock(m_IOMutex);
+  if (!m_IOThread.joinable())
+  {
+    m_StopIO   = false;
+    m_IOThread = std::thread(&SinkBase::RunIOThread, this);
+  }
+
+  // At most one job waits while another one is being written
+  m_IOCondition.wait(lock, [this] { return m_IOJobs.empty() || m_IOError; });
+  if (m_IOError)
+  {
+    std::exception_ptr error = m_IOError;
+    m_IOError                = nullptr;
+    std::rethrow_exception(error);
+  }
+  m_IOJobs.push_back(std::move(job));
+  m_IOCondition.notify_all();
+}
+
+void MultiImageFileWriter::SinkBase::RunIOThread()
+{
+  std::unique_lock<std::mutex> lock(m_IOMutex);
+  while (true)
+  {
+    m_IOCondition.wait(lock, [this] { return !m_IOJobs.empty() || m_StopIO; });
+    if (m_IOJobs.empty())
+    {
+      return;
+    }
+    std::function<void()> job = std::move(m_IOJobs.front());
+    m_IOJobs.pop_front();
+    m_IOCondition.notify_all();
+
+    // Once a write failed, the remaining divisions are dropped
+    if (m_IOError)
+    {
+      continue;
+    }
+
+    lock.unlock();
+    std::exception_ptr error;
+    try
+    {
+      job();
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    lock.lock();
+    if (error)
+    {
+      m_IOError = error;
+      m_IOCondition.notify_all();
+    }
+  }
+}
+
+void MultiImageFileWriter::SinkBase::StopIOThread(bool rethrow)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_IOMutex);
+    if (!m_IOThread.joinable())
+    {
+      return;
+    }
+    m_StopIO = true;
+  }
+  m_IOCondition.notify_all();
+  m_IOThread.join();
+
+  std::exception_ptr error;
+  std::swap(error, m_IOError);
+  if (rethrow && error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
 } // end of namespace otb
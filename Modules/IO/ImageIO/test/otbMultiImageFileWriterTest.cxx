@@ -21,6 +21,9 @@
 #include "otbMultiImageFileWriter.h"
 #include "otbImage.h"
 #include "otbImageFileReader.h"
+#include "itkRandomImageSource.h"
+
+#include <vector>
 
 int otbMultiImageFileWriterTest(int argc, char* argv[])
 {
@@ -37,7 +40,7 @@ int otbMultiImageFileWriterTest(int argc, char* argv[])
 
   if (argc < 6)
   {
-    std::cout << "Usage: " << argv[0] << " inputImageFileName1 inputImageFileName2 outputImageFileName1 outputImageFileName2 numberOfLinesPerStrip\n";
+    std::cout << "Usage: " << argv[0] << " inputImageFileName1 inputImageFileName2 outputImageFileName1 outputImageFileName2 numberOfLinesPerStrip [parallelWriting]\n";
     return EXIT_FAILURE;
   }
 
@@ -46,6 +49,7 @@ int otbMultiImageFileWriterTest(int argc, char* argv[])
   const std::string outputImageFileName1  = argv[3];
   const std::string outputImageFileName2  = argv[4];
   const int         numberOfLinesPerStrip = atoi(argv[5]);
+  const bool        parallelWriting       = argc > 6 ? atoi(argv[6]) != 0 : true;
 
   ReaderType1::Pointer reader1 = ReaderType1::New();
   reader1->SetFileName(inputImageFileName1);
@@ -61,6 +65,7 @@ int otbMultiImageFileWriterTest(int argc, char* argv[])
   writer->AddInputImage(reader1->GetOutput(), outputImageFileName1);
   writer->AddInputWriter<WriterType2>(writer2);
   writer->SetNumberOfLinesStrippedStreaming(numberOfLinesPerStrip);
+  writer->SetParallelWriting(parallelWriting);
 
   writer->Update();
 
@@ -68,3 +73,110 @@ int otbMultiImageFileWriterTest(int argc, char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+namespace
+{
+/** Multi-writer recording the stream regions of its inputs */
+class StreamRegionRecorder : public otb::MultiImageFileWriter
+{
+public:
+  typedef StreamRegionRecorder          Self;
+  typedef otb::MultiImageFileWriter     Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(StreamRegionRecorder, otb::MultiImageFileWriter);
+
+  std::vector<std::vector<RegionType>> StreamRegions;
+
+protected:
+  StreamRegionRecorder() = default;
+
+  RegionType GetStreamRegion(int inputIndex) override
+  {
+    const RegionType region = Superclass::GetStreamRegion(inputIndex);
+    if (StreamRegions.size() <= static_cast<unsigned int>(inputIndex))
+    {
+      StreamRegions.resize(inputIndex + 1);
+    }
+    StreamRegions[inputIndex].push_back(region);
+    return region;
+  }
+};
+}
+
+int otbMultiImageFileWriterAdaptativeSplit(int argc, char* argv[])
+{
+  typedef otb::Image<float, 2>              ImageType;
+  typedef itk::RandomImageSource<ImageType> SourceType;
+  typedef StreamRegionRecorder::RegionType  RegionType;
+
+  if (argc < 3)
+  {
+    std::cout << "Usage: " << argv[0] << " outputImageFileName1 outputImageFileName2\n";
+    return EXIT_FAILURE;
+  }
+
+  // Outputs tiled by 32x64 and 48x16 pixels: divisions shall be aligned on
+  // 96x64 pixels
+  const std::string   outputImageFileName1 = std::string(argv[1]) + "?&gdal:co:TILED=YES&gdal:co:BLOCKXSIZE=32&gdal:co:BLOCKYSIZE=64";
+  const std::string   outputImageFileName2 = std::string(argv[2]) + "?&gdal:co:TILED=YES&gdal:co:BLOCKXSIZE=48&gdal:co:BLOCKYSIZE=16";
+  const unsigned long hint[2]              = {96, 64};
+
+  ImageType::SizeType size;
+  size[0] = 960;
+  size[1] = 640;
+  std::vector<SourceType::Pointer> sources;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    SourceType::Pointer source = SourceType::New();
+    source->SetSize(size);
+    sources.push_back(source);
+  }
+
+  // Number of divisions with and without parallel writing, for 1 MB of RAM
+  unsigned int nbDivisions[2] = {0, 0};
+  for (unsigned int parallel = 0; parallel < 2; ++parallel)
+  {
+    StreamRegionRecorder::Pointer writer = StreamRegionRecorder::New();
+    writer->AddInputImage(sources[0]->GetOutput(), outputImageFileName1);
+    writer->AddInputImage(sources[1]->GetOutput(), outputImageFileName2);
+    writer->SetAutomaticAdaptativeStreaming(1);
+    writer->SetParallelWriting(parallel != 0);
+    writer->Update();
+
+    for (auto const& regions : writer->StreamRegions)
+    {
+      for (RegionType const& region : regions)
+      {
+        for (unsigned int dim = 0; dim < 2; ++dim)
+        {
+          const unsigned long index = region.GetIndex(dim);
+          const unsigned long end   = index + region.GetSize(dim);
+          if (index % hint[dim] != 0 || (end % hint[dim] != 0 && end != size[dim]))
+          {
+            std::cerr << "Fail: division " << region << " is not aligned on the blocks of the outputs" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+    nbDivisions[parallel] = writer->StreamRegions.front().size();
+    std::cout << "Number of divisions with parallel writing " << (parallel ? "on" : "off") << ": " << nbDivisions[parallel] << std::endl;
+  }
+
+  if (nbDivisions[0] < 2)
+  {
+    std::cerr << "Fail: the image shall be streamed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  // The copies pending for the I/O threads shall be accounted for
+  if (nbDivisions[1] <= nbDivisions[0])
+  {
+    std::cerr << "Fail: parallel writing shall use smaller divisions" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
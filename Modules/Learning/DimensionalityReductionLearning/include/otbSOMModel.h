@@ -93,6 +93,8 @@ public:
   itkGetMacro(RandomInit, bool);
   itkSetMacro(Seed, unsigned int);
   itkGetMacro(Seed, unsigned int);
+  itkSetMacro(BatchSize, unsigned int);
+  itkGetMacro(BatchSize, unsigned int);
 
   bool CanReadFile(const std::string& filename) override;
   bool CanWriteFile(const std::string& filename) override;
@@ -129,6 +131,8 @@ private:
   bool m_RandomInit;
   /** Seed for random initialization */
   unsigned int m_Seed;
+  /** Number of samples per mini-batch (0 for on-line training) */
+  unsigned int m_BatchSize{0};
   /** Behavior of the Learning weightening (link to the beta coefficient) */
   SOMLearningBehaviorFunctorType m_BetaFunctor;
   /** Behavior of the Neighborhood extent */
@@ -76,6 +76,7 @@ void SOMModel<TInputValue, MapDimension>::Train()
   estimator->SetBetaInit(m_BetaInit);
   estimator->SetBetaEnd(m_BetaEnd);
   estimator->SetMaxWeight(m_MaxWeight);
+  estimator->SetBatchSize(m_BatchSize);
   estimator->Update();
   m_SOMMap = estimator->GetOutput();
 }
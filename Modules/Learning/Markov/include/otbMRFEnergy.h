@@ -25,6 +25,8 @@
 #include "itkObject.h"
 #include "itkArray.h"
 
+#include <vector>
+
 namespace otb
 {
 /**
@@ -71,7 +73,7 @@ public:
     return this->m_Parameters;
   }
 
-  void SetParameters(const ParametersType& parameters)
+  virtual void SetParameters(const ParametersType& parameters)
   {
     if (parameters.Size() != m_NumberOfParameters)
     {
@@ -135,6 +137,24 @@ public:
     return result / insideNeighbors;
   }
 
+  /** Whether GetValue() on a labelled neighborhood only depends on the number
+   * of neighbors holding each label. Such energies implement
+   * GetValueFromLabelCounts(), which lets the samplers evaluate all the
+   * candidate labels of a pixel from a single pass over its neighborhood. */
+  virtual bool IsLabelCountBased() const
+  {
+    return false;
+  }
+
+  /** Value of GetValue() on a labelled neighborhood for the label \c value2,
+   * given the number \c labelCounts[l] of inside neighbors holding each label
+   * \c l, and their total \c numberOfNeighbors. */
+  virtual double GetValueFromLabelCounts(const std::vector<unsigned int>& itkNotUsed(labelCounts), unsigned int itkNotUsed(numberOfNeighbors),
+                                         const LabelledImagePixelType& itkNotUsed(value2)) const
+  {
+    itkExceptionMacro(<< "GetValueFromLabelCounts() has to be declared in label-count based child classes.");
+  }
+
 protected:
   // The constructor and destructor.
   MRFEnergy() : m_NumberOfParameters(1), m_Parameters(0){};
@@ -173,7 +193,7 @@ public:
     return this->m_Parameters;
   }
 
-  void SetParameters(const ParametersType& parameters)
+  virtual void SetParameters(const ParametersType& parameters)
   {
     if (parameters.Size() != m_NumberOfParameters)
     {
@@ -215,6 +235,24 @@ public:
     return result / insideNeighbors;
   }
 
+  /** Whether GetValue() on a labelled neighborhood only depends on the number
+   * of neighbors holding each label. Such energies implement
+   * GetValueFromLabelCounts(), which lets the samplers evaluate all the
+   * candidate labels of a pixel from a single pass over its neighborhood. */
+  virtual bool IsLabelCountBased() const
+  {
+    return false;
+  }
+
+  /** Value of GetValue() on a labelled neighborhood for the label \c value2,
+   * given the number \c labelCounts[l] of inside neighbors holding each label
+   * \c l, and their total \c numberOfNeighbors. */
+  virtual double GetValueFromLabelCounts(const std::vector<unsigned int>& itkNotUsed(labelCounts), unsigned int itkNotUsed(numberOfNeighbors),
+                                         const LabelledImagePixelType& itkNotUsed(value2)) const
+  {
+    itkExceptionMacro(<< "GetValueFromLabelCounts() has to be declared in label-count based child classes.");
+  }
+
 protected:
   // The constructor and destructor.
   MRFEnergy() : m_NumberOfParameters(1), m_Parameters(0){};
@@ -68,9 +68,16 @@ public:
   {
     Superclass::SetNumberOfParameters(nParameters);
     this->m_Parameters.SetSize(nParameters);
+    this->UpdateClassTables();
     this->Modified();
   }
 
+  void SetParameters(const ParametersType& parameters) override
+  {
+    Superclass::SetParameters(parameters);
+    this->UpdateClassTables();
+  }
+
   double GetSingleValue(const InputImagePixelType& value1, const LabelledImagePixelType& value2) override
   {
     if ((unsigned int)value2 >= this->GetNumberOfParameters() / 2)
@@ -79,9 +86,8 @@ public:
     }
     double val1 = static_cast<double>(value1);
 
-    double result =
-        vnl_math_sqr(val1 - this->m_Parameters[2 * static_cast<int>(value2)]) / (2 * vnl_math_sqr(this->m_Parameters[2 * static_cast<int>(value2) + 1])) +
-        std::log(std::sqrt(CONST_2PI) * this->m_Parameters[2 * static_cast<int>(value2) + 1]);
+    const unsigned int label  = static_cast<unsigned int>(value2);
+    double             result = vnl_math_sqr(val1 - this->m_Parameters[2 * label]) / m_TwoVariances[label] + m_LogNormalizations[label];
 
     return static_cast<double>(result);
   }
@@ -92,6 +98,24 @@ protected:
   ~MRFEnergyGaussianClassification() override
   {
   }
+
+  /** Precompute the terms of each class which do not depend on the pixel
+   * value, so that GetSingleValue() does not evaluate a logarithm per call. */
+  void UpdateClassTables()
+  {
+    const unsigned int nbClasses = this->m_Parameters.Size() / 2;
+    m_TwoVariances.resize(nbClasses);
+    m_LogNormalizations.resize(nbClasses);
+    for (unsigned int label = 0; label < nbClasses; ++label)
+    {
+      m_TwoVariances[label]      = 2 * vnl_math_sqr(this->m_Parameters[2 * label + 1]);
+      m_LogNormalizations[label] = std::log(std::sqrt(CONST_2PI) * this->m_Parameters[2 * label + 1]);
+    }
+  }
+
+private:
+  std::vector<double> m_TwoVariances;
+  std::vector<double> m_LogNormalizations;
 };
 }
 
@@ -78,6 +78,19 @@ public:
     }
   }
 
+  bool IsLabelCountBased() const override
+  {
+    return true;
+  }
+
+  double GetValueFromLabelCounts(const std::vector<unsigned int>& labelCounts, unsigned int numberOfNeighbors,
+                                 const LabelledImagePixelType& value2) const override
+  {
+    // Neighbors holding value2 contribute -beta, the others +beta
+    const double sameLabel = static_cast<double>(labelCounts[static_cast<unsigned int>(value2)]);
+    return this->m_Parameters[0] * (numberOfNeighbors - 2.0 * sameLabel) / numberOfNeighbors;
+  }
+
 protected:
   // The constructor and destructor.
   MRFEnergyPotts()
@@ -71,6 +71,22 @@ public:
 
   virtual bool Compute(double deltaEnergy) = 0;
 
+  /** Create an optimizer of the same type with the same parameters.
+   * Optimizers drawing random values override it to give the copy its own
+   * generator, seeded with \c seed, so that copies can run concurrently (see
+   * MarkovRandomFieldFilter::SetCheckerboardUpdate()). */
+  virtual Pointer CreateCopy(unsigned int itkNotUsed(seed)) const
+  {
+    Pointer copy = dynamic_cast<Self*>(this->CreateAnother().GetPointer());
+    if (copy.IsNull())
+    {
+      itkExceptionMacro(<< "Cannot create a copy of the optimizer.");
+    }
+    copy->m_NumberOfParameters = m_NumberOfParameters;
+    copy->m_Parameters         = m_Parameters;
+    return copy;
+  }
+
 protected:
   MRFOptimizer() : m_NumberOfParameters(1), m_Parameters(1)
   {
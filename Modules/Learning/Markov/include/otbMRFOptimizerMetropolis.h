@@ -92,6 +92,16 @@ public:
     return false;
   }
 
+  /** The copy draws its values from its own generator */
+  Superclass::Pointer CreateCopy(unsigned int seed) const override
+  {
+    Superclass::Pointer copy          = Superclass::CreateCopy(seed);
+    Self*               optimizerCopy = static_cast<Self*>(copy.GetPointer());
+    optimizerCopy->m_Generator        = RandomGeneratorType::New();
+    optimizerCopy->m_Generator->SetSeed(seed);
+    return copy;
+  }
+
   /** Methods to cancel random effects.*/
   void InitializeSeed(int seed)
   {
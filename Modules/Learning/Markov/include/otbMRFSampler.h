@@ -24,6 +24,8 @@
 #include "otbMRFEnergy.h"
 #include "itkNeighborhoodIterator.h"
 
+#include <vector>
+
 namespace otb
 {
 /**
@@ -81,7 +83,69 @@ public:
 
   virtual int Compute(const InputImageNeighborhoodIterator& itData, const LabelledImageNeighborhoodIterator& itRegul) = 0;
 
+  /** Create a sampler of the same type, sharing the parameters and the
+   * energies of this one. Samplers drawing random values override it to give
+   * the copy its own generator, seeded with \c seed, so that copies can run
+   * concurrently (see MarkovRandomFieldFilter::SetCheckerboardUpdate()). */
+  virtual Pointer CreateCopy(unsigned int itkNotUsed(seed)) const
+  {
+    Pointer copy = dynamic_cast<Self*>(this->CreateAnother().GetPointer());
+    if (copy.IsNull())
+    {
+      itkExceptionMacro(<< "Cannot create a copy of the sampler.");
+    }
+    copy->SetNumberOfClasses(m_NumberOfClasses);
+    copy->SetLambda(m_Lambda);
+    copy->SetEnergyRegularization(m_EnergyRegularization.GetPointer());
+    copy->SetEnergyFidelity(m_EnergyFidelity.GetPointer());
+    return copy;
+  }
+
 protected:
+  /** Fill the label-count table of the neighborhood of itRegul, when the
+   * regularization energy is label-count based and all the neighbors hold
+   * one of the NumberOfClasses labels. */
+  void ComputeLabelCounts(const LabelledImageNeighborhoodIterator& itRegul)
+  {
+    m_UseLabelCounts = m_EnergyRegularization->IsLabelCountBased();
+    if (!m_UseLabelCounts)
+    {
+      return;
+    }
+    m_LabelCounts.assign(m_NumberOfClasses, 0);
+    m_NumberOfNeighbors            = 0;
+    const unsigned int centerIndex = itRegul.GetCenterNeighborhoodIndex();
+    bool               isInside    = false;
+    for (unsigned int pos = 0; pos < itRegul.Size(); ++pos)
+    {
+      if (pos != centerIndex)
+      {
+        const unsigned int label = static_cast<unsigned int>(itRegul.GetPixel(pos, isInside));
+        if (isInside)
+        {
+          if (label >= m_NumberOfClasses)
+          {
+            m_UseLabelCounts = false;
+            return;
+          }
+          ++m_LabelCounts[label];
+          ++m_NumberOfNeighbors;
+        }
+      }
+    }
+  }
+
+  /** Regularization energy of value at the center of itRegul, evaluated
+   * from the label-count table when ComputeLabelCounts() could fill it. */
+  double GetRegularizationValue(const LabelledImageNeighborhoodIterator& itRegul, const LabelledImagePixelType& value)
+  {
+    if (m_UseLabelCounts && static_cast<unsigned int>(value) < m_NumberOfClasses)
+    {
+      return m_EnergyRegularization->GetValueFromLabelCounts(m_LabelCounts, m_NumberOfNeighbors, value);
+    }
+    return m_EnergyRegularization->GetValue(itRegul, value);
+  }
+
   unsigned int m_NumberOfClasses;
   double       m_EnergyBefore;
   double       m_EnergyAfter;
@@ -94,9 +158,21 @@ protected:
   EnergyFidelityPointer       m_EnergyFidelity;
   LabelledImagePixelType      m_ValueCurrent;
 
+  std::vector<unsigned int> m_LabelCounts;
+  unsigned int              m_NumberOfNeighbors;
+  bool                      m_UseLabelCounts;
+
 protected:
   // The constructor and destructor.
-  MRFSampler() : m_NumberOfClasses(1), m_EnergyBefore(1.0), m_EnergyAfter(1.0), m_DeltaEnergy(1.0), m_EnergyCurrent(1.0), m_Lambda(1.0)
+  MRFSampler()
+    : m_NumberOfClasses(1),
+      m_EnergyBefore(1.0),
+      m_EnergyAfter(1.0),
+      m_DeltaEnergy(1.0),
+      m_EnergyCurrent(1.0),
+      m_Lambda(1.0),
+      m_NumberOfNeighbors(0),
+      m_UseLabelCounts(false)
   {
     m_EnergyRegularization = EnergyRegularizationType::New();
     m_EnergyFidelity       = EnergyFidelityType::New();
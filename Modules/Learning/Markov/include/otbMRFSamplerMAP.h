@@ -70,8 +70,11 @@ public:
       itkExceptionMacro(<< "NumberOfClasse has to be greater than 0.");
     }
 
+    // A single pass over the neighborhood serves all the candidate labels
+    this->ComputeLabelCounts(itRegul);
+
     this->m_EnergyBefore = this->m_EnergyFidelity->GetValue(itData, itRegul.GetCenterPixel());
-    this->m_EnergyBefore += this->m_Lambda * this->m_EnergyRegularization->GetValue(itRegul, itRegul.GetCenterPixel());
+    this->m_EnergyBefore += this->m_Lambda * this->GetRegularizationValue(itRegul, itRegul.GetCenterPixel());
 
     // Try all possible value (how to be generic ?)
     this->m_EnergyAfter = this->m_EnergyBefore; // default values to current one
@@ -81,7 +84,7 @@ public:
     while (valueCurrent < static_cast<LabelledImagePixelType>(this->GetNumberOfClasses()) && valueCurrent != itk::NumericTraits<LabelledImagePixelType>::max())
     {
       this->m_EnergyCurrent = this->m_EnergyFidelity->GetValue(itData, valueCurrent);
-      this->m_EnergyCurrent += this->m_Lambda * this->m_EnergyRegularization->GetValue(itRegul, valueCurrent);
+      this->m_EnergyCurrent += this->m_Lambda * this->GetRegularizationValue(itRegul, valueCurrent);
       if (this->m_EnergyCurrent < this->m_EnergyAfter)
       {
         this->m_EnergyAfter = this->m_EnergyCurrent;
@@ -79,6 +79,16 @@ public:
     return 0;
   }
 
+  /** The copy draws its values from its own generator */
+  typename Superclass::Pointer CreateCopy(unsigned int seed) const override
+  {
+    typename Superclass::Pointer copy        = Superclass::CreateCopy(seed);
+    Self*                        samplerCopy = static_cast<Self*>(copy.GetPointer());
+    samplerCopy->m_Generator                 = RandomGeneratorType::New();
+    samplerCopy->m_Generator->SetSeed(seed);
+    return copy;
+  }
+
   /** Methods to cancel random effects.*/
   void InitializeSeed(int seed)
   {
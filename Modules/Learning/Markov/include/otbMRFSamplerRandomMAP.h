@@ -93,8 +93,11 @@ public:
       itkExceptionMacro(<< "NumberOfClasse has to be greater than 0.");
     }
 
+    // A single pass over the neighborhood serves all the candidate labels
+    this->ComputeLabelCounts(itRegul);
+
     this->m_EnergyBefore = this->m_EnergyFidelity->GetValue(itData, itRegul.GetCenterPixel());
-    this->m_EnergyBefore += this->m_Lambda * this->m_EnergyRegularization->GetValue(itRegul, itRegul.GetCenterPixel());
+    this->m_EnergyBefore += this->m_Lambda * this->GetRegularizationValue(itRegul, itRegul.GetCenterPixel());
 
     // Try all possible value (how to be generic ?)
     this->m_EnergyAfter = this->m_EnergyBefore; // default values to current one
@@ -106,7 +109,7 @@ public:
     for (valueCurrent = 0; valueCurrent < this->m_NumberOfClasses; ++valueCurrent)
     {
       this->m_EnergyCurrent = this->m_EnergyFidelity->GetValue(itData, static_cast<LabelledImagePixelType>(valueCurrent));
-      this->m_EnergyCurrent += this->m_Lambda * this->m_EnergyRegularization->GetValue(itRegul, static_cast<LabelledImagePixelType>(valueCurrent));
+      this->m_EnergyCurrent += this->m_Lambda * this->GetRegularizationValue(itRegul, static_cast<LabelledImagePixelType>(valueCurrent));
 
       m_Energy[valueCurrent]              = this->m_EnergyCurrent;
       m_RepartitionFunction[valueCurrent] = std::exp(-this->m_EnergyCurrent) + totalProba;
@@ -139,6 +142,16 @@ public:
     return 0;
   }
 
+  /** The copy draws its values from its own generator */
+  typename Superclass::Pointer CreateCopy(unsigned int seed) const override
+  {
+    typename Superclass::Pointer copy        = Superclass::CreateCopy(seed);
+    Self*                        samplerCopy = static_cast<Self*>(copy.GetPointer());
+    samplerCopy->m_Generator                 = RandomGeneratorType::New();
+    samplerCopy->m_Generator->SetSeed(seed);
+    return copy;
+  }
+
   /** Methods to cancel random effects.*/
   void InitializeSeed(int seed)
   {
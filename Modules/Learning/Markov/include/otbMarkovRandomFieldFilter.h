@@ -33,8 +33,12 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkNeighborhood.h"
 #include "itkSize.h"
+#include "itkMultiThreader.h"
 #include "otbMRFOptimizer.h"
 #include "otbMRFSampler.h"
+#include "otbParallelForRange.h"
+
+#include <cstdint>
 
 namespace otb
 {
@@ -69,6 +73,43 @@ namespace otb
  *   markovFilter->SetSampler(sampler);
  * \endcode
  *
+ * By default, each iteration visits the pixels sequentially in raster order.
+ * With SetCheckerboardUpdate(true), the pixels are split into colors such that
+ * no two pixels of the same color lie in each other's neighborhood: with a
+ * neighborhood radius r, the color of a pixel is its index modulo (r+1) along
+ * each dimension, i.e. the red-black ordering generalized to square
+ * neighborhoods ((r+1)^2 colors in 2D). An iteration updates the colors one
+ * after the other, and the pixels of a color are updated concurrently, each
+ * thread processing its own block of rows with its own copy of the sampler and
+ * of the optimizer. The copies draw their random values from independent
+ * generators, seeded from the filter generator (see InitializeSeed()), so
+ * that the result does not depend on the scheduling of the threads. The
+ * border rows of each block are read from the shared label buffer, where the
+ * neighboring blocks wrote them during the previous colors.
+ *
+ * In checkerboard mode, the filter is streamable. A color reads the labels up
+ * to r pixels away, so an iteration propagates a label at most
+ * GetNumberOfColors() * r pixels away, and the labels of a requested region
+ * only depend on the labels of the first iteration within GetHaloRadius()
+ * pixels. The output requested region is therefore enlarged by this halo, the
+ * labels are iterated over the enlarged region and the halo is recomputed by
+ * the neighboring streaming divisions rather than exchanged between them.
+ * The initial labels and the seeds of the copies are drawn once per update
+ * of the output information, the random initial labels being hashed from the
+ * pixel index: with a training input or a deterministic sampler and
+ * optimizer (e.g. MRFSamplerMAP and MRFOptimizerICM), a streamed result
+ * equals the one computed on the whole image. With random samplers or
+ * optimizers, each division is a valid but different realization, and a
+ * non-zero error tolerance is evaluated on each division. The halo grows with
+ * the maximum number of iterations: large values make the divisions overlap
+ * a lot.
+ *
+ * In sequential mode, the filter is not streamable: each iteration needs the
+ * labels of the whole image. It requests the largest possible region of its
+ * input and of its training input, and always produces its whole output,
+ * whatever the requested region. A streaming writer downstream runs it once,
+ * then writes its divisions from the output buffer.
+ *
  *
  * \ingroup Markov
  *
@@ -274,6 +315,20 @@ public:
   /** Get macro for number of iterations */
   itkGetConstReferenceMacro(NumberOfIterations, unsigned int);
 
+  /** Set/Get whether the pixels are updated color by color in parallel
+   * (checkerboard scheme) instead of sequentially. Default is false. */
+  itkSetMacro(CheckerboardUpdate, bool);
+  itkGetConstMacro(CheckerboardUpdate, bool);
+  itkBooleanMacro(CheckerboardUpdate);
+
+  /** Number of colors of the checkerboard scheme */
+  unsigned int GetNumberOfColors() const;
+
+  /** Margin added around the output requested region in checkerboard mode:
+   * MaximumNumberOfIterations * GetNumberOfColors() * radius along each
+   * dimension */
+  SizeType GetHaloRadius() const;
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(UnsignedIntConvertibleToClassifiedCheck, (itk::Concept::Convertible<unsigned int, LabelledImagePixelType>));
@@ -361,7 +416,31 @@ protected:
 
   virtual void MinimizeOnce();
 
+  /** Apply one iteration of the checkerboard scheme: the colors are updated
+   * one after the other, each one by all the threads. */
+  virtual void MinimizeOnceCheckerboard();
+
+  /** Update the pixels of the given color lying in the block of rows
+   * threadRegion, with the sampler and the optimizer of the thread threadId. */
+  void ThreadedMinimizeColor(unsigned int color, itk::ThreadIdType threadId, const LabelledImageRegionType& threadRegion);
+
 private:
+  /** Initial label of a pixel in checkerboard mode, hashed from its index so
+   * that it does not depend on the streaming division */
+  LabelledImagePixelType HashLabel(const LabelledImageIndexType& index) const;
+
+  bool m_CheckerboardUpdate;
+
+  /** Seed of the current update in checkerboard mode, drawn from the filter
+   * generator in GenerateOutputInformation() */
+  unsigned int m_RunSeed;
+
+  /** Per-thread copies of the sampler and of the optimizer, and per-thread
+   * results of the current iteration */
+  std::vector<SamplerPointer>   m_ThreadSamplers;
+  std::vector<OptimizerPointer> m_ThreadOptimizers;
+  std::vector<int>              m_ThreadErrorCounters;
+  std::vector<double>           m_ThreadDeltaEnergies;
 }; // class MarkovRandomFieldFilter
 
 } // namespace otb
@@ -39,7 +39,9 @@ MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::MarkovRandomFieldFilter(
     m_NumberOfIterations(0),
     m_Lambda(1.0),
     m_ExternalClassificationSet(false),
-    m_StopCondition(MaximumNumberOfIterations)
+    m_StopCondition(MaximumNumberOfIterations),
+    m_CheckerboardUpdate(false),
+    m_RunSeed(0)
 {
   m_Generator = RandomGeneratorType::GetInstance();
   m_Generator->SetSeed();
@@ -101,6 +103,8 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::PrintSelf(std::ostr
   os << indent << " Number of iterations: " << m_NumberOfIterations << std::endl;
 
   os << indent << " Lambda: " << m_Lambda << std::endl;
+
+  os << indent << " Checkerboard update: " << m_CheckerboardUpdate << std::endl;
 } // end PrintSelf
 
 /**
@@ -109,11 +113,39 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::PrintSelf(std::ostr
 template <class TInputImage, class TClassifiedImage>
 void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::GenerateInputRequestedRegion()
 {
-  // this filter requires the all of the input images
-  // to be at the size of the output requested region
-  InputImagePointer  inputPtr  = const_cast<InputImageType*>(this->GetInput());
-  OutputImagePointer outputPtr = this->GetOutput();
-  inputPtr->SetRequestedRegion(outputPtr->GetRequestedRegion());
+  InputImagePointer  inputPtr    = const_cast<InputImageType*>(this->GetInput());
+  TrainingImageType* trainingPtr = const_cast<TrainingImageType*>(this->GetTrainingInput());
+
+  if (!m_CheckerboardUpdate)
+  {
+    // Every iteration reads the labels of the whole image, so the filter
+    // requires the whole input images, whatever the output requested region
+    if (inputPtr)
+    {
+      inputPtr->SetRequestedRegionToLargestPossibleRegion();
+    }
+    if (trainingPtr)
+    {
+      trainingPtr->SetRequestedRegionToLargestPossibleRegion();
+    }
+    return;
+  }
+
+  // The output requested region already holds the halo (see
+  // EnlargeOutputRequestedRegion()): the labels are initialized on it, and
+  // the fidelity energy reads the input around it
+  const LabelledImageRegionType outputRegion = this->GetOutput()->GetRequestedRegion();
+  if (inputPtr)
+  {
+    InputImageRegionType inputRegion = outputRegion;
+    inputRegion.PadByRadius(m_InputImageNeighborhoodRadius);
+    inputRegion.Crop(inputPtr->GetLargestPossibleRegion());
+    inputPtr->SetRequestedRegion(inputRegion);
+  }
+  if (trainingPtr)
+  {
+    trainingPtr->SetRequestedRegion(outputRegion);
+  }
 }
 
 /**
@@ -122,11 +154,22 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::GenerateInputReques
 template <class TInputImage, class TClassifiedImage>
 void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::EnlargeOutputRequestedRegion(itk::DataObject* output)
 {
-  // this filter requires the all of the output image to be in
-  // the buffer
   TClassifiedImage* imgData;
   imgData = dynamic_cast<TClassifiedImage*>(output);
-  imgData->SetRequestedRegionToLargestPossibleRegion();
+
+  if (!m_CheckerboardUpdate)
+  {
+    // this filter produces the whole output image at once: downstream
+    // streaming divisions are then extracted from the buffer
+    imgData->SetRequestedRegionToLargestPossibleRegion();
+    return;
+  }
+
+  // The labels of the requested region are iterated with their halo
+  LabelledImageRegionType region = imgData->GetRequestedRegion();
+  region.PadByRadius(this->GetHaloRadius());
+  region.Crop(imgData->GetLargestPossibleRegion());
+  imgData->SetRequestedRegion(region);
 }
 
 /**
@@ -138,6 +181,9 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::GenerateOutputInfor
   typename TInputImage::ConstPointer input  = this->GetInput();
   typename TClassifiedImage::Pointer output = this->GetOutput();
   output->SetLargestPossibleRegion(input->GetLargestPossibleRegion());
+
+  // Every streaming division of this update shall use the same random values
+  m_RunSeed = m_Generator->GetIntegerVariate();
 }
 
 template <class TInputImage, class TClassifiedImage>
@@ -214,18 +260,21 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::Allocate()
   // Set the output labelled and allocate the memory
   LabelledImagePointer outputPtr = this->GetOutput();
 
-  // Allocate the output buffer memory
-  outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
+  // Allocate the output buffer memory: the labels of the whole image, or
+  // of the requested region and its halo in checkerboard mode, are updated
+  // at each iteration
+  const LabelledImageRegionType region = m_CheckerboardUpdate ? outputPtr->GetRequestedRegion() : outputPtr->GetLargestPossibleRegion();
+  outputPtr->SetBufferedRegion(region);
   outputPtr->Allocate();
 
   // Copy input data in the output buffer memory or
   // initialize to random values if not set
-  LabelledImageRegionIterator outImageIt(outputPtr, outputPtr->GetRequestedRegion());
+  LabelledImageRegionIterator outImageIt(outputPtr, region);
 
   if (m_ExternalClassificationSet)
   {
     typename TrainingImageType::ConstPointer trainingImage = this->GetTrainingInput();
-    LabelledImageRegionConstIterator         trainingImageIt(trainingImage, outputPtr->GetRequestedRegion());
+    LabelledImageRegionConstIterator         trainingImageIt(trainingImage, region);
 
     while (!outImageIt.IsAtEnd())
     {
@@ -236,6 +285,14 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::Allocate()
       ++outImageIt;
     } // end while
   }
+  else if (m_CheckerboardUpdate)
+  {
+    while (!outImageIt.IsAtEnd())
+    {
+      outImageIt.Set(this->HashLabel(outImageIt.GetIndex()));
+      ++outImageIt;
+    }
+  }
   else // set to random value
   {
     //       srand((unsigned)time(0));
@@ -249,6 +306,23 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::Allocate()
 
 } // Allocate
 
+template <class TInputImage, class TClassifiedImage>
+typename MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::LabelledImagePixelType
+MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::HashLabel(const LabelledImageIndexType& index) const
+{
+  // splitmix64 finalizer, chained over the seed and the index components
+  std::uint64_t hash = m_RunSeed;
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    hash ^= static_cast<std::uint64_t>(index[i]);
+    hash += 0x9e3779b97f4a7c15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+  }
+  return static_cast<LabelledImagePixelType>(hash % m_NumberOfClasses);
+}
+
 /**
 * Initialize pipeline and values
 */
@@ -258,7 +332,9 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::Initialize()
 
   m_ImageDeltaEnergy = 0.0;
 
-  InputImageSizeType inputImageSize = this->GetInput()->GetBufferedRegion().GetSize();
+  // Size of the iterated labels: the whole image, or the requested region
+  // and its halo in checkerboard mode
+  InputImageSizeType inputImageSize = this->GetOutput()->GetBufferedRegion().GetSize();
 
   //---------------------------------------------------------------------
   // Get the number of valid pixels in the output MRF image
@@ -315,11 +391,42 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::ApplyMarkovRandomFi
   m_NumberOfIterations = 0;
   m_ErrorCounter       = m_TotalNumberOfValidPixelsInOutputImage;
 
+  if (m_CheckerboardUpdate)
+  {
+    // Draw the seeds of the copies first: creating samplers and optimizers
+    // may reseed the shared generator. They derive from the seed of the
+    // update, so that all the streaming divisions use the same ones.
+    const itk::ThreadIdType numberOfThreads =
+        GetParallelForRangeNumberOfThreads(this->GetNumberOfThreads(), this->GetOutput()->GetBufferedRegion().GetSize(InputImageDimension - 1));
+    RandomGeneratorType::Pointer generator = RandomGeneratorType::New();
+    generator->SetSeed(m_RunSeed);
+    std::vector<unsigned int> seeds(2 * numberOfThreads);
+    for (unsigned int i = 0; i < seeds.size(); ++i)
+    {
+      seeds[i] = generator->GetIntegerVariate();
+    }
+
+    m_ThreadSamplers.resize(numberOfThreads);
+    m_ThreadOptimizers.resize(numberOfThreads);
+    for (itk::ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId)
+    {
+      m_ThreadSamplers[threadId]   = m_Sampler->CreateCopy(seeds[2 * threadId]);
+      m_ThreadOptimizers[threadId] = m_Optimizer->CreateCopy(seeds[2 * threadId + 1]);
+    }
+  }
+
   while ((m_NumberOfIterations < m_MaximumNumberOfIterations) && (m_ErrorCounter >= maxNumPixelError))
   {
     otbMsgDevMacro(<< "Iteration No." << m_NumberOfIterations);
 
-    this->MinimizeOnce();
+    if (m_CheckerboardUpdate)
+    {
+      this->MinimizeOnceCheckerboard();
+    }
+    else
+    {
+      this->MinimizeOnce();
+    }
 
     otbMsgDevMacro(<< "m_ErrorCounter/m_TotalNumberOfPixelsInInputImage: " << m_ErrorCounter / ((double)(m_TotalNumberOfPixelsInInputImage)));
     otbMsgDevMacro(<< "m_ImageDeltaEnergy: " << m_ImageDeltaEnergy);
@@ -327,6 +434,9 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::ApplyMarkovRandomFi
     ++m_NumberOfIterations;
   }
 
+  m_ThreadSamplers.clear();
+  m_ThreadOptimizers.clear();
+
   otbMsgDevMacro(<< "m_NumberOfIterations: " << m_NumberOfIterations);
   otbMsgDevMacro(<< "m_MaximumNumberOfIterations: " << m_MaximumNumberOfIterations);
   otbMsgDevMacro(<< "m_ErrorCounter: " << m_ErrorCounter);
@@ -371,6 +481,136 @@ void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::MinimizeOnce()
   }
 }
 
+template <class TInputImage, class TClassifiedImage>
+unsigned int MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::GetNumberOfColors() const
+{
+  unsigned int numberOfColors = 1;
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    numberOfColors *= m_LabelledImageNeighborhoodRadius[i] + 1;
+  }
+  return numberOfColors;
+}
+
+template <class TInputImage, class TClassifiedImage>
+typename MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::SizeType MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::GetHaloRadius() const
+{
+  const typename SizeType::SizeValueType reach = static_cast<typename SizeType::SizeValueType>(m_MaximumNumberOfIterations) * this->GetNumberOfColors();
+
+  SizeType haloRadius;
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    haloRadius[i] = reach * m_LabelledImageNeighborhoodRadius[i];
+  }
+  return haloRadius;
+}
+
+/**
+*Apply the MRF image filter on the whole image once, color by color
+*/
+template <class TInputImage, class TClassifiedImage>
+void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::MinimizeOnceCheckerboard()
+{
+  const itk::ThreadIdType numberOfThreads = m_ThreadSamplers.size();
+  m_ThreadErrorCounters.assign(numberOfThreads, 0);
+  m_ThreadDeltaEnergies.assign(numberOfThreads, 0.0);
+
+  // Each thread processes a block of rows of the iterated labels
+  const LabelledImageRegionType region   = this->GetOutput()->GetBufferedRegion();
+  const unsigned int            rowsAxis = InputImageDimension - 1;
+
+  // ParallelForRange() returns once all the threads are done: the labels
+  // written for a color are visible to all the threads for the next one
+  const unsigned int numberOfColors = this->GetNumberOfColors();
+  for (unsigned int color = 0; color < numberOfColors; ++color)
+  {
+    ParallelForRange(this->GetMultiThreader(), numberOfThreads, region.GetSize(rowsAxis),
+                     [this, color, &region, rowsAxis](itk::ThreadIdType threadId, std::size_t begin, std::size_t end) {
+                       LabelledImageRegionType threadRegion = region;
+                       threadRegion.SetIndex(rowsAxis, region.GetIndex(rowsAxis) + static_cast<IndexValueType>(begin));
+                       threadRegion.SetSize(rowsAxis, end - begin);
+                       this->ThreadedMinimizeColor(color, threadId, threadRegion);
+                     });
+  }
+
+  m_ErrorCounter = 0;
+  for (itk::ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId)
+  {
+    m_ErrorCounter += m_ThreadErrorCounters[threadId];
+    m_ImageDeltaEnergy += m_ThreadDeltaEnergies[threadId];
+  }
+}
+
+template <class TInputImage, class TClassifiedImage>
+void MarkovRandomFieldFilter<TInputImage, TClassifiedImage>::ThreadedMinimizeColor(unsigned int color, itk::ThreadIdType threadId,
+                                                                                    const LabelledImageRegionType& threadRegion)
+{
+  // Pixels of the color on the block: they form a lattice with a step of
+  // (radius + 1) along each dimension. The colors are defined from the
+  // origin of the image, so that they match between streaming divisions.
+  const LabelledImageRegionType largestRegion = this->GetOutput()->GetLargestPossibleRegion();
+  LabelledImageIndexType        first;
+  LabelledImageIndexType        last;
+  unsigned int                  colorRemainder = color;
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    const IndexValueType period = m_LabelledImageNeighborhoodRadius[i] + 1;
+    const IndexValueType phase  = colorRemainder % period;
+    colorRemainder /= period;
+
+    const IndexValueType start = threadRegion.GetIndex(i);
+    const IndexValueType shift = (start - largestRegion.GetIndex(i)) % period;
+    first[i]                   = start + (phase - shift + period) % period;
+    last[i]                    = start + static_cast<IndexValueType>(threadRegion.GetSize(i)) - 1;
+    if (first[i] > last[i])
+    {
+      return;
+    }
+  }
+
+  LabelledImageNeighborhoodIterator labelledIterator(m_LabelledImageNeighborhoodRadius, this->GetOutput(), this->GetOutput()->GetBufferedRegion());
+  InputImageNeighborhoodIterator    dataIterator(m_InputImageNeighborhoodRadius, this->GetInput(), this->GetInput()->GetBufferedRegion());
+
+  SamplerType*   sampler     = m_ThreadSamplers[threadId];
+  OptimizerType* optimizer   = m_ThreadOptimizers[threadId];
+  int            errorCount  = 0;
+  double         deltaEnergy = 0.0;
+
+  LabelledImageIndexType index = first;
+  bool                   done  = false;
+  while (!done)
+  {
+    labelledIterator.SetLocation(index);
+    dataIterator.SetLocation(index);
+
+    sampler->Compute(dataIterator, labelledIterator);
+    if (optimizer->Compute(sampler->GetDeltaEnergy()))
+    {
+      labelledIterator.SetCenterPixel(sampler->GetValue());
+      ++errorCount;
+      deltaEnergy += sampler->GetDeltaEnergy();
+    }
+
+    // Next pixel of the lattice, the first dimension varying fastest
+    done = true;
+    for (unsigned int i = 0; i < InputImageDimension && done; ++i)
+    {
+      index[i] += m_LabelledImageNeighborhoodRadius[i] + 1;
+      if (index[i] <= last[i])
+      {
+        done = false;
+      }
+      else
+      {
+        index[i] = first[i];
+      }
+    }
+  }
+
+  m_ThreadErrorCounters[threadId] += errorCount;
+  m_ThreadDeltaEnergies[threadId] += deltaEnergy;
+}
+
 } // namespace otb
 
 #endif
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbImage.h"
+#include "otbMarkovRandomFieldFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "otbMRFEnergyPotts.h"
+#include "otbMRFEnergyGaussianClassification.h"
+#include "otbMRFOptimizerICM.h"
+#include "otbMRFOptimizerMetropolis.h"
+#include "otbMRFSamplerMAP.h"
+#include "otbMRFSamplerRandom.h"
+
+namespace
+{
+typedef otb::Image<double, 2>        InputImageType;
+typedef otb::Image<unsigned char, 2> LabelledImageType;
+
+typedef otb::MarkovRandomFieldFilter<InputImageType, LabelledImageType>         MarkovRandomFieldFilterType;
+typedef otb::MRFEnergyPotts<LabelledImageType, LabelledImageType>               EnergyRegularizationType;
+typedef otb::MRFEnergyGaussianClassification<InputImageType, LabelledImageType> EnergyFidelityType;
+
+std::vector<unsigned char> RunMarkovRandomField(MarkovRandomFieldFilterType* markovFilter, itk::ThreadIdType numberOfThreads)
+{
+  markovFilter->InitializeSeed(2);
+  markovFilter->SetNumberOfThreads(numberOfThreads);
+  markovFilter->Modified();
+  markovFilter->Update();
+
+  std::vector<unsigned char> labels;
+  itk::ImageRegionIteratorWithIndex<LabelledImageType> it(markovFilter->GetOutput(), markovFilter->GetOutput()->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    labels.push_back(it.Get());
+  }
+  return labels;
+}
+}
+
+int otbMarkovRandomFieldFilterCheckerboard(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  const unsigned int nClass      = 4;
+  const double       means[4]    = {10.0, 80.0, 150.0, 220.0};
+  const double       stdDev      = 10.0;
+  const int          quadrant    = 30;
+  const double       noiseOffset = 40.0;
+
+  // Four quadrants of constant classes. Away from the quadrant borders,
+  // isolated pixels are moved closer to the mean of the next class: only the
+  // regularization can restore them.
+  InputImageType::RegionType region;
+  region.SetSize(0, 2 * quadrant);
+  region.SetSize(1, 2 * quadrant);
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  std::vector<unsigned char>                        truth;
+  itk::ImageRegionIteratorWithIndex<InputImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const int          x     = it.GetIndex()[0];
+    const int          y     = it.GetIndex()[1];
+    const unsigned int label = x / quadrant + 2 * (y / quadrant);
+    const bool inner = x % quadrant > 0 && x % quadrant < quadrant - 1 && y % quadrant > 0 && y % quadrant < quadrant - 1;
+    const bool noisy = inner && (x * 7 + y * 13) % 17 == 0;
+    it.Set(means[label] + (noisy ? noiseOffset : 0.0));
+    truth.push_back(label);
+  }
+
+  EnergyRegularizationType::Pointer energyRegularization = EnergyRegularizationType::New();
+  EnergyFidelityType::Pointer       energyFidelity       = EnergyFidelityType::New();
+  energyFidelity->SetNumberOfParameters(2 * nClass);
+  EnergyFidelityType::ParametersType parameters;
+  parameters.SetSize(energyFidelity->GetNumberOfParameters());
+  for (unsigned int c = 0; c < nClass; ++c)
+  {
+    parameters[2 * c]     = means[c];
+    parameters[2 * c + 1] = stdDev;
+  }
+  energyFidelity->SetParameters(parameters);
+
+  MarkovRandomFieldFilterType::Pointer markovFilter = MarkovRandomFieldFilterType::New();
+  markovFilter->SetNumberOfClasses(nClass);
+  markovFilter->SetMaximumNumberOfIterations(5);
+  markovFilter->SetErrorTolerance(0.0);
+  markovFilter->SetLambda(3.0);
+  markovFilter->SetNeighborhoodRadius(1);
+  markovFilter->SetEnergyRegularization(energyRegularization);
+  markovFilter->SetEnergyFidelity(energyFidelity);
+  markovFilter->SetInput(image);
+  markovFilter->CheckerboardUpdateOn();
+
+  // ICM with the MAP sampler is deterministic: the pixels of a color being
+  // independent, the result shall not depend on the number of threads
+  markovFilter->SetOptimizer(otb::MRFOptimizerICM::New());
+  markovFilter->SetSampler(otb::MRFSamplerMAP<InputImageType, LabelledImageType>::New());
+
+  const std::vector<unsigned char> icm1 = RunMarkovRandomField(markovFilter, 1);
+  const std::vector<unsigned char> icm4 = RunMarkovRandomField(markovFilter, 4);
+  if (icm1 != icm4)
+  {
+    std::cerr << "Checkerboard ICM gives different labels with 1 and 4 threads" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (icm4 != truth)
+  {
+    std::cerr << "Checkerboard ICM does not restore the quadrants" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // With random sampler and optimizer, each thread has its own generator
+  // seeded from the filter one: runs with the same seed shall be identical
+  otb::MRFOptimizerMetropolis::Pointer optimizer = otb::MRFOptimizerMetropolis::New();
+  optimizer->SetSingleParameter(1.0);
+  markovFilter->SetOptimizer(optimizer);
+  markovFilter->SetSampler(otb::MRFSamplerRandom<InputImageType, LabelledImageType>::New());
+
+  const std::vector<unsigned char> metropolis1 = RunMarkovRandomField(markovFilter, 4);
+  const std::vector<unsigned char> metropolis2 = RunMarkovRandomField(markovFilter, 4);
+  if (metropolis1 != metropolis2)
+  {
+    std::cerr << "Checkerboard Metropolis is not reproducible with a given seed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // In checkerboard mode, a part of the output is computed from the input
+  // around it only, and equals the same part of the whole image result
+  markovFilter->SetOptimizer(otb::MRFOptimizerICM::New());
+  markovFilter->SetSampler(otb::MRFSamplerMAP<InputImageType, LabelledImageType>::New());
+  markovFilter->InitializeSeed(2);
+  markovFilter->SetNumberOfThreads(4);
+  markovFilter->Modified();
+
+  LabelledImageType::RegionType subRegion;
+  subRegion.SetIndex(0, quadrant - 5);
+  subRegion.SetIndex(1, quadrant - 5);
+  subRegion.SetSize(0, 10);
+  subRegion.SetSize(1, 10);
+  markovFilter->GetOutput()->SetRequestedRegion(subRegion);
+  markovFilter->GetOutput()->Update();
+
+  LabelledImageType::RegionType haloRegion = subRegion;
+  haloRegion.PadByRadius(markovFilter->GetHaloRadius());
+  haloRegion.Crop(region);
+  InputImageType::RegionType inputRegion = haloRegion;
+  inputRegion.PadByRadius(1);
+  inputRegion.Crop(region);
+  if (haloRegion == region || image->GetRequestedRegion() != inputRegion || markovFilter->GetOutput()->GetBufferedRegion() != haloRegion)
+  {
+    std::cerr << "The filter shall request the input around the requested region only" << std::endl;
+    return EXIT_FAILURE;
+  }
+  itk::ImageRegionIteratorWithIndex<LabelledImageType> labelIt(markovFilter->GetOutput(), subRegion);
+  for (labelIt.GoToBegin(); !labelIt.IsAtEnd(); ++labelIt)
+  {
+    const LabelledImageType::IndexType index = labelIt.GetIndex();
+    if (labelIt.Get() != icm4[index[0] + 2 * quadrant * index[1]])
+    {
+      std::cerr << "The labels computed for a part of the output differ at " << index << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
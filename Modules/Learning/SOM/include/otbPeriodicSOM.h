@@ -115,6 +115,15 @@ protected:
   */
   void UpdateMap(const NeuronType& sample, double beta, SizeType& radius) override;
   /**
+  * Accumulate the contribution of a batch sample to the neurons in the
+  * periodic neighborhood of its winner.
+  * \param sample The sample to learn,
+  * \param position The index of the winner neuron,
+  * \param beta The learning coefficient,
+  * \param radius The radius of the neighbourhood.
+  */
+  void AccumulateNeighborhood(const NeuronType& sample, const IndexType& position, double beta, const SizeType& radius) override;
+  /**
   * Step one iteration.
   */
   void Step(unsigned int currentIteration) override
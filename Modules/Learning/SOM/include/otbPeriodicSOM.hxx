@@ -25,6 +25,7 @@
 
 #include "itkNumericTraits.h"
 #include "itkNeighborhoodIterator.h"
+#include "itkNeighborhood.h"
 
 #include "otbPeriodicSOM.h"
 
@@ -97,6 +98,47 @@ void PeriodicSOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoo
   }
 }
 
+/**
+ * Accumulate the contribution of a batch sample to the neurons in the
+ * periodic neighborhood of its winner.
+ * \param sample The sample to learn,
+ * \param position The index of the winner neuron,
+ * \param beta The learning coefficient,
+ * \param radius The radius of the neighbourhood.
+ */
+template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, class TSOMNeighborhoodBehaviorFunctor>
+void PeriodicSOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::AccumulateNeighborhood(const NeuronType& sample,
+                                                                                                                          const IndexType& position,
+                                                                                                                          double beta, const SizeType& radius)
+{
+  MapPointerType map     = this->GetOutput(0);
+  SizeType       mapSize = map->GetLargestPossibleRegion().GetSize();
+  IndexType      positionToUpdate;
+
+  // Same elliptic shape and periodic wrapping as UpdateMap()
+  itk::Neighborhood<char, MapType::ImageDimension> neighborhood;
+  neighborhood.SetRadius(radius);
+
+  for (unsigned int i = 0; i < neighborhood.Size(); ++i)
+  {
+    typename itk::Neighborhood<char, MapType::ImageDimension>::OffsetType offset = neighborhood.GetOffset(i);
+
+    double theDistance = itk::NumericTraits<double>::Zero;
+    for (unsigned int j = 0; j < MapType::ImageDimension; ++j)
+      theDistance += pow(static_cast<double>(offset[j]), 2.0) / pow(static_cast<double>(radius[j]), 2.0);
+
+    if (theDistance <= 1.0)
+    {
+      for (unsigned int j = 0; j < MapType::ImageDimension; ++j)
+      {
+        int pos             = offset[j] + position[j];
+        positionToUpdate[j] = (pos >= 0) ? pos % mapSize[j] : (mapSize[j] - ((-pos) % mapSize[j])) % mapSize[j];
+      }
+      this->AccumulateNeuron(sample, positionToUpdate, beta / (1.0 + theDistance));
+    }
+  }
+}
+
 } // end of namespace otb
 
 #endif
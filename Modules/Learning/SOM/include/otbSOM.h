@@ -24,6 +24,9 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkEuclideanDistanceMetric.h"
+#include "otbParallelForRange.h"
+
+#include <vector>
 
 #include "otbCzihoSOMLearningBehaviorFunctor.h"
 #include "otbCzihoSOMNeighborhoodBehaviorFunctor.h"
@@ -48,6 +51,15 @@ namespace otb
  * The SOMMap produced as output can be either initialized with a constant custom value or randomly
  * generated following a normal law. The seed for the random initialization can be modified.
  *
+ * By default, the map is updated after each sample (on-line training). When a batch size is set
+ * with SetBatchSize(), the samples are processed by mini-batches: the best-response neurons of
+ * all the samples of a batch are searched concurrently (one block of samples per thread) against
+ * the same state of the map, then the contributions of the batch are accumulated for each neuron
+ * and applied at once. A neuron receiving the total weight \f$ H = \sum_s h_s \f$ is moved by
+ * \f$ \sum_s h_s (x_s - w) / \max(1, H) \f$, so that a batch of one sample reproduces the on-line
+ * update. When the map uses the euclidean distance, the best-response search runs on the map
+ * buffer with a squared distance kernel instead of going through the distance metric object.
+ *
  * \sa SOMMap
  * \sa SOMActivationBuilder
  * \sa CzihoSOMLearningBehaviorFunctor
@@ -108,6 +120,9 @@ public:
   itkGetMacro(Seed, unsigned int);
   itkGetObjectMacro(ListSample, ListSampleType);
   itkSetObjectMacro(ListSample, ListSampleType);
+  /** Number of samples per mini-batch. 0 (the default) means on-line training. */
+  itkSetMacro(BatchSize, unsigned int);
+  itkGetMacro(BatchSize, unsigned int);
 
   void SetBetaFunctor(const SOMLearningBehaviorFunctorType& functor)
   {
@@ -141,12 +156,42 @@ protected:
    * Step one iteration.
    */
   virtual void Step(unsigned int currentIteration);
+  /**
+   * Step one iteration by mini-batches of samples.
+   */
+  virtual void BatchStep(double beta, SizeType& radius);
+  /**
+   * Accumulate the contribution of a batch sample to the neurons in the
+   * neighborhood of its winner. Each neuron is given to AccumulateNeuron()
+   * with its learning coefficient.
+   * \param sample The sample to learn,
+   * \param position The index of the winner neuron,
+   * \param beta The learning coefficient,
+   * \param radius The radius of the neighbourhood.
+   */
+  virtual void AccumulateNeighborhood(const NeuronType& sample, const IndexType& position, double beta, const SizeType& radius);
+  /**
+   * Accumulate the contribution of a batch sample to one neuron.
+   * \param sample The sample to learn,
+   * \param neuron The index of the neuron to update,
+   * \param beta The learning coefficient of the neuron for this sample.
+   */
+  virtual void AccumulateNeuron(const NeuronType& sample, const IndexType& neuron, double beta);
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
+  /** Batch accumulators: weighted sum of the moves towards the samples
+   * (components of each neuron, in the map buffer layout), and sum of the
+   * learning coefficients of each neuron */
+  std::vector<double> m_BatchMoves;
+  std::vector<double> m_BatchWeights;
+
 private:
   SOM(const Self&) = delete;
   void operator=(const Self&) = delete;
+
+  /** Search the winners of the samples [begin, end) of the current batch */
+  void FindBatchWinners(std::size_t begin, std::size_t end);
   /** Size of the neurons map */
   SizeType m_MapSize;
   /** Number of iterations */
@@ -171,6 +216,12 @@ private:
   SOMLearningBehaviorFunctorType m_BetaFunctor;
   /** Behavior of the Neighborhood extent */
   SOMNeighborhoodBehaviorFunctorType m_NeighborhoodSizeFunctor;
+  /** Number of samples per mini-batch (0 for on-line training) */
+  unsigned int m_BatchSize;
+  /** Samples of the current batch, packed contiguously */
+  std::vector<ValueType> m_BatchSamples;
+  /** Offset in the map buffer of the winner of each sample of the batch */
+  std::vector<itk::OffsetValueType> m_BatchWinners;
 };
 } // end namespace otb
 
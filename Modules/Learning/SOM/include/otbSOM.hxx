@@ -24,10 +24,17 @@
 
 #include "otbSOM.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkFixedArray.h"
 #include "otbMacro.h"
 #include "itkImageRegionIterator.h"
 #include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "otbSquaredEuclideanDistance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 
 namespace otb
 {
@@ -49,6 +56,7 @@ SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunc
   m_MaxWeight  = static_cast<ValueType>(128.0);
   m_RandomInit = false;
   m_Seed       = 123574651;
+  m_BatchSize  = 0;
 }
 /**
  * Destructor
@@ -130,11 +138,171 @@ void SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehavio
 
   // update the neurons map with each example of the training set.
   otbMsgDebugMacro(<< "Beta: " << newBeta << ", radius: " << newSize);
+  if (m_BatchSize > 0)
+  {
+    BatchStep(newBeta, newSize);
+    return;
+  }
   for (typename ListSampleType::Iterator it = m_ListSample->Begin(); it != m_ListSample->End(); ++it)
   {
     UpdateMap(it.GetMeasurementVector(), newBeta, newSize);
   }
 }
+
+/**
+ * Search the winners of a block of samples of the current batch.
+ */
+template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, class TSOMNeighborhoodBehaviorFunctor>
+void SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::FindBatchWinners(std::size_t begin, std::size_t end)
+{
+  MapType*           map       = this->GetOutput(0);
+  const unsigned int nbComp    = map->GetNumberOfComponentsPerPixel();
+  const ValueType*   neurons   = map->GetBufferPointer();
+  const auto         nbNeurons = static_cast<itk::OffsetValueType>(map->GetBufferedRegion().GetNumberOfPixels());
+
+  // The fast path only applies to the plain euclidean distance: other
+  // metrics (missing values, ...) go through SOMMap::GetWinner()
+  const bool euclidean = std::is_same<typename MapType::DistanceType, itk::Statistics::EuclideanDistanceMetric<NeuronType>>::value;
+
+  for (std::size_t s = begin; s < end; ++s)
+  {
+    ValueType* sample = &m_BatchSamples[s * nbComp];
+    if (euclidean)
+    {
+      // Same tie-breaking as SOMMap::GetWinner(): the last minimum is kept
+      double               minDistance = std::numeric_limits<double>::max();
+      itk::OffsetValueType winner      = 0;
+      for (itk::OffsetValueType n = 0; n < nbNeurons; ++n)
+      {
+        const double distance = SquaredEuclideanDistance(sample, neurons + n * nbComp, nbComp);
+        if (distance <= minDistance)
+        {
+          minDistance = distance;
+          winner      = n;
+        }
+      }
+      m_BatchWinners[s] = winner;
+    }
+    else
+    {
+      NeuronType sampleVector(sample, nbComp, false);
+      m_BatchWinners[s] = map->ComputeOffset(map->GetWinner(sampleVector));
+    }
+  }
+}
+
+/**
+ * Step one iteration by mini-batches of samples.
+ */
+template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, class TSOMNeighborhoodBehaviorFunctor>
+void SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::BatchStep(double beta, SizeType& radius)
+{
+  MapPointerType     map       = this->GetOutput(0);
+  const unsigned int nbComp    = map->GetNumberOfComponentsPerPixel();
+  const auto         nbNeurons = static_cast<std::size_t>(map->GetBufferedRegion().GetNumberOfPixels());
+
+  m_BatchSamples.resize(static_cast<std::size_t>(m_BatchSize) * nbComp);
+  m_BatchWinners.resize(m_BatchSize);
+
+  typename ListSampleType::Iterator it = m_ListSample->Begin();
+  while (it != m_ListSample->End())
+  {
+    // Pack the samples of the batch
+    unsigned int nbSamples = 0;
+    for (; nbSamples < m_BatchSize && it != m_ListSample->End(); ++nbSamples, ++it)
+    {
+      const typename ListSampleType::MeasurementVectorType& sample = it.GetMeasurementVector();
+      for (unsigned int i = 0; i < nbComp; ++i)
+      {
+        m_BatchSamples[nbSamples * nbComp + i] = static_cast<ValueType>(sample[i]);
+      }
+    }
+
+    // Search the winners against the current state of the map
+    ParallelForRange(this->GetMultiThreader(), this->GetNumberOfThreads(), nbSamples,
+                     [this](itk::ThreadIdType, std::size_t begin, std::size_t end) { FindBatchWinners(begin, end); });
+
+    // Accumulate the contributions of the batch
+    m_BatchMoves.assign(nbNeurons * nbComp, 0.0);
+    m_BatchWeights.assign(nbNeurons, 0.0);
+    for (unsigned int s = 0; s < nbSamples; ++s)
+    {
+      NeuronType sample(&m_BatchSamples[s * nbComp], nbComp, false);
+      AccumulateNeighborhood(sample, map->ComputeIndex(m_BatchWinners[s]), beta, radius);
+    }
+
+    // Apply them at once
+    ValueType* neurons = map->GetBufferPointer();
+    for (std::size_t n = 0; n < nbNeurons; ++n)
+    {
+      if (m_BatchWeights[n] > 0.0)
+      {
+        const double norm = 1.0 / std::max(1.0, m_BatchWeights[n]);
+        for (unsigned int i = 0; i < nbComp; ++i)
+        {
+          neurons[n * nbComp + i] += static_cast<ValueType>(m_BatchMoves[n * nbComp + i] * norm);
+        }
+      }
+    }
+  }
+  map->Modified();
+}
+
+/**
+ * Accumulate the contribution of a batch sample to the neighborhood of its winner.
+ */
+template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, class TSOMNeighborhoodBehaviorFunctor>
+void SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::AccumulateNeighborhood(const NeuronType& sample,
+                                                                                                             const IndexType& position, double beta,
+                                                                                                             const SizeType& radius)
+{
+  MapPointerType map = this->GetOutput(0);
+
+  // Same neighborhood as UpdateMap(): square window cropped to the map, and
+  // learning coefficient decreasing with the distance to the winner
+  RegionType localRegion;
+  IndexType  localIndex = position - radius;
+  SizeType   localSize;
+  for (unsigned int i = 0; i < MapType::ImageDimension; ++i)
+  {
+    localSize[i] = 2 * radius[i] + 1;
+  }
+  localRegion.SetIndex(localIndex);
+  localRegion.SetSize(localSize);
+  localRegion.Crop(map->GetLargestPossibleRegion());
+
+  typedef itk::ImageRegionConstIteratorWithIndex<MapType> IteratorType;
+  IteratorType it(map, localRegion);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    double distance = 0.0;
+    for (unsigned int i = 0; i < MapType::ImageDimension; ++i)
+    {
+      const double offset = static_cast<double>(it.GetIndex()[i] - position[i]);
+      distance += offset * offset;
+    }
+    AccumulateNeuron(sample, it.GetIndex(), beta / (1 + std::sqrt(distance)));
+  }
+}
+
+/**
+ * Accumulate the contribution of a batch sample to one neuron.
+ */
+template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, class TSOMNeighborhoodBehaviorFunctor>
+void SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::AccumulateNeuron(const NeuronType& sample, const IndexType& neuron,
+                                                                                                       double beta)
+{
+  MapPointerType     map    = this->GetOutput(0);
+  const unsigned int nbComp = map->GetNumberOfComponentsPerPixel();
+  const auto         offset = static_cast<std::size_t>(map->ComputeOffset(neuron));
+  const ValueType*   weights = map->GetBufferPointer() + offset * nbComp;
+
+  for (unsigned int i = 0; i < nbComp; ++i)
+  {
+    m_BatchMoves[offset * nbComp + i] += beta * (static_cast<double>(sample[i]) - static_cast<double>(weights[i]));
+  }
+  m_BatchWeights[offset] += beta;
+}
 /**
  *  Output information redefinition
  */
@@ -221,6 +389,7 @@ template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, clas
 void SOM<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "BatchSize: " << m_BatchSize << std::endl;
 }
 
 } // end namespace otb
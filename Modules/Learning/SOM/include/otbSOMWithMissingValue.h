@@ -97,6 +97,11 @@ protected:
    * Update the output map with a new sample, depending on the availability of the data
    */
   void UpdateMap(const NeuronType& sample, double beta, SizeType& radius) override;
+  /**
+   * Accumulate the contribution of a batch sample to one neuron, ignoring
+   * its missing components.
+   */
+  void AccumulateNeuron(const NeuronType& sample, const IndexType& neuron, double beta) override;
 
   /** Step one iteration. */
   void Step(unsigned int currentIteration) override
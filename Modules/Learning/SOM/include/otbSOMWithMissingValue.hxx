@@ -104,6 +104,27 @@ void SOMWithMissingValue<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNei
   }
 }
 
+/**
+ * Accumulate the contribution of a batch sample to one neuron. As in
+ * UpdateMap(), missing components of the sample leave the neuron unchanged.
+ */
+template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, class TSOMNeighborhoodBehaviorFunctor>
+void SOMWithMissingValue<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::AccumulateNeuron(const NeuronType& sample,
+                                                                                                                            const IndexType& neuron, double beta)
+{
+  MapPointerType     map     = this->GetOutput(0);
+  const unsigned int nbComp  = map->GetNumberOfComponentsPerPixel();
+  const auto         offset  = static_cast<std::size_t>(map->ComputeOffset(neuron));
+  const ValueType*   weights = map->GetBufferPointer() + offset * nbComp;
+
+  for (unsigned int i = 0; i < nbComp; ++i)
+  {
+    if (!DistanceType::IsMissingValue(sample[i]))
+      this->m_BatchMoves[offset * nbComp + i] += beta * (static_cast<double>(sample[i]) - static_cast<double>(weights[i]));
+  }
+  this->m_BatchWeights[offset] += beta;
+}
+
 template <class TListSample, class TMap, class TSOMLearningBehaviorFunctor, class TSOMNeighborhoodBehaviorFunctor>
 void SOMWithMissingValue<TListSample, TMap, TSOMLearningBehaviorFunctor, TSOMNeighborhoodBehaviorFunctor>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
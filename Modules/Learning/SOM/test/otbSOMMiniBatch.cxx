@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "itkMacro.h"
+#include "otbSOMMap.h"
+#include "otbSOM.h"
+#include "otbPeriodicSOM.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "itkListSample.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace
+{
+const unsigned int Dimension = 2;
+
+typedef double                                              ComponentType;
+typedef itk::VariableLengthVector<ComponentType>            PixelType;
+typedef itk::Statistics::EuclideanDistanceMetric<PixelType> DistanceType;
+typedef otb::SOMMap<PixelType, DistanceType, Dimension> MapType;
+typedef itk::Statistics::ListSample<PixelType> ListSampleType;
+
+struct TrainingParameters
+{
+  MapType::SizeType size;
+  MapType::SizeType radius;
+  unsigned int      nbIterations;
+  double            betaInit;
+  double            betaEnd;
+};
+
+/** Train a map from a null initial map */
+template <class TSOM>
+MapType::Pointer Train(ListSampleType* listSample, TrainingParameters const& parameters, unsigned int batchSize, unsigned int nbThreads)
+{
+  typename TSOM::Pointer som = TSOM::New();
+  som->SetListSample(listSample);
+  som->SetMapSize(parameters.size);
+  som->SetNeighborhoodSizeInit(parameters.radius);
+  som->SetNumberOfIterations(parameters.nbIterations);
+  som->SetBetaInit(parameters.betaInit);
+  som->SetBetaEnd(parameters.betaEnd);
+  som->SetMaxWeight(0);
+  som->SetRandomInit(false);
+  som->SetBatchSize(batchSize);
+  som->SetNumberOfThreads(nbThreads);
+  som->Update();
+  return som->GetOutput();
+}
+
+/** Mean distance between the samples and their winner neuron */
+double QuantizationError(ListSampleType* listSample, MapType* map)
+{
+  DistanceType::Pointer distance = DistanceType::New();
+  double                error    = 0.;
+  for (ListSampleType::Iterator it = listSample->Begin(); it != listSample->End(); ++it)
+  {
+    const PixelType& sample = it.GetMeasurementVector();
+    error += distance->Evaluate(sample, map->GetPixel(map->GetWinner(sample)));
+  }
+  return error / listSample->Size();
+}
+
+/** Mini-batch training shall not depend on the number of threads, and shall
+ * give a map of a quality comparable to on-line training */
+template <class TSOM>
+bool CheckMiniBatch(const char* name, ListSampleType* listSample, TrainingParameters const& parameters, unsigned int batchSize)
+{
+  MapType::Pointer online       = Train<TSOM>(listSample, parameters, 0, 1);
+  MapType::Pointer miniBatch    = Train<TSOM>(listSample, parameters, batchSize, 4);
+  MapType::Pointer miniBatchMT1 = Train<TSOM>(listSample, parameters, batchSize, 1);
+
+  itk::ImageRegionConstIterator<MapType> it(miniBatch, miniBatch->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<MapType> itMT1(miniBatchMT1, miniBatchMT1->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it, ++itMT1)
+  {
+    if (it.Get() != itMT1.Get())
+    {
+      std::cerr << name << ": mini-batch training depends on the number of threads at neuron " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+
+  // The initial map is null: its error is the mean norm of the samples
+  DistanceType::Pointer distance = DistanceType::New();
+  PixelType             zero(listSample->GetMeasurementVectorSize());
+  zero.Fill(0.);
+  double initialError = 0.;
+  for (ListSampleType::Iterator sit = listSample->Begin(); sit != listSample->End(); ++sit)
+  {
+    initialError += distance->Evaluate(sit.GetMeasurementVector(), zero);
+  }
+  initialError /= listSample->Size();
+
+  const double onlineError    = QuantizationError(listSample, online);
+  const double miniBatchError = QuantizationError(listSample, miniBatch);
+  std::cout << name << ": quantization error " << initialError << " initially, " << onlineError << " on-line, " << miniBatchError << " by batches of "
+            << batchSize << std::endl;
+  if (!(miniBatchError < 0.5 * initialError) || !(miniBatchError <= 2. * onlineError))
+  {
+    std::cerr << name << ": the map trained by mini-batches is not fitted to the samples" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int otbSOMMiniBatch(int itkNotUsed(argc), char* argv[])
+{
+  typedef otb::VectorImage<ComponentType, Dimension> ImageType;
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+
+  const char*        inputFileName = argv[1];
+  TrainingParameters parameters;
+  parameters.size[0]      = atoi(argv[2]);
+  parameters.size[1]      = atoi(argv[3]);
+  parameters.radius[0]    = atoi(argv[4]);
+  parameters.radius[1]    = atoi(argv[5]);
+  parameters.nbIterations = atoi(argv[6]);
+  parameters.betaInit     = atof(argv[7]);
+  parameters.betaEnd      = atof(argv[8]);
+  unsigned int batchSize  = atoi(argv[9]);
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFileName);
+  reader->Update();
+
+  ListSampleType::Pointer listSample = ListSampleType::New();
+  listSample->SetMeasurementVectorSize(reader->GetOutput()->GetNumberOfComponentsPerPixel());
+
+  itk::ImageRegionConstIterator<ImageType> it(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    listSample->PushBack(it.Get());
+  }
+
+  bool success = CheckMiniBatch<otb::SOM<ListSampleType, MapType>>("SOM", listSample, parameters, batchSize);
+  success      = CheckMiniBatch<otb::PeriodicSOM<ListSampleType, MapType>>("PeriodicSOM", listSample, parameters, batchSize) && success;
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
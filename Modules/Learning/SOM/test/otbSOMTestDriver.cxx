@@ -23,6 +23,7 @@
 void RegisterTests()
 {
   REGISTER_TEST(otbSOM);
+  REGISTER_TEST(otbSOMMiniBatch);
   REGISTER_TEST(otbSOMImageClassificationFilter);
   REGISTER_TEST(otbSOMActivationBuilder);
   REGISTER_TEST(otbSOMWithMissingValueTest);
@@ -23,6 +23,7 @@
 
 #include "otbPersistentSamplingFilterBase.h"
 #include "otbPersistentFilterStreamingDecorator.h"
+#include "otbSampleDrivenStreamingManager.h"
 #include "otbOGRDataSourceWrapper.h"
 #include "otbImage.h"
 #include <string>
@@ -185,6 +186,9 @@ protected:
   {
   }
 
+  /** Stream only the divisions containing samples */
+  void GenerateData(void) override;
+
 private:
   ImageSampleExtractorFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
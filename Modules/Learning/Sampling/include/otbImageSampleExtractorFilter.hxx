@@ -145,7 +145,8 @@ void PersistentImageSampleExtractorFilter<TInputImage>::GenerateInputRequestedRe
 {
   InputImageType* input     = const_cast<InputImageType*>(this->GetInput());
   RegionType      requested = this->GetOutput()->GetRequestedRegion();
-  input->SetRequestedRegion(requested);
+  // Only read the pixels bounding the samples of this division
+  input->SetRequestedRegion(this->SampledRegion(requested));
 }
 
 
@@ -222,6 +223,38 @@ void PersistentImageSampleExtractorFilter<TInputImage>::InitializeFields()
 
 // -------------- otb::ImageSampleExtractorFilter --------------------------
 
+template <class TInputImage>
+void ImageSampleExtractorFilter<TInputImage>::GenerateData(void)
+{
+  // Reset the filter before the generation.
+  this->GetFilter()->Reset();
+
+  // Pre-pass over the sample positions: only the divisions containing
+  // samples are streamed
+  this->GetFilter()->IndexFeatureRegions();
+
+  typedef SampleDrivenStreamingManager<InputImageType> SampleDrivenStreamingManagerType;
+  typename SampleDrivenStreamingManagerType::Pointer  streamingManager = SampleDrivenStreamingManagerType::New();
+  streamingManager->SetStreamingManager(this->GetStreamer()->GetStreamingManager());
+  streamingManager->SetSampleRegionIndex(&this->GetFilter()->GetFeatureRegionIndex());
+
+  this->GetStreamer()->SetStreamingManager(streamingManager);
+  this->GetStreamer()->SetInput(this->GetFilter()->GetOutput());
+  try
+  {
+    this->GetStreamer()->Update();
+  }
+  catch (...)
+  {
+    this->GetStreamer()->SetStreamingManager(streamingManager->GetStreamingManager());
+    throw;
+  }
+  this->GetStreamer()->SetStreamingManager(streamingManager->GetStreamingManager());
+
+  // Synthetize data after the streaming of the whole image.
+  this->GetFilter()->Synthetize();
+}
+
 template <class TInputImage>
 void ImageSampleExtractorFilter<TInputImage>::SetInput(const TInputImage* image)
 {
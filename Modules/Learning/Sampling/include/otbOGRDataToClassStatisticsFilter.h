@@ -23,6 +23,7 @@
 
 #include "otbPersistentSamplingFilterBase.h"
 #include "otbPersistentFilterStreamingDecorator.h"
+#include "otbSampleDrivenStreamingManager.h"
 #include "itkSimpleDataObjectDecorator.h"
 #include <string>
 
@@ -182,6 +183,9 @@ protected:
   {
   }
 
+  /** Stream only the divisions containing polygons */
+  void GenerateData(void) override;
+
 private:
   OGRDataToClassStatisticsFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
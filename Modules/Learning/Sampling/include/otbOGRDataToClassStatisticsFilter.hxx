@@ -192,6 +192,38 @@ void PersistentOGRDataToClassStatisticsFilter<TInputImage, TMaskImage>::PrepareF
 
 // -------------- otb::OGRDataToClassStatisticsFilter --------------------------
 
+template <class TInputImage, class TMaskImage>
+void OGRDataToClassStatisticsFilter<TInputImage, TMaskImage>::GenerateData(void)
+{
+  // Reset the filter before the generation.
+  this->GetFilter()->Reset();
+
+  // Pre-pass over the polygons: only the divisions intersecting them are
+  // streamed
+  this->GetFilter()->IndexFeatureRegions();
+
+  typedef SampleDrivenStreamingManager<InputImageType> SampleDrivenStreamingManagerType;
+  typename SampleDrivenStreamingManagerType::Pointer  streamingManager = SampleDrivenStreamingManagerType::New();
+  streamingManager->SetStreamingManager(this->GetStreamer()->GetStreamingManager());
+  streamingManager->SetSampleRegionIndex(&this->GetFilter()->GetFeatureRegionIndex());
+
+  this->GetStreamer()->SetStreamingManager(streamingManager);
+  this->GetStreamer()->SetInput(this->GetFilter()->GetOutput());
+  try
+  {
+    this->GetStreamer()->Update();
+  }
+  catch (...)
+  {
+    this->GetStreamer()->SetStreamingManager(streamingManager->GetStreamingManager());
+    throw;
+  }
+  this->GetStreamer()->SetStreamingManager(streamingManager->GetStreamingManager());
+
+  // Synthetize data after the streaming of the whole image.
+  this->GetFilter()->Synthetize();
+}
+
 template <class TInputImage, class TMaskImage>
 void OGRDataToClassStatisticsFilter<TInputImage, TMaskImage>::SetInput(const TInputImage* image)
 {
@@ -23,6 +23,7 @@
 
 #include "otbPersistentImageFilter.h"
 #include "otbOGRDataSourceWrapper.h"
+#include "otbOGRSpatialIndex.h"
 #include "otbImage.h"
 #include <string>
 
@@ -93,6 +94,18 @@ public:
   itkSetMacro(OutLayerName, std::string);
   itkGetMacro(OutLayerName, std::string);
 
+  /** Pre-pass over the input features: compute and index the image regions
+   *  they cover. The index is used to skip the streaming divisions without
+   *  samples (see SampleDrivenStreamingManager). */
+  void IndexFeatureRegions();
+
+  /** Get the index of the feature regions, in pixel coordinates (empty
+   *  until IndexFeatureRegions() is called) */
+  const ogr::SpatialIndex& GetFeatureRegionIndex() const
+  {
+    return m_FeatureRegionIndex;
+  }
+
 protected:
   /** Constructor */
   PersistentSamplingFilterBase();
@@ -143,6 +156,12 @@ protected:
   /** Get the region bounding a set of features */
   RegionType FeatureBoundingRegion(const TInputImage* image, otb::ogr::Layer::const_iterator& featIt) const;
 
+  /** Get the region bounding the feature regions intersecting a given
+   *  region, cropped to this region. The returned region is empty when
+   *  no feature intersects it. When IndexFeatureRegions() has not been
+   *  called, the given region is returned. */
+  RegionType SampledRegion(const RegionType& region) const;
+
   /** Method to split the input OGRDataSource between several containers
    *  for each thread. Default is to put the same number of features for
    *  each thread.*/
@@ -216,6 +235,10 @@ private:
 
   /** In-memory containers storing position during iteration loop*/
   std::vector<std::vector<OGRDataPointer>> m_InMemoryOutputs;
+
+  /** Image regions covered by the input features, and their index */
+  std::vector<RegionType> m_FeatureRegions;
+  ogr::SpatialIndex       m_FeatureRegionIndex;
 };
 } // End namespace otb
 
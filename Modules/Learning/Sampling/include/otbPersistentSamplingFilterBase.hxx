@@ -28,6 +28,7 @@
 #include "otbMacro.h"
 #include "otbStopwatch.h"
 #include "itkProgressReporter.h"
+#include <algorithm>
 
 namespace otb
 {
@@ -141,7 +142,8 @@ void PersistentSamplingFilterBase<TInputImage, TMaskImage>::GenerateInputRequest
 
   if (mask)
   {
-    mask->SetRequestedRegion(requested);
+    // Only read the mask pixels bounding the features of this division
+    mask->SetRequestedRegion(this->SampledRegion(requested));
   }
 }
 
@@ -615,6 +617,85 @@ PersistentSamplingFilterBase<TInputImage, TMaskImage>::FeatureBoundingRegion(con
   return region;
 }
 
+template <class TInputImage, class TMaskImage>
+void PersistentSamplingFilterBase<TInputImage, TMaskImage>::IndexFeatureRegions()
+{
+  TInputImage* inputImage = const_cast<TInputImage*>(this->GetInput());
+  inputImage->UpdateOutputInformation();
+
+  ogr::DataSource* vectors = const_cast<ogr::DataSource*>(this->GetOGRData());
+  ogr::Layer       inLayer = vectors->GetLayer(m_LayerIndex);
+
+  m_FeatureRegions.clear();
+  m_FeatureRegionIndex.Clear();
+
+  otb::Stopwatch             chrono = otb::Stopwatch::StartNew();
+  ogr::Layer::const_iterator featIt = inLayer.begin();
+  for (; featIt != inLayer.end(); ++featIt)
+  {
+    if (!featIt->GetGeometry())
+    {
+      continue;
+    }
+    RegionType region = FeatureBoundingRegion(inputImage, featIt);
+
+    OGREnvelope envelope;
+    envelope.MinX = region.GetIndex(0);
+    envelope.MinY = region.GetIndex(1);
+    envelope.MaxX = region.GetUpperIndex()[0];
+    envelope.MaxY = region.GetUpperIndex()[1];
+    m_FeatureRegionIndex.Insert(envelope, m_FeatureRegions.size());
+    m_FeatureRegions.push_back(region);
+  }
+  m_FeatureRegionIndex.Build();
+
+  chrono.Stop();
+  otbMsgDebugMacro(<< "Indexing " << m_FeatureRegions.size() << " feature regions took " << chrono.GetElapsedMilliseconds() << " ms");
+}
+
+template <class TInputImage, class TMaskImage>
+typename PersistentSamplingFilterBase<TInputImage, TMaskImage>::RegionType
+PersistentSamplingFilterBase<TInputImage, TMaskImage>::SampledRegion(const RegionType& region) const
+{
+  if (!m_FeatureRegionIndex.IsBuilt())
+  {
+    return region;
+  }
+
+  OGREnvelope window;
+  window.MinX = region.GetIndex(0);
+  window.MinY = region.GetIndex(1);
+  window.MaxX = region.GetUpperIndex()[0];
+  window.MaxY = region.GetUpperIndex()[1];
+
+  std::vector<ogr::SpatialIndex::IdType> ids;
+  m_FeatureRegionIndex.Query(window, ids);
+
+  RegionType sampled = region;
+  if (ids.empty())
+  {
+    sampled.SetSize(0, 0);
+    sampled.SetSize(1, 0);
+    return sampled;
+  }
+
+  typename RegionType::IndexType lower = m_FeatureRegions[ids.front()].GetIndex();
+  typename RegionType::IndexType upper = m_FeatureRegions[ids.front()].GetUpperIndex();
+  for (ogr::SpatialIndex::IdType id : ids)
+  {
+    const RegionType& featureRegion = m_FeatureRegions[id];
+    for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+      lower[dim] = std::min(lower[dim], featureRegion.GetIndex(dim));
+      upper[dim] = std::max(upper[dim], featureRegion.GetUpperIndex()[dim]);
+    }
+  }
+  sampled.SetIndex(lower);
+  sampled.SetUpperIndex(upper);
+  sampled.Crop(region);
+  return sampled;
+}
+
 template <class TInputImage, class TMaskImage>
 void PersistentSamplingFilterBase<TInputImage, TMaskImage>::DispatchInputVectors()
 {
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbSampleDrivenStreamingManager_h
+#define otbSampleDrivenStreamingManager_h
+
+#include "otbStreamingManager.h"
+#include "otbOGRSpatialIndex.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class SampleDrivenStreamingManager
+ *  \brief This class restricts the divisions of another streaming manager to
+ *  the ones containing samples.
+ *
+ *  The candidate divisions are computed by the streaming manager set with
+ *  SetStreamingManager(). Only those intersecting at least one of the image
+ *  regions indexed in the sample region index are kept, in the same order.
+ *  The index holds regions in pixel coordinates (see
+ *  PersistentSamplingFilterBase::IndexFeatureRegions()); it is not owned by
+ *  this class and shall outlive the streaming.
+ *
+ *  When sparse samples are spread over a large image, the divisions without
+ *  any sample are never requested, so that their pixels are not read.
+ *
+ * \sa PersistentSamplingFilterBase
+ * \sa StreamingImageVirtualWriter
+ *
+ * \ingroup OTBSampling
+ */
+template <class TImage>
+class ITK_EXPORT SampleDrivenStreamingManager : public StreamingManager<TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SampleDrivenStreamingManager  Self;
+  typedef StreamingManager<TImage>      Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  typedef TImage                          ImageType;
+  typedef typename Superclass::RegionType RegionType;
+
+  /** Creation through object factory macro */
+  itkNewMacro(Self);
+
+  /** Type macro */
+  itkTypeMacro(SampleDrivenStreamingManager, StreamingManager);
+
+  /** Dimension of input image. */
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  /** Streaming manager computing the candidate divisions */
+  itkSetObjectMacro(StreamingManager, Superclass);
+  itkGetObjectMacro(StreamingManager, Superclass);
+
+  /** Index of the image regions covered by the samples. When null, all
+   * the candidate divisions are kept. */
+  void SetSampleRegionIndex(const ogr::SpatialIndex* index);
+
+  const ogr::SpatialIndex* GetSampleRegionIndex() const
+  {
+    return m_SampleRegionIndex;
+  }
+
+  /** Actually computes the stream divisions given a DataObject and its region to write */
+  void PrepareStreaming(itk::DataObject* input, const RegionType& region) override;
+
+  /** Returns the number of divisions containing samples */
+  unsigned int GetNumberOfSplits() override;
+
+  /** Get the ith division containing samples */
+  RegionType GetSplit(unsigned int i) override;
+
+protected:
+  SampleDrivenStreamingManager();
+  ~SampleDrivenStreamingManager() override;
+
+  /** Streaming manager computing the candidate divisions */
+  typename Superclass::Pointer m_StreamingManager;
+
+  /** Index of the image regions covered by the samples (not owned) */
+  const ogr::SpatialIndex* m_SampleRegionIndex;
+
+  /** Divisions containing samples */
+  std::vector<RegionType> m_Splits;
+
+private:
+  SampleDrivenStreamingManager(const SampleDrivenStreamingManager&) = delete;
+  void operator=(const SampleDrivenStreamingManager&) = delete;
+};
+
+} // End namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbSampleDrivenStreamingManager.hxx"
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbSampleDrivenStreamingManager_hxx
+#define otbSampleDrivenStreamingManager_hxx
+
+#include "otbSampleDrivenStreamingManager.h"
+#include "otbMacro.h"
+
+namespace otb
+{
+
+template <class TImage>
+SampleDrivenStreamingManager<TImage>::SampleDrivenStreamingManager() : m_StreamingManager(nullptr), m_SampleRegionIndex(nullptr)
+{
+}
+
+template <class TImage>
+SampleDrivenStreamingManager<TImage>::~SampleDrivenStreamingManager()
+{
+}
+
+template <class TImage>
+void SampleDrivenStreamingManager<TImage>::SetSampleRegionIndex(const ogr::SpatialIndex* index)
+{
+  if (m_SampleRegionIndex != index)
+  {
+    m_SampleRegionIndex = index;
+    this->Modified();
+  }
+}
+
+template <class TImage>
+void SampleDrivenStreamingManager<TImage>::PrepareStreaming(itk::DataObject* input, const RegionType& region)
+{
+  if (m_StreamingManager.IsNull())
+  {
+    itkExceptionMacro(<< "No streaming manager set to compute the candidate divisions");
+  }
+
+  m_StreamingManager->PrepareStreaming(input, region);
+  const unsigned int nbCandidates = m_StreamingManager->GetNumberOfSplits();
+
+  m_Splits.clear();
+  for (unsigned int i = 0; i < nbCandidates; ++i)
+  {
+    RegionType split = m_StreamingManager->GetSplit(i);
+
+    bool hasSamples = true;
+    if (m_SampleRegionIndex)
+    {
+      // Regions are indexed with their first and last pixel indices
+      OGREnvelope window;
+      window.MinX = split.GetIndex(0);
+      window.MinY = split.GetIndex(1);
+      window.MaxX = split.GetIndex(0) + static_cast<double>(split.GetSize(0)) - 1;
+      window.MaxY = split.GetIndex(1) + static_cast<double>(split.GetSize(1)) - 1;
+      hasSamples  = m_SampleRegionIndex->Intersects(window);
+    }
+
+    if (hasSamples)
+    {
+      m_Splits.push_back(split);
+    }
+  }
+
+  otbMsgDevMacro(<< "Kept " << m_Splits.size() << " divisions containing samples out of " << nbCandidates);
+
+  this->m_ComputedNumberOfSplits = m_Splits.size();
+  this->m_Region                 = region;
+}
+
+template <class TImage>
+unsigned int SampleDrivenStreamingManager<TImage>::GetNumberOfSplits()
+{
+  return m_Splits.size();
+}
+
+template <class TImage>
+typename SampleDrivenStreamingManager<TImage>::RegionType SampleDrivenStreamingManager<TImage>::GetSplit(unsigned int i)
+{
+  if (i >= m_Splits.size())
+  {
+    // No division: return an empty region at the origin of the streamed region
+    RegionType empty;
+    empty.SetIndex(this->m_Region.GetIndex());
+    return empty;
+  }
+  return m_Splits[i];
+}
+
+} // End namespace otb
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbSampleTable_h
+#define otbSampleTable_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "otbOGRLayerWrapper.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OTBSamplingExport.h"
+
+namespace otb
+{
+/** Storage types of the columns of a sample table. */
+enum class SampleColumnType : std::uint32_t
+{
+  Int32   = 0,
+  Int64   = 1,
+  Float32 = 2,
+  Float64 = 3
+};
+
+/** Size in bytes of one value of a column. */
+OTBSampling_EXPORT std::size_t GetSampleColumnTypeSize(SampleColumnType type);
+
+/** \class SampleTableWriter
+ *  \brief Writes samples into a columnar binary file.
+ *
+ * A sample table stores, for a set of samples, typed columns of values (the
+ * sample features and the class label for instance). Each column is written
+ * as a contiguous native array, so that a \c SampleTableReader can access it
+ * without any decoding, while OGR formats need one field access per value.
+ *
+ * Rows are accumulated in memory (with \c AppendRow() or \c AppendLayer())
+ * and written at once by \c Write(). The file layout is:
+ *  - a header: magic "OTBSMPL", byte order mark, version, number of rows
+ *    and of columns, then the type and name of each column
+ *  - the columns, one after the other, each starting on an 8 bytes boundary.
+ *
+ * Files use the byte order of the machine that wrote them.
+ *
+ * \sa SampleTableReader
+ *
+ * \ingroup OTBSampling
+ */
+class OTBSampling_EXPORT SampleTableWriter : public itk::Object
+{
+public:
+  /** Standard typedefs */
+  typedef SampleTableWriter             Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(SampleTableWriter, itk::Object);
+
+  /** Add a column, before any row is appended.
+   * \return the index of the new column */
+  std::size_t AddColumn(const std::string& name, SampleColumnType type);
+
+  /** Append a row, with one value per column. Values are cast to the
+   * column types. */
+  void AppendRow(const std::vector<double>& values);
+
+  /** Append the features of an OGR layer, keeping the given fields only.
+   * Columns are created from the field types on the first call: integer
+   * fields give Int32 or Int64 columns, real fields give \c realType columns
+   * and string fields (class names) are converted to Float64. Next calls
+   * shall use fields with the same names. Unset fields are stored as 0.
+   */
+  void AppendLayer(ogr::Layer& layer, const std::vector<std::string>& fieldNames, SampleColumnType realType = SampleColumnType::Float64);
+
+  /** Number of rows appended so far */
+  std::uint64_t GetNumberOfRows() const
+  {
+    return m_NumberOfRows;
+  }
+
+  /** Number of columns */
+  std::size_t GetNumberOfColumns() const
+  {
+    return m_Names.size();
+  }
+
+  /** Write the table to a file */
+  void Write(const std::string& filename) const;
+
+  /** Remove all the columns and rows */
+  void Clear();
+
+protected:
+  /** Constructor */
+  SampleTableWriter();
+
+  /** Destructor */
+  ~SampleTableWriter() override
+  {
+  }
+
+  /**PrintSelf method */
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  SampleTableWriter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Append a value to the raw buffer of a column */
+  void AppendValue(std::size_t column, double value);
+
+  std::vector<std::string>       m_Names;
+  std::vector<SampleColumnType>  m_Types;
+  std::vector<std::vector<char>> m_Columns;
+  std::uint64_t                  m_NumberOfRows;
+};
+
+/** \class SampleTableReader
+ *  \brief Reads a columnar sample file written by \c SampleTableWriter.
+ *
+ * The file is memory-mapped on \c Open(): \c GetColumnData() gives a direct
+ * access to the values of a column, and \c ReadColumn() copies them with a
+ * conversion to the requested type.
+ *
+ * \sa SampleTableWriter
+ *
+ * \ingroup OTBSampling
+ */
+class OTBSampling_EXPORT SampleTableReader : public itk::Object
+{
+public:
+  /** Standard typedefs */
+  typedef SampleTableReader             Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(SampleTableReader, itk::Object);
+
+  /** Check whether a file is a sample table, from its first bytes */
+  static bool CanReadFile(const std::string& filename);
+
+  /** Map a sample table file. Throws if the file is not a valid table. */
+  void Open(const std::string& filename);
+
+  /** Release the mapped file */
+  void Close();
+
+  std::uint64_t GetNumberOfRows() const
+  {
+    return m_NumberOfRows;
+  }
+
+  std::size_t GetNumberOfColumns() const
+  {
+    return m_Names.size();
+  }
+
+  const std::string& GetColumnName(std::size_t column) const
+  {
+    return m_Names[column];
+  }
+
+  SampleColumnType GetColumnType(std::size_t column) const
+  {
+    return m_Types[column];
+  }
+
+  /** Index of a column from its name, -1 if there is no such column */
+  int GetColumnIndex(const std::string& name) const;
+
+  /** Direct access to the values of a column, stored with the column type.
+   * The pointer is valid until the reader is closed. */
+  const void* GetColumnData(std::size_t column) const;
+
+  /** Copy the values of a column, cast to T */
+  template <class T>
+  void ReadColumn(std::size_t column, std::vector<T>& values) const
+  {
+    values.resize(m_NumberOfRows);
+    ReadColumn(column, 0, m_NumberOfRows, values.data());
+  }
+
+  /** Copy count values of a column from the row begin, cast to T, to
+   * values[0], values[stride], values[2 * stride]... This interleaves
+   * columns straight from the mapped file into rows of samples. */
+  template <class T>
+  void ReadColumn(std::size_t column, std::uint64_t begin, std::uint64_t count, T* values, std::size_t stride = 1) const
+  {
+    const void* data = GetColumnData(column);
+    switch (m_Types[column])
+    {
+    case SampleColumnType::Int32:
+      CopyColumn(static_cast<const std::int32_t*>(data) + begin, count, values, stride);
+      break;
+    case SampleColumnType::Int64:
+      CopyColumn(static_cast<const std::int64_t*>(data) + begin, count, values, stride);
+      break;
+    case SampleColumnType::Float32:
+      CopyColumn(static_cast<const float*>(data) + begin, count, values, stride);
+      break;
+    case SampleColumnType::Float64:
+      CopyColumn(static_cast<const double*>(data) + begin, count, values, stride);
+      break;
+    }
+  }
+
+protected:
+  /** Constructor */
+  SampleTableReader();
+
+  /** Destructor */
+  ~SampleTableReader() override;
+
+  /**PrintSelf method */
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  SampleTableReader(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  template <class TSource, class T>
+  static void CopyColumn(const TSource* data, std::uint64_t count, T* values, std::size_t stride)
+  {
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+      values[i * stride] = static_cast<T>(data[i]);
+    }
+  }
+
+  /** Platform dependent file mapping */
+  struct MappedFile;
+
+  std::unique_ptr<MappedFile>   m_File;
+  std::vector<std::string>      m_Names;
+  std::vector<SampleColumnType> m_Types;
+  std::vector<std::uint64_t>    m_Offsets;
+  std::uint64_t                 m_NumberOfRows;
+};
+
+} // End namespace otb
+
+#endif
@@ -0,0 +1,524 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbSampleTable.h"
+#include "otbOGRFeatureWrapper.h"
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace otb
+{
+
+namespace
+{
+const char          SampleTableMagic[8] = {'O', 'T', 'B', 'S', 'M', 'P', 'L', '\0'};
+const std::uint32_t SampleTableByteOrderMark = 0x01020304;
+const std::uint32_t SampleTableVersion       = 1;
+
+/** Size of the fixed part of the header: magic, byte order mark, version,
+ * number of rows and number of columns */
+const std::size_t SampleTableHeaderSize = 8 + 4 + 4 + 8 + 8;
+
+std::uint64_t AlignOffset(std::uint64_t offset)
+{
+  return (offset + 7) & ~static_cast<std::uint64_t>(7);
+}
+
+template <class T>
+void WriteValue(std::ofstream& ofs, T value)
+{
+  ofs.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+T ReadValue(const unsigned char* data)
+{
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+}
+
+std::size_t GetSampleColumnTypeSize(SampleColumnType type)
+{
+  switch (type)
+  {
+  case SampleColumnType::Int32:
+  case SampleColumnType::Float32:
+    return 4;
+  case SampleColumnType::Int64:
+  case SampleColumnType::Float64:
+    return 8;
+  }
+  return 0;
+}
+
+// -------------- otb::SampleTableWriter --------------------------
+
+SampleTableWriter::SampleTableWriter() : m_NumberOfRows(0)
+{
+}
+
+std::size_t SampleTableWriter::AddColumn(const std::string& name, SampleColumnType type)
+{
+  if (m_NumberOfRows > 0)
+  {
+    itkExceptionMacro(<< "Can't add column " << name << " once rows have been appended");
+  }
+  m_Names.push_back(name);
+  m_Types.push_back(type);
+  m_Columns.emplace_back();
+  return m_Names.size() - 1;
+}
+
+void SampleTableWriter::AppendValue(std::size_t column, double value)
+{
+  std::vector<char>& buffer = m_Columns[column];
+  const std::size_t  offset = buffer.size();
+  buffer.resize(offset + GetSampleColumnTypeSize(m_Types[column]));
+  char* dest = buffer.data() + offset;
+  switch (m_Types[column])
+  {
+  case SampleColumnType::Int32:
+  {
+    const std::int32_t v = static_cast<std::int32_t>(value);
+    std::memcpy(dest, &v, sizeof(v));
+    break;
+  }
+  case SampleColumnType::Int64:
+  {
+    const std::int64_t v = static_cast<std::int64_t>(value);
+    std::memcpy(dest, &v, sizeof(v));
+    break;
+  }
+  case SampleColumnType::Float32:
+  {
+    const float v = static_cast<float>(value);
+    std::memcpy(dest, &v, sizeof(v));
+    break;
+  }
+  case SampleColumnType::Float64:
+    std::memcpy(dest, &value, sizeof(value));
+    break;
+  }
+}
+
+void SampleTableWriter::AppendRow(const std::vector<double>& values)
+{
+  if (values.size() != m_Names.size())
+  {
+    itkExceptionMacro(<< "Expecting " << m_Names.size() << " values per row, got " << values.size());
+  }
+  for (std::size_t c = 0; c < values.size(); ++c)
+  {
+    AppendValue(c, values[c]);
+  }
+  ++m_NumberOfRows;
+}
+
+void SampleTableWriter::AppendLayer(ogr::Layer& layer, const std::vector<std::string>& fieldNames, SampleColumnType realType)
+{
+  OGRFeatureDefn&  layerDefn = *layer.ogr().GetLayerDefn();
+  std::vector<int> fieldIndex(fieldNames.size(), -1);
+  for (std::size_t i = 0; i < fieldNames.size(); ++i)
+  {
+    fieldIndex[i] = layerDefn.GetFieldIndex(fieldNames[i].c_str());
+    if (fieldIndex[i] < 0)
+    {
+      itkExceptionMacro(<< "Field " << fieldNames[i] << " not found in layer " << layer.GetName());
+    }
+  }
+
+  if (m_Names.empty())
+  {
+    for (std::size_t i = 0; i < fieldNames.size(); ++i)
+    {
+      switch (layerDefn.GetFieldDefn(fieldIndex[i])->GetType())
+      {
+      case OFTInteger:
+        AddColumn(fieldNames[i], SampleColumnType::Int32);
+        break;
+      case OFTInteger64:
+        AddColumn(fieldNames[i], SampleColumnType::Int64);
+        break;
+      case OFTReal:
+        AddColumn(fieldNames[i], realType);
+        break;
+      case OFTString:
+        AddColumn(fieldNames[i], SampleColumnType::Float64);
+        break;
+      default:
+        itkExceptionMacro(<< "Unsupported type for field " << fieldNames[i]);
+      }
+    }
+  }
+  else if (fieldNames != m_Names)
+  {
+    itkExceptionMacro(<< "The fields of layer " << layer.GetName() << " don't match the columns of the table");
+  }
+
+  // Each row is parsed and checked before any of its values is appended, so
+  // that a field in error leaves all the columns with the same length.
+  // 64 bits integers don't go through a double to keep them exact.
+  std::vector<double>       values(fieldIndex.size());
+  std::vector<std::int64_t> integers(fieldIndex.size());
+  std::vector<bool>         isInteger(fieldIndex.size());
+
+  layer.ogr().ResetReading();
+  ogr::Feature feature = layer.ogr().GetNextFeature();
+  bool         goesOn  = feature.addr() != 0;
+  while (goesOn)
+  {
+    OGRFeature& ogrFeature = feature.ogr();
+    for (std::size_t i = 0; i < fieldIndex.size(); ++i)
+    {
+      values[i]    = 0.;
+      isInteger[i] = false;
+      if (!ogrFeature.IsFieldSet(fieldIndex[i]))
+      {
+        continue;
+      }
+      if (ogrFeature.GetFieldDefnRef(fieldIndex[i])->GetType() == OFTString)
+      {
+        const std::string svalue = ogrFeature.GetFieldAsString(fieldIndex[i]);
+        try
+        {
+          values[i] = std::stod(svalue);
+        }
+        catch (std::exception&)
+        {
+          layer.ogr().ResetReading();
+          itkExceptionMacro(<< "Field " << fieldNames[i] << " of feature " << feature.GetFID() << " of layer " << layer.GetName() << " is not a number: '"
+                            << svalue << "'");
+        }
+      }
+      else if (m_Types[i] == SampleColumnType::Int64)
+      {
+        integers[i]  = ogrFeature.GetFieldAsInteger64(fieldIndex[i]);
+        isInteger[i] = true;
+      }
+      else
+      {
+        values[i] = ogrFeature.GetFieldAsDouble(fieldIndex[i]);
+      }
+    }
+
+    for (std::size_t i = 0; i < fieldIndex.size(); ++i)
+    {
+      if (isInteger[i])
+      {
+        const std::int64_t& v      = integers[i];
+        std::vector<char>&  buffer = m_Columns[i];
+        buffer.insert(buffer.end(), reinterpret_cast<const char*>(&v), reinterpret_cast<const char*>(&v) + sizeof(v));
+      }
+      else
+      {
+        AppendValue(i, values[i]);
+      }
+    }
+    ++m_NumberOfRows;
+
+    feature = layer.ogr().GetNextFeature();
+    goesOn  = feature.addr() != 0;
+  }
+  layer.ogr().ResetReading();
+}
+
+void SampleTableWriter::Write(const std::string& filename) const
+{
+  std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+  if (!ofs)
+  {
+    itkExceptionMacro(<< "Can't open file " << filename << " for writing");
+  }
+
+  ofs.write(SampleTableMagic, sizeof(SampleTableMagic));
+  WriteValue(ofs, SampleTableByteOrderMark);
+  WriteValue(ofs, SampleTableVersion);
+  WriteValue(ofs, m_NumberOfRows);
+  WriteValue(ofs, static_cast<std::uint64_t>(m_Names.size()));
+
+  std::uint64_t offset = SampleTableHeaderSize;
+  for (std::size_t c = 0; c < m_Names.size(); ++c)
+  {
+    WriteValue(ofs, static_cast<std::uint32_t>(m_Types[c]));
+    WriteValue(ofs, static_cast<std::uint32_t>(m_Names[c].size()));
+    ofs.write(m_Names[c].data(), m_Names[c].size());
+    offset += 4 + 4 + m_Names[c].size();
+  }
+
+  const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  for (std::size_t c = 0; c < m_Columns.size(); ++c)
+  {
+    ofs.write(padding, AlignOffset(offset) - offset);
+    offset = AlignOffset(offset);
+    ofs.write(m_Columns[c].data(), m_Columns[c].size());
+    offset += m_Columns[c].size();
+  }
+
+  if (!ofs)
+  {
+    itkExceptionMacro(<< "Failed to write sample table " << filename);
+  }
+}
+
+void SampleTableWriter::Clear()
+{
+  m_Names.clear();
+  m_Types.clear();
+  m_Columns.clear();
+  m_NumberOfRows = 0;
+}
+
+void SampleTableWriter::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Number of rows: " << m_NumberOfRows << std::endl;
+  os << indent << "Columns:";
+  for (const auto& name : m_Names)
+  {
+    os << " " << name;
+  }
+  os << std::endl;
+}
+
+// -------------- otb::SampleTableReader --------------------------
+
+struct SampleTableReader::MappedFile
+{
+  const unsigned char* data = nullptr;
+  std::uint64_t        size = 0;
+#if defined(_WIN32)
+  HANDLE file    = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#endif
+
+  /** Map a whole file in read-only mode, returns false on failure */
+  bool Open(const std::string& filename)
+  {
+#if defined(_WIN32)
+    file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+      return false;
+    }
+    size    = static_cast<std::uint64_t>(fileSize.QuadPart);
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+      return false;
+    }
+    data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    return data != nullptr;
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0)
+    {
+      close(fd);
+      return false;
+    }
+    size         = static_cast<std::uint64_t>(status.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid once the descriptor is closed
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+      return false;
+    }
+    data = static_cast<const unsigned char*>(mapped);
+    return true;
+#endif
+  }
+
+  ~MappedFile()
+  {
+#if defined(_WIN32)
+    if (data)
+    {
+      UnmapViewOfFile(data);
+    }
+    if (mapping)
+    {
+      CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE)
+    {
+      CloseHandle(file);
+    }
+#else
+    if (data)
+    {
+      munmap(const_cast<unsigned char*>(data), size);
+    }
+#endif
+  }
+};
+
+SampleTableReader::SampleTableReader() : m_NumberOfRows(0)
+{
+}
+
+SampleTableReader::~SampleTableReader()
+{
+}
+
+bool SampleTableReader::CanReadFile(const std::string& filename)
+{
+  std::ifstream ifs(filename, std::ios::binary);
+  char          magic[sizeof(SampleTableMagic)];
+  if (!ifs.read(magic, sizeof(magic)))
+  {
+    return false;
+  }
+  return std::memcmp(magic, SampleTableMagic, sizeof(magic)) == 0;
+}
+
+void SampleTableReader::Open(const std::string& filename)
+{
+  Close();
+
+  std::unique_ptr<MappedFile> file(new MappedFile);
+  if (!file->Open(filename))
+  {
+    itkExceptionMacro(<< "Can't map sample table " << filename);
+  }
+
+  const unsigned char* data = file->data;
+  if (file->size < SampleTableHeaderSize || std::memcmp(data, SampleTableMagic, sizeof(SampleTableMagic)) != 0)
+  {
+    itkExceptionMacro(<< filename << " is not a sample table");
+  }
+  if (ReadValue<std::uint32_t>(data + 8) != SampleTableByteOrderMark)
+  {
+    itkExceptionMacro(<< "Sample table " << filename << " has been written with a different byte order");
+  }
+  if (ReadValue<std::uint32_t>(data + 12) != SampleTableVersion)
+  {
+    itkExceptionMacro(<< "Unsupported version of sample table " << filename);
+  }
+  const std::uint64_t nbRows    = ReadValue<std::uint64_t>(data + 16);
+  const std::uint64_t nbColumns = ReadValue<std::uint64_t>(data + 24);
+
+  std::vector<std::string>      names;
+  std::vector<SampleColumnType> types;
+  std::uint64_t                 offset = SampleTableHeaderSize;
+  for (std::uint64_t c = 0; c < nbColumns; ++c)
+  {
+    if (offset + 8 > file->size)
+    {
+      itkExceptionMacro(<< "Truncated sample table " << filename);
+    }
+    const std::uint32_t type       = ReadValue<std::uint32_t>(data + offset);
+    const std::uint32_t nameLength = ReadValue<std::uint32_t>(data + offset + 4);
+    offset += 8;
+    if (type > static_cast<std::uint32_t>(SampleColumnType::Float64) || offset + nameLength > file->size)
+    {
+      itkExceptionMacro(<< "Corrupted sample table " << filename);
+    }
+    types.push_back(static_cast<SampleColumnType>(type));
+    names.emplace_back(reinterpret_cast<const char*>(data + offset), nameLength);
+    offset += nameLength;
+  }
+
+  std::vector<std::uint64_t> offsets;
+  for (std::uint64_t c = 0; c < nbColumns; ++c)
+  {
+    offset = AlignOffset(offset);
+    offsets.push_back(offset);
+    offset += nbRows * GetSampleColumnTypeSize(types[c]);
+  }
+  if (offset > file->size)
+  {
+    itkExceptionMacro(<< "Truncated sample table " << filename);
+  }
+
+  m_File.swap(file);
+  m_Names.swap(names);
+  m_Types.swap(types);
+  m_Offsets.swap(offsets);
+  m_NumberOfRows = nbRows;
+}
+
+void SampleTableReader::Close()
+{
+  m_File.reset();
+  m_Names.clear();
+  m_Types.clear();
+  m_Offsets.clear();
+  m_NumberOfRows = 0;
+}
+
+int SampleTableReader::GetColumnIndex(const std::string& name) const
+{
+  for (std::size_t c = 0; c < m_Names.size(); ++c)
+  {
+    if (m_Names[c] == name)
+    {
+      return static_cast<int>(c);
+    }
+  }
+  return -1;
+}
+
+const void* SampleTableReader::GetColumnData(std::size_t column) const
+{
+  assert(m_File && column < m_Offsets.size());
+  return m_File->data + m_Offsets[column];
+}
+
+void SampleTableReader::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Number of rows: " << m_NumberOfRows << std::endl;
+  os << indent << "Columns:";
+  for (const auto& name : m_Names)
+  {
+    os << " " << name;
+  }
+  os << std::endl;
+}
+
+} // End namespace otb
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "otbSampleDrivenStreamingManager.h"
+#include "otbNumberOfDivisionsTiledStreamingManager.h"
+#include "otbImage.h"
+
+
+int otbSampleDrivenStreamingManager(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::Image<float, 2>                                      ImageType;
+  typedef otb::NumberOfDivisionsTiledStreamingManager<ImageType>    TiledManagerType;
+  typedef otb::SampleDrivenStreamingManager<ImageType>              SampleManagerType;
+  typedef ImageType::RegionType                                     RegionType;
+
+  ImageType::Pointer image = ImageType::New();
+  RegionType         largest;
+  largest.SetSize(0, 1000);
+  largest.SetSize(1, 1000);
+  image->SetRegions(largest);
+
+  // Two sample areas in opposite corners, first and last pixel indices
+  otb::ogr::SpatialIndex index;
+  OGREnvelope            corner;
+  corner.MinX = 10;
+  corner.MinY = 10;
+  corner.MaxX = 20;
+  corner.MaxY = 20;
+  index.Insert(corner, 0);
+  corner.MinX = 990;
+  corner.MinY = 995;
+  corner.MaxX = 999;
+  corner.MaxY = 999;
+  index.Insert(corner, 1);
+  index.Build();
+
+  TiledManagerType::Pointer tiledManager = TiledManagerType::New();
+  tiledManager->SetNumberOfDivisions(16);
+
+  SampleManagerType::Pointer sampleManager = SampleManagerType::New();
+  sampleManager->SetStreamingManager(tiledManager);
+  sampleManager->SetSampleRegionIndex(&index);
+  sampleManager->PrepareStreaming(image, largest);
+
+  std::cout << "Candidate divisions: " << tiledManager->GetNumberOfSplits() << std::endl;
+  std::cout << "Divisions with samples: " << sampleManager->GetNumberOfSplits() << std::endl;
+
+  if (sampleManager->GetNumberOfSplits() != 2)
+  {
+    std::cout << "Expecting 2 divisions containing samples" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ImageType::IndexType first, last;
+  first.Fill(15);
+  last[0] = 995;
+  last[1] = 997;
+  if (!sampleManager->GetSplit(0).IsInside(first) || !sampleManager->GetSplit(1).IsInside(last))
+  {
+    std::cout << "Divisions do not contain the samples: " << sampleManager->GetSplit(0) << sampleManager->GetSplit(1) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Without samples, no division is streamed
+  otb::ogr::SpatialIndex emptyIndex;
+  emptyIndex.Build();
+  sampleManager->SetSampleRegionIndex(&emptyIndex);
+  sampleManager->PrepareStreaming(image, largest);
+  if (sampleManager->GetNumberOfSplits() != 0 || sampleManager->GetSplit(0).GetNumberOfPixels() != 0)
+  {
+    std::cout << "Expecting no division without samples" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "otbSampleTable.h"
+#include "otbOGRDataSourceWrapper.h"
+
+
+int otbSampleTable(int itkNotUsed(argc), char* argv[])
+{
+  const std::string filename(argv[1]);
+  const unsigned int nbRows = 1000;
+
+  otb::SampleTableWriter::Pointer writer = otb::SampleTableWriter::New();
+  writer->AddColumn("class", otb::SampleColumnType::Int32);
+  writer->AddColumn("value_0", otb::SampleColumnType::Float32);
+  writer->AddColumn("value_1", otb::SampleColumnType::Float64);
+  for (unsigned int i = 0; i < nbRows; ++i)
+  {
+    writer->AppendRow({static_cast<double>(i % 7), 0.5 * i, -0.25 * i});
+  }
+  writer->Write(filename);
+
+  if (!otb::SampleTableReader::CanReadFile(filename))
+  {
+    std::cout << "The written file is not recognized as a sample table" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  otb::SampleTableReader::Pointer reader = otb::SampleTableReader::New();
+  reader->Open(filename);
+  if (reader->GetNumberOfRows() != nbRows || reader->GetNumberOfColumns() != 3)
+  {
+    std::cout << "Wrong table size: " << reader->GetNumberOfRows() << " x " << reader->GetNumberOfColumns() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (reader->GetColumnIndex("value_1") != 2 || reader->GetColumnIndex("value_2") != -1)
+  {
+    std::cout << "Wrong column indices" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (reader->GetColumnType(0) != otb::SampleColumnType::Int32 || reader->GetColumnType(1) != otb::SampleColumnType::Float32)
+  {
+    std::cout << "Wrong column types" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<int>    labels;
+  std::vector<double> values;
+  reader->ReadColumn(0, labels);
+  reader->ReadColumn(2, values);
+  const float* directValues = static_cast<const float*>(reader->GetColumnData(1));
+  for (unsigned int i = 0; i < nbRows; ++i)
+  {
+    if (labels[i] != static_cast<int>(i % 7) || directValues[i] != 0.5f * i || values[i] != -0.25 * i)
+    {
+      std::cout << "Wrong values at row " << i << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Interleave a range of rows of two columns, as the samples are read
+  const unsigned int  begin = 3;
+  const unsigned int  count = nbRows - 5;
+  std::vector<double> rows(2 * count);
+  reader->ReadColumn(1, begin, count, &rows[0], 2);
+  reader->ReadColumn(2, begin, count, &rows[1], 2);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (rows[2 * i] != 0.5 * (begin + i) || rows[2 * i + 1] != -0.25 * (begin + i))
+    {
+      std::cout << "Wrong interleaved values at row " << begin + i << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A string field that doesn't hold a number must be reported, not crash
+  otb::ogr::DataSource::Pointer ds    = otb::ogr::DataSource::New();
+  otb::ogr::Layer               layer = ds->CreateLayer("samples");
+  OGRFieldDefn                  fieldDefn("value", OFTString);
+  OGRFieldDefn                  countDefn("count", OFTInteger64);
+  layer.CreateField(otb::ogr::FieldDefn(countDefn));
+  layer.CreateField(otb::ogr::FieldDefn(fieldDefn));
+  const char* const fieldValues[] = {"1.5", "not a number"};
+  for (const char* fieldValue : fieldValues)
+  {
+    otb::ogr::Feature feature(layer.GetLayerDefn());
+    feature.ogr().SetField(0, static_cast<GIntBig>(1) << 40);
+    feature.ogr().SetField(1, fieldValue);
+    layer.CreateFeature(feature);
+  }
+
+  otb::SampleTableWriter::Pointer layerWriter = otb::SampleTableWriter::New();
+  try
+  {
+    layerWriter->AppendLayer(layer, {"count", "value"});
+    std::cout << "A non numeric string field was accepted" << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (itk::ExceptionObject& err)
+  {
+    std::cout << "Expected error: " << err.GetDescription() << std::endl;
+  }
+
+  // The row in error must not be partially appended: the table still holds
+  // the first row only, in every column
+  reader = nullptr;
+  layerWriter->Write(filename);
+  reader = otb::SampleTableReader::New();
+  reader->Open(filename);
+  std::vector<std::int64_t> counts;
+  std::vector<double>       parsed;
+  reader->ReadColumn(0, counts);
+  reader->ReadColumn(1, parsed);
+  if (reader->GetNumberOfRows() != 1 || counts.size() != 1 || counts[0] != (static_cast<std::int64_t>(1) << 40) || parsed[0] != 1.5)
+  {
+    std::cout << "The table is inconsistent after a row in error" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
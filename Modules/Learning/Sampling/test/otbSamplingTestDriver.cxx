@@ -29,4 +29,6 @@ void RegisterTests()
   REGISTER_TEST(otbImageSampleExtractorFilter);
   REGISTER_TEST(otbImageSampleExtractorFilterUpdate);
   REGISTER_TEST(otbSamplingRateCalculatorList);
+  REGISTER_TEST(otbSampleDrivenStreamingManager);
+  REGISTER_TEST(otbSampleTable);
 }
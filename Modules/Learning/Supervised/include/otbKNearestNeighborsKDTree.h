@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbKNearestNeighborsKDTree_h
+#define otbKNearestNeighborsKDTree_h
+
+#include "otbOpenCVUtils.h"
+#include <utility>
+#include <vector>
+
+namespace otb
+{
+
+/** \class KNearestNeighborsKDTree
+ * \brief KD-tree index of a training set for K nearest neighbors search
+ *
+ * The tree splits the samples at the median of their dimension of largest
+ * spread, down to leaves of at most LeafSize samples. The samples are stored
+ * in the order of the leaves, so that a leaf is a contiguous block of memory.
+ *
+ * Search() is exact by default. When a maximum number of leaf checks is
+ * given, the search stops after visiting that many leaves (nearest ones
+ * first), which trades recall for speed.
+ *
+ * The index is saved with Write() next to the samples of the OpenCV model,
+ * and restored with Read() from the same samples.
+ *
+ * \sa KNearestNeighborsMachineLearningModel
+ *
+ * \ingroup OTBSupervised
+ */
+class OTBSupervised_EXPORT KNearestNeighborsKDTree
+{
+public:
+  /** A neighbor found by Search(): squared euclidean distance to the query
+   * and position of the sample in the training set */
+  struct Neighbor
+  {
+    float        Distance;
+    unsigned int Index;
+
+    bool operator<(const Neighbor& other) const
+    {
+      return Distance < other.Distance;
+    }
+  };
+
+  /** Working memory of Search(), to be reused between the queries of a
+   * thread */
+  struct SearchBuffer
+  {
+    std::vector<Neighbor>                      Neighbors;
+    std::vector<std::pair<float, unsigned int>> Stack;
+  };
+
+  explicit KNearestNeighborsKDTree(unsigned int leafSize = 16);
+
+  /** Build the index of samples (one sample per row, CV_32F) and of their
+   * responses */
+  void Build(const cv::Mat& samples, const cv::Mat& responses);
+
+  void Clear();
+
+  bool IsEmpty() const
+  {
+    return m_Nodes.empty();
+  }
+
+  unsigned int GetDimension() const
+  {
+    return m_Dimension;
+  }
+
+  unsigned int GetNumberOfSamples() const
+  {
+    return static_cast<unsigned int>(m_Indices.size());
+  }
+
+  /** Response of the sample at the given position of the training set */
+  float GetResponse(unsigned int index) const
+  {
+    return m_Responses[index];
+  }
+
+  /** Search the k nearest samples of query (GetDimension() values). On
+   * return, buffer.Neighbors holds min(k, GetNumberOfSamples()) neighbors
+   * sorted by increasing distance. The search is exact if maxLeafChecks is
+   * 0. */
+  void Search(const float* query, unsigned int k, unsigned int maxLeafChecks, SearchBuffer& buffer) const;
+
+  /** Write the tree (not the samples) in the current node of fs */
+  void Write(cv::FileStorage& fs) const;
+
+  /** Read the tree written by Write() in node, for the given samples and
+   * responses, which shall be the ones given to Build() */
+  void Read(const cv::FileNode& node, const cv::Mat& samples, const cv::Mat& responses);
+
+private:
+  /** Internal nodes have their left child right after them, leaves have a
+   * negative SplitDimension and cover the samples [Begin, End) */
+  struct Node
+  {
+    int          SplitDimension;
+    float        SplitValue;
+    unsigned int Begin;
+    unsigned int End;
+    unsigned int Right;
+  };
+
+  /** Build the subtree of the samples [begin, end) of m_Indices */
+  void BuildNode(const cv::Mat& samples, unsigned int begin, unsigned int end);
+
+  /** Copy the samples in the order of m_Indices, and the responses */
+  void StoreSamples(const cv::Mat& samples, const cv::Mat& responses);
+
+  unsigned int m_LeafSize;
+  unsigned int m_Dimension;
+
+  /** Position in the training set of the samples, in the order of the leaves */
+  std::vector<unsigned int> m_Indices;
+  /** Samples in the order of the leaves, responses in the training set order */
+  std::vector<float> m_Samples;
+  std::vector<float> m_Responses;
+  std::vector<Node>  m_Nodes;
+};
+
+} // end namespace otb
+
+#endif
@@ -28,6 +28,7 @@
 #include "otbMachineLearningModel.h"
 
 #include "otbOpenCVUtils.h"
+#include "otbKNearestNeighborsKDTree.h"
 
 namespace otb
 {
@@ -41,14 +42,17 @@ public:
   typedef itk::SmartPointer<Self>       Pointer;
   typedef itk::SmartPointer<const Self> ConstPointer;
 
-  typedef typename Superclass::InputValueType       InputValueType;
-  typedef typename Superclass::InputSampleType      InputSampleType;
-  typedef typename Superclass::InputListSampleType  InputListSampleType;
-  typedef typename Superclass::TargetValueType      TargetValueType;
-  typedef typename Superclass::TargetSampleType     TargetSampleType;
-  typedef typename Superclass::TargetListSampleType TargetListSampleType;
-  typedef typename Superclass::ConfidenceValueType  ConfidenceValueType;
-  typedef typename Superclass::ProbaSampleType      ProbaSampleType;
+  typedef typename Superclass::InputValueType           InputValueType;
+  typedef typename Superclass::InputSampleType          InputSampleType;
+  typedef typename Superclass::InputListSampleType      InputListSampleType;
+  typedef typename Superclass::TargetValueType          TargetValueType;
+  typedef typename Superclass::TargetSampleType         TargetSampleType;
+  typedef typename Superclass::TargetListSampleType     TargetListSampleType;
+  typedef typename Superclass::ConfidenceValueType      ConfidenceValueType;
+  typedef typename Superclass::ProbaSampleType          ProbaSampleType;
+  typedef typename Superclass::ConfidenceSampleType     ConfidenceSampleType;
+  typedef typename Superclass::ConfidenceListSampleType ConfidenceListSampleType;
+  typedef typename Superclass::ProbaListSampleType      ProbaListSampleType;
   /** Run-time type information (and related methods). */
   itkNewMacro(Self);
   itkTypeMacro(KNearestNeighborsMachineLearningModel, MachineLearningModel);
@@ -78,6 +82,33 @@ public:
   itkGetMacro(DecisionRule, int);
   itkSetMacro(DecisionRule, int);
 
+  /** Neighbors search algorithm :
+   *   - KNN_BRUTE_FORCE : exhaustive search of OpenCV
+   *   - KNN_KD_TREE : search in a KD-tree built at training time and saved
+   *     in the model file
+   */
+  enum
+  {
+    KNN_BRUTE_FORCE,
+    KNN_KD_TREE
+  };
+
+  /** Setters/Getters to the search algorithm
+   *  Default is KNN_BRUTE_FORCE */
+  itkGetMacro(Algorithm, int);
+  itkSetMacro(Algorithm, int);
+
+  /** Setters/Getters to the maximum number of leaves visited by the KD-tree
+   *  search. The search is exact if 0 (default), approximate otherwise. */
+  itkGetMacro(MaxLeafChecks, unsigned int);
+  itkSetMacro(MaxLeafChecks, unsigned int);
+
+  /** KD-tree built by Train() or Load() in KNN_KD_TREE mode */
+  const KNearestNeighborsKDTree& GetKDTree() const
+  {
+    return m_KDTree;
+  }
+
   /** Train the machine learning model */
   void Train() override;
 
@@ -106,6 +137,10 @@ protected:
   /** Predict values using the model */
   TargetSampleType DoPredict(const InputSampleType& input, ConfidenceValueType* quality = nullptr, ProbaSampleType* proba = nullptr) const override;
 
+  /** Predict a range of samples, reusing the KD-tree search buffers */
+  void DoPredictBatch(const InputListSampleType* input, const unsigned int& startIndex, const unsigned int& size, TargetListSampleType* target,
+                      ConfidenceListSampleType* quality = nullptr, ProbaListSampleType* proba = nullptr) const override;
+
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
@@ -118,6 +153,16 @@ private:
   int m_K;
 
   int m_DecisionRule;
+
+  /** Apply the decision rule to the neighbors of query found in the KD-tree.
+   * responses is a working buffer. */
+  float PredictWithKDTree(const float* query, KNearestNeighborsKDTree::SearchBuffer& buffer, std::vector<float>& responses, ConfidenceValueType* quality) const;
+
+  int m_Algorithm;
+
+  unsigned int m_MaxLeafChecks;
+
+  KNearestNeighborsKDTree m_KDTree;
 };
 } // end namespace otb
 
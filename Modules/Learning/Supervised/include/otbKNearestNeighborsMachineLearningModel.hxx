@@ -25,6 +25,7 @@
 #include "otbKNearestNeighborsMachineLearningModel.h"
 #include "otbOpenCVUtils.h"
 
+#include <algorithm>
 #include <fstream>
 #include <set>
 #include "itkMacro.h"
@@ -37,7 +38,9 @@ KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::KNearestNeighb
   :
     m_KNearestModel(cv::ml::KNearest::create()),
     m_K(32),
-    m_DecisionRule(KNN_VOTING)
+    m_DecisionRule(KNN_VOTING),
+    m_Algorithm(KNN_BRUTE_FORCE),
+    m_MaxLeafChecks(0)
 {
   this->m_ConfidenceIndex       = true;
   this->m_IsRegressionSupported = true;
@@ -76,8 +79,71 @@ void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::Train()
   m_KNearestModel->setIsClassifier(!this->m_RegressionMode);
   // setEmax() ?
   m_KNearestModel->train(cv::ml::TrainData::create(samples, cv::ml::ROW_SAMPLE, labels));
+
+  // The OpenCV model keeps the samples saved in the model file, the KD-tree
+  // only indexes them
+  if (m_Algorithm == KNN_KD_TREE)
+  {
+    m_KDTree.Build(samples, labels);
+  }
+  else
+  {
+    m_KDTree.Clear();
+  }
 }
 
+template <class TInputValue, class TTargetValue>
+float KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::PredictWithKDTree(const float* query, KNearestNeighborsKDTree::SearchBuffer& buffer,
+                                                                                         std::vector<float>& responses, ConfidenceValueType* quality) const
+{
+  m_KDTree.Search(query, static_cast<unsigned int>(std::max(m_K, 1)), m_MaxLeafChecks, buffer);
+  responses.clear();
+  for (const auto& neighbor : buffer.Neighbors)
+  {
+    responses.push_back(m_KDTree.GetResponse(neighbor.Index));
+  }
+
+  // Same decision rules as OpenCV : on ties, VOTING outputs the lowest value
+  float result = 0.f;
+  if (m_DecisionRule == KNN_VOTING)
+  {
+    std::sort(responses.begin(), responses.end());
+    std::size_t bestCount = 0;
+    for (std::size_t begin = 0, end = 0; begin < responses.size(); begin = end)
+    {
+      for (end = begin + 1; end < responses.size() && responses[end] == responses[begin]; ++end)
+      {
+      }
+      if (end - begin > bestCount)
+      {
+        bestCount = end - begin;
+        result    = responses[begin];
+      }
+    }
+  }
+  else if (m_DecisionRule == KNN_MEDIAN)
+  {
+    std::sort(responses.begin(), responses.end());
+    result = responses[responses.size() >> 1];
+  }
+  else
+  {
+    double sum = 0.;
+    for (float response : responses)
+    {
+      sum += response;
+    }
+    result = static_cast<float>(sum / responses.size());
+  }
+
+  if (quality != nullptr)
+  {
+    (*quality) = static_cast<ConfidenceValueType>(std::count(responses.begin(), responses.end(), result));
+  }
+  return result;
+}
+
+
 template <class TInputValue, class TTargetValue>
 typename KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::TargetSampleType
 KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredict(const InputSampleType& input, ConfidenceValueType* quality,
@@ -85,6 +151,26 @@ KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredict(cons
 {
   TargetSampleType target;
 
+  if (m_Algorithm == KNN_KD_TREE)
+  {
+    if (m_KDTree.IsEmpty() || input.Size() != m_KDTree.GetDimension())
+    {
+      itkExceptionMacro(<< "The KD-tree is not built for samples of size " << input.Size());
+    }
+    if (proba != nullptr && !this->m_ProbaIndex)
+      itkExceptionMacro("Probability per class not available for this classifier !");
+
+    std::vector<float> query(input.Size());
+    for (unsigned int i = 0; i < input.Size(); ++i)
+    {
+      query[i] = static_cast<float>(input[i]);
+    }
+    KNearestNeighborsKDTree::SearchBuffer buffer;
+    std::vector<float>                    responses;
+    target[0] = static_cast<TTargetValue>(PredictWithKDTree(query.data(), buffer, responses, quality));
+    return target;
+  }
+
   // convert listsample to Mat
   cv::Mat sample;
   otb::SampleToMat<InputSampleType>(input, sample);
@@ -133,6 +219,71 @@ KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredict(cons
   return target;
 }
 
+template <class TInputValue, class TTargetValue>
+void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredictBatch(const InputListSampleType* input, const unsigned int& startIndex,
+                                                                                      const unsigned int& size, TargetListSampleType* targets,
+                                                                                      ConfidenceListSampleType* quality, ProbaListSampleType* proba) const
+{
+  assert(input != nullptr);
+  assert(targets != nullptr);
+
+  assert(input->Size() == targets->Size() && "Input sample list and target label list do not have the same size.");
+  assert(((quality == nullptr) || (quality->Size() == input->Size())) &&
+         "Quality samples list is not null and does not have the same size as input samples list");
+  assert(((proba == nullptr) || (input->Size() == proba->Size())) && "Proba sample list and target label list do not have the same size.");
+
+  if (startIndex + size > input->Size())
+  {
+    itkExceptionMacro(<< "requested range [" << startIndex << ", " << startIndex + size << "[ partially outside input sample list range.[0," << input->Size()
+                      << "[");
+  }
+  if (proba != nullptr && !this->m_ProbaIndex)
+    itkExceptionMacro("Probability per class not available for this classifier !");
+
+  if (m_Algorithm != KNN_KD_TREE)
+  {
+    for (unsigned int id = startIndex; id < startIndex + size; ++id)
+    {
+      ConfidenceValueType    confidence = 0;
+      const TargetSampleType target     = this->DoPredict(input->GetMeasurementVector(id), quality != nullptr ? &confidence : nullptr);
+      if (quality != nullptr)
+      {
+        quality->SetMeasurementVector(id, confidence);
+      }
+      targets->SetMeasurementVector(id, target);
+    }
+    return;
+  }
+
+  const unsigned int dimension = m_KDTree.GetDimension();
+  if (m_KDTree.IsEmpty() || input->GetMeasurementVectorSize() != dimension)
+  {
+    itkExceptionMacro(<< "The KD-tree is not built for samples of size " << input->GetMeasurementVectorSize());
+  }
+
+  // The buffers are shared by all the samples of the range
+  KNearestNeighborsKDTree::SearchBuffer buffer;
+  std::vector<float>                    responses;
+  std::vector<float>                    query(dimension);
+  for (unsigned int id = startIndex; id < startIndex + size; ++id)
+  {
+    const InputSampleType& sample = input->GetMeasurementVector(id);
+    for (unsigned int i = 0; i < dimension; ++i)
+    {
+      query[i] = static_cast<float>(sample[i]);
+    }
+
+    ConfidenceValueType confidence = 0;
+    TargetSampleType    target;
+    target[0] = static_cast<TTargetValue>(PredictWithKDTree(query.data(), buffer, responses, quality != nullptr ? &confidence : nullptr));
+    if (quality != nullptr)
+    {
+      quality->SetMeasurementVector(id, confidence);
+    }
+    targets->SetMeasurementVector(id, target);
+  }
+}
+
 template <class TInputValue, class TTargetValue>
 void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::Save(const std::string& filename, const std::string& name)
 {
@@ -140,6 +291,12 @@ void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::Save(cons
   fs << (name.empty() ? m_KNearestModel->getDefaultName() : cv::String(name)) << "{";
   m_KNearestModel->write(fs);
   fs << "DecisionRule" << m_DecisionRule;
+  fs << "Algorithm" << m_Algorithm;
+  fs << "MaxLeafChecks" << static_cast<int>(m_MaxLeafChecks);
+  if (m_Algorithm == KNN_KD_TREE)
+  {
+    m_KDTree.Write(fs);
+  }
   fs << "}";
   fs.release();
 }
@@ -171,6 +328,23 @@ void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::Load(cons
     m_KNearestModel->read(fs.getFirstTopLevelNode());
     m_DecisionRule = (int)(fs.getFirstTopLevelNode()["DecisionRule"]);
     m_K = m_KNearestModel->getDefaultK();
+
+    // Models saved before the KD-tree backend use the brute force search
+    const cv::FileNode root = fs.getFirstTopLevelNode();
+    m_Algorithm             = root["Algorithm"].empty() ? KNN_BRUTE_FORCE : (int)(root["Algorithm"]);
+    m_MaxLeafChecks         = root["MaxLeafChecks"].empty() ? 0 : static_cast<unsigned int>((int)(root["MaxLeafChecks"]));
+    if (m_Algorithm == KNN_KD_TREE)
+    {
+      cv::Mat samples;
+      cv::Mat responses;
+      root["samples"] >> samples;
+      root["responses"] >> responses;
+      m_KDTree.Read(root, samples, responses);
+    }
+    else
+    {
+      m_KDTree.Clear();
+    }
     return;
   }
   ifs.open(filename);
@@ -278,6 +452,8 @@ void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::PrintSelf
 {
   // Call superclass implementation
   Superclass::PrintSelf(os, indent);
+  os << indent << "Algorithm: " << m_Algorithm << std::endl;
+  os << indent << "MaxLeafChecks: " << m_MaxLeafChecks << std::endl;
 }
 
 } // end namespace otb
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbKNearestNeighborsKDTree.h"
+#include "otbSquaredEuclideanDistance.h"
+#include "itkMacro.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace otb
+{
+
+KNearestNeighborsKDTree::KNearestNeighborsKDTree(unsigned int leafSize) : m_LeafSize(std::max(leafSize, 1u)), m_Dimension(0)
+{
+}
+
+void KNearestNeighborsKDTree::Clear()
+{
+  m_Dimension = 0;
+  m_Indices.clear();
+  m_Samples.clear();
+  m_Responses.clear();
+  m_Nodes.clear();
+}
+
+void KNearestNeighborsKDTree::Build(const cv::Mat& samples, const cv::Mat& responses)
+{
+  Clear();
+  cv::Mat floatSamples;
+  samples.convertTo(floatSamples, CV_32F);
+  if (floatSamples.rows == 0)
+  {
+    return;
+  }
+
+  m_Dimension = floatSamples.cols;
+  m_Indices.resize(floatSamples.rows);
+  std::iota(m_Indices.begin(), m_Indices.end(), 0);
+  BuildNode(floatSamples, 0, floatSamples.rows);
+  StoreSamples(floatSamples, responses);
+}
+
+void KNearestNeighborsKDTree::BuildNode(const cv::Mat& samples, unsigned int begin, unsigned int end)
+{
+  const unsigned int nodeId = static_cast<unsigned int>(m_Nodes.size());
+  Node               leaf   = {-1, 0.f, begin, end, 0};
+  m_Nodes.push_back(leaf);
+  if (end - begin <= m_LeafSize)
+  {
+    return;
+  }
+
+  // Split along the dimension of largest spread
+  int   splitDimension = -1;
+  float maxSpread      = 0.f;
+  for (unsigned int d = 0; d < m_Dimension; ++d)
+  {
+    float minimum = samples.at<float>(m_Indices[begin], d);
+    float maximum = minimum;
+    for (unsigned int i = begin + 1; i < end; ++i)
+    {
+      const float value = samples.at<float>(m_Indices[i], d);
+      minimum           = std::min(minimum, value);
+      maximum           = std::max(maximum, value);
+    }
+    if (maximum - minimum > maxSpread)
+    {
+      maxSpread      = maximum - minimum;
+      splitDimension = d;
+    }
+  }
+  if (splitDimension < 0)
+  {
+    // All the samples are identical
+    return;
+  }
+
+  // Samples on the left are lower or equal to the split value, samples on
+  // the right greater or equal
+  const unsigned int middle = begin + (end - begin) / 2;
+  std::nth_element(m_Indices.begin() + begin, m_Indices.begin() + middle, m_Indices.begin() + end,
+                   [&samples, splitDimension](unsigned int a, unsigned int b) { return samples.at<float>(a, splitDimension) < samples.at<float>(b, splitDimension); });
+  m_Nodes[nodeId].SplitDimension = splitDimension;
+  m_Nodes[nodeId].SplitValue     = samples.at<float>(m_Indices[middle], splitDimension);
+
+  BuildNode(samples, begin, middle);
+  m_Nodes[nodeId].Right = static_cast<unsigned int>(m_Nodes.size());
+  BuildNode(samples, middle, end);
+}
+
+void KNearestNeighborsKDTree::StoreSamples(const cv::Mat& samples, const cv::Mat& responses)
+{
+  m_Samples.resize(m_Indices.size() * m_Dimension);
+  for (unsigned int pos = 0; pos < m_Indices.size(); ++pos)
+  {
+    const float* row = samples.ptr<float>(m_Indices[pos]);
+    std::copy(row, row + m_Dimension, m_Samples.begin() + pos * m_Dimension);
+  }
+
+  cv::Mat floatResponses;
+  responses.convertTo(floatResponses, CV_32F);
+  floatResponses = floatResponses.reshape(1, static_cast<int>(floatResponses.total()));
+  if (floatResponses.rows != static_cast<int>(m_Indices.size()))
+  {
+    itkGenericExceptionMacro(<< "The number of responses (" << floatResponses.rows << ") does not match the number of samples (" << m_Indices.size() << ")");
+  }
+  m_Responses.resize(m_Indices.size());
+  for (unsigned int i = 0; i < m_Responses.size(); ++i)
+  {
+    m_Responses[i] = floatResponses.at<float>(i, 0);
+  }
+}
+
+void KNearestNeighborsKDTree::Search(const float* query, unsigned int k, unsigned int maxLeafChecks, SearchBuffer& buffer) const
+{
+  std::vector<Neighbor>&                       neighbors = buffer.Neighbors;
+  std::vector<std::pair<float, unsigned int>>& stack     = buffer.Stack;
+  neighbors.clear();
+  stack.clear();
+
+  const unsigned int nbNeighbors = std::min(k, GetNumberOfSamples());
+  if (nbNeighbors == 0 || m_Nodes.empty())
+  {
+    return;
+  }
+
+  // Depth-first traversal, nearest child first. The stack holds the far
+  // children with a lower bound of their distance to the query.
+  unsigned int leafChecks = 0;
+  stack.emplace_back(0.f, 0u);
+  while (!stack.empty())
+  {
+    const float  bound  = stack.back().first;
+    unsigned int nodeId = stack.back().second;
+    stack.pop_back();
+    if (neighbors.size() == nbNeighbors && bound >= neighbors.front().Distance)
+    {
+      continue;
+    }
+
+    while (m_Nodes[nodeId].SplitDimension >= 0)
+    {
+      const Node& node     = m_Nodes[nodeId];
+      const float diff     = query[node.SplitDimension] - node.SplitValue;
+      const float farBound = std::max(bound, diff * diff);
+      if (diff < 0.f)
+      {
+        stack.emplace_back(farBound, node.Right);
+        nodeId = nodeId + 1;
+      }
+      else
+      {
+        stack.emplace_back(farBound, nodeId + 1);
+        nodeId = node.Right;
+      }
+    }
+
+    // neighbors is a max-heap on the distance while searching
+    const Node& leaf = m_Nodes[nodeId];
+    for (unsigned int pos = leaf.Begin; pos < leaf.End; ++pos)
+    {
+      const Neighbor candidate = {SquaredEuclideanDistance<float>(query, &m_Samples[pos * m_Dimension], m_Dimension), m_Indices[pos]};
+      if (neighbors.size() < nbNeighbors)
+      {
+        neighbors.push_back(candidate);
+        std::push_heap(neighbors.begin(), neighbors.end());
+      }
+      else if (candidate.Distance < neighbors.front().Distance)
+      {
+        std::pop_heap(neighbors.begin(), neighbors.end());
+        neighbors.back() = candidate;
+        std::push_heap(neighbors.begin(), neighbors.end());
+      }
+    }
+
+    ++leafChecks;
+    if (maxLeafChecks > 0 && leafChecks >= maxLeafChecks && neighbors.size() == nbNeighbors)
+    {
+      break;
+    }
+  }
+  std::sort_heap(neighbors.begin(), neighbors.end());
+}
+
+void KNearestNeighborsKDTree::Write(cv::FileStorage& fs) const
+{
+  cv::Mat indices(static_cast<int>(m_Indices.size()), 1, CV_32S);
+  for (unsigned int i = 0; i < m_Indices.size(); ++i)
+  {
+    indices.at<int>(i, 0) = static_cast<int>(m_Indices[i]);
+  }
+  cv::Mat nodes(static_cast<int>(m_Nodes.size()), 4, CV_32S);
+  cv::Mat splits(static_cast<int>(m_Nodes.size()), 1, CV_32F);
+  for (unsigned int n = 0; n < m_Nodes.size(); ++n)
+  {
+    nodes.at<int>(n, 0)    = m_Nodes[n].SplitDimension;
+    nodes.at<int>(n, 1)    = static_cast<int>(m_Nodes[n].Begin);
+    nodes.at<int>(n, 2)    = static_cast<int>(m_Nodes[n].End);
+    nodes.at<int>(n, 3)    = static_cast<int>(m_Nodes[n].Right);
+    splits.at<float>(n, 0) = m_Nodes[n].SplitValue;
+  }
+  fs << "KDTreeLeafSize" << static_cast<int>(m_LeafSize);
+  fs << "KDTreeIndices" << indices;
+  fs << "KDTreeNodes" << nodes;
+  fs << "KDTreeSplits" << splits;
+}
+
+void KNearestNeighborsKDTree::Read(const cv::FileNode& node, const cv::Mat& samples, const cv::Mat& responses)
+{
+  Clear();
+  cv::Mat indices;
+  cv::Mat nodes;
+  cv::Mat splits;
+  node["KDTreeIndices"] >> indices;
+  node["KDTreeNodes"] >> nodes;
+  node["KDTreeSplits"] >> splits;
+  if (nodes.empty() || nodes.cols != 4 || nodes.type() != CV_32S || splits.rows != nodes.rows || splits.type() != CV_32F || indices.rows != samples.rows ||
+      indices.type() != CV_32S)
+  {
+    itkGenericExceptionMacro(<< "Invalid KD-tree in the model file");
+  }
+
+  cv::Mat floatSamples;
+  samples.convertTo(floatSamples, CV_32F);
+  m_LeafSize  = std::max(static_cast<int>(node["KDTreeLeafSize"]), 1);
+  m_Dimension = floatSamples.cols;
+
+  // The indices must be a permutation of the samples
+  const unsigned int nbSamples = static_cast<unsigned int>(samples.rows);
+  std::vector<bool>  used(nbSamples, false);
+  m_Indices.resize(nbSamples);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+  {
+    const int index = indices.at<int>(i, 0);
+    if (index < 0 || static_cast<unsigned int>(index) >= nbSamples || used[index])
+    {
+      Clear();
+      itkGenericExceptionMacro(<< "Invalid KD-tree in the model file: sample index " << index << " at position " << i);
+    }
+    used[index]  = true;
+    m_Indices[i] = static_cast<unsigned int>(index);
+  }
+
+  // Children are stored after their parent, the left one right after it, so
+  // that a search always ends in a leaf
+  const unsigned int nbNodes = static_cast<unsigned int>(nodes.rows);
+  m_Nodes.resize(nbNodes);
+  for (unsigned int n = 0; n < nbNodes; ++n)
+  {
+    const int splitDimension = nodes.at<int>(n, 0);
+    const int begin          = nodes.at<int>(n, 1);
+    const int end            = nodes.at<int>(n, 2);
+    const int right          = nodes.at<int>(n, 3);
+
+    const bool validRange = begin >= 0 && begin <= end && static_cast<unsigned int>(end) <= nbSamples;
+    const bool validSplit = splitDimension == -1 || (splitDimension >= 0 && static_cast<unsigned int>(splitDimension) < m_Dimension && n + 1 < nbNodes &&
+                                                     right > static_cast<int>(n) + 1 && static_cast<unsigned int>(right) < nbNodes);
+    if (!validRange || !validSplit)
+    {
+      Clear();
+      itkGenericExceptionMacro(<< "Invalid KD-tree in the model file: node " << n << " (" << splitDimension << ", " << begin << ", " << end << ", " << right
+                               << ") with " << nbSamples << " samples and " << nbNodes << " nodes");
+    }
+    m_Nodes[n].SplitDimension = splitDimension;
+    m_Nodes[n].Begin          = static_cast<unsigned int>(begin);
+    m_Nodes[n].End            = static_cast<unsigned int>(end);
+    m_Nodes[n].Right          = static_cast<unsigned int>(right);
+    m_Nodes[n].SplitValue     = splits.at<float>(n, 0);
+  }
+  StoreSamples(floatSamples, responses);
+}
+
+} // end namespace otb
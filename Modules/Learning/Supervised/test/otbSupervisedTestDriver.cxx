@@ -53,6 +53,7 @@ void RegisterTests()
   // training tests
   REGISTER_TEST(otbSVMMachineLearningModel);
   REGISTER_TEST(otbKNearestNeighborsMachineLearningModel);
+  REGISTER_TEST(otbKNearestNeighborsKDTreeMachineLearningModel);
   REGISTER_TEST(otbRandomForestsMachineLearningModel);
   REGISTER_TEST(otbBoostMachineLearningModel);
   REGISTER_TEST(otbANNMachineLearningModel);
@@ -214,6 +214,181 @@ int otbKNearestNeighborsMachineLearningModel(int argc, char* argv[])
   return otbGenericMachineLearningModel<KNearestNeighborsType>(argc, argv);
 }
 
+/** Fraction of the neighbors found by the KD-tree that are among the k
+ * nearest ones (ties included), measured against an exhaustive search */
+double ComputeKDTreeRecall(const otb::KNearestNeighborsKDTree& tree, InputListSampleType* samples, unsigned int k, unsigned int maxLeafChecks)
+{
+  const unsigned int                         dimension = tree.GetDimension();
+  otb::KNearestNeighborsKDTree::SearchBuffer buffer;
+  std::vector<float>                         query(dimension);
+  std::vector<float>                         distances(samples->Size());
+  unsigned long                              found = 0;
+  unsigned long                              total = 0;
+  for (unsigned int q = 0; q < samples->Size(); ++q)
+  {
+    const InputSampleType& sample = samples->GetMeasurementVector(q);
+    std::copy(sample.GetDataPointer(), sample.GetDataPointer() + dimension, query.begin());
+    for (unsigned int i = 0; i < samples->Size(); ++i)
+    {
+      const InputSampleType& other    = samples->GetMeasurementVector(i);
+      float                  distance = 0.f;
+      for (unsigned int d = 0; d < dimension; ++d)
+      {
+        distance += (query[d] - other[d]) * (query[d] - other[d]);
+      }
+      distances[i] = distance;
+    }
+    std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+    const float kthDistance = distances[k - 1];
+
+    tree.Search(query.data(), k, maxLeafChecks, buffer);
+    for (const auto& neighbor : buffer.Neighbors)
+    {
+      found += (neighbor.Distance <= kthDistance * (1.f + 1e-6f)) ? 1 : 0;
+    }
+    total += k;
+  }
+  return static_cast<double>(found) / total;
+}
+
+int otbKNearestNeighborsKDTreeMachineLearningModel(int argc, char* argv[])
+{
+  if (argc != 3)
+  {
+    std::cout << "Wrong number of arguments " << std::endl;
+    std::cout << "Usage : sample file, output file " << std::endl;
+    return EXIT_FAILURE;
+  }
+  InputListSampleType::Pointer  samples = InputListSampleType::New();
+  TargetListSampleType::Pointer labels  = TargetListSampleType::New();
+  if (!otb::ReadDataFile(argv[1], samples, labels))
+  {
+    std::cout << "Failed to read samples file " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  using TimeT = std::chrono::milliseconds;
+  const int k = 32;
+
+  // Reference : brute force search
+  KNearestNeighborsType::Pointer bruteForce = KNearestNeighborsType::New();
+  bruteForce->SetInputListSample(samples);
+  bruteForce->SetTargetListSample(labels);
+  bruteForce->SetK(k);
+  bruteForce->Train();
+  auto                          start     = std::chrono::system_clock::now();
+  TargetListSampleType::Pointer reference = bruteForce->PredictBatch(samples, nullptr);
+  otbLogMacro(Info, << "Brute force: " << std::chrono::duration_cast<TimeT>(std::chrono::system_clock::now() - start).count() << " ms");
+  const float kappaReference = GetConfusionMatrixResults(reference, labels);
+
+  // Exact and approximate KD-tree searches
+  KNearestNeighborsType::Pointer kdTree = KNearestNeighborsType::New();
+  kdTree->SetInputListSample(samples);
+  kdTree->SetTargetListSample(labels);
+  kdTree->SetK(k);
+  kdTree->SetAlgorithm(KNearestNeighborsType::KNN_KD_TREE);
+  kdTree->Train();
+  kdTree->Save(argv[2]);
+
+  const double exactRecall = ComputeKDTreeRecall(kdTree->GetKDTree(), samples, k, 0);
+  if (exactRecall != 1.)
+  {
+    std::cout << "Exact KD-tree search has a recall of " << exactRecall << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  TargetListSampleType::Pointer predicted;
+  for (unsigned int maxLeafChecks : {0u, 16u, 4u})
+  {
+    kdTree->SetMaxLeafChecks(maxLeafChecks);
+    start     = std::chrono::system_clock::now();
+    predicted = kdTree->PredictBatch(samples, nullptr);
+    otbLogMacro(Info, << "KD-tree, " << maxLeafChecks << " max leaf checks: "
+                      << std::chrono::duration_cast<TimeT>(std::chrono::system_clock::now() - start).count() << " ms, recall "
+                      << ComputeKDTreeRecall(kdTree->GetKDTree(), samples, k, maxLeafChecks));
+    const float kappa = GetConfusionMatrixResults(predicted, labels);
+    // Ties in the distances may select different neighbors than OpenCV
+    if (maxLeafChecks == 0 && std::abs(kappa - kappaReference) > 0.01)
+    {
+      std::cout << "Exact KD-tree search kappa " << kappa << " differs from brute force kappa " << kappaReference << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The loaded model shall use the saved tree
+  kdTree->SetMaxLeafChecks(0);
+  predicted                                 = kdTree->PredictBatch(samples, nullptr);
+  KNearestNeighborsType::Pointer kdTreeLoad = KNearestNeighborsType::New();
+  kdTreeLoad->Load(argv[2]);
+  if (kdTreeLoad->GetAlgorithm() != KNearestNeighborsType::KNN_KD_TREE || kdTreeLoad->GetKDTree().GetNumberOfSamples() != samples->Size())
+  {
+    std::cout << "The KD-tree was not restored from " << argv[2] << std::endl;
+    return EXIT_FAILURE;
+  }
+  TargetListSampleType::Pointer predictedLoad = kdTreeLoad->PredictBatch(samples, nullptr);
+  for (unsigned int i = 0; i < samples->Size(); ++i)
+  {
+    if (predictedLoad->GetMeasurementVector(i)[0] != predicted->GetMeasurementVector(i)[0])
+    {
+      std::cout << "Loaded model predicts " << predictedLoad->GetMeasurementVector(i)[0] << " instead of " << predicted->GetMeasurementVector(i)[0]
+                << " for sample " << i << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A tree that doesn't match its samples must be rejected when read. The
+  // first case is the valid tree {split, leaf, leaf} of two samples, the
+  // others corrupt one node value, or the indices for node -1.
+  struct Corruption
+  {
+    int Node;
+    int Column;
+    int Value;
+  };
+  const Corruption corruptions[] = {{-2, 0, 0}, {1, 2, 3}, {2, 1, -1}, {0, 3, 1}, {0, 3, 3}, {0, 0, 1}, {-1, 0, 0}};
+  const cv::Mat    treeSamples   = (cv::Mat_<float>(2, 1) << 0.f, 1.f);
+  const cv::Mat    treeResponses = (cv::Mat_<float>(2, 1) << 0.f, 1.f);
+  for (const Corruption& corruption : corruptions)
+  {
+    cv::Mat indices = (cv::Mat_<int>(2, 1) << 0, 1);
+    cv::Mat nodes   = (cv::Mat_<int>(3, 4) << 0, 0, 2, 2, -1, 0, 1, 0, -1, 1, 2, 0);
+    cv::Mat splits  = (cv::Mat_<float>(3, 1) << 0.5f, 0.f, 0.f);
+    if (corruption.Node == -1)
+    {
+      indices.at<int>(1, 0) = 0;
+    }
+    else if (corruption.Node >= 0)
+    {
+      nodes.at<int>(corruption.Node, corruption.Column) = corruption.Value;
+    }
+
+    cv::FileStorage treeWriter(".yml", cv::FileStorage::WRITE | cv::FileStorage::MEMORY);
+    treeWriter << "tree"
+               << "{"
+               << "KDTreeLeafSize" << 1 << "KDTreeIndices" << indices << "KDTreeNodes" << nodes << "KDTreeSplits" << splits << "}";
+    cv::FileStorage treeReader(treeWriter.releaseAndGetString(), cv::FileStorage::READ | cv::FileStorage::MEMORY);
+
+    otb::KNearestNeighborsKDTree tree;
+    bool                         rejected = false;
+    try
+    {
+      tree.Read(treeReader["tree"], treeSamples, treeResponses);
+    }
+    catch (itk::ExceptionObject& err)
+    {
+      rejected = true;
+      std::cout << "Expected error: " << err.GetDescription() << std::endl;
+    }
+    if (rejected != (corruption.Node != -2))
+    {
+      std::cout << "The tree corrupted at node " << corruption.Node << ", column " << corruption.Column << " was " << (rejected ? "rejected" : "accepted")
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
 using RandomForestType = otb::RandomForestsMachineLearningModel<InputValueType, TargetValueType>;
 int otbRandomForestsMachineLearningModel(int argc, char* argv[])
 {
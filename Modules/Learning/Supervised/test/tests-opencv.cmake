@@ -76,6 +76,12 @@ otb_add_test(NAME leTvKNearestNeighborsMachineLearningModel COMMAND otbSupervise
   ${TEMP}/knn_model.txt
   )
 
+otb_add_test(NAME leTvKNearestNeighborsKDTreeMachineLearningModel COMMAND otbSupervisedTestDriver
+  otbKNearestNeighborsKDTreeMachineLearningModel
+  ${INPUTDATA}/letter_light.scale
+  ${TEMP}/knn_kdtree_model.txt
+  )
+
 otb_add_test(NAME leTvDecisionTreeMachineLearningModel COMMAND otbSupervisedTestDriver
   otbDecisionTreeMachineLearningModel
   ${INPUTDATA}/letter_light.scale
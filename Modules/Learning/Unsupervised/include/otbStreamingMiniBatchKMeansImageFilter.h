@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingMiniBatchKMeansImageFilter_h
+#define otbStreamingMiniBatchKMeansImageFilter_h
+
+#include <vector>
+
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkVariableLengthVector.h"
+#include "otbImage.h"
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include "otbParallelForRange.h"
+
+namespace otb
+{
+
+/** \class PersistentMiniBatchKMeansImageFilter
+ * \brief Persistent filter learning k-means centroids from the pixels of an
+ * image, one streaming division at a time.
+ *
+ * The filter implements the mini-batch k-means of Sculley (Web-scale k-means
+ * clustering, 2010). It is driven by epochs, set with SetCurrentEpoch():
+ *
+ * - Epoch 0 is the seeding pass: valid pixels are drawn into a reservoir of
+ *   ReservoirSize samples (uniform reservoir sampling), and Synthetize() seeds
+ *   the K centroids from the reservoir with k-means++. If initial centroids
+ *   have been given with SetInitialCentroids(), Synthetize() uses them instead
+ *   and the pass does not need to stream the image.
+ * - Each following epoch is a training pass: the valid pixels of each
+ *   division are shuffled and processed by batches of BatchSize samples. The
+ *   nearest centroid of each sample of a batch is searched concurrently (one
+ *   block of samples per thread) against the centroids of the previous batch,
+ *   then each sample moves its centroid with a per-centroid learning rate of
+ *   1 / (number of samples assigned to the centroid so far).
+ *
+ * A pixel is valid when the optional mask is not zero at its location and all
+ * its components are finite.
+ *
+ * The filter does not produce an image: it shall be streamed through
+ * StreamingMiniBatchKMeansImageFilter, which runs all the epochs.
+ *
+ * \sa StreamingMiniBatchKMeansImageFilter
+ *
+ * \ingroup OTBUnsupervised
+ */
+template <class TInputImage, class TMaskImage = otb::Image<unsigned char, 2>>
+class ITK_EXPORT PersistentMiniBatchKMeansImageFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentMiniBatchKMeansImageFilter Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentMiniBatchKMeansImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                       ImageType;
+  typedef typename ImageType::RegionType    RegionType;
+  typedef typename ImageType::PixelType     PixelType;
+  typedef TMaskImage                        MaskImageType;
+  typedef itk::VariableLengthVector<double> CentroidType;
+  typedef std::vector<CentroidType>         CentroidsType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+  typedef RandomGeneratorType::IntegerType                       IntegerType;
+
+  /** Set the mask: only pixels with a non-zero mask value are used. */
+  void SetMaskImage(const MaskImageType* mask);
+  const MaskImageType* GetMaskImage() const;
+
+  /** Number of centroids */
+  itkSetMacro(NumberOfClusters, unsigned int);
+  itkGetConstMacro(NumberOfClusters, unsigned int);
+
+  /** Number of samples per mini-batch */
+  itkSetMacro(BatchSize, unsigned int);
+  itkGetConstMacro(BatchSize, unsigned int);
+
+  /** Number of samples kept for the k-means++ seeding */
+  itkSetMacro(ReservoirSize, unsigned int);
+  itkGetConstMacro(ReservoirSize, unsigned int);
+
+  /** Seed of the random generator (reservoir, seeding and batch shuffling) */
+  itkSetMacro(Seed, unsigned int);
+  itkGetConstMacro(Seed, unsigned int);
+
+  /** Epoch of the next pass: 0 for seeding, training otherwise */
+  itkSetMacro(CurrentEpoch, unsigned int);
+  itkGetConstMacro(CurrentEpoch, unsigned int);
+
+  /** Centroids to start from instead of the k-means++ seeding. An empty list
+   * restores the seeding. */
+  void SetInitialCentroids(const CentroidsType& centroids);
+
+  /** Tells whether initial centroids have been given */
+  bool HasInitialCentroids() const
+  {
+    return !m_InitialCentroids.empty();
+  }
+
+  /** Current centroids */
+  CentroidsType GetCentroids() const;
+
+  /** Sum of the squared distances of the samples of the last epoch to their
+   * centroid, measured when each batch is assigned */
+  itkGetConstMacro(Inertia, double);
+
+  /** Number of samples processed during the last epoch */
+  itkGetConstMacro(NumberOfProcessedSamples, unsigned long);
+
+  void GenerateOutputInformation() override;
+  void AllocateOutputs() override;
+  void Reset(void) override;
+  void Synthetize(void) override;
+
+protected:
+  PersistentMiniBatchKMeansImageFilter();
+  ~PersistentMiniBatchKMeansImageFilter() override
+  {
+  }
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  /** Single-threaded GenerateData: the division is split into batches, and
+   * the assignment of each batch is multi-threaded. */
+  void GenerateData() override;
+
+  /** Assign the samples [begin, end) of the current batch */
+  void AssignBatch(std::size_t begin, std::size_t end);
+
+  /** Seed the centroids from the reservoir with k-means++ */
+  void SeedCentroids();
+
+private:
+  PersistentMiniBatchKMeansImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  unsigned int m_NumberOfClusters;
+  unsigned int m_BatchSize;
+  unsigned int m_ReservoirSize;
+  unsigned int m_Seed;
+  unsigned int m_CurrentEpoch;
+
+  /** Centroids and number of samples assigned to them, packed contiguously */
+  unsigned int        m_NumberOfComponents;
+  std::vector<double> m_Centroids;
+  std::vector<double> m_Counts;
+  CentroidsType       m_InitialCentroids;
+
+  /** Seeding reservoir, and number of valid pixels seen so far */
+  std::vector<double> m_Reservoir;
+  unsigned long       m_NumberOfSeenSamples;
+
+  /** Samples of the current batch, their centroid and squared distance */
+  std::vector<double>       m_BatchSamples;
+  std::vector<unsigned int> m_BatchLabels;
+  std::vector<double>       m_BatchDistances;
+
+  double        m_Inertia;
+  unsigned long m_NumberOfProcessedSamples;
+
+  RandomGeneratorType::Pointer m_Generator;
+}; // end of class PersistentMiniBatchKMeansImageFilter
+
+
+/** \class StreamingMiniBatchKMeansImageFilter
+ * \brief Streams an image through PersistentMiniBatchKMeansImageFilter for
+ * the seeding pass and NumberOfEpochs training passes.
+ *
+ * Only one streaming division is in memory at a time, so that the centroids
+ * can be learnt from all the pixels of images that do not fit in memory.
+ *
+ * \code
+ * typedef otb::StreamingMiniBatchKMeansImageFilter<ImageType> KMeansType;
+ * KMeansType::Pointer kmeans = KMeansType::New();
+ * kmeans->SetInput(reader->GetOutput());
+ * kmeans->GetFilter()->SetNumberOfClusters(5);
+ * kmeans->SetNumberOfEpochs(3);
+ * kmeans->Update();
+ * KMeansType::CentroidsType centroids = kmeans->GetCentroids();
+ * \endcode
+ *
+ * \sa PersistentMiniBatchKMeansImageFilter
+ *
+ * \ingroup OTBUnsupervised
+ */
+template <class TInputImage, class TMaskImage = otb::Image<unsigned char, 2>>
+class ITK_EXPORT StreamingMiniBatchKMeansImageFilter
+    : public PersistentFilterStreamingDecorator<PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingMiniBatchKMeansImageFilter Self;
+  typedef PersistentFilterStreamingDecorator<PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingMiniBatchKMeansImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef typename Superclass::FilterType          KMeansFilterType;
+  typedef typename KMeansFilterType::CentroidsType CentroidsType;
+  typedef TInputImage                              InputImageType;
+  typedef TMaskImage                               MaskImageType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType* input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType* GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  void SetMaskImage(const MaskImageType* mask)
+  {
+    this->GetFilter()->SetMaskImage(mask);
+  }
+
+  /** Number of training passes over the image */
+  itkSetMacro(NumberOfEpochs, unsigned int);
+  itkGetConstMacro(NumberOfEpochs, unsigned int);
+
+  /** Learnt centroids */
+  CentroidsType GetCentroids() const
+  {
+    return this->GetFilter()->GetCentroids();
+  }
+
+protected:
+  /** Constructor */
+  StreamingMiniBatchKMeansImageFilter() : m_NumberOfEpochs(3)
+  {
+  }
+  /** Destructor */
+  ~StreamingMiniBatchKMeansImageFilter() override
+  {
+  }
+
+  void GenerateData(void) override;
+
+private:
+  StreamingMiniBatchKMeansImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  unsigned int m_NumberOfEpochs;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingMiniBatchKMeansImageFilter.hxx"
+#endif
+
+#endif
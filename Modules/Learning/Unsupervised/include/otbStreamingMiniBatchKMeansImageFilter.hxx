@@ -0,0 +1,421 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingMiniBatchKMeansImageFilter_hxx
+#define otbStreamingMiniBatchKMeansImageFilter_hxx
+
+#include "otbStreamingMiniBatchKMeansImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "itkImageRegionConstIterator.h"
+#include "otbMacro.h"
+#include "otbSquaredEuclideanDistance.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TMaskImage>
+PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::PersistentMiniBatchKMeansImageFilter()
+  : m_NumberOfClusters(2),
+    m_BatchSize(1024),
+    m_ReservoirSize(10000),
+    m_Seed(0),
+    m_CurrentEpoch(0),
+    m_NumberOfComponents(0),
+    m_NumberOfSeenSamples(0),
+    m_Inertia(0.0),
+    m_NumberOfProcessedSamples(0),
+    m_Generator(RandomGeneratorType::New())
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::SetMaskImage(const MaskImageType* mask)
+{
+  this->itk::ProcessObject::SetNthInput(1, const_cast<MaskImageType*>(mask));
+}
+
+template <class TInputImage, class TMaskImage>
+const typename PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::MaskImageType*
+PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::GetMaskImage() const
+{
+  if (this->GetNumberOfInputs() < 2)
+  {
+    return nullptr;
+  }
+  return static_cast<const MaskImageType*>(this->itk::ProcessObject::GetInput(1));
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::SetInitialCentroids(const CentroidsType& centroids)
+{
+  m_InitialCentroids = centroids;
+  this->Modified();
+}
+
+template <class TInputImage, class TMaskImage>
+typename PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::CentroidsType
+PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::GetCentroids() const
+{
+  CentroidsType centroids;
+  if (m_NumberOfComponents == 0)
+  {
+    return centroids;
+  }
+  const unsigned int nbCentroids = m_Centroids.size() / m_NumberOfComponents;
+  for (unsigned int c = 0; c < nbCentroids; ++c)
+  {
+    CentroidType centroid(m_NumberOfComponents);
+    for (unsigned int i = 0; i < m_NumberOfComponents; ++i)
+    {
+      centroid[i] = m_Centroids[c * m_NumberOfComponents + i];
+    }
+    centroids.push_back(centroid);
+  }
+  return centroids;
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+  {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+    {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+    }
+  }
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::AllocateOutputs()
+{
+  // Nothing to allocate: the output image is not intended to be used
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::Reset()
+{
+  if (m_CurrentEpoch == 0)
+  {
+    if (m_NumberOfClusters < 1)
+    {
+      itkExceptionMacro(<< "The number of clusters shall be at least 1");
+    }
+    if (m_BatchSize < 1)
+    {
+      itkExceptionMacro(<< "The batch size shall be at least 1");
+    }
+    const_cast<ImageType*>(this->GetInput())->UpdateOutputInformation();
+    m_NumberOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
+
+    m_Generator->Initialize(m_Seed);
+    m_Reservoir.clear();
+    m_Reservoir.reserve(static_cast<std::size_t>(m_ReservoirSize) * m_NumberOfComponents);
+    m_NumberOfSeenSamples = 0;
+    m_Centroids.clear();
+    m_Counts.assign(m_NumberOfClusters, 0.0);
+  }
+  else if (m_Centroids.empty())
+  {
+    itkExceptionMacro(<< "The centroids shall be seeded (epoch 0) before training");
+  }
+
+  m_Inertia                  = 0.0;
+  m_NumberOfProcessedSamples = 0;
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::Synthetize()
+{
+  if (m_CurrentEpoch != 0)
+  {
+    return;
+  }
+
+  if (m_InitialCentroids.empty())
+  {
+    SeedCentroids();
+    return;
+  }
+
+  if (m_InitialCentroids.size() != m_NumberOfClusters)
+  {
+    itkExceptionMacro(<< "Expecting " << m_NumberOfClusters << " initial centroids, got " << m_InitialCentroids.size());
+  }
+  m_Centroids.clear();
+  for (const auto& centroid : m_InitialCentroids)
+  {
+    if (centroid.Size() != m_NumberOfComponents)
+    {
+      itkExceptionMacro(<< "The initial centroids have " << centroid.Size() << " components, the image has " << m_NumberOfComponents);
+    }
+    for (unsigned int i = 0; i < m_NumberOfComponents; ++i)
+    {
+      m_Centroids.push_back(centroid[i]);
+    }
+  }
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::SeedCentroids()
+{
+  const unsigned int nbComp    = m_NumberOfComponents;
+  const std::size_t  nbSamples = m_Reservoir.size() / nbComp;
+  if (nbSamples < m_NumberOfClusters)
+  {
+    itkExceptionMacro(<< "Only " << nbSamples << " valid samples found, at least " << m_NumberOfClusters << " are needed");
+  }
+
+  // k-means++: the first centroid is drawn uniformly, the next ones with a
+  // probability proportional to the squared distance to the nearest centroid
+  m_Centroids.clear();
+  std::vector<double> distances(nbSamples, std::numeric_limits<double>::max());
+  std::size_t         chosen = m_Generator->GetIntegerVariate(static_cast<IntegerType>(nbSamples - 1));
+  for (unsigned int c = 0; c < m_NumberOfClusters; ++c)
+  {
+    const double* centroid = &m_Reservoir[chosen * nbComp];
+    m_Centroids.insert(m_Centroids.end(), centroid, centroid + nbComp);
+
+    double total = 0.0;
+    for (std::size_t s = 0; s < nbSamples; ++s)
+    {
+      distances[s] = std::min(distances[s], SquaredEuclideanDistance(&m_Reservoir[s * nbComp], centroid, nbComp));
+      total += distances[s];
+    }
+
+    if (total <= 0.0)
+    {
+      // All the samples lie on the centroids already chosen
+      chosen = m_Generator->GetIntegerVariate(static_cast<IntegerType>(nbSamples - 1));
+      continue;
+    }
+
+    const double threshold = m_Generator->GetUniformVariate(0.0, total);
+    double       cumulated = 0.0;
+    chosen                 = nbSamples - 1;
+    for (std::size_t s = 0; s < nbSamples; ++s)
+    {
+      cumulated += distances[s];
+      if (cumulated >= threshold && distances[s] > 0.0)
+      {
+        chosen = s;
+        break;
+      }
+    }
+  }
+
+  // The reservoir is not needed anymore
+  std::vector<double>().swap(m_Reservoir);
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::GenerateData()
+{
+  // With initial centroids, the seeding pass has nothing to read
+  if (m_CurrentEpoch == 0 && !m_InitialCentroids.empty())
+  {
+    return;
+  }
+
+  const ImageType*     input  = this->GetInput();
+  const MaskImageType* mask   = this->GetMaskImage();
+  const RegionType     region = this->GetOutput()->GetRequestedRegion();
+  const unsigned int   nbComp = m_NumberOfComponents;
+
+  // Gather the valid pixels of the division
+  std::vector<double> samples;
+  samples.reserve(region.GetNumberOfPixels() * nbComp);
+  std::vector<double> pixel(nbComp);
+
+  itk::ImageRegionConstIterator<ImageType>     it(input, region);
+  itk::ImageRegionConstIterator<MaskImageType> maskIt;
+  if (mask)
+  {
+    maskIt = itk::ImageRegionConstIterator<MaskImageType>(mask, region);
+    maskIt.GoToBegin();
+  }
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    bool valid = true;
+    if (mask)
+    {
+      valid = maskIt.Get() != 0;
+      ++maskIt;
+    }
+    if (!valid)
+    {
+      continue;
+    }
+
+    const PixelType& value = it.Get();
+    for (unsigned int i = 0; i < nbComp && valid; ++i)
+    {
+      pixel[i] = static_cast<double>(value[i]);
+      valid    = std::isfinite(pixel[i]);
+    }
+    if (valid)
+    {
+      samples.insert(samples.end(), pixel.begin(), pixel.end());
+    }
+  }
+  const std::size_t nbSamples = samples.size() / nbComp;
+
+  if (m_CurrentEpoch == 0)
+  {
+    // Reservoir sampling
+    for (std::size_t s = 0; s < nbSamples; ++s, ++m_NumberOfSeenSamples)
+    {
+      if (m_NumberOfSeenSamples < m_ReservoirSize)
+      {
+        m_Reservoir.insert(m_Reservoir.end(), samples.begin() + s * nbComp, samples.begin() + (s + 1) * nbComp);
+      }
+      else
+      {
+        // Uniform index in [0, m_NumberOfSeenSamples], without the 32 bits
+        // limit of GetIntegerVariate()
+        const auto j = static_cast<unsigned long>(m_Generator->GetUniformVariate(0.0, static_cast<double>(m_NumberOfSeenSamples) + 1.0));
+        if (j < m_ReservoirSize)
+        {
+          std::copy(samples.begin() + s * nbComp, samples.begin() + (s + 1) * nbComp, m_Reservoir.begin() + j * nbComp);
+        }
+      }
+    }
+    return;
+  }
+
+  // Shuffle the samples so that batches are not made of neighbouring pixels
+  std::vector<std::size_t> order(nbSamples);
+  for (std::size_t s = 0; s < nbSamples; ++s)
+  {
+    order[s] = s;
+  }
+  for (std::size_t s = nbSamples; s > 1; --s)
+  {
+    std::swap(order[s - 1], order[m_Generator->GetIntegerVariate(static_cast<IntegerType>(s - 1))]);
+  }
+
+  m_BatchSamples.resize(static_cast<std::size_t>(m_BatchSize) * nbComp);
+  m_BatchLabels.resize(m_BatchSize);
+  m_BatchDistances.resize(m_BatchSize);
+
+  for (std::size_t first = 0; first < nbSamples; first += m_BatchSize)
+  {
+    const unsigned int batchSize = static_cast<unsigned int>(std::min<std::size_t>(m_BatchSize, nbSamples - first));
+    for (unsigned int s = 0; s < batchSize; ++s)
+    {
+      std::copy(samples.begin() + order[first + s] * nbComp, samples.begin() + (order[first + s] + 1) * nbComp, m_BatchSamples.begin() + s * nbComp);
+    }
+
+    // Assign the batch against the current centroids
+    ParallelForRange(this->GetMultiThreader(), this->GetNumberOfThreads(), batchSize,
+                     [this](itk::ThreadIdType, std::size_t begin, std::size_t end) { AssignBatch(begin, end); });
+
+    // Move the centroids towards their samples
+    for (unsigned int s = 0; s < batchSize; ++s)
+    {
+      const unsigned int c = m_BatchLabels[s];
+      m_Counts[c] += 1.0;
+      const double  eta      = 1.0 / m_Counts[c];
+      double*       centroid = &m_Centroids[c * nbComp];
+      const double* sample   = &m_BatchSamples[s * nbComp];
+      for (unsigned int i = 0; i < nbComp; ++i)
+      {
+        centroid[i] += eta * (sample[i] - centroid[i]);
+      }
+      m_Inertia += m_BatchDistances[s];
+    }
+    m_NumberOfProcessedSamples += batchSize;
+  }
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::AssignBatch(std::size_t begin, std::size_t end)
+{
+  const unsigned int nbComp      = m_NumberOfComponents;
+  const unsigned int nbCentroids = m_NumberOfClusters;
+  const double*      centroids   = m_Centroids.data();
+
+  for (std::size_t s = begin; s < end; ++s)
+  {
+    const double* sample      = &m_BatchSamples[s * nbComp];
+    double        minDistance = std::numeric_limits<double>::max();
+    unsigned int  label       = 0;
+    for (unsigned int c = 0; c < nbCentroids; ++c)
+    {
+      const double distance = SquaredEuclideanDistance(sample, centroids + c * nbComp, nbComp);
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        label       = c;
+      }
+    }
+    m_BatchLabels[s]    = label;
+    m_BatchDistances[s] = minDistance;
+  }
+}
+
+template <class TInputImage, class TMaskImage>
+void PersistentMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfClusters: " << m_NumberOfClusters << std::endl;
+  os << indent << "BatchSize: " << m_BatchSize << std::endl;
+  os << indent << "ReservoirSize: " << m_ReservoirSize << std::endl;
+  os << indent << "Seed: " << m_Seed << std::endl;
+  os << indent << "CurrentEpoch: " << m_CurrentEpoch << std::endl;
+  os << indent << "Inertia: " << m_Inertia << std::endl;
+}
+
+template <class TInputImage, class TMaskImage>
+void StreamingMiniBatchKMeansImageFilter<TInputImage, TMaskImage>::GenerateData()
+{
+  KMeansFilterType* filter = this->GetFilter();
+  this->GetStreamer()->SetInput(filter->GetOutput());
+
+  for (unsigned int epoch = 0; epoch <= m_NumberOfEpochs; ++epoch)
+  {
+    // Changing the epoch modifies the filter, so that the streamer runs
+    // through the whole image again
+    filter->SetCurrentEpoch(epoch);
+    filter->Reset();
+    if (epoch > 0 || !filter->HasInitialCentroids())
+    {
+      this->GetStreamer()->Update();
+    }
+    filter->Synthetize();
+    if (epoch > 0)
+    {
+      otbMsgDevMacro(<< "Mini-batch k-means epoch " << epoch << ": mean squared distance "
+                     << filter->GetInertia() / std::max(1ul, filter->GetNumberOfProcessedSamples()));
+    }
+  }
+}
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbVectorImage.h"
+#include "otbImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "otbStreamingMiniBatchKMeansImageFilter.h"
+
+int otbStreamingMiniBatchKMeansImageFilter(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::VectorImage<float, 2>                          ImageType;
+  typedef otb::Image<unsigned char, 2>                        MaskType;
+  typedef otb::StreamingMiniBatchKMeansImageFilter<ImageType> KMeansType;
+
+  // Three clusters in vertical stripes, plus a masked stripe of outliers
+  const double centers[3][3] = {{0., 0., 0.}, {10., 0., 5.}, {0., 10., -5.}};
+
+  ImageType::RegionType region;
+  region.SetSize(0, 120);
+  region.SetSize(1, 100);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(3);
+  image->Allocate();
+  MaskType::Pointer mask = MaskType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  itk::ImageRegionIteratorWithIndex<MaskType>  maskIt(mask, region);
+  for (it.GoToBegin(), maskIt.GoToBegin(); !it.IsAtEnd(); ++it, ++maskIt)
+  {
+    const int    x      = it.GetIndex()[0];
+    const int    y      = it.GetIndex()[1];
+    const int    stripe = x / 30;
+    const double noise  = ((x * 7 + y * 13) % 11 - 5) / 10.;
+
+    ImageType::PixelType pixel(3);
+    for (unsigned int b = 0; b < 3; ++b)
+    {
+      pixel[b] = stripe < 3 ? centers[stripe][b] + noise : 1000.;
+    }
+    it.Set(pixel);
+    maskIt.Set(stripe < 3 ? 1 : 0);
+  }
+
+  KMeansType::Pointer kmeans = KMeansType::New();
+  kmeans->SetInput(image);
+  kmeans->SetMaskImage(mask);
+  kmeans->SetNumberOfEpochs(3);
+  kmeans->GetFilter()->SetNumberOfClusters(3);
+  kmeans->GetFilter()->SetBatchSize(64);
+  kmeans->GetFilter()->SetReservoirSize(500);
+  kmeans->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  kmeans->Update();
+
+  KMeansType::CentroidsType centroids = kmeans->GetCentroids();
+  if (centroids.size() != 3)
+  {
+    std::cerr << "Expecting 3 centroids, got " << centroids.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Each cluster shall be found, and the masked outliers ignored
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    bool found = false;
+    for (const auto& centroid : centroids)
+    {
+      double distance = 0.;
+      for (unsigned int b = 0; b < 3; ++b)
+      {
+        distance += (centroid[b] - centers[c][b]) * (centroid[b] - centers[c][b]);
+      }
+      found = found || distance < 0.25;
+    }
+    if (!found)
+    {
+      std::cerr << "Cluster " << c << " not found" << std::endl;
+      for (const auto& centroid : centroids)
+      {
+        std::cerr << "  centroid " << centroid << std::endl;
+      }
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Restarting from the learnt centroids skips the seeding pass
+  kmeans->GetFilter()->SetInitialCentroids(centroids);
+  kmeans->SetNumberOfEpochs(1);
+  kmeans->Update();
+  if (kmeans->GetFilter()->GetNumberOfProcessedSamples() != 90 * 100)
+  {
+    std::cerr << "Expecting " << 90 * 100 << " processed samples, got " << kmeans->GetFilter()->GetNumberOfProcessedSamples() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
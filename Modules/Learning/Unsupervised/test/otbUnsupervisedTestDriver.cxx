@@ -24,6 +24,7 @@ void RegisterTests()
   REGISTER_TEST(otbContingencyTableCalculatorSetListSamples);
   REGISTER_TEST(otbContingencyTableCalculatorCompute);
   REGISTER_TEST(otbContingencyTableCalculatorComputeWithBaseline);
+  REGISTER_TEST(otbStreamingMiniBatchKMeansImageFilter);
 
 #ifdef OTB_USE_SHARK
   REGISTER_TEST(otbSharkKMeansMachineLearningModelCanRead);
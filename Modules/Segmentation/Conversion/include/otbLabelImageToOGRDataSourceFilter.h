@@ -23,7 +23,9 @@
 
 #include "itkProcessObject.h"
 #include "otbOGRDataSourceWrapper.h"
+#include "otbParallelForRange.h"
 #include <string>
+#include <vector>
 
 namespace otb
 {
@@ -38,6 +40,13 @@ namespace otb
  * \note The Use8Connected parameter can be turn on and it will be used in \c GDALPolygonize(). But be carreful, it
  * can create cross polygons !
  * \note It is a non-streamed version.
+ * \note The image is polygonized by horizontal strips of NumberOfLinesPerStrip lines, shared
+ * between the threads. Polygons which don't reach the border of their strip are kept as is,
+ * while the fragments crossing the borders are merged once all the strips are done. The
+ * features are then sorted by their first pixel in raster order, and each ring starts on
+ * its first vertex in raster order. The split doesn't depend on the number of threads, so
+ * the output only depends on the input. Images of less than two strips, or polygonized with
+ * the Use8Connected option, or rotated, give the output of a single \c GDALPolygonize() call.
  * \ingroup OBIA
  *
  *
@@ -106,6 +115,11 @@ public:
    */
   itkGetMacro(Use8Connected, bool);
 
+  /** Set/Get the number of lines of the strips the image is polygonized
+   * by (default is 512). 0 polygonizes the image at once. */
+  itkSetMacro(NumberOfLinesPerStrip, unsigned int);
+  itkGetMacro(NumberOfLinesPerStrip, unsigned int);
+
   /**
    * Get the output \c ogr::DataSource which is a "memory" datasource.
    */
@@ -122,6 +136,17 @@ protected:
   /** Generate Data method*/
   void GenerateData() override;
 
+  /** Create a MEM dataset over the buffer of an image, restricted to a
+   * region of full lines */
+  GDALDataset* CreateDataset(const InputImageType* image, const RegionType& region) const;
+
+  /** Polygonize a region of full lines of the input image into a layer */
+  void PolygonizeRegion(const RegionType& region, OGRLayerType& layer);
+
+  /** Write the polygons of all the strips into the output layer, merging the
+   * fragments of polygons crossing the strip borders */
+  void MergeStrips(const std::vector<RegionType>& strips, const std::vector<OGRDataSourcePointerType>& stripData, OGRLayerType& outputLayer);
+
   /** DataObject pointer */
   typedef itk::DataObject::Pointer DataObjectPointer;
 
@@ -132,8 +157,9 @@ private:
   LabelImageToOGRDataSourceFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
 
-  std::string m_FieldName;
-  bool        m_Use8Connected;
+  std::string  m_FieldName;
+  bool         m_Use8Connected;
+  unsigned int m_NumberOfLinesPerStrip;
 };
 
 
@@ -23,6 +23,8 @@
 
 #include "otbLabelImageToOGRDataSourceFilter.h"
 #include "otbGdalDataTypeBridge.h"
+#include "otbOGRFeatureWrapper.h"
+#include "otbOGRGeometryWrapper.h"
 
 // gdal libraries
 #include "gdal.h"
@@ -31,11 +33,20 @@
 #include "gdal_alg.h"
 
 #include "stdint.h" //needed for uintptr_t
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 namespace otb
 {
 template <class TInputImage>
-LabelImageToOGRDataSourceFilter<TInputImage>::LabelImageToOGRDataSourceFilter() : m_FieldName("DN"), m_Use8Connected(false)
+LabelImageToOGRDataSourceFilter<TInputImage>::LabelImageToOGRDataSourceFilter()
+  : m_FieldName("DN"), m_Use8Connected(false), m_NumberOfLinesPerStrip(512)
 {
   this->SetNumberOfRequiredInputs(2);
   this->SetNumberOfRequiredInputs(1);
@@ -121,21 +132,11 @@ void LabelImageToOGRDataSourceFilter<TInputImage>::GenerateInputRequestedRegion(
 
 
 template <class TInputImage>
-void LabelImageToOGRDataSourceFilter<TInputImage>::GenerateData(void)
+GDALDataset* LabelImageToOGRDataSourceFilter<TInputImage>::CreateDataset(const InputImageType* image, const RegionType& region) const
 {
-  if (this->GetInput()->GetRequestedRegion() != this->GetInput()->GetLargestPossibleRegion())
-  {
-    itkExceptionMacro(<< "Not streamed filter. ERROR : requested region is not the largest possible region.");
-  }
-
-  SizeType     size;
-  unsigned int nbBands      = 0;
-  unsigned int bytePerPixel = 0;
-
-  /* Convert the input image into a GDAL raster needed by GDALPolygonize */
-  size         = this->GetInput()->GetLargestPossibleRegion().GetSize();
-  nbBands      = this->GetInput()->GetNumberOfComponentsPerPixel();
-  bytePerPixel = sizeof(InputPixelType);
+  const unsigned int nbBands      = image->GetNumberOfComponentsPerPixel();
+  const unsigned int bytePerPixel = sizeof(InputPixelType);
+  const SizeType     bufferSize   = image->GetBufferedRegion().GetSize();
 
   // buffer casted in unsigned long cause under Win32 the address
   // don't begin with 0x, the address in not interpreted as
@@ -143,33 +144,36 @@ void LabelImageToOGRDataSourceFilter<TInputImage>::GenerateData(void)
   // integer make us pointing to an non allowed memory block => Crash.
   std::ostringstream stream;
   stream << "MEM:::"
-         << "DATAPOINTER=" << (uintptr_t)(this->GetInput()->GetBufferPointer()) << ","
-         << "PIXELS=" << size[0] << ","
-         << "LINES=" << size[1] << ","
+         << "DATAPOINTER=" << (uintptr_t)(image->GetBufferPointer() + image->ComputeOffset(region.GetIndex()) * nbBands) << ","
+         << "PIXELS=" << region.GetSize()[0] << ","
+         << "LINES=" << region.GetSize()[1] << ","
          << "BANDS=" << nbBands << ","
          << "DATATYPE=" << GDALGetDataTypeName(GdalDataTypeBridge::GetGDALDataType<InputPixelType>()) << ","
          << "PIXELOFFSET=" << bytePerPixel * nbBands << ","
-         << "LINEOFFSET=" << bytePerPixel * nbBands * size[0] << ","
+         << "LINEOFFSET=" << bytePerPixel * nbBands * bufferSize[0] << ","
          << "BANDOFFSET=" << bytePerPixel;
 
   GDALDataset* dataset = static_cast<GDALDataset*>(GDALOpen(stream.str().c_str(), GA_ReadOnly));
+  if (!dataset)
+  {
+    itkExceptionMacro(<< "Failed to create the GDAL dataset: " << CPLGetLastErrorMsg());
+  }
 
   // Set input Projection ref and Geo transform to the dataset.
-  dataset->SetProjection(this->GetInput()->GetProjectionRef().c_str());
+  dataset->SetProjection(image->GetProjectionRef().c_str());
 
-  unsigned int projSize = this->GetInput()->GetGeoTransform().size();
+  unsigned int projSize = image->GetGeoTransform().size();
   double       geoTransform[6];
 
   // Set the geo transform of the input image (if any)
-  // Reporting origin and spacing of the buffered region
-  // the spacing is unchanged, the origin is relative to the buffered region
-  IndexType  bufferIndexOrigin = this->GetInput()->GetBufferedRegion().GetIndex();
-  OriginType bufferOrigin;
-  this->GetInput()->TransformIndexToPhysicalPoint(bufferIndexOrigin, bufferOrigin);
-  geoTransform[0] = bufferOrigin[0] - 0.5 * this->GetInput()->GetSignedSpacing()[0];
-  geoTransform[3] = bufferOrigin[1] - 0.5 * this->GetInput()->GetSignedSpacing()[1];
-  geoTransform[1] = this->GetInput()->GetSignedSpacing()[0];
-  geoTransform[5] = this->GetInput()->GetSignedSpacing()[1];
+  // Reporting origin and spacing of the region
+  // the spacing is unchanged, the origin is relative to the region
+  OriginType regionOrigin;
+  image->TransformIndexToPhysicalPoint(region.GetIndex(), regionOrigin);
+  geoTransform[0] = regionOrigin[0] - 0.5 * image->GetSignedSpacing()[0];
+  geoTransform[3] = regionOrigin[1] - 0.5 * image->GetSignedSpacing()[1];
+  geoTransform[1] = image->GetSignedSpacing()[0];
+  geoTransform[5] = image->GetSignedSpacing()[1];
   // FIXME: Here component 1 and 4 should be replaced by the orientation parameters
   if (projSize == 0)
   {
@@ -178,18 +182,19 @@ void LabelImageToOGRDataSourceFilter<TInputImage>::GenerateData(void)
   }
   else
   {
-    geoTransform[2] = this->GetInput()->GetGeoTransform()[2];
-    geoTransform[4] = this->GetInput()->GetGeoTransform()[4];
+    geoTransform[2] = image->GetGeoTransform()[2];
+    geoTransform[4] = image->GetGeoTransform()[4];
   }
   dataset->SetGeoTransform(geoTransform);
 
-  // Create the output layer for GDALPolygonize().
-  ogr::DataSource::Pointer ogrDS = ogr::DataSource::New();
-
-  OGRLayerType outputLayer = ogrDS->CreateLayer("layer", nullptr, wkbPolygon);
+  return dataset;
+}
 
-  OGRFieldDefn field(m_FieldName.c_str(), OFTInteger);
-  outputLayer.CreateField(field, true);
+template <class TInputImage>
+void LabelImageToOGRDataSourceFilter<TInputImage>::PolygonizeRegion(const RegionType& region, OGRLayerType& layer)
+{
+  /* Convert the input image into a GDAL raster needed by GDALPolygonize */
+  GDALDataset* dataset = this->CreateDataset(this->GetInput(), region);
 
   // Call GDALPolygonize()
   char** options;
@@ -203,70 +208,400 @@ void LabelImageToOGRDataSourceFilter<TInputImage>::GenerateData(void)
   }
 
   /* Convert the mask input into a GDAL raster needed by GDALPolygonize */
-  typename InputImageType::ConstPointer inputMask = this->GetInputMask();
-  if (!inputMask.IsNull())
+  const InputImageType* inputMask = this->GetInputMask();
+  if (inputMask)
   {
-    size         = this->GetInputMask()->GetLargestPossibleRegion().GetSize();
-    nbBands      = this->GetInputMask()->GetNumberOfComponentsPerPixel();
-    bytePerPixel = sizeof(InputPixelType);
-    // buffer casted in unsigned long cause under Win32 the address
-    // don't begin with 0x, the address in not interpreted as
-    // hexadecimal but alpha numeric value, then the conversion to
-    // integer make us pointing to an non allowed memory block => Crash.
-    std::ostringstream maskstream;
-    maskstream << "MEM:::"
-               << "DATAPOINTER=" << (uintptr_t)(this->GetInputMask()->GetBufferPointer()) << ","
-               << "PIXELS=" << size[0] << ","
-               << "LINES=" << size[1] << ","
-               << "BANDS=" << nbBands << ","
-               << "DATATYPE=" << GDALGetDataTypeName(GdalDataTypeBridge::GetGDALDataType<InputPixelType>()) << ","
-               << "PIXELOFFSET=" << bytePerPixel * nbBands << ","
-               << "LINEOFFSET=" << bytePerPixel * nbBands * size[0] << ","
-               << "BANDOFFSET=" << bytePerPixel;
-
-    GDALDataset* maskDataset = static_cast<GDALDataset*>(GDALOpen(maskstream.str().c_str(), GA_ReadOnly));
-
-    // Set input Projection ref and Geo transform to the dataset.
-    maskDataset->SetProjection(this->GetInputMask()->GetProjectionRef().c_str());
-
-    projSize = this->GetInputMask()->GetGeoTransform().size();
-
-    // Set the geo transform of the input mask image (if any)
-    // Reporting origin and spacing of the buffered region
-    // the spacing is unchanged, the origin is relative to the buffered region
-    bufferIndexOrigin = this->GetInputMask()->GetBufferedRegion().GetIndex();
-    this->GetInputMask()->TransformIndexToPhysicalPoint(bufferIndexOrigin, bufferOrigin);
-    geoTransform[0] = bufferOrigin[0] - 0.5 * this->GetInputMask()->GetSignedSpacing()[0];
-    geoTransform[3] = bufferOrigin[1] - 0.5 * this->GetInputMask()->GetSignedSpacing()[1];
-    geoTransform[1] = this->GetInputMask()->GetSignedSpacing()[0];
-    geoTransform[5] = this->GetInputMask()->GetSignedSpacing()[1];
-    // FIXME: Here component 1 and 4 should be replaced by the orientation parameters
-    if (projSize == 0)
+    GDALDataset* maskDataset = this->CreateDataset(inputMask, region);
+    GDALPolygonize(dataset->GetRasterBand(1), maskDataset->GetRasterBand(1), &layer.ogr(), 0, options, nullptr, nullptr);
+    GDALClose(maskDataset);
+  }
+  else
+  {
+    GDALPolygonize(dataset->GetRasterBand(1), nullptr, &layer.ogr(), 0, options, nullptr, nullptr);
+  }
+
+  // Clear memory
+  GDALClose(dataset);
+}
+
+template <class TInputImage>
+void LabelImageToOGRDataSourceFilter<TInputImage>::GenerateData(void)
+{
+  if (this->GetInput()->GetRequestedRegion() != this->GetInput()->GetLargestPossibleRegion())
+  {
+    itkExceptionMacro(<< "Not streamed filter. ERROR : requested region is not the largest possible region.");
+  }
+
+  const RegionType region = this->GetInput()->GetLargestPossibleRegion();
+
+  // Split the image in strips of full lines, whatever the number of threads so
+  // that the output doesn't depend on it. Polygons can't be merged across
+  // strips if they are 8-connected (GDALPolygonize() may build self-touching
+  // rings), or if the strip borders are not horizontal.
+  unsigned int nbStrips = 1;
+  const bool   rotated  = this->GetInput()->GetGeoTransform().size() == 6 &&
+                       (this->GetInput()->GetGeoTransform()[2] != 0. || this->GetInput()->GetGeoTransform()[4] != 0.);
+  if (!m_Use8Connected && !rotated && m_NumberOfLinesPerStrip > 0)
+  {
+    nbStrips = std::max<unsigned int>(1, region.GetSize()[1] / m_NumberOfLinesPerStrip);
+  }
+
+  std::vector<RegionType>               strips;
+  std::vector<OGRDataSourcePointerType> stripData;
+  for (unsigned int i = 0; i < nbStrips; ++i)
+  {
+    const unsigned long firstLine = region.GetSize()[1] * i / nbStrips;
+    const unsigned long lastLine  = region.GetSize()[1] * (i + 1) / nbStrips;
+
+    RegionType strip = region;
+    strip.SetIndex(1, region.GetIndex()[1] + firstLine);
+    strip.SetSize(1, lastLine - firstLine);
+    strips.push_back(strip);
+
+    // Create the output layer for GDALPolygonize().
+    ogr::DataSource::Pointer ogrDS       = ogr::DataSource::New();
+    OGRLayerType             outputLayer = ogrDS->CreateLayer("layer", nullptr, wkbPolygon);
+    OGRFieldDefn             field(m_FieldName.c_str(), OFTInteger);
+    outputLayer.CreateField(field, true);
+    stripData.push_back(ogrDS);
+  }
+
+  if (nbStrips == 1)
+  {
+    OGRLayerType outputLayer = stripData[0]->GetLayer(0);
+    this->PolygonizeRegion(region, outputLayer);
+    this->SetNthOutput(0, stripData[0]);
+    return;
+  }
+
+  ParallelForRange(this->GetMultiThreader(), this->GetNumberOfThreads(), nbStrips, [this, &strips, &stripData](itk::ThreadIdType, std::size_t begin, std::size_t end) {
+    for (std::size_t s = begin; s < end; ++s)
     {
-      geoTransform[2] = 0.;
-      geoTransform[4] = 0.;
+      OGRLayerType layer = stripData[s]->GetLayer(0);
+      this->PolygonizeRegion(strips[s], layer);
     }
-    else
+  });
+
+  ogr::DataSource::Pointer ogrDS       = ogr::DataSource::New();
+  OGRLayerType             outputLayer = ogrDS->CreateLayer("layer", nullptr, wkbPolygon);
+  OGRFieldDefn             field(m_FieldName.c_str(), OFTInteger);
+  outputLayer.CreateField(field, true);
+
+  this->MergeStrips(strips, stripData, outputLayer);
+
+  this->SetNthOutput(0, ogrDS);
+}
+
+namespace internal
+{
+/** Move the vertices of the rings of a polygon lying (within tolerance) on
+ * the line Y = y exactly onto it, so that fragments computed with the origins
+ * of neighbouring strips share their edges. */
+inline void SnapPolygonToLine(OGRPolygon& polygon, double y, double tolerance)
+{
+  for (int r = -1; r < polygon.getNumInteriorRings(); ++r)
+  {
+    OGRLinearRing* ring = r < 0 ? polygon.getExteriorRing() : polygon.getInteriorRing(r);
+    for (int p = 0; p < ring->getNumPoints(); ++p)
     {
-      geoTransform[2] = this->GetInputMask()->GetGeoTransform()[2];
-      geoTransform[4] = this->GetInputMask()->GetGeoTransform()[4];
+      if (std::abs(ring->getY(p) - y) < tolerance)
+      {
+        ring->setPoint(p, ring->getX(p), y);
+      }
     }
-    maskDataset->SetGeoTransform(geoTransform);
+  }
+}
 
-    GDALPolygonize(dataset->GetRasterBand(1), maskDataset->GetRasterBand(1), &outputLayer.ogr(), 0, options, nullptr, nullptr);
-    GDALClose(maskDataset);
+/** Remove the vertices left in the middle of straight edges by the merge of
+ * polygon fragments. Edges of polygonized pixels are horizontal or vertical. */
+inline void RemoveCollinearPoints(OGRPolygon& polygon)
+{
+  for (int r = -1; r < polygon.getNumInteriorRings(); ++r)
+  {
+    OGRLinearRing* ring = r < 0 ? polygon.getExteriorRing() : polygon.getInteriorRing(r);
+    // The last point closes the ring
+    const int nbPoints = ring->getNumPoints() - 1;
+    if (nbPoints < 4)
+    {
+      continue;
+    }
+    std::vector<double> x, y;
+    for (int p = 0; p < nbPoints; ++p)
+    {
+      const int prev = (p + nbPoints - 1) % nbPoints;
+      const int next = (p + 1) % nbPoints;
+      if ((ring->getX(prev) == ring->getX(p) && ring->getX(p) == ring->getX(next)) ||
+          (ring->getY(prev) == ring->getY(p) && ring->getY(p) == ring->getY(next)))
+      {
+        continue;
+      }
+      x.push_back(ring->getX(p));
+      y.push_back(ring->getY(p));
+    }
+    x.push_back(x.front());
+    y.push_back(y.front());
+    ring->setPoints(static_cast<int>(x.size()), x.data(), y.data());
   }
-  else
+}
+
+/** Position of a vertex in raster order: line first, then column. The signs
+ * of the spacing give the direction of the lines and columns. */
+typedef std::pair<double, double> RasterPosition;
+
+inline RasterPosition GetRasterPosition(const OGRLinearRing& ring, int p, double signX, double signY)
+{
+  return RasterPosition(signY * ring.getY(p), signX * ring.getX(p));
+}
+
+/** Position of the first vertex in raster order of a polygon, which is the
+ * corner of its first pixel */
+inline RasterPosition GetFirstVertexPosition(const OGRPolygon& polygon, double signX, double signY)
+{
+  const OGRLinearRing* ring  = polygon.getExteriorRing();
+  RasterPosition       first = GetRasterPosition(*ring, 0, signX, signY);
+  for (int p = 1; p < ring->getNumPoints(); ++p)
   {
-    GDALPolygonize(dataset->GetRasterBand(1), nullptr, &outputLayer.ogr(), 0, options, nullptr, nullptr);
+    first = std::min(first, GetRasterPosition(*ring, p, signX, signY));
   }
+  return first;
+}
 
-  this->SetNthOutput(0, ogrDS);
+/** Make the rings of a polygon start on their first vertex in raster order */
+inline void StartRingsOnFirstVertex(OGRPolygon& polygon, double signX, double signY)
+{
+  for (int r = -1; r < polygon.getNumInteriorRings(); ++r)
+  {
+    OGRLinearRing* ring = r < 0 ? polygon.getExteriorRing() : polygon.getInteriorRing(r);
+    // The last point closes the ring
+    const int nbPoints = ring->getNumPoints() - 1;
+    if (nbPoints < 3)
+    {
+      continue;
+    }
+    int start = 0;
+    for (int p = 1; p < nbPoints; ++p)
+    {
+      if (GetRasterPosition(*ring, p, signX, signY) < GetRasterPosition(*ring, start, signX, signY))
+      {
+        start = p;
+      }
+    }
+    std::vector<double> x(nbPoints + 1), y(nbPoints + 1);
+    for (int p = 0; p <= nbPoints; ++p)
+    {
+      x[p] = ring->getX((start + p) % nbPoints);
+      y[p] = ring->getY((start + p) % nbPoints);
+    }
+    ring->setPoints(nbPoints + 1, x.data(), y.data());
+  }
+}
 
-  // Clear memory
-  GDALClose(dataset);
+/** Orient the exterior ring of a polygon as given, and its interior rings the
+ * other way */
+inline void OrientRings(OGRPolygon& polygon, bool exteriorClockwise)
+{
+  for (int r = -1; r < polygon.getNumInteriorRings(); ++r)
+  {
+    OGRLinearRing* ring = r < 0 ? polygon.getExteriorRing() : polygon.getInteriorRing(r);
+    if ((ring->isClockwise() != 0) != (r < 0 ? exteriorClockwise : !exteriorClockwise))
+    {
+      ring->reverseWindingOrder();
+    }
+  }
+}
 }
 
+template <class TInputImage>
+void LabelImageToOGRDataSourceFilter<TInputImage>::MergeStrips(const std::vector<RegionType>& strips, const std::vector<OGRDataSourcePointerType>& stripData,
+                                                               OGRLayerType& outputLayer)
+{
+  const InputImageType* input      = this->GetInput();
+  const double          toleranceX = 0.25 * std::abs(input->GetSignedSpacing()[0]);
+  const double          toleranceY = 0.25 * std::abs(input->GetSignedSpacing()[1]);
+  const double          signX      = input->GetSignedSpacing()[0] < 0 ? -1. : 1.;
+  const double          signY      = input->GetSignedSpacing()[1] < 0 ? -1. : 1.;
+
+  // Final polygons, written sorted by their first pixel
+  struct OutputPolygon
+  {
+    std::unique_ptr<OGRGeometry, ogr::internal::GeometryDeleter> geometry;
+    internal::RasterPosition                                     firstVertex;
+    int                                                          label;
+  };
+  std::vector<OutputPolygon> outputPolygons;
+
+  // Y coordinates of the borders between strips
+  std::vector<double> borders;
+  for (unsigned int s = 1; s < strips.size(); ++s)
+  {
+    OriginType firstLineCenter;
+    input->TransformIndexToPhysicalPoint(strips[s].GetIndex(), firstLineCenter);
+    borders.push_back(firstLineCenter[1] - 0.5 * input->GetSignedSpacing()[1]);
+  }
+
+  // Fragments of polygons touching a border between strips
+  struct Fragment
+  {
+    std::unique_ptr<OGRGeometry, ogr::internal::GeometryDeleter> geometry;
+    OGREnvelope                                                  envelope;
+    int                                                          label;
+  };
+  std::vector<Fragment> fragments;
+  // fragments touching each border from above and from below, by label
+  std::vector<std::map<int, std::vector<std::size_t>>> above(borders.size()), below(borders.size());
+
+  for (unsigned int s = 0; s < strips.size(); ++s)
+  {
+    OGRLayerType layer   = stripData[s]->GetLayer(0);
+    ogr::Feature feature = layer.ogr().GetNextFeature();
+    bool         goesOn  = feature.addr() != 0;
+    while (goesOn)
+    {
+      const int   label    = feature.ogr().GetFieldAsInteger(0);
+      OGRPolygon* polygon  = dynamic_cast<OGRPolygon*>(feature.ogr().GetGeometryRef());
+      OGREnvelope envelope;
+      if (polygon)
+      {
+        polygon->getEnvelope(&envelope);
+      }
+      // The polygons of a strip lie on one side of its borders
+      const bool touchesTop    = polygon && s > 0 && (std::abs(envelope.MinY - borders[s - 1]) < toleranceY || std::abs(envelope.MaxY - borders[s - 1]) < toleranceY);
+      const bool touchesBottom = polygon && s + 1 < strips.size() && (std::abs(envelope.MinY - borders[s]) < toleranceY || std::abs(envelope.MaxY - borders[s]) < toleranceY);
+
+      if (!touchesTop && !touchesBottom)
+      {
+        // Interior polygon: final
+        OutputPolygon outputPolygon;
+        outputPolygon.firstVertex = internal::RasterPosition(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+        if (polygon)
+        {
+          internal::StartRingsOnFirstVertex(*polygon, signX, signY);
+          outputPolygon.firstVertex = internal::GetFirstVertexPosition(*polygon, signX, signY);
+        }
+        outputPolygon.geometry.reset(feature.StealGeometry().release());
+        outputPolygon.label = label;
+        outputPolygons.push_back(std::move(outputPolygon));
+      }
+      else
+      {
+        if (touchesTop)
+        {
+          internal::SnapPolygonToLine(*polygon, borders[s - 1], toleranceY);
+          below[s - 1][label].push_back(fragments.size());
+        }
+        if (touchesBottom)
+        {
+          internal::SnapPolygonToLine(*polygon, borders[s], toleranceY);
+          above[s][label].push_back(fragments.size());
+        }
+        Fragment fragment;
+        fragment.geometry.reset(feature.StealGeometry().release());
+        fragment.geometry->getEnvelope(&fragment.envelope);
+        fragment.label = label;
+        fragments.push_back(std::move(fragment));
+      }
+
+      feature = layer.ogr().GetNextFeature();
+      goesOn  = feature.addr() != 0;
+    }
+  }
+
+  // Union-find of the fragments sharing an edge across a border
+  std::vector<std::size_t> parent(fragments.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto root = [&parent](std::size_t i) {
+    while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i         = parent[i];
+    }
+    return i;
+  };
+
+  for (unsigned int b = 0; b < borders.size(); ++b)
+  {
+    for (const auto& labelFragments : above[b])
+    {
+      auto lowerIt = below[b].find(labelFragments.first);
+      if (lowerIt == below[b].end())
+      {
+        continue;
+      }
+      for (std::size_t u : labelFragments.second)
+      {
+        for (std::size_t l : lowerIt->second)
+        {
+          const OGREnvelope& ue = fragments[u].envelope;
+          const OGREnvelope& le = fragments[l].envelope;
+          if (ue.MaxX - le.MinX < toleranceX || le.MaxX - ue.MinX < toleranceX || root(u) == root(l))
+          {
+            continue;
+          }
+          // 4-connected fragments are merged when they share an edge, not a corner
+          ogr::UniqueGeometryPtr intersection = ogr::Intersection(*fragments[u].geometry, *fragments[l].geometry);
+          if (intersection && intersection->getDimension() >= 1)
+          {
+            parent[root(l)] = root(u);
+          }
+        }
+      }
+    }
+  }
+
+  std::map<std::size_t, std::vector<std::size_t>> polygons;
+  for (std::size_t f = 0; f < fragments.size(); ++f)
+  {
+    polygons[root(f)].push_back(f);
+  }
+
+  for (const auto& polygon : polygons)
+  {
+    const std::vector<std::size_t>& members = polygon.second;
+    OutputPolygon                   outputPolygon;
+    if (members.size() == 1)
+    {
+      outputPolygon.geometry = std::move(fragments[members[0]].geometry);
+    }
+    else
+    {
+      // The merged polygon keeps the orientation given by GDALPolygonize()
+      const bool exteriorClockwise = static_cast<OGRPolygon&>(*fragments[members[0]].geometry).getExteriorRing()->isClockwise() != 0;
+
+      ogr::UniqueGeometryPtr merged = ogr::Union(*fragments[members[0]].geometry, *fragments[members[1]].geometry);
+      for (std::size_t m = 2; m < members.size(); ++m)
+      {
+        merged = ogr::Union(*merged, *fragments[members[m]].geometry);
+      }
+      if (OGRPolygon* mergedPolygon = dynamic_cast<OGRPolygon*>(merged.get()))
+      {
+        internal::RemoveCollinearPoints(*mergedPolygon);
+        internal::OrientRings(*mergedPolygon, exteriorClockwise);
+      }
+      outputPolygon.geometry.reset(merged.release());
+    }
+
+    OGRPolygon* outputGeometry = dynamic_cast<OGRPolygon*>(outputPolygon.geometry.get());
+    outputPolygon.firstVertex  = internal::RasterPosition(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    if (outputGeometry)
+    {
+      internal::StartRingsOnFirstVertex(*outputGeometry, signX, signY);
+      outputPolygon.firstVertex = internal::GetFirstVertexPosition(*outputGeometry, signX, signY);
+    }
+    outputPolygon.label = fragments[members[0]].label;
+    outputPolygons.push_back(std::move(outputPolygon));
+  }
+
+  // The first pixels of 4-connected polygons are all different
+  std::sort(outputPolygons.begin(), outputPolygons.end(),
+            [](const OutputPolygon& a, const OutputPolygon& b) { return a.firstVertex < b.firstVertex; });
+  for (OutputPolygon& outputPolygon : outputPolygons)
+  {
+    ogr::Feature dstFeature(outputLayer.GetLayerDefn());
+    dstFeature.SetGeometryDirectly(ogr::UniqueGeometryPtr(outputPolygon.geometry.release()));
+    dstFeature.ogr().SetField(0, outputPolygon.label);
+    outputLayer.CreateFeature(dstFeature);
+  }
+}
 
 } // end namespace otb
 
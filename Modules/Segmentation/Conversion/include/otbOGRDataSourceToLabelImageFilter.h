@@ -28,6 +28,7 @@
 #include "gdal.h"
 #include "gdal_alg.h"
 #include "otbOGRDataSourceWrapper.h"
+#include "otbOGRGeometriesRasterizer.h"
 #include <string>
 
 namespace otb
@@ -52,6 +53,10 @@ namespace otb
  *    - Setting the Origin/Size/Spacing of the output image
  *    - Using an existing image as support via SetOutputParametersFromImage(ImageBase)
  *
+ *  The geometries are read once per update and indexed (see
+ *  ogr::GeometriesRasterizer); each thread then only rasterizes the
+ *  geometries intersecting its own part of the requested region.
+ *
  *
  * \ingroup OTBConversion
  */
@@ -147,7 +152,9 @@ public:
   void SetOutputParametersFromImage(const ImagePointerType image);
 
 protected:
-  void GenerateData() override;
+  void BeforeThreadedGenerateData() override;
+
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
 
   OGRDataSourceToLabelImageFilter();
   ~OGRDataSourceToLabelImageFilter() override = default;
@@ -163,6 +170,10 @@ private:
   std::vector<OGRLayerH> m_SrcDataSetLayers;
   std::vector<int>       m_BandsToBurn;
 
+  // Geometries of m_SrcDataSetLayers, read once per update
+  ogr::GeometriesRasterizer m_Rasterizer;
+  bool                      m_RasterizerUpToDate;
+
   // Field used to extract the burn value
   std::string m_BurnAttribute;
 
@@ -37,7 +37,8 @@ namespace otb
 {
 template <class TOutputImage>
 OGRDataSourceToLabelImageFilter<TOutputImage>::OGRDataSourceToLabelImageFilter()
-  : m_BurnAttribute("DN"), m_BackgroundValue(0), m_ForegroundValue(255), m_BurnAttributeMode(true), m_AllTouchedMode(false)
+  : m_BurnAttribute("DN"), m_BackgroundValue(0), m_ForegroundValue(255), m_BurnAttributeMode(true), m_AllTouchedMode(false),
+    m_RasterizerUpToDate(false)
 {
   this->SetNumberOfRequiredInputs(1);
 
@@ -135,6 +136,8 @@ void OGRDataSourceToLabelImageFilter<TOutputImage>::GenerateOutputInformation()
   outputPtr->SetProjectionRef(this->GetOutputProjectionRef());
  
   // Generate the OGRLayers from the input OGRDataSource
+  m_SrcDataSetLayers.clear();
+  m_RasterizerUpToDate = false;
   for (unsigned int idx = 0; idx < this->GetNumberOfInputs(); ++idx)
   {
     OGRDataSourcePointerType ogrDS    = dynamic_cast<OGRDataSourceType*>(this->itk::ProcessObject::GetInput(idx));
@@ -157,25 +160,55 @@ void OGRDataSourceToLabelImageFilter<TOutputImage>::GenerateOutputInformation()
 }
 
 template <class TOutputImage>
-void OGRDataSourceToLabelImageFilter<TOutputImage>::GenerateData()
+void OGRDataSourceToLabelImageFilter<TOutputImage>::BeforeThreadedGenerateData()
 {
-  // Call Superclass GenerateData
-  this->AllocateOutputs();
-
-  // Get the buffered region
-  OutputImageRegionType bufferedRegion = this->GetOutput()->GetBufferedRegion();
-
   // nb bands
   const unsigned int& nbBands = this->GetOutput()->GetNumberOfComponentsPerPixel();
 
+  m_BandsToBurn.clear();
+  for (unsigned int band = 0; band < nbBands; ++band)
+  {
+    m_BandsToBurn.push_back(band + 1);
+  }
+
+  // Read and index the geometries only once for all the streaming divisions
+  if (!m_RasterizerUpToDate)
+  {
+    m_Rasterizer.Clear();
+    const std::vector<double> foreground(nbBands, m_ForegroundValue);
+    for (OGRLayerH layer : m_SrcDataSetLayers)
+    {
+      m_Rasterizer.AddLayer(*reinterpret_cast<OGRLayer*>(layer), this->GetOutput()->GetProjectionRef(), foreground, m_BurnAttributeMode ? m_BurnAttribute : "");
+    }
+    m_Rasterizer.BuildIndex();
+    m_RasterizerUpToDate = true;
+  }
+
   // register drivers
   GDALAllRegister();
+}
+
+template <class TOutputImage>
+void OGRDataSourceToLabelImageFilter<TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType itkNotUsed(threadId))
+{
+  OutputImageType* outputPtr = this->GetOutput();
+
+  // Get the buffered region
+  OutputImageRegionType bufferedRegion = outputPtr->GetBufferedRegion();
+
+  // nb bands
+  const unsigned int& nbBands = outputPtr->GetNumberOfComponentsPerPixel();
+
+  // The MEM dataset only covers the region of this thread, lines are
+  // still those of the whole buffer
+  OutputImageInternalPixelType* regionPointer =
+      outputPtr->GetBufferPointer() + outputPtr->ComputeOffset(outputRegionForThread.GetIndex()) * nbBands;
 
   std::ostringstream stream;
   stream << "MEM:::"
-         << "DATAPOINTER=" << (uintptr_t)(this->GetOutput()->GetBufferPointer()) << ","
-         << "PIXELS=" << bufferedRegion.GetSize()[0] << ","
-         << "LINES=" << bufferedRegion.GetSize()[1] << ","
+         << "DATAPOINTER=" << (uintptr_t)(regionPointer) << ","
+         << "PIXELS=" << outputRegionForThread.GetSize()[0] << ","
+         << "LINES=" << outputRegionForThread.GetSize()[1] << ","
          << "BANDS=" << nbBands << ","
          << "DATATYPE=" << GDALGetDataTypeName(GdalDataTypeBridge::GetGDALDataType<OutputImageInternalPixelType>()) << ","
          << "PIXELOFFSET=" << sizeof(OutputImageInternalPixelType) * nbBands << ","
@@ -184,8 +217,10 @@ void OGRDataSourceToLabelImageFilter<TOutputImage>::GenerateData()
 
   GDALDatasetH dataset = GDALOpen(stream.str().c_str(), GA_Update);
 
-  // Add the projection ref to the dataset
-  GDALSetProjection(dataset, this->GetOutput()->GetProjectionRef().c_str());
+  if (dataset == nullptr)
+  {
+    itkExceptionMacro(<< "Failed to create the in-memory dataset for region " << outputRegionForThread << ": " << CPLGetLastErrorMsg());
+  }
 
   // Set the nodata value
   for (unsigned int band = 0; band < nbBands; ++band)
@@ -197,42 +232,34 @@ void OGRDataSourceToLabelImageFilter<TOutputImage>::GenerateData()
   // add the geoTransform to the dataset
   itk::VariableLengthVector<double> geoTransform(6);
 
-  // Reporting origin and spacing of the buffered region
-  // the spacing is unchanged, the origin is relative to the buffered region
-  OutputIndexType  bufferIndexOrigin = bufferedRegion.GetIndex();
-  OutputOriginType bufferOrigin;
-  this->GetOutput()->TransformIndexToPhysicalPoint(bufferIndexOrigin, bufferOrigin);
-  geoTransform[0] = bufferOrigin[0] - 0.5 * this->GetOutput()->GetSignedSpacing()[0];
-  geoTransform[3] = bufferOrigin[1] - 0.5 * this->GetOutput()->GetSignedSpacing()[1];
-  geoTransform[1] = this->GetOutput()->GetSignedSpacing()[0];
-  geoTransform[5] = this->GetOutput()->GetSignedSpacing()[1];
+  // Reporting origin and spacing of the thread region
+  // the spacing is unchanged, the origin is relative to the thread region
+  OutputIndexType  regionIndexOrigin = outputRegionForThread.GetIndex();
+  OutputOriginType regionOrigin;
+  outputPtr->TransformIndexToPhysicalPoint(regionIndexOrigin, regionOrigin);
+  geoTransform[0] = regionOrigin[0] - 0.5 * outputPtr->GetSignedSpacing()[0];
+  geoTransform[3] = regionOrigin[1] - 0.5 * outputPtr->GetSignedSpacing()[1];
+  geoTransform[1] = outputPtr->GetSignedSpacing()[0];
+  geoTransform[5] = outputPtr->GetSignedSpacing()[1];
 
   // FIXME: Here component 1 and 4 should be replaced by the orientation parameters
   geoTransform[2] = 0.;
   geoTransform[4] = 0.;
   GDALSetGeoTransform(dataset, const_cast<double*>(geoTransform.GetDataPointer()));
 
-  // Burn the geometries into the dataset
-  if (dataset != nullptr)
+  // Burn the geometries intersecting the region into the dataset
+  try
+  {
+    m_Rasterizer.Burn(dataset, m_BandsToBurn, m_AllTouchedMode);
+  }
+  catch (...)
   {
-    std::vector<std::string> options;
-
-    std::vector<double> foreground(nbBands * m_SrcDataSetLayers.size(), m_ForegroundValue);
-
-    if (m_BurnAttributeMode)
-    {
-      options.push_back("ATTRIBUTE=" + m_BurnAttribute);
-    }
-    if (m_AllTouchedMode)
-    {
-      options.push_back("ALL_TOUCHED=TRUE");
-    }
-
-    GDALRasterizeLayers(dataset, nbBands, &m_BandsToBurn[0], m_SrcDataSetLayers.size(), &(m_SrcDataSetLayers[0]), nullptr, nullptr, &foreground[0],
-                        ogr::StringListConverter(options).to_ogr(), nullptr, nullptr);
-    // release the dataset
     GDALClose(dataset);
+    throw;
   }
+
+  // release the dataset
+  GDALClose(dataset);
 }
 
 template <class TOutputImage>
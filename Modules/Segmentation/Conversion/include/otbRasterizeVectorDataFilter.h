@@ -27,6 +27,7 @@
 #include "otbMacro.h"
 
 #include "otbVectorData.h"
+#include "otbOGRGeometriesRasterizer.h"
 
 #include "gdal.h"
 #include "gdal_alg.h"
@@ -57,6 +58,10 @@ namespace otb
  *  projectionRef. Nothing is done in this class to reproject the
  *  VectorData into the image coordinate system.
  *
+ *  The geometries are read once per update and indexed (see
+ *  ogr::GeometriesRasterizer); each thread then only burns the
+ *  geometries intersecting its own part of the requested region.
+ *
  * \ingroup OTBConversion
  */
 template <class TVectorData, class TInputImage, class TOutputImage = TInputImage>
@@ -142,6 +147,10 @@ public:
 protected:
   void GenerateData() override;
 
+  void BeforeThreadedGenerateData() override;
+
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
   RasterizeVectorDataFilter();
   ~RasterizeVectorDataFilter() override
   {
@@ -169,6 +178,10 @@ private:
   std::vector<int>    m_BandsToBurn;
   bool                m_AllTouchedMode;
 
+  // Geometries of m_SrcDataSetLayers, read once per update
+  ogr::GeometriesRasterizer m_Rasterizer;
+  bool                      m_RasterizerUpToDate;
+
 }; // end of class RasterizeVectorDataFilter
 
 } // end of namespace otb
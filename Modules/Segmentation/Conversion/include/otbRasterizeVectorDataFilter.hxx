@@ -28,7 +28,8 @@
 namespace otb
 {
 template <class TVectorData, class TInputImage, class TOutputImage>
-RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::RasterizeVectorDataFilter() : m_OGRDataSourcePointer(nullptr), m_AllTouchedMode(false)
+RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::RasterizeVectorDataFilter()
+  : m_OGRDataSourcePointer(nullptr), m_AllTouchedMode(false), m_RasterizerUpToDate(false)
 {
   this->SetNumberOfRequiredInputs(1);
 }
@@ -54,6 +55,16 @@ void RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::Generate
 {
   Superclass::GenerateOutputInformation();
 
+  // Forget the layers of a previous update
+  m_SrcDataSetLayers.clear();
+  m_FullBurnValues.clear();
+  m_RasterizerUpToDate = false;
+  if (m_OGRDataSourcePointer != nullptr)
+  {
+    GDALClose(m_OGRDataSourcePointer);
+    m_OGRDataSourcePointer = nullptr;
+  }
+
   // Generate the OGRLayers from the input VectorDatas
   // iteration begin from 1 cause the 0th input is a image
   for (unsigned int idx = 1; idx < this->GetNumberOfInputs(); ++idx)
@@ -131,23 +142,74 @@ void RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::Generate
 template <class TVectorData, class TInputImage, class TOutputImage>
 void RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::GenerateData()
 {
-  // Call Superclass GenerateData
-  Superclass::GenerateData();
+  // itk::CastImageFilter skips the threaded part when running in place:
+  // go through the standard threaded execution so that geometries are
+  // still burnt in parallel.
+  itk::ImageSource<TOutputImage>::GenerateData();
+}
 
-  // Get the buffered region
-  OutputImageRegionType bufferedRegion = this->GetOutput()->GetBufferedRegion();
+template <class TVectorData, class TInputImage, class TOutputImage>
+void RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
 
-  // nb bands
-  unsigned int nbBands = this->GetOutput()->GetNumberOfComponentsPerPixel();
+  // Read and index the geometries only once for all the streaming divisions
+  if (!m_RasterizerUpToDate)
+  {
+    m_Rasterizer.Clear();
+    const unsigned int nbBands = m_BandsToBurn.size();
+    for (unsigned int idx = 0; idx < m_SrcDataSetLayers.size(); ++idx)
+    {
+      // Burn values of layer idx, as expected by GDALRasterizeLayers
+      std::vector<double> layerBurnValues(nbBands, 0.);
+      for (unsigned int band = 0; band < nbBands && idx * nbBands + band < m_FullBurnValues.size(); ++band)
+      {
+        layerBurnValues[band] = m_FullBurnValues[idx * nbBands + band];
+      }
+      // The geometries are reprojected once into the output spatial reference
+      m_Rasterizer.AddLayer(*reinterpret_cast<OGRLayer*>(m_SrcDataSetLayers[idx]), this->GetOutput()->GetProjectionRef(), layerBurnValues);
+    }
+    m_Rasterizer.BuildIndex();
+    m_RasterizerUpToDate = true;
+  }
 
   // register drivers
   GDALAllRegister();
+}
+
+template <class TVectorData, class TInputImage, class TOutputImage>
+void RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                            itk::ThreadIdType              threadId)
+{
+  // Cast the input pixels, unless the output is the input buffer itself
+  if (!(this->GetInPlace() && this->CanRunInPlace()))
+  {
+    Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+  }
+
+  if (m_BandsToBurn.empty())
+  {
+    return;
+  }
+
+  OutputImageType* outputPtr = this->GetOutput();
+
+  // Get the buffered region
+  OutputImageRegionType bufferedRegion = outputPtr->GetBufferedRegion();
+
+  // nb bands
+  unsigned int nbBands = outputPtr->GetNumberOfComponentsPerPixel();
+
+  // The MEM dataset only covers the region of this thread, lines are
+  // still those of the whole buffer
+  OutputImageInternalPixelType* regionPointer =
+      outputPtr->GetBufferPointer() + outputPtr->ComputeOffset(outputRegionForThread.GetIndex()) * nbBands;
 
   std::ostringstream stream;
   stream << "MEM:::"
-         << "DATAPOINTER=" << (uintptr_t)(this->GetOutput()->GetBufferPointer()) << ","
-         << "PIXELS=" << bufferedRegion.GetSize()[0] << ","
-         << "LINES=" << bufferedRegion.GetSize()[1] << ","
+         << "DATAPOINTER=" << (uintptr_t)(regionPointer) << ","
+         << "PIXELS=" << outputRegionForThread.GetSize()[0] << ","
+         << "LINES=" << outputRegionForThread.GetSize()[1] << ","
          << "BANDS=" << nbBands << ","
          << "DATATYPE=" << GDALGetDataTypeName(GdalDataTypeBridge::GetGDALDataType<OutputImageInternalPixelType>()) << ","
          << "PIXELOFFSET=" << sizeof(OutputImageInternalPixelType) * nbBands << ","
@@ -156,44 +218,42 @@ void RasterizeVectorDataFilter<TVectorData, TInputImage, TOutputImage>::Generate
 
   GDALDatasetH dataset = GDALOpen(stream.str().c_str(), GA_Update);
 
-  // Add the projection ref to the dataset
-  GDALSetProjection(dataset, this->GetOutput()->GetProjectionRef().c_str());
+  if (dataset == nullptr)
+  {
+    itkExceptionMacro(<< "Failed to create the in-memory dataset for region " << outputRegionForThread << ": " << CPLGetLastErrorMsg());
+  }
 
   // add the geoTransform to the dataset
   itk::VariableLengthVector<double> geoTransform(6);
 
-  // Reporting origin and spacing of the buffered region
-  // the spacing is unchanged, the origin is relative to the buffered region
-  InputIndexType bufferIndexOrigin = bufferedRegion.GetIndex();
-  InputPointType bufferOrigin;
-  this->GetOutput()->TransformIndexToPhysicalPoint(bufferIndexOrigin, bufferOrigin);
-  geoTransform[0] = bufferOrigin[0] - 0.5 * this->GetOutput()->GetSignedSpacing()[0];
-  geoTransform[3] = bufferOrigin[1] - 0.5 * this->GetOutput()->GetSignedSpacing()[1];
-  geoTransform[1] = this->GetOutput()->GetSignedSpacing()[0];
-  geoTransform[5] = this->GetOutput()->GetSignedSpacing()[1];
+  // Reporting origin and spacing of the thread region
+  // the spacing is unchanged, the origin is relative to the thread region
+  InputIndexType regionIndexOrigin = outputRegionForThread.GetIndex();
+  InputPointType regionOrigin;
+  outputPtr->TransformIndexToPhysicalPoint(regionIndexOrigin, regionOrigin);
+  geoTransform[0] = regionOrigin[0] - 0.5 * outputPtr->GetSignedSpacing()[0];
+  geoTransform[3] = regionOrigin[1] - 0.5 * outputPtr->GetSignedSpacing()[1];
+  geoTransform[1] = outputPtr->GetSignedSpacing()[0];
+  geoTransform[5] = outputPtr->GetSignedSpacing()[1];
 
   // FIXME: Here component 1 and 4 should be replaced by the orientation parameters
   geoTransform[2] = 0.;
   geoTransform[4] = 0.;
   GDALSetGeoTransform(dataset, const_cast<double*>(geoTransform.GetDataPointer()));
 
-  char** options = nullptr;
-  if (m_AllTouchedMode)
+  // Burn the geometries intersecting the region into the dataset
+  try
   {
-    options = CSLSetNameValue(options, "ALL_TOUCHED", "TRUE");
+    m_Rasterizer.Burn(dataset, m_BandsToBurn, m_AllTouchedMode);
   }
-
-  // Burn the geometries into the dataset
-  if (dataset != nullptr)
+  catch (...)
   {
-    GDALRasterizeLayers(dataset, m_BandsToBurn.size(), &(m_BandsToBurn[0]), m_SrcDataSetLayers.size(), &(m_SrcDataSetLayers[0]), nullptr, nullptr,
-                        &(m_FullBurnValues[0]), options, GDALDummyProgress, nullptr);
-
-    CSLDestroy(options);
-
-    // release the dataset
     GDALClose(dataset);
+    throw;
   }
+
+  // release the dataset
+  GDALClose(dataset);
 }
 
 template <class TVectorData, class TInputImage, class TOutputImage>
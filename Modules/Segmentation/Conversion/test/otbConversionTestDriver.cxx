@@ -26,6 +26,7 @@ void RegisterTests()
   REGISTER_TEST(otbOGRDataSourceToLabelImageFilter);
   REGISTER_TEST(otbLabelImageToVectorDataFilter);
   REGISTER_TEST(otbLabelImageToOGRDataSourceFilter);
+  REGISTER_TEST(otbLabelImageToOGRDataSourceFilterStrips);
   REGISTER_TEST(otbVectorDataToLabelImageFilter);
   REGISTER_TEST(otbPolygonizationRasterizationTest);
   REGISTER_TEST(otbVectorDataRasterizeFilter);
@@ -23,6 +23,14 @@
 #include "otbImage.h"
 #include "otbImageFileReader.h"
 #include "otbVectorDataFileWriter.h"
+#include "otbOGRFeatureWrapper.h"
+#include "otbOGRGeometryWrapper.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
 
 
 int otbLabelImageToOGRDataSourceFilter(int argc, char* argv[])
@@ -52,5 +60,129 @@ int otbLabelImageToOGRDataSourceFilter(int argc, char* argv[])
   filter->Update();
 
 
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+typedef otb::Image<unsigned int, 2> StripLabelImageType;
+typedef otb::LabelImageToOGRDataSourceFilter<StripLabelImageType> StripFilterType;
+
+StripFilterType::Pointer PolygonizeByStrips(StripLabelImageType* image, unsigned int nbLines, unsigned int nbThreads)
+{
+  StripFilterType::Pointer filter = StripFilterType::New();
+  filter->SetInput(image);
+  filter->SetNumberOfLinesPerStrip(nbLines);
+  filter->SetNumberOfThreads(nbThreads);
+  filter->Update();
+  return filter;
+}
+}
+
+int otbLabelImageToOGRDataSourceFilterStrips(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  // Diagonal bands cut by a ring around a disk, all of them crossing the
+  // borders between the strips
+  StripLabelImageType::SizeType size;
+  size[0] = 200;
+  size[1] = 300;
+  StripLabelImageType::RegionType region;
+  region.SetSize(size);
+  StripLabelImageType::Pointer image = StripLabelImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<StripLabelImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const long   x        = it.GetIndex()[0];
+    const long   y        = it.GetIndex()[1];
+    const double distance = std::sqrt(static_cast<double>((x - 100) * (x - 100) + (y - 150) * (y - 150)));
+    if (distance < 30.)
+    {
+      it.Set(10);
+    }
+    else if (distance < 50.)
+    {
+      it.Set(9);
+    }
+    else
+    {
+      it.Set(1 + ((x + y / 2) / 15) % 5);
+    }
+  }
+
+  // At once, by 4 strips of 75 lines with several threads, and with one thread
+  StripFilterType::Pointer single  = PolygonizeByStrips(image, 0, 4);
+  StripFilterType::Pointer strips  = PolygonizeByStrips(image, 64, 4);
+  StripFilterType::Pointer strips1 = PolygonizeByStrips(image, 64, 1);
+  otb::ogr::Layer          layer   = const_cast<otb::ogr::DataSource*>(single->GetOutput())->GetLayer(0);
+  otb::ogr::Layer          layerN  = const_cast<otb::ogr::DataSource*>(strips->GetOutput())->GetLayer(0);
+  otb::ogr::Layer          layerN1 = const_cast<otb::ogr::DataSource*>(strips1->GetOutput())->GetLayer(0);
+
+  if (layerN.GetFeatureCount(true) != layer.GetFeatureCount(true) || layerN1.GetFeatureCount(true) != layer.GetFeatureCount(true))
+  {
+    std::cerr << "Wrong number of polygons: " << layerN.GetFeatureCount(true) << " and " << layerN1.GetFeatureCount(true) << " by strips, "
+              << layer.GetFeatureCount(true) << " at once" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Polygons at once, by label
+  std::multimap<int, std::shared_ptr<OGRGeometry>> reference;
+  for (otb::ogr::Layer::const_iterator f = layer.cbegin(); f != layer.cend(); ++f)
+  {
+    reference.insert(std::make_pair(f->ogr().GetFieldAsInteger(0), std::shared_ptr<OGRGeometry>(f->GetGeometry()->clone(), OGRGeometryFactory::destroyGeometry)));
+  }
+
+  double                          previousTop = -1.;
+  otb::ogr::Layer::const_iterator f1          = layerN1.cbegin();
+  for (otb::ogr::Layer::const_iterator f = layerN.cbegin(); f != layerN.cend(); ++f, ++f1)
+  {
+    // The output doesn't depend on the number of threads
+    char* wkt  = nullptr;
+    char* wkt1 = nullptr;
+    f->GetGeometry()->exportToWkt(&wkt);
+    f1->GetGeometry()->exportToWkt(&wkt1);
+    const bool sameWkt = std::string(wkt) == std::string(wkt1);
+    CPLFree(wkt);
+    CPLFree(wkt1);
+    if (!sameWkt || f->ogr().GetFieldAsInteger(0) != f1->ogr().GetFieldAsInteger(0))
+    {
+      std::cerr << "Feature " << f->GetFID() << " depends on the number of threads" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Features are sorted by their first line
+    OGREnvelope envelope;
+    f->GetGeometry()->getEnvelope(&envelope);
+    if (envelope.MinY < previousTop)
+    {
+      std::cerr << "Feature " << f->GetFID() << " is not sorted by its first pixel" << std::endl;
+      return EXIT_FAILURE;
+    }
+    previousTop = envelope.MinY;
+
+    // Same polygon and area as the ones polygonized at once
+    const OGRPolygon& polygon = dynamic_cast<const OGRPolygon&>(*f->GetGeometry());
+    auto              range   = reference.equal_range(f->ogr().GetFieldAsInteger(0));
+    auto              match   = range.first;
+    while (match != range.second && !otb::ogr::Equals(polygon, *match->second))
+    {
+      ++match;
+    }
+    if (match == range.second)
+    {
+      std::cerr << "Feature " << f->GetFID() << " of label " << f->ogr().GetFieldAsInteger(0) << " doesn't match any polygon computed at once"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    const double area = dynamic_cast<const OGRPolygon&>(*match->second).get_Area();
+    if (std::abs(polygon.get_Area() - area) > 1e-9 * area)
+    {
+      std::cerr << "Feature " << f->GetFID() << " has an area of " << polygon.get_Area() << " instead of " << area << std::endl;
+      return EXIT_FAILURE;
+    }
+    reference.erase(match);
+  }
+
   return EXIT_SUCCESS;
 }
@@ -22,6 +22,8 @@
 #define otbWrapperApplicationRegistry_h
 
 #include <string>
+#include <utility>
+#include <vector>
 #include "itkObject.h"
 
 #include "otbWrapperApplication.h"
@@ -55,6 +57,21 @@ public:
   /** Convenient typedefs. */
   typedef otb::Wrapper::Application::Pointer ApplicationPointer;
 
+  /** Description of an application, as stored in the manifest of its
+   * directory */
+  struct ManifestEntry
+  {
+    /** Application name */
+    std::string Name;
+    /** Path of the application module */
+    std::string Library;
+    /** Short description of the application */
+    std::string Description;
+    /** Parameter keys, with their type (see \c
+     * ParameterGroup::GetParameterTypeAsString()) */
+    std::vector<std::pair<std::string, std::string>> Parameters;
+  };
+
   /** Set the specified path to the list of application search path. Reinit all previously set paths */
   static void SetApplicationPath(std::string path);
 
@@ -64,9 +81,36 @@ public:
   /** Return the application search path */
   static std::string GetApplicationPath();
 
-  /** Return the list of available applications */
+  /** Return the list of available applications.
+   * Applications found in the search path are listed from the manifests of
+   * their directories, see \c GetApplicationManifest(). */
   static std::vector<std::string> GetAvailableApplications(bool useFactory = true);
 
+  /** Return the description of the applications found in the search path.
+   *
+   * The description of the applications of each directory of the search
+   * path is cached in a manifest file of the user (\c GetManifestPath()),
+   * so that application modules are only loaded when the manifest is
+   * missing, or when the size or the modification time of one of them
+   * changed. In that case, the manifest is generated again. Application
+   * directories are never written, they may be read-only.
+   */
+  static std::vector<ManifestEntry> GetApplicationManifest();
+
+  /** Generate the manifest of a directory, loading all its application
+   * modules.
+   * \return false if the manifest can't be written
+   */
+  static bool UpdateManifest(const std::string& directory);
+
+  /** Path of the manifest of an application directory, in the cache
+   * directory of the user: \c $XDG_CACHE_HOME/otb/applications, or \c
+   * $HOME/.cache/otb/applications (\c %LOCALAPPDATA%/otb/applications on
+   * Windows).
+   * \return an empty string if there is no cache directory
+   */
+  static std::string GetManifestPath(const std::string& directory);
+
   /** Create the specified Application */
   static Application::Pointer CreateApplication(const std::string& applicationName, bool useFactory = true);
 
@@ -87,6 +131,13 @@ private:
 
   /** Load an application from a shared library */
   static Application::Pointer LoadApplicationFromPath(std::string path, std::string name);
+
+  /** Describe all the applications of a directory, loading their modules */
+  static std::vector<ManifestEntry> ScanDirectory(const std::string& directory);
+
+  /** Write the manifest of a directory, with the current signature of its
+   * modules */
+  static bool WriteManifest(const std::string& directory, const std::vector<ManifestEntry>& entries);
 };
 
 } // end namespace Wrapper
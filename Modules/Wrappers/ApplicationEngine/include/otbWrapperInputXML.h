@@ -37,6 +37,12 @@ OTBApplicationEngine_EXPORT const std::string GetChildNodeTextOf(TiXmlElement* p
 
 OTBApplicationEngine_EXPORT int Read(const std::string& filename, Application::Pointer application);
 
+/** Sets the parameters of an application from an already parsed document */
+OTBApplicationEngine_EXPORT int Read(TiXmlDocument& doc, Application::Pointer application);
+
+/** Name of the application a parameter document was generated for */
+OTBApplicationEngine_EXPORT std::string GetApplicationName(TiXmlDocument& doc);
+
 /* copied from Utilities/tinyXMLlib/tinyxml.cpp. Must have a FIX inside tinyxml.cpp */
 OTBApplicationEngine_EXPORT FILE* TiXmlFOpen(const char* filename, const char* mode);
 
@@ -888,7 +888,8 @@ void Application::WriteOutput()
   if (m_MultiWriting)
     {
     multiWriter = otb::MultiImageFileWriter::New();
-    multiWriter->SetAutomaticStrippedStreaming(ram);
+    // Adaptative streaming aligns the divisions on the blocks of the outputs
+    multiWriter->SetAutomaticAdaptativeStreaming(ram);
     }
   
   for (auto const & key : paramList)
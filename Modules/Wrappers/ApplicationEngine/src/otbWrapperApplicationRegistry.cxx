@@ -27,7 +27,18 @@
 #include "itkMutexLock.h"
 #include "itkMutexLockHolder.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iterator>
+#include <map>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 namespace otb
 {
@@ -265,86 +276,364 @@ Application::Pointer ApplicationRegistry::CreateApplicationFaster(const std::str
 
 std::vector<std::string> ApplicationRegistry::GetAvailableApplications(bool useFactory)
 {
-  ApplicationPointer    appli;
   std::set<std::string> appSet;
 
-  std::string appPrefix("otbapp_");
+  for (auto const& entry : GetApplicationManifest())
+  {
+    appSet.insert(entry.Name);
+  }
+
+  if (useFactory)
+  {
+    std::list<LightObject::Pointer> allobjects = itk::ObjectFactoryBase::CreateAllInstance("otbWrapperApplication");
+    // Downcast and Sanity check
+    for (std::list<LightObject::Pointer>::iterator i = allobjects.begin(); i != allobjects.end(); ++i)
+    {
+      Application* app = dynamic_cast<Application*>(i->GetPointer());
+      if (app)
+      {
+        app->Init();
+        std::string curName(app->GetName());
+        appSet.insert(curName);
+      }
+    }
+  }
+
+  std::vector<std::string> appVec;
+  std::copy(appSet.begin(), appSet.end(), std::back_inserter(appVec));
+  return appVec;
+}
+
+namespace
+{
+const char ManifestHeader[] = "# OTB applications manifest v2";
+
+std::string GetApplicationExtension()
+{
   std::string appExtension = itksys::DynamicLoader::LibExtension();
 #ifdef __APPLE__
   appExtension = ".dylib";
 #endif
+  return appExtension;
+}
 
-#if defined(WIN32)
-  const char pathSeparator = ';';
+std::string JoinPath(std::string directory, const std::string& filename)
+{
+#ifdef _WIN32
+  const char sep = '\\';
 #else
-  const char       pathSeparator = ':';
+  const char sep = '/';
+#endif
+  if (!directory.empty() && directory[directory.size() - 1] != sep)
+  {
+    directory.push_back(sep);
+  }
+  return directory + filename;
+}
+
+/** Application modules of a directory (file names, sorted) */
+std::vector<std::string> ListApplicationLibraries(const std::string& directory)
+{
+  const std::string appPrefix("otbapp_");
+  const std::string appExtension = GetApplicationExtension();
+
+  std::vector<std::string> libraries;
+  itk::Directory::Pointer  dir = itk::Directory::New();
+  if (!dir->Load(directory.c_str()))
+  {
+    return libraries;
+  }
+  for (unsigned int i = 0; i < dir->GetNumberOfFiles(); i++)
+  {
+    const std::string            sfilename(dir->GetFile(i));
+    const std::string::size_type extPos = sfilename.rfind(appExtension);
+    // Check if current file is a shared lib with the right pattern
+    if (extPos != std::string::npos && extPos + appExtension.size() == sfilename.size() && sfilename.find(appPrefix) == 0)
+    {
+      libraries.push_back(sfilename);
+    }
+  }
+  std::sort(libraries.begin(), libraries.end());
+  return libraries;
+}
+
+/** Size and modification time of a module, which change whenever it is
+ * rebuilt or reinstalled */
+std::string GetModuleSignature(const std::string& path)
+{
+  std::ostringstream signature;
+#ifdef _WIN32
+  signature << itksys::SystemTools::FileLength(path) << ":" << itksys::SystemTools::ModifiedTime(path);
+#else
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0)
+  {
+    return std::string();
+  }
+#ifdef __APPLE__
+  const long nanoseconds = status.st_mtimespec.tv_nsec;
+#else
+  const long nanoseconds = status.st_mtim.tv_nsec;
 #endif
+  signature << status.st_size << ":" << status.st_mtime << "." << nanoseconds;
+#endif
+  return signature.str();
+}
 
+/** Per-user directory of the manifests, empty if there is none */
+std::string GetManifestCacheDirectory()
+{
+  std::string cache;
 #ifdef _WIN32
-  const char sep = '\\';
+  itksys::SystemTools::GetEnv("LOCALAPPDATA", cache);
 #else
-  const char       sep           = '/';
+  if (!itksys::SystemTools::GetEnv("XDG_CACHE_HOME", cache) || cache.empty())
+  {
+    std::string home;
+    if (itksys::SystemTools::GetEnv("HOME", home) && !home.empty())
+    {
+      cache = JoinPath(home, ".cache");
+    }
+  }
+#endif
+  if (cache.empty())
+  {
+    return cache;
+  }
+  return JoinPath(JoinPath(cache, "otb"), "applications");
+}
+
+/** Removes the characters used as separators in the manifest */
+std::string CleanManifestField(std::string field)
+{
+  std::replace(field.begin(), field.end(), '\t', ' ');
+  std::replace(field.begin(), field.end(), '\n', ' ');
+  std::replace(field.begin(), field.end(), '\r', ' ');
+  return field;
+}
+
+/** Reads the manifest of a directory.
+ * \return false if the manifest is missing, invalid, or outdated
+ */
+bool ReadManifest(const std::string& directory, std::vector<ApplicationRegistry::ManifestEntry>& entries)
+{
+  entries.clear();
+  const std::string manifestPath = ApplicationRegistry::GetManifestPath(directory);
+  if (manifestPath.empty())
+  {
+    return false;
+  }
+  std::ifstream manifest(manifestPath);
+  std::string   line;
+  if (!manifest || !std::getline(manifest, line) || line != ManifestHeader || !std::getline(manifest, line) ||
+      line != itksys::SystemTools::CollapseFullPath(directory))
+  {
+    return false;
+  }
+
+  // One line per module: name, library, signature, description, parameters.
+  // Modules without application have an empty name.
+  std::map<std::string, std::string> signatures;
+  while (std::getline(manifest, line))
+  {
+    if (line.empty())
+    {
+      continue;
+    }
+    std::vector<std::string> fields;
+    std::istringstream       iss(line);
+    for (std::string field; std::getline(iss, field, '\t');)
+    {
+      fields.push_back(field);
+    }
+    if (fields.size() < 3)
+    {
+      return false;
+    }
+    signatures[fields[1]] = fields[2];
+    if (fields[0].empty())
+    {
+      continue;
+    }
+
+    ApplicationRegistry::ManifestEntry entry;
+    entry.Name    = fields[0];
+    entry.Library = JoinPath(directory, fields[1]);
+    if (fields.size() > 3)
+    {
+      entry.Description = fields[3];
+    }
+    if (fields.size() > 4)
+    {
+      std::istringstream params(fields[4]);
+      for (std::string param; std::getline(params, param, ';');)
+      {
+        const std::string::size_type pos = param.find('=');
+        entry.Parameters.emplace_back(param.substr(0, pos), pos == std::string::npos ? std::string() : param.substr(pos + 1));
+      }
+    }
+    entries.push_back(entry);
+  }
+
+  // The manifest shall list all the modules, as they are now
+  const std::vector<std::string> actualLibraries = ListApplicationLibraries(directory);
+  if (signatures.size() != actualLibraries.size())
+  {
+    return false;
+  }
+  for (auto const& library : actualLibraries)
+  {
+    auto signature = signatures.find(library);
+    if (signature == signatures.end() || signature->second != GetModuleSignature(JoinPath(directory, library)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+std::string ApplicationRegistry::GetManifestPath(const std::string& directory)
+{
+  const std::string cache = GetManifestCacheDirectory();
+  if (cache.empty())
+  {
+    return cache;
+  }
+  // FNV-1a hash of the directory, which is also written in the manifest
+  std::uint64_t     hash     = 14695981039346656037ULL;
+  const std::string fullPath = itksys::SystemTools::CollapseFullPath(directory);
+  for (unsigned char c : fullPath)
+  {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  std::ostringstream filename;
+  filename << "manifest_" << std::hex << hash << ".txt";
+  return JoinPath(cache, filename.str());
+}
+
+std::vector<ApplicationRegistry::ManifestEntry> ApplicationRegistry::ScanDirectory(const std::string& directory)
+{
+  const std::string appPrefix("otbapp_");
+  const std::string appExtension = GetApplicationExtension();
+
+  std::vector<ManifestEntry> entries;
+  for (auto const& library : ListApplicationLibraries(directory))
+  {
+    ManifestEntry entry;
+    entry.Library = JoinPath(directory, library);
+
+    const std::string  name  = library.substr(appPrefix.size(), library.size() - appPrefix.size() - appExtension.size());
+    ApplicationPointer appli = LoadApplicationFromPath(entry.Library, name);
+    if (appli.IsNotNull())
+    {
+      entry.Name        = name;
+      entry.Description = appli->GetDescription();
+      for (auto const& key : appli->GetParametersKeys(true))
+      {
+        entry.Parameters.emplace_back(key, appli->GetParameterList()->GetParameterTypeAsString(appli->GetParameterType(key)));
+      }
+    }
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+bool ApplicationRegistry::UpdateManifest(const std::string& directory)
+{
+  return WriteManifest(directory, ScanDirectory(directory));
+}
+
+std::vector<ApplicationRegistry::ManifestEntry> ApplicationRegistry::GetApplicationManifest()
+{
+#if defined(WIN32)
+  const char pathSeparator = ';';
+#else
+  const char pathSeparator = ':';
 #endif
 
+  std::vector<ManifestEntry>  result;
+  std::set<std::string>       names;
   std::string                 otbAppPath = GetApplicationPath();
   std::vector<itksys::String> pathList;
   if (!otbAppPath.empty())
   {
     pathList = itksys::SystemTools::SplitString(otbAppPath, pathSeparator, false);
   }
-  for (unsigned int k = 0; k < pathList.size(); ++k)
+  for (auto const& directory : pathList)
   {
-    itk::Directory::Pointer dir = itk::Directory::New();
-    if (!dir->Load(pathList[k].c_str()))
+    if (directory.empty() || !itksys::SystemTools::FileIsDirectory(directory))
     {
       continue;
     }
-    for (unsigned int i = 0; i < dir->GetNumberOfFiles(); i++)
+
+    std::vector<ManifestEntry> entries;
+    if (!ReadManifest(directory, entries))
     {
-      const char*            filename = dir->GetFile(i);
-      std::string            sfilename(filename);
-      std::string::size_type extPos    = sfilename.rfind(appExtension);
-      std::string::size_type prefixPos = sfilename.find(appPrefix);
+      otbLogMacro(Debug, << "Generating the application manifest of " << directory);
+      entries = ScanDirectory(directory);
+      // Without a cache directory, modules are scanned at each call
+      WriteManifest(directory, entries);
+    }
 
-      // Check if current file is a shared lib with the right pattern
-      if (extPos + appExtension.size() == sfilename.size() && prefixPos == 0)
+    // The first directory of the search path wins, as in CreateApplication()
+    for (auto const& entry : entries)
+    {
+      if (!entry.Name.empty() && names.insert(entry.Name).second)
       {
-        std::string name     = sfilename.substr(appPrefix.size(), extPos - appPrefix.size());
-        std::string fullpath = pathList[k];
-        if (!fullpath.empty() && fullpath[fullpath.size() - 1] != sep)
-        {
-          fullpath.push_back(sep);
-        }
-        fullpath.append(sfilename);
-        appli = LoadApplicationFromPath(fullpath, name);
-        if (appli.IsNotNull())
-        {
-          appSet.insert(name);
-        }
-        appli = nullptr;
+        result.push_back(entry);
       }
     }
   }
+  return result;
+}
 
-  if (useFactory)
+bool ApplicationRegistry::WriteManifest(const std::string& directory, const std::vector<ManifestEntry>& entries)
+{
+  const std::string manifestPath = GetManifestPath(directory);
+  if (manifestPath.empty() || !itksys::SystemTools::MakeDirectory(itksys::SystemTools::GetFilenamePath(manifestPath)))
   {
-    std::list<LightObject::Pointer> allobjects = itk::ObjectFactoryBase::CreateAllInstance("otbWrapperApplication");
-    // Downcast and Sanity check
-    for (std::list<LightObject::Pointer>::iterator i = allobjects.begin(); i != allobjects.end(); ++i)
+    return false;
+  }
+
+  // Write a temporary file and rename it, so that concurrent readers never
+  // see a partial manifest
+  std::ostringstream tmpPath;
+  tmpPath << manifestPath << "." << std::chrono::steady_clock::now().time_since_epoch().count() << ".tmp";
+  {
+    std::ofstream manifest(tmpPath.str());
+    if (!manifest)
     {
-      Application* app = dynamic_cast<Application*>(i->GetPointer());
-      if (app)
+      return false;
+    }
+    manifest << ManifestHeader << "\n" << itksys::SystemTools::CollapseFullPath(directory) << "\n";
+    for (auto const& entry : entries)
+    {
+      manifest << CleanManifestField(entry.Name) << "\t" << itksys::SystemTools::GetFilenameName(entry.Library) << "\t" << GetModuleSignature(entry.Library)
+               << "\t" << CleanManifestField(entry.Description) << "\t";
+      for (std::size_t i = 0; i < entry.Parameters.size(); ++i)
       {
-        app->Init();
-        std::string curName(app->GetName());
-        appSet.insert(curName);
+        manifest << (i ? ";" : "") << entry.Parameters[i].first << "=" << entry.Parameters[i].second;
       }
+      manifest << "\n";
+    }
+    if (!manifest)
+    {
+      manifest.close();
+      itksys::SystemTools::RemoveFile(tmpPath.str());
+      return false;
     }
   }
-
-  std::vector<std::string> appVec;
-  std::copy(appSet.begin(), appSet.end(), std::back_inserter(appVec));
-  return appVec;
+#ifdef _WIN32
+  // rename() doesn't replace existing files on Windows
+  itksys::SystemTools::RemoveFile(manifestPath);
+#endif
+  if (std::rename(tmpPath.str().c_str(), manifestPath.c_str()) != 0)
+  {
+    itksys::SystemTools::RemoveFile(tmpPath.str());
+    return false;
+  }
+  return true;
 }
 
 void ApplicationRegistry::CleanRegistry()
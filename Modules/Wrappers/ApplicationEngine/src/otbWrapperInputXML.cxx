@@ -121,6 +121,12 @@ int Read(const std::string& filename, Application::Pointer this_)
     itkGenericExceptionMacro(<< "Can't open file " << filename);
   }
 
+  return Read(doc, this_);
+}
+
+/** Returns the application node of a parameter document */
+static TiXmlElement* GetApplicationNode(TiXmlDocument& doc)
+{
   TiXmlHandle handle(&doc);
 
   TiXmlElement* n_OTB;
@@ -128,7 +134,7 @@ int Read(const std::string& filename, Application::Pointer this_)
 
   if (!n_OTB)
   {
-    std::string info = "Input XML file " + filename + " is invalid.";
+    itkGenericExceptionMacro(<< "Input XML " << doc.Value() << " is invalid: no OTB node.");
   }
 
   std::string otb_Version;
@@ -138,9 +144,24 @@ int Read(const std::string& filename, Application::Pointer this_)
     otbGenericMsgDebugMacro(<< "Input XML was generated with a different version of OTB (" << otb_Version << ") and current version is OTB ("
                             << OTB_VERSION_STRING << ")");
 
+  TiXmlElement* n_AppNode = n_OTB->FirstChildElement("application");
+  if (!n_AppNode)
+  {
+    itkGenericExceptionMacro(<< "Input XML " << doc.Value() << " is invalid: no application node.");
+  }
+  return n_AppNode;
+}
+
+std::string GetApplicationName(TiXmlDocument& doc)
+{
+  return GetChildNodeTextOf(GetApplicationNode(doc), "name");
+}
+
+int Read(TiXmlDocument& doc, Application::Pointer this_)
+{
   int ret = 0;
 
-  TiXmlElement* n_AppNode = n_OTB->FirstChildElement("application");
+  TiXmlElement* n_AppNode = GetApplicationNode(doc);
 
   std::string app_Name;
   app_Name = GetChildNodeTextOf(n_AppNode, "name");
@@ -30,6 +30,7 @@ void RegisterTests()
   REGISTER_TEST(otbWrapperStringParameterTest1);
   REGISTER_TEST(otbWrapperChoiceParameterTest1);
   REGISTER_TEST(otbWrapperApplicationRegistry);
+  REGISTER_TEST(otbWrapperApplicationRegistryManifest);
   REGISTER_TEST(otbWrapperStringListParameterTest1);
   REGISTER_TEST(otbWrapperDocExampleStructureTest);
   REGISTER_TEST(otbWrapperParameterKey);
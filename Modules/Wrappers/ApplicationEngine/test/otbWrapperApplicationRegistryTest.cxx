@@ -23,6 +23,16 @@
 #endif
 
 #include "otbWrapperApplicationRegistry.h"
+#include "otbStopwatch.h"
+#include "itksys/Directory.hxx"
+#include "itksys/DynamicLoader.hxx"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <thread>
 
 int otbWrapperApplicationRegistry(int itkNotUsed(argc), char* itkNotUsed(argv)[])
 {
@@ -37,3 +47,121 @@ int otbWrapperApplicationRegistry(int itkNotUsed(argc), char* itkNotUsed(argv)[]
   }
   return EXIT_SUCCESS;
 }
+
+int otbWrapperApplicationRegistryManifest(int argc, char* argv[])
+{
+  if (argc != 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " application_directory work_directory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  using otb::Wrapper::ApplicationRegistry;
+
+  // Work on a copy of a module, to be able to modify it
+  const std::string appDir(argv[2]);
+  itksys::SystemTools::RemoveADirectory(appDir);
+  itksys::SystemTools::MakeDirectory(appDir);
+  std::string extension = itksys::DynamicLoader::LibExtension();
+#ifdef __APPLE__
+  extension = ".dylib";
+#endif
+  const std::string module = appDir + "/otbapp_Smoothing" + extension;
+  if (!itksys::SystemTools::CopyFileAlways(std::string(argv[1]) + "/otbapp_Smoothing" + extension, module))
+  {
+    std::cerr << "Fail: cannot copy the Smoothing module" << std::endl;
+    return EXIT_FAILURE;
+  }
+  ApplicationRegistry::SetApplicationPath(appDir);
+
+  const std::string manifest = ApplicationRegistry::GetManifestPath(appDir);
+  if (manifest.empty())
+  {
+    std::cerr << "Fail: no cache directory for the manifest" << std::endl;
+    return EXIT_FAILURE;
+  }
+  itksys::SystemTools::RemoveFile(manifest);
+
+  // Without manifest: all the modules are loaded
+  otb::Stopwatch chrono = otb::Stopwatch::StartNew();
+  const std::vector<std::string> scanned = ApplicationRegistry::GetAvailableApplications(false);
+  chrono.Stop();
+  std::cout << "Listing " << scanned.size() << " applications without manifest: " << chrono.GetElapsedMilliseconds() << " ms" << std::endl;
+  ApplicationRegistry::CleanRegistry();
+
+  if (!itksys::SystemTools::FileExists(manifest))
+  {
+    std::cerr << "Fail: the manifest " << manifest << " has not been generated" << std::endl;
+    return EXIT_FAILURE;
+  }
+  itksys::Directory directory;
+  directory.Load(appDir);
+  if (directory.GetNumberOfFiles() != 3) // ".", ".." and the module
+  {
+    std::cerr << "Fail: the application directory has been written" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // With manifest: no module is loaded
+  chrono.Restart();
+  const std::vector<std::string> listed = ApplicationRegistry::GetAvailableApplications(false);
+  chrono.Stop();
+  std::cout << "Listing " << listed.size() << " applications from the manifest: " << chrono.GetElapsedMilliseconds() << " ms" << std::endl;
+
+  if (listed != scanned || listed.empty())
+  {
+    std::cerr << "Fail: the manifest doesn't list the same applications as the modules" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Creating an application only loads its own module
+  chrono.Restart();
+  ApplicationRegistry::ApplicationPointer app = ApplicationRegistry::CreateApplication(listed.front(), false);
+  chrono.Stop();
+  std::cout << "Creating " << listed.front() << ": " << chrono.GetElapsedMilliseconds() << " ms" << std::endl;
+  if (app.IsNull())
+  {
+    std::cerr << "Fail: cannot create application " << listed.front() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The manifest describes the parameters
+  for (auto const& entry : ApplicationRegistry::GetApplicationManifest())
+  {
+    if (entry.Name == app->GetName())
+    {
+      const std::vector<std::string> keys = app->GetParametersKeys(true);
+      if (entry.Parameters.size() != keys.size())
+      {
+        std::cerr << "Fail: the manifest entry of " << entry.Name << " doesn't match the application" << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (std::size_t i = 0; i < keys.size(); ++i)
+      {
+        if (entry.Parameters[i].first != keys[i])
+        {
+          std::cerr << "Fail: parameter " << keys[i] << " of " << entry.Name << " is missing in the manifest" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  app = nullptr;
+  ApplicationRegistry::CleanRegistry();
+
+  // A module modified within the same second as the manifest makes it outdated
+  std::ifstream     before(manifest);
+  const std::string beforeContent((std::istreambuf_iterator<char>(before)), std::istreambuf_iterator<char>());
+  before.close();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  itksys::SystemTools::Touch(module, false);
+  ApplicationRegistry::GetAvailableApplications(false);
+  ApplicationRegistry::CleanRegistry();
+  std::ifstream     after(manifest);
+  const std::string afterContent((std::istreambuf_iterator<char>(after)), std::istreambuf_iterator<char>());
+  if (afterContent == beforeContent)
+  {
+    std::cerr << "Fail: the manifest has not been updated after a module changed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbWrapperCommandLineServer_h
+#define otbWrapperCommandLineServer_h
+
+#include "otbWrapperApplication.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace otb
+{
+namespace Wrapper
+{
+
+/** \class CommandLineServer
+ *  \brief Long-lived process running applications on request.
+ *
+ * Launching an application from the command line pays the process start-up,
+ * the loading of the application module, the registration of the GDAL
+ * drivers and the opening of the elevation data before doing any work. The
+ * server pays them once: it listens on a local (Unix domain) socket and runs
+ * each job it receives with a new instance of the requested application, so
+ * that parameters are never shared between jobs, while application modules,
+ * GDAL drivers and elevation caches stay loaded across jobs.
+ *
+ * Protocol: a client connects, sends a job description, and shuts down the
+ * writing side of its connection. A job description uses the format of the
+ * \c -inxml / \c -outxml files (see \c Application::LoadParametersFromXML()).
+ * The server answers with the log of the application, followed by a last
+ * line <tt>OTB_JOB_STATUS <code></tt>, where \c code is 0 on success. A
+ * request made of the single word \c shutdown stops the server once the
+ * running jobs are over. Requests not received within \c
+ * GetRequestTimeout(), or larger than 16 MB, are rejected.
+ *
+ * Jobs are run concurrently, up to \c GetMaximumNumberOfJobs() at a time.
+ * Each job uses the default number of threads of ITK and the default RAM of
+ * OTB: they should be set (\c ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS, \c
+ * OTB_MAX_RAM_HINT) according to the number of concurrent jobs. Elevation
+ * settings are process-wide, they shall be the same for all the jobs.
+ *
+ * \note Only available on platforms with Unix domain sockets.
+ *
+ * \ingroup OTBCommandLine
+ */
+class ITK_ABI_EXPORT CommandLineServer : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef CommandLineServer             Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Defining ::New() static method */
+  itkNewMacro(Self);
+
+  /** RTTI support */
+  itkTypeMacro(CommandLineServer, itk::Object);
+
+  /** Path of the socket the server listens on. */
+  itkSetMacro(SocketPath, std::string);
+  itkGetConstReferenceMacro(SocketPath, std::string);
+
+  /** Maximum number of jobs run concurrently (1 by default). */
+  itkSetMacro(MaximumNumberOfJobs, unsigned int);
+  itkGetConstMacro(MaximumNumberOfJobs, unsigned int);
+
+  /** Time given to a client to send its job description, and to take the
+   * reply, in seconds (60 by default, 0 for no limit). */
+  itkSetMacro(RequestTimeout, unsigned int);
+  itkGetConstMacro(RequestTimeout, unsigned int);
+
+  /** Listens and runs the jobs, until a shutdown request is received.
+   * A socket left by a server that stopped is replaced.
+   * \return false if the socket can't be created, if the path is used by
+   * another file, or if a server is already listening on it.
+   */
+  bool Run();
+
+  /** Runs a job in the current thread.
+   * \param[in] job  job description
+   * \param[out] log  log of the application
+   * \return 0 on success
+   */
+  int RunJob(const std::string& job, std::ostream& log);
+
+  /** Sends a job to a server and waits for its completion.
+   * \param[in] socketPath  path of the socket of the server
+   * \param[in] job         job description
+   * \param[out] log        log of the application
+   * \return the status of the job, or -1 if the server can't be reached.
+   */
+  static int SubmitJob(const std::string& socketPath, const std::string& job, std::ostream& log);
+
+  /** Asks a server to stop once its running jobs are over.
+   * \return false if the server can't be reached.
+   */
+  static bool RequestShutdown(const std::string& socketPath);
+
+protected:
+  /** Constructor */
+  CommandLineServer();
+
+  /** Destructor */
+  ~CommandLineServer() override;
+
+private:
+  CommandLineServer(const CommandLineServer&) = delete;
+  void operator=(const CommandLineServer&) = delete;
+
+  /** Serves a connection: reads the request, runs it and closes the
+   * connection. */
+  void ServeConnection(int connection);
+
+  /** Creates a new instance of an application. The first instance of each
+   * application is kept so that its module stays loaded. */
+  Application::Pointer CreateApplication(const std::string& name);
+
+  std::string  m_SocketPath;
+  unsigned int m_MaximumNumberOfJobs;
+  unsigned int m_RequestTimeout;
+
+  /** Jobs scheduling */
+  std::mutex              m_JobsMutex;
+  std::condition_variable m_JobsCondition;
+  unsigned int            m_NumberOfRunningJobs;
+  bool                    m_ShutdownRequested;
+
+  /** Application creation is not thread safe */
+  std::mutex                                  m_RegistryMutex;
+  std::map<std::string, Application::Pointer> m_LoadedApplications;
+}; // end class
+
+} // end namespace Wrapper
+} // end namespace otb
+
+#endif // otbWrapperCommandLineServer_h
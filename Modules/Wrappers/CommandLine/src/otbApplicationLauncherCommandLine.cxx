@@ -20,8 +20,15 @@
 
 
 #include "otbWrapperCommandLineLauncher.h"
+#include "otbWrapperCommandLineServer.h"
+#include "otbWrapperApplicationRegistry.h"
 #include "otbConfigurationManager.h"
 #include "otb_tinyxml.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
 #include <vector>
 
 #ifdef OTB_USE_MPI
@@ -45,6 +52,83 @@ std::string CleanWord(const std::string& word)
 void ShowUsage(char* argv[])
 {
   std::cerr << "Usage: " << argv[0] << " module_name [MODULEPATH] [arguments]" << std::endl;
+  std::cerr << "       " << argv[0] << " -server socket_path [-maxjobs N] [-timeout seconds] [MODULEPATH]" << std::endl;
+  std::cerr << "       " << argv[0] << " -submit socket_path job.xml" << std::endl;
+  std::cerr << "       " << argv[0] << " -shutdown socket_path" << std::endl;
+}
+
+/** Parses a non negative integer option, returns false if invalid */
+bool ParseUnsignedOption(const std::string& value, unsigned int& result)
+{
+  if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+  {
+    return false;
+  }
+  errno                    = 0;
+  const unsigned long read = std::strtoul(value.c_str(), nullptr, 10);
+  if (errno != 0 || read > std::numeric_limits<unsigned int>::max())
+  {
+    return false;
+  }
+  result = static_cast<unsigned int>(read);
+  return true;
+}
+
+/** Server mode: run the jobs received on a socket */
+int RunServer(const std::vector<std::string>& vexp, char* argv[])
+{
+  typedef otb::Wrapper::CommandLineServer ServerType;
+  ServerType::Pointer                     server = ServerType::New();
+  server->SetSocketPath(vexp[1]);
+
+  for (std::size_t i = 2; i < vexp.size(); ++i)
+  {
+    if (vexp[i] == "-maxjobs" || vexp[i] == "-timeout")
+    {
+      unsigned int value = 0;
+      if (i + 1 >= vexp.size() || !ParseUnsignedOption(vexp[i + 1], value) || (vexp[i] == "-maxjobs" && value == 0))
+      {
+        std::cerr << "ERROR: Invalid value for " << vexp[i] << (i + 1 < vexp.size() ? ": " + vexp[i + 1] : std::string()) << std::endl;
+        ShowUsage(argv);
+        return EXIT_FAILURE;
+      }
+      if (vexp[i] == "-maxjobs")
+      {
+        server->SetMaximumNumberOfJobs(value);
+      }
+      else
+      {
+        server->SetRequestTimeout(value);
+      }
+      ++i;
+    }
+    else
+    {
+      otb::Wrapper::ApplicationRegistry::AddApplicationPath(vexp[i]);
+    }
+  }
+
+  return server->Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/** Client mode: send a job to a server and wait for its completion */
+int SubmitJob(const std::string& socketPath, const std::string& jobFile)
+{
+  std::ifstream file(jobFile);
+  if (!file)
+  {
+    std::cerr << "ERROR: Cannot read " << jobFile << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::ostringstream job;
+  job << file.rdbuf();
+
+  const int status = otb::Wrapper::CommandLineServer::SubmitJob(socketPath, job.str(), std::cout);
+  if (status < 0)
+  {
+    std::cerr << "ERROR: No answer from the server listening on " << socketPath << std::endl;
+  }
+  return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 int main(int argc, char* argv[])
@@ -76,6 +160,25 @@ int main(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  if (vexp[0] == "-server" || vexp[0] == "-submit" || vexp[0] == "-shutdown")
+  {
+    if (vexp.size() < 2 || (vexp[0] == "-submit" && vexp.size() != 3))
+    {
+      ShowUsage(argv);
+      return EXIT_FAILURE;
+    }
+    if (vexp[0] == "-submit")
+    {
+      return SubmitJob(vexp[1], vexp[2]);
+    }
+    if (vexp[0] == "-shutdown")
+    {
+      return otb::Wrapper::CommandLineServer::RequestShutdown(vexp[1]) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    otb::ConfigurationManager::InitOpenMPThreads();
+    return RunServer(vexp, argv);
+  }
+
 #ifdef OTB_USE_MPI
   if (std::find(vexp.begin(), vexp.end(), "-testenv") == vexp.end())
     otb::MPIConfig::Instance()->Init(argc, argv);
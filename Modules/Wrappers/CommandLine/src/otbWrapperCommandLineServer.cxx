@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbWrapperCommandLineServer.h"
+
+#include "otbWrapperApplicationRegistry.h"
+#include "otbWrapperInputXML.h"
+#include "otb_tinyxml.h"
+
+#include "itkStdStreamLogOutput.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace otb
+{
+namespace Wrapper
+{
+
+namespace
+{
+const char statusTag[]       = "OTB_JOB_STATUS ";
+const char shutdownRequest[] = "shutdown";
+
+/** Largest job description accepted by the server */
+const std::size_t maximumRequestSize = 16 * 1024 * 1024;
+
+#ifndef _WIN32
+bool FillAddress(const std::string& path, sockaddr_un& address)
+{
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path))
+  {
+    return false;
+  }
+  std::copy(path.begin(), path.end(), address.sun_path);
+  return true;
+}
+
+/** Connects to a server, returns the connection or -1 */
+int Connect(const std::string& path)
+{
+  sockaddr_un address;
+  if (!FillAddress(path, address))
+  {
+    return -1;
+  }
+  const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (connection < 0)
+  {
+    return -1;
+  }
+  if (connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+  {
+    close(connection);
+    return -1;
+  }
+  return connection;
+}
+
+bool WriteAll(int connection, const std::string& data)
+{
+  std::size_t written = 0;
+  while (written < data.size())
+  {
+    const ssize_t n = write(connection, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return false;
+    }
+    written += n;
+  }
+  return true;
+}
+
+/** Reads until the peer shuts down its writing side, up to maxSize bytes
+ * if not 0 */
+bool ReadAll(int connection, std::string& data, std::size_t maxSize = 0)
+{
+  char buffer[4096];
+  while (true)
+  {
+    if (maxSize > 0 && data.size() > maxSize)
+    {
+      errno = EMSGSIZE;
+      return false;
+    }
+    const ssize_t n = read(connection, buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n < 0)
+    {
+      return false;
+    }
+    if (n == 0)
+    {
+      return true;
+    }
+    data.append(buffer, n);
+  }
+}
+
+/** Sends a request and reads the whole reply */
+bool SendRequest(const std::string& socketPath, const std::string& request, std::string& reply)
+{
+  const int connection = Connect(socketPath);
+  if (connection < 0)
+  {
+    return false;
+  }
+  const bool ok = WriteAll(connection, request) && shutdown(connection, SHUT_WR) == 0 && ReadAll(connection, reply);
+  close(connection);
+  return ok;
+}
+
+/** Extracts the status line of a reply, returns -1 if there is none */
+int SplitReply(const std::string& reply, std::ostream& log)
+{
+  const std::string::size_type pos = reply.rfind(statusTag);
+  if (pos == std::string::npos || (pos > 0 && reply[pos - 1] != '\n'))
+  {
+    log << reply;
+    return -1;
+  }
+  log << reply.substr(0, pos);
+  int status = -1;
+  std::istringstream(reply.substr(pos + sizeof(statusTag) - 1)) >> status;
+  return status;
+}
+#endif
+}
+
+CommandLineServer::CommandLineServer() : m_MaximumNumberOfJobs(1), m_RequestTimeout(60), m_NumberOfRunningJobs(0), m_ShutdownRequested(false)
+{
+}
+
+CommandLineServer::~CommandLineServer()
+{
+}
+
+bool CommandLineServer::Run()
+{
+#ifdef _WIN32
+  std::cerr << "ERROR: The application server is not available on this platform." << std::endl;
+  return false;
+#else
+  sockaddr_un address;
+  if (!FillAddress(m_SocketPath, address))
+  {
+    std::cerr << "ERROR: Invalid socket path \"" << m_SocketPath << "\"." << std::endl;
+    return false;
+  }
+
+  const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0)
+  {
+    std::cerr << "ERROR: Cannot create a socket: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  // Remove the socket left by a previous server, but neither another file nor
+  // the socket of a running server
+  struct stat fileStatus;
+  if (lstat(m_SocketPath.c_str(), &fileStatus) == 0)
+  {
+    if (!S_ISSOCK(fileStatus.st_mode))
+    {
+      std::cerr << "ERROR: " << m_SocketPath << " exists and is not a socket." << std::endl;
+      close(server);
+      return false;
+    }
+    const int runningServer = Connect(m_SocketPath);
+    if (runningServer >= 0)
+    {
+      close(runningServer);
+      std::cerr << "ERROR: A server is already listening on " << m_SocketPath << "." << std::endl;
+      close(server);
+      return false;
+    }
+    unlink(m_SocketPath.c_str());
+  }
+  if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(server, SOMAXCONN) < 0)
+  {
+    std::cerr << "ERROR: Cannot listen on " << m_SocketPath << ": " << std::strerror(errno) << std::endl;
+    close(server);
+    return false;
+  }
+
+  // Clients leaving before the end of their job shall not kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+
+  m_ShutdownRequested = false;
+  std::cout << "Listening on " << m_SocketPath << " (" << m_MaximumNumberOfJobs << " concurrent jobs)" << std::endl;
+
+  const unsigned int maxJobs = std::max(m_MaximumNumberOfJobs, 1u);
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_JobsMutex);
+      m_JobsCondition.wait(lock, [this, maxJobs] { return m_ShutdownRequested || m_NumberOfRunningJobs < maxJobs; });
+      if (m_ShutdownRequested)
+      {
+        break;
+      }
+    }
+
+    const int connection = accept(server, nullptr, nullptr);
+    if (connection < 0)
+    {
+      if (errno == EINTR || errno == ECONNABORTED)
+      {
+        continue;
+      }
+      std::cerr << "ERROR: Cannot accept connections: " << std::strerror(errno) << std::endl;
+      break;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_JobsMutex);
+      if (m_ShutdownRequested)
+      {
+        close(connection);
+        break;
+      }
+      ++m_NumberOfRunningJobs;
+    }
+    std::thread(&CommandLineServer::ServeConnection, this, connection).detach();
+  }
+
+  // Wait for the running jobs
+  {
+    std::unique_lock<std::mutex> lock(m_JobsMutex);
+    m_JobsCondition.wait(lock, [this] { return m_NumberOfRunningJobs == 0; });
+  }
+  close(server);
+  unlink(m_SocketPath.c_str());
+  return true;
+#endif
+}
+
+void CommandLineServer::ServeConnection(int connection)
+{
+#ifndef _WIN32
+  std::string        request;
+  std::ostringstream log;
+  int                status = 1;
+
+  // A client that never ends its request shall not hold a job slot forever
+  if (m_RequestTimeout > 0)
+  {
+    timeval timeout;
+    timeout.tv_sec  = m_RequestTimeout;
+    timeout.tv_usec = 0;
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  }
+
+  if (!ReadAll(connection, request, maximumRequestSize))
+  {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      log << "ERROR: The job description was not received within " << m_RequestTimeout << " s" << std::endl;
+    }
+    else if (errno == EMSGSIZE)
+    {
+      log << "ERROR: The job description is larger than " << maximumRequestSize << " bytes" << std::endl;
+    }
+    else
+    {
+      log << "ERROR: Cannot read the job description: " << std::strerror(errno) << std::endl;
+    }
+  }
+  else if (request.compare(0, sizeof(shutdownRequest) - 1, shutdownRequest) == 0 &&
+           request.find_first_not_of(" \t\r\n", sizeof(shutdownRequest) - 1) == std::string::npos)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_JobsMutex);
+      m_ShutdownRequested = true;
+    }
+    m_JobsCondition.notify_all();
+    // Wake up the server if it is waiting for a connection
+    const int wakeUp = Connect(m_SocketPath);
+    if (wakeUp >= 0)
+    {
+      close(wakeUp);
+    }
+    status = 0;
+  }
+  else
+  {
+    status = RunJob(request, log);
+  }
+
+  std::string reply = log.str();
+  if (!reply.empty() && reply.back() != '\n')
+  {
+    reply += '\n';
+  }
+  reply += statusTag + std::to_string(status) + "\n";
+  WriteAll(connection, reply);
+  close(connection);
+
+  {
+    std::lock_guard<std::mutex> lock(m_JobsMutex);
+    --m_NumberOfRunningJobs;
+  }
+  m_JobsCondition.notify_all();
+#else
+  (void)connection;
+#endif
+}
+
+Application::Pointer CommandLineServer::CreateApplication(const std::string& name)
+{
+  std::lock_guard<std::mutex> lock(m_RegistryMutex);
+
+  Application::Pointer application = ApplicationRegistry::CreateApplication(name);
+  if (application.IsNotNull() && m_LoadedApplications.find(name) == m_LoadedApplications.end())
+  {
+    // Keep an instance, and thus its module, alive: the next jobs won't have
+    // to load it again
+    m_LoadedApplications[name] = ApplicationRegistry::CreateApplication(name);
+  }
+  return application;
+}
+
+int CommandLineServer::RunJob(const std::string& job, std::ostream& log)
+{
+  TiXmlDocument doc;
+  doc.Parse(job.c_str(), nullptr, TIXML_ENCODING_UTF8);
+  if (doc.Error())
+  {
+    log << "ERROR: Invalid job description: " << doc.ErrorDesc() << std::endl;
+    return 1;
+  }
+
+  Application::Pointer application;
+  try
+  {
+    const std::string name = XML::GetApplicationName(doc);
+    application            = this->CreateApplication(name);
+    if (application.IsNull())
+    {
+      log << "ERROR: Could not find application \"" << name << "\"" << std::endl;
+      return 1;
+    }
+  }
+  catch (itk::ExceptionObject& err)
+  {
+    log << "ERROR: " << err.GetDescription() << std::endl;
+    return 1;
+  }
+
+  // Each job has its own log
+  itk::StdStreamLogOutput::Pointer logOutput = itk::StdStreamLogOutput::New();
+  logOutput->SetStream(log);
+  application->GetLogger()->AddLogOutput(logOutput);
+
+  try
+  {
+    XML::Read(doc, application);
+    return application->ExecuteAndWriteOutput() == 0 ? 0 : 1;
+  }
+  catch (otb::ApplicationException& err)
+  {
+    // Already logged by otbAppLogFATAL
+    application->GetLogger()->Debug(std::string(err.what()) + "\n");
+  }
+  catch (itk::ExceptionObject& err)
+  {
+    application->GetLogger()->Debug(std::string(err.what()) + "\n");
+    application->GetLogger()->Fatal(std::string(err.GetDescription()) + "\n");
+  }
+  catch (std::exception& err)
+  {
+    application->GetLogger()->Fatal(std::string("Caught std::exception during application execution: ") + err.what() + "\n");
+  }
+  catch (...)
+  {
+    application->GetLogger()->Fatal("Caught unknown exception during application execution.\n");
+  }
+  return 1;
+}
+
+int CommandLineServer::SubmitJob(const std::string& socketPath, const std::string& job, std::ostream& log)
+{
+#ifdef _WIN32
+  (void)socketPath;
+  (void)job;
+  (void)log;
+  return -1;
+#else
+  std::string reply;
+  if (!SendRequest(socketPath, job, reply))
+  {
+    return -1;
+  }
+  return SplitReply(reply, log);
+#endif
+}
+
+bool CommandLineServer::RequestShutdown(const std::string& socketPath)
+{
+#ifdef _WIN32
+  (void)socketPath;
+  return false;
+#else
+  std::string reply;
+  return SendRequest(socketPath, shutdownRequest, reply);
+#endif
+}
+
+} // end namespace Wrapper
+} // end namespace otb
@@ -27,4 +27,5 @@ void RegisterTests()
   REGISTER_TEST(otbWrapperCommandLineParserTest2);
   REGISTER_TEST(otbWrapperCommandLineParserTest3);
   REGISTER_TEST(otbWrapperCommandLineParserTest4);
+  REGISTER_TEST(otbWrapperCommandLineServerTest);
 }
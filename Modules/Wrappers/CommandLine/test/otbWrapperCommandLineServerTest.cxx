@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbWrapperCommandLineServer.h"
+#include "otbWrapperApplicationRegistry.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+/** Sends the beginning of a request without ending it, returns the reply */
+std::string SendUnfinishedRequest(const std::string& socketPath)
+{
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+  const int   connection = socket(AF_UNIX, SOCK_STREAM, 0);
+  std::string reply;
+  if (connection < 0 || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || write(connection, "<OTB>", 5) != 5)
+  {
+    if (connection >= 0)
+    {
+      close(connection);
+    }
+    return reply;
+  }
+  char    buffer[4096];
+  ssize_t n = 0;
+  while ((n = read(connection, buffer, sizeof(buffer))) > 0)
+  {
+    reply.append(buffer, n);
+  }
+  close(connection);
+  return reply;
+}
+}
+
+int otbWrapperCommandLineServerTest(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::cerr << "Usage: " << argv[0] << " socket_path module_path input_image output_prefix" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string socketPath(argv[1]);
+  const std::string prefix(argv[4]);
+
+  typedef otb::Wrapper::CommandLineServer ServerType;
+  otb::Wrapper::ApplicationRegistry::AddApplicationPath(argv[2]);
+
+  // Generate two job descriptions
+  std::vector<std::string> jobs;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    otb::Wrapper::Application::Pointer app = otb::Wrapper::ApplicationRegistry::CreateApplication("Rescale");
+    if (app.IsNull())
+    {
+      std::cerr << "Cannot create the Rescale application" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::ostringstream output, xml;
+    output << prefix << "_" << i << ".tif";
+    xml << prefix << "_" << i << ".xml";
+    app->SetParameterString("in", argv[3]);
+    app->SetParameterString("out", output.str());
+    app->SetParameterFloat("outmax", 100.f * (i + 1));
+    app->SaveParametersToXML(xml.str());
+
+    std::ifstream      file(xml.str());
+    std::ostringstream job;
+    job << file.rdbuf();
+    jobs.push_back(job.str());
+  }
+
+  bool success = true;
+
+  // A file which is not a socket is never replaced
+  const std::string filePath = prefix + ".notasocket";
+  std::ofstream(filePath) << "not a socket";
+  ServerType::Pointer fileServer = ServerType::New();
+  fileServer->SetSocketPath(filePath);
+  if (fileServer->Run() || !std::ifstream(filePath))
+  {
+    std::cerr << "Fail: the server shall not replace a regular file" << std::endl;
+    success = false;
+  }
+
+  ServerType::Pointer server = ServerType::New();
+  server->SetSocketPath(socketPath);
+  server->SetMaximumNumberOfJobs(2);
+  server->SetRequestTimeout(1);
+  bool        serverOk = false;
+  std::thread serverThread([&server, &serverOk] { serverOk = server->Run(); });
+
+  // Wait for the server to listen
+  std::ostringstream dummy;
+  for (unsigned int i = 0; i < 100 && ServerType::SubmitJob(socketPath, "", dummy) < 0; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  // The socket of a running server is not taken over
+  ServerType::Pointer secondServer = ServerType::New();
+  secondServer->SetSocketPath(socketPath);
+  if (secondServer->Run())
+  {
+    std::cerr << "Fail: a second server shall not listen on the socket of a running one" << std::endl;
+    success = false;
+  }
+
+  // Concurrent jobs
+  int         status[2] = {-1, -1};
+  std::thread clients[2];
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    clients[i] = std::thread([&jobs, &status, &socketPath, i] {
+      std::ostringstream log;
+      status[i] = ServerType::SubmitJob(socketPath, jobs[i], log);
+      std::cout << "Job " << i << ":\n" << log.str() << std::endl;
+    });
+  }
+  for (auto& client : clients)
+  {
+    client.join();
+  }
+  if (status[0] != 0 || status[1] != 0)
+  {
+    std::cerr << "Fail: jobs ended with status " << status[0] << " and " << status[1] << std::endl;
+    success = false;
+  }
+
+  // Invalid jobs are reported as failures
+  std::ostringstream log;
+  if (ServerType::SubmitJob(socketPath, "<OTB><application><name>NotAnApplication</name></application></OTB>", log) != 1)
+  {
+    std::cerr << "Fail: an unknown application shall be reported as a failed job" << std::endl;
+    success = false;
+  }
+
+  // A client which doesn't end its request is rejected after the timeout
+  const std::string reply = SendUnfinishedRequest(socketPath);
+  if (reply.find("OTB_JOB_STATUS 1") == std::string::npos)
+  {
+    std::cerr << "Fail: an unfinished request shall be rejected, got \"" << reply << "\"" << std::endl;
+    success = false;
+  }
+
+  if (!ServerType::RequestShutdown(socketPath))
+  {
+    std::cerr << "Fail: cannot stop the server" << std::endl;
+    success = false;
+  }
+  serverThread.join();
+
+  if (!serverOk)
+  {
+    std::cerr << "Fail: the server didn't start" << std::endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -44,6 +44,13 @@
 import_array();
 %}
 
+%{
+#include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbNumpyTileFilter.h"
+typedef otb::NumpyTileFilter          NumpyTileFilter;
+typedef otb::NumpyTileFilter::Pointer NumpyTileFilter_Pointer;
+%}
+
 /*leave the mess to SWIG and let us not worry.*/
 %apply (signed char* INPLACE_ARRAY3, int DIM1, int DIM2, int DIM3) {(signed char* buffer, int dim1, int dim2, int dim3)};
 %apply (signed short* INPLACE_ARRAY3, int DIM1, int DIM2, int DIM3) {(signed short* buffer, int dim1, int dim2, int dim3)};
@@ -476,6 +483,42 @@ public:
     return oss.str();
     }
 
+  std::vector<itk::ImageRegion<2> > GetStreamingDivisions(const std::string & key, unsigned int ram = 0)
+    {
+    ImageBaseType* img = $self->GetParameterOutputImage(key);
+    img->UpdateOutputInformation();
+    typedef otb::RAMDrivenAdaptativeStreamingManager<otb::Wrapper::FloatVectorImageType> StreamingManagerType;
+    StreamingManagerType::Pointer manager = StreamingManagerType::New();
+    manager->SetAvailableRAMInMB(ram);
+    ImageBaseType::RegionType largest = img->GetLargestPossibleRegion();
+    manager->PrepareStreaming(img, largest);
+    std::vector<itk::ImageRegion<2> > divisions;
+    for (unsigned int i = 0; i < manager->GetNumberOfSplits(); ++i)
+      {
+      ImageBaseType::RegionType split = manager->GetSplit(i);
+      split.SetIndex(0, split.GetIndex(0) - largest.GetIndex(0));
+      split.SetIndex(1, split.GetIndex(1) - largest.GetIndex(1));
+      divisions.push_back(split);
+      }
+    return divisions;
+    }
+
+  itk::ImageRegion<2> UpdateImageRegion_(const std::string & key, itk::ImageRegion<2> region)
+    {
+    ImageBaseType* img = $self->GetParameterOutputImage(key);
+    ImageBaseType::RegionType largest = img->GetLargestPossibleRegion();
+    ImageBaseType::RegionType requested = region;
+    requested.SetIndex(0, requested.GetIndex(0) + largest.GetIndex(0));
+    requested.SetIndex(1, requested.GetIndex(1) + largest.GetIndex(1));
+    img->SetRequestedRegion(requested);
+    img->PropagateRequestedRegion();
+    img->UpdateOutputData();
+    ImageBaseType::RegionType buffered = img->GetBufferedRegion();
+    buffered.SetIndex(0, buffered.GetIndex(0) - largest.GetIndex(0));
+    buffered.SetIndex(1, buffered.GetIndex(1) - largest.GetIndex(1));
+    return buffered;
+    }
+
   void SetupImageInformation(
     ImageBaseType* img,
     itk::Point<SpacePrecisionType,2> origin,
@@ -876,6 +919,55 @@ class ApplicationProxy(object):
       img = self.SetVectorImageFromNumpyArray(paramKey, pyImg["array"], index)
       self.SetupImageInformation(img, pyImg["origin"], pyImg["spacing"], pyImg["size"], pyImg["region"], pyImg["metadata"])
 
+    def StreamImageOutput(self, paramKey, ram=None):
+      """
+      Generator pulling an output image parameter division by division, without
+      writing it nor holding it entirely in memory. The divisions are computed
+      by the RAM driven streaming manager, from the given amount of RAM (in MB),
+      or from the 'ram' parameter of the application when there is one.
+      Each division is yielded as a python dictionary with the following keys:
+        - array: numpy array (rows, columns, bands) viewing the pipeline buffer
+        - region: region of the division in the image
+        - index: number of the division
+        - geotransform: GDAL-like geotransform of the division
+      The application shall have been executed with Execute(). The array is
+      only valid until the next division is requested: copy it to keep it.
+      """
+      if ram is None:
+        ram = self.GetParameterInt("ram") if "ram" in self.GetParametersKeys() else 0
+      pixT = self.GetImageBasePixelType(paramKey)
+      origin = self.GetImageOrigin(paramKey)
+      spacing = self.GetImageSpacing(paramKey)
+      for idx, region in enumerate(self.GetStreamingDivisions(paramKey, ram)):
+        buffered = self.UpdateImageRegion_(paramKey, region)
+        array = self.NumpyExporterMap[pixT](self, paramKey)
+        x0 = region.GetIndex(0) - buffered.GetIndex(0)
+        y0 = region.GetIndex(1) - buffered.GetIndex(1)
+        array = array[y0:y0 + region.GetSize(1), x0:x0 + region.GetSize(0), :]
+        # the origin is the center of the first pixel, GDAL uses its corner
+        geotransform = (origin[0] + (region.GetIndex(0) - 0.5) * spacing[0], spacing[0], 0.,
+                        origin[1] + (region.GetIndex(1) - 0.5) * spacing[1], 0., spacing[1])
+        yield {"array": array, "region": region, "index": idx, "geotransform": geotransform}
+
+    def ConnectImageThroughNumpy(self, paramKey, image, callable, index=0):
+      """
+      Connect an image to an input image parameter through a NumpyTileFilter:
+      each region of the image pulled by this application is given to
+      callable(array, index) as a writable numpy array (rows, columns, bands) of
+      float32, which shall be modified in place. 'image' is typically the
+      result of GetParameterOutputImage() on another application. The filter
+      is kept alive by this application and returned.
+      """
+      tileFilter = NumpyTileFilter.New()
+      tileFilter.SetInputImage(image)
+      tileFilter.SetCallable(callable)
+      if self.GetParameterType(paramKey) == ParameterType_InputImageList:
+        self.AddImageToParameterInputImageList(paramKey, tileFilter.GetOutputImage())
+      else:
+        self.SetParameterInputImage(paramKey, tileFilter.GetOutputImage())
+      self.__dict__.setdefault("numpyTileFilters", []).append(tileFilter)
+      return tileFilter
+
     def ExportImage(self, paramKey):
       """
       Export an output image from an otbApplication into a python dictionary with the
@@ -893,6 +985,21 @@ class ApplicationProxy(object):
     }
 }
 
+#if SWIGPYTHON
+class NumpyTileFilter : public itkProcessObject
+{
+public:
+  static NumpyTileFilter_Pointer New();
+  void SetInputImage(ImageBaseType* image);
+  ImageBaseType* GetOutputImage();
+  void SetCallable(PyObject* obj);
+  PyObject* GetCallable();
+protected:
+  NumpyTileFilter();
+};
+DECLARE_REF_COUNT_CLASS( NumpyTileFilter )
+#endif
+
 #endif /* OTB_SWIGNUMPY */
 
 class Registry : public itkObject
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbNumpyTileFilter_h
+#define otbNumpyTileFilter_h
+
+#include "itkInPlaceImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "otbWrapperInputImageParameter.h"
+
+// The python header defines _POSIX_C_SOURCE without a preceding #undef
+#undef _POSIX_C_SOURCE
+// The python header defines _XOPEN_SOURCE without a preceding #undef
+#undef _XOPEN_SOURCE
+
+#include <Python.h>
+
+// This header uses the numpy C API: it shall be included in the translation
+// unit generated by SWIG, after numpy.i (which includes numpy/arrayobject.h
+// and calls import_array() at module initialisation).
+
+namespace otb
+{
+
+/** \class NumpyTileFilter
+ *  \brief Pipeline stage delegating the processing of each region to a
+ *  Python callable.
+ *
+ * For each requested region, the output buffer is filled with the input
+ * pixels (or the input buffer is reused when the filter runs in place), then
+ * the callable is invoked as \c callable(array, index) where \c array is a
+ * writable numpy view (rows, columns, bands) of the requested region, and \c
+ * index the (x, y) index of the region in the largest possible region. The
+ * callable modifies the array in place; its return value is ignored. It
+ * shall not keep a reference to the array, whose memory belongs to the
+ * pipeline.
+ *
+ * Whatever the pixel type of the input image, it is processed as an
+ * otb::Wrapper::FloatVectorImageType, like application inputs are.
+ *
+ * The callable runs with the GIL held, so GenerateData() is single-threaded:
+ * the pipeline can still be streamed, but the callable is called once per
+ * streaming division.
+ *
+ * \ingroup OTBSWIG
+ */
+class NumpyTileFilter : public itk::InPlaceImageFilter<Wrapper::FloatVectorImageType, Wrapper::FloatVectorImageType>
+{
+public:
+  /** Standard class typedefs. */
+  typedef NumpyTileFilter                                                                       Self;
+  typedef itk::InPlaceImageFilter<Wrapper::FloatVectorImageType, Wrapper::FloatVectorImageType> Superclass;
+  typedef itk::SmartPointer<Self>                                                               Pointer;
+  typedef itk::SmartPointer<const Self>                                                         ConstPointer;
+
+  typedef Wrapper::FloatVectorImageType ImageType;
+  typedef ImageType::RegionType         RegionType;
+  typedef ImageType::InternalPixelType  InternalPixelType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(NumpyTileFilter, InPlaceImageFilter);
+
+  /** Connects any image produced by an application, or given to one. */
+  void SetInputImage(Wrapper::ImageBaseType* image)
+  {
+    m_InputParameter->SetImage(image);
+    this->SetInput(m_InputParameter->GetFloatVectorImage());
+  }
+
+  Wrapper::ImageBaseType* GetOutputImage()
+  {
+    return this->GetOutput();
+  }
+
+  /** Assigns the Python callable; a reference is kept on it. */
+  void SetCallable(PyObject* obj)
+  {
+    if (obj != m_Callable)
+    {
+      GILStateEnsure gil;
+      Py_XINCREF(obj);
+      Py_XDECREF(m_Callable);
+      m_Callable = obj;
+      this->Modified();
+    }
+  }
+
+  PyObject* GetCallable()
+  {
+    return m_Callable;
+  }
+
+protected:
+  NumpyTileFilter() : m_InputParameter(Wrapper::InputImageParameter::New()), m_Callable(nullptr)
+  {
+    this->InPlaceOn();
+  }
+
+  ~NumpyTileFilter() override
+  {
+    if (m_Callable)
+    {
+      GILStateEnsure gil;
+      Py_DECREF(m_Callable);
+    }
+  }
+
+  void GenerateData() override
+  {
+    if (!m_Callable || !PyCallable_Check(m_Callable))
+    {
+      itkExceptionMacro(<< "The tile callable is not a callable Python object, or it has not been set.");
+    }
+
+    this->AllocateOutputs();
+
+    const ImageType* input  = this->GetInput();
+    ImageType*       output = this->GetOutput();
+    const RegionType region = output->GetRequestedRegion();
+
+    if (output->GetBufferPointer() != input->GetBufferPointer())
+    {
+      itk::ImageRegionConstIterator<ImageType> inIt(input, region);
+      itk::ImageRegionIterator<ImageType>      outIt(output, region);
+      for (inIt.GoToBegin(), outIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt, ++outIt)
+      {
+        outIt.Set(inIt.Get());
+      }
+    }
+
+    // View of the requested region inside the (possibly larger) buffer
+    const unsigned int nbComp   = output->GetNumberOfComponentsPerPixel();
+    const RegionType   buffered = output->GetBufferedRegion();
+    npy_intp           dims[3]  = {static_cast<npy_intp>(region.GetSize(1)), static_cast<npy_intp>(region.GetSize(0)), static_cast<npy_intp>(nbComp)};
+    npy_intp strides[3]         = {static_cast<npy_intp>(buffered.GetSize(0) * nbComp * sizeof(InternalPixelType)),
+                           static_cast<npy_intp>(nbComp * sizeof(InternalPixelType)), static_cast<npy_intp>(sizeof(InternalPixelType))};
+    InternalPixelType* data = output->GetBufferPointer() + output->ComputeOffset(region.GetIndex()) * nbComp;
+
+    const RegionType::IndexType largestIndex = output->GetLargestPossibleRegion().GetIndex();
+
+    GILStateEnsure gil;
+    PyObject* array = PyArray_New(&PyArray_Type, 3, dims, NPY_FLOAT32, strides, data, 0, NPY_ARRAY_WRITEABLE | NPY_ARRAY_ALIGNED, nullptr);
+    if (!array)
+    {
+      PyErr_Print();
+      itkExceptionMacro(<< "Cannot create the numpy view of region " << region);
+    }
+    PyObject* result = PyObject_CallFunction(m_Callable, const_cast<char*>("O(ll)"), array, static_cast<long>(region.GetIndex(0) - largestIndex[0]),
+                                             static_cast<long>(region.GetIndex(1) - largestIndex[1]));
+    Py_DECREF(array);
+    if (!result)
+    {
+      // Print the Python error before turning it into an ITK exception
+      PyErr_Print();
+      itkExceptionMacro(<< "There was an error executing the tile callable on region " << region);
+    }
+    Py_DECREF(result);
+  }
+
+private:
+  NumpyTileFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Acquires the GIL for the lifetime of the object */
+  class GILStateEnsure
+  {
+  public:
+    GILStateEnsure() : m_GIL(PyGILState_Ensure())
+    {
+    }
+    ~GILStateEnsure()
+    {
+      PyGILState_Release(m_GIL);
+    }
+
+  private:
+    PyGILState_STATE m_GIL;
+  };
+
+  Wrapper::InputImageParameter::Pointer m_InputParameter;
+  PyObject*                             m_Callable;
+};
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+#-*- coding: utf-8 -*-
+#
+# Copyright (C) 2005-2020 Centre National d'Etudes Spatiales (CNES)
+#
+# This file is part of Orfeo Toolbox
+#
+#     https://www.orfeo-toolbox.org/
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import numpy as np
+
+def test(otb, argv):
+  # Reference: the whole output in memory
+  app = otb.Registry.CreateApplication("Smoothing")
+  app.SetParameterString("in", argv[1])
+  app.SetParameterString("type", "mean")
+  app.Execute()
+  reference = np.copy(app.GetVectorImageAsNumpyArray("out"))
+
+  # Pull the same output by divisions of at most 1 MB
+  app2 = otb.Registry.CreateApplication("Smoothing")
+  app2.SetParameterString("in", argv[1])
+  app2.SetParameterString("type", "mean")
+  app2.Execute()
+  streamed = np.zeros(reference.shape, dtype=reference.dtype)
+  origin = app2.GetImageOrigin("out")
+  spacing = app2.GetImageSpacing("out")
+  nbDivisions = 0
+  for tile in app2.StreamImageOutput("out", ram=1):
+    region = tile["region"]
+    x, y = region.GetIndex(0), region.GetIndex(1)
+    sx, sy = region.GetSize(0), region.GetSize(1)
+    assert tile["array"].shape == (sy, sx, reference.shape[2])
+    assert tile["index"] == nbDivisions
+    gt = tile["geotransform"]
+    assert abs(gt[0] + 0.5 * spacing[0] - (origin[0] + x * spacing[0])) < 1e-6 * abs(spacing[0])
+    assert abs(gt[3] + 0.5 * spacing[1] - (origin[1] + y * spacing[1])) < 1e-6 * abs(spacing[1])
+    streamed[y:y + sy, x:x + sx, :] = tile["array"]
+    nbDivisions += 1
+  print("Number of divisions: " + str(nbDivisions))
+  assert nbDivisions > 1
+  assert np.array_equal(streamed, reference)
+
+  # Python stage between two applications: each tile is doubled in place
+  regions = []
+  def double(array, index):
+    regions.append(index)
+    array *= 2
+
+  app3 = otb.Registry.CreateApplication("Smoothing")
+  app3.SetParameterString("in", argv[1])
+  app3.SetParameterString("type", "mean")
+  app3.Execute()
+  app4 = otb.Registry.CreateApplication("ExtractROI")
+  app4.ConnectImageThroughNumpy("in", app3.GetParameterOutputImage("out"), double)
+  app4.Execute()
+  doubled = np.zeros(reference.shape, dtype=np.float32)
+  for tile in app4.StreamImageOutput("out", ram=1):
+    region = tile["region"]
+    x, y = region.GetIndex(0), region.GetIndex(1)
+    doubled[y:y + region.GetSize(1), x:x + region.GetSize(0), :] = tile["array"]
+  print("Number of tiles processed in Python: " + str(len(regions)))
+  assert len(regions) > 1
+  assert np.allclose(doubled, 2 * reference)